@@ -0,0 +1,191 @@
+#include "ArchiveConverter.h"
+
+#include <boost/filesystem.hpp>
+#include <tinyxml2/tinyxml2.h>
+
+#include <cstring>
+#include <fstream>
+#include <unordered_set>
+
+using namespace AssetArchiveFormat;
+
+namespace
+{
+	uint64_t alignOffset(uint64_t p_Offset)
+	{
+		return (p_Offset + alignment - 1) / alignment * alignment;
+	}
+}
+
+ArchiveConverter::ArchiveConverter()
+{
+}
+
+void ArchiveConverter::clear()
+{
+	m_Resources.clear();
+	m_MissingFiles.clear();
+}
+
+bool ArchiveConverter::loadResourceList(const std::string& p_FilePath)
+{
+	tinyxml2::XMLDocument resourceList;
+	if (resourceList.LoadFile(p_FilePath.c_str()) != tinyxml2::XML_NO_ERROR)
+	{
+		return false;
+	}
+
+	const tinyxml2::XMLElement* resources = resourceList.FirstChildElement("Resources");
+	if (!resources)
+	{
+		return false;
+	}
+
+	for (const tinyxml2::XMLElement* resourceType = resources->FirstChildElement("ResourceType");
+		resourceType;
+		resourceType = resourceType->NextSiblingElement("ResourceType"))
+	{
+		const char* type = resourceType->Attribute("Type");
+		if (!type)
+		{
+			continue;
+		}
+
+		for (const tinyxml2::XMLElement* resource = resourceType->FirstChildElement("Resource");
+			resource;
+			resource = resource->NextSiblingElement("Resource"))
+		{
+			const char* name = resource->Attribute("Name");
+			const char* path = resource->Attribute("Path");
+			if (!name || !path)
+			{
+				return false;
+			}
+
+			addResource(type, name, path);
+		}
+	}
+
+	return true;
+}
+
+void ArchiveConverter::addResource(const std::string& p_Type, const std::string& p_Name, const std::string& p_Path)
+{
+	Resource resource;
+	resource.m_Type = p_Type;
+	resource.m_Name = p_Name;
+	resource.m_Path = p_Path;
+	m_Resources.push_back(resource);
+}
+
+bool ArchiveConverter::writeFile(const std::string& p_RootPath, const std::string& p_OutputPath)
+{
+	m_MissingFiles.clear();
+
+	// Lay out the entries first, so the directory can be written before the contents
+	std::vector<Entry> entries;
+	std::vector<boost::filesystem::path> files;
+	std::string strings;
+	std::unordered_set<std::string> keys;
+	for (const auto& resource : m_Resources)
+	{
+		const std::string key = resource.m_Type + ':' + resource.m_Name;
+		if (!keys.insert(key).second)
+		{
+			continue;
+		}
+
+		const boost::filesystem::path file = boost::filesystem::path(p_RootPath) / resource.m_Path;
+		boost::system::error_code error;
+		const uintmax_t fileSize = boost::filesystem::file_size(file, error);
+		if (error)
+		{
+			m_MissingFiles.push_back(resource.m_Path);
+			continue;
+		}
+
+		Entry entry;
+		entry.m_Hash = hashKey(resource.m_Type.data(), resource.m_Type.size(), resource.m_Name.data(), resource.m_Name.size());
+		entry.m_DataOffset = 0;
+		entry.m_DataSize = fileSize;
+		entry.m_KeyOffset = static_cast<uint32_t>(strings.size());
+		entry.m_KeyLength = static_cast<uint32_t>(key.size());
+		strings += key;
+		entry.m_PathOffset = static_cast<uint32_t>(strings.size());
+		entry.m_PathLength = static_cast<uint32_t>(resource.m_Path.size());
+		strings += resource.m_Path;
+
+		entries.push_back(entry);
+		files.push_back(file);
+	}
+
+	// At most half of the slots are used, which keeps the probe sequences short
+	uint32_t numSlots = 1;
+	while (numSlots <= entries.size() * 2)
+	{
+		numSlots <<= 1;
+	}
+
+	Header header;
+	memcpy(header.m_Magic, magic, sizeof(header.m_Magic));
+	header.m_Version = version;
+	header.m_NumEntries = static_cast<uint32_t>(entries.size());
+	header.m_NumSlots = numSlots;
+	header.m_StringsOffset = sizeof(Header) + uint64_t(numSlots) * sizeof(Entry);
+	header.m_StringsSize = strings.size();
+
+	uint64_t dataOffset = header.m_StringsOffset + header.m_StringsSize;
+	for (auto& entry : entries)
+	{
+		dataOffset = alignOffset(dataOffset);
+		entry.m_DataOffset = dataOffset;
+		dataOffset += entry.m_DataSize;
+	}
+
+	std::vector<Entry> directory(numSlots);
+	memset(directory.data(), 0, directory.size() * sizeof(Entry));
+	for (const auto& entry : entries)
+	{
+		uint32_t slot = static_cast<uint32_t>(entry.m_Hash) & (numSlots - 1);
+		while (directory[slot].m_KeyLength != 0)
+		{
+			slot = (slot + 1) & (numSlots - 1);
+		}
+		directory[slot] = entry;
+	}
+
+	std::ofstream output(p_OutputPath, std::ostream::out | std::ostream::binary | std::ostream::trunc);
+	if (!output)
+	{
+		return false;
+	}
+
+	output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	output.write(reinterpret_cast<const char*>(directory.data()), directory.size() * sizeof(Entry));
+	output.write(strings.data(), strings.size());
+
+	const char padding[alignment] = {};
+	uint64_t position = header.m_StringsOffset + header.m_StringsSize;
+	std::vector<char> buffer;
+	for (unsigned int i = 0; i < entries.size(); ++i)
+	{
+		output.write(padding, entries[i].m_DataOffset - position);
+
+		buffer.resize(static_cast<size_t>(entries[i].m_DataSize));
+		std::ifstream input(files[i].string(), std::istream::in | std::istream::binary);
+		if (!input.read(buffer.data(), buffer.size()))
+		{
+			return false;
+		}
+		output.write(buffer.data(), buffer.size());
+
+		position = entries[i].m_DataOffset + entries[i].m_DataSize;
+	}
+
+	return static_cast<bool>(output);
+}
+
+const std::vector<std::string>& ArchiveConverter::getMissingFiles() const
+{
+	return m_MissingFiles;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <AssetArchiveFormat.h>
+
+#include <string>
+#include <vector>
+
+/**
+ * Packs the files of a resource list into a single asset archive, in the
+ * format described in AssetArchiveFormat.h.
+ *
+ * Resources are keyed by type and name like in the resource list, and keep
+ * their path so that resource types that can not load from memory can still
+ * be resolved through the archive.
+ */
+class ArchiveConverter
+{
+public:
+	struct Resource
+	{
+		std::string m_Type;
+		std::string m_Name;
+		std::string m_Path;
+	};
+
+private:
+	std::vector<Resource> m_Resources;
+	std::vector<std::string> m_MissingFiles;
+
+public:
+	/**
+	 * Constructor.
+	 */
+	ArchiveConverter();
+
+	/**
+	 * Remove all added resources.
+	 */
+	void clear();
+
+	/**
+	 * Add every resource of a resource list.
+	 *
+	 * @param p_FilePath the path to a Resources.xml file
+	 * @return false if the file could not be read or is not a resource list
+	 */
+	bool loadResourceList(const std::string& p_FilePath);
+
+	/**
+	 * Add a single resource. A resource with the same type and name as an
+	 * earlier one is ignored, like the resource list does.
+	 *
+	 * @param p_Path the path of the file, relative to the root used when writing
+	 */
+	void addResource(const std::string& p_Type, const std::string& p_Name, const std::string& p_Path);
+
+	/**
+	 * Write all added resources to an archive. Files that can not be found are
+	 * left out of the archive and reported by getMissingFiles.
+	 *
+	 * @param p_RootPath the directory the resource paths are relative to
+	 * @param p_OutputPath the path of the archive to write
+	 * @return false if the archive could not be written
+	 */
+	bool writeFile(const std::string& p_RootPath, const std::string& p_OutputPath);
+
+	/**
+	 * The paths of the resources left out by the last call to writeFile.
+	 */
+	const std::vector<std::string>& getMissingFiles() const;
+};
@@ -0,0 +1,602 @@
+#include "BatchConverter.h"
+#include "BoundingVolumeConverter.h"
+#include "InstanceConverter.h"
+#include "InstanceLoader.h"
+#include "MaterialBundleConverter.h"
+#include "ModelConverter.h"
+#include "ModelLoader.h"
+#include <AnimationMetadata.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace
+{
+	const char* const cacheFileName = "BinaryConverter.cache";
+	const char* const cacheTag = "BinaryConverterCache";
+
+	uint64_t hashBytes(const void* p_Data, size_t p_Size, uint64_t p_Hash)
+	{
+		// 64-bit FNV-1a
+		const unsigned char* bytes = static_cast<const unsigned char*>(p_Data);
+		for (size_t i = 0; i < p_Size; ++i)
+		{
+			p_Hash ^= bytes[i];
+			p_Hash *= 1099511628211ull;
+		}
+		return p_Hash;
+	}
+
+	void writeJsonString(std::ostream& p_Output, const std::string& p_String)
+	{
+		p_Output << '"';
+		for (char c : p_String)
+		{
+			switch (c)
+			{
+			case '"': p_Output << "\\\""; break;
+			case '\\': p_Output << "\\\\"; break;
+			case '\n': p_Output << "\\n"; break;
+			case '\r': p_Output << "\\r"; break;
+			case '\t': p_Output << "\\t"; break;
+			default:
+				if ((unsigned char)c < 0x20)
+				{
+					p_Output << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (int)c << std::dec << std::setfill(' ');
+				}
+				else
+				{
+					p_Output << c;
+				}
+			}
+		}
+		p_Output << '"';
+	}
+
+	const char* statusName(BatchConverter::Status p_Status)
+	{
+		switch (p_Status)
+		{
+		case BatchConverter::Status::CONVERTED: return "converted";
+		case BatchConverter::Status::UP_TO_DATE: return "upToDate";
+		default: return "failed";
+		}
+	}
+
+	void setFileInfo(ModelLoader& p_Loader, ModelConverter& p_Converter)
+	{
+		p_Converter.setMeshName(p_Loader.getMeshName());
+		p_Converter.setVertices(&p_Loader.getVertices());
+		p_Converter.setTransparent(p_Loader.getTransparent());
+		p_Converter.setCollidable(p_Loader.getCollidable());
+		p_Converter.setNormals(&p_Loader.getNormals());
+		p_Converter.setTextureCoords(&p_Loader.getTextureCoords());
+		p_Converter.setTangents(&p_Loader.getTangents());
+		p_Converter.setIndices(&p_Loader.getIndices());
+		p_Converter.setMaterial(&p_Loader.getMaterial());
+		p_Converter.setWeightsList(&p_Loader.getWeightsList());
+		p_Converter.setListOfJoints(&p_Loader.getListOfJoints());
+		p_Converter.setNumberOfFrames(p_Loader.getNumberOfFrames());
+	}
+
+	void setLevelInfo(InstanceLoader& p_Loader, InstanceConverter& p_Converter)
+	{
+		p_Converter.setLevelHead(p_Loader.getLevelHeader());
+		p_Converter.setModelList(&p_Loader.getModelList());
+		p_Converter.setLevelDirectionalLightList(&p_Loader.getLevelDirectionalLightList());
+		p_Converter.setLevelPointLightList(&p_Loader.getLevelPointLightList());
+		p_Converter.setLevelSpotLightList(&p_Loader.getLevelSpotLightList());
+		p_Converter.setLevelCheckPointList(&p_Loader.getLevelCheckPointList());
+		p_Converter.setLevelCheckPointStart(p_Loader.getLevelCheckPointStart());
+		p_Converter.setLevelCheckPointEnd(p_Loader.getLevelCheckPointEnd());
+		p_Converter.setModelInformation(&p_Loader.getModelInformation());
+		p_Converter.setEffectList(&p_Loader.getLevelEffectList());
+	}
+}
+
+BatchConverter::BatchConverter()
+	:	m_NumThreads(std::thread::hardware_concurrency()),
+		m_Force(false),
+		m_TotalTime(0.0)
+{
+}
+
+bool BatchConverter::addDirectory(const boost::filesystem::path& p_Directory)
+{
+	if (!boost::filesystem::is_directory(p_Directory))
+	{
+		return false;
+	}
+	if (m_CachePath.empty())
+	{
+		m_CachePath = p_Directory / cacheFileName;
+	}
+
+	// Sort the files to get the same order, and the same report, on every run
+	std::vector<boost::filesystem::path> files;
+	for (boost::filesystem::recursive_directory_iterator it(p_Directory), end; it != end; ++it)
+	{
+		if (boost::filesystem::is_regular_file(it->status()) && !getOutputPath(it->path()).empty())
+		{
+			files.push_back(it->path());
+		}
+	}
+	std::sort(files.begin(), files.end());
+	m_Inputs.insert(m_Inputs.end(), files.begin(), files.end());
+	return true;
+}
+
+bool BatchConverter::addManifest(const boost::filesystem::path& p_Manifest)
+{
+	std::ifstream input(p_Manifest.string());
+	if (!input)
+	{
+		return false;
+	}
+	const boost::filesystem::path directory = p_Manifest.parent_path();
+	if (m_CachePath.empty())
+	{
+		m_CachePath = directory / cacheFileName;
+	}
+
+	std::string line;
+	while (std::getline(input, line))
+	{
+		const size_t first = line.find_first_not_of(" \t\r");
+		if (first == std::string::npos || line[first] == '#')
+		{
+			continue;
+		}
+		const size_t last = line.find_last_not_of(" \t\r");
+		addFile(directory / line.substr(first, last - first + 1));
+	}
+	return true;
+}
+
+void BatchConverter::addFile(const boost::filesystem::path& p_File)
+{
+	m_Inputs.push_back(p_File);
+}
+
+void BatchConverter::setResourceListLocation(const std::string& p_Location)
+{
+	m_ResourceListLocation = p_Location;
+}
+
+void BatchConverter::setModelOptions(const ModelOptions& p_Options)
+{
+	m_ModelOptions = p_Options;
+}
+
+void BatchConverter::setNumThreads(unsigned int p_NumThreads)
+{
+	m_NumThreads = p_NumThreads;
+}
+
+void BatchConverter::setForce(bool p_Force)
+{
+	m_Force = p_Force;
+}
+
+bool BatchConverter::loadTextureTable(const std::string& p_TablePath)
+{
+	return m_TextureTable.loadFile(p_TablePath);
+}
+
+void BatchConverter::setCachePath(const boost::filesystem::path& p_CachePath)
+{
+	m_CachePath = p_CachePath;
+}
+
+const std::vector<BatchConverter::Result>& BatchConverter::run()
+{
+	typedef std::chrono::high_resolution_clock Clock;
+	const Clock::time_point start = Clock::now();
+
+	loadCache();
+	m_Results.assign(m_Inputs.size(), Result());
+	m_ModelInfos.assign(m_Inputs.size(), ModelInfo());
+
+	// The cache is only read while converting, every thread writes its own results
+	std::atomic<unsigned int> nextInput(0);
+	auto worker = [&] ()
+	{
+		for (unsigned int i = nextInput++; i < m_Inputs.size(); i = nextInput++)
+		{
+			convert(i);
+		}
+	};
+
+	const unsigned int numThreads = (std::min)(m_NumThreads, (unsigned int)m_Inputs.size());
+	std::vector<std::thread> threads;
+	for (unsigned int i = 1; i < numThreads; ++i)
+	{
+		threads.push_back(std::thread(worker));
+	}
+	worker();
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	saveCache();
+	updateResourceList();
+
+	m_TotalTime = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count() / 1000.0;
+	return m_Results;
+}
+
+const std::vector<BatchConverter::Result>& BatchConverter::getResults() const
+{
+	return m_Results;
+}
+
+unsigned int BatchConverter::getCount(Status p_Status) const
+{
+	unsigned int count = 0;
+	for (const Result& result : m_Results)
+	{
+		if (result.m_Status == p_Status)
+		{
+			++count;
+		}
+	}
+	return count;
+}
+
+void BatchConverter::writeReport(std::ostream& p_Output) const
+{
+	p_Output << "{" << std::endl
+		<< "\t\"converterVersion\": " << converterVersion << "," << std::endl
+		<< "\t\"threads\": " << (std::max)(1u, (std::min)(m_NumThreads, (unsigned int)m_Results.size())) << "," << std::endl
+		<< "\t\"time\": " << m_TotalTime << "," << std::endl
+		<< "\t\"converted\": " << getCount(Status::CONVERTED) << "," << std::endl
+		<< "\t\"upToDate\": " << getCount(Status::UP_TO_DATE) << "," << std::endl
+		<< "\t\"failed\": " << getCount(Status::FAILED) << "," << std::endl
+		<< "\t\"files\": [";
+
+	for (unsigned int i = 0; i < m_Results.size(); ++i)
+	{
+		const Result& result = m_Results[i];
+		std::ostringstream hash;
+		hash << std::hex << std::setw(16) << std::setfill('0') << result.m_Hash;
+
+		p_Output << (i == 0 ? "" : ",") << std::endl << "\t\t{ \"input\": ";
+		writeJsonString(p_Output, result.m_Input);
+		p_Output << ", \"output\": ";
+		writeJsonString(p_Output, result.m_Output);
+		p_Output << ", \"status\": \"" << statusName(result.m_Status) << "\", \"hash\": \"" << hash.str()
+			<< "\", \"inputSize\": " << result.m_InputSize << ", \"outputSize\": " << result.m_OutputSize
+			<< ", \"time\": " << result.m_Time;
+		if (result.m_Status == Status::FAILED)
+		{
+			p_Output << ", \"error\": ";
+			writeJsonString(p_Output, result.m_Error);
+		}
+		p_Output << " }";
+	}
+	p_Output << std::endl << "\t]" << std::endl << "}" << std::endl;
+}
+
+boost::filesystem::path BatchConverter::getOutputPath(const boost::filesystem::path& p_Input)
+{
+	const std::string extension = p_Input.extension().string();
+	boost::filesystem::path output(p_Input);
+	if (extension == ".tx")
+	{
+		return output.replace_extension(".btx");
+	}
+	if (extension == ".txl")
+	{
+		return output.replace_extension(".btxl");
+	}
+	if (extension == ".txe")
+	{
+		return output.replace_extension(".btxe");
+	}
+	if (extension == ".txc")
+	{
+		return output.replace_extension(".bbv");
+	}
+	if (extension == ".mlx")
+	{
+		return output.replace_extension(".bmlx");
+	}
+	return boost::filesystem::path();
+}
+
+uint64_t BatchConverter::hashFile(const std::vector<char>& p_Contents, const std::string& p_Extension, const ModelOptions& p_Options)
+{
+	uint64_t hash = 14695981039346656037ull;
+	const int versions[] = { converterVersion, ModelConverter::indexedVersion };
+	hash = hashBytes(versions, sizeof(versions), hash);
+	hash = hashBytes(p_Extension.data(), p_Extension.size(), hash);
+	if (p_Extension == ".tx")
+	{
+		const char options[] = { p_Options.m_Indexed, p_Options.m_Compact, p_Options.m_Compress };
+		hash = hashBytes(options, sizeof(options), hash);
+	}
+	return hashBytes(p_Contents.data(), p_Contents.size(), hash);
+}
+
+void BatchConverter::convert(unsigned int p_Index)
+{
+	typedef std::chrono::high_resolution_clock Clock;
+	const Clock::time_point start = Clock::now();
+
+	const boost::filesystem::path& input = m_Inputs[p_Index];
+	const boost::filesystem::path output = getOutputPath(input);
+	Result& result = m_Results[p_Index];
+	result.m_Input = input.string();
+	result.m_Output = output.string();
+	result.m_Status = Status::FAILED;
+	result.m_Hash = 0;
+	result.m_InputSize = 0;
+	result.m_OutputSize = 0;
+
+	try
+	{
+		if (output.empty())
+		{
+			throw std::runtime_error("Unsupported file type");
+		}
+
+		std::ifstream file(input.string(), std::istream::in | std::istream::binary);
+		if (!file)
+		{
+			throw std::runtime_error("Error loading file");
+		}
+		const std::vector<char> contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		file.close();
+		result.m_InputSize = contents.size();
+		result.m_Hash = hashFile(contents, input.extension().string(), m_ModelOptions);
+		if (input.extension() == ".tx" && m_TextureTable.getNumTextures() > 0)
+		{
+			const uint64_t tableHash = m_TextureTable.getHash();
+			result.m_Hash = hashBytes(&tableHash, sizeof(tableHash), result.m_Hash);
+		}
+		const boost::filesystem::path metadataPath = boost::filesystem::path(input).replace_extension(".mlx");
+		if (input.extension() == ".tx" && boost::filesystem::exists(metadataPath))
+		{
+			// The metadata is embedded in the .atx, so editing it has to convert the model again
+			std::ifstream metadataFile(metadataPath.string(), std::istream::in | std::istream::binary);
+			const std::vector<char> metadata((std::istreambuf_iterator<char>(metadataFile)), std::istreambuf_iterator<char>());
+			result.m_Hash = hashBytes(metadata.data(), metadata.size(), result.m_Hash);
+		}
+
+		const auto cached = m_Cache.find(input.generic_string());
+		if (!m_Force && cached != m_Cache.end() && cached->second.m_Hash == result.m_Hash && hasOutputs(output, cached->second))
+		{
+			m_ModelInfos[p_Index].m_MeshName = cached->second.m_MeshName;
+			m_ModelInfos[p_Index].m_Collidable = cached->second.m_Collidable;
+			m_ModelInfos[p_Index].m_Animated = cached->second.m_Animated;
+			result.m_Status = Status::UP_TO_DATE;
+		}
+		else
+		{
+			convertFile(input, output, m_ModelInfos[p_Index]);
+			result.m_Status = Status::CONVERTED;
+		}
+		result.m_OutputSize = boost::filesystem::file_size(output);
+	}
+	catch (std::exception& err)
+	{
+		result.m_Status = Status::FAILED;
+		result.m_Error = err.what();
+	}
+
+	result.m_Time = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count() / 1000.0;
+}
+
+bool BatchConverter::hasOutputs(const boost::filesystem::path& p_Output, const CacheEntry& p_Entry) const
+{
+	if (!boost::filesystem::exists(p_Output))
+	{
+		return false;
+	}
+	if (p_Output.extension() == ".btx")
+	{
+		// ModelConverter writes the animation of animated models next to the model
+		if (p_Entry.m_Animated && !boost::filesystem::exists(boost::filesystem::path(p_Output).replace_extension(".atx")))
+		{
+			return false;
+		}
+		if (m_TextureTable.getNumTextures() > 0 && !boost::filesystem::exists(MaterialBundleConverter::getBundlePath(p_Output.string())))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void BatchConverter::convertFile(const boost::filesystem::path& p_Input, const boost::filesystem::path& p_Output, ModelInfo& p_ModelInfo) const
+{
+	const std::string extension = p_Input.extension().string();
+	if (extension == ".tx")
+	{
+		ModelLoader loader;
+		if (!loader.loadFile(p_Input.string()))
+		{
+			throw std::runtime_error("Error loading file");
+		}
+		ModelConverter converter;
+		converter.setIndexedOutput(m_ModelOptions.m_Indexed);
+		converter.setCompactVertices(m_ModelOptions.m_Compact);
+		if (m_ModelOptions.m_Compress)
+		{
+			converter.setAnimationCompression(true, AnimationCompressor::Settings());
+		}
+		setFileInfo(loader, converter);
+		const boost::filesystem::path metadataPath = boost::filesystem::path(p_Input).replace_extension(".mlx");
+		if (boost::filesystem::exists(metadataPath))
+		{
+			converter.setAnimationMetadata(AnimationMetadata::loadText(metadataPath.string()));
+		}
+		if (!converter.writeFile(p_Output.string()))
+		{
+			throw std::runtime_error("Error writing file");
+		}
+		if (m_TextureTable.getNumTextures() > 0)
+		{
+			MaterialBundleConverter bundle(m_TextureTable);
+			for (const ModelLoader::Material& material : loader.getMaterial())
+			{
+				bundle.addMaterial(material.m_MaterialID, material.m_DiffuseMap, material.m_NormalMap, material.m_SpecularMap);
+			}
+			if (!bundle.writeFile(MaterialBundleConverter::getBundlePath(p_Output.string())))
+			{
+				throw std::runtime_error("Error writing material bundle");
+			}
+		}
+		p_ModelInfo.m_MeshName = loader.getMeshName();
+		p_ModelInfo.m_Collidable = loader.getCollidable();
+		p_ModelInfo.m_Animated = !loader.getWeightsList().empty();
+	}
+	else if (extension == ".txl" || extension == ".txe")
+	{
+		InstanceLoader loader;
+		if (!loader.loadLevel(p_Input.string()))
+		{
+			throw std::runtime_error("Error loading file");
+		}
+		InstanceConverter converter;
+		setLevelInfo(loader, converter);
+		if (!converter.writeFile(p_Output.string()))
+		{
+			throw std::runtime_error("Error writing file");
+		}
+	}
+	else if (extension == ".txc")
+	{
+		BoundingVolumeConverter converter;
+		if (!converter.loadFile(p_Input.string()))
+		{
+			throw std::runtime_error("Error loading file");
+		}
+		if (!converter.writeFile(p_Output.string()))
+		{
+			throw std::runtime_error("Error writing file");
+		}
+	}
+	else if (extension == ".mlx")
+	{
+		AnimationMetadata metadata = AnimationMetadata::loadText(p_Input.string());
+		std::ofstream output(p_Output.string(), std::ostream::out | std::ostream::binary);
+		if (!output)
+		{
+			throw std::runtime_error("Error writing file");
+		}
+		metadata.write(output);
+	}
+}
+
+void BatchConverter::loadCache()
+{
+	m_Cache.clear();
+	std::ifstream input(m_CachePath.string());
+	std::string tag;
+	int version = 0;
+	if (!input || !(input >> tag >> version) || tag != cacheTag || version != converterVersion)
+	{
+		return;
+	}
+
+	// <hash> <collidable> <animated>\t<mesh name>\t<input path>, names and paths may contain spaces
+	std::string line;
+	while (std::getline(input, line))
+	{
+		std::istringstream stream(line);
+		CacheEntry entry;
+		std::string path;
+		if (stream >> std::hex >> entry.m_Hash >> std::dec >> entry.m_Collidable >> entry.m_Animated
+			&& stream.get() == '\t' && std::getline(stream, entry.m_MeshName, '\t') && std::getline(stream, path) && !path.empty())
+		{
+			m_Cache[path] = entry;
+		}
+	}
+}
+
+void BatchConverter::saveCache() const
+{
+	if (m_CachePath.empty())
+	{
+		return;
+	}
+
+	// Keep the entries of files that were not part of this batch
+	std::map<std::string, CacheEntry> cache(m_Cache);
+	for (unsigned int i = 0; i < m_Results.size(); ++i)
+	{
+		const std::string key = m_Inputs[i].generic_string();
+		if (m_Results[i].m_Status == Status::FAILED)
+		{
+			cache.erase(key);
+			continue;
+		}
+		CacheEntry& entry = cache[key];
+		entry.m_Hash = m_Results[i].m_Hash;
+		entry.m_MeshName = m_ModelInfos[i].m_MeshName;
+		entry.m_Collidable = m_ModelInfos[i].m_Collidable;
+		entry.m_Animated = m_ModelInfos[i].m_Animated;
+	}
+
+	std::ofstream output(m_CachePath.string());
+	output << cacheTag << " " << converterVersion << std::endl;
+	for (const auto& entry : cache)
+	{
+		output << std::hex << std::setw(16) << std::setfill('0') << entry.second.m_Hash << std::dec << std::setfill(' ')
+			<< " " << entry.second.m_Collidable << " " << entry.second.m_Animated
+			<< "\t" << entry.second.m_MeshName << "\t" << entry.first << std::endl;
+	}
+}
+
+void BatchConverter::updateResourceList()
+{
+	if (m_ResourceListLocation.empty())
+	{
+		return;
+	}
+
+	bool hasModels = false;
+	for (unsigned int i = 0; i < m_Results.size(); ++i)
+	{
+		hasModels |= m_Results[i].m_Status != Status::FAILED && !m_ModelInfos[i].m_MeshName.empty();
+	}
+	if (!hasModels)
+	{
+		return;
+	}
+
+	// Up to date models are added again, in case the resource list was replaced since they were converted
+	const std::string location = m_ResourceListLocation + "\\Resources.xml";
+	tinyxml2::XMLDocument resources;
+	tinyxml2::XMLError error = resources.LoadFile(location.c_str());
+	if (error == tinyxml2::XML_ERROR_EMPTY_DOCUMENT || error == tinyxml2::XML_ERROR_FILE_NOT_FOUND)
+	{
+		// Start a new list, clearing the error so it is not returned by SaveFile
+		resources.Clear();
+	}
+	else if (error != tinyxml2::XML_NO_ERROR)
+	{
+		throw std::runtime_error("Resource list could not be opened: " + location);
+	}
+	for (unsigned int i = 0; i < m_Results.size(); ++i)
+	{
+		const ModelInfo& info = m_ModelInfos[i];
+		if (m_Results[i].m_Status != Status::FAILED && !info.m_MeshName.empty())
+		{
+			ModelLoader::addResourceInfo(resources, info.m_MeshName, info.m_Collidable, info.m_Animated);
+		}
+	}
+	error = resources.SaveFile(location.c_str());
+	if (error != tinyxml2::XML_NO_ERROR)
+	{
+		throw std::runtime_error("Resource list could not be saved: " + location);
+	}
+}
@@ -0,0 +1,222 @@
+#pragma once
+
+#include <TextureTable.h>
+
+#include <boost/filesystem.hpp>
+
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * Converts many source files in one process, spread over a pool of threads.
+ *
+ * Inputs are collected from directories or manifests and converted with the
+ * same converters as single file mode. A cache file next to the inputs stores a
+ * hash of every converted file together with the converter version and options,
+ * and files whose hash and output are unchanged are skipped. The resource list
+ * is loaded once before and saved once after the batch, instead of once per model.
+ */
+class BatchConverter
+{
+public:
+	/**
+	 * Bump when any output format or conversion changes, to reconvert everything.
+	 */
+	static const int converterVersion = 1;
+
+	enum class Status
+	{
+		CONVERTED,
+		UP_TO_DATE,
+		FAILED,
+	};
+
+	/**
+	 * Options for .tx models, matching the single file command line options.
+	 */
+	struct ModelOptions
+	{
+		bool m_Indexed;
+		bool m_Compact;
+		bool m_Compress;
+
+		ModelOptions()
+			:	m_Indexed(true),
+				m_Compact(false),
+				m_Compress(false)
+		{}
+	};
+
+	/**
+	 * The outcome of one input file.
+	 */
+	struct Result
+	{
+		std::string m_Input;
+		std::string m_Output;
+		Status m_Status;
+		std::string m_Error;
+		uint64_t m_Hash;
+		uintmax_t m_InputSize;
+		uintmax_t m_OutputSize;
+		/**
+		 * Time spent hashing and converting the file, in milliseconds.
+		 */
+		double m_Time;
+	};
+
+private:
+	/**
+	 * What is remembered about a converted file between batches.
+	 */
+	struct CacheEntry
+	{
+		uint64_t m_Hash;
+		std::string m_MeshName;
+		bool m_Collidable;
+		bool m_Animated;
+	};
+
+	/**
+	 * Mesh information of a converted model, applied to the resource list after the batch.
+	 */
+	struct ModelInfo
+	{
+		std::string m_MeshName;
+		bool m_Collidable;
+		bool m_Animated;
+
+		ModelInfo()
+			:	m_Collidable(false),
+				m_Animated(false)
+		{}
+	};
+
+	std::vector<boost::filesystem::path> m_Inputs;
+	boost::filesystem::path m_CachePath;
+	std::string m_ResourceListLocation;
+	ModelOptions m_ModelOptions;
+	TextureTable m_TextureTable;
+	unsigned int m_NumThreads;
+	bool m_Force;
+
+	std::map<std::string, CacheEntry> m_Cache;
+	std::vector<Result> m_Results;
+	std::vector<ModelInfo> m_ModelInfos;
+	double m_TotalTime;
+
+public:
+	/**
+	 * Constructor, uses one thread per hardware thread.
+	 */
+	BatchConverter();
+
+	/**
+	 * Add all convertible files in a directory and its subdirectories.
+	 * The cache file is placed in the first added directory.
+	 *
+	 * @param p_Directory the directory to search
+	 * @return false if the directory does not exist
+	 */
+	bool addDirectory(const boost::filesystem::path& p_Directory);
+
+	/**
+	 * Add the files listed in a manifest, one path per line relative to the manifest.
+	 * Empty lines and lines starting with # are ignored. The cache file is placed next
+	 * to the first added manifest.
+	 *
+	 * @param p_Manifest the manifest file
+	 * @return false if the manifest could not be opened
+	 */
+	bool addManifest(const boost::filesystem::path& p_Manifest);
+
+	/**
+	 * Add a single file, even if its type can not be converted, which is reported as a failure.
+	 */
+	void addFile(const boost::filesystem::path& p_File);
+
+	/**
+	 * @param p_Location the directory with the Resources.xml that models are added to,
+	 *			empty to leave the resource list untouched
+	 */
+	void setResourceListLocation(const std::string& p_Location);
+
+	void setModelOptions(const ModelOptions& p_Options);
+
+	/**
+	 * Write a material bundle (.bmb) next to every converted model, with the
+	 * textures resolved against a texture table. Models are converted again
+	 * when the table changes.
+	 *
+	 * @param p_TablePath the texture table (.btt)
+	 * @return false if the table could not be loaded
+	 */
+	bool loadTextureTable(const std::string& p_TablePath);
+
+	/**
+	 * @param p_NumThreads the number of threads converting files, 0 or 1 converts on the calling thread
+	 */
+	void setNumThreads(unsigned int p_NumThreads);
+
+	/**
+	 * @param p_Force true to convert files even if they are up to date
+	 */
+	void setForce(bool p_Force);
+
+	/**
+	 * Override where the conversion cache is stored.
+	 */
+	void setCachePath(const boost::filesystem::path& p_CachePath);
+
+	/**
+	 * Convert all added files that are not up to date.
+	 *
+	 * @return the result of every added file, in the order they were added
+	 */
+	const std::vector<Result>& run();
+
+	const std::vector<Result>& getResults() const;
+
+	/**
+	 * Count the results of the last run with a status.
+	 */
+	unsigned int getCount(Status p_Status) const;
+
+	/**
+	 * Write the results of the last run as JSON, with per file status, timing and sizes.
+	 */
+	void writeReport(std::ostream& p_Output) const;
+
+	/**
+	 * The output file a source file converts to.
+	 *
+	 * @return the output path, empty if the file type can not be converted
+	 */
+	static boost::filesystem::path getOutputPath(const boost::filesystem::path& p_Input);
+
+	/**
+	 * 64-bit FNV-1a hash of the file contents, the converter version and the options
+	 * that affect its output.
+	 */
+	static uint64_t hashFile(const std::vector<char>& p_Contents, const std::string& p_Extension, const ModelOptions& p_Options);
+
+private:
+	void convert(unsigned int p_Index);
+
+	/**
+	 * Check that every file written for an input is still there, so a cached file is
+	 * converted again if any of its outputs was removed.
+	 *
+	 * @param p_Output the main output of the file
+	 * @param p_Entry what was remembered about the file from the last batch
+	 */
+	bool hasOutputs(const boost::filesystem::path& p_Output, const CacheEntry& p_Entry) const;
+	void convertFile(const boost::filesystem::path& p_Input, const boost::filesystem::path& p_Output, ModelInfo& p_ModelInfo) const;
+
+	void loadCache();
+	void saveCache() const;
+	void updateResourceList();
+};
@@ -1,13 +1,27 @@
 #pragma once 
 #pragma warning(disable : 4996)
+#include "ArchiveConverter.h"
+#include "BatchConverter.h"
 #include "ModelConverter.h"
 #include "ModelLoader.h"
+#include "MeshOptimizer.h"
 #include "InstanceLoader.h"
 #include "InstanceConverter.h"
+#include "BoundingVolumeConverter.h"
+#include "MaterialBundleConverter.h"
+#include "TextureTableConverter.h"
+#include <AnimationMetadata.h>
+#include <chrono>
+#include <fstream>
 #include <iostream>
 
 void setFileInfo(ModelLoader* p_Loader, ModelConverter* p_Converter);
 void setLevelInfo(InstanceLoader* p_Loader, InstanceConverter* p_Converter);
+void printStatistics(const ModelConverter::MeshStatistics& p_Statistics, long long p_LoadMicro);
+int runBatch(int argc, char* argv[]);
+int runPack(int argc, char* argv[]);
+int runTextureTable(int argc, char* argv[]);
+bool writeMaterialBundle(const ModelLoader& p_Loader, const TextureTable& p_Table, const std::string& p_ModelPath);
 
 int main(int argc, char* argv[])
 {
@@ -19,6 +33,18 @@ int main(int argc, char* argv[])
 	{
 		return EXIT_FAILURE;
 	}
+	if(strcmp(argv[1], "-batch") == 0)
+	{
+		return runBatch(argc, argv);
+	}
+	if(strcmp(argv[1], "-pack") == 0)
+	{
+		return runPack(argc, argv);
+	}
+	if(strcmp(argv[1], "-texturetable") == 0)
+	{
+		return runTextureTable(argc, argv);
+	}
 	std::vector<char> buffer(strlen(argv[1])+1);
 	strcpy(buffer.data(), argv[1]);
 	char *tmp, *type = nullptr;
@@ -29,27 +55,81 @@ int main(int argc, char* argv[])
 		tmp = strtok(NULL,".");
 	}
 	bool result;
-	if(argc == 3)
+	if(argc >= 3 && argc <= 8)
 	{
 		if(strcmp(type, "tx") == 0)
 		{
+			bool indexed = true;
+			std::string textureTableFile;
+			for(int i = 3; i < argc; i++)
+			{
+				if(strcmp(argv[i], "-compress") == 0)
+				{
+					converter.setAnimationCompression(true, AnimationCompressor::Settings());
+				}
+				else if(strcmp(argv[i], "-expanded") == 0)
+				{
+					indexed = false;
+				}
+				else if(strcmp(argv[i], "-compact") == 0)
+				{
+					converter.setCompactVertices(true);
+				}
+				else if(strcmp(argv[i], "-textures") == 0 && i + 1 < argc)
+				{
+					textureTableFile = argv[++i];
+				}
+				else
+				{
+					std::cout << "Unknown option: " << argv[i];
+					return EXIT_FAILURE;
+				}
+			}
+			TextureTable textureTable;
+			if(!textureTableFile.empty() && !textureTable.loadFile(textureTableFile))
+			{
+				std::cout << "Error loading texture table: " << textureTableFile << std::endl;
+				return EXIT_FAILURE;
+			}
+			converter.setIndexedOutput(indexed);
 			std::vector<char> outputBuffer(strlen(argv[1])+2);
 			strcpy(outputBuffer.data(), argv[1]);
 			int length = outputBuffer.size();
 			strcpy(outputBuffer.data()+length-5, ".btx");
+			std::chrono::high_resolution_clock::time_point loadStart = std::chrono::high_resolution_clock::now();
 			result = loader.loadFile(argv[1], argv[2]);
 			if(!result){std::cout<<"Error loading file";return EXIT_FAILURE;}
+			long long loadMicro = std::chrono::duration_cast<std::chrono::microseconds>(
+				std::chrono::high_resolution_clock::now() - loadStart).count();
 			setFileInfo(&loader, &converter);
+			const std::string metadataFile = boost::filesystem::path(argv[1]).replace_extension("mlx").string();
+			if(boost::filesystem::exists(metadataFile))
+			{
+				converter.setAnimationMetadata(AnimationMetadata::loadText(metadataFile));
+			}
 			result = converter.writeFile(outputBuffer.data());
 			if(!result){std::cout<<"Error writing file";return EXIT_FAILURE;}
+			if(!textureTableFile.empty())
+			{
+				result = writeMaterialBundle(loader, textureTable, outputBuffer.data());
+				if(!result){std::cout<<"Error writing material bundle";return EXIT_FAILURE;}
+			}
 			std::cout << outputBuffer.data();
+			if(indexed)
+			{
+				printStatistics(converter.getStatistics(), loadMicro);
+			}
 			loader.clear();
 			converter.clear();
 			return EXIT_SUCCESS;
 		}
 		std::cout << argv[0] << " does not support files of type: " << type << std::endl
 			<< "Supported types are: " << std::endl << "      .tx" << std::endl << "      .txl"
-			<< std::endl << ".tx files needs 2 arguments, filename and resourcelist.";
+			<< std::endl << ".tx files needs 2 arguments, filename and resourcelist."
+			<< std::endl << "Add -compress after the resourcelist to write a compressed .atx file."
+			<< std::endl << "Add -expanded to write the old unindexed vertex list instead of an indexed model."
+			<< std::endl << "Add -compact to quantize the vertices of an indexed model."
+			<< std::endl << "Add -textures _texture_table_ to also write a material bundle (.bmb) resolved against a texture table.";
 
 
 		return EXIT_FAILURE;
@@ -79,15 +159,47 @@ int main(int argc, char* argv[])
 			levelConverter.clear();
 			return EXIT_SUCCESS;
 		}
+		if(strcmp(type, "txc") == 0)
+		{
+			BoundingVolumeConverter volumeConverter;
+			std::string outputFile(argv[1]);
+			outputFile.replace(outputFile.length() - 4, 4, ".bbv");
+			result = volumeConverter.loadFile(argv[1]);
+			if(!result){std::cout<<"Error loading file";return EXIT_FAILURE;}
+			result = volumeConverter.writeFile(outputFile);
+			if(!result){std::cout<<"Error writing file";return EXIT_FAILURE;}
+			std::cout << outputFile << std::endl;
+			return EXIT_SUCCESS;
+		}
+		if(strcmp(type, "mlx") == 0)
+		{
+			std::string outputFile(argv[1]);
+			outputFile.replace(outputFile.length() - 4, 4, ".bmlx");
+			std::ifstream input(argv[1]);
+			if(!input){std::cout<<"Error loading file";return EXIT_FAILURE;}
+			input.close();
+			AnimationMetadata metadata = AnimationMetadata::loadText(argv[1]);
+			std::ofstream output(outputFile, std::ostream::out | std::ostream::binary);
+			if(!output){std::cout<<"Error writing file";return EXIT_FAILURE;}
+			metadata.write(output);
+			output.close();
+			std::cout << outputFile << std::endl;
+			return EXIT_SUCCESS;
+		}
 		std::cout << argv[0] << " does not support files of type: " << type << std::endl
-			<< "Supported types are: " << std::endl << "      .txe" << std::endl << "      .txl";
+			<< "Supported types are: " << std::endl << "      .txe" << std::endl << "      .txl" << std::endl << "      .txc"
+			<< std::endl << "      .mlx";
 
 
 		return EXIT_FAILURE;
 	}
 	else
 	{
-		std::cout << "Usage: " << argv[0] << " _in_file_ " << std::endl;
+		std::cout << "Usage: " << argv[0] << " _in_file_ " << std::endl
+			<< "       " << argv[0] << " -batch _directory_or_manifest_ _resourcelist_ [-threads n] [-report file] [-force]"
+			<< " [-compress] [-expanded] [-compact] [-textures _texture_table_]" << std::endl
+			<< "       " << argv[0] << " -pack _resourcelist_ _root_directory_ _out_file_" << std::endl
+			<< "       " << argv[0] << " -texturetable _texture_directory_ _out_file_" << std::endl;
 	}
 
 	return EXIT_FAILURE;
@@ -109,6 +221,112 @@ void setFileInfo(ModelLoader* p_Loader, ModelConverter* p_Converter)
 	p_Converter->setNumberOfFrames(p_Loader->getNumberOfFrames());
 }
 
+void printStatistics(const ModelConverter::MeshStatistics& p_Statistics, long long p_LoadMicro)
+{
+	std::cout << std::endl
+		<< "  source load time: " << p_LoadMicro / 1000.0 << " ms" << std::endl
+		<< "  vertices: " << p_Statistics.m_Corners << " -> " << p_Statistics.m_Vertices << " welded, "
+		<< p_Statistics.m_VertexSize << " bytes each" << (p_Statistics.m_Compact ? " (compact)" : "") << std::endl
+		<< "  indices: " << p_Statistics.m_Corners << " x " << p_Statistics.m_IndexSize << " bytes" << std::endl
+		<< "  ACMR (" << MeshOptimizer::cacheSize << " entry FIFO): " << p_Statistics.m_ACMRBefore << " -> " << p_Statistics.m_ACMRAfter << std::endl
+		<< "  file size: " << p_Statistics.m_FileSize << " bytes" << std::endl;
+	if(p_Statistics.m_Compact)
+	{
+		const VertexQuantizer::Error& error = p_Statistics.m_QuantizationError;
+		std::cout << "  quantization error: position " << error.m_Position << ", normal " << error.m_Normal
+			<< " deg, tangent " << error.m_Tangent << " deg, binormal " << error.m_Binormal << " deg, uv " << error.m_UV
+			<< ", weight " << error.m_Weight << ", joint mismatches " << error.m_JointMismatches << std::endl;
+	}
+}
+
+int runBatch(int argc, char* argv[])
+{
+	if(argc < 4)
+	{
+		std::cout << "Usage: " << argv[0] << " -batch _directory_or_manifest_ _resourcelist_ [-threads n] [-report file] [-force]"
+			<< " [-compress] [-expanded] [-compact] [-textures _texture_table_]" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	BatchConverter batch;
+	BatchConverter::ModelOptions options;
+	std::string reportFile;
+	for(int i = 4; i < argc; i++)
+	{
+		if(strcmp(argv[i], "-threads") == 0 && i + 1 < argc)
+		{
+			batch.setNumThreads(atoi(argv[++i]));
+		}
+		else if(strcmp(argv[i], "-report") == 0 && i + 1 < argc)
+		{
+			reportFile = argv[++i];
+		}
+		else if(strcmp(argv[i], "-force") == 0)
+		{
+			batch.setForce(true);
+		}
+		else if(strcmp(argv[i], "-compress") == 0)
+		{
+			options.m_Compress = true;
+		}
+		else if(strcmp(argv[i], "-expanded") == 0)
+		{
+			options.m_Indexed = false;
+		}
+		else if(strcmp(argv[i], "-compact") == 0)
+		{
+			options.m_Compact = true;
+		}
+		else if(strcmp(argv[i], "-textures") == 0 && i + 1 < argc)
+		{
+			if(!batch.loadTextureTable(argv[++i]))
+			{
+				std::cout << "Error loading texture table: " << argv[i] << std::endl;
+				return EXIT_FAILURE;
+			}
+		}
+		else
+		{
+			std::cout << "Unknown option: " << argv[i];
+			return EXIT_FAILURE;
+		}
+	}
+	batch.setModelOptions(options);
+	batch.setResourceListLocation(argv[3]);
+
+	const bool added = boost::filesystem::is_directory(argv[2]) ? batch.addDirectory(argv[2]) : batch.addManifest(argv[2]);
+	if(!added){std::cout<<"Error loading file";return EXIT_FAILURE;}
+
+	try
+	{
+		batch.run();
+	}
+	catch(std::exception& err)
+	{
+		std::cout << err.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	for(const BatchConverter::Result& result : batch.getResults())
+	{
+		if(result.m_Status == BatchConverter::Status::FAILED)
+		{
+			std::cout << result.m_Input << ": " << result.m_Error << std::endl;
+		}
+	}
+	std::cout << batch.getCount(BatchConverter::Status::CONVERTED) << " converted, "
+		<< batch.getCount(BatchConverter::Status::UP_TO_DATE) << " up to date, "
+		<< batch.getCount(BatchConverter::Status::FAILED) << " failed" << std::endl;
+
+	if(!reportFile.empty())
+	{
+		std::ofstream report(reportFile);
+		if(!report){std::cout<<"Error writing file";return EXIT_FAILURE;}
+		batch.writeReport(report);
+	}
+	return batch.getCount(BatchConverter::Status::FAILED) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
 void setLevelInfo(InstanceLoader* p_Loader, InstanceConverter* p_Converter)
 {
 	p_Converter->setLevelHead(p_Loader->getLevelHeader());
@@ -121,4 +339,75 @@ void setLevelInfo(InstanceLoader* p_Loader, InstanceConverter* p_Converter)
 	p_Converter->setLevelCheckPointEnd(p_Loader->getLevelCheckPointEnd());
 	p_Converter->setModelInformation(&p_Loader->getModelInformation());
 	p_Converter->setEffectList(&p_Loader->getLevelEffectList());
-}
\ No newline at end of file
+}
+
+int runPack(int argc, char* argv[])
+{
+	if(argc != 5)
+	{
+		std::cout << "Usage: " << argv[0] << " -pack _resourcelist_ _root_directory_ _out_file_" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	ArchiveConverter archive;
+	if(!archive.loadResourceList(argv[2]))
+	{
+		std::cout << "Error loading resource list: " << argv[2] << std::endl;
+		return EXIT_FAILURE;
+	}
+	if(!archive.writeFile(argv[3], argv[4]))
+	{
+		std::cout << "Error writing archive: " << argv[4] << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	for(const std::string& missing : archive.getMissingFiles())
+	{
+		std::cout << "Missing file, not packed: " << missing << std::endl;
+	}
+
+	return EXIT_SUCCESS;
+}
+
+int runTextureTable(int argc, char* argv[])
+{
+	if(argc != 4)
+	{
+		std::cout << "Usage: " << argv[0] << " -texturetable _texture_directory_ _out_file_" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	TextureTableConverter table;
+	if(!table.addDirectory(argv[2]))
+	{
+		std::cout << "Error loading texture directory: " << argv[2] << std::endl;
+		return EXIT_FAILURE;
+	}
+	if(!table.writeFile(argv[3]))
+	{
+		std::cout << "Error writing texture table: " << argv[3] << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	for(const std::string& unsupported : table.getUnsupportedTextures())
+	{
+		std::cout << "Unsupported texture format, not in table: " << unsupported << std::endl;
+	}
+	std::cout << table.getTextures().size() << " textures written to " << argv[3] << std::endl;
+
+	return EXIT_SUCCESS;
+}
+
+bool writeMaterialBundle(const ModelLoader& p_Loader, const TextureTable& p_Table, const std::string& p_ModelPath)
+{
+	MaterialBundleConverter bundle(p_Table);
+	for(const ModelLoader::Material& material : p_Loader.getMaterial())
+	{
+		bundle.addMaterial(material.m_MaterialID, material.m_DiffuseMap, material.m_NormalMap, material.m_SpecularMap);
+	}
+	for(const std::string& missing : bundle.getMissingTextures())
+	{
+		std::cout << "Texture not in texture table: " << missing << std::endl;
+	}
+	return bundle.writeFile(MaterialBundleConverter::getBundlePath(p_ModelPath));
+}
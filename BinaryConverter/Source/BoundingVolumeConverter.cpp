@@ -0,0 +1,181 @@
+#include "BoundingVolumeConverter.h"
+
+#include <MappedFile.h>
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+BoundingVolumeConverter::BoundingVolumeConverter()
+	: m_Radius(0.f)
+{
+}
+
+void BoundingVolumeConverter::clear()
+{
+	m_Corners.clear();
+	m_Corners.shrink_to_fit();
+	m_Radius = 0.f;
+}
+
+bool BoundingVolumeConverter::loadFile(std::string p_FilePath)
+{
+	MappedFile input;
+	if(!input.open(p_FilePath))
+	{
+		return false;
+	}
+
+	TextTokenizer tokenizer(input.getData(), input.getSize());
+	return readText(tokenizer);
+}
+
+bool BoundingVolumeConverter::readStream(std::istream& p_Input)
+{
+	const std::string text((std::istreambuf_iterator<char>(p_Input)), std::istreambuf_iterator<char>());
+	TextTokenizer tokenizer(text.data(), text.size());
+	return readText(tokenizer);
+}
+
+bool BoundingVolumeConverter::readText(TextTokenizer& p_Input)
+{
+	clear();
+
+	// Same layout as read by BVLoader::readHeader and BVLoader::readBoundingVolume
+	std::string meshName;
+	int numMaterials = 0, numVertices = 0, numFaces = 0;
+	p_Input.nextLine();
+	p_Input.nextLine();
+	p_Input.readToken();
+	p_Input.readInt(numMaterials);
+	p_Input.nextLine();
+	p_Input.readToken();
+	p_Input.readString(meshName);
+	p_Input.nextLine();
+	p_Input.readToken();
+	p_Input.readInt(numVertices);
+	// Lines run out all at once, so the last header line tells if all of them were there
+	const bool completeHeader = p_Input.nextLine();
+	p_Input.readToken();
+	p_Input.readInt(numFaces);
+
+	if(!completeHeader || numVertices <= 0 || numFaces <= 0)
+	{
+		return false;
+	}
+
+	p_Input.nextLine();
+	p_Input.nextLine();
+	std::vector<DirectX::XMFLOAT4> vertices;
+	vertices.reserve(numVertices);
+	for(int i = 0; i < numVertices; i++)
+	{
+		DirectX::XMFLOAT4 vertex;
+		p_Input.nextLine();
+		p_Input.readToken();
+		p_Input.readFloat(vertex.x);
+		p_Input.readFloat(vertex.y);
+		p_Input.readFloat(vertex.z);
+		if(p_Input.fail())
+		{
+			return false;
+		}
+
+		vertex.x *= -1.f * BoundingVolumeFormat::scale;
+		vertex.y *= BoundingVolumeFormat::scale;
+		vertex.z *= BoundingVolumeFormat::scale;
+		vertex.w = 1.f;
+		vertices.push_back(vertex);
+	}
+
+	p_Input.nextLine();
+	p_Input.nextLine();
+	p_Input.nextLine();
+	p_Input.nextLine();
+
+	m_Corners.reserve(numFaces * 3);
+	for(int i = 0; i < numFaces; i++)
+	{
+		p_Input.nextLine();
+		int index[3];
+		p_Input.readInt(index[0]);
+		p_Input.readToken();
+		p_Input.readInt(index[1]);
+		p_Input.readToken();
+		p_Input.readInt(index[2]);
+		if(p_Input.fail())
+		{
+			clear();
+			return false;
+		}
+
+		for(int k = 0; k < 3; k++)
+		{
+			if(index[k] < 0 || index[k] >= numVertices)
+			{
+				clear();
+				return false;
+			}
+			m_Corners.push_back(vertices[index[k]]);
+		}
+	}
+
+	float farthestDistance = 0.f;
+	for(const auto& corner : m_Corners)
+	{
+		float distance = corner.x * corner.x + corner.y * corner.y + corner.z * corner.z;
+		if(distance > farthestDistance)
+		{
+			farthestDistance = distance;
+		}
+	}
+	m_Radius = sqrtf(farthestDistance);
+
+	return true;
+}
+
+bool BoundingVolumeConverter::writeFile(std::string p_FilePath)
+{
+	if(m_Corners.empty())
+	{
+		return false;
+	}
+
+	std::ofstream output(p_FilePath, std::ostream::out | std::ostream::binary);
+	if(!output)
+	{
+		return false;
+	}
+
+	return writeStream(output);
+}
+
+bool BoundingVolumeConverter::writeStream(std::ostream& p_Output)
+{
+	if(m_Corners.empty())
+	{
+		return false;
+	}
+
+	BoundingVolumeFormat::Header header;
+	memcpy(header.m_Magic, BoundingVolumeFormat::magic, sizeof(header.m_Magic));
+	header.m_Version = BoundingVolumeFormat::version;
+	header.m_NumTriangles = m_Corners.size() / 3;
+	header.m_BoundingSphere = DirectX::XMFLOAT4(0.f, 0.f, 0.f, m_Radius);
+
+	p_Output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	p_Output.write(reinterpret_cast<const char*>(m_Corners.data()), m_Corners.size() * sizeof(DirectX::XMFLOAT4));
+
+	return !p_Output.fail();
+}
+
+const std::vector<DirectX::XMFLOAT4>& BoundingVolumeConverter::getCorners() const
+{
+	return m_Corners;
+}
+
+float BoundingVolumeConverter::getRadius() const
+{
+	return m_Radius;
+}
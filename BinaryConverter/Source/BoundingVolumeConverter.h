@@ -0,0 +1,83 @@
+#pragma once
+
+#include <BoundingVolumeFormat.h>
+#include <TextTokenizer.h>
+
+#include <DirectXMath.h>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * Converts text bounding volumes (.txc) to the binary .bbv format described
+ * in BoundingVolumeFormat.h. The corners are converted to meters and the
+ * surrounding sphere is calculated here, so the game does not have to.
+ */
+class BoundingVolumeConverter
+{
+private:
+	std::vector<DirectX::XMFLOAT4> m_Corners;
+	float m_Radius;
+
+public:
+	/**
+	 * Constructor.
+	 */
+	BoundingVolumeConverter();
+
+	/**
+	 * Use this function to release the memory in converter vectors.
+	 */
+	void clear();
+
+	/**
+	 * Loads a .txc bounding volume file.
+	 *
+	 * @param p_FilePath is the complete path to the source file.
+	 * @return false if the file could not be read.
+	 */
+	bool loadFile(std::string p_FilePath);
+
+	/**
+	 * Reads a .txc bounding volume from a stream.
+	 *
+	 * @param p_Input the text to read.
+	 * @return false if the header or any vertex or face could not be read.
+	 */
+	bool readStream(std::istream& p_Input);
+
+	/**
+	 * Reads a .txc bounding volume from tokenized text.
+	 *
+	 * @param p_Input the tokenizer, positioned before the first line.
+	 * @return false if the header or any vertex or face could not be read.
+	 */
+	bool readText(TextTokenizer& p_Input);
+
+	/**
+	 * Writes the loaded bounding volume as a .bbv file.
+	 *
+	 * @param p_FilePath is the complete path to the file to create.
+	 * @return false if nothing is loaded or the file could not be written.
+	 */
+	bool writeFile(std::string p_FilePath);
+
+	/**
+	 * Writes the loaded bounding volume in the .bbv format.
+	 *
+	 * @param p_Output a stream opened in binary mode.
+	 * @return false if nothing is loaded.
+	 */
+	bool writeStream(std::ostream& p_Output);
+
+	/**
+	 * @return the triangle corners in meters, three per triangle.
+	 */
+	const std::vector<DirectX::XMFLOAT4>& getCorners() const;
+
+	/**
+	 * @return the radius of the sphere around origo containing all corners, in meters.
+	 */
+	float getRadius() const;
+};
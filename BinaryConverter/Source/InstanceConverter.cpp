@@ -1,5 +1,8 @@
 #include "InstanceConverter.h"
 
+#include <algorithm>
+#include <cstring>
+
 InstanceConverter::InstanceConverter()
 {
 	m_Header.m_NumberOfModels = 0;
@@ -43,6 +46,7 @@ bool InstanceConverter::writeFile(std::string p_FilePath)
 		createLighting(&output);
 		createCheckPoints(&output);
 		createEffect(&output);
+		createSpatialIndex(&output);
 	}
 	else
 	{
@@ -60,7 +64,7 @@ void InstanceConverter::createHeader(std::ostream* p_Output)
 	intToByte(m_Header.m_NumberOfEffects, p_Output);
 }
 
-void InstanceConverter::createLevel(std::ostream* p_Output)
+std::vector<InstanceConverter::ModelData> InstanceConverter::groupModels() const
 {
 	std::vector<ModelData> level;
 	ModelData model;
@@ -102,6 +106,12 @@ void InstanceConverter::createLevel(std::ostream* p_Output)
 		}
 		written = false;
 	}
+	return level;
+}
+
+void InstanceConverter::createLevel(std::ostream* p_Output)
+{
+	std::vector<ModelData> level = groupModels();
 	intToByte(level.size(), p_Output);
 	for(unsigned int i = 0; i < level.size(); i++)
 	{
@@ -306,6 +316,76 @@ void InstanceConverter::createEffect(std::ostream* p_Output)
 	}
 }
 
+void InstanceConverter::createSpatialIndex(std::ostream* p_Output)
+{
+	using namespace LevelSpatialIndexFormat;
+
+	std::vector<ModelData> level = groupModels();
+
+	Header header;
+	memcpy(header.m_Magic, magic, sizeof(header.m_Magic));
+	header.m_Version = version;
+	header.m_NumInstances = 0;
+	header.m_BoundsMin = DirectX::XMFLOAT3(0.f, 0.f, 0.f);
+	header.m_BoundsMax = DirectX::XMFLOAT3(0.f, 0.f, 0.f);
+	for(const auto& model : level)
+	{
+		for(const auto& translation : model.m_Translation)
+		{
+			if(header.m_NumInstances == 0)
+			{
+				header.m_BoundsMin = translation;
+				header.m_BoundsMax = translation;
+			}
+			header.m_BoundsMin.x = (std::min)(header.m_BoundsMin.x, translation.x);
+			header.m_BoundsMin.y = (std::min)(header.m_BoundsMin.y, translation.y);
+			header.m_BoundsMin.z = (std::min)(header.m_BoundsMin.z, translation.z);
+			header.m_BoundsMax.x = (std::max)(header.m_BoundsMax.x, translation.x);
+			header.m_BoundsMax.y = (std::max)(header.m_BoundsMax.y, translation.y);
+			header.m_BoundsMax.z = (std::max)(header.m_BoundsMax.z, translation.z);
+			++header.m_NumInstances;
+		}
+	}
+	chooseCells(header.m_BoundsMin, header.m_BoundsMax, header.m_NumInstances, header.m_Cells);
+
+	// Counting sort by cell, keeping the model order within each cell
+	const uint32_t numCells = getNumCells(header);
+	std::vector<uint32_t> instanceCells;
+	instanceCells.reserve(header.m_NumInstances);
+	std::vector<uint32_t> cellStart(numCells + 1, 0);
+	for(const auto& model : level)
+	{
+		for(const auto& translation : model.m_Translation)
+		{
+			uint32_t cell = getCellIndex(header, translation);
+			instanceCells.push_back(cell);
+			++cellStart[cell + 1];
+		}
+	}
+	for(uint32_t i = 0; i < numCells; i++)
+	{
+		cellStart[i + 1] += cellStart[i];
+	}
+
+	std::vector<InstanceRef> instances(header.m_NumInstances);
+	std::vector<uint32_t> cellEnd(cellStart.begin(), cellStart.end() - 1);
+	unsigned int instance = 0;
+	for(unsigned int i = 0; i < level.size(); i++)
+	{
+		for(unsigned int j = 0; j < level.at(i).m_Translation.size(); j++)
+		{
+			InstanceRef& ref = instances[cellEnd[instanceCells[instance]]++];
+			ref.m_Model = i;
+			ref.m_Instance = j;
+			++instance;
+		}
+	}
+
+	p_Output->write(reinterpret_cast<const char*>(&header), sizeof(Header));
+	p_Output->write(reinterpret_cast<const char*>(cellStart.data()), sizeof(uint32_t) * cellStart.size());
+	p_Output->write(reinterpret_cast<const char*>(instances.data()), sizeof(InstanceRef) * instances.size());
+}
+
 void InstanceConverter::stringToByte(std::string p_String, std::ostream* p_Output)
 {
 	unsigned int size = p_String.size();
@@ -5,6 +5,7 @@
 #include <memory>
 #include <vector>
 #include "InstanceLoader.h"
+#include <LevelSpatialIndexFormat.h>
 
 class InstanceConverter
 {
@@ -135,4 +136,15 @@ protected:
 	void createLighting(std::ostream* p_Output);
 	void createCheckPoints(std::ostream* p_Output);
 	void InstanceConverter::createEffect(std::ostream* p_Output);
+
+	/**
+	 * Write the spatial index described in LevelSpatialIndexFormat.h, a grid
+	 * over the positions of the instances written by createLevel.
+	 */
+	void createSpatialIndex(std::ostream* p_Output);
+
+	/**
+	 * Group the instances by mesh name, in the order createLevel writes them.
+	 */
+	std::vector<ModelData> groupModels() const;
 };
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "InstanceLoader.h"
 
+#include <MappedFile.h>
+
 InstanceLoader::InstanceLoader()
 {
 	m_Header.m_NumberOfModels = 0;
@@ -32,84 +34,79 @@ void InstanceLoader::clear()
 	m_Header.m_NumberOfModels = 0;
 	m_Header.m_NumberOfLights = 0;
 	m_Header.m_NumberOfCheckPoints = 0;
-	m_Stringstream.clear();
 	m_ModelHeaders.clear();
 	m_ModelHeaders.shrink_to_fit();
 }
 
 bool InstanceLoader::loadLevel(std::string p_FilePath)
 {
-	std::ifstream input(p_FilePath, std::ifstream::in);
-	if(!input)
+	MappedFile input;
+	if(!input.open(p_FilePath))
 	{
 		return false;
 	}
 	clearData();
-	startReading(input);
+	TextTokenizer tokenizer(input.getData(), input.getSize());
+	startReading(tokenizer);
 	readModelHeaders(p_FilePath);
-	input.close();
 
 	return true;
 }
 
-void InstanceLoader::startReading(std::istream& p_Input)
+void InstanceLoader::startReading(TextTokenizer& p_Input)
 {
-	std::string line, key, filler;
-	while(!p_Input.eof() && std::getline(p_Input, line))
+	while(p_Input.nextLine())
 	{
-		key = "";
-		m_Stringstream = std::stringstream(line);
-		m_Stringstream >> key >> std::ws;
+		const TextTokenizer::Token key = p_Input.readToken();
 		if(key == "*ObjectHeader*")
 		{
 			m_Header.m_NumberOfModels = readHeader(p_Input);
-			std::getline(p_Input, line);
+			p_Input.nextLine();
 		}
 		else if(key == "*LightHeader*")
 		{
 			m_Header.m_NumberOfLights = readHeader(p_Input);
-			std::getline(p_Input, line);
+			p_Input.nextLine();
 		}
 		else if(key == "*CheckPointHeader*")
 		{
 			m_Header.m_NumberOfCheckPoints = readHeader(p_Input);
-			std::getline(p_Input, line);
+			p_Input.nextLine();
 		}
 		else if(key == "*EffectHeader*")
 		{
 			m_Header.m_NumberOfEffects = readHeader(p_Input);
-			std::getline(p_Input, line);
+			p_Input.nextLine();
 		}
 		else if(key == "#MESH:" || key == "#MESH")
 		{
 			readMeshList(p_Input);
-			std::getline(p_Input, line);
+			p_Input.nextLine();
 		}
 		else if(key == "#Light:")
 		{
 			readLightList(p_Input);
-			std::getline(p_Input, line);
+			p_Input.nextLine();
 		}
 		else if(key == "#Type:")
 		{
 			readCheckPointList(p_Input);
-			std::getline(p_Input, line);
+			p_Input.nextLine();
 		}
 		else if(key == "#Effect:")
 		{
 			readEffect(p_Input);
-			std::getline(p_Input, line);
+			p_Input.nextLine();
 		}
 	}
 }
 
-int InstanceLoader::readHeader(std::istream& p_Input)
+int InstanceLoader::readHeader(TextTokenizer& p_Input)
 {
-	std::string key, line;
-	int result;
-	std::getline(p_Input, line);
-	m_Stringstream = std::stringstream(line);
-	m_Stringstream >> key >> result;
+	int result = 0;
+	p_Input.nextLine();
+	p_Input.readToken();
+	p_Input.readInt(result);
 	return result;
 }
 
@@ -131,120 +128,98 @@ void InstanceLoader::readModelHeaders(std::string p_FilePath)
 	headerFile.close();
 }
 
-void InstanceLoader::readMeshList(std::istream& p_Input)
+void InstanceLoader::readFloat3(TextTokenizer& p_Input, DirectX::XMFLOAT3& p_Value)
+{
+	p_Input.nextLine();
+	p_Input.readToken();
+	p_Input.readFloat(p_Value.x);
+	p_Input.readFloat(p_Value.y);
+	p_Input.readFloat(p_Value.z);
+}
+
+void InstanceLoader::readMeshList(TextTokenizer& p_Input)
 {
-	std::string key, filler, line;
 	ModelStruct tempLevel;
-	m_Stringstream >> tempLevel.m_MeshName;
-	std::getline(p_Input, line);
-	m_Stringstream = std::stringstream(line);
-	m_Stringstream >> filler >> tempLevel.m_Translation.x >> tempLevel.m_Translation.y >> tempLevel.m_Translation.z;
-	std::getline(p_Input, line);
-	m_Stringstream = std::stringstream(line);
-	m_Stringstream >> filler >> tempLevel.m_Rotation.x >> tempLevel.m_Rotation.y >> tempLevel.m_Rotation.z;
-	std::getline(p_Input, line);
-	m_Stringstream = std::stringstream(line);
-	m_Stringstream >> filler >> tempLevel.m_Scale.x >> tempLevel.m_Scale.y >> tempLevel.m_Scale.z;
+	p_Input.readString(tempLevel.m_MeshName);
+	readFloat3(p_Input, tempLevel.m_Translation);
+	readFloat3(p_Input, tempLevel.m_Rotation);
+	readFloat3(p_Input, tempLevel.m_Scale);
 
 	m_ModelList.push_back(tempLevel);
 }
 
-void InstanceLoader::readLightList(std::istream& p_Input)
+void InstanceLoader::readLightList(TextTokenizer& p_Input)
 {
-	std::string key, filler, line, tempName;
 	LightData tempLight;
-	std::string tempString;
-	m_Stringstream >> tempName;
-	std::getline(p_Input, line);
-	m_Stringstream = std::stringstream(line);
-	m_Stringstream >> filler >> tempLight.m_Translation.x >> tempLight.m_Translation.y >> tempLight.m_Translation.z;
-	std::getline(p_Input, line);
-	m_Stringstream = std::stringstream(line);
-	m_Stringstream >> filler >> tempLight.m_Color.x >> tempLight.m_Color.y >> tempLight.m_Color.z;
-	std::getline(p_Input, line);
-	m_Stringstream = std::stringstream(line);
-	m_Stringstream >> filler >> tempString;
-	if(tempString == "kDirectionalLight")
+	p_Input.readToken();
+	readFloat3(p_Input, tempLight.m_Translation);
+	readFloat3(p_Input, tempLight.m_Color);
+	p_Input.nextLine();
+	p_Input.readToken();
+	const TextTokenizer::Token type = p_Input.readToken();
+	if(type == "kDirectionalLight")
 	{
 		tempLight.m_Type = 0;
 		DirectionalLight tempDirectional;
-		std::getline(p_Input, line);
-		m_Stringstream = std::stringstream(line);
-		m_Stringstream >> filler >> tempDirectional.m_Intensity;
-		std::getline(p_Input, line);
-		m_Stringstream = std::stringstream(line);
-		m_Stringstream >> filler >> tempDirectional.m_Direction.x >> tempDirectional.m_Direction.y >> tempDirectional.m_Direction.z;
+		p_Input.nextLine();
+		p_Input.readToken();
+		p_Input.readFloat(tempDirectional.m_Intensity);
+		readFloat3(p_Input, tempDirectional.m_Direction);
 		m_LevelDirectionalLightList.push_back(std::make_pair(tempLight,tempDirectional));
 	}
-	else if(tempString == "kPointLight")
+	else if(type == "kPointLight")
 	{
 		tempLight.m_Type = 1;
 		PointLight tempDirectional;
-		std::getline(p_Input, line);
-		m_Stringstream = std::stringstream(line);
-		m_Stringstream >> filler >> tempDirectional.m_Intensity;
+		p_Input.nextLine();
+		p_Input.readToken();
+		p_Input.readFloat(tempDirectional.m_Intensity);
 		m_LevelPointLightList.push_back(std::make_pair(tempLight,tempDirectional));
 	}
-	else if(tempString == "kSpotLight")
+	else if(type == "kSpotLight")
 	{
 		tempLight.m_Type = 2;
 		SpotLight tempSpot;
-		std::getline(p_Input, line);
-		m_Stringstream = std::stringstream(line);
-		m_Stringstream >> filler >> tempSpot.m_Intensity;
-		std::getline(p_Input, line);
-		m_Stringstream = std::stringstream(line);
-		m_Stringstream >> filler >> tempSpot.m_Direction.x >> tempSpot.m_Direction.y >> tempSpot.m_Direction.z;
-		std::getline(p_Input, line);
-		m_Stringstream = std::stringstream(line);
-		m_Stringstream >> filler >> tempSpot.m_ConeAngle >> tempSpot.m_PenumbraAngle;
+		p_Input.nextLine();
+		p_Input.readToken();
+		p_Input.readFloat(tempSpot.m_Intensity);
+		readFloat3(p_Input, tempSpot.m_Direction);
+		p_Input.nextLine();
+		p_Input.readToken();
+		p_Input.readFloat(tempSpot.m_ConeAngle);
+		p_Input.readFloat(tempSpot.m_PenumbraAngle);
 		m_LevelSpotLightList.push_back(std::make_pair(tempLight,tempSpot));
 	}
 }
 
-void InstanceLoader::readCheckPointList(std::istream& p_Input)
+void InstanceLoader::readCheckPointList(TextTokenizer& p_Input)
 {
-	std::string key, filler, line;
 	CheckPointStruct tempCheckPoint;
-	std::string tempString;
-	m_Stringstream >> tempString;
-	if(tempString == "Start")
+	const TextTokenizer::Token type = p_Input.readToken();
+	if(type == "Start")
 	{
-		std::getline(p_Input, line);
-		m_Stringstream = std::stringstream(line);
-		m_Stringstream >> filler >> m_CheckPointStart.x >> m_CheckPointStart.y >> m_CheckPointStart.z;
+		readFloat3(p_Input, m_CheckPointStart);
 	}
-	else if(tempString == "End")
+	else if(type == "End")
 	{
-		std::getline(p_Input, line);
-		m_Stringstream = std::stringstream(line);
-		m_Stringstream >> filler >> m_CheckPointEnd.x >> m_CheckPointEnd.y >> m_CheckPointEnd.z;
+		readFloat3(p_Input, m_CheckPointEnd);
 	}
 	else
 	{
-		std::getline(p_Input, line);
-		m_Stringstream = std::stringstream(line);
-		m_Stringstream >> filler >> tempCheckPoint.m_Number;
-		std::getline(p_Input, line);
-		m_Stringstream = std::stringstream(line);
-		m_Stringstream >> filler >> tempCheckPoint.m_Translation.x >> tempCheckPoint.m_Translation.y >> tempCheckPoint.m_Translation.z;
+		p_Input.nextLine();
+		p_Input.readToken();
+		p_Input.readInt(tempCheckPoint.m_Number);
+		readFloat3(p_Input, tempCheckPoint.m_Translation);
 		m_LevelCheckPointList.push_back(tempCheckPoint);
 	}
 }
 
-void InstanceLoader::readEffect(std::istream& p_Input)
+void InstanceLoader::readEffect(TextTokenizer& p_Input)
 {
-	std::string key, filler, line;
 	EffectStruct tempEffect;
-	std::string tempString;
-	m_Stringstream >> tempString;
-	tempEffect.m_EffectName = tempString;
-	std::getline(p_Input, line);
-	m_Stringstream = std::stringstream(line);
-	m_Stringstream >> filler >> tempEffect.m_Translation.x >> tempEffect.m_Translation.y >> tempEffect.m_Translation.z;
-	std::getline(p_Input, line);
-	m_Stringstream = std::stringstream(line);
-	m_Stringstream >> filler >> tempEffect.m_Rotation.x >> tempEffect.m_Rotation.y >> tempEffect.m_Rotation.z;
+	p_Input.readString(tempEffect.m_EffectName);
+	readFloat3(p_Input, tempEffect.m_Translation);
+	readFloat3(p_Input, tempEffect.m_Rotation);
 
 	m_EffectList.push_back(tempEffect);
 }
@@ -310,7 +285,6 @@ void InstanceLoader::clearData()
 	m_Header.m_NumberOfLights = 0;
 	m_Header.m_NumberOfCheckPoints = 0;
 	m_ModelHeaders.clear();
-	m_Stringstream.clear();
 }
 
 InstanceLoader::LevelHeader InstanceLoader::getLevelHeader()
@@ -6,6 +6,8 @@
 #include <memory>
 #include <vector>
 
+#include <TextTokenizer.h>
+
 class InstanceLoader
 {
 public:
@@ -72,7 +74,6 @@ private:
 	std::vector<std::pair<LightData,DirectionalLight>> m_LevelDirectionalLightList;
 	std::vector<std::pair<LightData,PointLight>> m_LevelPointLightList;
 	std::vector<std::pair<LightData,SpotLight>> m_LevelSpotLightList;
-	std::stringstream m_Stringstream;
 	LevelHeader m_Header;
 	std::vector<ModelHeader> m_ModelHeaders;
 public:
@@ -174,14 +175,18 @@ protected:
 	void byteToString(std::istream& p_Input, std::string& p_Return);
 	std::string getPath(std::string p_FilePath);
 
-	void startReading(std::istream& p_Input);
+	void startReading(TextTokenizer& p_Input);
 	void readModelHeaders(std::string p_FilePath);
-	int readHeader(std::istream& p_Input);
-	void readMeshList(std::istream& p_Input);
-	void readLightList(std::istream& p_Input);
-	void readCheckPointList(std::istream& p_Input);
-	void InstanceLoader::readEffect(std::istream& p_Input);
+	int readHeader(TextTokenizer& p_Input);
+	void readMeshList(TextTokenizer& p_Input);
+	void readLightList(TextTokenizer& p_Input);
+	void readCheckPointList(TextTokenizer& p_Input);
+	void InstanceLoader::readEffect(TextTokenizer& p_Input);
 
 private:
+	/**
+	 * Reads the next line as a key followed by three floats.
+	 */
+	static void readFloat3(TextTokenizer& p_Input, DirectX::XMFLOAT3& p_Value);
 	void clearData();
 };
\ No newline at end of file
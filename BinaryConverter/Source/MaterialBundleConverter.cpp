@@ -0,0 +1,87 @@
+#include "MaterialBundleConverter.h"
+
+#include <boost/filesystem.hpp>
+
+#include <cstring>
+#include <fstream>
+
+using namespace MaterialBundleFormat;
+
+MaterialBundleConverter::MaterialBundleConverter(const TextureTable& p_Table)
+	:	m_Table(&p_Table)
+{
+}
+
+void MaterialBundleConverter::clear()
+{
+	m_Materials.clear();
+	m_MissingTextures.clear();
+}
+
+void MaterialBundleConverter::addMaterial(const std::string& p_MaterialID, const std::string& p_DiffuseMap,
+	const std::string& p_NormalMap, const std::string& p_SpecularMap)
+{
+	Material material;
+	material.m_MaterialID = p_MaterialID;
+	material.m_Diffuse = findTexture(p_DiffuseMap, "Default_COLOR.dds");
+	material.m_Normal = findTexture(p_NormalMap, "Default_NRM.dds");
+	material.m_Specular = findTexture(p_SpecularMap, "Default_SPEC.dds");
+	m_Materials.push_back(material);
+}
+
+bool MaterialBundleConverter::writeFile(const std::string& p_OutputPath) const
+{
+	std::vector<MaterialEntry> entries;
+	std::string strings;
+	for (const auto& material : m_Materials)
+	{
+		MaterialEntry entry;
+		entry.m_IDOffset = static_cast<uint32_t>(strings.size());
+		entry.m_IDLength = static_cast<uint32_t>(material.m_MaterialID.size());
+		entry.m_Diffuse = material.m_Diffuse;
+		entry.m_Normal = material.m_Normal;
+		entry.m_Specular = material.m_Specular;
+		strings += material.m_MaterialID;
+		entries.push_back(entry);
+	}
+
+	BundleHeader header;
+	memcpy(header.m_Magic, bundleMagic, sizeof(header.m_Magic));
+	header.m_Version = version;
+	header.m_TableHash = m_Table->getHash();
+	header.m_NumMaterials = static_cast<uint32_t>(entries.size());
+	header.m_StringsSize = static_cast<uint32_t>(strings.size());
+
+	std::ofstream output(p_OutputPath, std::ostream::out | std::ostream::binary | std::ostream::trunc);
+	if (!output)
+	{
+		return false;
+	}
+
+	output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	output.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(MaterialEntry));
+	output.write(strings.data(), strings.size());
+
+	return static_cast<bool>(output);
+}
+
+const std::vector<std::string>& MaterialBundleConverter::getMissingTextures() const
+{
+	return m_MissingTextures;
+}
+
+std::string MaterialBundleConverter::getBundlePath(const std::string& p_ModelPath)
+{
+	return boost::filesystem::path(p_ModelPath).replace_extension(".bmb").string();
+}
+
+uint32_t MaterialBundleConverter::findTexture(const std::string& p_Map, const char* p_Default)
+{
+	const std::string name = (p_Map.empty() || p_Map == "NONE") ? p_Default : p_Map;
+	const uint32_t id = m_Table->find(name);
+	if (id == invalidTexture)
+	{
+		m_MissingTextures.push_back(name);
+	}
+	return id;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <TextureTable.h>
+
+#include <string>
+#include <vector>
+
+/**
+ * Writes the material bundle (.bmb) of a model, in the format described in
+ * MaterialBundleFormat.h.
+ *
+ * The texture names of the materials are resolved against a texture table
+ * when converting, using the same defaults for missing maps as the game, so
+ * the game gets texture IDs instead of names to resolve.
+ */
+class MaterialBundleConverter
+{
+private:
+	struct Material
+	{
+		std::string m_MaterialID;
+		uint32_t m_Diffuse;
+		uint32_t m_Normal;
+		uint32_t m_Specular;
+	};
+
+	const TextureTable* m_Table;
+	std::vector<Material> m_Materials;
+	std::vector<std::string> m_MissingTextures;
+
+public:
+	/**
+	 * Constructor.
+	 *
+	 * @param p_Table the texture table to resolve texture names against, must outlive the converter
+	 */
+	explicit MaterialBundleConverter(const TextureTable& p_Table);
+
+	/**
+	 * Remove all added materials.
+	 */
+	void clear();
+
+	/**
+	 * Add a material of the model, in the order the model stores them.
+	 * Maps named "NONE" use the default texture of their kind. Textures missing
+	 * from the table are reported by getMissingTextures.
+	 *
+	 * @param p_DiffuseMap the file name of the diffuse texture
+	 * @param p_NormalMap the file name of the normal map
+	 * @param p_SpecularMap the file name of the specular map
+	 */
+	void addMaterial(const std::string& p_MaterialID, const std::string& p_DiffuseMap,
+		const std::string& p_NormalMap, const std::string& p_SpecularMap);
+
+	/**
+	 * Write all added materials to a material bundle.
+	 *
+	 * @return false if the bundle could not be written
+	 */
+	bool writeFile(const std::string& p_OutputPath) const;
+
+	/**
+	 * The names of the textures that were not in the table.
+	 */
+	const std::vector<std::string>& getMissingTextures() const;
+
+	/**
+	 * The bundle path of a model, the model path with the extension replaced by .bmb.
+	 */
+	static std::string getBundlePath(const std::string& p_ModelPath);
+
+private:
+	uint32_t findTexture(const std::string& p_Map, const char* p_Default);
+};
@@ -0,0 +1,205 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	// Scoring constants from Tom Forsyth's "Linear-Speed Vertex Cache Optimisation"
+	const float cacheDecayPower = 1.5f;
+	const float lastTriangleScore = 0.75f;
+	const float valenceBoostScale = 2.f;
+	const float valenceBoostPower = 0.5f;
+
+	float vertexScore(int p_CachePosition, unsigned int p_RemainingTriangles)
+	{
+		if (p_RemainingTriangles == 0)
+		{
+			// Nothing left to draw with this vertex
+			return -1.f;
+		}
+
+		float score = 0.f;
+		if (p_CachePosition >= 0)
+		{
+			if (p_CachePosition < 3)
+			{
+				// Used by the last triangle, fixed score to not favour any of its edges
+				score = lastTriangleScore;
+			}
+			else
+			{
+				const float scaler = 1.f / (MeshOptimizer::cacheSize - 3);
+				score = std::pow(1.f - (p_CachePosition - 3) * scaler, cacheDecayPower);
+			}
+		}
+
+		// Prefer vertices with few triangles left, to get rid of lone triangles
+		score += valenceBoostScale * std::pow((float)p_RemainingTriangles, -valenceBoostPower);
+		return score;
+	}
+}
+
+void MeshOptimizer::optimizeTriangleOrder(std::vector<unsigned int>& p_Indices, unsigned int p_NumVertices)
+{
+	const unsigned int numTriangles = p_Indices.size() / 3;
+	if (numTriangles == 0 || p_Indices.size() % 3 != 0)
+	{
+		return;
+	}
+
+	// Triangles using each vertex, packed in one array. The first remaining[v] entries
+	// of vertex v are the triangles not yet emitted.
+	std::vector<unsigned int> remaining(p_NumVertices, 0);
+	for (unsigned int index : p_Indices)
+	{
+		++remaining[index];
+	}
+
+	std::vector<unsigned int> offsets(p_NumVertices + 1, 0);
+	for (unsigned int v = 0; v < p_NumVertices; ++v)
+	{
+		offsets[v + 1] = offsets[v] + remaining[v];
+	}
+
+	std::vector<unsigned int> adjacency(p_Indices.size());
+	std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+	for (unsigned int i = 0; i < p_Indices.size(); ++i)
+	{
+		adjacency[fill[p_Indices[i]]++] = i / 3;
+	}
+
+	std::vector<int> cachePosition(p_NumVertices, -1);
+	std::vector<float> vertexScores(p_NumVertices);
+	for (unsigned int v = 0; v < p_NumVertices; ++v)
+	{
+		vertexScores[v] = vertexScore(-1, remaining[v]);
+	}
+
+	std::vector<bool> emitted(numTriangles, false);
+	int best = -1;
+	float bestScore = -1.f;
+	for (unsigned int t = 0; t < numTriangles; ++t)
+	{
+		const float score = vertexScores[p_Indices[t * 3]] + vertexScores[p_Indices[t * 3 + 1]] + vertexScores[p_Indices[t * 3 + 2]];
+		if (score > bestScore)
+		{
+			bestScore = score;
+			best = t;
+		}
+	}
+
+	std::vector<unsigned int> output;
+	output.reserve(p_Indices.size());
+	std::vector<unsigned int> cache;
+	std::vector<unsigned int> newCache;
+	cache.reserve(cacheSize + 3);
+	newCache.reserve(cacheSize + 3);
+	unsigned int scanCursor = 0;
+
+	while (output.size() < p_Indices.size())
+	{
+		if (best < 0)
+		{
+			// Nothing in the cache has triangles left, continue with the next unused triangle
+			while (emitted[scanCursor])
+			{
+				++scanCursor;
+			}
+			best = scanCursor;
+		}
+
+		emitted[best] = true;
+		const unsigned int* triangle = &p_Indices[best * 3];
+		output.insert(output.end(), triangle, triangle + 3);
+
+		newCache.assign(triangle, triangle + 3);
+		for (unsigned int k = 0; k < 3; ++k)
+		{
+			// Move the triangle out of the vertex's remaining range
+			const unsigned int v = triangle[k];
+			unsigned int* begin = &adjacency[offsets[v]];
+			unsigned int* end = begin + remaining[v];
+			unsigned int* found = std::find(begin, end, (unsigned int)best);
+			std::swap(*found, *(end - 1));
+			--remaining[v];
+		}
+
+		for (unsigned int v : cache)
+		{
+			if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+			{
+				newCache.push_back(v);
+			}
+		}
+
+		for (unsigned int i = 0; i < newCache.size(); ++i)
+		{
+			const unsigned int v = newCache[i];
+			cachePosition[v] = i < cacheSize ? i : -1;
+			vertexScores[v] = vertexScore(cachePosition[v], remaining[v]);
+		}
+
+		// Rescore the triangles touching the changed vertices and pick the best one
+		best = -1;
+		bestScore = -1.f;
+		for (unsigned int v : newCache)
+		{
+			for (unsigned int j = offsets[v]; j < offsets[v] + remaining[v]; ++j)
+			{
+				const unsigned int t = adjacency[j];
+				const float score = vertexScores[p_Indices[t * 3]] + vertexScores[p_Indices[t * 3 + 1]] + vertexScores[p_Indices[t * 3 + 2]];
+				if (score > bestScore)
+				{
+					bestScore = score;
+					best = t;
+				}
+			}
+		}
+
+		if (newCache.size() > cacheSize)
+		{
+			newCache.resize(cacheSize);
+		}
+		cache.swap(newCache);
+	}
+
+	p_Indices.swap(output);
+}
+
+float MeshOptimizer::computeACMR(const std::vector<unsigned int>& p_Indices, unsigned int p_CacheSize)
+{
+	if (p_Indices.size() < 3)
+	{
+		return 0.f;
+	}
+
+	const unsigned int numVertices = *std::max_element(p_Indices.begin(), p_Indices.end()) + 1;
+
+	// The miss count when each vertex last entered the FIFO, 0 if it never did
+	std::vector<unsigned int> entered(numVertices, 0);
+	unsigned int misses = 0;
+	for (unsigned int index : p_Indices)
+	{
+		if (entered[index] == 0 || misses - entered[index] >= p_CacheSize)
+		{
+			++misses;
+			entered[index] = misses;
+		}
+	}
+
+	return (float)misses / (p_Indices.size() / 3);
+}
+
+size_t MeshOptimizer::hashBytes(const void* p_Data, size_t p_Size)
+{
+	// FNV-1a
+	const unsigned char* bytes = static_cast<const unsigned char*>(p_Data);
+	size_t hash = 2166136261u;
+	for (size_t i = 0; i < p_Size; ++i)
+	{
+		hash ^= bytes[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
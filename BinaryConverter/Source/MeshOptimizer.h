@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Turns expanded triangle lists into indexed meshes that are cheap to store and render.
+ *
+ * Identical vertices are welded into one, triangles are reordered for the
+ * post-transform vertex cache with Tom Forsyth's linear-speed algorithm and the
+ * vertices are then renumbered in the order they are first used, so the vertex
+ * fetches follow the index buffer.
+ */
+class MeshOptimizer
+{
+public:
+	/**
+	 * The size of the simulated vertex cache, in vertices.
+	 */
+	static const unsigned int cacheSize = 32;
+
+	/**
+	 * Merge bitwise identical vertices.
+	 *
+	 * @param p_Corners one vertex per triangle corner, three per triangle
+	 * @param p_Vertices receives the unique vertices, in order of first appearance
+	 * @return one index into p_Vertices per corner
+	 */
+	template <typename Vertex>
+	static std::vector<unsigned int> weld(const std::vector<Vertex>& p_Corners, std::vector<Vertex>& p_Vertices)
+	{
+		std::vector<unsigned int> indices;
+		indices.reserve(p_Corners.size());
+		p_Vertices.clear();
+
+		std::unordered_multimap<size_t, unsigned int> lookup;
+		lookup.reserve(p_Corners.size());
+		for (const Vertex& corner : p_Corners)
+		{
+			const size_t hash = hashBytes(&corner, sizeof(Vertex));
+
+			unsigned int index = p_Vertices.size();
+			auto range = lookup.equal_range(hash);
+			for (auto it = range.first; it != range.second; ++it)
+			{
+				if (memcmp(&p_Vertices[it->second], &corner, sizeof(Vertex)) == 0)
+				{
+					index = it->second;
+					break;
+				}
+			}
+
+			if (index == p_Vertices.size())
+			{
+				p_Vertices.push_back(corner);
+				lookup.insert(std::make_pair(hash, index));
+			}
+			indices.push_back(index);
+		}
+
+		return indices;
+	}
+
+	/**
+	 * Reorder the triangles of an indexed triangle list to reuse the vertex cache.
+	 *
+	 * @param p_Indices the triangle list, reordered in place. Left unchanged if it is not whole triangles.
+	 * @param p_NumVertices the number of vertices referenced by the indices
+	 */
+	static void optimizeTriangleOrder(std::vector<unsigned int>& p_Indices, unsigned int p_NumVertices);
+
+	/**
+	 * Renumber the vertices in the order the indices first use them.
+	 *
+	 * @param p_Indices the triangle list, remapped in place
+	 * @param p_Vertices the vertices, reordered in place. Unreferenced vertices are removed.
+	 */
+	template <typename Vertex>
+	static void optimizeVertexOrder(std::vector<unsigned int>& p_Indices, std::vector<Vertex>& p_Vertices)
+	{
+		static const unsigned int unused = ~0u;
+		std::vector<unsigned int> remap(p_Vertices.size(), unused);
+		std::vector<Vertex> ordered;
+		ordered.reserve(p_Vertices.size());
+
+		for (unsigned int& index : p_Indices)
+		{
+			if (remap[index] == unused)
+			{
+				remap[index] = ordered.size();
+				ordered.push_back(p_Vertices[index]);
+			}
+			index = remap[index];
+		}
+
+		p_Vertices.swap(ordered);
+	}
+
+	/**
+	 * Simulate a FIFO post-transform cache of cacheSize vertices.
+	 *
+	 * @param p_Indices the triangle list
+	 * @param p_CacheSize the number of vertices the simulated cache holds
+	 * @return the average number of vertices transformed per triangle, between 0.5 and 3 for real meshes
+	 */
+	static float computeACMR(const std::vector<unsigned int>& p_Indices, unsigned int p_CacheSize);
+
+private:
+	static size_t hashBytes(const void* p_Data, size_t p_Size);
+};
@@ -1,6 +1,12 @@
 #pragma warning(disable : 4996)
 #include "ModelConverter.h"
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cstdint>
 #include <fstream>
+#include <mutex>
+
+const char ModelConverter::indexedMagic[4] = { 'B', 'T', 'X', 'I' };
 
 ModelConverter::ModelConverter()
 {
@@ -11,6 +17,11 @@ ModelConverter::ModelConverter()
 	m_IndexPerMaterialSize = 0;
 	m_ListOfJointsSize = 0;
 	m_WeightsListSize = 0;
+	m_CompressAnimation = false;
+	m_EmbedMetadata = false;
+	m_IndexedOutput = true;
+	m_Statistics = MeshStatistics();
+	m_CompactVertices = false;
 }
 
 ModelConverter::~ModelConverter()
@@ -45,27 +56,65 @@ bool ModelConverter::writeFile(std::string p_FilePath)
 	{
 		return false;
 	}
-	createHeader(&output); 
+	if(m_IndexedOutput)
+	{
+		buildIndexedMesh();
+		createIndexedHeader(&output);
+	}
+	else
+	{
+		createHeader(&output);
+	}
 	createModelHeaderFile(p_FilePath);
 	createMaterial(&output);
 	if(m_WeightsListSize != 0)
 	{
-		createVertexBufferAnimation(&output);
+		if(m_IndexedOutput)
+		{
+			createIndexedVertexBuffer(&output);
+		}
+		else
+		{
+			createVertexBufferAnimation(&output);
+		}
 
 		std::vector<char> outputBuffer(p_FilePath.size()+1);
 		strcpy(outputBuffer.data(), p_FilePath.c_str());
 		int length = outputBuffer.size();
 		strcpy(outputBuffer.data()+length-5, ".atx");
 		std::ofstream outputAnimation(outputBuffer.data(), std::ostream::out | std::ostream::binary);
-		createAnimationHeader(&outputAnimation);
-		createJointBuffer(&outputAnimation);
+		if (m_CompressAnimation)
+		{
+			createCompressedAnimation(&outputAnimation);
+		}
+		else
+		{
+			createAnimationHeader(&outputAnimation);
+			createJointBuffer(&outputAnimation);
+		}
+		if(m_EmbedMetadata)
+		{
+			m_AnimationMetadata.write(outputAnimation);
+		}
 		outputAnimation.close();
 	}
+	else if(m_IndexedOutput)
+	{
+		createIndexedVertexBuffer(&output);
+	}
 	else
 	{
 		createVertexBuffer(&output); 
 	}
+	if(m_IndexedOutput)
+	{
+		createIndexBuffer(&output);
+	}
 	createMaterialBuffer(&output);
+	if(m_IndexedOutput)
+	{
+		m_Statistics.m_FileSize = output.tellp();
+	}
 	output.close();
 	clearData();
 	return true;
@@ -91,6 +140,28 @@ void ModelConverter::createHeader(std::ostream* p_Output)
 	intToByte(m_Collidable, p_Output);
 }
 
+void ModelConverter::createIndexedHeader(std::ostream* p_Output)
+{
+	p_Output->write(indexedMagic, sizeof(indexedMagic));
+	intToByte(indexedVersion, p_Output);
+	stringToByte(m_MeshName, p_Output);
+	intToByte(m_MaterialSize, p_Output);
+	m_VertexCount = m_Statistics.m_Vertices;
+	intToByte(m_VertexCount, p_Output);
+	intToByte(m_IndexPerMaterialSize, p_Output);
+	m_Animated = m_ListOfJointsSize != 0;
+	intToByte(m_Animated, p_Output);
+	intToByte(m_Transparency, p_Output);
+	intToByte(m_Collidable, p_Output);
+	intToByte(m_Statistics.m_IndexSize, p_Output);
+	intToByte(m_MeshIndices.size(), p_Output);
+	intToByte(m_Statistics.m_Compact ? VertexQuantizer::compactFormat : VertexQuantizer::floatFormat, p_Output);
+	if(m_Statistics.m_Compact)
+	{
+		p_Output->write(reinterpret_cast<const char*>(&m_CompactBounds), sizeof(m_CompactBounds));
+	}
+}
+
 void ModelConverter::createAnimationHeader(std::ostream* p_AnimationOutput)
 {
 	stringToByte(m_MeshName, p_AnimationOutput);
@@ -98,6 +169,34 @@ void ModelConverter::createAnimationHeader(std::ostream* p_AnimationOutput)
 	intToByte(m_NumberOfFrames, p_AnimationOutput);
 }
 
+void ModelConverter::createVertex(const ModelLoader::IndexDesc& p_Desc, VertexBuffer& p_Vertex) const
+{
+	const DirectX::XMFLOAT3& vertexPos = m_Vertices->at(p_Desc.m_Vertex);
+
+	p_Vertex.m_Position = DirectX::XMFLOAT4(vertexPos.x, vertexPos.y, vertexPos.z, 1.0f);
+	p_Vertex.m_Normal = m_Normals->at(p_Desc.m_Normal);
+	p_Vertex.m_UV = m_TextureCoord->at(p_Desc.m_TextureCoord);
+	p_Vertex.m_Tangent = m_Tangents->at(p_Desc.m_Tangent);
+	DirectX::XMStoreFloat3(&p_Vertex.m_Binormal, DirectX::XMVector3Cross(DirectX::XMLoadFloat3(&p_Vertex.m_Tangent),DirectX::XMLoadFloat3(&p_Vertex.m_Normal)));
+	p_Vertex.m_Position.x *= -1.f;
+	p_Vertex.m_Normal.x *= -1.f;
+	p_Vertex.m_Tangent.x *= -1.f;
+	p_Vertex.m_Binormal.x *= -1.f;
+}
+
+void ModelConverter::createVertex(const ModelLoader::IndexDesc& p_Desc, VertexBufferAnimation& p_Vertex) const
+{
+	const DirectX::XMFLOAT3& vertexPos = m_Vertices->at(p_Desc.m_Vertex);
+
+	p_Vertex.m_Position = DirectX::XMFLOAT4(vertexPos.x,vertexPos.y,vertexPos.z, 1.0f);
+	p_Vertex.m_Normal = m_Normals->at(p_Desc.m_Normal);
+	p_Vertex.m_UV = m_TextureCoord->at(p_Desc.m_TextureCoord);
+	p_Vertex.m_Tangent = m_Tangents->at(p_Desc.m_Tangent);
+	DirectX::XMStoreFloat3(&p_Vertex.m_Binormal, DirectX::XMVector3Cross(DirectX::XMLoadFloat3(&p_Vertex.m_Tangent),DirectX::XMLoadFloat3(&p_Vertex.m_Normal)));
+	p_Vertex.m_Weight = m_WeightsList->at(p_Desc.m_Vertex).first;
+	p_Vertex.m_Joint = m_WeightsList->at(p_Desc.m_Vertex).second;
+}
+
 void ModelConverter::createVertexBuffer(std::ostream* p_Output)
 {
 	VertexBuffer temp;
@@ -107,15 +206,7 @@ void ModelConverter::createVertexBuffer(std::ostream* p_Output)
 		int tempsize = m_IndexPerMaterial->at(i).size()-1;
 		for(int j = tempsize; j >= 0 ; j--)
 		{
-			temp.m_Position = DirectX::XMFLOAT4(m_Vertices->at(m_IndexPerMaterial->at(i).at(j).m_Vertex).x,m_Vertices->at(m_IndexPerMaterial->at(i).at(j).m_Vertex).y,m_Vertices->at(m_IndexPerMaterial->at(i).at(j).m_Vertex).z, 1.0f);
-			temp.m_Normal = m_Normals->at(m_IndexPerMaterial->at(i).at(j).m_Normal);
-			temp.m_UV = m_TextureCoord->at(m_IndexPerMaterial->at(i).at(j).m_TextureCoord);
-			temp.m_Tangent = m_Tangents->at(m_IndexPerMaterial->at(i).at(j).m_Tangent);
-			DirectX::XMStoreFloat3(&temp.m_Binormal, DirectX::XMVector3Cross(DirectX::XMLoadFloat3(&temp.m_Tangent),DirectX::XMLoadFloat3(&temp.m_Normal)));
-			temp.m_Position.x *= -1.f;
-			temp.m_Normal.x *= -1.f;
-			temp.m_Tangent.x *= -1.f;
-			temp.m_Binormal.x *= -1.f;
+			createVertex(m_IndexPerMaterial->at(i).at(j), temp);
 			tempVertex.push_back(temp);
 		}
 	}
@@ -132,24 +223,194 @@ void ModelConverter::createVertexBufferAnimation(std::ostream* p_Output)
 		int tempsize = m_IndexPerMaterial->at(i).size()-1;
 		for(int j = tempsize; j >= 0 ; j--)
 		{
-			const ModelLoader::IndexDesc& desc = m_IndexPerMaterial->at(i).at(j);
-			const DirectX::XMFLOAT3& vertexPos = m_Vertices->at(desc.m_Vertex);
-
-			temp.m_Position = DirectX::XMFLOAT4(vertexPos.x,vertexPos.y,vertexPos.z, 1.0f);
-			temp.m_Normal = m_Normals->at(desc.m_Normal);
-			temp.m_UV = m_TextureCoord->at(desc.m_TextureCoord);
-			temp.m_Tangent = m_Tangents->at(desc.m_Tangent);
-			DirectX::XMStoreFloat3(&temp.m_Binormal, DirectX::XMVector3Cross(DirectX::XMLoadFloat3(&temp.m_Tangent),DirectX::XMLoadFloat3(&temp.m_Normal)));
-			temp.m_Weight = m_WeightsList->at(desc.m_Vertex).first;
-			temp.m_Joint = m_WeightsList->at(desc.m_Vertex).second;
+			createVertex(m_IndexPerMaterial->at(i).at(j), temp);
 			tempVertex.push_back(temp);
 		}
 	}
 	p_Output->write(reinterpret_cast<const char*>(tempVertex.data()), sizeof(VertexBufferAnimation) * tempVertex.size());
 }
 
+void ModelConverter::buildIndexedMesh()
+{
+	if(m_WeightsListSize != 0)
+	{
+		buildIndexedMesh(m_IndexedVerticesAnimation);
+	}
+	else
+	{
+		buildIndexedMesh(m_IndexedVertices);
+	}
+	quantizeVertices();
+}
+
+void ModelConverter::quantizeVertices()
+{
+	m_CompactStaticVertices.clear();
+	m_CompactSkinnedVertices.clear();
+	m_Statistics.m_Compact = false;
+	m_Statistics.m_QuantizationError = VertexQuantizer::Error();
+	if(!m_CompactVertices)
+	{
+		return;
+	}
+
+	VertexQuantizer::Error& error = m_Statistics.m_QuantizationError;
+	if(m_WeightsListSize != 0)
+	{
+		for(const VertexBufferAnimation& vertex : m_IndexedVerticesAnimation)
+		{
+			if(!VertexQuantizer::canEncodeSkin(vertex.m_Joint))
+			{
+				m_CompactSkinnedVertices.clear();
+				return;
+			}
+		}
+
+		m_CompactBounds = VertexQuantizer::computeBounds(m_IndexedVerticesAnimation.empty() ? nullptr : &m_IndexedVerticesAnimation[0].m_Position,
+			m_IndexedVerticesAnimation.size(), sizeof(VertexBufferAnimation));
+		m_CompactSkinnedVertices.resize(m_IndexedVerticesAnimation.size());
+		for(unsigned int i = 0; i < m_IndexedVerticesAnimation.size(); i++)
+		{
+			const VertexBufferAnimation& vertex = m_IndexedVerticesAnimation[i];
+			VertexQuantizer::CompactSkinnedVertex& compact = m_CompactSkinnedVertices[i];
+			VertexQuantizer::encode(vertex.m_Position, vertex.m_Normal, vertex.m_UV, vertex.m_Tangent, vertex.m_Binormal,
+				m_CompactBounds, compact.m_Vertex);
+			VertexQuantizer::encodeSkin(vertex.m_Weight, vertex.m_Joint, compact.m_Skin);
+			VertexQuantizer::measureError(vertex.m_Position, vertex.m_Normal, vertex.m_UV, vertex.m_Tangent, vertex.m_Binormal,
+				compact.m_Vertex, m_CompactBounds, error);
+			VertexQuantizer::measureSkinError(vertex.m_Weight, vertex.m_Joint, compact.m_Skin, error);
+		}
+		m_Statistics.m_VertexSize = sizeof(VertexQuantizer::CompactSkinnedVertex);
+	}
+	else
+	{
+		m_CompactBounds = VertexQuantizer::computeBounds(m_IndexedVertices.empty() ? nullptr : &m_IndexedVertices[0].m_Position,
+			m_IndexedVertices.size(), sizeof(VertexBuffer));
+		m_CompactStaticVertices.resize(m_IndexedVertices.size());
+		for(unsigned int i = 0; i < m_IndexedVertices.size(); i++)
+		{
+			const VertexBuffer& vertex = m_IndexedVertices[i];
+			VertexQuantizer::encode(vertex.m_Position, vertex.m_Normal, vertex.m_UV, vertex.m_Tangent, vertex.m_Binormal,
+				m_CompactBounds, m_CompactStaticVertices[i]);
+			VertexQuantizer::measureError(vertex.m_Position, vertex.m_Normal, vertex.m_UV, vertex.m_Tangent, vertex.m_Binormal,
+				m_CompactStaticVertices[i], m_CompactBounds, error);
+		}
+		m_Statistics.m_VertexSize = sizeof(VertexQuantizer::CompactVertex);
+	}
+	m_Statistics.m_Compact = true;
+}
+
+void ModelConverter::createIndexedVertexBuffer(std::ostream* p_Output)
+{
+	if(m_Statistics.m_Compact)
+	{
+		if(m_WeightsListSize != 0)
+		{
+			p_Output->write(reinterpret_cast<const char*>(m_CompactSkinnedVertices.data()), sizeof(VertexQuantizer::CompactSkinnedVertex) * m_CompactSkinnedVertices.size());
+		}
+		else
+		{
+			p_Output->write(reinterpret_cast<const char*>(m_CompactStaticVertices.data()), sizeof(VertexQuantizer::CompactVertex) * m_CompactStaticVertices.size());
+		}
+	}
+	else if(m_WeightsListSize != 0)
+	{
+		p_Output->write(reinterpret_cast<const char*>(m_IndexedVerticesAnimation.data()), sizeof(VertexBufferAnimation) * m_IndexedVerticesAnimation.size());
+	}
+	else
+	{
+		p_Output->write(reinterpret_cast<const char*>(m_IndexedVertices.data()), sizeof(VertexBuffer) * m_IndexedVertices.size());
+	}
+}
+
+template <typename Vertex>
+void ModelConverter::buildIndexedMesh(std::vector<Vertex>& p_Vertices)
+{
+	m_Statistics = MeshStatistics();
+	p_Vertices.clear();
+	m_MeshIndices.clear();
+	m_IndexRanges.clear();
+
+	std::vector<unsigned int> originalOrder;
+	std::vector<Vertex> corners;
+	std::vector<Vertex> vertices;
+	unsigned int largestRange = 0;
+	for(int i = 0; i < m_IndexPerMaterialSize; i++)
+	{
+		// Same corner order as the expanded format, which reverses the winding
+		const std::vector<ModelLoader::IndexDesc>& material = m_IndexPerMaterial->at(i);
+		corners.resize(material.size());
+		for(unsigned int j = 0; j < material.size(); j++)
+		{
+			createVertex(material[material.size() - 1 - j], corners[j]);
+		}
+
+		std::vector<unsigned int> indices = MeshOptimizer::weld(corners, vertices);
+
+		IndexRange range;
+		range.m_Start = m_MeshIndices.size();
+		range.m_Count = indices.size();
+		range.m_BaseVertex = p_Vertices.size();
+		for(unsigned int index : indices)
+		{
+			originalOrder.push_back(range.m_BaseVertex + index);
+		}
+
+		MeshOptimizer::optimizeTriangleOrder(indices, vertices.size());
+		MeshOptimizer::optimizeVertexOrder(indices, vertices);
+
+		m_MeshIndices.insert(m_MeshIndices.end(), indices.begin(), indices.end());
+		p_Vertices.insert(p_Vertices.end(), vertices.begin(), vertices.end());
+		m_IndexRanges.push_back(range);
+
+		largestRange = (std::max)(largestRange, (unsigned int)vertices.size());
+		m_Statistics.m_Corners += corners.size();
+	}
+
+	// 16-bit indices are enough as long as every material range has few enough vertices
+	m_Statistics.m_IndexSize = largestRange <= 0x10000 ? 2 : 4;
+	m_Statistics.m_Vertices = p_Vertices.size();
+	m_Statistics.m_VertexSize = sizeof(Vertex);
+	m_Statistics.m_ACMRBefore = MeshOptimizer::computeACMR(originalOrder, MeshOptimizer::cacheSize);
+
+	std::vector<unsigned int> optimizedOrder(m_MeshIndices.size());
+	for(const IndexRange& range : m_IndexRanges)
+	{
+		for(unsigned int j = range.m_Start; j < range.m_Start + range.m_Count; j++)
+		{
+			optimizedOrder[j] = range.m_BaseVertex + m_MeshIndices[j];
+		}
+	}
+	m_Statistics.m_ACMRAfter = MeshOptimizer::computeACMR(optimizedOrder, MeshOptimizer::cacheSize);
+}
+
+void ModelConverter::createIndexBuffer(std::ostream* p_Output)
+{
+	if(m_Statistics.m_IndexSize == 2)
+	{
+		std::vector<uint16_t> shortIndices(m_MeshIndices.begin(), m_MeshIndices.end());
+		p_Output->write(reinterpret_cast<const char*>(shortIndices.data()), sizeof(uint16_t) * shortIndices.size());
+	}
+	else
+	{
+		p_Output->write(reinterpret_cast<const char*>(m_MeshIndices.data()), sizeof(unsigned int) * m_MeshIndices.size());
+	}
+}
+
 void ModelConverter::createMaterialBuffer(std::ostream* p_Output)
 {
+	if(!m_IndexRanges.empty())
+	{
+		for(int j = 0; j < m_IndexPerMaterialSize; j++)
+		{
+			stringToByte(m_IndexPerMaterial->at(j).at(0).m_MaterialID,p_Output);
+			intToByte(m_IndexRanges[j].m_Start, p_Output);
+			intToByte(m_IndexRanges[j].m_Count, p_Output);
+			intToByte(m_IndexRanges[j].m_BaseVertex, p_Output);
+		}
+		return;
+	}
+
 	int start = 0;
 	for(int j = 0; j < m_IndexPerMaterialSize; j++)
 	{
@@ -184,6 +445,28 @@ void ModelConverter::createJointBuffer(std::ostream* p_Output)
 	}
 }
 
+void ModelConverter::createCompressedAnimation(std::ostream* p_Output)
+{
+	std::vector<Joint> joints(m_ListOfJointsSize);
+	for(int i = 0; i < m_ListOfJointsSize; i++)
+	{
+		const ModelLoader::Joint& source = m_ListOfJoints->at(i);
+		joints[i].m_JointName = source.m_JointName;
+		joints[i].m_ID = source.m_ID;
+		joints[i].m_Parent = source.m_Parent;
+		joints[i].m_TotalJointOffset = source.m_JointOffsetMatrix;
+		joints[i].m_JointAnimation.resize(m_NumberOfFrames);
+		for(int j = 0; j < m_NumberOfFrames; j++)
+		{
+			joints[i].m_JointAnimation[j].m_Trans = source.m_JointAnimation[j].m_Trans;
+			joints[i].m_JointAnimation[j].m_Rot = source.m_JointAnimation[j].m_Rot;
+			joints[i].m_JointAnimation[j].m_Scale = source.m_JointAnimation[j].m_Scale;
+		}
+	}
+
+	AnimationCompressor::write(*p_Output, m_MeshName, joints, m_NumberOfFrames, m_CompressionSettings);
+}
+
 void ModelConverter::stringToByte(std::string p_String, std::ostream* p_Output)
 {
 	int size = p_String.size();
@@ -255,6 +538,33 @@ void ModelConverter::setNumberOfFrames(int p_NumberOfFrames)
 	m_NumberOfFrames = p_NumberOfFrames;
 }
 
+void ModelConverter::setAnimationCompression(bool p_Compress, const AnimationCompressor::Settings& p_Settings)
+{
+	m_CompressAnimation = p_Compress;
+	m_CompressionSettings = p_Settings;
+}
+
+void ModelConverter::setAnimationMetadata(const AnimationMetadata& p_Metadata)
+{
+	m_EmbedMetadata = true;
+	m_AnimationMetadata = p_Metadata;
+}
+
+void ModelConverter::setIndexedOutput(bool p_Indexed)
+{
+	m_IndexedOutput = p_Indexed;
+}
+
+void ModelConverter::setCompactVertices(bool p_Compact)
+{
+	m_CompactVertices = p_Compact;
+}
+
+const ModelConverter::MeshStatistics& ModelConverter::getStatistics() const
+{
+	return m_Statistics;
+}
+
 void ModelConverter::setMeshName(std::string p_MeshName)
 {
 	m_MeshName = p_MeshName;
@@ -294,8 +604,17 @@ std::string ModelConverter::getPath(std::string p_FilePath)
 	return temp;
 }
 
+namespace
+{
+	/**
+	 * All models of a level share one header file, BatchConverter writes models from several threads.
+	 */
+	std::mutex modelHeaderFileLock;
+}
+
 bool ModelConverter::createModelHeaderFile(std::string p_FilePath)
 {
+	std::lock_guard<std::mutex> lock(modelHeaderFileLock);
 	std::string path = getPath(p_FilePath);
 	std::fstream headerOutput(path, std::fstream::in | std::fstream::out | std::fstream::binary);
 	if(!headerOutput)
@@ -365,4 +684,10 @@ void ModelConverter::clearData()
 	m_ListOfJointsSize = 0;
 	m_WeightsListSize = 0;
 	m_MeshName = "";
+	m_IndexedVertices.clear();
+	m_IndexedVerticesAnimation.clear();
+	m_MeshIndices.clear();
+	m_IndexRanges.clear();
+	m_CompactStaticVertices.clear();
+	m_CompactSkinnedVertices.clear();
 }
\ No newline at end of file
@@ -6,6 +6,10 @@
 #include <vector>
 #include "ModelLoader.h"
 
+#include <AnimationCompressor.h>
+#include <AnimationMetadata.h>
+#include <VertexQuantizer.h>
+
 class ModelConverter
 {
 public:
@@ -41,6 +45,42 @@ public:
 		int length;
 	};
 
+	/**
+	 * The part of the index buffer drawn with one material. The indices are
+	 * relative to m_BaseVertex, so each range fits in 16-bit indices on its own.
+	 */
+	struct IndexRange
+	{
+		unsigned int m_Start;
+		unsigned int m_Count;
+		unsigned int m_BaseVertex;
+	};
+
+	/**
+	 * Numbers describing the last written indexed model.
+	 */
+	struct MeshStatistics
+	{
+		unsigned int m_Corners;
+		unsigned int m_Vertices;
+		unsigned int m_VertexSize;
+		unsigned int m_IndexSize;
+		float m_ACMRBefore;
+		float m_ACMRAfter;
+		std::streamoff m_FileSize;
+		/**
+		 * If the vertices were written in the compact layout, and how far they are from the source.
+		 */
+		bool m_Compact;
+		VertexQuantizer::Error m_QuantizationError;
+	};
+
+	/**
+	 * The first four bytes of an indexed model file, never a valid mesh name length.
+	 */
+	static const char indexedMagic[4];
+	static const int indexedVersion = 2;
+
 private:
 	std::string m_MeshName;
 	std::vector<ModelLoader::IndexDesc>* m_Indices;
@@ -56,6 +96,24 @@ private:
 	const std::vector<ModelLoader::Joint>* m_ListOfJoints;
 
 	int m_VertexCount;
+
+	bool m_CompressAnimation;
+	AnimationCompressor::Settings m_CompressionSettings;
+
+	bool m_EmbedMetadata;
+	AnimationMetadata m_AnimationMetadata;
+
+	bool m_IndexedOutput;
+	std::vector<VertexBuffer> m_IndexedVertices;
+	std::vector<VertexBufferAnimation> m_IndexedVerticesAnimation;
+	std::vector<unsigned int> m_MeshIndices;
+	std::vector<IndexRange> m_IndexRanges;
+	MeshStatistics m_Statistics;
+
+	bool m_CompactVertices;
+	VertexQuantizer::Bounds m_CompactBounds;
+	std::vector<VertexQuantizer::CompactVertex> m_CompactStaticVertices;
+	std::vector<VertexQuantizer::CompactSkinnedVertex> m_CompactSkinnedVertices;
 public:
 	
 	/**
@@ -167,20 +225,71 @@ public:
 	 */
 	void setMeshName(std::string p_MeshName);
 
+	/**
+	 * Write the .atx file with AnimationCompressor instead of raw key frames.
+	 *
+	 * @param p_Compress true to compress the animation
+	 * @param p_Settings the error bounds for the compression
+	 */
+	void setAnimationCompression(bool p_Compress, const AnimationCompressor::Settings& p_Settings);
+
+	/**
+	 * Append the clips, IK groups, paths and grab shells of the model to the .atx file,
+	 * so the animation and its metadata are loaded with a single read.
+	 *
+	 * @param p_Metadata the metadata from the .mlx file next to the model
+	 */
+	void setAnimationMetadata(const AnimationMetadata& p_Metadata);
+
+	/**
+	 * Choose between the indexed file format and the old expanded triangle list.
+	 * Indexed output welds identical vertices, reorders the triangles of each material
+	 * for the vertex cache and is the default.
+	 *
+	 * @param p_Indexed true to write indexed models
+	 */
+	void setIndexedOutput(bool p_Indexed);
+
+	/**
+	 * Write indexed models with the compact vertex layout from VertexQuantizer, which
+	 * uses a third of the memory. Skinned models referring to joints past
+	 * VertexQuantizer::maxJoint keep full floats.
+	 *
+	 * @param p_Compact true to quantize the vertices
+	 */
+	void setCompactVertices(bool p_Compact);
+
+	/**
+	 * Get statistics about the last model written with indexed output.
+	 *
+	 * @return the vertex, index and cache statistics
+	 */
+	const MeshStatistics& getStatistics() const;
+
 protected:
 	void intToByte(int p_Int, std::ostream* p_Output);
 	void stringToByte(std::string p_String, std::ostream* p_Output);
 
 	void createHeader(std::ostream* p_Output);
+	void createIndexedHeader(std::ostream* p_Output);
 	bool createModelHeaderFile(std::string p_FilePath);
 	void createAnimationHeader(std::ostream* p_AnimationOutput);
 	void createMaterial(std::ostream* p_Output);
 	void createMaterialBuffer(std::ostream* p_Output);
 	void createVertexBuffer(std::ostream* p_Output);
 	void createVertexBufferAnimation(std::ostream* p_Output);
+	void createIndexBuffer(std::ostream* p_Output);
+	void createIndexedVertexBuffer(std::ostream* p_Output);
+	void buildIndexedMesh();
+	void quantizeVertices();
 	void createJointBuffer(std::ostream* p_Output);
+	void createCompressedAnimation(std::ostream* p_Output);
 private:
 	void clearData();
+	void createVertex(const ModelLoader::IndexDesc& p_Desc, VertexBuffer& p_Vertex) const;
+	void createVertex(const ModelLoader::IndexDesc& p_Desc, VertexBufferAnimation& p_Vertex) const;
+	template <typename Vertex>
+	void buildIndexedMesh(std::vector<Vertex>& p_Vertices);
 	void byteToString(std::istream& p_Input, std::string& p_Return);
 	void byteToInt(std::istream& p_Input, int& p_Return);
 	std::string getPath(std::string p_FilePath);
@@ -1,4 +1,7 @@
 #include "ModelLoader.h"
+
+#include <MappedFile.h>
+
 #include <iostream>
 
 ModelLoader::ModelLoader()
@@ -48,34 +51,39 @@ void ModelLoader::clear()
 
 bool ModelLoader::loadFile(std::string p_FilePath, std::string p_ResourceListLocation)
 {
-	clearData();
-	std::ifstream input(p_FilePath, std::ifstream::in);
-	if(!input)
+	if(!loadFile(p_FilePath))
 	{
 		return false;
 	}
-	startReading(input);
 	printOutResourceInfo(p_ResourceListLocation);
 
-	input.close();
-
 	return true;
-}	
-void ModelLoader::startReading(std::istream& p_Input)	
+}
+
+bool ModelLoader::loadFile(std::string p_FilePath)
 {
-	std::string line, key;
-	std::stringstream stringstream;
-	while (!p_Input.eof() && std::getline(p_Input, line))
+	clearData();
+	MappedFile input;
+	if(!input.open(p_FilePath))
 	{
+		return false;
+	}
+	TextTokenizer tokenizer(input.getData(), input.getSize());
+	startReading(tokenizer);
+
+	return true;
+}
 
-		key = "";
-		stringstream = std::stringstream(line);
-		stringstream >> key >> std::ws;
-		if(strcmp(key.c_str(), "*Header") == 0)
+void ModelLoader::startReading(TextTokenizer& p_Input)
+{
+	while(p_Input.nextLine())
+	{
+		const TextTokenizer::Token key = p_Input.readToken();
+		if(key == "*Header")
 		{
 			readHeader(p_Input);
 		}
-		else if(key  == "*Materials")
+		else if(key == "*Materials")
 		{
 			readMaterials(p_Input);
 		}
@@ -118,148 +126,138 @@ void ModelLoader::startReading(std::istream& p_Input)
 	}
 }
 
-void ModelLoader::readHeader(std::istream& p_Input)
-{
-	std::string line, key;
-	std::getline(p_Input, line);
-	m_Stringstream = std::stringstream(line);
-	m_Stringstream >> key >> m_Transparent;
-	std::getline(p_Input, line);
-	m_Stringstream = std::stringstream(line);
-	m_Stringstream >> key >> m_Collidable;
-	std::getline(p_Input, line);
-	m_Stringstream = std::stringstream(line);
-	m_Stringstream >> key >> m_NumberOfMaterials;
-	std::getline(p_Input, line);
-	m_Stringstream = std::stringstream(line);
-	m_Stringstream >> key >> m_MeshName;
-	std::getline(p_Input, line);
-	m_Stringstream = std::stringstream(line);
-	m_Stringstream >> key >> m_NumberOfVertices;
-	std::getline(p_Input, line);
-	m_Stringstream = std::stringstream(line);
-	m_Stringstream >> key >> m_NumberOfTriangles;
-}
-
-void ModelLoader::readMaterials(std::istream& p_Input)
-{
-	std::string line, key;
+void ModelLoader::readHeader(TextTokenizer& p_Input)
+{
+	p_Input.nextLine();
+	p_Input.readToken();
+	p_Input.readBool(m_Transparent);
+	p_Input.nextLine();
+	p_Input.readToken();
+	p_Input.readBool(m_Collidable);
+	p_Input.nextLine();
+	p_Input.readToken();
+	p_Input.readInt(m_NumberOfMaterials);
+	p_Input.nextLine();
+	p_Input.readToken();
+	p_Input.readString(m_MeshName);
+	p_Input.nextLine();
+	p_Input.readToken();
+	p_Input.readInt(m_NumberOfVertices);
+	p_Input.nextLine();
+	p_Input.readToken();
+	p_Input.readInt(m_NumberOfTriangles);
+}
+
+void ModelLoader::readMaterials(TextTokenizer& p_Input)
+{
 	Material tempMaterial;
-	std::getline(p_Input, line);
-	m_Stringstream = std::stringstream(line);
+	p_Input.nextLine();
 	for(int i = 0; i < m_NumberOfMaterials; i++)
 	{
-		m_Stringstream >> key >> tempMaterial.m_MaterialID;
-		std::getline(p_Input, line);
-		m_Stringstream = std::stringstream(line);
-		m_Stringstream >> key >> tempMaterial.m_DiffuseMap;
-		std::getline(p_Input, line);
-		m_Stringstream = std::stringstream(line);
-		m_Stringstream >> key >> tempMaterial.m_NormalMap;
-		std::getline(p_Input, line);
-		m_Stringstream = std::stringstream(line);
-		m_Stringstream >> key >> tempMaterial.m_SpecularMap;
-		std::getline(p_Input, line);
-		m_Stringstream = std::stringstream(line);
+		p_Input.readToken();
+		p_Input.readString(tempMaterial.m_MaterialID);
+		p_Input.nextLine();
+		p_Input.readToken();
+		p_Input.readString(tempMaterial.m_DiffuseMap);
+		p_Input.nextLine();
+		p_Input.readToken();
+		p_Input.readString(tempMaterial.m_NormalMap);
+		p_Input.nextLine();
+		p_Input.readToken();
+		p_Input.readString(tempMaterial.m_SpecularMap);
+		p_Input.nextLine();
 		if(i != m_NumberOfMaterials-1)
 		{
-			std::getline(p_Input, line);
-			m_Stringstream = std::stringstream(line);
+			p_Input.nextLine();
 		}
 		m_Material.push_back(tempMaterial);
 	}
 }
 
-void ModelLoader::readVertex(std::istream& p_Input)
+void ModelLoader::readVertex(TextTokenizer& p_Input)
 {
 	DirectX::XMFLOAT3 tempFloat3;
-	std::string line, key;
-	while(std::getline(p_Input, line))
-	{	
-		m_Stringstream = std::stringstream(line);
-		if(line == "")
-			break;
-		m_Stringstream >> key >> tempFloat3.x >> tempFloat3.y >> tempFloat3.z;
+	while(p_Input.nextLine() && !p_Input.isLineEmpty())
+	{
+		p_Input.readToken();
+		p_Input.readFloat(tempFloat3.x);
+		p_Input.readFloat(tempFloat3.y);
+		p_Input.readFloat(tempFloat3.z);
 		m_Vertices.push_back(tempFloat3);
 	}
 }
 
-void ModelLoader::readNormals(std::istream& p_Input)
+void ModelLoader::readNormals(TextTokenizer& p_Input)
 {
 	DirectX::XMFLOAT3 tempFloat3;
-	std::string line, key;
-	while(std::getline(p_Input, line))
+	while(p_Input.nextLine() && !p_Input.isLineEmpty())
 	{
-		m_Stringstream = std::stringstream(line);
-		if(line == "")
-			break;
-		m_Stringstream >> key >> tempFloat3.x >> tempFloat3.y >> tempFloat3.z;
+		p_Input.readToken();
+		p_Input.readFloat(tempFloat3.x);
+		p_Input.readFloat(tempFloat3.y);
+		p_Input.readFloat(tempFloat3.z);
 		m_Normals.push_back(tempFloat3);
 	}
 }
 
-void ModelLoader::readUV(std::istream& p_Input)
+void ModelLoader::readUV(TextTokenizer& p_Input)
 {
-	DirectX::XMFLOAT3 tempFloat3;
-	std::string line, key;
-	while(std::getline(p_Input, line))
+	DirectX::XMFLOAT2 tempFloat2;
+	while(p_Input.nextLine() && !p_Input.isLineEmpty())
 	{
-		m_Stringstream = std::stringstream(line);
-		if(line == "")
-			break;
-		m_Stringstream >> key >> tempFloat3.x >> tempFloat3.y;
-		m_TextureCoord.push_back(DirectX::XMFLOAT2(tempFloat3.x, 1 - tempFloat3.y));
+		p_Input.readToken();
+		p_Input.readFloat(tempFloat2.x);
+		p_Input.readFloat(tempFloat2.y);
+		m_TextureCoord.push_back(DirectX::XMFLOAT2(tempFloat2.x, 1 - tempFloat2.y));
 	}
 }
 
-void ModelLoader::readTangents(std::istream& p_Input)
+void ModelLoader::readTangents(TextTokenizer& p_Input)
 {
 	DirectX::XMFLOAT3 tempFloat3;
-	std::string line, key;
-	while(std::getline(p_Input, line))
+	while(p_Input.nextLine() && !p_Input.isLineEmpty())
 	{
-		m_Stringstream = std::stringstream(line);
-		if(line == "")
-			break;
-		m_Stringstream >> key >> tempFloat3.x >> tempFloat3.y >> tempFloat3.z;
+		p_Input.readToken();
+		p_Input.readFloat(tempFloat3.x);
+		p_Input.readFloat(tempFloat3.y);
+		p_Input.readFloat(tempFloat3.z);
 		m_Tangents.push_back(tempFloat3);
 	}
 }
 
-void ModelLoader::readFaces(std::istream& p_Input)
+void ModelLoader::readFaces(TextTokenizer& p_Input)
 {
-	int tempInt;
+	int tempInt = 0;
+	int numberOfIndices = 0;
 	IndexDesc tempFace;
-	std::string line, key, filler;
 	if(m_NumberOfMaterials != 0)
 	{
 		for(int i = 0; i < m_NumberOfMaterials; i++)
 		{
 			m_Indices.clear();
-			std::getline(p_Input, line);
-			m_Stringstream = std::stringstream(line);
-			m_Stringstream >> tempFace.m_MaterialID;
-			std::getline(p_Input, line);
-			m_Stringstream = std::stringstream(line);
-			m_Stringstream >> filler >> key;
-			while(std::getline(p_Input,line))
+			p_Input.nextLine();
+			p_Input.readString(tempFace.m_MaterialID);
+			p_Input.nextLine();
+			p_Input.readToken();
+			p_Input.readInt(numberOfIndices);
+			while(p_Input.nextLine() && !p_Input.isLineEmpty())
 			{
-				m_Stringstream = std::stringstream(line);
-				if(line == "")
-					break;
-				for(int i = 0; i < atoi(key.c_str()); i++)
+				for(int i = 0; i < numberOfIndices; i++)
 				{
-					m_Stringstream >> tempInt >> filler;
+					p_Input.readInt(tempInt);
+					p_Input.readToken();
 					tempFace.m_Vertex = tempInt;
-					m_Stringstream >> tempInt >> filler;
+					p_Input.readInt(tempInt);
+					p_Input.readToken();
 					tempFace.m_Tangent = tempInt;
-					m_Stringstream >> tempInt >> filler;
+					p_Input.readInt(tempInt);
+					p_Input.readToken();
 					tempFace.m_Normal = tempInt;
-					m_Stringstream >> tempInt >> filler;	
+					p_Input.readInt(tempInt);
+					p_Input.readToken();
 					tempFace.m_TextureCoord = tempInt;
 					m_Indices.push_back(tempFace);
 				}
-					
 			}
 			m_IndexPerMaterial.push_back(m_Indices);
 		}
@@ -267,50 +265,48 @@ void ModelLoader::readFaces(std::istream& p_Input)
 	else
 	{
 		m_Indices.clear();
-		std::getline(p_Input, line);
-		m_Stringstream = std::stringstream(line);
-		m_Stringstream >> tempFace.m_MaterialID;
-		std::getline(p_Input, line);
-		m_Stringstream = std::stringstream(line);
-		m_Stringstream >> filler >> key;
-		while(std::getline(p_Input,line))
+		p_Input.nextLine();
+		p_Input.readString(tempFace.m_MaterialID);
+		p_Input.nextLine();
+		p_Input.readToken();
+		p_Input.readInt(numberOfIndices);
+		while(p_Input.nextLine() && !p_Input.isLineEmpty())
 		{
-			m_Stringstream = std::stringstream(line);
-			if(line == "")
-				break;
-			for(int i = 0; i < atoi(key.c_str()); i++)
+			for(int i = 0; i < numberOfIndices; i++)
 			{
-				m_Stringstream >> tempInt >> filler;
+				p_Input.readInt(tempInt);
+				p_Input.readToken();
 				tempFace.m_Vertex = tempInt;
 				tempFace.m_Tangent = 0;
-				tempFace.m_Normal = 0;	
+				tempFace.m_Normal = 0;
 				tempFace.m_TextureCoord = 0;
 				m_Indices.push_back(tempFace);
 			}
-					
 		}
 		m_IndexPerMaterial.push_back(m_Indices);
 	}
-
 }
 
-void ModelLoader::readWeights(std::istream& p_Input)
+void ModelLoader::readWeights(TextTokenizer& p_Input)
 {
 	DirectX::XMFLOAT3 tempWeight;
 	DirectX::XMINT4 tempJoint;
-	std::string line, key, filler;
 
-	while(std::getline(p_Input, line))
+	while(p_Input.nextLine() && !p_Input.isLineEmpty())
 	{
-		m_Stringstream = std::stringstream(line);
-		if(line == "")
-			break;
-		float weightW;
-		m_Stringstream >> filler >> tempWeight.x >> tempWeight.y >> tempWeight.z >> weightW;
-
-		std::getline(p_Input, line);
-		m_Stringstream = std::stringstream(line);
-		m_Stringstream >> filler >> tempJoint.x >> tempJoint.y >> tempJoint.z >> tempJoint.w;
+		float weightW = 0.f;
+		p_Input.readToken();
+		p_Input.readFloat(tempWeight.x);
+		p_Input.readFloat(tempWeight.y);
+		p_Input.readFloat(tempWeight.z);
+		p_Input.readFloat(weightW);
+
+		p_Input.nextLine();
+		p_Input.readToken();
+		p_Input.readInt(tempJoint.x);
+		p_Input.readInt(tempJoint.y);
+		p_Input.readInt(tempJoint.z);
+		p_Input.readInt(tempJoint.w);
 		
 		if(tempJoint.w != 0)
 		{
@@ -330,67 +326,70 @@ void ModelLoader::readWeights(std::istream& p_Input)
 	}
 }
 
-void ModelLoader::readHierarchy(std::istream& p_Input)
+void ModelLoader::readHierarchy(TextTokenizer& p_Input)
 {
-	std::string line, filler;
 	Joint tempJointStruct;
-	while(std::getline(p_Input, line))
+	while(p_Input.nextLine() && !p_Input.isLineEmpty())
 	{
-		m_Stringstream = std::stringstream(line);
-		if(line == "")
-			break;
-		m_Stringstream >> tempJointStruct.m_JointName >> tempJointStruct.m_ID >> filler >> tempJointStruct.m_Parent;
+		p_Input.readString(tempJointStruct.m_JointName);
+		p_Input.readInt(tempJointStruct.m_ID);
+		p_Input.readToken();
+		p_Input.readInt(tempJointStruct.m_Parent);
 		m_ListOfJoints.push_back(tempJointStruct);
 	}
 }
 
-void ModelLoader::readJointOffset(std::istream& p_Input)
+void ModelLoader::readJointOffset(TextTokenizer& p_Input)
 {
-	std::string line, filler;
 	DirectX::XMFLOAT4X4 tempMat4x4;
 	int i = 0;
-	while(std::getline(p_Input, line))
+	while(p_Input.nextLine() && !p_Input.isLineEmpty())
 	{
-		m_Stringstream = std::stringstream(line);
-		if(line == "")
-			break;
-		m_Stringstream >> filler 
-			>> tempMat4x4._11 >> tempMat4x4._12 >> tempMat4x4._13 >> tempMat4x4._14 
-			>> tempMat4x4._21 >> tempMat4x4._22	>> tempMat4x4._23 >> tempMat4x4._24
-			>> tempMat4x4._31 >> tempMat4x4._32 >> tempMat4x4._33 >> tempMat4x4._34
-			>> tempMat4x4._41 >> tempMat4x4._42 >> tempMat4x4._43 >> tempMat4x4._44;
+		p_Input.readToken();
+		for(int row = 0; row < 4; row++)
+		{
+			for(int column = 0; column < 4; column++)
+			{
+				p_Input.readFloat(tempMat4x4.m[row][column]);
+			}
+		}
 		m_ListOfJoints.at(i).m_JointOffsetMatrix = tempMat4x4;
 		i++;
 	}
 }
 
-void ModelLoader::readAnimation(std::istream& p_Input)
+void ModelLoader::readAnimation(TextTokenizer& p_Input)
 {
-	std::string line, filler;
 	KeyFrame tempKeyFrame;
 	int i = 0;
-	std::getline(p_Input, line);
-	m_Stringstream = std::stringstream(line);
-	m_Stringstream >> filler >> m_Start;
-	std::getline(p_Input, line);
-	m_Stringstream = std::stringstream(line);
-	m_Stringstream >> filler >> m_End;
-	std::getline(p_Input, line);
-	m_Stringstream = std::stringstream(line);
-	m_Stringstream >> filler >> m_NumberOfFrames;
-	std::getline(p_Input, line);
-	while(std::getline(p_Input, line))
+	p_Input.nextLine();
+	p_Input.readToken();
+	p_Input.readFloat(m_Start);
+	p_Input.nextLine();
+	p_Input.readToken();
+	p_Input.readFloat(m_End);
+	p_Input.nextLine();
+	p_Input.readToken();
+	p_Input.readInt(m_NumberOfFrames);
+	p_Input.nextLine();
+	while(p_Input.nextLine() && !p_Input.isLineEmpty())
 	{
-		if(line == "")
-			break;
 		for(int j = 0; j < m_NumberOfFrames; j++)
 		{
-			std::getline(p_Input, line);
-			m_Stringstream = std::stringstream(line);
-			m_Stringstream >> filler 
-				>> tempKeyFrame.m_Trans.x >> tempKeyFrame.m_Trans.y >> tempKeyFrame.m_Trans.z >> filler
-				>> tempKeyFrame.m_Rot.x >> tempKeyFrame.m_Rot.y >> tempKeyFrame.m_Rot.z >> tempKeyFrame.m_Rot.w >> filler
-				>> tempKeyFrame.m_Scale.x >> tempKeyFrame.m_Scale.y >> tempKeyFrame.m_Scale.z;
+			p_Input.nextLine();
+			p_Input.readToken();
+			p_Input.readFloat(tempKeyFrame.m_Trans.x);
+			p_Input.readFloat(tempKeyFrame.m_Trans.y);
+			p_Input.readFloat(tempKeyFrame.m_Trans.z);
+			p_Input.readToken();
+			p_Input.readFloat(tempKeyFrame.m_Rot.x);
+			p_Input.readFloat(tempKeyFrame.m_Rot.y);
+			p_Input.readFloat(tempKeyFrame.m_Rot.z);
+			p_Input.readFloat(tempKeyFrame.m_Rot.w);
+			p_Input.readToken();
+			p_Input.readFloat(tempKeyFrame.m_Scale.x);
+			p_Input.readFloat(tempKeyFrame.m_Scale.y);
+			p_Input.readFloat(tempKeyFrame.m_Scale.z);
 			m_ListOfJoints.at(i).m_JointAnimation.push_back(tempKeyFrame);
 		}
 		i++;
@@ -403,53 +402,60 @@ void ModelLoader::printOutResourceInfo(std::string p_ResourceListLocation)
 	bool found = false;
 	p_ResourceListLocation.append("\\Resources.xml");
 	tinyxml2::XMLError error = resource.LoadFile(p_ResourceListLocation.c_str());
-	tinyxml2::XMLElement* element;
 	if(error == tinyxml2::XML_ERROR_EMPTY_DOCUMENT || error == tinyxml2::XML_ERROR_FILE_NOT_FOUND)
 	{
-		element = resource.NewElement("Resources");
-		resource.InsertFirstChild(element);
+		// Start a new list, clearing the error so it is not returned by SaveFile
+		resource.Clear();
 	}
 	else if(error != tinyxml2::XML_NO_ERROR)
 	{
 		throw std::exception("File could not be opened.");
 	}
-	else
+
+	addResourceInfo(resource, m_MeshName, m_Collidable, m_WeightsList.size() > 0);
+
+	error = resource.SaveFile(p_ResourceListLocation.c_str());
+	if(error != tinyxml2::XML_NO_ERROR)
 	{
-		element = resource.FirstChildElement("Resources");
+		throw std::exception("Error saving file, check output path");
+	}
+}
+
+void ModelLoader::addResourceInfo(tinyxml2::XMLDocument& p_Resources, const std::string& p_MeshName, bool p_Collidable, bool p_Animated)
+{
+	tinyxml2::XMLElement* element = p_Resources.FirstChildElement("Resources");
+	if(!element)
+	{
+		element = p_Resources.NewElement("Resources");
+		p_Resources.InsertFirstChild(element);
 	}
 
-	tinyxml2::XMLElement* resourceType = searchForElement(resource, element, "ResourceType", "Type", "model"); 
-	tinyxml2::XMLElement* leafNode = searchForElement(resource, resourceType, "Resource", "Name", m_MeshName);
+	tinyxml2::XMLElement* resourceType = searchForElement(p_Resources, element, "ResourceType", "Type", "model"); 
+	tinyxml2::XMLElement* leafNode = searchForElement(p_Resources, resourceType, "Resource", "Name", p_MeshName);
 
 	std::string path = "assets/models/"; 
-	path.append(m_MeshName);
+	path.append(p_MeshName);
 	path.append(".btx");
 	printPath(leafNode, path);
 
-	if(m_Collidable)
+	if(p_Collidable)
 	{
-		resourceType = searchForElement(resource, element, "ResourceType", "Type", "volume");
-		leafNode = searchForElement(resource, resourceType, "Resource", "Name", m_MeshName);
+		resourceType = searchForElement(p_Resources, element, "ResourceType", "Type", "volume");
+		leafNode = searchForElement(p_Resources, resourceType, "Resource", "Name", p_MeshName);
 		std::string path = "assets/volumes/CB_"; 
-		path.append(m_MeshName);
+		path.append(p_MeshName);
 		path.append(".txc");
 		printPath(leafNode, path);
 	}
-	if(m_WeightsList.size() > 0)
+	if(p_Animated)
 	{
-		resourceType = searchForElement(resource, element, "ResourceType", "Type", "animation");
-		leafNode = searchForElement(resource, resourceType, "Resource", "Name", m_MeshName);
+		resourceType = searchForElement(p_Resources, element, "ResourceType", "Type", "animation");
+		leafNode = searchForElement(p_Resources, resourceType, "Resource", "Name", p_MeshName);
 		std::string path = "assets/animations/"; 
-		path.append(m_MeshName);
+		path.append(p_MeshName);
 		path.append(".atx");
 		printPath(leafNode, path);
 	}
-
-	error = resource.SaveFile(p_ResourceListLocation.c_str());
-	if(error != tinyxml2::XML_NO_ERROR)
-	{
-		throw std::exception("Error saving file, check output path");
-	}
 }
 
 void ModelLoader::printPath(tinyxml2::XMLElement* p_Ele, std::string p_Path)
@@ -6,6 +6,7 @@
 #include <memory>
 #include <vector>
 
+#include <TextTokenizer.h>
 #include <tinyxml2\tinyxml2.h>
 
 class ModelLoader
@@ -61,8 +62,6 @@ private:
 	std::vector<std::pair<DirectX::XMFLOAT3, DirectX::XMINT4>> m_WeightsList;
 	std::vector<Joint> m_ListOfJoints;
 	
-	std::stringstream m_Stringstream;
-	
 public:
 	
 	/**
@@ -88,6 +87,24 @@ public:
 	 */
 	bool loadFile(std::string p_FilePath, std::string p_ResourceListLocation);
 
+	/**
+	 * Creates vectors with information from the requested file without touching the resource list.
+	 *
+	 * @param p_FilePath, the absolute path to the requested file.
+	 * @return false if something is wrong when loading file.
+	 */
+	bool loadFile(std::string p_FilePath);
+
+	/**
+	 * Adds or updates the model, volume and animation paths of a mesh in a loaded resource list.
+	 *
+	 * @param p_Resources the Resources.xml document
+	 * @param p_MeshName the name of the mesh
+	 * @param p_Collidable true if the mesh has a bounding volume
+	 * @param p_Animated true if the mesh has an animation
+	 */
+	static void addResourceInfo(tinyxml2::XMLDocument& p_Resources, const std::string& p_MeshName, bool p_Collidable, bool p_Animated);
+
 	/**
 	 * Returns the stored information about vertices as a vector with Float3 values. 
 	 *
@@ -187,35 +204,40 @@ public:
 	std::string getMeshName() const;
 
 protected: 
-	void startReading(std::istream& p_Input);
+	/**
+	 * Reads a whole .tx file, dispatching each section to its read function.
+	 *
+	 * @param p_Input the tokenizer, positioned before the first line.
+	 */
+	void startReading(TextTokenizer& p_Input);
 
-	void readHeader(std::istream& p_Input);
+	void readHeader(TextTokenizer& p_Input);
 
-	void readMaterials(std::istream& p_Input);
+	void readMaterials(TextTokenizer& p_Input);
 
-	void readVertex(std::istream& p_Input); 
+	void readVertex(TextTokenizer& p_Input); 
 
-	void readNormals(std::istream& p_Input);
+	void readNormals(TextTokenizer& p_Input);
 
-	void readUV(std::istream& p_Input);
+	void readUV(TextTokenizer& p_Input);
 
-	void readTangents(std::istream& p_Input);
+	void readTangents(TextTokenizer& p_Input);
 
-	void readFaces(std::istream& p_Input);
+	void readFaces(TextTokenizer& p_Input);
 
-	void readWeights(std::istream& p_Input);
+	void readWeights(TextTokenizer& p_Input);
 
-	void readHierarchy(std::istream& p_Input);
+	void readHierarchy(TextTokenizer& p_Input);
 
-	void readJointOffset(std::istream& p_Input);
+	void readJointOffset(TextTokenizer& p_Input);
 
-	void readAnimation(std::istream& p_Input);
+	void readAnimation(TextTokenizer& p_Input);
 	
 	void printOutResourceInfo(std::string p_ResourceListLocation);
 
 private:
-	void printPath(tinyxml2::XMLElement* p_Ele, std::string p_Path);
-	tinyxml2::XMLElement* searchForElement(tinyxml2::XMLDocument& p_Doc, tinyxml2::XMLElement* p_Parent, std::string p_ElementName, std::string p_Attribute, std::string p_AttributeValue);
+	static void printPath(tinyxml2::XMLElement* p_Ele, std::string p_Path);
+	static tinyxml2::XMLElement* searchForElement(tinyxml2::XMLDocument& p_Doc, tinyxml2::XMLElement* p_Parent, std::string p_ElementName, std::string p_Attribute, std::string p_AttributeValue);
 	void clearData();
 
 };
\ No newline at end of file
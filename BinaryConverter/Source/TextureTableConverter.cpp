@@ -0,0 +1,297 @@
+#include "TextureTableConverter.h"
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <unordered_set>
+
+using namespace MaterialBundleFormat;
+
+namespace
+{
+	// The DXGI_FORMAT values of the formats that DDS files are converted to
+	const uint32_t formatR32G32B32A32Float = 2;
+	const uint32_t formatR16G16B16A16Float = 10;
+	const uint32_t formatR8G8B8A8Unorm = 28;
+	const uint32_t formatR8Unorm = 61;
+	const uint32_t formatBC1Unorm = 71;
+	const uint32_t formatBC2Unorm = 74;
+	const uint32_t formatBC3Unorm = 77;
+	const uint32_t formatBC4Unorm = 80;
+	const uint32_t formatBC5Unorm = 83;
+	const uint32_t formatB5G6R5Unorm = 85;
+	const uint32_t formatB8G8R8A8Unorm = 87;
+	const uint32_t formatB8G8R8X8Unorm = 88;
+	const uint32_t formatLast = 132;
+
+	// Offsets into a DDS file, counted from the magic number
+	const size_t ddsHeaderSize = 4 + 124;
+	const size_t ddsFlagsOffset = 8;
+	const size_t ddsHeightOffset = 12;
+	const size_t ddsWidthOffset = 16;
+	const size_t ddsMipCountOffset = 28;
+	const size_t ddsPixelFlagsOffset = 80;
+	const size_t ddsFourCCOffset = 84;
+	const size_t ddsBitCountOffset = 88;
+	const size_t ddsRedMaskOffset = 92;
+	const size_t ddsAlphaMaskOffset = 104;
+	const size_t ddsCaps2Offset = 112;
+	const size_t dx10HeaderSize = 20;
+
+	const uint32_t ddsdMipMapCount = 0x20000;
+	const uint32_t ddpfAlphaPixels = 0x1;
+	const uint32_t ddpfFourCC = 0x4;
+	const uint32_t ddpfRGB = 0x40;
+	const uint32_t ddpfLuminance = 0x20000;
+	const uint32_t ddsCaps2Cubemap = 0x200;
+	const uint32_t dx10MiscTextureCube = 0x4;
+
+	const char* const wicExtensions[] =
+	{
+		".bmp", ".gif", ".ico", ".jpeg", ".jpe", ".jpg", ".png", ".tiff", ".tif", ".phot",
+	};
+
+	uint32_t readUint(const char* p_Data, size_t p_Offset)
+	{
+		uint32_t value;
+		memcpy(&value, p_Data + p_Offset, sizeof(value));
+		return value;
+	}
+
+	uint32_t makeFourCC(char p_A, char p_B, char p_C, char p_D)
+	{
+		return uint32_t(uint8_t(p_A)) | uint32_t(uint8_t(p_B)) << 8 | uint32_t(uint8_t(p_C)) << 16 | uint32_t(uint8_t(p_D)) << 24;
+	}
+
+	/**
+	 * The DXGI format of a legacy DDS pixel format, 0 if it has none.
+	 */
+	uint32_t getLegacyFormat(const char* p_Data)
+	{
+		const uint32_t flags = readUint(p_Data, ddsPixelFlagsOffset);
+		if (flags & ddpfFourCC)
+		{
+			const uint32_t fourCC = readUint(p_Data, ddsFourCCOffset);
+			if (fourCC == makeFourCC('D', 'X', 'T', '1'))
+				return formatBC1Unorm;
+			if (fourCC == makeFourCC('D', 'X', 'T', '2') || fourCC == makeFourCC('D', 'X', 'T', '3'))
+				return formatBC2Unorm;
+			if (fourCC == makeFourCC('D', 'X', 'T', '4') || fourCC == makeFourCC('D', 'X', 'T', '5'))
+				return formatBC3Unorm;
+			if (fourCC == makeFourCC('A', 'T', 'I', '1') || fourCC == makeFourCC('B', 'C', '4', 'U'))
+				return formatBC4Unorm;
+			if (fourCC == makeFourCC('A', 'T', 'I', '2') || fourCC == makeFourCC('B', 'C', '5', 'U'))
+				return formatBC5Unorm;
+			// Some writers store the D3DFORMAT value instead of a four character code
+			if (fourCC == 113)
+				return formatR16G16B16A16Float;
+			if (fourCC == 116)
+				return formatR32G32B32A32Float;
+			return 0;
+		}
+
+		const uint32_t bitCount = readUint(p_Data, ddsBitCountOffset);
+		const uint32_t redMask = readUint(p_Data, ddsRedMaskOffset);
+		const uint32_t alphaMask = readUint(p_Data, ddsAlphaMaskOffset);
+		if ((flags & ddpfRGB) && bitCount == 32)
+		{
+			if (redMask == 0x000000ff)
+				return formatR8G8B8A8Unorm;
+			if (redMask == 0x00ff0000)
+				return (flags & ddpfAlphaPixels) && alphaMask != 0 ? formatB8G8R8A8Unorm : formatB8G8R8X8Unorm;
+		}
+		if ((flags & ddpfRGB) && bitCount == 16 && redMask == 0xf800)
+			return formatB5G6R5Unorm;
+		if ((flags & ddpfLuminance) && bitCount == 8)
+			return formatR8Unorm;
+		return 0;
+	}
+
+	bool hasWICExtension(const std::string& p_Name)
+	{
+		std::string extension = boost::filesystem::path(p_Name).extension().string();
+		std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+		for (const char* wicExtension : wicExtensions)
+		{
+			if (extension == wicExtension)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+}
+
+TextureTableConverter::TextureTableConverter()
+{
+}
+
+void TextureTableConverter::clear()
+{
+	m_Textures.clear();
+	m_UnsupportedTextures.clear();
+}
+
+bool TextureTableConverter::addDirectory(const std::string& p_Directory)
+{
+	if (!boost::filesystem::is_directory(p_Directory))
+	{
+		return false;
+	}
+
+	// Directory iteration order is unspecified, sort so the IDs are the same every time
+	std::vector<boost::filesystem::path> files;
+	for (boost::filesystem::directory_iterator it(p_Directory), end; it != end; ++it)
+	{
+		if (boost::filesystem::is_regular_file(it->status()))
+		{
+			files.push_back(it->path());
+		}
+	}
+	std::sort(files.begin(), files.end());
+
+	std::vector<char> buffer;
+	for (const auto& file : files)
+	{
+		const std::string name = file.filename().string();
+		std::string extension = file.extension().string();
+		std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+		if (extension != ".dds" && !hasWICExtension(name))
+		{
+			continue;
+		}
+
+		std::ifstream input(file.string(), std::istream::in | std::istream::binary);
+		buffer.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+		addTexture(name, buffer.data(), buffer.size());
+	}
+
+	return true;
+}
+
+bool TextureTableConverter::addTexture(const std::string& p_Name, const char* p_Data, size_t p_Size)
+{
+	for (const auto& texture : m_Textures)
+	{
+		if (texture.m_Name == p_Name)
+		{
+			return true;
+		}
+	}
+
+	TextureTable::Texture texture;
+	if (!readTextureInfo(p_Name, p_Data, p_Size, texture))
+	{
+		m_UnsupportedTextures.push_back(p_Name);
+		return false;
+	}
+
+	m_Textures.push_back(texture);
+	return true;
+}
+
+bool TextureTableConverter::writeFile(const std::string& p_OutputPath) const
+{
+	std::vector<TextureEntry> entries;
+	std::string strings;
+	for (const auto& texture : m_Textures)
+	{
+		TextureEntry entry;
+		entry.m_NameOffset = static_cast<uint32_t>(strings.size());
+		entry.m_NameLength = static_cast<uint32_t>(texture.m_Name.size());
+		entry.m_Container = texture.m_Container;
+		entry.m_Format = texture.m_Format;
+		entry.m_Width = texture.m_Width;
+		entry.m_Height = texture.m_Height;
+		entry.m_MipLevels = texture.m_MipLevels;
+		entry.m_ArraySize = texture.m_ArraySize;
+		strings += texture.m_Name;
+		entries.push_back(entry);
+	}
+
+	TableHeader header;
+	memcpy(header.m_Magic, tableMagic, sizeof(header.m_Magic));
+	header.m_Version = version;
+	header.m_NumTextures = static_cast<uint32_t>(entries.size());
+	header.m_StringsSize = static_cast<uint32_t>(strings.size());
+
+	std::ofstream output(p_OutputPath, std::ostream::out | std::ostream::binary | std::ostream::trunc);
+	if (!output)
+	{
+		return false;
+	}
+
+	output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	output.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(TextureEntry));
+	output.write(strings.data(), strings.size());
+
+	return static_cast<bool>(output);
+}
+
+const std::vector<TextureTable::Texture>& TextureTableConverter::getTextures() const
+{
+	return m_Textures;
+}
+
+const std::vector<std::string>& TextureTableConverter::getUnsupportedTextures() const
+{
+	return m_UnsupportedTextures;
+}
+
+bool TextureTableConverter::readTextureInfo(const std::string& p_Name, const char* p_Data, size_t p_Size,
+	TextureTable::Texture& p_Texture)
+{
+	static const char ddsMagic[4] = { 'D', 'D', 'S', ' ' };
+
+	p_Texture = TextureTable::Texture();
+	p_Texture.m_Name = p_Name;
+
+	if (p_Size < sizeof(ddsMagic) || memcmp(p_Data, ddsMagic, sizeof(ddsMagic)) != 0)
+	{
+		// WIC decides the format when decoding, and images have no mips
+		p_Texture.m_Container = WIC_CONTAINER;
+		return hasWICExtension(p_Name);
+	}
+
+	if (p_Size < ddsHeaderSize)
+	{
+		return false;
+	}
+
+	p_Texture.m_Container = DDS_CONTAINER;
+	p_Texture.m_Width = readUint(p_Data, ddsWidthOffset);
+	p_Texture.m_Height = readUint(p_Data, ddsHeightOffset);
+	if (readUint(p_Data, ddsFlagsOffset) & ddsdMipMapCount)
+	{
+		p_Texture.m_MipLevels = (std::max)(readUint(p_Data, ddsMipCountOffset), 1u);
+	}
+
+	const bool dx10 = (readUint(p_Data, ddsPixelFlagsOffset) & ddpfFourCC)
+		&& readUint(p_Data, ddsFourCCOffset) == makeFourCC('D', 'X', '1', '0');
+	if (dx10)
+	{
+		if (p_Size < ddsHeaderSize + dx10HeaderSize)
+		{
+			return false;
+		}
+		p_Texture.m_Format = readUint(p_Data, ddsHeaderSize);
+		p_Texture.m_ArraySize = (std::max)(readUint(p_Data, ddsHeaderSize + 12), 1u);
+		if (readUint(p_Data, ddsHeaderSize + 8) & dx10MiscTextureCube)
+		{
+			p_Texture.m_ArraySize *= 6;
+		}
+	}
+	else
+	{
+		p_Texture.m_Format = getLegacyFormat(p_Data);
+		if (readUint(p_Data, ddsCaps2Offset) & ddsCaps2Cubemap)
+		{
+			p_Texture.m_ArraySize = 6;
+		}
+	}
+
+	return p_Texture.m_Format != 0 && p_Texture.m_Format <= formatLast;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <TextureTable.h>
+
+#include <string>
+#include <vector>
+
+/**
+ * Builds a texture table (.btt) from the textures of a texture directory, in
+ * the format described in MaterialBundleFormat.h.
+ *
+ * The header of every texture is read once here, so that the game knows the
+ * container, format and mip count of a texture without looking at the file.
+ */
+class TextureTableConverter
+{
+private:
+	std::vector<TextureTable::Texture> m_Textures;
+	std::vector<std::string> m_UnsupportedTextures;
+
+public:
+	/**
+	 * Constructor.
+	 */
+	TextureTableConverter();
+
+	/**
+	 * Remove all added textures.
+	 */
+	void clear();
+
+	/**
+	 * Add every texture file directly in a directory, in file name order.
+	 *
+	 * @param p_Directory the texture directory
+	 * @return false if the directory does not exist
+	 */
+	bool addDirectory(const std::string& p_Directory);
+
+	/**
+	 * Add a single texture. Textures get IDs in the order they are added.
+	 * A texture with the same name as an earlier one is ignored.
+	 *
+	 * @param p_Name the file name of the texture
+	 * @param p_Data the contents of the texture file
+	 * @param p_Size the size of the contents in bytes
+	 * @return false if the texture is in an unsupported format, which is reported
+	 *			by getUnsupportedTextures and left out of the table
+	 */
+	bool addTexture(const std::string& p_Name, const char* p_Data, size_t p_Size);
+
+	/**
+	 * Write all added textures to a texture table.
+	 *
+	 * @return false if the table could not be written
+	 */
+	bool writeFile(const std::string& p_OutputPath) const;
+
+	const std::vector<TextureTable::Texture>& getTextures() const;
+
+	/**
+	 * The names of the textures that could not be added.
+	 */
+	const std::vector<std::string>& getUnsupportedTextures() const;
+
+	/**
+	 * Read the container, format, size and mip count of a texture from its contents.
+	 * DDS files are recognized by their header, anything else by its file extension.
+	 *
+	 * @param p_Name the file name of the texture
+	 * @param p_Texture set to the description of the texture, including the name
+	 * @return false if the texture is not a supported DDS or WIC image
+	 */
+	static bool readTextureInfo(const std::string& p_Name, const char* p_Data, size_t p_Size, TextureTable::Texture& p_Texture);
+};
@@ -0,0 +1,141 @@
+#include <boost/test/unit_test.hpp>
+#include "../../BinaryConverter/Source/ModelLoader.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+
+BOOST_AUTO_TEST_SUITE(ModelLoading)
+
+/**
+ * Writes a .tx model with one material and p_NumVertices vertices, normals, uvs
+ * and tangents, indexed by p_NumVertices / 3 triangles.
+ */
+static void writeLargeModel(const std::string& p_FilePath, unsigned int p_NumVertices)
+{
+	std::ofstream output(p_FilePath, std::ostream::out | std::ostream::binary);
+	output << "*Header\n#Tansparent 0 \n#Collidable 0 \n#Materials 1 \n#MESH largeModel \n#Vertices "
+		<< p_NumVertices << " \n#Triangles " << p_NumVertices / 3 << " \n"
+		<< "*Materials \nMaterial: lambert1 \nDiffuseMap: NONE \nNormalMap: NONE \nSpecularMap: NONE \n \n";
+	output << std::fixed << std::setprecision(6);
+
+	std::mt19937 random(41);
+	std::uniform_real_distribution<float> distribution(-100.f, 100.f);
+	const char* const sections[] = { "*Vertices", "*Normals", "*UV COORDS", "*Tangets" };
+	const char* const keys[] = { "v", "n", "uv", "t" };
+	for (unsigned int section = 0; section < 4; ++section)
+	{
+		output << sections[section] << " \n";
+		for (unsigned int i = 0; i < p_NumVertices; ++i)
+		{
+			output << keys[section] << ' ' << distribution(random) << ' ' << distribution(random);
+			if (section != 2)
+			{
+				output << ' ' << distribution(random);
+			}
+			output << " \n";
+		}
+		output << "\n";
+	}
+
+	output << "*FACES \n-lambert1 \nface: 3 \n";
+	for (unsigned int i = 0; i + 2 < p_NumVertices; i += 3)
+	{
+		for (unsigned int k = i; k < i + 3; ++k)
+		{
+			output << k << " / " << k << " / " << k << " / " << k << " | ";
+		}
+		output << "\n";
+	}
+	output << "\n";
+}
+
+/**
+ * Reads the same values the way ModelLoader did before it used TextTokenizer, with
+ * std::getline and a std::stringstream per line, as the benchmark baseline.
+ */
+static std::vector<DirectX::XMFLOAT3> readWithStringstreams(const std::string& p_FilePath, unsigned int& p_NumIndices)
+{
+	std::vector<DirectX::XMFLOAT3> vertices;
+	std::vector<DirectX::XMFLOAT3> others;
+	p_NumIndices = 0;
+
+	std::ifstream input(p_FilePath, std::ifstream::in);
+	std::string line, key, filler;
+	while (std::getline(input, line))
+	{
+		std::stringstream stream(line);
+		DirectX::XMFLOAT3 value;
+		int index;
+		if (line.compare(0, 2, "v ") == 0)
+		{
+			stream >> key >> value.x >> value.y >> value.z;
+			vertices.push_back(value);
+		}
+		else if (line.compare(0, 2, "n ") == 0 || line.compare(0, 2, "t ") == 0)
+		{
+			stream >> key >> value.x >> value.y >> value.z;
+			others.push_back(value);
+		}
+		else if (line.compare(0, 3, "uv ") == 0)
+		{
+			stream >> key >> value.x >> value.y;
+			others.push_back(value);
+		}
+		else if (!line.empty() && isdigit(line[0]))
+		{
+			for (int i = 0; i < 3; ++i)
+			{
+				stream >> index >> filler >> index >> filler >> index >> filler >> index >> filler;
+				++p_NumIndices;
+			}
+		}
+	}
+
+	return vertices;
+}
+
+BOOST_AUTO_TEST_CASE(TestLoadBenchmark)
+{
+	typedef std::chrono::high_resolution_clock Clock;
+	static const unsigned int numVertices = 1000000;
+	const std::string path = "largeModel.tx";
+	writeLargeModel(path, numVertices);
+
+	Clock::time_point stringstreamStart = Clock::now();
+	unsigned int stringstreamIndices = 0;
+	const std::vector<DirectX::XMFLOAT3> expected = readWithStringstreams(path, stringstreamIndices);
+	Clock::time_point stringstreamEnd = Clock::now();
+
+	Clock::time_point tokenizerStart = Clock::now();
+	ModelLoader loader;
+	BOOST_REQUIRE(loader.loadFile(path));
+	Clock::time_point tokenizerEnd = Clock::now();
+
+	BOOST_REQUIRE_EQUAL(loader.getVertices().size(), numVertices);
+	BOOST_REQUIRE_EQUAL(expected.size(), numVertices);
+	BOOST_CHECK_EQUAL(loader.getNormals().size(), numVertices);
+	BOOST_CHECK_EQUAL(loader.getTextureCoords().size(), numVertices);
+	BOOST_CHECK_EQUAL(loader.getTangents().size(), numVertices);
+	BOOST_REQUIRE_EQUAL(loader.getIndices().size(), 1);
+	BOOST_CHECK_EQUAL(loader.getIndices()[0].size(), stringstreamIndices);
+	BOOST_CHECK_EQUAL(loader.getIndices()[0].back().m_TextureCoord, numVertices - 2);
+	for (unsigned int i = 0; i < numVertices; i += 997)
+	{
+		BOOST_CHECK_CLOSE_FRACTION(loader.getVertices()[i].x, expected[i].x, 1e-6f);
+		BOOST_CHECK_CLOSE_FRACTION(loader.getVertices()[i].z, expected[i].z, 1e-6f);
+	}
+
+	loader.clear();
+	std::remove(path.c_str());
+
+	const long long stringstreamMicro = std::chrono::duration_cast<std::chrono::microseconds>(stringstreamEnd - stringstreamStart).count();
+	const long long tokenizerMicro = std::chrono::duration_cast<std::chrono::microseconds>(tokenizerEnd - tokenizerStart).count();
+	BOOST_TEST_MESSAGE("Loading a " << numVertices << " vertex .tx file: std::stringstream per line "
+		<< stringstreamMicro << " us, mapped TextTokenizer " << tokenizerMicro << " us");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
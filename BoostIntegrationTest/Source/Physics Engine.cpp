@@ -7,6 +7,10 @@
 #include "../../Physics/Source/BVLoader.h"
 #include "../../Physics/Source/PhysicsLogger.h"
 #include "../../Common/Source/ResourceManager.h"
+#include "../../BinaryConverter/Source/BoundingVolumeConverter.h"
+
+#include <chrono>
+#include <cstdio>
 
 #if _DEBUG
 #include <vld.h>
@@ -387,6 +391,61 @@ BOOST_AUTO_TEST_CASE(BVLoaderIntegration)
 	BOOST_CHECK_SMALL(hd.colNorm.z, 0.0001f);
 	Body::resetBodyHandleCounter();
 }
+
+BOOST_AUTO_TEST_CASE(BVLoaderBinaryFormatIntegration)
+{
+	typedef std::chrono::high_resolution_clock Clock;
+	static const int numLoads = 1000;
+	static const char* volumes[] = { "../Bin/assets/volumes/CB_Barrel1", "../Bin/assets/volumes/CB_Crate1" };
+
+	BOOST_MESSAGE(testId + "Testing binary bounding volumes converted from .txc files");
+	for (const char* volume : volumes)
+	{
+		const std::string textFile = std::string(volume) + ".txc";
+		const std::string binaryFile = std::string(volume) + ".bbv";
+
+		BoundingVolumeConverter converter;
+		BOOST_REQUIRE(converter.loadFile(textFile));
+		BOOST_REQUIRE(converter.writeFile(binaryFile));
+
+		BVLoader textLoader;
+		BVLoader binaryLoader;
+		BOOST_REQUIRE(textLoader.loadBinaryFile(textFile));
+		BOOST_REQUIRE(binaryLoader.loadBinaryFile(binaryFile));
+		BOOST_CHECK(!textLoader.isPrescaled());
+		BOOST_CHECK(binaryLoader.isPrescaled());
+		BOOST_CHECK_CLOSE_FRACTION(binaryLoader.getBoundingSphere().w, converter.getRadius(), 0.0001f);
+
+		const std::vector<BVLoader::BoundingVolume>& text = textLoader.getBoundingVolumes();
+		const std::vector<BVLoader::BoundingVolume>& binary = binaryLoader.getBoundingVolumes();
+		BOOST_REQUIRE_EQUAL(text.size(), binary.size());
+		for (unsigned int i = 0; i < text.size(); i++)
+		{
+			BOOST_CHECK_EQUAL(text[i].m_Postition.x * 0.01f, binary[i].m_Postition.x);
+			BOOST_CHECK_EQUAL(text[i].m_Postition.y * 0.01f, binary[i].m_Postition.y);
+			BOOST_CHECK_EQUAL(text[i].m_Postition.z * 0.01f, binary[i].m_Postition.z);
+		}
+
+		Clock::time_point textStart = Clock::now();
+		for (int i = 0; i < numLoads; i++)
+		{
+			textLoader.loadBinaryFile(textFile);
+		}
+		Clock::time_point textEnd = Clock::now();
+		for (int i = 0; i < numLoads; i++)
+		{
+			binaryLoader.loadBinaryFile(binaryFile);
+		}
+		Clock::time_point binaryEnd = Clock::now();
+
+		const long long textMicro = std::chrono::duration_cast<std::chrono::microseconds>(textEnd - textStart).count();
+		const long long binaryMicro = std::chrono::duration_cast<std::chrono::microseconds>(binaryEnd - textEnd).count();
+		BOOST_MESSAGE(testId + textFile + ": " + std::to_string(numLoads) + " loads, .txc "
+			+ std::to_string(textMicro) + " us, .bbv " + std::to_string(binaryMicro) + " us");
+
+		std::remove(binaryFile.c_str());
+	}
+}
 #pragma endregion
 
 #pragma region // ## Step 4 ## //
@@ -307,6 +307,19 @@ BOOST_AUTO_TEST_CASE(UpdateAnimationEventDataTest)
 	std::shared_ptr<UpdateAnimationEventData> newEventData = std::static_pointer_cast<UpdateAnimationEventData>(eventData->copy());
 	BOOST_CHECK(newEventData->getId() == 2);
 	BOOST_CHECK(newEventData->getAnimationData().size() == 1);
+	BOOST_CHECK(!newEventData->hasPoseSource());
+
+	// The pose source follows the lifetime of its owner, also in copies
+	const DirectX::XMFLOAT4X4* pose = matrix.data();
+	std::shared_ptr<const DirectX::XMFLOAT4X4* const> poseSource(new const DirectX::XMFLOAT4X4*(pose));
+	std::shared_ptr<UpdateAnimationEventData> poseEventData(new UpdateAnimationEventData(2, matrix, anim.getAnimationData(), world, poseSource));
+	std::shared_ptr<UpdateAnimationEventData> poseEventCopy = std::static_pointer_cast<UpdateAnimationEventData>(poseEventData->copy());
+	BOOST_CHECK(poseEventData->hasPoseSource());
+	BOOST_CHECK(poseEventData->getPoseSource().get() == poseSource.get());
+
+	poseSource.reset();
+	BOOST_CHECK(poseEventCopy->hasPoseSource());
+	BOOST_CHECK(!poseEventCopy->getPoseSource());
 }
 
 BOOST_AUTO_TEST_CASE(GameStartedEventDataTest)
@@ -0,0 +1,372 @@
+#include <boost/test/unit_test.hpp>
+#include "../../../Client/Source/Level.h"
+#include <ActorFactory.h>
+#include <ActorList.h>
+#include <Components.h>
+#include <EventManager.h>
+#include <IPhysics.h>
+#include <LevelBinaryView.h>
+#include <ResourceManager.h>
+#include <XMLHelper.h>
+
+#include <chrono>
+#include <iterator>
+#include <sstream>
+
+BOOST_AUTO_TEST_SUITE(TestActorFactory)
+
+static const unsigned int numBenchmarkInstances = 5000;
+
+static ActorFactory::InstanceModel createTestInstance(unsigned int p_Index)
+{
+	ActorFactory::InstanceModel model;
+	model.meshName = "House1";
+	model.position = Vector3((float)(p_Index % 100) * 500.f, 0.f, (float)(p_Index / 100) * 500.f);
+	model.rotation = Vector3(0.1f * (float)(p_Index % 7), 0.f, 0.f);
+	model.scale = Vector3(1.f, 1.f, 1.f);
+
+	return model;
+}
+
+/**
+ * Instance creation as it was done before the typed descriptions,
+ * printing and re-parsing the actor description for every instance.
+ */
+static Actor::ptr createInstanceThroughXML(ActorFactory& p_Factory, const ActorFactory::InstanceModel& p_Model)
+{
+	tinyxml2::XMLPrinter printer;
+	printer.OpenElement("Object");
+	pushVector(printer, p_Model.position);
+	pushRotation(printer, p_Model.rotation);
+	printer.OpenElement("Model");
+	printer.PushAttribute("Mesh", p_Model.meshName.c_str());
+	pushVector(printer, "Scale", p_Model.scale);
+	printer.CloseElement();
+	printer.CloseElement();
+
+	tinyxml2::XMLDocument doc;
+	doc.Parse(printer.CStr());
+
+	return p_Factory.createActor(doc.FirstChildElement("Object"));
+}
+
+static std::string serializeActor(const Actor::ptr& p_Actor)
+{
+	std::ostringstream stream;
+	p_Actor->serialize(stream);
+	return stream.str();
+}
+
+template <typename T>
+static void writeValue(std::vector<char>& p_Buffer, const T& p_Value)
+{
+	const char* bytes = reinterpret_cast<const char*>(&p_Value);
+	p_Buffer.insert(p_Buffer.end(), bytes, bytes + sizeof(T));
+}
+
+static void writeInstanceArray(std::vector<char>& p_Buffer, const std::vector<Vector3>& p_Values)
+{
+	writeValue(p_Buffer, (int)p_Values.size());
+	for (const Vector3& value : p_Values)
+	{
+		writeValue(p_Buffer, value);
+	}
+}
+
+/**
+ * Builds a .btxl level with the benchmark instances spread over the
+ * models of the test resource list. The models do not collide, so the
+ * level needs no volumes or edge files.
+ */
+static std::vector<char> createBenchmarkLevel()
+{
+	static const char* const meshNames[] = { "House1", "Dzala" };
+	static const unsigned int numMeshes = sizeof(meshNames) / sizeof(meshNames[0]);
+
+	std::vector<char> level;
+	writeValue(level, (int)numMeshes);
+	writeValue(level, 0);
+	writeValue(level, 0);
+	writeValue(level, 0);
+
+	writeValue(level, (int)numMeshes);
+	for (unsigned int mesh = 0; mesh < numMeshes; ++mesh)
+	{
+		const std::string meshName = meshNames[mesh];
+		writeValue(level, (int)meshName.size());
+		level.insert(level.end(), meshName.begin(), meshName.end());
+		writeValue(level, 0);
+		writeValue(level, 0);
+		writeValue(level, 0);
+
+		std::vector<Vector3> translations;
+		std::vector<Vector3> rotations;
+		std::vector<Vector3> scales;
+		for (unsigned int i = mesh; i < numBenchmarkInstances; i += numMeshes)
+		{
+			const ActorFactory::InstanceModel model = createTestInstance(i);
+			translations.push_back(model.position);
+			rotations.push_back(model.rotation);
+			scales.push_back(model.scale);
+		}
+		writeInstanceArray(level, translations);
+		writeInstanceArray(level, rotations);
+		writeInstanceArray(level, scales);
+	}
+
+	return level;
+}
+
+/**
+ * Creates the instances of a level the way Level did before the typed
+ * descriptions, with an XML round-trip for every instance.
+ */
+static void createLevelThroughXML(ActorFactory& p_Factory, const LevelBinaryView& p_Level, ActorList& p_ActorOut)
+{
+	for (const auto& model : p_Level.getModelData())
+	{
+		ActorFactory::InstanceModel instance;
+		instance.meshName = LevelBinaryView::toString(model.m_MeshName);
+		for (unsigned int i = 0; i < model.m_Translation.size(); ++i)
+		{
+			instance.position = model.m_Translation[i];
+			instance.rotation = model.m_Rotation[i];
+			instance.scale = model.m_Scale[i];
+			p_ActorOut.addActor(createInstanceThroughXML(p_Factory, instance));
+		}
+	}
+}
+
+class TestModelResource
+{
+public:
+	bool create(const char* p_ResourceType, const char* p_ResourceName)
+	{
+		return true;
+	}
+	bool release(const char* p_Resource)
+	{
+		return true;
+	}
+};
+
+BOOST_AUTO_TEST_CASE(TestInstanceActorMatchesXML)
+{
+	EventManager eventManager;
+	ActorFactory xmlFactory(0);
+	xmlFactory.setEventManager(&eventManager);
+	ActorFactory typedFactory(0);
+	typedFactory.setEventManager(&eventManager);
+
+	const ActorFactory::InstanceModel model = createTestInstance(42);
+	const std::vector<ActorFactory::InstanceBoundingVolume> volumes;
+	const std::vector<ActorFactory::InstanceEdgeBox> edges;
+
+	Actor::ptr xmlActor = createInstanceThroughXML(xmlFactory, model);
+	Actor::ptr typedActor = typedFactory.createInstanceActor(model, volumes, edges);
+
+	BOOST_REQUIRE(xmlActor);
+	BOOST_REQUIRE(typedActor);
+	BOOST_CHECK_EQUAL(xmlActor->getId(), typedActor->getId());
+	BOOST_CHECK_EQUAL(serializeActor(xmlActor), serializeActor(typedActor));
+}
+
+BOOST_AUTO_TEST_CASE(TestParticleActorMatchesXML)
+{
+	EventManager eventManager;
+	ActorFactory factory(0);
+	factory.setEventManager(&eventManager);
+
+	Actor::ptr typedActor = factory.createParticles(Vector3(1.f, 2.f, 3.f), "fire", Vector4(0.2f, 0.3f, 0.4f, 0.5f));
+	BOOST_REQUIRE(typedActor);
+
+	tinyxml2::XMLDocument doc;
+	doc.Parse(serializeActor(typedActor).c_str());
+	Actor::ptr xmlActor = factory.createActor(doc.FirstChildElement("Object"));
+	BOOST_REQUIRE(xmlActor);
+
+	BOOST_CHECK_EQUAL(serializeActor(xmlActor), serializeActor(typedActor));
+}
+
+BOOST_AUTO_TEST_CASE(TestLevelLoadBenchmark)
+{
+	typedef std::chrono::high_resolution_clock Clock;
+
+	const std::vector<char> levelBuffer = createBenchmarkLevel();
+	std::shared_ptr<LevelBinaryView> levelData(new LevelBinaryView);
+	levelData->openBuffer(levelBuffer.data(), levelBuffer.size());
+
+	EventManager eventManager;
+	ResourceManager resourceManager;
+	resourceManager.loadDataFromFile("..\\Source\\Common\\Resources.xml");
+	TestModelResource modelResource;
+	using namespace std::placeholders;
+	resourceManager.registerFunction("model",
+		std::bind(&TestModelResource::create, modelResource, _1, _2),
+		std::bind(&TestModelResource::release, modelResource, _1));
+
+	ActorFactory xmlFactory(0);
+	xmlFactory.setEventManager(&eventManager);
+	ActorList xmlActors;
+	Clock::time_point xmlStart = Clock::now();
+	createLevelThroughXML(xmlFactory, *levelData, xmlActors);
+	Clock::time_point xmlEnd = Clock::now();
+
+	ActorFactory levelFactory(0);
+	levelFactory.setEventManager(&eventManager);
+	ActorList::ptr levelActors(new ActorList);
+	Level level(&resourceManager, &levelFactory, &eventManager, nullptr);
+	Clock::time_point levelStart = Clock::now();
+	level.loadLevel(levelData, levelActors);
+	while (level.isLoading())
+	{
+		resourceManager.finishAsyncLoads();
+		level.onFrame();
+	}
+	Clock::time_point levelEnd = Clock::now();
+
+	// The level clones its instances from prototypes, they have to match the XML-built ones
+	BOOST_REQUIRE_EQUAL((unsigned int)std::distance(levelActors->begin(), levelActors->end()), numBenchmarkInstances);
+	BOOST_REQUIRE_EQUAL((unsigned int)std::distance(xmlActors.begin(), xmlActors.end()), numBenchmarkInstances);
+	auto xmlActor = xmlActors.begin();
+	for (auto levelActor = levelActors->begin(); levelActor != levelActors->end(); ++levelActor, ++xmlActor)
+	{
+		BOOST_REQUIRE_EQUAL(levelActor->first, xmlActor->first);
+		BOOST_REQUIRE_EQUAL(serializeActor(levelActor->second), serializeActor(xmlActor->second));
+	}
+
+	const long long xmlMicro = std::chrono::duration_cast<std::chrono::microseconds>(xmlEnd - xmlStart).count();
+	const long long levelMicro = std::chrono::duration_cast<std::chrono::microseconds>(levelEnd - levelStart).count();
+	BOOST_TEST_MESSAGE("Level instances: " << numBenchmarkInstances
+		<< ", XML round-trip: " << xmlMicro << " us"
+		<< ", Level::loadLevel: " << levelMicro << " us");
+
+	level.releaseLevel();
+}
+
+BOOST_AUTO_TEST_CASE(TestInstancePrototypes)
+{
+	EventManager eventManager;
+	IPhysics* physics = IPhysics::createPhysics();
+	physics->initialize(false, 1.f / 60.f);
+	ActorFactory factory(0);
+	factory.setEventManager(&eventManager);
+	factory.setPhysics(physics);
+
+	std::vector<ActorFactory::InstanceEdgeBox> edges(1);
+	edges[0].halfsize = Vector3(100.f, 10.f, 10.f);
+	edges[0].offsetPosition = Vector3(0.f, 200.f, 0.f);
+	edges[0].offsetRotation = Vector3(0.f, 0.f, 0.f);
+	const std::vector<ActorFactory::InstanceBoundingVolume> volumes;
+
+	{
+		ActorFactory::InstanceModel model = createTestInstance(0);
+		Actor::ptr first = factory.createInstanceActor(model, volumes, edges);
+		model.position = Vector3(1000.f, 0.f, 0.f);
+		Actor::ptr clone = factory.createInstanceActor(model, volumes, edges);
+		BOOST_CHECK_EQUAL(factory.getNumInstancePrototypes(), 1);
+		BOOST_CHECK_NE(first->getId(), clone->getId());
+		BOOST_CHECK_EQUAL(clone->getBodyHandles().size(), 1);
+		BOOST_CHECK(clone->getPosition() == model.position);
+
+		model.scale = Vector3(2.f, 1.f, 1.f);
+		Actor::ptr scaled = factory.createInstanceActor(model, volumes, edges);
+		BOOST_CHECK_EQUAL(factory.getNumInstancePrototypes(), 2);
+
+		// The prototypes release nothing, the clones release their own bodies
+		const BodyHandle cloneBody = clone->getBodyHandles()[0];
+		factory.clearInstancePrototypes();
+		BOOST_CHECK_EQUAL(factory.getNumInstancePrototypes(), 0);
+		BOOST_CHECK(physics->validBody(cloneBody));
+		clone.reset();
+		BOOST_CHECK(!physics->validBody(cloneBody));
+	}
+
+	IPhysics::deletePhysics(physics);
+}
+
+BOOST_AUTO_TEST_CASE(TestInstanceThroughputBenchmark)
+{
+	typedef std::chrono::high_resolution_clock Clock;
+	static const unsigned int numMeshes = 20;
+	static const unsigned int numEdges = 4;
+
+	EventManager eventManager;
+	IPhysics* physics = IPhysics::createPhysics();
+	physics->initialize(false, 1.f / 60.f);
+
+	std::vector<ActorFactory::InstanceEdgeBox> edges(numEdges);
+	for (unsigned int i = 0; i < numEdges; ++i)
+	{
+		edges[i].halfsize = Vector3(100.f, 10.f, 10.f);
+		edges[i].offsetPosition = Vector3(0.f, 100.f * (float)i, 0.f);
+		edges[i].offsetRotation = Vector3(0.5f * (float)i, 0.f, 0.f);
+	}
+	const std::vector<ActorFactory::InstanceBoundingVolume> volumes;
+
+	std::vector<ActorFactory::InstanceModel> instances;
+	instances.reserve(numBenchmarkInstances);
+	for (unsigned int i = 0; i < numBenchmarkInstances; ++i)
+	{
+		ActorFactory::InstanceModel model = createTestInstance(i);
+		model.meshName = "Mesh" + std::to_string(i % numMeshes);
+		model.scale = Vector3(2.f, 1.f, 1.f);
+		instances.push_back(model);
+	}
+
+	double instancesPerSec[2];
+	std::vector<std::string> builtActors;
+	for (unsigned int pass = 0; pass < 2; ++pass)
+	{
+		const bool usePrototypes = pass == 1;
+		ActorFactory factory(0);
+		factory.setEventManager(&eventManager);
+		factory.setPhysics(physics);
+
+		std::vector<Actor::ptr> actors;
+		actors.reserve(numBenchmarkInstances);
+
+		Clock::time_point start = Clock::now();
+		for (const auto& instance : instances)
+		{
+			if (!usePrototypes)
+			{
+				factory.clearInstancePrototypes();
+			}
+			actors.push_back(factory.createInstanceActor(instance, volumes, edges));
+		}
+		Clock::time_point end = Clock::now();
+
+		BOOST_CHECK_EQUAL(actors.size(), numBenchmarkInstances);
+		if (usePrototypes)
+		{
+			BOOST_CHECK_EQUAL(factory.getNumInstancePrototypes(), numMeshes);
+
+			// Cloned actors match the ones built from scratch, including their edge components
+			BOOST_REQUIRE_EQUAL(builtActors.size(), actors.size());
+			for (unsigned int i = 0; i < actors.size(); ++i)
+			{
+				BOOST_REQUIRE_EQUAL(actors[i]->getBodyHandles().size(), numEdges);
+				BOOST_REQUIRE_EQUAL(serializeActor(actors[i]), builtActors[i]);
+			}
+		}
+		else
+		{
+			for (const auto& actor : actors)
+			{
+				builtActors.push_back(serializeActor(actor));
+			}
+		}
+
+		const double seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - start).count();
+		instancesPerSec[pass] = seconds > 0.0 ? numBenchmarkInstances / seconds : 0.0;
+	}
+
+	BOOST_TEST_MESSAGE("Level load throughput, " << numBenchmarkInstances << " instances of " << numMeshes << " meshes: "
+		<< instancesPerSec[0] << " instances/s without prototypes, "
+		<< instancesPerSec[1] << " instances/s with prototypes");
+
+	IPhysics::deletePhysics(physics);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
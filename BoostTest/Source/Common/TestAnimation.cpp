@@ -3,6 +3,9 @@
 #include "AnimationLoader.h"
 #include "CommonExceptions.h"
 
+#include <chrono>
+#include <memory>
+
 /**
  * If these test break, go to dropbox and download the "TestCharacter.atx" file from the "Files needed for BoostTest" folder.
  */
@@ -52,4 +55,234 @@ BOOST_AUTO_TEST_CASE(testAnimation)
 	testAnimation.getFinalTransform();
 }
 
+/**
+ * Build a synthetic skeleton shaped as a binary tree, with parents before children,
+ * a looping "default" clip on track 0 and a layered "Wave" clip on track 4.
+ */
+static AnimationData::ptr createTestSkeleton(unsigned int p_NumJoints)
+{
+	static const unsigned int numFrames = 32;
+
+	AnimationData::ptr data(new AnimationData);
+	data->joints.resize(p_NumJoints);
+	for (unsigned int i = 0; i < p_NumJoints; ++i)
+	{
+		Joint& joint = data->joints[i];
+		joint.m_JointName = "Joint" + std::to_string(i);
+		joint.m_ID = i + 1;
+		joint.m_Parent = i == 0 ? 0 : (i - 1) / 2 + 1;
+		XMStoreFloat4x4(&joint.m_JointOffsetMatrix, XMMatrixIdentity());
+		XMStoreFloat4x4(&joint.m_TotalJointOffset, XMMatrixTranslation(0.f, -(float)i, 0.f));
+
+		joint.m_JointAnimation.resize(numFrames);
+		for (unsigned int f = 0; f < numFrames; ++f)
+		{
+			KeyFrame& key = joint.m_JointAnimation[f];
+			key.m_Trans = XMFLOAT3(0.f, 1.f, 0.f);
+			XMStoreFloat4(&key.m_Rot, XMQuaternionRotationRollPitchYaw(0.01f * f, 0.f, 0.f));
+			key.m_Scale = XMFLOAT3(1.f, 1.f, 1.f);
+		}
+	}
+
+	data->animationClips["default"] = AnimationClip("default", 1.f, 1, numFrames - 2, true, "Joint0", 0, false, false, 0, false, 0, 1.f);
+	data->animationClips["Wave"] = AnimationClip("Wave", 1.f, 1, numFrames - 2, true, "Joint2", 4, true, false, 0, false, 0, 0.5f);
+	data->computeJointData();
+
+	return data;
+}
+
+BOOST_AUTO_TEST_CASE(testJointMasks)
+{
+	AnimationData::ptr data = createTestSkeleton(15);
+
+	// Joint2 has the children 5 and 6, which in turn have 11, 12, 13 and 14.
+	const std::vector<bool>& mask = data->animationClips["Wave"].m_AffectedJoints;
+	BOOST_REQUIRE_EQUAL(mask.size(), 15);
+	for (unsigned int i = 0; i < mask.size(); ++i)
+	{
+		const bool expected = i == 2 || i == 5 || i == 6 || i >= 11;
+		BOOST_CHECK_EQUAL(mask[i], expected);
+	}
+
+	BOOST_REQUIRE_EQUAL(data->inverseBindPoses.size(), 15);
+	BOOST_CHECK_CLOSE(data->inverseBindPoses[4]._42, 4.f, 0.001f);
+}
+
+BOOST_AUTO_TEST_CASE(testUpdateAnimationBenchmark)
+{
+	typedef std::chrono::high_resolution_clock Clock;
+	static const unsigned int numFrames = 2000;
+	static const unsigned int jointCounts[] = { 50, 200 };
+
+	for (unsigned int numJoints : jointCounts)
+	{
+		Animation animation;
+		animation.setAnimationData(createTestSkeleton(numJoints));
+		animation.playClip("default", false);
+		animation.playClip("Wave", false);
+
+		animation.updateAnimation(1.f / 60.f);
+		const DirectX::XMFLOAT4X4* finalTransform = animation.getFinalTransform().data();
+		BOOST_REQUIRE_EQUAL(animation.getFinalTransform().size(), numJoints);
+
+		Clock::time_point start = Clock::now();
+		for (unsigned int i = 0; i < numFrames; ++i)
+		{
+			animation.updateAnimation(1.f / 60.f);
+		}
+		Clock::time_point end = Clock::now();
+
+		// The per frame path must not reallocate the pose
+		BOOST_CHECK(animation.getFinalTransform().data() == finalTransform);
+
+		const double microPerFrame = std::chrono::duration_cast<std::chrono::duration<double, std::micro>>(end - start).count() / numFrames;
+		BOOST_TEST_MESSAGE("updateAnimation with " << numJoints << " joints and a layered clip: " << microPerFrame << " us per update");
+	}
+}
+
+static void addTestIKGroup(AnimationData::ptr p_Data)
+{
+	// Joint1 -> Joint3 -> Joint7 is a chain in the binary tree
+	IKGroup arm;
+	arm.m_GroupName = "Arm";
+	arm.m_Shoulder = "Joint1";
+	arm.m_Elbow = "Joint3";
+	arm.m_Hand = "Joint7";
+	p_Data->ikGroups["Arm"] = arm;
+	p_Data->computeJointData();
+}
+
+BOOST_AUTO_TEST_CASE(testHandles)
+{
+	AnimationData::ptr data = createTestSkeleton(15);
+	addTestIKGroup(data);
+
+	BOOST_CHECK_EQUAL(data->findJoint("Joint7"), 7);
+	BOOST_CHECK_EQUAL(data->findJoint("Missing"), AnimationData::invalidHandle);
+	BOOST_CHECK_EQUAL(data->findClip("Missing"), AnimationData::invalidHandle);
+	BOOST_CHECK_EQUAL(data->findIKGroup("Missing"), AnimationData::invalidHandle);
+
+	const AnimationData::Handle wave = data->findClip("Wave");
+	BOOST_REQUIRE_NE(wave, AnimationData::invalidHandle);
+	BOOST_CHECK_EQUAL(data->clipTable[wave]->m_ClipName, "Wave");
+
+	const AnimationData::Handle arm = data->findIKGroup("Arm");
+	BOOST_REQUIRE_NE(arm, AnimationData::invalidHandle);
+	BOOST_CHECK_EQUAL(data->ikGroupTable[arm].m_Shoulder, 1);
+	BOOST_CHECK_EQUAL(data->ikGroupTable[arm].m_Elbow, 3);
+	BOOST_CHECK_EQUAL(data->ikGroupTable[arm].m_Hand, 7);
+
+	// Resolved and string based calls give the same pose
+	Animation byName;
+	Animation byHandle;
+	byName.setAnimationData(data);
+	byHandle.setAnimationData(data);
+	byName.playClip("Wave", false);
+	byHandle.playClip(wave, false);
+	byName.updateAnimation(0.1f);
+	byHandle.updateAnimation(0.1f);
+
+	XMFLOAT4X4 world;
+	XMStoreFloat4x4(&world, XMMatrixIdentity());
+	const XMFLOAT3 target(2.f, -1.f, 1.f);
+	byName.applyIK_ReachPoint("Arm", target, world, 1.f);
+	byHandle.applyIK_ReachPoint(arm, target, world, 1.f);
+
+	const XMFLOAT3 namePos = byName.getJointPos("Joint7", world);
+	const XMFLOAT3 handlePos = byHandle.getJointPos(data->findJoint("Joint7"), world);
+	BOOST_CHECK(memcmp(&namePos, &handlePos, sizeof(XMFLOAT3)) == 0);
+
+	BOOST_CHECK_THROW(byHandle.getJointPos(AnimationData::invalidHandle, world), InvalidArgument);
+	BOOST_CHECK_THROW(byHandle.getJointPos(15, world), InvalidArgument);
+	byHandle.applyIK_ReachPoint(AnimationData::invalidHandle, target, world, 1.f);
+	byHandle.playClip(AnimationData::invalidHandle, false);
+}
+
+BOOST_AUTO_TEST_CASE(testPoseScratchReuse)
+{
+	static const unsigned int numCharacters = 20;
+
+	AnimationData::ptr data = createTestSkeleton(50);
+	const PoseScratchPool::ptr pool = data->posePool;
+	BOOST_REQUIRE(pool);
+	BOOST_CHECK_EQUAL(pool->getSlotSize(), 100);
+
+	{
+		std::vector<std::unique_ptr<Animation>> characters;
+		for (unsigned int i = 0; i < numCharacters; ++i)
+		{
+			characters.push_back(std::unique_ptr<Animation>(new Animation));
+			characters.back()->setAnimationData(data);
+			characters.back()->updateAnimation(1.f / 60.f);
+		}
+		BOOST_CHECK_EQUAL(pool->getNumSlots() - pool->getNumFreeSlots(), numCharacters);
+	}
+	const unsigned int allocatedSlots = pool->getNumSlots();
+	BOOST_CHECK_EQUAL(pool->getNumFreeSlots(), allocatedSlots);
+
+	// A second wave of characters of the same rig reuses the slots without allocating
+	{
+		std::vector<std::unique_ptr<Animation>> characters;
+		for (unsigned int i = 0; i < numCharacters; ++i)
+		{
+			characters.push_back(std::unique_ptr<Animation>(new Animation));
+			characters.back()->setAnimationData(data);
+		}
+		BOOST_CHECK_EQUAL(pool->getNumSlots(), allocatedSlots);
+		BOOST_CHECK_EQUAL(pool->getNumFreeSlots(), allocatedSlots - numCharacters);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(testHandleLookupBenchmark)
+{
+	typedef std::chrono::high_resolution_clock Clock;
+	static const unsigned int numIterations = 2000;
+
+	AnimationData::ptr data = createTestSkeleton(200);
+	addTestIKGroup(data);
+
+	Animation byName;
+	Animation byHandle;
+	byName.setAnimationData(data);
+	byHandle.setAnimationData(data);
+	byName.updateAnimation(1.f / 60.f);
+	byHandle.updateAnimation(1.f / 60.f);
+
+	XMFLOAT4X4 world;
+	XMStoreFloat4x4(&world, XMMatrixIdentity());
+	const XMFLOAT3 target(2.f, -1.f, 1.f);
+
+	XMFLOAT3 namePos;
+	Clock::time_point nameStart = Clock::now();
+	for (unsigned int i = 0; i < numIterations; ++i)
+	{
+		byName.applyIK_ReachPoint("Arm", target, world, 1.f);
+		namePos = byName.getJointPos("Joint190", world);
+	}
+	Clock::time_point nameEnd = Clock::now();
+
+	const AnimationData::Handle arm = data->findIKGroup("Arm");
+	const AnimationData::Handle joint = data->findJoint("Joint190");
+	XMFLOAT3 handlePos;
+	Clock::time_point handleStart = Clock::now();
+	for (unsigned int i = 0; i < numIterations; ++i)
+	{
+		byHandle.applyIK_ReachPoint(arm, target, world, 1.f);
+		handlePos = byHandle.getJointPos(joint, world);
+	}
+	Clock::time_point handleEnd = Clock::now();
+
+	// Both paths run the same IK, so the poses must match bit for bit
+	BOOST_CHECK(memcmp(&namePos, &handlePos, sizeof(XMFLOAT3)) == 0);
+	const std::vector<XMFLOAT4X4>& namePose = byName.getFinalTransform();
+	const std::vector<XMFLOAT4X4>& handlePose = byHandle.getFinalTransform();
+	BOOST_REQUIRE_EQUAL(namePose.size(), handlePose.size());
+	BOOST_CHECK(memcmp(namePose.data(), handlePose.data(), namePose.size() * sizeof(XMFLOAT4X4)) == 0);
+
+	const long long nameMicro = std::chrono::duration_cast<std::chrono::microseconds>(nameEnd - nameStart).count();
+	const long long handleMicro = std::chrono::duration_cast<std::chrono::microseconds>(handleEnd - handleStart).count();
+	BOOST_TEST_MESSAGE("IK and joint lookups with 200 joints, " << numIterations << " iterations: by name "
+		<< nameMicro << " us, by handle " << handleMicro << " us");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
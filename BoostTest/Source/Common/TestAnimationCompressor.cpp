@@ -0,0 +1,362 @@
+#include <boost/test/unit_test.hpp>
+#include "AnimationCompressor.h"
+#include "AnimationLoader.h"
+#include "AnimationMetadata.h"
+#include "CommonExceptions.h"
+
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+/**
+ * If these test break, go to dropbox and download the "TestCharacter.atx" file from the "Files needed for BoostTest" folder.
+ */
+
+BOOST_AUTO_TEST_SUITE(TestAnimationCompressor)
+
+using namespace DirectX;
+
+static float rotationDistance(const XMFLOAT4& p_A, const XMFLOAT4& p_B)
+{
+	XMVECTOR a = XMLoadFloat4(&p_A);
+	XMVECTOR b = XMLoadFloat4(&p_B);
+	if (XMVectorGetX(XMVector4Dot(a, b)) < 0.f)
+	{
+		b = XMVectorNegate(b);
+	}
+	return XMVectorGetX(XMVector4Length(XMVectorSubtract(a, b)));
+}
+
+/**
+ * The largest component difference, which is what the compression settings bound.
+ */
+static float componentDistance(XMVECTOR p_A, XMVECTOR p_B)
+{
+	XMFLOAT4 diff;
+	XMStoreFloat4(&diff, XMVectorAbs(XMVectorSubtract(p_A, p_B)));
+	return (std::max)((std::max)(diff.x, diff.y), (std::max)(diff.z, diff.w));
+}
+
+static float rotationComponentDistance(const XMFLOAT4& p_A, const XMFLOAT4& p_B)
+{
+	XMVECTOR a = XMLoadFloat4(&p_A);
+	XMVECTOR b = XMLoadFloat4(&p_B);
+	if (XMVectorGetX(XMVector4Dot(a, b)) < 0.f)
+	{
+		b = XMVectorNegate(b);
+	}
+	return componentDistance(a, b);
+}
+
+static float vectorComponentDistance(const XMFLOAT3& p_A, const XMFLOAT3& p_B)
+{
+	return componentDistance(XMLoadFloat3(&p_A), XMLoadFloat3(&p_B));
+}
+
+/**
+ * The joints as stored in a raw .atx file, undoing the offset conversion done by the loader.
+ */
+static std::vector<Joint> getFileJoints(const std::vector<Joint>& p_LoadedJoints)
+{
+	std::vector<Joint> joints = p_LoadedJoints;
+	for (auto& joint : joints)
+	{
+		XMStoreFloat4x4(&joint.m_TotalJointOffset, XMMatrixTranspose(XMLoadFloat4x4(&joint.m_TotalJointOffset)));
+	}
+	return joints;
+}
+
+BOOST_AUTO_TEST_CASE(TestSmallestThree)
+{
+	const XMVECTOR rotations[] =
+	{
+		XMQuaternionIdentity(),
+		XMQuaternionRotationRollPitchYaw(0.3f, -1.2f, 2.5f),
+		XMVectorNegate(XMQuaternionRotationRollPitchYaw(0.3f, -1.2f, 2.5f)),
+		XMQuaternionRotationRollPitchYaw(3.1f, 0.f, 0.f),
+		XMQuaternionRotationAxis(XMVectorSet(0.f, 0.f, 1.f, 0.f), -2.f),
+	};
+
+	for (const XMVECTOR& rotation : rotations)
+	{
+		XMFLOAT4 original;
+		XMStoreFloat4(&original, rotation);
+
+		uint16_t packed[3];
+		CompressedChannel::packQuaternion(original, packed);
+		const XMFLOAT4 unpacked = CompressedChannel::unpackQuaternion(packed);
+
+		BOOST_CHECK_SMALL(rotationDistance(original, unpacked), 0.0002f);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(TestCompressedRoundTrip)
+{
+	AnimationLoader loader;
+	loader.loadAnimationDataResource("raw", "../Source/TestCharacter.atx");
+	AnimationData::ptr raw = loader.getAnimationData("raw");
+	BOOST_REQUIRE(raw);
+	BOOST_REQUIRE(!raw->joints.empty());
+
+	const int numFrames = raw->joints[0].m_JointAnimation.size();
+	AnimationCompressor::Settings settings;
+
+	std::ostringstream output(std::ios::binary);
+	const AnimationCompressor::Statistics stats = AnimationCompressor::write(output, "TestCharacter", raw->joints, numFrames, settings);
+	BOOST_CHECK_LT(stats.m_CompressedKeyBytes, stats.m_RawKeyBytes);
+	BOOST_CHECK_EQUAL(stats.m_TotalChannels, raw->joints.size() * 3);
+
+	std::istringstream input(output.str(), std::ios::binary);
+	BOOST_REQUIRE(AnimationCompressor::isCompressed(input));
+
+	std::string modelName;
+	int decodedFrames = 0;
+	const std::vector<Joint> decoded = AnimationCompressor::read(input, modelName, decodedFrames);
+	BOOST_CHECK_EQUAL(modelName, "TestCharacter");
+	BOOST_CHECK_EQUAL(decodedFrames, numFrames);
+	BOOST_REQUIRE_EQUAL(decoded.size(), raw->joints.size());
+
+	// The bounds hold for the sampled keys, quantization included
+	float maxTranslationError = 0.f;
+	float maxRotationError = 0.f;
+	float maxScaleError = 0.f;
+	for (unsigned int i = 0; i < decoded.size(); ++i)
+	{
+		BOOST_CHECK_EQUAL(decoded[i].m_JointName, raw->joints[i].m_JointName);
+		BOOST_CHECK_EQUAL(decoded[i].m_Parent, raw->joints[i].m_Parent);
+		BOOST_CHECK(memcmp(&decoded[i].m_TotalJointOffset, &raw->joints[i].m_TotalJointOffset, sizeof(XMFLOAT4X4)) == 0);
+
+		for (int f = 0; f < numFrames; ++f)
+		{
+			const KeyFrame& a = raw->joints[i].m_JointAnimation[f];
+			const KeyFrame b = decoded[i].getKeyFrame(f);
+
+			XMFLOAT4 normalizedRotation;
+			XMStoreFloat4(&normalizedRotation, XMQuaternionNormalize(XMLoadFloat4(&a.m_Rot)));
+
+			maxTranslationError = (std::max)(maxTranslationError, vectorComponentDistance(a.m_Trans, b.m_Trans));
+			maxRotationError = (std::max)(maxRotationError, rotationComponentDistance(normalizedRotation, b.m_Rot));
+			maxScaleError = (std::max)(maxScaleError, vectorComponentDistance(a.m_Scale, b.m_Scale));
+		}
+	}
+	BOOST_CHECK_LE(maxTranslationError, settings.m_TranslationError);
+	BOOST_CHECK_LE(maxRotationError, settings.m_RotationError);
+	BOOST_CHECK_LE(maxScaleError, settings.m_ScaleError);
+	BOOST_CHECK_CLOSE(stats.m_TranslationError + 1.f, maxTranslationError + 1.f, 0.001f);
+	BOOST_CHECK_CLOSE(stats.m_RotationError + 1.f, maxRotationError + 1.f, 0.001f);
+	BOOST_CHECK_CLOSE(stats.m_ScaleError + 1.f, maxScaleError + 1.f, 0.001f);
+
+	BOOST_TEST_MESSAGE("TestCharacter.atx keys: " << stats.m_RawKeyBytes << " bytes raw, "
+		<< stats.m_CompressedKeyBytes << " bytes compressed, "
+		<< stats.m_ConstantChannels << " of " << stats.m_TotalChannels << " channels constant, "
+		<< stats.m_ReducedChannels << " reduced; max error translation " << maxTranslationError
+		<< ", rotation " << maxRotationError << ", scale " << maxScaleError);
+}
+
+BOOST_AUTO_TEST_CASE(TestErrorIncludesQuantization)
+{
+	// A wide range makes the quantization step close to the translation bound
+	static const unsigned int numFrames = 200;
+	std::vector<Joint> joints(1);
+	joints[0].m_JointName = "Root";
+	joints[0].m_ID = 1;
+	joints[0].m_Parent = 0;
+	XMStoreFloat4x4(&joints[0].m_TotalJointOffset, XMMatrixIdentity());
+	joints[0].m_JointAnimation.resize(numFrames);
+	for (unsigned int f = 0; f < numFrames; ++f)
+	{
+		joints[0].m_JointAnimation[f].m_Trans = XMFLOAT3(500.f * sinf(f * 0.05f), 0.25f * f, 0.f);
+		XMStoreFloat4(&joints[0].m_JointAnimation[f].m_Rot, XMQuaternionRotationRollPitchYaw(0.f, 0.03f * f, 0.f));
+		joints[0].m_JointAnimation[f].m_Scale = XMFLOAT3(1.f, 1.f, 1.f);
+	}
+
+	AnimationCompressor::Settings settings;
+	std::ostringstream output(std::ios::binary);
+	const AnimationCompressor::Statistics stats = AnimationCompressor::write(output, "Wide", joints, numFrames, settings);
+	BOOST_CHECK_EQUAL(stats.m_ConstantChannels, 1);
+	BOOST_CHECK_EQUAL(stats.m_ReducedChannels, 2);
+	BOOST_CHECK_LE(stats.m_TranslationError, settings.m_TranslationError);
+	BOOST_CHECK_LE(stats.m_RotationError, settings.m_RotationError);
+
+	std::istringstream input(output.str(), std::ios::binary);
+	std::string modelName;
+	int decodedFrames = 0;
+	const std::vector<Joint> decoded = AnimationCompressor::read(input, modelName, decodedFrames);
+	BOOST_REQUIRE_EQUAL(decoded.size(), 1);
+	BOOST_REQUIRE_EQUAL(decoded[0].getNumFrames(), numFrames);
+	for (unsigned int f = 0; f < numFrames; ++f)
+	{
+		const KeyFrame& a = joints[0].m_JointAnimation[f];
+		const KeyFrame b = decoded[0].getKeyFrame(f);
+		BOOST_CHECK_LE(vectorComponentDistance(a.m_Trans, b.m_Trans), settings.m_TranslationError);
+		BOOST_CHECK_LE(rotationComponentDistance(a.m_Rot, b.m_Rot), settings.m_RotationError);
+	}
+	BOOST_CHECK_THROW(decoded[0].getKeyFrame(numFrames), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(TestLoadCompressedFile)
+{
+	typedef std::chrono::high_resolution_clock Clock;
+	static const char* compressedPath = "TestCharacterCompressed.atx";
+	static const unsigned int numLoads = 20;
+
+	AnimationLoader loader;
+	loader.loadAnimationDataResource("raw", "../Source/TestCharacter.atx");
+	AnimationData::ptr raw = loader.getAnimationData("raw");
+	BOOST_REQUIRE(raw);
+
+	const int numFrames = raw->joints[0].m_JointAnimation.size();
+	{
+		std::ofstream output(compressedPath, std::ostream::out | std::ostream::binary);
+		AnimationCompressor::write(output, "TestCharacter", getFileJoints(raw->joints), numFrames, AnimationCompressor::Settings());
+	}
+
+	loader.loadAnimationDataResource("compressed", compressedPath);
+	AnimationData::ptr compressed = loader.getAnimationData("compressed");
+	BOOST_REQUIRE(compressed);
+	BOOST_REQUIRE_EQUAL(compressed->joints.size(), raw->joints.size());
+	for (unsigned int i = 0; i < raw->joints.size(); ++i)
+	{
+		BOOST_CHECK_CLOSE(compressed->joints[i].m_JointOffsetMatrix._41 + 1000.f, raw->joints[i].m_JointOffsetMatrix._41 + 1000.f, 0.001f);
+		BOOST_CHECK_CLOSE(compressed->joints[i].m_TotalJointOffset._42 + 1000.f, raw->joints[i].m_TotalJointOffset._42 + 1000.f, 0.001f);
+		BOOST_CHECK_EQUAL(compressed->joints[i].getNumFrames(), raw->joints[i].getNumFrames());
+		BOOST_CHECK(compressed->joints[i].m_JointAnimation.empty());
+	}
+	BOOST_CHECK_EQUAL(compressed->inverseBindPoses.size(), compressed->joints.size());
+
+	Clock::time_point rawStart = Clock::now();
+	for (unsigned int i = 0; i < numLoads; ++i)
+	{
+		loader.loadAnimationDataResource("bench", "../Source/TestCharacter.atx");
+		loader.releaseAnimationData("bench");
+	}
+	Clock::time_point rawEnd = Clock::now();
+
+	Clock::time_point compressedStart = Clock::now();
+	for (unsigned int i = 0; i < numLoads; ++i)
+	{
+		loader.loadAnimationDataResource("bench", compressedPath);
+		loader.releaseAnimationData("bench");
+	}
+	Clock::time_point compressedEnd = Clock::now();
+
+	std::ifstream rawFile("../Source/TestCharacter.atx", std::ifstream::binary | std::ifstream::ate);
+	std::ifstream compressedFile(compressedPath, std::ifstream::binary | std::ifstream::ate);
+	const long long rawBytes = rawFile.tellg();
+	const long long compressedBytes = compressedFile.tellg();
+	compressedFile.close();
+
+	const long long rawMicro = std::chrono::duration_cast<std::chrono::microseconds>(rawEnd - rawStart).count() / numLoads;
+	const long long compressedMicro = std::chrono::duration_cast<std::chrono::microseconds>(compressedEnd - compressedStart).count() / numLoads;
+	BOOST_TEST_MESSAGE("TestCharacter.atx file: " << rawBytes << " bytes raw, " << compressedBytes << " bytes compressed; load: "
+		<< rawMicro << " us raw, " << compressedMicro << " us compressed");
+
+	std::remove(compressedPath);
+}
+
+BOOST_AUTO_TEST_CASE(TestEmbeddedMetadata)
+{
+	static const char* animationPath = "TestEmbeddedMetadata.atx";
+	static const char* binaryPath = "TestEmbeddedMetadata.bmlx";
+	static const char* textPath = "TestEmbeddedMetadata.mlx";
+
+	std::vector<Joint> joints(1);
+	joints[0].m_JointName = "Root";
+	joints[0].m_ID = 1;
+	joints[0].m_Parent = 0;
+	XMStoreFloat4x4(&joints[0].m_TotalJointOffset, XMMatrixIdentity());
+	joints[0].m_JointAnimation.resize(10);
+	for (unsigned int f = 0; f < 10; ++f)
+	{
+		joints[0].m_JointAnimation[f].m_Trans = XMFLOAT3((float)f, 0.f, 0.f);
+		joints[0].m_JointAnimation[f].m_Rot = XMFLOAT4(0.f, 0.f, 0.f, 1.f);
+		joints[0].m_JointAnimation[f].m_Scale = XMFLOAT3(1.f, 1.f, 1.f);
+	}
+
+	AnimationMetadata embedded;
+	embedded.m_Clips["Embedded"].m_ClipName = "Embedded";
+	embedded.m_Clips["Embedded"].m_FirstJoint = "Root";
+	{
+		std::ofstream output(animationPath, std::ostream::out | std::ostream::binary);
+		AnimationCompressor::write(output, "Embedded", joints, 10, AnimationCompressor::Settings());
+		embedded.write(output);
+	}
+
+	AnimationLoader loader;
+	BOOST_REQUIRE(loader.loadAnimationDataResource("embedded", animationPath));
+	AnimationData::ptr data = loader.getAnimationData("embedded");
+	BOOST_REQUIRE(data);
+	BOOST_CHECK_EQUAL(data->joints.size(), 1u);
+	BOOST_CHECK_EQUAL(data->animationClips.count("Embedded"), 1u);
+
+	// An edited .mlx makes the embedded metadata stale, a .bmlx converted after the edit is used instead
+	AnimationMetadata sidecar;
+	sidecar.m_Clips["Sidecar"].m_ClipName = "Sidecar";
+	sidecar.m_Clips["Sidecar"].m_FirstJoint = "Root";
+	{
+		std::ofstream output(binaryPath, std::ostream::out | std::ostream::binary);
+		sidecar.write(output);
+	}
+	std::ofstream(textPath).close();
+	const std::time_t converted = boost::filesystem::last_write_time(animationPath);
+	boost::filesystem::last_write_time(textPath, converted + 10);
+	boost::filesystem::last_write_time(binaryPath, converted + 20);
+
+	BOOST_REQUIRE(loader.loadAnimationDataResource("sidecar", animationPath));
+	data = loader.getAnimationData("sidecar");
+	BOOST_CHECK_EQUAL(data->animationClips.count("Embedded"), 0u);
+	BOOST_CHECK_EQUAL(data->animationClips.count("Sidecar"), 1u);
+
+	// The text wins once it is newer than every converted copy
+	boost::filesystem::last_write_time(textPath, converted + 30);
+
+	BOOST_REQUIRE(loader.loadAnimationDataResource("text", animationPath));
+	data = loader.getAnimationData("text");
+	BOOST_CHECK_EQUAL(data->animationClips.count("Embedded"), 0u);
+	BOOST_CHECK_EQUAL(data->animationClips.count("Sidecar"), 0u);
+
+	std::remove(animationPath);
+	std::remove(binaryPath);
+	std::remove(textPath);
+}
+
+BOOST_AUTO_TEST_CASE(TestBrokenCompressedData)
+{
+	std::vector<Joint> joints(1);
+	joints[0].m_JointName = "Root";
+	joints[0].m_ID = 1;
+	joints[0].m_Parent = 0;
+	XMStoreFloat4x4(&joints[0].m_TotalJointOffset, XMMatrixIdentity());
+	joints[0].m_JointAnimation.resize(10);
+	for (unsigned int f = 0; f < 10; ++f)
+	{
+		joints[0].m_JointAnimation[f].m_Trans = XMFLOAT3((float)(f * f), 0.f, 0.f);
+		XMStoreFloat4(&joints[0].m_JointAnimation[f].m_Rot, XMQuaternionRotationRollPitchYaw(0.2f * f, 0.f, 0.f));
+		joints[0].m_JointAnimation[f].m_Scale = XMFLOAT3(1.f, 1.f, 1.f);
+	}
+
+	std::ostringstream output(std::ios::binary);
+	AnimationCompressor::write(output, "Broken", joints, 10, AnimationCompressor::Settings());
+	const std::string data = output.str();
+
+	std::string modelName;
+	int numFrames;
+	std::istringstream truncated(data.substr(0, data.size() - 3), std::ios::binary);
+	BOOST_CHECK_THROW(AnimationCompressor::read(truncated, modelName, numFrames), CommonException);
+
+	std::string wrongVersion = data;
+	wrongVersion[4] = 99;
+	std::istringstream versioned(wrongVersion, std::ios::binary);
+	BOOST_CHECK_THROW(AnimationCompressor::read(versioned, modelName, numFrames), CommonException);
+
+	std::vector<Joint> missingFrames = joints;
+	missingFrames[0].m_JointAnimation.pop_back();
+	std::ostringstream unused(std::ios::binary);
+	BOOST_CHECK_THROW(AnimationCompressor::write(unused, "Broken", missingFrames, 10, AnimationCompressor::Settings()), CommonException);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
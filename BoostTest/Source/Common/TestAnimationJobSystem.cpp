@@ -0,0 +1,370 @@
+#include <boost/test/unit_test.hpp>
+#include "AnimationJobSystem.h"
+#include "CommonExceptions.h"
+
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+BOOST_AUTO_TEST_SUITE(TestAnimationJobSystem)
+
+using namespace DirectX;
+
+/**
+ * A skeleton shaped as a binary tree with a looping "default" clip.
+ */
+static AnimationData::ptr createJobSkeleton(unsigned int p_NumJoints)
+{
+	static const unsigned int numFrames = 32;
+
+	AnimationData::ptr data(new AnimationData);
+	data->joints.resize(p_NumJoints);
+	for (unsigned int i = 0; i < p_NumJoints; ++i)
+	{
+		Joint& joint = data->joints[i];
+		joint.m_JointName = "Joint" + std::to_string(i);
+		joint.m_ID = i + 1;
+		joint.m_Parent = i == 0 ? 0 : (i - 1) / 2 + 1;
+		XMStoreFloat4x4(&joint.m_JointOffsetMatrix, XMMatrixIdentity());
+		XMStoreFloat4x4(&joint.m_TotalJointOffset, XMMatrixTranslation(0.f, -(float)i, 0.f));
+
+		joint.m_JointAnimation.resize(numFrames);
+		for (unsigned int f = 0; f < numFrames; ++f)
+		{
+			KeyFrame& key = joint.m_JointAnimation[f];
+			key.m_Trans = XMFLOAT3(0.f, 1.f, 0.f);
+			XMStoreFloat4(&key.m_Rot, XMQuaternionRotationRollPitchYaw(0.02f * f, 0.01f * f, 0.f));
+			key.m_Scale = XMFLOAT3(1.f, 1.f, 1.f);
+		}
+	}
+
+	data->animationClips["default"] = AnimationClip("default", 1.f, 1, numFrames - 2, true, "Joint0", 0, false, false, 0, false, 0, 1.f);
+	data->computeJointData();
+
+	return data;
+}
+
+/**
+ * Animate a number of actors for a number of frames through a job system.
+ *
+ * @return the published poses of all actors after the last frame
+ */
+static std::vector<XMFLOAT4X4> animateActors(unsigned int p_NumThreads, unsigned int p_NumActors, unsigned int p_NumFrames)
+{
+	AnimationData::ptr data = createJobSkeleton(31);
+	AnimationJobSystem jobs(p_NumThreads);
+
+	std::vector<std::unique_ptr<Animation>> actors;
+	std::vector<AnimationJobSystem::JobPtr> registrations;
+	for (unsigned int i = 0; i < p_NumActors; ++i)
+	{
+		actors.push_back(std::unique_ptr<Animation>(new Animation));
+		actors.back()->setAnimationData(data);
+		actors.back()->playClip("default", false);
+		registrations.push_back(jobs.registerAnimation(actors.back().get(), std::function<void()>()));
+	}
+
+	for (unsigned int f = 0; f < p_NumFrames; ++f)
+	{
+		for (unsigned int i = 0; i < p_NumActors; ++i)
+		{
+			// Every actor at its own speed, and every fourth throttled
+			jobs.submit(registrations[i], (1.f + 0.1f * i) / 60.f, i % 4 == 0 ? 1.f / 20.f : 0.f);
+		}
+		jobs.run();
+	}
+
+	std::vector<XMFLOAT4X4> poses;
+	for (const auto& registration : registrations)
+	{
+		const XMFLOAT4X4* pose = *registration->getPoseSource();
+		poses.insert(poses.end(), pose, pose + registration->getPoseSize());
+	}
+	return poses;
+}
+
+BOOST_AUTO_TEST_CASE(TestPoseArena)
+{
+	PoseArena arena(64);
+
+	PoseArena::Pose* first = arena.allocate(10);
+	PoseArena::Pose* second = arena.allocate(10);
+	BOOST_CHECK_EQUAL(arena.getNumPoses(), 2);
+	BOOST_CHECK_EQUAL(arena.getCapacity(), 64);
+	BOOST_CHECK_EQUAL(first->m_Size, 10);
+	BOOST_CHECK(first->m_Back == first->m_Front + 10);
+
+	XMFLOAT4X4 identity;
+	XMStoreFloat4x4(&identity, XMMatrixIdentity());
+	BOOST_CHECK(memcmp(&first->m_Front[9], &identity, sizeof(XMFLOAT4X4)) == 0);
+
+	// Publishing flips the buffers without touching the data
+	XMStoreFloat4x4(&first->m_Back[0], XMMatrixTranslation(1.f, 2.f, 3.f));
+	const XMFLOAT4X4* back = first->m_Back;
+	PoseArena::publish(first);
+	BOOST_CHECK(first->m_Front == back);
+	BOOST_CHECK_EQUAL(first->m_Front[0]._42, 2.f);
+
+	// Released ranges are reused by poses of the same size
+	const XMFLOAT4X4* range = (std::min)(first->m_Front, first->m_Back);
+	arena.release(first);
+	BOOST_CHECK_EQUAL(arena.getNumPoses(), 1);
+	PoseArena::Pose* third = arena.allocate(10);
+	BOOST_CHECK(third->m_Front == range);
+	BOOST_CHECK_EQUAL(arena.getCapacity(), 64);
+
+	// Poses that do not fit get new chunks
+	arena.allocate(20);
+	BOOST_CHECK_EQUAL(arena.getCapacity(), 128);
+	arena.allocate(100);
+	BOOST_CHECK_EQUAL(arena.getCapacity(), 328);
+	BOOST_CHECK_EQUAL(arena.getNumPoses(), 4);
+
+	BOOST_CHECK_THROW(arena.allocate(0), InvalidArgument);
+	arena.release(second);
+	arena.release(nullptr);
+	BOOST_CHECK_EQUAL(arena.getNumPoses(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(TestPublishedPose)
+{
+	AnimationData::ptr data = createJobSkeleton(15);
+	AnimationJobSystem jobs(0);
+
+	Animation reference;
+	reference.setAnimationData(data);
+	reference.playClip("default", false);
+
+	Animation animation;
+	animation.setAnimationData(data);
+	animation.playClip("default", false);
+	AnimationJobSystem::JobPtr job = jobs.registerAnimation(&animation, std::function<void()>());
+	BOOST_CHECK_EQUAL(job->getPoseSize(), 15);
+	BOOST_CHECK_EQUAL(jobs.getNumThreads(), 0);
+	BOOST_CHECK_EQUAL(jobs.getNumJobs(), 1);
+
+	// Readers follow the pose through the source without copying it
+	const XMFLOAT4X4* const* source = job->getPoseSource();
+	for (unsigned int i = 0; i < 5; ++i)
+	{
+		reference.updateAnimation(1.f / 30.f);
+		jobs.submit(job, 1.f / 30.f, 0.f);
+		jobs.run();
+
+		BOOST_CHECK(memcmp(*source, reference.getFinalTransform().data(), 15 * sizeof(XMFLOAT4X4)) == 0);
+	}
+
+	// Submitting twice before running adds up the time
+	reference.updateAnimation(2.f / 30.f);
+	jobs.submit(job, 1.f / 30.f, 0.f);
+	jobs.submit(job, 1.f / 30.f, 0.f);
+	jobs.run();
+	BOOST_CHECK(memcmp(*source, reference.getFinalTransform().data(), 15 * sizeof(XMFLOAT4X4)) == 0);
+
+	Animation noData;
+	BOOST_CHECK_THROW(jobs.registerAnimation(&noData, std::function<void()>()), InvalidArgument);
+}
+
+BOOST_AUTO_TEST_CASE(TestFinishOrder)
+{
+	AnimationData::ptr data = createJobSkeleton(7);
+	AnimationJobSystem jobs(2);
+
+	std::vector<unsigned int> finished;
+	std::vector<std::unique_ptr<Animation>> actors;
+	std::vector<AnimationJobSystem::JobPtr> registrations;
+	for (unsigned int i = 0; i < 8; ++i)
+	{
+		actors.push_back(std::unique_ptr<Animation>(new Animation));
+		actors.back()->setAnimationData(data);
+		registrations.push_back(jobs.registerAnimation(actors.back().get(), [&finished, i] () { finished.push_back(i); }));
+	}
+
+	// Finish callbacks run in submission order, released jobs are skipped
+	const unsigned int order[] = { 5, 2, 7, 0, 3 };
+	for (unsigned int i : order)
+	{
+		jobs.submit(registrations[i], 1.f / 60.f, 0.f);
+	}
+	registrations[7].reset();
+	jobs.run();
+
+	BOOST_REQUIRE_EQUAL(finished.size(), 4);
+	BOOST_CHECK_EQUAL(finished[0], 5);
+	BOOST_CHECK_EQUAL(finished[1], 2);
+	BOOST_CHECK_EQUAL(finished[2], 0);
+	BOOST_CHECK_EQUAL(finished[3], 3);
+	BOOST_CHECK_EQUAL(jobs.getNumJobs(), 7);
+
+	// Only submitted animations are run
+	finished.clear();
+	jobs.run();
+	BOOST_CHECK(finished.empty());
+}
+
+BOOST_AUTO_TEST_CASE(TestDeterministicThreads)
+{
+	const std::vector<XMFLOAT4X4> serial = animateActors(0, 24, 40);
+	const std::vector<XMFLOAT4X4> parallel = animateActors(3, 24, 40);
+
+	BOOST_REQUIRE_EQUAL(serial.size(), parallel.size());
+	BOOST_CHECK(memcmp(serial.data(), parallel.data(), serial.size() * sizeof(XMFLOAT4X4)) == 0);
+}
+
+/**
+ * Animate a number of actors of which one has a joint with too few key frames.
+ *
+ * @return true if run() threw std::out_of_range and the other actors could be run afterwards
+ */
+static bool runBrokenActor(unsigned int p_NumThreads)
+{
+	AnimationData::ptr data = createJobSkeleton(7);
+	AnimationData::ptr broken = createJobSkeleton(7);
+	broken->joints[3].m_JointAnimation.resize(2);
+	AnimationJobSystem jobs(p_NumThreads);
+
+	std::vector<std::unique_ptr<Animation>> actors;
+	std::vector<AnimationJobSystem::JobPtr> registrations;
+	for (unsigned int i = 0; i < 16; ++i)
+	{
+		actors.push_back(std::unique_ptr<Animation>(new Animation));
+		actors.back()->setAnimationData(i == 5 ? broken : data);
+		actors.back()->playClip("default", false);
+		registrations.push_back(jobs.registerAnimation(actors.back().get(), std::function<void()>()));
+	}
+
+	bool threw = false;
+	for (unsigned int f = 0; f < 30 && !threw; ++f)
+	{
+		for (const auto& registration : registrations)
+		{
+			jobs.submit(registration, 1.f / 10.f, 0.f);
+		}
+		try
+		{
+			jobs.run();
+		}
+		catch (std::out_of_range&)
+		{
+			threw = true;
+		}
+	}
+	if (!threw)
+	{
+		return false;
+	}
+
+	// The workers are idle again and the remaining actors keep animating
+	registrations[5].reset();
+	for (unsigned int f = 0; f < 5; ++f)
+	{
+		for (const auto& registration : registrations)
+		{
+			if (registration)
+			{
+				jobs.submit(registration, 1.f / 10.f, 0.f);
+			}
+		}
+		jobs.run();
+	}
+	return true;
+}
+
+BOOST_AUTO_TEST_CASE(TestThrowingAnimation)
+{
+	BOOST_CHECK(runBrokenActor(0));
+	BOOST_CHECK(runBrokenActor(3));
+}
+
+BOOST_AUTO_TEST_CASE(TestBatchMatchesAnimation)
+{
+	// Two skeleton sizes in one batch, and a layered clip on some of the actors
+	AnimationData::ptr small = createJobSkeleton(7);
+	AnimationData::ptr large = createJobSkeleton(31);
+	const AnimationClip wave("wave", 1.5f, 3, 20, true, "Joint2", 4, true, false, 0, false, 0, 0.5f);
+	small->animationClips["wave"] = wave;
+	large->animationClips["wave"] = wave;
+	small->computeJointData();
+	large->computeJointData();
+
+	AnimationJobSystem jobs(2);
+	std::vector<std::unique_ptr<Animation>> actors;
+	std::vector<std::unique_ptr<Animation>> references;
+	std::vector<AnimationJobSystem::JobPtr> registrations;
+	for (unsigned int i = 0; i < 12; ++i)
+	{
+		AnimationData::ptr data = i % 3 == 0 ? small : large;
+		for (unsigned int copy = 0; copy < 2; ++copy)
+		{
+			std::unique_ptr<Animation> animation(new Animation);
+			animation->setAnimationData(data);
+			animation->playClip("default", false);
+			if (i % 2 == 0)
+			{
+				animation->playClip("wave", false);
+			}
+			(copy == 0 ? actors : references).push_back(std::move(animation));
+		}
+		registrations.push_back(jobs.registerAnimation(actors.back().get(), std::function<void()>()));
+	}
+
+	for (unsigned int f = 0; f < 20; ++f)
+	{
+		for (unsigned int i = 0; i < actors.size(); ++i)
+		{
+			const float deltaTime = (1.f + 0.1f * i) / 60.f;
+			jobs.submit(registrations[i], deltaTime, 0.f);
+			references[i]->updateAnimation(deltaTime);
+		}
+		jobs.run();
+	}
+
+	for (unsigned int i = 0; i < actors.size(); ++i)
+	{
+		const std::vector<XMFLOAT4X4>& expected = references[i]->getFinalTransform();
+		BOOST_REQUIRE_EQUAL(registrations[i]->getPoseSize(), expected.size());
+		BOOST_CHECK(memcmp(*registrations[i]->getPoseSource(), expected.data(), expected.size() * sizeof(XMFLOAT4X4)) == 0);
+	}
+
+	// The layered clip only moves Joint2 and the joints below it
+	Animation plain;
+	plain.setAnimationData(large);
+	plain.playClip("default", false);
+	plain.updateAnimation(1.f / 60.f);
+	Animation waving;
+	waving.setAnimationData(large);
+	waving.playClip("default", false);
+	waving.playClip("wave", false);
+	waving.updateAnimation(1.f / 60.f);
+	BOOST_CHECK(memcmp(&plain.getFinalTransform()[1], &waving.getFinalTransform()[1], sizeof(XMFLOAT4X4)) == 0);
+	BOOST_CHECK(memcmp(&plain.getFinalTransform()[2], &waving.getFinalTransform()[2], sizeof(XMFLOAT4X4)) != 0);
+}
+
+BOOST_AUTO_TEST_CASE(TestJobSystemBenchmark)
+{
+	typedef std::chrono::high_resolution_clock Clock;
+	static const unsigned int numActors = 64;
+	static const unsigned int numFrames = 300;
+
+	const unsigned int numCores = std::thread::hardware_concurrency();
+	const unsigned int numThreads = numCores > 1 ? numCores - 1 : 1;
+
+	Clock::time_point serialStart = Clock::now();
+	const std::vector<XMFLOAT4X4> serial = animateActors(0, numActors, numFrames);
+	Clock::time_point serialEnd = Clock::now();
+
+	Clock::time_point parallelStart = Clock::now();
+	const std::vector<XMFLOAT4X4> parallel = animateActors(numThreads, numActors, numFrames);
+	Clock::time_point parallelEnd = Clock::now();
+
+	BOOST_REQUIRE_EQUAL(serial.size(), parallel.size());
+	BOOST_CHECK(memcmp(serial.data(), parallel.data(), serial.size() * sizeof(XMFLOAT4X4)) == 0);
+
+	const long long serialMicro = std::chrono::duration_cast<std::chrono::microseconds>(serialEnd - serialStart).count();
+	const long long parallelMicro = std::chrono::duration_cast<std::chrono::microseconds>(parallelEnd - parallelStart).count();
+	BOOST_TEST_MESSAGE("Animating " << numActors << " actors for " << numFrames << " frames: single threaded "
+		<< serialMicro << " us, " << numThreads << " workers " << parallelMicro << " us");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,269 @@
+#include <boost/test/unit_test.hpp>
+#include "Animation.h"
+#include "AnimationLOD.h"
+#include "TweakSettings.h"
+
+#include <chrono>
+#include <memory>
+
+BOOST_AUTO_TEST_SUITE(TestAnimationLOD)
+
+using namespace DirectX;
+
+/**
+ * A skeleton shaped as a binary tree with a looping "default" clip and an IK chain "Arm".
+ */
+static AnimationData::ptr createLODSkeleton(unsigned int p_NumJoints)
+{
+	static const unsigned int numFrames = 32;
+
+	AnimationData::ptr data(new AnimationData);
+	data->joints.resize(p_NumJoints);
+	for (unsigned int i = 0; i < p_NumJoints; ++i)
+	{
+		Joint& joint = data->joints[i];
+		joint.m_JointName = "Joint" + std::to_string(i);
+		joint.m_ID = i + 1;
+		joint.m_Parent = i == 0 ? 0 : (i - 1) / 2 + 1;
+		XMStoreFloat4x4(&joint.m_JointOffsetMatrix, XMMatrixIdentity());
+		XMStoreFloat4x4(&joint.m_TotalJointOffset, XMMatrixTranslation(0.f, -(float)i, 0.f));
+
+		joint.m_JointAnimation.resize(numFrames);
+		for (unsigned int f = 0; f < numFrames; ++f)
+		{
+			KeyFrame& key = joint.m_JointAnimation[f];
+			key.m_Trans = XMFLOAT3(0.f, 1.f, 0.f);
+			XMStoreFloat4(&key.m_Rot, XMQuaternionRotationRollPitchYaw(0.02f * f, 0.01f * f, 0.f));
+			key.m_Scale = XMFLOAT3(1.f, 1.f, 1.f);
+		}
+	}
+
+	data->animationClips["default"] = AnimationClip("default", 1.f, 1, numFrames - 2, true, "Joint0", 0, false, false, 0, false, 0, 1.f);
+
+	IKGroup arm;
+	arm.m_GroupName = "Arm";
+	arm.m_Shoulder = "Joint1";
+	arm.m_Elbow = "Joint3";
+	arm.m_Hand = "Joint7";
+	data->ikGroups["Arm"] = arm;
+
+	data->computeJointData();
+
+	return data;
+}
+
+BOOST_AUTO_TEST_CASE(TestLODTweakSettings)
+{
+	TweakSettings::initializeMaster();
+	TweakSettings* settings = TweakSettings::getInstance();
+
+	{
+		AnimationLOD lod;
+		lod.registerTweakSettings();
+		settings->setSetting("animation.lod.full.distance", 123.f);
+		BOOST_CHECK_EQUAL(lod.getTierSettings(AnimationLOD::Tier::FULL).m_MaxDistance, 123.f);
+	}
+
+	// The listeners must not outlive the LOD they write to
+	settings->setSetting("animation.lod.full.distance", 456.f);
+	float distance = 0.f;
+	settings->querySetting("animation.lod.full.distance", distance);
+	BOOST_CHECK_EQUAL(distance, 456.f);
+
+	TweakSettings::shutdown();
+}
+
+BOOST_AUTO_TEST_CASE(TestTierAssignment)
+{
+	AnimationLOD lod;
+
+	AnimationLOD::TierSettings full = lod.getTierSettings(AnimationLOD::Tier::FULL);
+	full.m_MaxDistance = 100.f;
+	full.m_Budget = 2;
+	lod.setTierSettings(AnimationLOD::Tier::FULL, full);
+
+	AnimationLOD::TierSettings reduced = lod.getTierSettings(AnimationLOD::Tier::REDUCED);
+	reduced.m_MaxDistance = 500.f;
+	reduced.m_Budget = 0;
+	lod.setTierSettings(AnimationLOD::Tier::REDUCED, reduced);
+
+	// Distances 0, 50, 90, 400 and 1000 along the x-axis
+	const float distances[] = { 1000.f, 50.f, 400.f, 0.f, 90.f };
+	std::vector<AnimationLOD::InstancePtr> instances;
+	for (float distance : distances)
+	{
+		instances.push_back(lod.registerInstance());
+		instances.back()->m_Position = XMFLOAT3(distance, 0.f, 0.f);
+	}
+	BOOST_CHECK(instances[0]->m_Tier == AnimationLOD::Tier::FULL);
+
+	lod.assignTiers(XMFLOAT3(0.f, 0.f, 0.f));
+
+	// The third closest is within full range but over budget
+	BOOST_CHECK(instances[3]->m_Tier == AnimationLOD::Tier::FULL);
+	BOOST_CHECK(instances[1]->m_Tier == AnimationLOD::Tier::FULL);
+	BOOST_CHECK(instances[4]->m_Tier == AnimationLOD::Tier::REDUCED);
+	BOOST_CHECK(instances[2]->m_Tier == AnimationLOD::Tier::REDUCED);
+	BOOST_CHECK(instances[0]->m_Tier == AnimationLOD::Tier::LOW);
+	BOOST_CHECK_EQUAL(lod.getTierCount(AnimationLOD::Tier::FULL), 2);
+	BOOST_CHECK_EQUAL(lod.getTierCount(AnimationLOD::Tier::REDUCED), 2);
+	BOOST_CHECK_EQUAL(lod.getTierCount(AnimationLOD::Tier::LOW), 1);
+	BOOST_CHECK_EQUAL(instances[0]->m_Settings.m_UseIK, false);
+	BOOST_CHECK_EQUAL(instances[3]->m_Settings.m_UseIK, true);
+	BOOST_CHECK_EQUAL(lod.getTierCountText(), "2 full, 2 reduced, 1 low");
+
+	// Released instances are dropped, freeing budget for the next one in line
+	instances[3].reset();
+	lod.assignTiers(XMFLOAT3(0.f, 0.f, 0.f));
+	BOOST_CHECK(instances[4]->m_Tier == AnimationLOD::Tier::FULL);
+	BOOST_CHECK_EQUAL(lod.getTierCount(AnimationLOD::Tier::FULL) + lod.getTierCount(AnimationLOD::Tier::REDUCED)
+		+ lod.getTierCount(AnimationLOD::Tier::LOW), 4);
+}
+
+BOOST_AUTO_TEST_CASE(TestThrottledUpdate)
+{
+	static const float frameTime = 1.f / 60.f;
+	static const float interval = 0.04f;
+
+	AnimationData::ptr data = createLODSkeleton(15);
+	Animation animation;
+	animation.setAnimationData(data);
+
+	// The first update always evaluates
+	BOOST_CHECK(animation.updateAnimationThrottled(frameTime, interval));
+	BOOST_CHECK(!animation.updateAnimationThrottled(frameTime, interval));
+	BOOST_CHECK(!animation.updateAnimationThrottled(frameTime, interval));
+	BOOST_CHECK(animation.updateAnimationThrottled(frameTime, interval));
+
+	// With two evaluated poses, frames in between continue the motion
+	const XMFLOAT4X4 evaluated = animation.getFinalTransform()[14];
+	BOOST_CHECK(!animation.updateAnimationThrottled(frameTime, interval));
+	const XMFLOAT4X4 extrapolated = animation.getFinalTransform()[14];
+	BOOST_CHECK(memcmp(&evaluated, &extrapolated, sizeof(XMFLOAT4X4)) != 0);
+
+	// A zero interval evaluates every frame
+	BOOST_CHECK(animation.updateAnimationThrottled(frameTime, 0.f));
+	BOOST_CHECK(animation.updateAnimationThrottled(frameTime, 0.f));
+}
+
+BOOST_AUTO_TEST_CASE(TestThrottledUpdateStaysRigid)
+{
+	static const float frameTime = 1.f / 60.f;
+	static const float interval = 0.04f;
+
+	// A single joint spinning quickly, blending its matrices element by element would shrink it
+	AnimationData::ptr data = createLODSkeleton(1);
+	std::vector<KeyFrame>& keys = data->joints[0].m_JointAnimation;
+	for (unsigned int f = 0; f < keys.size(); ++f)
+	{
+		XMStoreFloat4(&keys[f].m_Rot, XMQuaternionRotationRollPitchYaw(0.f, 0.5f * f, 0.f));
+	}
+
+	Animation animation;
+	animation.setAnimationData(data);
+	for (unsigned int frame = 0; frame < 12; ++frame)
+	{
+		animation.updateAnimationThrottled(frameTime, interval);
+
+		const XMMATRIX matrix = XMLoadFloat4x4(&animation.getFinalTransform()[0]);
+		BOOST_CHECK_CLOSE(XMVectorGetX(XMVector3Length(matrix.r[0])), 1.f, 0.1f);
+		BOOST_CHECK_CLOSE(XMVectorGetX(XMVector3Length(matrix.r[1])), 1.f, 0.1f);
+		BOOST_CHECK_CLOSE(XMVectorGetX(XMVector3Length(matrix.r[2])), 1.f, 0.1f);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(TestReducedJointSet)
+{
+	AnimationData::ptr data = createLODSkeleton(15);
+	BOOST_CHECK_EQUAL(data->jointDepths[0], 0);
+	BOOST_CHECK_EQUAL(data->jointDepths[2], 1);
+	BOOST_CHECK_EQUAL(data->jointDepths[14], 3);
+
+	Animation full;
+	Animation reduced;
+	full.setAnimationData(data);
+	reduced.setAnimationData(data);
+	reduced.setMaxJointDepth(1);
+
+	for (unsigned int i = 0; i < 10; ++i)
+	{
+		full.updateAnimation(1.f / 30.f);
+		reduced.updateAnimation(1.f / 30.f);
+	}
+
+	// Joints within the depth are sampled as usual, deeper joints lag behind
+	BOOST_CHECK(memcmp(&full.getFinalTransform()[2], &reduced.getFinalTransform()[2], sizeof(XMFLOAT4X4)) == 0);
+	BOOST_CHECK(memcmp(&full.getFinalTransform()[14], &reduced.getFinalTransform()[14], sizeof(XMFLOAT4X4)) != 0);
+}
+
+BOOST_AUTO_TEST_CASE(TestLODBenchmark)
+{
+	typedef std::chrono::high_resolution_clock Clock;
+	static const unsigned int numActors = 32;
+	static const unsigned int numJoints = 60;
+	static const unsigned int numFrames = 600;
+	static const float frameTime = 1.f / 60.f;
+
+	AnimationData::ptr data = createLODSkeleton(numJoints);
+	const AnimationData::Handle arm = data->findIKGroup("Arm");
+	XMFLOAT4X4 world;
+	XMStoreFloat4x4(&world, XMMatrixIdentity());
+	const XMFLOAT3 target(2.f, -1.f, 1.f);
+
+	AnimationLOD lod;
+	std::vector<std::unique_ptr<Animation>> actors;
+	std::vector<AnimationLOD::InstancePtr> instances;
+	for (unsigned int i = 0; i < numActors; ++i)
+	{
+		actors.push_back(std::unique_ptr<Animation>(new Animation));
+		actors.back()->setAnimationData(data);
+		actors.back()->playClip("default", false);
+
+		instances.push_back(lod.registerInstance());
+		instances.back()->m_Position = XMFLOAT3(0.f, 0.f, 250.f * i);
+	}
+	lod.assignTiers(XMFLOAT3(0.f, 0.f, 0.f));
+
+	Clock::time_point fullStart = Clock::now();
+	for (unsigned int f = 0; f < numFrames; ++f)
+	{
+		for (auto& actor : actors)
+		{
+			actor->updateAnimation(frameTime);
+			actor->applyIK_ReachPoint(arm, target, world, 1.f);
+		}
+	}
+	Clock::time_point fullEnd = Clock::now();
+
+	unsigned int evaluations = 0;
+	Clock::time_point lodStart = Clock::now();
+	for (unsigned int f = 0; f < numFrames; ++f)
+	{
+		lod.assignTiers(XMFLOAT3(0.f, 0.f, 0.f));
+		for (unsigned int i = 0; i < numActors; ++i)
+		{
+			const AnimationLOD::TierSettings& settings = instances[i]->m_Settings;
+			actors[i]->setMaxJointDepth(settings.m_MaxJointDepth);
+			if (actors[i]->updateAnimationThrottled(frameTime, settings.m_UpdateInterval))
+			{
+				++evaluations;
+			}
+			if (settings.m_UseIK)
+			{
+				actors[i]->applyIK_ReachPoint(arm, target, world, 1.f);
+			}
+		}
+	}
+	Clock::time_point lodEnd = Clock::now();
+
+	BOOST_CHECK_LT(evaluations, numActors * numFrames);
+	BOOST_CHECK_EQUAL(lod.getTierCount(AnimationLOD::Tier::FULL), 8);
+
+	const long long fullMicro = std::chrono::duration_cast<std::chrono::microseconds>(fullEnd - fullStart).count();
+	const long long lodMicro = std::chrono::duration_cast<std::chrono::microseconds>(lodEnd - lodStart).count();
+	BOOST_TEST_MESSAGE("Animating " << numActors << " actors with " << numJoints << " joints for " << numFrames
+		<< " frames: full detail " << fullMicro << " us, LOD " << lodMicro << " us (" << lod.getTierCountText()
+		<< ", " << evaluations << " pose evaluations)");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,137 @@
+#include <boost/test/unit_test.hpp>
+#include "AnimationMetadata.h"
+#include "CommonExceptions.h"
+
+#include <chrono>
+#include <sstream>
+
+BOOST_AUTO_TEST_SUITE(TestAnimationMetadata)
+
+static std::string writeMetadata(const AnimationMetadata& p_Metadata)
+{
+	std::ostringstream output(std::ostringstream::binary);
+	p_Metadata.write(output);
+	return output.str();
+}
+
+BOOST_AUTO_TEST_CASE(TestRoundTrip)
+{
+	AnimationMetadata text = AnimationMetadata::loadText("../Source/TestCharacter.mlx");
+	BOOST_REQUIRE(!text.m_Clips.empty());
+	BOOST_REQUIRE(!text.m_Paths.empty());
+
+	IKGrabShell shell;
+	shell.m_Name = "Climb3";
+	shell.m_Speed = 1.2f;
+	IKGrab grab;
+	grab.m_Target = "LeftArm";
+	grab.m_Position = -23.f;
+	grab.m_FadeIn = true;
+	grab.m_FadeInTime = 3.f;
+	grab.m_FadeOutTime = 2.f;
+	grab.m_Start = 1.f;
+	grab.m_End = 20.f;
+	shell.m_Grabs[grab.m_Target] = grab;
+	text.m_GrabShells[shell.m_Name] = shell;
+
+	const std::string data = writeMetadata(text);
+	const AnimationMetadata binary = AnimationMetadata::read(data.data(), data.size());
+
+	BOOST_REQUIRE_EQUAL(binary.m_Clips.size(), text.m_Clips.size());
+	for (const auto& entry : text.m_Clips)
+	{
+		const AnimationClip& expected = entry.second;
+		const AnimationClip& clip = binary.m_Clips.at(entry.first);
+		BOOST_CHECK_EQUAL(clip.m_ClipName, expected.m_ClipName);
+		BOOST_CHECK_EQUAL(clip.m_AnimationSpeed, expected.m_AnimationSpeed);
+		BOOST_CHECK_EQUAL(clip.m_Start, expected.m_Start);
+		BOOST_CHECK_EQUAL(clip.m_End, expected.m_End);
+		BOOST_CHECK_EQUAL(clip.m_Loop, expected.m_Loop);
+		BOOST_CHECK_EQUAL(clip.m_FirstJoint, expected.m_FirstJoint);
+		BOOST_CHECK_EQUAL(clip.m_DestinationTrack, expected.m_DestinationTrack);
+		BOOST_CHECK_EQUAL(clip.m_Layered, expected.m_Layered);
+		BOOST_CHECK_EQUAL(clip.m_FadeIn, expected.m_FadeIn);
+		BOOST_CHECK_EQUAL(clip.m_FadeInFrames, expected.m_FadeInFrames);
+		BOOST_CHECK_EQUAL(clip.m_FadeOut, expected.m_FadeOut);
+		BOOST_CHECK_EQUAL(clip.m_FadeOutFrames, expected.m_FadeOutFrames);
+		BOOST_CHECK_EQUAL(clip.m_Weight, expected.m_Weight);
+	}
+
+	BOOST_REQUIRE_EQUAL(binary.m_IKGroups.size(), text.m_IKGroups.size());
+	for (const auto& entry : text.m_IKGroups)
+	{
+		const IKGroup& group = binary.m_IKGroups.at(entry.first);
+		BOOST_CHECK_EQUAL(group.m_Shoulder, entry.second.m_Shoulder);
+		BOOST_CHECK_EQUAL(group.m_Elbow, entry.second.m_Elbow);
+		BOOST_CHECK_EQUAL(group.m_Hand, entry.second.m_Hand);
+	}
+
+	BOOST_REQUIRE_EQUAL(binary.m_Paths.size(), text.m_Paths.size());
+	for (const auto& entry : text.m_Paths)
+	{
+		const AnimationPath& path = binary.m_Paths.at(entry.first);
+		BOOST_CHECK_EQUAL(path.m_Speed, entry.second.m_Speed);
+		BOOST_REQUIRE_EQUAL(path.m_YPath.size(), entry.second.m_YPath.size());
+		BOOST_REQUIRE_EQUAL(path.m_ZPath.size(), entry.second.m_ZPath.size());
+		for (unsigned int i = 0; i < path.m_ZPath.size(); ++i)
+		{
+			BOOST_CHECK_EQUAL(path.m_ZPath[i].x, entry.second.m_ZPath[i].x);
+			BOOST_CHECK_EQUAL(path.m_ZPath[i].y, entry.second.m_ZPath[i].y);
+		}
+	}
+
+	BOOST_REQUIRE_EQUAL(binary.m_GrabShells.count("Climb3"), 1);
+	const IKGrabShell& readShell = binary.m_GrabShells.at("Climb3");
+	BOOST_CHECK_EQUAL(readShell.m_Speed, 1.2f);
+	BOOST_REQUIRE_EQUAL(readShell.m_Grabs.count("LeftArm"), 1);
+	const IKGrab& readGrab = readShell.m_Grabs.at("LeftArm");
+	BOOST_CHECK_EQUAL(readGrab.m_Position, -23.f);
+	BOOST_CHECK_EQUAL(readGrab.m_FadeIn, true);
+	BOOST_CHECK_EQUAL(readGrab.m_FadeOutTime, 2.f);
+	BOOST_CHECK_EQUAL(readGrab.m_End, 20.f);
+	BOOST_CHECK_EQUAL(readGrab.m_Faded, 1.f);
+}
+
+BOOST_AUTO_TEST_CASE(TestInvalidData)
+{
+	const std::string data = writeMetadata(AnimationMetadata::loadText("../Source/TestCharacter.mlx"));
+
+	BOOST_CHECK_THROW(AnimationMetadata::read(data.data(), data.size() - 3), CommonException);
+	BOOST_CHECK_THROW(AnimationMetadata::read(data.data(), 2), CommonException);
+
+	std::string wrongMagic = data;
+	wrongMagic[0] = 'X';
+	BOOST_CHECK_THROW(AnimationMetadata::read(wrongMagic.data(), wrongMagic.size()), CommonException);
+
+	AnimationMetadata missing;
+	BOOST_CHECK(!AnimationMetadata::loadBinary("../Source/NoSuchFile.bmlx", missing));
+}
+
+BOOST_AUTO_TEST_CASE(TestMetadataBenchmark)
+{
+	typedef std::chrono::high_resolution_clock Clock;
+	static const unsigned int numLoads = 100;
+
+	const std::string data = writeMetadata(AnimationMetadata::loadText("../Source/TestCharacter.mlx"));
+
+	Clock::time_point textStart = Clock::now();
+	for (unsigned int i = 0; i < numLoads; ++i)
+	{
+		AnimationMetadata::loadText("../Source/TestCharacter.mlx");
+	}
+	Clock::time_point textEnd = Clock::now();
+
+	Clock::time_point binaryStart = Clock::now();
+	for (unsigned int i = 0; i < numLoads; ++i)
+	{
+		AnimationMetadata::read(data.data(), data.size());
+	}
+	Clock::time_point binaryEnd = Clock::now();
+
+	const long long textMicro = std::chrono::duration_cast<std::chrono::microseconds>(textEnd - textStart).count();
+	const long long binaryMicro = std::chrono::duration_cast<std::chrono::microseconds>(binaryEnd - binaryStart).count();
+	BOOST_TEST_MESSAGE("Loading animation metadata " << numLoads << " times: text " << textMicro << " us, binary "
+		<< binaryMicro << " us (" << data.size() << " bytes)");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
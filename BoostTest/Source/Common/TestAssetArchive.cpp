@@ -0,0 +1,285 @@
+#include <boost/test/unit_test.hpp>
+#include <AssetArchive.h>
+#include <CommonExceptions.h>
+#include <ResourceManager.h>
+#include "../../../BinaryConverter/Source/ArchiveConverter.h"
+
+#include <boost/filesystem.hpp>
+
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(TestAssetArchive)
+
+typedef std::chrono::high_resolution_clock Clock;
+
+/**
+ * A directory of resource files with a resource list, removed when done.
+ */
+struct ArchiveFixture
+{
+	boost::filesystem::path m_Root;
+	std::string m_ArchivePath;
+
+	ArchiveFixture()
+		:	m_Root("TestAssetArchive"),
+			m_ArchivePath("TestAssetArchive.hpak")
+	{
+		boost::filesystem::remove_all(m_Root);
+		boost::filesystem::create_directories(m_Root / "assets/textures");
+		boost::filesystem::create_directories(m_Root / "assets/volumes");
+	}
+
+	~ArchiveFixture()
+	{
+		boost::filesystem::remove_all(m_Root);
+		boost::filesystem::remove(m_ArchivePath);
+	}
+
+	void writeFile(const std::string& p_Path, const std::string& p_Contents)
+	{
+		std::ofstream output((m_Root / p_Path).string(), std::ostream::out | std::ostream::binary);
+		output << p_Contents;
+	}
+
+	std::string writeResourceList(const std::string& p_Resources)
+	{
+		const std::string path = (m_Root / "Resources.xml").string();
+		std::ofstream output(path);
+		output << "<Resources>" << p_Resources << "</Resources>";
+		return path;
+	}
+};
+
+BOOST_FIXTURE_TEST_CASE(TestWriteAndFind, ArchiveFixture)
+{
+	const std::string binary("DDS \0\x01\x02\xff", 8);
+	writeFile("assets/textures/Stone.dds", binary);
+	writeFile("assets/textures/Grass.png", "grass");
+	writeFile("assets/volumes/CB_Barrel.bbv", "barrel");
+	writeFile("assets/textures/Empty.png", "");
+
+	const std::string resourceList = writeResourceList(
+		"<ResourceType Type=\"texture\">"
+			"<Resource Name=\"Stone\" Path=\"assets/textures/Stone.dds\"/>"
+			"<Resource Name=\"Grass\" Path=\"assets/textures/Grass.png\"/>"
+			"<Resource Name=\"Empty\" Path=\"assets/textures/Empty.png\"/>"
+			"<Resource Name=\"Missing\" Path=\"assets/textures/Missing.png\"/>"
+			"<Resource Name=\"Stone\" Path=\"assets/textures/Grass.png\"/>"
+		"</ResourceType>"
+		"<ResourceType Type=\"volume\">"
+			"<Resource Name=\"Barrel\" Path=\"assets/volumes/CB_Barrel.bbv\"/>"
+		"</ResourceType>");
+
+	ArchiveConverter converter;
+	BOOST_REQUIRE(converter.loadResourceList(resourceList));
+	BOOST_REQUIRE(converter.writeFile(m_Root.string(), m_ArchivePath));
+	BOOST_REQUIRE_EQUAL(converter.getMissingFiles().size(), 1);
+	BOOST_CHECK_EQUAL(converter.getMissingFiles()[0], "assets/textures/Missing.png");
+
+	AssetArchive archive;
+	BOOST_CHECK(!archive.isOpen());
+	BOOST_CHECK(archive.find("texture", "Stone") == nullptr);
+	BOOST_REQUIRE(archive.open(m_ArchivePath));
+	BOOST_CHECK_EQUAL(archive.getNumEntries(), 4);
+
+	// The first resource with a name is used, like in the resource list
+	const AssetArchiveFormat::Entry* stone = archive.find("texture", "Stone");
+	BOOST_REQUIRE(stone != nullptr);
+	BOOST_CHECK_EQUAL(archive.getPath(*stone), "assets/textures/Stone.dds");
+	BOOST_CHECK(std::string(archive.getData(*stone), static_cast<size_t>(stone->m_DataSize)) == binary);
+	BOOST_CHECK_EQUAL(stone->m_DataOffset % AssetArchiveFormat::alignment, 0);
+
+	const AssetArchiveFormat::Entry* barrel = archive.find("volume", "Barrel");
+	BOOST_REQUIRE(barrel != nullptr);
+	BOOST_CHECK_EQUAL(std::string(archive.getData(*barrel), static_cast<size_t>(barrel->m_DataSize)), "barrel");
+	BOOST_CHECK_EQUAL(barrel->m_DataOffset % AssetArchiveFormat::alignment, 0);
+
+	const AssetArchiveFormat::Entry* empty = archive.find("texture", "Empty");
+	BOOST_REQUIRE(empty != nullptr);
+	BOOST_CHECK_EQUAL(empty->m_DataSize, 0);
+
+	BOOST_CHECK(archive.find("texture", "Missing") == nullptr);
+	BOOST_CHECK(archive.find("volume", "Stone") == nullptr);
+	BOOST_CHECK(archive.find("textur", "e:Stone") == nullptr);
+
+	archive.close();
+	BOOST_CHECK(!archive.isOpen());
+	BOOST_CHECK_EQUAL(archive.getNumEntries(), 0);
+}
+
+BOOST_FIXTURE_TEST_CASE(TestInvalidArchive, ArchiveFixture)
+{
+	writeFile("assets/textures/Grass.png", "grass");
+	ArchiveConverter converter;
+	converter.addResource("texture", "Grass", "assets/textures/Grass.png");
+	BOOST_REQUIRE(converter.writeFile(m_Root.string(), m_ArchivePath));
+
+	std::string contents;
+	{
+		std::ifstream input(m_ArchivePath, std::istream::in | std::istream::binary);
+		std::ostringstream buffer;
+		buffer << input.rdbuf();
+		contents = buffer.str();
+	}
+
+	AssetArchive archive;
+	BOOST_CHECK(!archive.open("NotAnArchive.hpak"));
+	BOOST_REQUIRE(archive.open(m_ArchivePath));
+	archive.close();
+
+	std::string brokenMagic = contents;
+	brokenMagic[0] = 'X';
+	std::string truncated = contents.substr(0, contents.size() - 1);
+	const std::string broken[] = { brokenMagic, truncated, contents.substr(0, 8) };
+	for (const std::string& file : broken)
+	{
+		{
+			std::ofstream output(m_ArchivePath, std::ostream::out | std::ostream::binary | std::ostream::trunc);
+			output << file;
+		}
+		BOOST_CHECK(!archive.open(m_ArchivePath));
+		BOOST_CHECK(!archive.isOpen());
+	}
+}
+
+class TestResource
+{
+public:
+	std::map<std::string, std::string> m_Created;
+
+	bool create(const char* p_ResourceName, const char* p_FilePath)
+	{
+		m_Created[p_ResourceName] = std::string("file:") + p_FilePath;
+		return true;
+	}
+	bool createFromMemory(const char* p_ResourceName, const char* p_Data, size_t p_Size)
+	{
+		m_Created[p_ResourceName] = "memory:" + std::string(p_Data, p_Size);
+		return true;
+	}
+	bool release(const char* p_ResourceName)
+	{
+		m_Created.erase(p_ResourceName);
+		return true;
+	}
+};
+
+BOOST_FIXTURE_TEST_CASE(TestResourceManagerArchive, ArchiveFixture)
+{
+	writeFile("assets/textures/Grass.png", "grass");
+	writeFile("assets/volumes/CB_Barrel.bbv", "barrel");
+	writeFile("assets/textures/Rock.png", "rock");
+	ArchiveConverter converter;
+	converter.addResource("texture", "Grass", "assets/textures/Grass.png");
+	converter.addResource("volume", "Barrel", "assets/volumes/CB_Barrel.bbv");
+	BOOST_REQUIRE(converter.writeFile(m_Root.string(), m_ArchivePath));
+
+	// Resources added after the archive was built are still found through the resource list
+	const std::string resourceList = writeResourceList(
+		"<ResourceType Type=\"texture\">"
+			"<Resource Name=\"Rock\" Path=\"assets/textures/Rock.png\"/>"
+		"</ResourceType>");
+
+	TestResource textures;
+	TestResource volumes;
+	{
+		ResourceManager rm(m_Root);
+		using namespace std::placeholders;
+		rm.registerFunction("texture",
+			std::bind(&TestResource::create, &textures, _1, _2),
+			std::bind(&TestResource::createFromMemory, &textures, _1, _2, _3),
+			std::bind(&TestResource::release, &textures, _1));
+		rm.registerFunction("volume",
+			std::bind(&TestResource::create, &volumes, _1, _2),
+			std::bind(&TestResource::release, &volumes, _1));
+
+		BOOST_CHECK_THROW(rm.loadArchive("NotAnArchive.hpak"), ResourceManagerException);
+		rm.loadDataFromFile(resourceList);
+		rm.loadArchive(m_ArchivePath);
+
+		BOOST_CHECK(rm.isArchived("texture", "Grass"));
+		BOOST_CHECK(!rm.isArchived("texture", "Rock"));
+
+		const int grass = rm.loadResource("texture", "Grass");
+		BOOST_CHECK_EQUAL(textures.m_Created["Grass"], "memory:grass");
+		BOOST_CHECK_EQUAL(rm.loadResource("texture", "Grass"), grass);
+		BOOST_CHECK_EQUAL(textures.m_Created.size(), 1);
+
+		const std::string rockPath = (m_Root / "assets/textures/Rock.png").string();
+		const int rock = rm.loadResource("texture", "Rock");
+		BOOST_CHECK_EQUAL(textures.m_Created["Rock"], "file:" + rockPath);
+		BOOST_CHECK_EQUAL(rm.getResourcePath("texture", "Rock"), rockPath);
+
+		// Types without a memory create function are given the path from the archive
+		const std::string barrelPath = (m_Root / "assets/volumes/CB_Barrel.bbv").string();
+		const int barrel = rm.loadResource("volume", "Barrel");
+		BOOST_CHECK_EQUAL(volumes.m_Created["Barrel"], "file:" + barrelPath);
+		BOOST_CHECK_EQUAL(rm.getResourcePath("volume", "Barrel"), barrelPath);
+
+		BOOST_CHECK_THROW(rm.loadResource("texture", "Unknown"), ResourceManagerException);
+
+		rm.setReleaseImmediately(true);
+		BOOST_CHECK(rm.releaseResource(grass));
+		BOOST_CHECK_EQUAL(textures.m_Created.count("Grass"), 1);
+		BOOST_CHECK(rm.releaseResource(grass));
+		BOOST_CHECK_EQUAL(textures.m_Created.count("Grass"), 0);
+		BOOST_CHECK(rm.releaseResource(rock));
+		BOOST_CHECK(rm.releaseResource(barrel));
+	}
+	BOOST_CHECK(textures.m_Created.empty());
+	BOOST_CHECK(volumes.m_Created.empty());
+}
+
+BOOST_FIXTURE_TEST_CASE(TestLookupBenchmark, ArchiveFixture)
+{
+	static const int numResources = 5000;
+
+	std::ostringstream resources;
+	resources << "<ResourceType Type=\"texture\">";
+	ArchiveConverter converter;
+	for (int i = 0; i < numResources; ++i)
+	{
+		const std::string name = "Texture" + std::to_string(i);
+		const std::string path = "assets/textures/" + name + ".png";
+		writeFile(path, name);
+		converter.addResource("texture", name, path);
+		resources << "<Resource Name=\"" << name << "\" Path=\"" << path << "\"/>";
+	}
+	resources << "</ResourceType>";
+	const std::string resourceList = writeResourceList(resources.str());
+	BOOST_REQUIRE(converter.writeFile(m_Root.string(), m_ArchivePath));
+
+	ResourceTranslator translator;
+	{
+		std::ifstream input(resourceList);
+		translator.loadResourceList(input);
+	}
+	Clock::time_point start = Clock::now();
+	size_t translated = 0;
+	for (int i = 0; i < numResources; ++i)
+	{
+		translated += translator.translate("texture", "Texture" + std::to_string(i)).size();
+	}
+	const long long translateTime = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+
+	AssetArchive archive;
+	BOOST_REQUIRE(archive.open(m_ArchivePath));
+	start = Clock::now();
+	size_t found = 0;
+	for (int i = 0; i < numResources; ++i)
+	{
+		const AssetArchiveFormat::Entry* entry = archive.find("texture", "Texture" + std::to_string(i));
+		found += entry ? archive.getPath(*entry).size() : 0;
+	}
+	const long long findTime = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+	BOOST_CHECK_EQUAL(found, translated);
+
+	BOOST_TEST_MESSAGE("Resolving " << numResources << " resources: resource list " << translateTime
+		<< " us, archive " << findTime << " us");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,193 @@
+#include <boost/test/unit_test.hpp>
+#include "PoseBlender.h"
+
+#include <algorithm>
+#include <chrono>
+
+BOOST_AUTO_TEST_SUITE(TestPoseBlender)
+
+using namespace DirectX;
+
+static std::vector<Joint> createTestJoints(unsigned int p_NumJoints, unsigned int p_NumFrames)
+{
+	std::vector<Joint> joints(p_NumJoints);
+	for (unsigned int i = 0; i < p_NumJoints; ++i)
+	{
+		Joint& joint = joints[i];
+		joint.m_JointName = "Joint" + std::to_string(i);
+		joint.m_ID = i + 1;
+		joint.m_Parent = i;
+		XMStoreFloat4x4(&joint.m_JointOffsetMatrix, XMMatrixIdentity());
+		XMStoreFloat4x4(&joint.m_TotalJointOffset, XMMatrixIdentity());
+
+		joint.m_JointAnimation.resize(p_NumFrames);
+		for (unsigned int f = 0; f < p_NumFrames; ++f)
+		{
+			KeyFrame& key = joint.m_JointAnimation[f];
+			key.m_Trans = XMFLOAT3((float)f, (float)i, 0.f);
+			XMStoreFloat4(&key.m_Rot, XMQuaternionRotationRollPitchYaw(0.05f * f, 0.01f * i, 0.f));
+			key.m_Scale = XMFLOAT3(1.f, 1.f, 1.f);
+		}
+	}
+	return joints;
+}
+
+static bool quaternionsClose(const XMFLOAT4& p_A, FXMVECTOR p_B)
+{
+	// q and -q are the same rotation
+	const float dot = XMVectorGetX(XMVector4Dot(XMLoadFloat4(&p_A), p_B));
+	return fabsf(fabsf(dot) - 1.f) < 0.0001f;
+}
+
+BOOST_AUTO_TEST_CASE(TestBlendMatchesReference)
+{
+	static const unsigned int numPoses = 3;
+	static const unsigned int numJoints = 6;
+
+	PoseBuffer dest;
+	PoseBuffer source;
+	dest.resize(numPoses, numJoints);
+	source.resize(numPoses, numJoints);
+	BOOST_CHECK_EQUAL(dest.getStride(), 8);
+
+	for (unsigned int p = 0; p < numPoses; ++p)
+	{
+		for (unsigned int j = 0; j < numJoints; ++j)
+		{
+			MatrixDecomposed a;
+			XMStoreFloat4(&a.rotation, XMQuaternionRotationRollPitchYaw(0.3f * j, 0.1f * p, 0.f));
+			a.translation = XMFLOAT4((float)j, 0.f, 0.f, 0.f);
+			a.scale = XMFLOAT4(1.f, 1.f, 1.f, 0.f);
+
+			MatrixDecomposed b;
+			// Negated quaternion for odd joints to exercise the shortest arc flip
+			XMVECTOR rotB = XMQuaternionRotationRollPitchYaw(0.f, 0.2f * j + 0.5f, 0.4f);
+			XMStoreFloat4(&b.rotation, j % 2 ? XMVectorNegate(rotB) : rotB);
+			b.translation = XMFLOAT4(0.f, (float)p, 2.f, 0.f);
+			b.scale = XMFLOAT4(2.f, 2.f, 2.f, 0.f);
+
+			dest.setJoint(p, j, a);
+			source.setJoint(p, j, b);
+		}
+	}
+
+	const float poseWeights[numPoses] = { 0.f, 0.25f, 0.7f };
+	std::vector<float> weights(numPoses * dest.getStride());
+	for (unsigned int p = 0; p < numPoses; ++p)
+	{
+		std::fill(weights.begin() + p * dest.getStride(), weights.begin() + (p + 1) * dest.getStride(), poseWeights[p]);
+	}
+
+	// The last joint of the last pose is masked out
+	weights[(numPoses - 1) * dest.getStride() + numJoints - 1] = 0.f;
+	const MatrixDecomposed masked = dest.getJoint(numPoses - 1, numJoints - 1);
+
+	PoseBuffer nlerpDest = dest;
+	PoseBlender::blend(dest, source, weights.data(), PoseBlender::RotationBlend::SLERP);
+	PoseBlender::blendRange(nlerpDest, source, weights.data(), PoseBlender::RotationBlend::NLERP, 1, numPoses - 1);
+	PoseBlender::blendRange(nlerpDest, source, weights.data(), PoseBlender::RotationBlend::NLERP, 0, 1);
+
+	const MatrixDecomposed unblended = dest.getJoint(numPoses - 1, numJoints - 1);
+	BOOST_CHECK(quaternionsClose(unblended.rotation, XMLoadFloat4(&masked.rotation)));
+	BOOST_CHECK_EQUAL(unblended.translation.x, masked.translation.x);
+	BOOST_CHECK_EQUAL(unblended.scale.y, masked.scale.y);
+
+	for (unsigned int p = 0; p < numPoses; ++p)
+	{
+		for (unsigned int j = 0; j < numJoints; ++j)
+		{
+			if (p == numPoses - 1 && j == numJoints - 1)
+			{
+				continue;
+			}
+
+			const XMVECTOR rotA = XMQuaternionRotationRollPitchYaw(0.3f * j, 0.1f * p, 0.f);
+			XMVECTOR rotB = XMQuaternionRotationRollPitchYaw(0.f, 0.2f * j + 0.5f, 0.4f);
+			if (XMVectorGetX(XMVector4Dot(rotA, rotB)) < 0.f)
+			{
+				rotB = XMVectorNegate(rotB);
+			}
+
+			const MatrixDecomposed slerped = dest.getJoint(p, j);
+			BOOST_CHECK(quaternionsClose(slerped.rotation, XMQuaternionSlerp(rotA, rotB, poseWeights[p])));
+			BOOST_CHECK_CLOSE(slerped.translation.x + 1.f, (float)j * (1.f - poseWeights[p]) + 1.f, 0.01f);
+			BOOST_CHECK_CLOSE(slerped.translation.z + 1.f, 2.f * poseWeights[p] + 1.f, 0.01f);
+			BOOST_CHECK_CLOSE(slerped.scale.y, 1.f + poseWeights[p], 0.01f);
+
+			const MatrixDecomposed nlerped = nlerpDest.getJoint(p, j);
+			const XMVECTOR reference = XMQuaternionNormalize(XMVectorLerp(rotA, rotB, poseWeights[p]));
+			BOOST_CHECK(quaternionsClose(nlerped.rotation, reference));
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(TestBatchBlendBenchmark)
+{
+	typedef std::chrono::high_resolution_clock Clock;
+	static const unsigned int numCharacters = 64;
+	static const unsigned int numJoints = 50;
+	static const unsigned int numFrames = 32;
+	static const unsigned int numUpdates = 200;
+
+	const std::vector<Joint> joints = createTestJoints(numJoints, numFrames);
+	std::vector<float> frames(numCharacters);
+	for (unsigned int c = 0; c < numCharacters; ++c)
+	{
+		frames[c] = 1.f + (float)(c % 20) + 0.3f;
+	}
+
+	// Per Animation path: two tracks sampled and blended one joint at a time
+	std::vector<MatrixDecomposed> reference((size_t)numCharacters * numJoints);
+	Clock::time_point perJointStart = Clock::now();
+	for (unsigned int u = 0; u < numUpdates; ++u)
+	{
+		for (unsigned int c = 0; c < numCharacters; ++c)
+		{
+			for (unsigned int j = 0; j < numJoints; ++j)
+			{
+				const MatrixDecomposed track0 = joints[j].interpolateEx(frames[c], frames[c] + 1.f);
+				const MatrixDecomposed track1 = joints[j].interpolateEx(frames[c] + 5.f, frames[c] + 6.f);
+				reference[c * numJoints + j] = joints[j].interpolateEx(track0, track1, 0.5f);
+			}
+		}
+	}
+	Clock::time_point perJointEnd = Clock::now();
+
+	// Batch path: gather the key frames into SoA buffers and blend all characters at once
+	PoseBuffer track0, track0Next, track1, track1Next;
+	track0.resize(numCharacters, numJoints);
+	track0Next.resize(numCharacters, numJoints);
+	track1.resize(numCharacters, numJoints);
+	track1Next.resize(numCharacters, numJoints);
+	const std::vector<float> fractions(numCharacters * track0.getStride(), 0.3f);
+	const std::vector<float> weights(numCharacters * track0.getStride(), 0.5f);
+
+	Clock::time_point batchStart = Clock::now();
+	for (unsigned int u = 0; u < numUpdates; ++u)
+	{
+		for (unsigned int c = 0; c < numCharacters; ++c)
+		{
+			const unsigned int frame = (unsigned int)frames[c];
+			track0.loadKeyFrame(c, joints, frame);
+			track0Next.loadKeyFrame(c, joints, frame + 1);
+			track1.loadKeyFrame(c, joints, frame + 5);
+			track1Next.loadKeyFrame(c, joints, frame + 6);
+		}
+		PoseBlender::blend(track0, track0Next, fractions.data(), PoseBlender::RotationBlend::NLERP);
+		PoseBlender::blend(track1, track1Next, fractions.data(), PoseBlender::RotationBlend::NLERP);
+		PoseBlender::blend(track0, track1, weights.data(), PoseBlender::RotationBlend::SLERP);
+	}
+	Clock::time_point batchEnd = Clock::now();
+
+	// Translation is blended linearly by both paths
+	const MatrixDecomposed batched = track0.getJoint(7, 13);
+	BOOST_CHECK_CLOSE(batched.translation.x, reference[7 * numJoints + 13].translation.x, 0.01f);
+	BOOST_CHECK_CLOSE(batched.translation.y, reference[7 * numJoints + 13].translation.y, 0.01f);
+
+	const long long perJointMicro = std::chrono::duration_cast<std::chrono::microseconds>(perJointEnd - perJointStart).count();
+	const long long batchMicro = std::chrono::duration_cast<std::chrono::microseconds>(batchEnd - batchStart).count();
+	BOOST_TEST_MESSAGE("Pose blending, " << numCharacters << " characters with " << numJoints << " joints, "
+		<< numUpdates << " updates: per joint " << perJointMicro << " us, SoA batch " << batchMicro << " us");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -2,6 +2,12 @@
 #include <ResourceManager.h>
 #include "..\..\Client\Source\ClientExceptions.h"
 
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <thread>
+
 BOOST_AUTO_TEST_SUITE(ResourceManagerTest)
 
 	class TestResource
@@ -105,4 +111,437 @@ BOOST_AUTO_TEST_SUITE(ResourceManagerTest)
 		BOOST_CHECK_THROW(rm.loadDataFromFile(""), ResourceManagerException);
 	}
 
+	BOOST_AUTO_TEST_CASE(ReleaseUnusedResources)
+	{
+		ResourceManager rm;
+		rm.loadDataFromFile("..\\Source\\Common\\Resources.xml");
+		std::vector<std::string> released;
+		rm.registerFunction("model",
+			[] (const char*, const char*) { return true; },
+			[&] (const char* p_Name) { released.push_back(p_Name); return true; });
+
+		const int dzala = rm.loadResource("model", "Dzala");
+		const int house = rm.loadResource("model", "House1");
+		BOOST_CHECK(rm.releaseResource(dzala));
+		BOOST_CHECK(rm.releaseResource(house));
+
+		// A resource that is used again is no longer unused
+		BOOST_CHECK_EQUAL(rm.loadResource("model", "Dzala"), dzala);
+		rm.releaseUnusedResources();
+		BOOST_REQUIRE_EQUAL(released.size(), 1);
+		BOOST_CHECK_EQUAL(released[0], "House1");
+
+		BOOST_CHECK(rm.releaseResource(dzala));
+		BOOST_CHECK(rm.acquireResource(dzala));
+		BOOST_CHECK(rm.releaseResource(dzala));
+		rm.releaseUnusedResources();
+		BOOST_CHECK_EQUAL(released.size(), 2);
+		BOOST_CHECK(!rm.acquireResource(dzala));
+		BOOST_CHECK(rm.getResourceList().at("model").m_LoadedResources.empty());
+	}
+
+	BOOST_AUTO_TEST_CASE(ResourceTableBenchmark)
+	{
+		typedef std::chrono::high_resolution_clock Clock;
+		static const int numResources = 10000;
+
+		const boost::filesystem::path listPath = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+		{
+			std::ofstream list(listPath.string());
+			list << "<Resources><ResourceType Type=\"texture\">";
+			for (int i = 0; i < numResources; ++i)
+			{
+				list << "<Resource Name=\"Texture" << i << "\" Path=\"assets/textures/Texture" << i << ".dds\"/>";
+			}
+			list << "</ResourceType></Resources>";
+		}
+
+		int numCreated = 0;
+		int numReleased = 0;
+		{
+			ResourceManager rm;
+			rm.loadDataFromFile(listPath.string());
+			rm.registerFunction("texture",
+				[&] (const char*, const char*) { ++numCreated; return true; },
+				[&] (const char*) { ++numReleased; return true; });
+
+			std::vector<std::string> names;
+			for (int i = 0; i < numResources; ++i)
+			{
+				names.push_back("Texture" + std::to_string(i));
+			}
+
+			Clock::time_point start = Clock::now();
+			std::vector<int> ids;
+			for (const auto& name : names)
+			{
+				ids.push_back(rm.loadResource("texture", name));
+			}
+			const long long loadTime = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+
+			start = Clock::now();
+			for (unsigned int i = 0; i < names.size(); ++i)
+			{
+				BOOST_CHECK_EQUAL(rm.loadResource("texture", names[i]), ids[i]);
+				BOOST_CHECK(rm.acquireResource(ids[i]));
+			}
+			const long long queryTime = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+
+			start = Clock::now();
+			for (int id : ids)
+			{
+				rm.releaseResource(id);
+				rm.releaseResource(id);
+				rm.releaseResource(id);
+			}
+			rm.releaseUnusedResources();
+			const long long releaseTime = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+
+			BOOST_CHECK_EQUAL(numCreated, numResources);
+			BOOST_CHECK_EQUAL(numReleased, numResources);
+
+			BOOST_TEST_MESSAGE(numResources << " resources: load " << loadTime << " us, query " << queryTime
+				<< " us, release " << releaseTime << " us");
+		}
+
+		boost::filesystem::remove(listPath);
+	}
+
+	BOOST_AUTO_TEST_CASE(ResourceBudget)
+	{
+		ResourceManager rm;
+		std::vector<std::string> released;
+		rm.registerFunction("texture",
+			[] (const char*, const char*) { return true; },
+			[&] (const char* p_Name) { released.push_back(p_Name); return true; });
+		BOOST_CHECK(rm.registerSizeFunction("texture", [] (const char*, const char*) -> size_t { return 10; }));
+		BOOST_CHECK(rm.setResourceBudget("texture", 30));
+		BOOST_CHECK_EQUAL(rm.getResourceBudget("texture"), 30);
+		BOOST_CHECK(!rm.setResourceBudget("model", 30));
+
+		const int a = rm.loadModelTextureImpl("A", "assets/textures/A.dds");
+		const int b = rm.loadModelTextureImpl("B", "assets/textures/B.dds");
+		const int c = rm.loadModelTextureImpl("C", "assets/textures/C.dds");
+		const int d = rm.loadModelTextureImpl("D", "assets/textures/D.dds");
+
+		// Resources in use are kept even when over budget
+		BOOST_CHECK_EQUAL(rm.getResidentSize("texture"), 40);
+
+		BOOST_CHECK(rm.releaseResource(a));
+		BOOST_REQUIRE_EQUAL(released.size(), 1);
+		BOOST_CHECK_EQUAL(released[0], "A");
+		BOOST_CHECK_EQUAL(rm.getResidentSize("texture"), 30);
+
+		// Within budget, unused resources stay loaded in the order they were released
+		BOOST_CHECK(rm.releaseResource(b));
+		BOOST_CHECK(rm.releaseResource(c));
+		BOOST_CHECK_EQUAL(released.size(), 1);
+		std::vector<int> order = rm.getEvictionOrder("texture");
+		BOOST_REQUIRE_EQUAL(order.size(), 2);
+		BOOST_CHECK_EQUAL(order[0], b);
+		BOOST_CHECK_EQUAL(order[1], c);
+
+		// Using a resource again makes it the most recently used
+		BOOST_CHECK_EQUAL(rm.loadModelTextureImpl("B", "assets/textures/B.dds"), b);
+		BOOST_CHECK_EQUAL(rm.getEvictionOrder("texture").size(), 1);
+		BOOST_CHECK(rm.releaseResource(b));
+		order = rm.getEvictionOrder("texture");
+		BOOST_REQUIRE_EQUAL(order.size(), 2);
+		BOOST_CHECK_EQUAL(order[0], c);
+		BOOST_CHECK_EQUAL(order[1], b);
+
+		const int e = rm.loadModelTextureImpl("E", "assets/textures/E.dds");
+		BOOST_REQUIRE_EQUAL(released.size(), 2);
+		BOOST_CHECK_EQUAL(released[1], "C");
+		BOOST_CHECK_EQUAL(rm.getResidentSize("texture"), 30);
+
+		BOOST_CHECK(rm.setResourceBudget("texture", 0));
+		BOOST_REQUIRE_EQUAL(released.size(), 3);
+		BOOST_CHECK_EQUAL(released[2], "B");
+		BOOST_CHECK(rm.getEvictionOrder("texture").empty());
+
+		BOOST_CHECK(rm.releaseResource(d));
+		BOOST_CHECK(rm.releaseResource(e));
+		BOOST_CHECK_EQUAL(released.size(), 5);
+		BOOST_CHECK_EQUAL(rm.getResidentSize("texture"), 0);
+	}
+
+	BOOST_AUTO_TEST_CASE(ResourceChurnBenchmark)
+	{
+		typedef std::chrono::high_resolution_clock Clock;
+		static const int numResources = 200;
+		static const int numFrames = 20000;
+		static const unsigned int maxInUse = 16;
+		static const size_t resourceSize = 1024;
+		static const size_t unlimited = (std::numeric_limits<size_t>::max)();
+
+		struct Policy
+		{
+			const char* m_Name;
+			bool m_ReleaseImmediately;
+			size_t m_Budget;
+		};
+		const Policy policies[] =
+		{
+			{ "release immediately", true, unlimited },
+			{ "budget of 64", false, 64 * resourceSize },
+			{ "unlimited", false, unlimited },
+		};
+		static const unsigned int numPolicies = sizeof(policies) / sizeof(policies[0]);
+
+		std::vector<std::string> names;
+		std::vector<std::string> paths;
+		for (int i = 0; i < numResources; ++i)
+		{
+			names.push_back("Effect" + std::to_string(i));
+			paths.push_back("assets/models/" + names.back() + ".btx");
+		}
+
+		int numCreated[numPolicies];
+		for (unsigned int p = 0; p < numPolicies; ++p)
+		{
+			numCreated[p] = 0;
+			ResourceManager rm;
+			rm.registerFunction("texture",
+				[&] (const char*, const char*) { ++numCreated[p]; return true; },
+				[] (const char*) { return true; });
+			rm.registerSizeFunction("texture", [] (const char*, const char*) { return resourceSize; });
+			rm.setReleaseImmediately(policies[p].m_ReleaseImmediately);
+			rm.setResourceBudget("texture", policies[p].m_Budget);
+
+			// Resources near a slowly moving window come and go every frame,
+			// like spell effects during a game
+			std::mt19937 random(5);
+			std::vector<int> inUse;
+			bool withinBudget = true;
+			const Clock::time_point start = Clock::now();
+			for (int frame = 0; frame < numFrames; ++frame)
+			{
+				const int window = frame * numResources / numFrames;
+				const int index = (window + random() % 32) % numResources;
+				inUse.push_back(rm.loadModelTextureImpl(names[index].c_str(), paths[index].c_str()));
+
+				if (inUse.size() > maxInUse)
+				{
+					const size_t released = random() % inUse.size();
+					rm.releaseResource(inUse[released]);
+					inUse[released] = inUse.back();
+					inUse.pop_back();
+				}
+
+				withinBudget = withinBudget && rm.getResidentSize("texture") <= policies[p].m_Budget;
+			}
+			const long long churnTime = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+
+			BOOST_CHECK(withinBudget);
+			for (int id : inUse)
+			{
+				rm.releaseResource(id);
+			}
+
+			BOOST_TEST_MESSAGE(policies[p].m_Name << ": " << numCreated[p] << " loads in " << numFrames
+				<< " frames, " << churnTime << " us");
+		}
+
+		BOOST_CHECK_LT(numCreated[1], numCreated[0]);
+		BOOST_CHECK_LE(numCreated[2], numCreated[1]);
+		BOOST_CHECK_LE(numCreated[2], numResources);
+	}
+
+	/**
+	 * Registers a model type that depends on two textures, and loads and
+	 * releases the textures when created and released like the graphics does.
+	 */
+	class AsyncTestResources
+	{
+	public:
+		ResourceManager& m_Manager;
+		std::vector<std::string> m_Finished;
+		std::vector<std::thread::id> m_PrepareThreads;
+		std::mutex m_PrepareLock;
+		int m_NumReleased;
+
+		explicit AsyncTestResources(ResourceManager& p_Manager)
+			:	m_Manager(p_Manager),
+				m_NumReleased(0)
+		{
+			m_Manager.registerFunction("model",
+				[this] (const char* p_Name, const char*) { return createModel(p_Name); },
+				[this] (const char*)
+				{
+					m_Manager.releaseModelTextureImpl("Diffuse");
+					m_Manager.releaseModelTextureImpl("Normal");
+					m_NumReleased++;
+					return true;
+				});
+			m_Manager.registerFunction("texture",
+				[this] (const char* p_Name, const char*) { return createTexture(p_Name); },
+				[this] (const char*)
+				{
+					m_NumReleased++;
+					return true;
+				});
+
+			m_Manager.registerPrepareFunction("model",
+				[this] (const char* p_Name, const char*, ResourceDependencies& p_Dependencies) -> ResourceManager::FinishFunction
+				{
+					recordPrepare();
+					p_Dependencies.addDependency("texture", "Diffuse", "assets/textures/Diffuse.dds");
+					p_Dependencies.addDependency("texture", "Normal", "assets/textures/Normal.dds");
+					const std::string name(p_Name);
+					return [=] () { return createModel(name.c_str()); };
+				});
+			m_Manager.registerPrepareFunction("texture",
+				[this] (const char* p_Name, const char*, ResourceDependencies&) -> ResourceManager::FinishFunction
+				{
+					recordPrepare();
+					const std::string name(p_Name);
+					return [=] () { return createTexture(name.c_str()); };
+				});
+		}
+
+		bool createModel(const char* p_Name)
+		{
+			m_Finished.push_back(p_Name);
+			m_Manager.loadModelTextureImpl("Diffuse", "assets/textures/Diffuse.dds");
+			m_Manager.loadModelTextureImpl("Normal", "assets/textures/Normal.dds");
+			return true;
+		}
+
+		bool createTexture(const char* p_Name)
+		{
+			m_Finished.push_back(p_Name);
+			return true;
+		}
+
+		void recordPrepare()
+		{
+			std::lock_guard<std::mutex> lock(m_PrepareLock);
+			m_PrepareThreads.push_back(std::this_thread::get_id());
+		}
+
+	private:
+		AsyncTestResources& operator=(const AsyncTestResources&);
+	};
+
+	BOOST_AUTO_TEST_CASE(LoadResourceAsync)
+	{
+		ResourceManager rm;
+		rm.loadDataFromFile("..\\Source\\Common\\Resources.xml");
+		AsyncTestResources resources(rm);
+		rm.setReleaseImmediately(true);
+
+		int id = -1;
+		rm.loadResourceAsync("model", "Dzala", [&] (int p_ID) { id = p_ID; });
+		BOOST_CHECK_EQUAL(id, -1);
+		BOOST_CHECK_EQUAL(rm.getNumPendingLoads(), 1);
+
+		rm.finishAsyncLoads();
+		BOOST_CHECK_GE(id, 0);
+		BOOST_CHECK_EQUAL(rm.getNumPendingLoads(), 0);
+
+		// The textures are finished before the model that depends on them
+		BOOST_REQUIRE_EQUAL(resources.m_Finished.size(), 3);
+		BOOST_CHECK(resources.m_Finished[0] != "Dzala");
+		BOOST_CHECK(resources.m_Finished[1] != "Dzala");
+		BOOST_CHECK_EQUAL(resources.m_Finished[2], "Dzala");
+
+		// An already loaded resource is referenced at once, like loadResource
+		int sameId = -1;
+		rm.loadResourceAsync("model", "Dzala", [&] (int p_ID) { sameId = p_ID; });
+		BOOST_CHECK_EQUAL(sameId, id);
+		BOOST_CHECK_EQUAL(rm.loadResource("model", "Dzala"), id);
+
+		BOOST_CHECK(rm.releaseResource(id));
+		BOOST_CHECK(rm.releaseResource(id));
+		BOOST_CHECK_EQUAL(resources.m_NumReleased, 0);
+
+		// Only the references taken by the model keep the textures loaded
+		BOOST_CHECK(rm.releaseResource(id));
+		BOOST_CHECK_EQUAL(resources.m_NumReleased, 3);
+	}
+
+	BOOST_AUTO_TEST_CASE(LoadResourceAsyncShared)
+	{
+		ResourceManager rm;
+		rm.loadDataFromFile("..\\Source\\Common\\Resources.xml");
+		AsyncTestResources resources(rm);
+		rm.setReleaseImmediately(true);
+
+		std::vector<int> ids;
+		rm.loadResourceAsync("model", "Dzala", [&] (int p_ID) { ids.push_back(p_ID); });
+		rm.loadResourceAsync("model", "Dzala", [&] (int p_ID) { ids.push_back(p_ID); });
+		rm.loadResourceAsync("model", "House1", [&] (int p_ID) { ids.push_back(p_ID); });
+		BOOST_CHECK_EQUAL(rm.getNumPendingLoads(), 2);
+
+		rm.finishAsyncLoads();
+
+		// Both models share the textures, which are only created once
+		BOOST_REQUIRE_EQUAL(ids.size(), 3);
+		BOOST_CHECK_EQUAL(ids[0], ids[1]);
+		BOOST_CHECK_NE(ids[0], ids[2]);
+		BOOST_CHECK_EQUAL(resources.m_Finished.size(), 4);
+
+		BOOST_CHECK(rm.releaseResource(ids[0]));
+		BOOST_CHECK(rm.releaseResource(ids[2]));
+		BOOST_CHECK_EQUAL(resources.m_NumReleased, 1);
+		BOOST_CHECK(rm.releaseResource(ids[1]));
+		BOOST_CHECK_EQUAL(resources.m_NumReleased, 4);
+	}
+
+	BOOST_AUTO_TEST_CASE(LoadResourceAsyncFailure)
+	{
+		ResourceManager rm;
+		rm.loadDataFromFile("..\\Source\\Common\\Resources.xml");
+		TestResource tr;
+		using namespace std::placeholders;
+		rm.registerFunction("model", std::bind(&TestResource::create, tr, _1, _2), std::bind(&TestResource::release, tr, _1));
+		rm.registerPrepareFunction("model",
+			[] (const char*, const char*, ResourceDependencies&) -> ResourceManager::FinishFunction
+			{
+				throw ResourceManagerException("Broken model", __LINE__, __FILE__);
+			});
+
+		int id = 0;
+		rm.loadResourceAsync("model", "Dzala", [&] (int p_ID) { id = p_ID; });
+		BOOST_CHECK_NO_THROW(rm.finishAsyncLoads());
+		BOOST_CHECK_EQUAL(id, -1);
+		BOOST_CHECK_EQUAL(rm.getNumPendingLoads(), 0);
+		BOOST_CHECK(!rm.registerPrepareFunction("sound", nullptr));
+	}
+
+	BOOST_AUTO_TEST_CASE(LoadResourceAsyncThreads)
+	{
+		ResourceManager rm;
+		rm.loadDataFromFile("..\\Source\\Common\\Resources.xml");
+		AsyncTestResources resources(rm);
+		rm.setLoaderThreads(4);
+
+		int ids[2] = { -1, -1 };
+		rm.loadResourceAsync("model", "Dzala", [&] (int p_ID) { ids[0] = p_ID; });
+		rm.loadResourceAsync("model", "House1", [&] (int p_ID) { ids[1] = p_ID; });
+
+		for (unsigned int i = 0; i < 5000 && rm.getNumPendingLoads() > 0; ++i)
+		{
+			rm.finishAsyncLoads();
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		rm.finishAsyncLoads();
+
+		BOOST_CHECK_EQUAL(rm.getNumPendingLoads(), 0);
+		BOOST_CHECK_GE(ids[0], 0);
+		BOOST_CHECK_GE(ids[1], 0);
+		BOOST_CHECK_EQUAL(resources.m_Finished.size(), 4);
+
+		// Prepared on the loader threads, finished on this one
+		BOOST_CHECK_GE(resources.m_PrepareThreads.size(), 4);
+		for (const auto& thread : resources.m_PrepareThreads)
+		{
+			BOOST_CHECK(thread != std::this_thread::get_id());
+		}
+
+		rm.releaseResource(ids[0]);
+		rm.releaseResource(ids[1]);
+	}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -0,0 +1,283 @@
+#include <boost/test/unit_test.hpp>
+#include "TextTokenizer.h"
+#include "MappedFile.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(TestTextTokenizer)
+
+static TextTokenizer tokenize(const std::string& p_Text)
+{
+	return TextTokenizer(p_Text.data(), p_Text.size());
+}
+
+BOOST_AUTO_TEST_CASE(TestLines)
+{
+	const std::string text = "first line\r\n\r\n \nlast";
+	TextTokenizer tokenizer = tokenize(text);
+
+	BOOST_CHECK(tokenizer.isLineEmpty());
+	BOOST_REQUIRE(tokenizer.nextLine());
+	BOOST_CHECK(!tokenizer.isLineEmpty());
+	BOOST_CHECK(tokenizer.readToken() == "first");
+	BOOST_CHECK(tokenizer.readToken() == "line");
+	BOOST_CHECK(tokenizer.readToken().empty());
+	BOOST_CHECK(tokenizer.fail());
+
+	// A carriage return before the newline is not part of the line
+	BOOST_REQUIRE(tokenizer.nextLine());
+	BOOST_CHECK(!tokenizer.fail());
+	BOOST_CHECK(tokenizer.isLineEmpty());
+
+	// Like comparing a line from std::getline with "", whitespace is not empty
+	BOOST_REQUIRE(tokenizer.nextLine());
+	BOOST_CHECK(!tokenizer.isLineEmpty());
+	BOOST_CHECK(tokenizer.readToken().empty());
+
+	BOOST_REQUIRE(tokenizer.nextLine());
+	BOOST_CHECK(tokenizer.atEnd());
+	std::string last;
+	BOOST_CHECK(tokenizer.readString(last));
+	BOOST_CHECK_EQUAL(last, "last");
+
+	BOOST_CHECK(!tokenizer.nextLine());
+	BOOST_CHECK(tokenizer.isLineEmpty());
+	BOOST_CHECK(tokenizer.readToken().empty());
+
+	// A trailing newline does not start another line
+	const std::string terminated = "a\n";
+	TextTokenizer terminatedTokenizer = tokenize(terminated);
+	BOOST_CHECK(terminatedTokenizer.nextLine());
+	BOOST_CHECK(!terminatedTokenizer.nextLine());
+}
+
+BOOST_AUTO_TEST_CASE(TestStreamSemantics)
+{
+	const std::string text = "v 1.5 -2 3e2 \nface: 3 \n0 / 12 | x 7\n1 2\n";
+	TextTokenizer tokenizer = tokenize(text);
+
+	tokenizer.nextLine();
+	float x = 0.f, y = 0.f, z = 0.f;
+	BOOST_CHECK(tokenizer.readToken() == "v");
+	BOOST_CHECK(tokenizer.readFloat(x));
+	BOOST_CHECK(tokenizer.readFloat(y));
+	BOOST_CHECK(tokenizer.readFloat(z));
+	BOOST_CHECK_EQUAL(x, 1.5f);
+	BOOST_CHECK_EQUAL(y, -2.f);
+	BOOST_CHECK_EQUAL(z, 300.f);
+	BOOST_CHECK(!tokenizer.readFloat(x));
+	BOOST_CHECK_EQUAL(x, 1.5f);
+
+	tokenizer.nextLine();
+	int count = 0;
+	BOOST_CHECK(tokenizer.readToken() == "face:");
+	BOOST_CHECK(tokenizer.readInt(count));
+	BOOST_CHECK_EQUAL(count, 3);
+
+	// Once a read fails, the rest of the line fails as well
+	tokenizer.nextLine();
+	int first = -1, second = -1, third = -1;
+	BOOST_CHECK(tokenizer.readInt(first));
+	BOOST_CHECK(tokenizer.readToken() == "/");
+	BOOST_CHECK(tokenizer.readInt(second));
+	BOOST_CHECK(tokenizer.readToken() == "|");
+	BOOST_CHECK(!tokenizer.readInt(third));
+	BOOST_CHECK(!tokenizer.readInt(third));
+	BOOST_CHECK(tokenizer.readToken().empty());
+	BOOST_CHECK_EQUAL(first, 0);
+	BOOST_CHECK_EQUAL(second, 12);
+	BOOST_CHECK_EQUAL(third, -1);
+
+	tokenizer.nextLine();
+	bool flag = false;
+	BOOST_CHECK(tokenizer.readBool(flag));
+	BOOST_CHECK(flag);
+	BOOST_CHECK(!tokenizer.readBool(flag));
+	BOOST_CHECK(flag);
+
+	// Numbers end where the characters stop matching, like stream extraction
+	const std::string joined = "1.5abc 12.5";
+	TextTokenizer joinedTokenizer = tokenize(joined);
+	joinedTokenizer.nextLine();
+	int integer = 0;
+	BOOST_CHECK(joinedTokenizer.readInt(integer));
+	BOOST_CHECK_EQUAL(integer, 1);
+	BOOST_CHECK(joinedTokenizer.readFloat(x));
+	BOOST_CHECK_EQUAL(x, 0.5f);
+	BOOST_CHECK(joinedTokenizer.readToken() == "abc");
+}
+
+BOOST_AUTO_TEST_CASE(TestParseFloat)
+{
+	const char* const numbers[] =
+	{
+		"0", "-0", "+1", "0.375", "-0.492047", ".5", "5.", "1e5", "1E-5", "2.5e+3",
+		"0.0416667", "-0.00028988", "1.138714", "3.40282346e38", "1.17549435e-38", "1e-45",
+		"0.1000000000000000055511151231257827", "123456789012345678901234567890",
+		"0.70710678118654752440", "16777217", "1e40",
+	};
+	for (const char* number : numbers)
+	{
+		const char* end = number + strlen(number);
+		float value = 42.f;
+		BOOST_CHECK(TextTokenizer::parseFloat(number, end, value) == end);
+		BOOST_CHECK_EQUAL(value, static_cast<float>(strtod(number, nullptr)));
+	}
+
+	// The exponent is only consumed if it has digits
+	const std::string partial = "2e+x";
+	float value = 0.f;
+	BOOST_CHECK(TextTokenizer::parseFloat(partial.data(), partial.data() + partial.size(), value) == partial.data() + 1);
+	BOOST_CHECK_EQUAL(value, 2.f);
+
+	const std::string invalid[] = { "", "-", ".", "e5", "abc", "-.e1" };
+	for (const std::string& text : invalid)
+	{
+		value = 42.f;
+		BOOST_CHECK(TextTokenizer::parseFloat(text.data(), text.data() + text.size(), value) == text.data());
+		BOOST_CHECK_EQUAL(value, 42.f);
+	}
+
+	// Every float printed with enough digits reads back exactly
+	std::mt19937 random(5);
+	std::uniform_real_distribution<float> distribution(-1000.f, 1000.f);
+	for (int i = 0; i < 20000; ++i)
+	{
+		const float original = distribution(random) * (i % 2 ? 1.f : 1e-3f);
+		std::ostringstream printed;
+		if (i % 3 == 0)
+		{
+			printed << std::scientific;
+		}
+		printed << std::setprecision(9) << original;
+		const std::string text = printed.str();
+		float parsed = 0.f;
+		TextTokenizer::parseFloat(text.data(), text.data() + text.size(), parsed);
+		if (parsed != original)
+		{
+			BOOST_ERROR("Read " << text << " as " << parsed);
+			break;
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(TestParseFloatEdgeCases)
+{
+	const char* const numbers[] =
+	{
+		// More significant digits than the mantissa keeps
+		"1234567890123456789012", "0.12345678901234567890123", "99999999999999999999.5",
+		"3.14159265358979323846264338327950288", "-2.71828182845904523536028747135266250e-3",
+		// Leading zeros before and after the point
+		"0000123.25", "-000.000125", "00000000000000000000000000001.5", "007e2",
+		"000000000000000000000012345678901234567890", "0.000000000000000000000000000000000000000123",
+		// Exponents outside the powers of ten that are exact in a double
+		"1e23", "-1e-23", "1.5e-23", "4.7e30", "123e-30", "0.001e25", "3.4028234e38",
+		"1e-38", "1.4e-45", "7e-46", "12345e-50",
+	};
+	for (const char* number : numbers)
+	{
+		const char* end = number + strlen(number);
+		float value = 42.f;
+		BOOST_CHECK(TextTokenizer::parseFloat(number, end, value) == end);
+		BOOST_CHECK_MESSAGE(value == static_cast<float>(strtod(number, nullptr)), number << " read as " << value);
+	}
+
+	// Halfway between two floats, and just either side of it. Narrowing the nearest
+	// double rounds all of these to even, only the exact halfway cases should be.
+	struct Halfway
+	{
+		const char* text;
+		float value;
+	};
+	const Halfway halfways[] =
+	{
+		{ "16777217", 16777216.f },
+		{ "16777219", 16777220.f },
+		{ "-33554434", -33554432.f },
+		{ "0.5000000298023223876953125", 0.5f },
+		{ "1.000000059604644775390625", 1.f },
+		{ "1.000000178813934326171875", 1.0000002384185791015625f },
+		{ "1.00000005960464477539062", 1.f },
+		{ "1.00000005960464477539063", 1.00000011920928955078125f },
+		{ "1.0000000596046447753906250000000001", 1.00000011920928955078125f },
+		{ "1.0000001788139343261718749999999999", 1.00000011920928955078125f },
+		{ "-100000.00390625", -100000.f },
+		{ "-1.0000000390625000000000001e5", -100000.0078125f },
+	};
+	for (const Halfway& halfway : halfways)
+	{
+		const char* end = halfway.text + strlen(halfway.text);
+		float value = 42.f;
+		BOOST_CHECK(TextTokenizer::parseFloat(halfway.text, end, value) == end);
+		BOOST_CHECK_MESSAGE(value == halfway.value, halfway.text << " read as " << std::setprecision(12) << value);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(TestParseInt)
+{
+	const std::string numbers[] = { "0", "-17", "+5", "2147483647", "-2147483648" };
+	for (const std::string& number : numbers)
+	{
+		int value = 42;
+		BOOST_CHECK(TextTokenizer::parseInt(number.data(), number.data() + number.size(), value) == number.data() + number.size());
+		BOOST_CHECK_EQUAL(value, atoi(number.c_str()));
+	}
+
+	const std::string invalid[] = { "", "-", "x1", "2147483648", "-2147483649", "99999999999999999999" };
+	for (const std::string& text : invalid)
+	{
+		int value = 42;
+		BOOST_CHECK(TextTokenizer::parseInt(text.data(), text.data() + text.size(), value) == text.data());
+		BOOST_CHECK_EQUAL(value, 42);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(TestMappedFile)
+{
+	const std::string path = "TestMappedFile.txt";
+	const std::string text = "*Header\r\n#MESH mapped\r\n";
+	{
+		std::ofstream output(path, std::ostream::out | std::ostream::binary);
+		output << text;
+	}
+
+	MappedFile file;
+	BOOST_CHECK(!file.isOpen());
+	BOOST_CHECK(!file.open("NotAFile.txt"));
+	BOOST_REQUIRE(file.open(path));
+	BOOST_REQUIRE_EQUAL(file.getSize(), text.size());
+	BOOST_CHECK(std::string(file.getData(), file.getSize()) == text);
+
+	TextTokenizer tokenizer(file.getData(), file.getSize());
+	tokenizer.nextLine();
+	tokenizer.nextLine();
+	std::string name;
+	tokenizer.readToken();
+	BOOST_CHECK(tokenizer.readString(name));
+	BOOST_CHECK_EQUAL(name, "mapped");
+
+	file.close();
+	BOOST_CHECK(!file.isOpen());
+
+	// Empty files can not be mapped, but are still valid
+	{
+		std::ofstream output(path, std::ostream::out | std::ostream::trunc);
+	}
+	BOOST_REQUIRE(file.open(path));
+	BOOST_CHECK_EQUAL(file.getSize(), 0);
+	TextTokenizer empty(file.getData(), file.getSize());
+	BOOST_CHECK(!empty.nextLine());
+	file.close();
+
+	std::remove(path.c_str());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -102,6 +102,29 @@ BOOST_AUTO_TEST_CASE(TestTweakSettingsListener)
 	BOOST_CHECK_EQUAL(b, testBool1);
 }
 
+BOOST_AUTO_TEST_CASE(TestRemoveTweakSettingsListener)
+{
+	TweakSettings settings;
+
+	static const int testInt1 = 12;
+	static const int testInt2 = 34;
+
+	int i = 0;
+	settings.setListener(std::string("TestInt"), std::function<void(int)>([&] (int p_Val) { i = p_Val; }));
+	settings.setSetting("TestInt", testInt1);
+	BOOST_CHECK_EQUAL(i, testInt1);
+
+	settings.removeListener("TestInt");
+	settings.setSetting("TestInt", testInt2);
+	BOOST_CHECK_EQUAL(i, testInt1);
+
+	int val = 0;
+	settings.querySetting("TestInt", val);
+	BOOST_CHECK_EQUAL(val, testInt2);
+
+	settings.removeListener("MissingSetting");
+}
+
 BOOST_AUTO_TEST_CASE(TestTweakSettingsSingleton)
 {
 	TweakSettings::initializeMaster();
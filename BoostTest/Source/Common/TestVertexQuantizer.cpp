@@ -0,0 +1,138 @@
+#include <boost/test/unit_test.hpp>
+#include "VertexQuantizer.h"
+
+#include <cmath>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(TestVertexQuantizer)
+
+static float angleBetween(const DirectX::XMFLOAT3& p_A, const DirectX::XMFLOAT3& p_B)
+{
+	const DirectX::XMFLOAT3 normal(p_A.y * p_B.z - p_A.z * p_B.y, p_A.z * p_B.x - p_A.x * p_B.z, p_A.x * p_B.y - p_A.y * p_B.x);
+	const float sine = std::sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+	return std::atan2(sine, p_A.x * p_B.x + p_A.y * p_B.y + p_A.z * p_B.z) * 180.f / 3.14159265f;
+}
+
+BOOST_AUTO_TEST_CASE(TestHalf)
+{
+	const float exact[] = { 0.f, -0.f, 1.f, -2.f, 0.5f, 0.25f, 65504.f, 1.f / 1024.f, 6.1035156e-5f };
+	for (float value : exact)
+	{
+		BOOST_CHECK_EQUAL(VertexQuantizer::halfToFloat(VertexQuantizer::floatToHalf(value)), value);
+	}
+
+	BOOST_CHECK_EQUAL(VertexQuantizer::floatToHalf(1.f), 0x3c00);
+	BOOST_CHECK_EQUAL(VertexQuantizer::floatToHalf(-2.f), 0xc000);
+	// Too large for a half becomes infinity
+	BOOST_CHECK_EQUAL(VertexQuantizer::floatToHalf(1e6f), 0x7c00);
+
+	for (float value = -4.f; value <= 4.f; value += 0.0137f)
+	{
+		const float decoded = VertexQuantizer::halfToFloat(VertexQuantizer::floatToHalf(value));
+		BOOST_CHECK_SMALL(decoded - value, 4.f / 2048.f);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(TestOctahedral)
+{
+	float largestError = 0.f;
+	for (int i = 0; i < 64; ++i)
+	{
+		for (int j = 0; j <= 32; ++j)
+		{
+			// Cover the whole sphere, including both poles and the seams of the octahedron
+			const float phi = i * 2.f * 3.14159265f / 64.f;
+			const float theta = j * 3.14159265f / 32.f;
+			const DirectX::XMFLOAT3 direction(std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta));
+
+			int16_t encoded[2];
+			VertexQuantizer::encodeOctahedral(direction, encoded);
+			const DirectX::XMFLOAT3 decoded = VertexQuantizer::decodeOctahedral(encoded);
+			BOOST_CHECK_CLOSE(decoded.x * decoded.x + decoded.y * decoded.y + decoded.z * decoded.z, 1.f, 0.01f);
+			largestError = (std::max)(largestError, angleBetween(direction, decoded));
+		}
+	}
+	BOOST_CHECK_LT(largestError, 0.01f);
+
+	int16_t zero[2];
+	VertexQuantizer::encodeOctahedral(DirectX::XMFLOAT3(0.f, 0.f, 0.f), zero);
+	BOOST_CHECK_EQUAL(VertexQuantizer::decodeOctahedral(zero).z, 1.f);
+}
+
+BOOST_AUTO_TEST_CASE(TestVertex)
+{
+	std::vector<DirectX::XMFLOAT4> positions;
+	positions.push_back(DirectX::XMFLOAT4(-10.f, 2.f, 0.5f, 1.f));
+	positions.push_back(DirectX::XMFLOAT4(30.f, -5.f, 0.5f, 1.f));
+	positions.push_back(DirectX::XMFLOAT4(12.345f, 0.f, 0.5f, 1.f));
+
+	const VertexQuantizer::Bounds bounds = VertexQuantizer::computeBounds(positions.data(), positions.size(), sizeof(DirectX::XMFLOAT4));
+	BOOST_CHECK_EQUAL(bounds.m_Min.x, -10.f);
+	BOOST_CHECK_EQUAL(bounds.m_Size.x, 40.f);
+	BOOST_CHECK_EQUAL(bounds.m_Size.y, 7.f);
+	BOOST_CHECK_EQUAL(bounds.m_Size.z, 0.f);
+
+	const DirectX::XMFLOAT3 normal(0.f, 0.f, -1.f);
+	const DirectX::XMFLOAT3 tangent(1.f, 0.f, 0.f);
+	const DirectX::XMFLOAT3 binormals[] = { DirectX::XMFLOAT3(0.f, 1.f, 0.f), DirectX::XMFLOAT3(0.f, -1.f, 0.f) };
+	for (const DirectX::XMFLOAT3& binormal : binormals)
+	{
+		for (const DirectX::XMFLOAT4& position : positions)
+		{
+			VertexQuantizer::CompactVertex compact;
+			VertexQuantizer::encode(position, normal, DirectX::XMFLOAT2(0.3f, -1.5f), tangent, binormal, bounds, compact);
+
+			DirectX::XMFLOAT4 decodedPosition;
+			DirectX::XMFLOAT3 decodedNormal, decodedTangent, decodedBinormal;
+			DirectX::XMFLOAT2 decodedUV;
+			VertexQuantizer::decode(compact, bounds, decodedPosition, decodedNormal, decodedUV, decodedTangent, decodedBinormal);
+			BOOST_CHECK_SMALL(decodedPosition.x - position.x, 40.f / 65535.f);
+			BOOST_CHECK_SMALL(decodedPosition.y - position.y, 7.f / 65535.f);
+			BOOST_CHECK_EQUAL(decodedPosition.z, position.z);
+			BOOST_CHECK_EQUAL(decodedPosition.w, 1.f);
+			BOOST_CHECK_SMALL(decodedUV.x - 0.3f, 0.001f);
+			BOOST_CHECK_EQUAL(decodedUV.y, -1.5f);
+			BOOST_CHECK_LT(angleBetween(decodedNormal, normal), 0.01f);
+			BOOST_CHECK_LT(angleBetween(decodedTangent, tangent), 0.01f);
+			BOOST_CHECK_LT(angleBetween(decodedBinormal, binormal), 0.01f);
+
+			VertexQuantizer::Error error;
+			VertexQuantizer::measureError(position, normal, DirectX::XMFLOAT2(0.3f, -1.5f), tangent, binormal, compact, bounds, error);
+			BOOST_CHECK_LE(error.m_Position, 40.f / 65535.f);
+			BOOST_CHECK_LT(error.m_Binormal, 0.01f);
+		}
+	}
+
+	BOOST_CHECK_EQUAL(sizeof(VertexQuantizer::CompactVertex), 20);
+	BOOST_CHECK_EQUAL(sizeof(VertexQuantizer::CompactSkinnedVertex), 28);
+}
+
+BOOST_AUTO_TEST_CASE(TestSkin)
+{
+	BOOST_CHECK(VertexQuantizer::canEncodeSkin(DirectX::XMINT4(0, 1, 254, 255)));
+	BOOST_CHECK(!VertexQuantizer::canEncodeSkin(DirectX::XMINT4(0, 256, 0, 0)));
+	BOOST_CHECK(!VertexQuantizer::canEncodeSkin(DirectX::XMINT4(0, 0, 0, -1)));
+
+	const DirectX::XMFLOAT3 weights(0.6f, 0.25f, 0.1f);
+	const DirectX::XMINT4 joints(3, 200, 17, 255);
+	VertexQuantizer::CompactSkin compact;
+	VertexQuantizer::encodeSkin(weights, joints, compact);
+
+	DirectX::XMFLOAT3 decodedWeights;
+	DirectX::XMINT4 decodedJoints;
+	VertexQuantizer::decodeSkin(compact, decodedWeights, decodedJoints);
+	BOOST_CHECK_SMALL(decodedWeights.x - weights.x, 0.5f / 255.f);
+	BOOST_CHECK_SMALL(decodedWeights.y - weights.y, 0.5f / 255.f);
+	BOOST_CHECK_SMALL(decodedWeights.z - weights.z, 0.5f / 255.f);
+	BOOST_CHECK_EQUAL(decodedJoints.x, joints.x);
+	BOOST_CHECK_EQUAL(decodedJoints.y, joints.y);
+	BOOST_CHECK_EQUAL(decodedJoints.z, joints.z);
+	BOOST_CHECK_EQUAL(decodedJoints.w, joints.w);
+
+	VertexQuantizer::Error error;
+	VertexQuantizer::measureSkinError(weights, joints, compact, error);
+	BOOST_CHECK_LE(error.m_Weight, 0.5f / 255.f);
+	BOOST_CHECK_EQUAL(error.m_JointMismatches, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,296 @@
+#include <boost/test/unit_test.hpp>
+#include "../../Graphics/Source/CullingGrid.h"
+#include "../../Graphics/Source/Frustum.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+BOOST_AUTO_TEST_SUITE(TestFrustumCulling)
+
+using namespace DirectX;
+
+static BoundingBox createBox(float p_X, float p_Y, float p_Z, float p_HalfSize)
+{
+	return BoundingBox(XMFLOAT3(p_X - p_HalfSize, p_Y - p_HalfSize, p_Z - p_HalfSize),
+		XMFLOAT3(p_X + p_HalfSize, p_Y + p_HalfSize, p_Z + p_HalfSize));
+}
+
+/**
+ * A camera at the origin looking along +z with a 90 degree field of view,
+ * stored transposed like the matrices in Graphics.
+ */
+static Frustum createCameraFrustum()
+{
+	XMFLOAT4X4 view;
+	XMFLOAT4X4 projection;
+	XMStoreFloat4x4(&view, XMMatrixTranspose(XMMatrixLookToLH(XMVectorSet(0.f, 0.f, 0.f, 1.f),
+		XMVectorSet(0.f, 0.f, 1.f, 0.f), XMVectorSet(0.f, 1.f, 0.f, 0.f))));
+	XMStoreFloat4x4(&projection, XMMatrixTranspose(XMMatrixPerspectiveFovLH(XM_PIDIV2, 1.f, 1.f, 100.f)));
+
+	return Frustum(view, projection);
+}
+
+BOOST_AUTO_TEST_CASE(TestPerspectiveFrustum)
+{
+	const Frustum frustum = createCameraFrustum();
+
+	BOOST_CHECK(frustum.test(createBox(0.f, 0.f, 10.f, 1.f)) == Frustum::Result::INSIDE);
+	BOOST_CHECK(frustum.test(createBox(0.f, 0.f, -10.f, 1.f)) == Frustum::Result::OUTSIDE);
+	BOOST_CHECK(frustum.test(createBox(0.f, 0.f, 200.f, 1.f)) == Frustum::Result::OUTSIDE);
+	BOOST_CHECK(frustum.test(createBox(20.f, 0.f, 10.f, 1.f)) == Frustum::Result::OUTSIDE);
+	BOOST_CHECK(frustum.test(createBox(0.f, -20.f, 10.f, 1.f)) == Frustum::Result::OUTSIDE);
+	BOOST_CHECK(frustum.test(createBox(0.f, 0.f, 1.f, 0.5f)) == Frustum::Result::INTERSECTS);
+	BOOST_CHECK(frustum.test(createBox(10.f, 0.f, 10.f, 1.f)) == Frustum::Result::INTERSECTS);
+	BOOST_CHECK(frustum.test(createBox(0.f, 0.f, 100.f, 1.f)) == Frustum::Result::INTERSECTS);
+
+	BOOST_CHECK(frustum.isVisible(createBox(5.f, 5.f, 50.f, 1.f)));
+	BOOST_CHECK(!frustum.isVisible(createBox(60.f, 5.f, 50.f, 1.f)));
+}
+
+BOOST_AUTO_TEST_CASE(TestOrthographicFrustum)
+{
+	XMFLOAT4X4 view;
+	XMFLOAT4X4 projection;
+	XMStoreFloat4x4(&view, XMMatrixTranspose(XMMatrixLookToLH(XMVectorSet(0.f, 0.f, 0.f, 1.f),
+		XMVectorSet(0.f, -1.f, 0.f, 0.f), XMVectorSet(0.f, 0.f, 1.f, 0.f))));
+	XMStoreFloat4x4(&projection, XMMatrixTranspose(XMMatrixOrthographicLH(100.f, 100.f, -1000.f, 1000.f)));
+	const Frustum frustum(view, projection);
+
+	BOOST_CHECK(frustum.test(createBox(0.f, -500.f, 0.f, 10.f)) == Frustum::Result::INSIDE);
+	BOOST_CHECK(frustum.test(createBox(0.f, 500.f, 0.f, 10.f)) == Frustum::Result::INSIDE);
+	BOOST_CHECK(frustum.test(createBox(80.f, 0.f, 0.f, 10.f)) == Frustum::Result::OUTSIDE);
+	BOOST_CHECK(frustum.test(createBox(50.f, 0.f, 0.f, 10.f)) == Frustum::Result::INTERSECTS);
+}
+
+BOOST_AUTO_TEST_CASE(TestDefaultFrustum)
+{
+	const Frustum frustum;
+
+	BOOST_CHECK(frustum.test(createBox(0.f, 0.f, 0.f, 1.f)) == Frustum::Result::INSIDE);
+	BOOST_CHECK(frustum.test(createBox(-1e6f, 1e6f, 1e6f, 1e5f)) == Frustum::Result::INSIDE);
+}
+
+BOOST_AUTO_TEST_CASE(TestGridMatchesBruteForce)
+{
+	const Frustum frustum = createCameraFrustum();
+	CullingGrid grid(10.f);
+
+	std::srand(4711);
+	std::vector<BoundingBox> boxes;
+	for (unsigned int i = 0; i < 2000; ++i)
+	{
+		const float x = (std::rand() % 2000) / 10.f - 100.f;
+		const float y = (std::rand() % 2000) / 10.f - 100.f;
+		const float z = (std::rand() % 2000) / 10.f - 100.f;
+		const float halfSize = i % 100 == 0 ? 30.f : (std::rand() % 30) / 10.f + 0.1f;
+
+		boxes.push_back(createBox(x, y, z, halfSize));
+		BOOST_CHECK_EQUAL(grid.add(), i);
+		grid.update(i, boxes.back());
+	}
+
+	std::vector<unsigned int> expected;
+	for (unsigned int i = 0; i < boxes.size(); ++i)
+	{
+		if (frustum.isVisible(boxes[i]))
+			expected.push_back(i);
+	}
+	BOOST_REQUIRE(!expected.empty());
+	BOOST_REQUIRE_LT(expected.size(), boxes.size());
+
+	std::vector<unsigned int> visible;
+	grid.cull(frustum, visible);
+	std::sort(visible.begin(), visible.end());
+
+	BOOST_CHECK_EQUAL_COLLECTIONS(visible.begin(), visible.end(), expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(TestGridUpdateAndRemove)
+{
+	const Frustum frustum = createCameraFrustum();
+	CullingGrid grid(10.f);
+	std::vector<unsigned int> visible;
+
+	grid.add();
+	grid.add();
+	grid.add();
+	grid.update(0, createBox(0.f, 0.f, 10.f, 1.f));
+	grid.update(1, createBox(0.f, 0.f, 20.f, 1.f));
+
+	// Handles without a box are never visible
+	grid.cull(frustum, visible);
+	std::sort(visible.begin(), visible.end());
+	BOOST_REQUIRE_EQUAL(visible.size(), 2);
+	BOOST_CHECK_EQUAL(visible[0], 0);
+	BOOST_CHECK_EQUAL(visible[1], 1);
+
+	// Move out of view, within the same cell and to another cell
+	grid.update(2, createBox(0.f, 0.f, 30.f, 1.f));
+	grid.update(0, createBox(0.f, 0.f, -10.f, 1.f));
+	grid.update(1, createBox(0.f, 0.f, 25.f, 1.f));
+	grid.cull(frustum, visible);
+	std::sort(visible.begin(), visible.end());
+	BOOST_REQUIRE_EQUAL(visible.size(), 2);
+	BOOST_CHECK_EQUAL(visible[0], 1);
+	BOOST_CHECK_EQUAL(visible[1], 2);
+
+	// The last handle takes the number of the removed one
+	grid.remove(1);
+	BOOST_CHECK_EQUAL(grid.getSize(), 2);
+	grid.cull(frustum, visible);
+	BOOST_REQUIRE_EQUAL(visible.size(), 1);
+	BOOST_CHECK_EQUAL(visible[0], 1);
+
+	grid.update(1, createBox(0.f, 0.f, -30.f, 1.f));
+	grid.cull(frustum, visible);
+	BOOST_CHECK(visible.empty());
+
+	grid.clear();
+	BOOST_CHECK_EQUAL(grid.getSize(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(TestGridShrinksAndDropsCells)
+{
+	CullingGrid grid(10.f);
+
+	grid.add();
+	grid.add();
+	grid.update(0, createBox(2.f, 2.f, 2.f, 1.f));
+	grid.update(1, createBox(6.f, 6.f, 6.f, 1.f));
+	BOOST_CHECK_EQUAL(grid.getNumCells(), 1);
+	BOOST_CHECK_EQUAL(grid.getCellBounds(0).min.x, 1.f);
+	BOOST_CHECK_EQUAL(grid.getCellBounds(0).max.x, 7.f);
+
+	// Growing and shrinking a box within its cell
+	grid.update(0, createBox(2.f, 2.f, 2.f, 40.f));
+	BOOST_CHECK_EQUAL(grid.getCellBounds(1).min.x, -38.f);
+	grid.update(0, createBox(2.f, 2.f, 2.f, 0.5f));
+	BOOST_CHECK_EQUAL(grid.getCellBounds(1).min.x, 1.5f);
+	BOOST_CHECK_EQUAL(grid.getCellBounds(1).max.x, 7.f);
+
+	// Moving the box that defined the bounds to another cell
+	grid.update(1, createBox(16.f, 6.f, 6.f, 1.f));
+	BOOST_CHECK_EQUAL(grid.getNumCells(), 2);
+	BOOST_CHECK_EQUAL(grid.getCellBounds(0).max.x, 2.5f);
+	BOOST_CHECK_EQUAL(grid.getCellBounds(1).min.x, 15.f);
+
+	// Cells left empty are dropped, both when moving and removing boxes
+	grid.update(0, createBox(14.f, 4.f, 4.f, 1.f));
+	BOOST_CHECK_EQUAL(grid.getNumCells(), 1);
+	BOOST_CHECK_EQUAL(grid.getCellBounds(0).min.x, 13.f);
+	BOOST_CHECK_EQUAL(grid.getCellBounds(1).max.x, 17.f);
+	grid.update(1, createBox(-100.f, 6.f, 6.f, 1.f));
+	BOOST_CHECK_EQUAL(grid.getNumCells(), 2);
+	grid.remove(0);
+	BOOST_CHECK_EQUAL(grid.getNumCells(), 1);
+	BOOST_CHECK_EQUAL(grid.getCellBounds(0).min.x, -101.f);
+	grid.remove(0);
+	BOOST_CHECK_EQUAL(grid.getNumCells(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(TestGridMovingBoxes)
+{
+	const Frustum frustum = createCameraFrustum();
+	CullingGrid grid(10.f);
+
+	std::srand(1337);
+	std::vector<BoundingBox> boxes;
+	for (unsigned int i = 0; i < 500; ++i)
+	{
+		boxes.push_back(createBox((std::rand() % 200) - 100.f, (std::rand() % 200) - 100.f,
+			(std::rand() % 200) - 100.f, 1.f));
+		grid.add();
+		grid.update(i, boxes.back());
+	}
+
+	std::vector<unsigned int> expected;
+	std::vector<unsigned int> visible;
+	for (unsigned int frame = 0; frame < 20; ++frame)
+	{
+		for (unsigned int i = 0; i < boxes.size(); ++i)
+		{
+			const float halfSize = (std::rand() % 50) / 10.f + 0.1f;
+			const float x = (boxes[i].min.x + boxes[i].max.x) * 0.5f + (std::rand() % 11) - 5.f;
+			const float y = (boxes[i].min.y + boxes[i].max.y) * 0.5f + (std::rand() % 11) - 5.f;
+			const float z = (boxes[i].min.z + boxes[i].max.z) * 0.5f + (std::rand() % 11) - 5.f;
+			boxes[i] = createBox(x, y, z, halfSize);
+			grid.update(i, boxes[i]);
+		}
+
+		const unsigned int removed = std::rand() % boxes.size();
+		boxes[removed] = boxes.back();
+		boxes.pop_back();
+		grid.remove(removed);
+
+		expected.clear();
+		for (unsigned int i = 0; i < boxes.size(); ++i)
+		{
+			if (frustum.isVisible(boxes[i]))
+				expected.push_back(i);
+		}
+
+		grid.cull(frustum, visible);
+		std::sort(visible.begin(), visible.end());
+		BOOST_CHECK_EQUAL_COLLECTIONS(visible.begin(), visible.end(), expected.begin(), expected.end());
+	}
+	BOOST_CHECK_LE(grid.getNumCells(), boxes.size());
+}
+
+BOOST_AUTO_TEST_CASE(TestCullingBenchmark)
+{
+	typedef std::chrono::high_resolution_clock Clock;
+	static const unsigned int numBoxes = 20000;
+	static const unsigned int numCulls = 20;
+
+	XMFLOAT4X4 view;
+	XMFLOAT4X4 projection;
+	XMStoreFloat4x4(&view, XMMatrixTranspose(XMMatrixLookToLH(XMVectorSet(0.f, 0.f, 0.f, 1.f),
+		XMVectorSet(0.f, 0.f, 1.f, 0.f), XMVectorSet(0.f, 1.f, 0.f, 0.f))));
+	XMStoreFloat4x4(&projection, XMMatrixTranspose(XMMatrixPerspectiveFovLH(XM_PIDIV4, 16.f / 9.f, 10.f, 50000.f)));
+	const Frustum frustum(view, projection);
+	CullingGrid grid(2000.f);
+
+	std::srand(4711);
+	std::vector<BoundingBox> boxes;
+	for (unsigned int i = 0; i < numBoxes; ++i)
+	{
+		const float x = (float)(std::rand() % 100000) - 50000.f;
+		const float y = (float)(std::rand() % 4000) - 2000.f;
+		const float z = (float)(std::rand() % 100000) - 50000.f;
+		boxes.push_back(createBox(x, y, z, (std::rand() % 300) + 50.f));
+		grid.add();
+		grid.update(i, boxes.back());
+	}
+
+	std::vector<unsigned int> expected;
+	Clock::time_point bruteStart = Clock::now();
+	for (unsigned int c = 0; c < numCulls; ++c)
+	{
+		expected.clear();
+		for (unsigned int i = 0; i < boxes.size(); ++i)
+		{
+			if (frustum.isVisible(boxes[i]))
+				expected.push_back(i);
+		}
+	}
+	Clock::time_point bruteEnd = Clock::now();
+
+	std::vector<unsigned int> visible;
+	Clock::time_point gridStart = Clock::now();
+	for (unsigned int c = 0; c < numCulls; ++c)
+	{
+		grid.cull(frustum, visible);
+	}
+	Clock::time_point gridEnd = Clock::now();
+
+	std::sort(visible.begin(), visible.end());
+	BOOST_CHECK_EQUAL_COLLECTIONS(visible.begin(), visible.end(), expected.begin(), expected.end());
+
+	const long long bruteMicro = std::chrono::duration_cast<std::chrono::microseconds>(bruteEnd - bruteStart).count();
+	const long long gridMicro = std::chrono::duration_cast<std::chrono::microseconds>(gridEnd - gridStart).count();
+	BOOST_TEST_MESSAGE("Culling " << numBoxes << " boxes " << numCulls << " times: brute force " << bruteMicro
+		<< " us, grid " << gridMicro << " us in " << grid.getNumCells() << " cells, " << expected.size() << " visible");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,193 @@
+#include <boost/test/unit_test.hpp>
+#include "../../Graphics/Source/ModelScene.h"
+#include "../../Graphics/Source/ShadowMapView.h"
+
+BOOST_AUTO_TEST_SUITE(TestModelScene)
+
+using namespace DirectX;
+
+static ModelDefinition* const fakeModel = reinterpret_cast<ModelDefinition*>(0x10);
+static ModelDefinition* const otherModel = reinterpret_cast<ModelDefinition*>(0x20);
+static const BoundingBox unitBox(XMFLOAT3(-1.f, -1.f, -1.f), XMFLOAT3(1.f, 1.f, 1.f));
+
+BOOST_AUTO_TEST_CASE(TestAddInstance)
+{
+	ModelScene scene;
+
+	BOOST_CHECK_EQUAL(scene.addInstance("Model", fakeModel, unitBox), 1);
+	BOOST_CHECK_EQUAL(scene.addInstance("Model", fakeModel, unitBox), 2);
+	BOOST_CHECK_EQUAL(scene.addInstance("Other", otherModel, unitBox), 3);
+	BOOST_CHECK_EQUAL(scene.getSize(), 3);
+
+	BOOST_CHECK_EQUAL(scene.getModel(3), otherModel);
+	BOOST_CHECK_EQUAL(scene.getInstance(3)->getModelName(), "Other");
+	BOOST_CHECK(scene.getInstance(4) == nullptr);
+	BOOST_CHECK(scene.getModel(4) == nullptr);
+	BOOST_CHECK(scene.getTransform(4) == nullptr);
+	BOOST_CHECK(!scene.setPosition(4, XMFLOAT3(0.f, 0.f, 0.f)));
+
+	scene.clear();
+	BOOST_CHECK_EQUAL(scene.getSize(), 0);
+	BOOST_CHECK_EQUAL(scene.addInstance("Model", fakeModel, unitBox), 4);
+}
+
+BOOST_AUTO_TEST_CASE(TestRemoveInstance)
+{
+	ModelScene scene;
+	for (int i = 0; i < 5; ++i)
+	{
+		const ModelScene::InstanceId id = scene.addInstance("Model", fakeModel, unitBox);
+		scene.setPosition(id, XMFLOAT3((float)id, 0.f, 0.f));
+	}
+	scene.updateTransforms();
+
+	BOOST_CHECK(scene.removeInstance(2));
+	BOOST_CHECK(!scene.removeInstance(2));
+	BOOST_CHECK(scene.removeInstance(5));
+	BOOST_REQUIRE_EQUAL(scene.getSize(), 3);
+
+	const std::vector<ModelScene::InstanceId>& ids = scene.getIds();
+	for (unsigned int i = 0; i < ids.size(); ++i)
+	{
+		BOOST_CHECK_NE(ids[i], 2);
+		BOOST_CHECK_NE(ids[i], 5);
+		BOOST_CHECK_EQUAL(scene.getInstance(ids[i]), &scene.getInstances()[i]);
+		BOOST_CHECK_EQUAL(scene.getTransform(ids[i]), &scene.getTransforms()[i]);
+		BOOST_CHECK_EQUAL(scene.getTransforms()[i].world._14, (float)ids[i]);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(TestUpdateTransforms)
+{
+	ModelScene scene;
+	const ModelScene::InstanceId first = scene.addInstance("Model", fakeModel, unitBox);
+	const ModelScene::InstanceId second = scene.addInstance("Model", fakeModel, unitBox);
+	const ModelScene::InstanceId third = scene.addInstance("Model", fakeModel, unitBox);
+
+	BOOST_CHECK_EQUAL(scene.updateTransforms(), 3);
+	BOOST_CHECK_EQUAL(scene.updateTransforms(), 0);
+
+	scene.setPosition(second, XMFLOAT3(1.f, 2.f, 3.f));
+	scene.setScale(second, XMFLOAT3(2.f, 2.f, 2.f));
+	scene.setRotation(third, XMFLOAT3(0.f, 1.f, 0.f));
+	BOOST_CHECK_EQUAL(scene.updateTransforms(), 2);
+
+	scene.setPosition(first, XMFLOAT3(1.f, 0.f, 0.f));
+	scene.removeInstance(first);
+	BOOST_CHECK_EQUAL(scene.updateTransforms(), 0);
+
+	scene.setScale(third, XMFLOAT3(1.f, 1.f, 4.f));
+	const ModelScene::Transform* transform = scene.getTransform(third);
+	BOOST_CHECK_EQUAL(scene.updateTransforms(), 0);
+
+	const XMFLOAT4X4& world = scene.getInstance(third)->getWorldMatrix();
+	for (int row = 0; row < 4; ++row)
+	{
+		for (int col = 0; col < 4; ++col)
+		{
+			BOOST_CHECK_EQUAL(transform->world.m[row][col], world.m[row][col]);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(TestInverseTransposeWorld)
+{
+	ModelScene scene;
+	const ModelScene::InstanceId id = scene.addInstance("Model", fakeModel, unitBox);
+	scene.setPosition(id, XMFLOAT3(5.f, -3.f, 2.f));
+	scene.setScale(id, XMFLOAT3(2.f, 4.f, 0.5f));
+
+	const ModelScene::Transform* transform = scene.getTransform(id);
+	BOOST_REQUIRE(transform != nullptr);
+
+	BOOST_CHECK_CLOSE(transform->invTransposeWorld._11, 0.5f, 0.001f);
+	BOOST_CHECK_CLOSE(transform->invTransposeWorld._22, 0.25f, 0.001f);
+	BOOST_CHECK_CLOSE(transform->invTransposeWorld._33, 2.f, 0.001f);
+	BOOST_CHECK_EQUAL(transform->invTransposeWorld._41, 0.f);
+	BOOST_CHECK_EQUAL(transform->invTransposeWorld._42, 0.f);
+	BOOST_CHECK_EQUAL(transform->invTransposeWorld._43, 0.f);
+	BOOST_CHECK_EQUAL(transform->invTransposeWorld._44, 1.f);
+}
+
+BOOST_AUTO_TEST_CASE(TestBounds)
+{
+	ModelScene scene;
+	const ModelScene::InstanceId id = scene.addInstance("Model", fakeModel, unitBox);
+	scene.setPosition(id, XMFLOAT3(10.f, 0.f, 0.f));
+	scene.setScale(id, XMFLOAT3(2.f, 1.f, 1.f));
+
+	const BoundingBox* bounds = scene.getBounds(id);
+	BOOST_REQUIRE(bounds != nullptr);
+	BOOST_CHECK_CLOSE(bounds->min.x, 8.f, 0.001f);
+	BOOST_CHECK_CLOSE(bounds->max.x, 12.f, 0.001f);
+	BOOST_CHECK_CLOSE(bounds->max.y, 1.f, 0.001f);
+
+	scene.setRotation(id, XMFLOAT3(0.f, XM_PIDIV2, 0.f));
+	bounds = scene.getBounds(id);
+	BOOST_CHECK_CLOSE(bounds->max.x - bounds->min.x, 2.f, 0.001f);
+	BOOST_CHECK_CLOSE(bounds->max.z - bounds->min.z, 4.f, 0.001f);
+}
+
+BOOST_AUTO_TEST_CASE(TestCullViews)
+{
+	ModelScene scene;
+	const ModelScene::InstanceId front = scene.addInstance("Model", fakeModel, unitBox);
+	const ModelScene::InstanceId behind = scene.addInstance("Model", fakeModel, unitBox);
+	const ModelScene::InstanceId farAway = scene.addInstance("Model", fakeModel, unitBox);
+	scene.setPosition(front, XMFLOAT3(0.f, 0.f, 500.f));
+	scene.setPosition(behind, XMFLOAT3(0.f, 0.f, -500.f));
+	scene.setPosition(farAway, XMFLOAT3(50000.f, 0.f, 0.f));
+	scene.updateTransforms();
+
+	// A camera at the origin looking along +z, and a light shining down at an angle
+	XMFLOAT4X4 view;
+	XMFLOAT4X4 projection;
+	XMStoreFloat4x4(&view, XMMatrixTranspose(XMMatrixLookToLH(XMVectorSet(0.f, 0.f, 0.f, 1.f),
+		XMVectorSet(0.f, 0.f, 1.f, 0.f), XMVectorSet(0.f, 1.f, 0.f, 0.f))));
+	XMStoreFloat4x4(&projection, XMMatrixTranspose(XMMatrixPerspectiveFovLH(XM_PIDIV2, 1.f, 8.f, 100000.f)));
+
+	const XMFLOAT3 cameraPosition(0.f, 0.f, 0.f);
+	const XMFLOAT3 lightDirection(0.3f, -1.f, 0.2f);
+	const Frustum frustums[] =
+	{
+		Frustum(view, projection),
+		ShadowMapView::createFrustum(cameraPosition, lightDirection, 3000.f),
+	};
+
+	std::vector<unsigned int> visibleViews;
+	scene.cullViews(frustums, 2, visibleViews);
+	BOOST_REQUIRE_EQUAL(visibleViews.size(), 3);
+	BOOST_CHECK_EQUAL(visibleViews[0], 3u);
+	BOOST_CHECK_EQUAL(visibleViews[1], 2u);
+	BOOST_CHECK_EQUAL(visibleViews[2], 0u);
+
+	// Before the frame's light has been set the shadow view must not cull anything
+	const Frustum noLight[] =
+	{
+		Frustum(view, projection),
+		ShadowMapView::createFrustum(cameraPosition, XMFLOAT3(0.f, 0.f, 0.f), 3000.f),
+	};
+	scene.cullViews(noLight, 2, visibleViews);
+	BOOST_CHECK_EQUAL(visibleViews[0], 3u);
+	BOOST_CHECK_EQUAL(visibleViews[1], 2u);
+	BOOST_CHECK_EQUAL(visibleViews[2], 2u);
+}
+
+BOOST_AUTO_TEST_CASE(TestDetachModel)
+{
+	ModelScene scene;
+	const ModelScene::InstanceId first = scene.addInstance("Model", fakeModel, unitBox);
+	const ModelScene::InstanceId second = scene.addInstance("Other", otherModel, unitBox);
+
+	scene.detachModel(fakeModel);
+	BOOST_CHECK(scene.getModel(first) == nullptr);
+	BOOST_CHECK_EQUAL(scene.getModel(second), otherModel);
+
+	scene.attachModel("Other", fakeModel, unitBox);
+	BOOST_CHECK(scene.getModel(first) == nullptr);
+
+	scene.attachModel("Model", otherModel, unitBox);
+	BOOST_CHECK_EQUAL(scene.getModel(first), otherModel);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
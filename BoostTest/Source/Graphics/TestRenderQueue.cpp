@@ -0,0 +1,207 @@
+#include <boost/test/unit_test.hpp>
+#include "../../Graphics/Source/RenderQueue.h"
+#include "../../Graphics/Source/GraphicsExceptions.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+BOOST_AUTO_TEST_SUITE(TestRenderQueue)
+
+BOOST_AUTO_TEST_CASE(TestSortMatchesStableSort)
+{
+	RenderQueue queue;
+
+	std::srand(1234);
+	std::vector<std::pair<uint64_t, unsigned int>> expected;
+	for (unsigned int i = 0; i < 5000; ++i)
+	{
+		// Few distinct high bits, to get both skipped and full radix passes and many equal keys
+		const uint64_t key = ((uint64_t)(std::rand() % 4) << 60) | ((uint64_t)(std::rand() % 50) << 24) | (std::rand() % 3);
+		BOOST_CHECK_EQUAL(queue.add(key), i);
+		expected.push_back(std::make_pair(key, i));
+	}
+	std::stable_sort(expected.begin(), expected.end(),
+		[] (const std::pair<uint64_t, unsigned int>& p_A, const std::pair<uint64_t, unsigned int>& p_B)
+		{
+			return p_A.first < p_B.first;
+		});
+
+	queue.sort();
+	BOOST_REQUIRE_EQUAL(queue.getSize(), expected.size());
+	for (unsigned int i = 0; i < expected.size(); ++i)
+	{
+		BOOST_CHECK_EQUAL(queue.getKeys()[i], expected[i].first);
+		BOOST_CHECK_EQUAL(queue.getOrder()[i], expected[i].second);
+	}
+
+	queue.clear();
+	BOOST_CHECK_EQUAL(queue.getSize(), 0);
+	queue.sort();
+	BOOST_CHECK(queue.getOrder().empty());
+}
+
+BOOST_AUTO_TEST_CASE(TestKeyOrder)
+{
+	RenderQueue queue;
+	int shaderA, shaderB;
+	int modelA, modelB;
+
+	const uint64_t near = queue.createKey(1, &shaderA, 0, &modelA, 0.1f);
+	const uint64_t far = queue.createKey(1, &shaderA, 0, &modelA, 0.9f);
+	BOOST_CHECK_LT(near, far);
+	BOOST_CHECK_EQUAL(near & RenderQueue::stateMask, far & RenderQueue::stateMask);
+	BOOST_CHECK_EQUAL(queue.createKey(1, &shaderA, 0, &modelA, -5.f), queue.createKey(1, &shaderA, 0, &modelA, 0.f));
+	BOOST_CHECK_EQUAL(queue.createKey(1, &shaderA, 0, &modelA, 5.f), queue.createKey(1, &shaderA, 0, &modelA, 1.f));
+
+	// Pass, then shader, material set and model, then depth
+	BOOST_CHECK_LT(queue.createKey(0, &shaderB, 3, &modelB, 1.f), queue.createKey(1, &shaderA, 0, &modelA, 0.f));
+	BOOST_CHECK_LT(queue.createKey(1, &shaderA, 3, &modelB, 1.f), queue.createKey(1, &shaderB, 0, &modelA, 0.f));
+	BOOST_CHECK_LT(queue.createKey(1, &shaderA, 0, &modelB, 1.f), queue.createKey(1, &shaderA, 1, &modelA, 0.f));
+	BOOST_CHECK_LT(queue.createKey(1, &shaderA, 0, &modelA, 1.f), queue.createKey(1, &shaderA, 0, &modelB, 0.f));
+
+	BOOST_CHECK_EQUAL(RenderQueue::getPass(queue.createKey(0, &shaderB, 3, &modelB, 0.5f)), 0);
+	BOOST_CHECK_EQUAL(RenderQueue::getPass(queue.createKey(3, &shaderA, 0, &modelA, 0.5f)), 3);
+}
+
+BOOST_AUTO_TEST_CASE(TestRuns)
+{
+	RenderQueue queue;
+	int shader;
+	int modelA, modelB;
+
+	queue.add(queue.createKey(1, &shader, 0, &modelA, 0.5f));
+	queue.add(queue.createKey(1, &shader, 0, &modelB, 0.2f));
+	queue.add(queue.createKey(1, &shader, 0, &modelA, 0.1f));
+	queue.add(queue.createKey(1, &shader, 1, &modelA, 0.3f));
+	queue.add(queue.createKey(1, &shader, 0, &modelA, 0.3f));
+	queue.sort();
+
+	const std::vector<unsigned int>& order = queue.getOrder();
+	BOOST_REQUIRE_EQUAL(order.size(), 5);
+
+	// Model A with material set 0, nearest first
+	BOOST_CHECK_EQUAL(queue.getRunEnd(0), 3);
+	BOOST_CHECK_EQUAL(order[0], 2);
+	BOOST_CHECK_EQUAL(order[1], 4);
+	BOOST_CHECK_EQUAL(order[2], 0);
+
+	// Model B, then model A with material set 1
+	BOOST_CHECK_EQUAL(queue.getRunEnd(3), 4);
+	BOOST_CHECK_EQUAL(order[3], 1);
+	BOOST_CHECK_EQUAL(queue.getRunEnd(4), 5);
+	BOOST_CHECK_EQUAL(order[4], 3);
+}
+
+BOOST_AUTO_TEST_CASE(TestKeyOverflow)
+{
+	RenderQueue queue;
+	int shader;
+	int model;
+
+	BOOST_CHECK_NO_THROW(queue.createKey(3, &shader, 63, &model, 0.f));
+	BOOST_CHECK_THROW(queue.createKey(4, &shader, 0, &model, 0.f), GraphicsException);
+	BOOST_CHECK_THROW(queue.createKey(0, &shader, 64, &model, 0.f), GraphicsException);
+	BOOST_CHECK_THROW(queue.createKey(0, &shader, (unsigned int)-1, &model, 0.f), GraphicsException);
+
+	// Every shader identifier is used, a new shader must not share one
+	queue.resetIds();
+	std::vector<char> shaders(1 << RenderQueue::shaderBits);
+	for (auto& otherShader : shaders)
+	{
+		queue.createKey(0, &otherShader, 0, &model, 0.f);
+	}
+	BOOST_CHECK_NO_THROW(queue.createKey(0, &shaders.back(), 0, &model, 0.f));
+	BOOST_CHECK_THROW(queue.createKey(0, &model, 0, &model, 0.f), GraphicsException);
+
+	queue.resetIds();
+	BOOST_CHECK_NO_THROW(queue.createKey(0, &model, 0, &model, 0.f));
+}
+
+BOOST_AUTO_TEST_CASE(TestResetIds)
+{
+	RenderQueue queue;
+	int shader;
+	int modelA, modelB;
+
+	const uint64_t keyA = queue.createKey(1, &shader, 0, &modelA, 0.5f);
+	const uint64_t keyB = queue.createKey(1, &shader, 0, &modelB, 0.5f);
+	BOOST_CHECK_NE(keyA, keyB);
+
+	// After a reset the identifiers are given out from the start again
+	queue.resetIds();
+	BOOST_CHECK_EQUAL(queue.createKey(1, &shader, 0, &modelB, 0.5f), keyA);
+}
+
+BOOST_AUTO_TEST_CASE(TestSortBenchmark)
+{
+	typedef std::chrono::high_resolution_clock Clock;
+	static const unsigned int numRenderables = 10000;
+	static const unsigned int numFrames = 20;
+
+	// A level sized scene: a few shaders, a few hundred models with some material sets
+	std::vector<char> shaders(4);
+	std::vector<char> models(300);
+	std::vector<std::pair<unsigned int, unsigned int>> renderables;
+	std::vector<float> depths;
+	std::srand(4711);
+	for (unsigned int i = 0; i < numRenderables; ++i)
+	{
+		renderables.push_back(std::make_pair(std::rand() % models.size(), std::rand() % 3));
+		depths.push_back((std::rand() % 10000) / 10000.f);
+	}
+
+	RenderQueue queue;
+	std::vector<std::pair<uint64_t, unsigned int>> expected;
+	long long radixMicro = 0;
+	long long stableSortMicro = 0;
+	for (unsigned int frame = 0; frame < numFrames; ++frame)
+	{
+		Clock::time_point radixStart = Clock::now();
+		queue.clear();
+		for (unsigned int i = 0; i < numRenderables; ++i)
+		{
+			const unsigned int model = renderables[i].first;
+			queue.add(queue.createKey(model % 2, &shaders[model % shaders.size()], renderables[i].second,
+				&models[model], depths[i]));
+		}
+		queue.sort();
+		Clock::time_point radixEnd = Clock::now();
+
+		// The same keys sorted the way the renderer sorted them before the queue
+		Clock::time_point stableSortStart = Clock::now();
+		expected.clear();
+		for (unsigned int i = 0; i < numRenderables; ++i)
+		{
+			const unsigned int model = renderables[i].first;
+			expected.push_back(std::make_pair(queue.createKey(model % 2, &shaders[model % shaders.size()],
+				renderables[i].second, &models[model], depths[i]), i));
+		}
+		std::stable_sort(expected.begin(), expected.end(),
+			[] (const std::pair<uint64_t, unsigned int>& p_A, const std::pair<uint64_t, unsigned int>& p_B)
+			{
+				return p_A.first < p_B.first;
+			});
+		Clock::time_point stableSortEnd = Clock::now();
+
+		radixMicro += std::chrono::duration_cast<std::chrono::microseconds>(radixEnd - radixStart).count();
+		stableSortMicro += std::chrono::duration_cast<std::chrono::microseconds>(stableSortEnd - stableSortStart).count();
+	}
+
+	BOOST_REQUIRE_EQUAL(queue.getSize(), expected.size());
+	for (unsigned int i = 0; i < expected.size(); ++i)
+	{
+		BOOST_REQUIRE_EQUAL(queue.getOrder()[i], expected[i].second);
+	}
+
+	unsigned int numRuns = 0;
+	for (unsigned int run = 0; run < queue.getSize(); run = queue.getRunEnd(run))
+	{
+		++numRuns;
+	}
+
+	BOOST_TEST_MESSAGE("Sorting " << numRenderables << " renderables " << numFrames << " times: radix "
+		<< radixMicro << " us, std::stable_sort " << stableSortMicro << " us, " << numRuns << " runs");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,213 @@
+#include <boost/test/unit_test.hpp>
+#include "../../../BinaryConverter/Source/BatchConverter.h"
+
+#include <fstream>
+#include <sstream>
+
+BOOST_AUTO_TEST_SUITE(TestBatchConverter)
+
+static const boost::filesystem::path batchDirectory("..\\Source\\Loader\\batch");
+
+static void writeText(const boost::filesystem::path& p_File, const std::string& p_Text)
+{
+	std::ofstream output(p_File.string(), std::ostream::out | std::ostream::binary);
+	output << p_Text;
+}
+
+static std::string readText(const boost::filesystem::path& p_File)
+{
+	std::ifstream input(p_File.string(), std::istream::in | std::istream::binary);
+	std::ostringstream text;
+	text << input.rdbuf();
+	return text.str();
+}
+
+static const std::string modelText =
+	"*Header\n #Tansparent 0 \n#Collidable 1 \n#Materials 1 \n#MESH batchModel \n#Vertices 3 \n#Triangles 1 \n"
+	"*Materials \nMaterial: lambert1 \nDiffuseMap: NONE \nNormalMap: NONE \nSpecularMap: NONE \n \n"
+	"*Vertices \nv -0.5 -0.5 0.5 \nv -0.5 0.5 0.5 \nv 0.5 0.5 -0.5 \n\n"
+	"*Normals \nn 0 0 1 \nn 0 0 1 \nn 0 0 1 \n\n"
+	"*UV COORDS \nuv 0 0 \nuv 0 1 \nuv 1 1 \n\n"
+	"*Tangets \nt 1 0 0 \nt 1 0 0 \nt 1 0 0 \n\n"
+	"*FACES \n-lambert1 \nface: 3 \n0 / 0 / 0 / 0 | 1 / 1 / 1 / 1 | 2 / 2 / 2 / 2 | \n\n";
+
+static const std::string volumeText =
+	"*Header\n"
+	"#Materials 0\n"
+	"#MESH CB_batchModel\n"
+	"#Vertices 3\n"
+	"#Triangles 1\n"
+	"\n"
+	"*Vertices\n"
+	"v 100 100 100\n"
+	"v 200 200 100\n"
+	"v 200 100 100\n"
+	"\n"
+	"*FACES\n"
+	"-BoundingVolume\n"
+	"face: 3\n"
+	"0 | 1 | 2 |";
+
+static void createBatch()
+{
+	boost::filesystem::remove_all(batchDirectory);
+	boost::filesystem::create_directories(batchDirectory / "animations");
+	writeText(batchDirectory / "batchModel.tx", modelText);
+	writeText(batchDirectory / "CB_batchModel.txc", volumeText);
+	writeText(batchDirectory / "broken.txc", "*Header\n");
+	writeText(batchDirectory / "notes.txt", "Not an asset");
+	boost::filesystem::copy_file("..\\Source\\TestCharacter.mlx", batchDirectory / "animations" / "TestCharacter.mlx");
+}
+
+static const BatchConverter::Result* findResult(const BatchConverter& p_Batch, const std::string& p_Filename)
+{
+	for (const BatchConverter::Result& result : p_Batch.getResults())
+	{
+		if (boost::filesystem::path(result.m_Input).filename() == p_Filename)
+		{
+			return &result;
+		}
+	}
+	return nullptr;
+}
+
+BOOST_AUTO_TEST_CASE(TestDirectory)
+{
+	createBatch();
+
+	BatchConverter batch;
+	batch.setNumThreads(2);
+	batch.setResourceListLocation(batchDirectory.string());
+	BOOST_REQUIRE(batch.addDirectory(batchDirectory));
+	BOOST_REQUIRE_EQUAL(batch.run().size(), 4);
+	BOOST_CHECK_EQUAL(batch.getCount(BatchConverter::Status::CONVERTED), 3);
+	BOOST_CHECK_EQUAL(batch.getCount(BatchConverter::Status::FAILED), 1);
+
+	const BatchConverter::Result* model = findResult(batch, "batchModel.tx");
+	BOOST_REQUIRE(model);
+	BOOST_CHECK(model->m_Status == BatchConverter::Status::CONVERTED);
+	BOOST_CHECK_EQUAL(model->m_InputSize, modelText.size());
+	BOOST_CHECK_GT(model->m_OutputSize, 0);
+	BOOST_CHECK(boost::filesystem::exists(batchDirectory / "batchModel.btx"));
+	BOOST_CHECK(boost::filesystem::exists(batchDirectory / "CB_batchModel.bbv"));
+	BOOST_CHECK(boost::filesystem::exists(batchDirectory / "animations" / "TestCharacter.bmlx"));
+	BOOST_CHECK(!findResult(batch, "notes.txt"));
+
+	const BatchConverter::Result* broken = findResult(batch, "broken.txc");
+	BOOST_REQUIRE(broken);
+	BOOST_CHECK(broken->m_Status == BatchConverter::Status::FAILED);
+	BOOST_CHECK(!broken->m_Error.empty());
+
+	// The resource list is written once for the whole batch
+	const std::string resources = readText(batchDirectory.string() + "\\Resources.xml");
+	BOOST_CHECK(resources.find("assets/models/batchModel.btx") != std::string::npos);
+	BOOST_CHECK(resources.find("assets/volumes/CB_batchModel.txc") != std::string::npos);
+
+	std::ostringstream report;
+	batch.writeReport(report);
+	BOOST_CHECK(report.str().find("\"converted\": 3") != std::string::npos);
+	BOOST_CHECK(report.str().find("\"failed\": 1") != std::string::npos);
+	BOOST_CHECK(report.str().find("\"status\": \"failed\"") != std::string::npos);
+
+	// Unchanged files are skipped, even if the resource list was removed in between
+	boost::filesystem::remove(batchDirectory.string() + "\\Resources.xml");
+	BatchConverter second;
+	second.setResourceListLocation(batchDirectory.string());
+	BOOST_REQUIRE(second.addDirectory(batchDirectory));
+	second.run();
+	BOOST_CHECK_EQUAL(second.getCount(BatchConverter::Status::UP_TO_DATE), 3);
+	BOOST_CHECK_EQUAL(second.getCount(BatchConverter::Status::FAILED), 1);
+	BOOST_CHECK_EQUAL(findResult(second, "batchModel.tx")->m_Hash, model->m_Hash);
+	BOOST_CHECK(readText(batchDirectory.string() + "\\Resources.xml").find("assets/models/batchModel.btx") != std::string::npos);
+
+	// Changed contents, changed model options and forcing convert again
+	writeText(batchDirectory / "CB_batchModel.txc", volumeText + "\n");
+	BatchConverter third;
+	BatchConverter::ModelOptions options;
+	options.m_Compact = true;
+	third.setModelOptions(options);
+	BOOST_REQUIRE(third.addDirectory(batchDirectory));
+	third.run();
+	BOOST_CHECK(findResult(third, "batchModel.tx")->m_Status == BatchConverter::Status::CONVERTED);
+	BOOST_CHECK(findResult(third, "CB_batchModel.txc")->m_Status == BatchConverter::Status::CONVERTED);
+	BOOST_CHECK(findResult(third, "TestCharacter.mlx")->m_Status == BatchConverter::Status::UP_TO_DATE);
+
+	BatchConverter forced;
+	forced.setModelOptions(options);
+	forced.setForce(true);
+	forced.setNumThreads(0);
+	BOOST_REQUIRE(forced.addDirectory(batchDirectory));
+	forced.run();
+	BOOST_CHECK_EQUAL(forced.getCount(BatchConverter::Status::CONVERTED), 3);
+}
+
+BOOST_AUTO_TEST_CASE(TestManifest)
+{
+	createBatch();
+	writeText(batchDirectory / "assets.txt",
+		"# Converted in this order\n"
+		"\n"
+		"CB_batchModel.txc\n"
+		"  missing.txc  \n"
+		"notes.txt\n");
+
+	BatchConverter batch;
+	BOOST_CHECK(!batch.addManifest(batchDirectory / "missing.txt"));
+	BOOST_REQUIRE(batch.addManifest(batchDirectory / "assets.txt"));
+	const std::vector<BatchConverter::Result>& results = batch.run();
+	BOOST_REQUIRE_EQUAL(results.size(), 3);
+	BOOST_CHECK(results[0].m_Status == BatchConverter::Status::CONVERTED);
+	BOOST_CHECK(results[1].m_Status == BatchConverter::Status::FAILED);
+	BOOST_CHECK_EQUAL(results[1].m_Error, "Error loading file");
+	BOOST_CHECK(results[2].m_Status == BatchConverter::Status::FAILED);
+	BOOST_CHECK_EQUAL(results[2].m_Error, "Unsupported file type");
+	BOOST_CHECK(boost::filesystem::exists(batchDirectory / "BinaryConverter.cache"));
+}
+
+BOOST_AUTO_TEST_CASE(TestCacheEntries)
+{
+	createBatch();
+
+	BatchConverter batch;
+	BOOST_REQUIRE(batch.addDirectory(batchDirectory));
+	batch.run();
+	BOOST_REQUIRE(findResult(batch, "batchModel.tx")->m_Status == BatchConverter::Status::CONVERTED);
+
+	// Mesh names with spaces survive the cache
+	const boost::filesystem::path cachePath = batchDirectory / "BinaryConverter.cache";
+	std::string cache = readText(cachePath);
+	const size_t meshName = cache.find("\tbatchModel\t");
+	BOOST_REQUIRE(meshName != std::string::npos);
+	writeText(cachePath, cache.replace(meshName, 12, "\tbatch model\t"));
+
+	BatchConverter second;
+	second.setResourceListLocation(batchDirectory.string());
+	BOOST_REQUIRE(second.addDirectory(batchDirectory));
+	second.run();
+	BOOST_CHECK(findResult(second, "batchModel.tx")->m_Status == BatchConverter::Status::UP_TO_DATE);
+	BOOST_CHECK(readText(batchDirectory.string() + "\\Resources.xml").find("assets/models/batch model.btx") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(TestHash)
+{
+	const std::vector<char> contents(modelText.begin(), modelText.end());
+	BatchConverter::ModelOptions options;
+	BatchConverter::ModelOptions compact;
+	compact.m_Compact = true;
+
+	BOOST_CHECK_EQUAL(BatchConverter::hashFile(contents, ".tx", options), BatchConverter::hashFile(contents, ".tx", options));
+	BOOST_CHECK_NE(BatchConverter::hashFile(contents, ".tx", options), BatchConverter::hashFile(contents, ".tx", compact));
+	BOOST_CHECK_NE(BatchConverter::hashFile(contents, ".tx", options), BatchConverter::hashFile(contents, ".txc", options));
+	// Model options do not affect other files
+	BOOST_CHECK_EQUAL(BatchConverter::hashFile(contents, ".txc", options), BatchConverter::hashFile(contents, ".txc", compact));
+
+	std::vector<char> changed(contents);
+	changed.back() = ' ';
+	BOOST_CHECK_NE(BatchConverter::hashFile(contents, ".tx", options), BatchConverter::hashFile(changed, ".tx", options));
+
+	BOOST_CHECK_EQUAL(BatchConverter::getOutputPath("models\\a.tx").extension().string(), ".btx");
+	BOOST_CHECK_EQUAL(BatchConverter::getOutputPath("levels/a.txl").extension().string(), ".btxl");
+	BOOST_CHECK(BatchConverter::getOutputPath("a.txt").empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,252 @@
+#include <boost/test/unit_test.hpp>
+#include "../../../Common/Source/LevelBinaryView.h"
+#include "../../../Common/Source/CommonExceptions.h"
+
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(TestLevelBinaryView)
+
+static const char binLevel[] =
+	"\x01\0\0\0"
+	"\0\0\0\0"
+	"\0\0\0\0"
+	"\x01\0\0\0"
+
+	"\x01\0\0\0"
+	"\x06\0\0\0House1"
+	"\0\0\0\0"
+	"\0\0\0\0"
+	"\x01\0\0\0"
+	"\x01\0\0\0"
+	"\0\0pA\0\0?D\0\0\0?"
+	"\x01\0\0\0"
+	"\0\0\0D\0\0\0D\0\0\0D"
+	"\x01\0\0\0"
+	"\0\0\0\0\0\0\0\0\0\0\0\0"
+
+	"\x01\0\0\0"
+	"\x04\0\0\0fire"
+	"\x01\0\0\0"
+	"\0\0pA\0\0\0D\0\0\0D"
+	"\x01\0\0\0"
+	"\0\0\0\0\0\0\0\0\0\0\0\0";
+
+// The string literal adds a terminating null that is not part of the level
+static const size_t binLevelSize = sizeof(binLevel) - 1;
+
+static const char binLevelTwoInstances[] =
+	"\x01\0\0\0"
+	"\0\0\0\0"
+	"\0\0\0\0"
+	"\x01\0\0\0"
+
+	"\x01\0\0\0"
+	"\x06\0\0\0House1"
+	"\0\0\0\0"
+	"\0\0\0\0"
+	"\x01\0\0\0"
+	"\x02\0\0\0"
+	"\0\0pA\0\0?D\0\0\0?"
+	"\0\0pA\0\0?D\0\0\0?"
+	"\x02\0\0\0"
+	"\0\0\0D\0\0\0D\0\0\0D"
+	"\0\0\0D\0\0\0D\0\0\0D"
+	"\x02\0\0\0"
+	"\0\0\0\0\0\0\0\0\0\0\0\0"
+	"\0\0\0\0\0\0\0\0\0\0\0\0"
+
+	"\0\0\0\0";
+static const size_t binLevelTwoInstancesSize = sizeof(binLevelTwoInstances) - 1;
+
+BOOST_AUTO_TEST_CASE(TestViewPointsIntoBuffer)
+{
+	LevelBinaryView view;
+	view.openBuffer(binLevel, binLevelSize);
+
+	BOOST_CHECK(view.getData() == binLevel);
+	BOOST_CHECK_EQUAL(view.getSize(), binLevelSize);
+	BOOST_REQUIRE_EQUAL(view.getModelData().size(), 1);
+
+	const LevelBinaryView::ModelData& model = view.getModelData()[0];
+	BOOST_CHECK_EQUAL(LevelBinaryView::toString(model.m_MeshName), "House1");
+	BOOST_CHECK_EQUAL(model.m_CollideAble, true);
+	BOOST_REQUIRE_EQUAL(model.m_Translation.size(), 1);
+	BOOST_CHECK(model.m_Translation.data() >= (const void*)binLevel);
+	BOOST_CHECK((const char*)model.m_Scale.data() + model.m_Scale.size() * sizeof(DirectX::XMFLOAT3) <= binLevel + binLevelSize);
+	BOOST_CHECK_EQUAL(model.m_Rotation[0].x, 512.f);
+
+	BOOST_REQUIRE_EQUAL(view.getEffectData().size(), 1);
+	BOOST_CHECK_EQUAL(LevelBinaryView::toString(view.getEffectData()[0].m_EffectName), "fire");
+	BOOST_CHECK_EQUAL(view.getEffectData()[0].m_Translation[0].x, 15.f);
+}
+
+BOOST_AUTO_TEST_CASE(TestViewReadsUnalignedArrays)
+{
+	// The six character mesh name leaves the instance arrays off the float alignment
+	LevelBinaryView view;
+	view.openBuffer(binLevel, binLevelSize);
+	BOOST_REQUIRE_EQUAL(view.getModelData().size(), 1);
+
+	const LevelBinaryView::ModelData& model = view.getModelData()[0];
+	BOOST_REQUIRE_NE((size_t)((const char*)model.m_Translation.data() - binLevel) % sizeof(float), 0);
+	BOOST_CHECK_EQUAL(model.m_Translation[0].x, 15.f);
+	BOOST_CHECK_EQUAL(model.m_Translation[0].y, 764.f);
+	BOOST_CHECK_EQUAL(model.m_Translation[0].z, 0.5f);
+
+	unsigned int numRotations = 0;
+	for (const DirectX::XMFLOAT3& rotation : model.m_Rotation)
+	{
+		BOOST_CHECK_EQUAL(rotation.y, 512.f);
+		++numRotations;
+	}
+	BOOST_CHECK_EQUAL(numRotations, model.m_Rotation.size());
+}
+
+BOOST_AUTO_TEST_CASE(TestViewOwnsCopy)
+{
+	std::vector<char> received(binLevel, binLevel + binLevelSize);
+	LevelBinaryView view;
+	view.openCopy(received.data(), received.size());
+	std::fill(received.begin(), received.end(), '\0');
+
+	BOOST_CHECK(view.getData() != received.data());
+	BOOST_REQUIRE_EQUAL(view.getModelData().size(), 1);
+	BOOST_CHECK_EQUAL(LevelBinaryView::toString(view.getModelData()[0].m_MeshName), "House1");
+	BOOST_CHECK_EQUAL(view.getModelData()[0].m_Translation[0].x, 15.f);
+}
+
+BOOST_AUTO_TEST_CASE(TestViewMatchesLoader)
+{
+	LevelBinaryView view;
+	view.openBuffer(binLevel, binLevelSize);
+
+	InstanceBinaryLoader loader;
+	std::istringstream stream(std::string(binLevel, binLevelSize));
+	loader.readStreamData(stream);
+
+	BOOST_REQUIRE_EQUAL(loader.getModelData().size(), view.getModelData().size());
+	const InstanceBinaryLoader::ModelData& loaded = loader.getModelData()[0];
+	const LevelBinaryView::ModelData& viewed = view.getModelData()[0];
+	BOOST_CHECK_EQUAL(loaded.m_MeshName, LevelBinaryView::toString(viewed.m_MeshName));
+	BOOST_CHECK_EQUAL(loaded.m_CollideAble, viewed.m_CollideAble);
+	BOOST_CHECK_EQUAL(loaded.m_Translation[0].x, viewed.m_Translation[0].x);
+	BOOST_CHECK_EQUAL(loaded.m_Translation[0].y, viewed.m_Translation[0].y);
+	BOOST_CHECK_EQUAL(loaded.m_Translation[0].z, viewed.m_Translation[0].z);
+	BOOST_CHECK_EQUAL(loaded.m_Scale[0].x, viewed.m_Scale[0].x);
+}
+
+BOOST_AUTO_TEST_CASE(TestViewRejectsBrokenData)
+{
+	LevelBinaryView view;
+	for (size_t size = 0; size < binLevelSize; ++size)
+	{
+		BOOST_CHECK_THROW(view.openBuffer(binLevel, size), CommonException);
+	}
+	BOOST_CHECK(view.getModelData().empty());
+	BOOST_CHECK(view.getData() == nullptr);
+
+	std::string negativeCount(binLevel, binLevelSize);
+	negativeCount[16] = '\xff';
+	negativeCount[19] = '\xff';
+	BOOST_CHECK_THROW(view.openBuffer(negativeCount.data(), negativeCount.size()), CommonException);
+
+	BOOST_CHECK_THROW(view.openFile("NonExistingLevel.btxl"), CommonException);
+}
+
+static std::string appendSpatialIndex(std::string p_Level, const LevelSpatialIndexFormat::Header& p_Header,
+	const std::vector<LevelSpatialIndexFormat::InstanceRef>& p_Refs)
+{
+	const uint32_t cellStart[] = { 0, (uint32_t)p_Refs.size() };
+	p_Level.append(reinterpret_cast<const char*>(&p_Header), sizeof(p_Header));
+	p_Level.append(reinterpret_cast<const char*>(cellStart), sizeof(cellStart));
+	p_Level.append(reinterpret_cast<const char*>(p_Refs.data()), p_Refs.size() * sizeof(LevelSpatialIndexFormat::InstanceRef));
+	return p_Level;
+}
+
+static std::string appendSpatialIndex(const LevelSpatialIndexFormat::Header& p_Header, uint32_t p_Model, uint32_t p_Instance)
+{
+	LevelSpatialIndexFormat::InstanceRef ref;
+	ref.m_Model = p_Model;
+	ref.m_Instance = p_Instance;
+	return appendSpatialIndex(std::string(binLevel, binLevelSize), p_Header, std::vector<LevelSpatialIndexFormat::InstanceRef>(1, ref));
+}
+
+BOOST_AUTO_TEST_CASE(TestViewSpatialIndex)
+{
+	LevelBinaryView view;
+	view.openBuffer(binLevel, binLevelSize);
+	BOOST_CHECK(!view.hasSpatialIndex());
+
+	LevelSpatialIndexFormat::Header header;
+	memcpy(header.m_Magic, LevelSpatialIndexFormat::magic, sizeof(header.m_Magic));
+	header.m_Version = LevelSpatialIndexFormat::version;
+	header.m_BoundsMin = DirectX::XMFLOAT3(15.f, 0.5f, 0.5f);
+	header.m_BoundsMax = DirectX::XMFLOAT3(15.f, 0.5f, 0.5f);
+	header.m_Cells[0] = header.m_Cells[1] = header.m_Cells[2] = 1;
+	header.m_NumInstances = 1;
+
+	const std::string indexed = appendSpatialIndex(header, 0, 0);
+	view.openBuffer(indexed.data(), indexed.size());
+	BOOST_REQUIRE(view.hasSpatialIndex());
+	BOOST_CHECK_EQUAL(view.getSpatialIndex().m_CellStart.size(), 2);
+	BOOST_REQUIRE_EQUAL(view.getSpatialIndex().m_Instances.size(), 1);
+	BOOST_CHECK_EQUAL(view.getSpatialIndex().m_Instances[0].m_Model, 0);
+	BOOST_CHECK_EQUAL(view.getSpatialIndex().m_Header.m_BoundsMin.x, 15.f);
+
+	for (size_t size = binLevelSize + sizeof(LevelSpatialIndexFormat::magic); size < indexed.size(); ++size)
+	{
+		BOOST_CHECK_THROW(view.openBuffer(indexed.data(), size), CommonException);
+	}
+
+	const std::string missingModel = appendSpatialIndex(header, 1, 0);
+	BOOST_CHECK_THROW(view.openBuffer(missingModel.data(), missingModel.size()), CommonException);
+	const std::string missingInstance = appendSpatialIndex(header, 0, 1);
+	BOOST_CHECK_THROW(view.openBuffer(missingInstance.data(), missingInstance.size()), CommonException);
+
+	LevelSpatialIndexFormat::Header emptyGrid = header;
+	emptyGrid.m_Cells[1] = 0;
+	const std::string brokenGrid = appendSpatialIndex(emptyGrid, 0, 0);
+	BOOST_CHECK_THROW(view.openBuffer(brokenGrid.data(), brokenGrid.size()), CommonException);
+
+	LevelSpatialIndexFormat::Header newerVersion = header;
+	newerVersion.m_Version = LevelSpatialIndexFormat::version + 1;
+	const std::string newer = appendSpatialIndex(newerVersion, 0, 0);
+	view.openBuffer(newer.data(), newer.size());
+	BOOST_CHECK(!view.hasSpatialIndex());
+	BOOST_CHECK_EQUAL(view.getModelData().size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(TestViewSpatialIndexCoversEachInstanceOnce)
+{
+	const std::string level(binLevelTwoInstances, binLevelTwoInstancesSize);
+	LevelBinaryView view;
+	view.openBuffer(level.data(), level.size());
+	BOOST_REQUIRE_EQUAL(view.getModelData().size(), 1);
+	BOOST_REQUIRE_EQUAL(view.getModelData()[0].m_Translation.size(), 2);
+
+	LevelSpatialIndexFormat::Header header;
+	memcpy(header.m_Magic, LevelSpatialIndexFormat::magic, sizeof(header.m_Magic));
+	header.m_Version = LevelSpatialIndexFormat::version;
+	header.m_BoundsMin = DirectX::XMFLOAT3(15.f, 0.5f, 0.5f);
+	header.m_BoundsMax = DirectX::XMFLOAT3(15.f, 0.5f, 0.5f);
+	header.m_Cells[0] = header.m_Cells[1] = header.m_Cells[2] = 1;
+	header.m_NumInstances = 2;
+
+	std::vector<LevelSpatialIndexFormat::InstanceRef> refs(2);
+	refs[0].m_Model = 0;
+	refs[0].m_Instance = 1;
+	refs[1].m_Model = 0;
+	refs[1].m_Instance = 0;
+	const std::string indexed = appendSpatialIndex(level, header, refs);
+	view.openBuffer(indexed.data(), indexed.size());
+	BOOST_CHECK(view.hasSpatialIndex());
+
+	// The right number of references, but one instance twice and the other never
+	refs[1].m_Instance = 1;
+	const std::string duplicated = appendSpatialIndex(level, header, refs);
+	BOOST_CHECK_THROW(view.openBuffer(duplicated.data(), duplicated.size()), CommonException);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
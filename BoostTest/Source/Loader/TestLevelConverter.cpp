@@ -1,5 +1,8 @@
 #include <boost/test/unit_test.hpp>
 #include "../../../BinaryConverter/Source/InstanceConverter.h"
+#include "../../../Common/Source/LevelBinaryView.h"
+
+#include <set>
 BOOST_AUTO_TEST_SUITE(TestLevelConverter)
 
 class testConv : public InstanceConverter
@@ -29,6 +32,11 @@ public:
 	{
 		createCheckPoints(p_Output);
 	}
+
+	void testCreateSpatialIndex(std::ostream* p_Output)
+	{
+		createSpatialIndex(p_Output);
+	}
 };
 
 BOOST_AUTO_TEST_CASE(TestWriteLevelFile)
@@ -462,4 +470,69 @@ BOOST_AUTO_TEST_CASE(TestBreakCreateLevel)
 	conv.clear();
 }
 
+BOOST_AUTO_TEST_CASE(TestCreateSpatialIndex)
+{
+	testConv conv;
+
+	static const char* const meshNames[] = { "Tree", "Rock", "House" };
+	std::vector<InstanceLoader::ModelStruct> level;
+	for (int i = 0; i < 150; ++i)
+	{
+		InstanceLoader::ModelStruct model;
+		model.m_MeshName = meshNames[i % 3];
+		model.m_Translation = DirectX::XMFLOAT3((i % 15) * 100.f, (float)(i % 4), (i / 15) * 70.f - 300.f);
+		model.m_Rotation = DirectX::XMFLOAT3(0.f, 0.f, 0.f);
+		model.m_Scale = DirectX::XMFLOAT3(1.f, 1.f, 1.f);
+		level.push_back(model);
+	}
+	std::vector<InstanceLoader::ModelHeader> modelInfo;
+
+	conv.setModelInformation(&modelInfo);
+	conv.setModelList(&level);
+	InstanceLoader::LevelHeader header;
+	header.m_NumberOfModels = 3;
+	header.m_NumberOfLights = 0;
+	header.m_NumberOfCheckPoints = 0;
+	header.m_NumberOfEffects = 0;
+	conv.setLevelHead(header);
+
+	std::ostringstream output;
+	conv.testCreateHeader(&output);
+	conv.testCreateLevel(&output);
+	conv.testCreateSpatialIndex(&output);
+	const std::string data = output.str();
+
+	LevelBinaryView view;
+	view.openBuffer(data.data(), data.size());
+	BOOST_REQUIRE(view.hasSpatialIndex());
+
+	const LevelBinaryView::SpatialIndex& index = view.getSpatialIndex();
+	const unsigned int numCells = LevelSpatialIndexFormat::getNumCells(index.m_Header);
+	BOOST_CHECK_EQUAL(index.m_Header.m_NumInstances, 150);
+	BOOST_CHECK(numCells > 1);
+	BOOST_CHECK_EQUAL(index.m_Header.m_BoundsMin.x, -1400.f);
+	BOOST_CHECK_EQUAL(index.m_Header.m_BoundsMax.z, 330.f);
+	BOOST_REQUIRE_EQUAL(index.m_CellStart.size(), numCells + 1);
+
+	std::set<std::pair<unsigned int, unsigned int>> seen;
+	for (unsigned int cell = 0; cell < numCells; ++cell)
+	{
+		DirectX::XMFLOAT3 cellMin;
+		DirectX::XMFLOAT3 cellMax;
+		LevelSpatialIndexFormat::getCellBounds(index.m_Header, cell, cellMin, cellMax);
+
+		for (unsigned int i = index.m_CellStart[cell]; i < index.m_CellStart[cell + 1]; ++i)
+		{
+			const LevelSpatialIndexFormat::InstanceRef& ref = index.m_Instances[i];
+			BOOST_CHECK(seen.insert(std::make_pair(ref.m_Model, ref.m_Instance)).second);
+
+			const DirectX::XMFLOAT3& position = view.getModelData()[ref.m_Model].m_Translation[ref.m_Instance];
+			BOOST_CHECK(position.x >= cellMin.x - 0.01f && position.x <= cellMax.x + 0.01f);
+			BOOST_CHECK(position.y >= cellMin.y - 0.01f && position.y <= cellMax.y + 0.01f);
+			BOOST_CHECK(position.z >= cellMin.z - 0.01f && position.z <= cellMax.z + 0.01f);
+		}
+	}
+	BOOST_CHECK_EQUAL(seen.size(), 150);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -3,6 +3,20 @@
 
 BOOST_AUTO_TEST_SUITE(TestLevelLoader)
 
+/**
+ * Keeps the text of a test stream alive for the tokenizer reading it.
+ */
+struct StreamText
+{
+	std::string m_Text;
+	TextTokenizer m_Tokenizer;
+
+	explicit StreamText(std::istream& p_Input)
+		:	m_Text((std::istreambuf_iterator<char>(p_Input)), std::istreambuf_iterator<char>()),
+			m_Tokenizer(m_Text.data(), m_Text.size())
+	{}
+};
+
 class testLevelLoader : public InstanceLoader
 {
 public:
@@ -13,23 +27,28 @@ public:
 
 	int testHeader(std::istream& p_Input)
 	{
-		return readHeader(p_Input);
+		StreamText text(p_Input);
+		return readHeader(text.m_Tokenizer);
 	}
 	void testMeshList(std::istream& p_Input)
 	{
-		readMeshList(p_Input);
+		StreamText text(p_Input);
+		readMeshList(text.m_Tokenizer);
 	}
 	void testLightLists(std::istream& p_Input)
 	{
-		readLightList(p_Input);
+		StreamText text(p_Input);
+		readLightList(text.m_Tokenizer);
 	}
 	void testCheckPointList(std::istream& p_Input)
 	{
-		readCheckPointList(p_Input);
+		StreamText text(p_Input);
+		readCheckPointList(text.m_Tokenizer);
 	}
 	void testMainLoop(std::istream& p_Input)
 	{
-		startReading(p_Input);
+		StreamText text(p_Input);
+		startReading(text.m_Tokenizer);
 	}
 };
 
@@ -4,6 +4,20 @@
 
 BOOST_AUTO_TEST_SUITE(TestModelTXLoader)
 
+/**
+ * Keeps the text of a test stream alive for the tokenizer reading it.
+ */
+struct StreamText
+{
+	std::string m_Text;
+	TextTokenizer m_Tokenizer;
+
+	explicit StreamText(std::istream& p_Input)
+		:	m_Text((std::istreambuf_iterator<char>(p_Input)), std::istreambuf_iterator<char>()),
+			m_Tokenizer(m_Text.data(), m_Text.size())
+	{}
+};
+
 class testLoader : public ModelLoader
 {
 public:
@@ -19,51 +33,63 @@ public:
 
 	void testHeader(std::istream& p_Input)
 	{
-		readHeader(p_Input);
+		StreamText text(p_Input);
+		readHeader(text.m_Tokenizer);
 	}
 	void testMaterial(std::istream& p_Input)
 	{
-		readMaterials(p_Input);
+		StreamText text(p_Input);
+		readMaterials(text.m_Tokenizer);
 	}
 	void testVertex(std::istream& p_Input)
 	{
-		readVertex(p_Input); 
+		StreamText text(p_Input);
+		readVertex(text.m_Tokenizer);
 	}
 	void testNormal(std::istream& p_Input)
 	{
-		readNormals(p_Input);
+		StreamText text(p_Input);
+		readNormals(text.m_Tokenizer);
 	}
 	void testUV(std::istream& p_Input)
 	{
-		readUV(p_Input);
+		StreamText text(p_Input);
+		readUV(text.m_Tokenizer);
 	}
 	void testTangent(std::istream& p_Input)
 	{
-		readTangents(p_Input);
+		StreamText text(p_Input);
+		readTangents(text.m_Tokenizer);
 	}
 	void testFaces(std::istream& p_Input)
 	{
-		readFaces(p_Input);
+		StreamText text(p_Input);
+		readFaces(text.m_Tokenizer);
 	}
 	void testWeights(std::istream& p_Input)
 	{
-		readWeights(p_Input);
+		StreamText text(p_Input);
+		readWeights(text.m_Tokenizer);
 	}
 	void testHierarchy(std::istream& p_Input)
 	{
-		readHierarchy(p_Input);
+		StreamText text(p_Input);
+		readHierarchy(text.m_Tokenizer);
 	}
 	void testJointOffset(std::istream& p_Input)
 	{
-		readJointOffset(p_Input);
+		StreamText text(p_Input);
+		readJointOffset(text.m_Tokenizer);
 	}
 	void testAnimation(std::istream& p_Input)
 	{
-		readAnimation(p_Input);
+		StreamText text(p_Input);
+		readAnimation(text.m_Tokenizer);
 	}
 	void testStart(std::istream& p_Input)
 	{
-		startReading(p_Input);
+		StreamText text(p_Input);
+		startReading(text.m_Tokenizer);
 	}
 };
 
@@ -282,6 +308,4 @@ BOOST_AUTO_TEST_CASE(TestMainLoop)
 	BOOST_CHECK_EQUAL(loader.getNumberOfFrames(), 1);
 }
 
-
-
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
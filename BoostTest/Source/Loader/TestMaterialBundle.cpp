@@ -0,0 +1,248 @@
+#include <boost/test/unit_test.hpp>
+#include "../../../BinaryConverter/Source/MaterialBundleConverter.h"
+#include "../../../BinaryConverter/Source/TextureTableConverter.h"
+#include <MaterialBundle.h>
+
+#include <boost/filesystem.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(TestMaterialBundle)
+
+static const uint32_t formatBC1 = 71;
+static const uint32_t formatBC3 = 77;
+static const uint32_t formatRGBA = 28;
+static const uint32_t formatBC7 = 98;
+
+static void writeUint(std::string& p_Data, size_t p_Offset, uint32_t p_Value)
+{
+	memcpy(&p_Data[p_Offset], &p_Value, sizeof(p_Value));
+}
+
+/**
+ * The header of a DDS file, without any pixel data.
+ */
+static std::string makeDDS(uint32_t p_Width, uint32_t p_Height, uint32_t p_MipLevels, const char* p_FourCC)
+{
+	std::string data(128, '\0');
+	memcpy(&data[0], "DDS ", 4);
+	writeUint(data, 4, 124);
+	writeUint(data, 8, 0x1 | 0x2 | 0x4 | 0x1000 | (p_MipLevels > 0 ? 0x20000 : 0));
+	writeUint(data, 12, p_Height);
+	writeUint(data, 16, p_Width);
+	writeUint(data, 28, p_MipLevels);
+	writeUint(data, 76, 32);
+	if (p_FourCC)
+	{
+		writeUint(data, 80, 0x4);
+		memcpy(&data[84], p_FourCC, 4);
+	}
+	else
+	{
+		// 32-bit RGBA
+		writeUint(data, 80, 0x40 | 0x1);
+		writeUint(data, 88, 32);
+		writeUint(data, 92, 0x000000ff);
+		writeUint(data, 96, 0x0000ff00);
+		writeUint(data, 100, 0x00ff0000);
+		writeUint(data, 104, 0xff000000);
+	}
+	return data;
+}
+
+static std::string makeDX10(uint32_t p_Width, uint32_t p_Height, uint32_t p_MipLevels, uint32_t p_Format, uint32_t p_ArraySize)
+{
+	std::string data = makeDDS(p_Width, p_Height, p_MipLevels, "DX10");
+	data.resize(data.size() + 20, '\0');
+	writeUint(data, 128, p_Format);
+	writeUint(data, 132, 3);
+	writeUint(data, 140, p_ArraySize);
+	return data;
+}
+
+static const std::string pngData("\x89PNG\r\n\x1a\n\0\0\0\rIHDR", 16);
+
+/**
+ * Temporary texture table and bundle files, removed when done.
+ */
+struct BundleFixture
+{
+	std::string m_TablePath;
+	std::string m_BundlePath;
+
+	BundleFixture()
+		:	m_TablePath("TestMaterialBundle.btt"),
+			m_BundlePath("TestMaterialBundle.bmb")
+	{
+	}
+
+	~BundleFixture()
+	{
+		boost::filesystem::remove(m_TablePath);
+		boost::filesystem::remove(m_BundlePath);
+	}
+
+	void writeTable(TextureTable& p_Table)
+	{
+		const std::string stone = makeDDS(256, 128, 9, "DXT1");
+		const std::string normal = makeDDS(64, 64, 7, "DXT5");
+		const std::string specular = makeDDS(16, 16, 0, nullptr);
+
+		TextureTableConverter converter;
+		BOOST_CHECK(converter.addTexture("Stone_COLOR.dds", stone.data(), stone.size()));
+		BOOST_CHECK(converter.addTexture("Default_NRM.dds", normal.data(), normal.size()));
+		BOOST_CHECK(converter.addTexture("Default_SPEC.dds", specular.data(), specular.size()));
+		BOOST_CHECK(converter.addTexture("Stone_COLOR.dds", normal.data(), normal.size()));
+		BOOST_CHECK(converter.writeFile(m_TablePath));
+		BOOST_REQUIRE(p_Table.loadFile(m_TablePath));
+	}
+};
+
+BOOST_AUTO_TEST_CASE(TestReadTextureInfo)
+{
+	TextureTable::Texture texture;
+	const std::string dxt1 = makeDDS(256, 128, 9, "DXT1");
+	BOOST_REQUIRE(TextureTableConverter::readTextureInfo("Stone.dds", dxt1.data(), dxt1.size(), texture));
+	BOOST_CHECK_EQUAL(texture.m_Name, "Stone.dds");
+	BOOST_CHECK_EQUAL(texture.m_Container, MaterialBundleFormat::DDS_CONTAINER);
+	BOOST_CHECK_EQUAL(texture.m_Format, formatBC1);
+	BOOST_CHECK_EQUAL(texture.m_Width, 256);
+	BOOST_CHECK_EQUAL(texture.m_Height, 128);
+	BOOST_CHECK_EQUAL(texture.m_MipLevels, 9);
+	BOOST_CHECK_EQUAL(texture.m_ArraySize, 1);
+
+	// Without a mip count the texture has a single level
+	const std::string rgba = makeDDS(16, 16, 0, nullptr);
+	BOOST_REQUIRE(TextureTableConverter::readTextureInfo("Flat.dds", rgba.data(), rgba.size(), texture));
+	BOOST_CHECK_EQUAL(texture.m_Format, formatRGBA);
+	BOOST_CHECK_EQUAL(texture.m_MipLevels, 1);
+
+	std::string cube = makeDDS(32, 32, 6, "DXT5");
+	writeUint(cube, 112, 0x200 | 0xfc00);
+	BOOST_REQUIRE(TextureTableConverter::readTextureInfo("Sky.dds", cube.data(), cube.size(), texture));
+	BOOST_CHECK_EQUAL(texture.m_Format, formatBC3);
+	BOOST_CHECK_EQUAL(texture.m_ArraySize, 6);
+
+	const std::string dx10 = makeDX10(512, 512, 10, formatBC7, 4);
+	BOOST_REQUIRE(TextureTableConverter::readTextureInfo("Array.dds", dx10.data(), dx10.size(), texture));
+	BOOST_CHECK_EQUAL(texture.m_Format, formatBC7);
+	BOOST_CHECK_EQUAL(texture.m_MipLevels, 10);
+	BOOST_CHECK_EQUAL(texture.m_ArraySize, 4);
+
+	BOOST_REQUIRE(TextureTableConverter::readTextureInfo("Icon.png", pngData.data(), pngData.size(), texture));
+	BOOST_CHECK_EQUAL(texture.m_Container, MaterialBundleFormat::WIC_CONTAINER);
+	BOOST_CHECK_EQUAL(texture.m_Format, 0);
+
+	const std::string unknown = makeDDS(16, 16, 0, "ABCD");
+	BOOST_CHECK(!TextureTableConverter::readTextureInfo("Unknown.dds", unknown.data(), unknown.size(), texture));
+	BOOST_CHECK(!TextureTableConverter::readTextureInfo("Short.dds", dxt1.data(), 64, texture));
+	BOOST_CHECK(!TextureTableConverter::readTextureInfo("Short.dds", dx10.data(), 130, texture));
+	BOOST_CHECK(!TextureTableConverter::readTextureInfo("Notes.txt", pngData.data(), pngData.size(), texture));
+}
+
+BOOST_FIXTURE_TEST_CASE(TestTextureTable, BundleFixture)
+{
+	TextureTable table;
+	writeTable(table);
+
+	// The duplicate is ignored, like in resource lists
+	BOOST_REQUIRE_EQUAL(table.getNumTextures(), 3);
+	BOOST_CHECK_EQUAL(table.find("Stone_COLOR.dds"), 0);
+	BOOST_CHECK_EQUAL(table.find("Default_NRM.dds"), 1);
+	BOOST_CHECK_EQUAL(table.find("Default_SPEC.dds"), 2);
+	BOOST_CHECK_EQUAL(table.find("Missing.dds"), MaterialBundleFormat::invalidTexture);
+
+	const TextureTable::Texture& stone = table.getTexture(0);
+	BOOST_CHECK_EQUAL(stone.m_Name, "Stone_COLOR.dds");
+	BOOST_CHECK_EQUAL(stone.m_Format, formatBC1);
+	BOOST_CHECK_EQUAL(stone.m_Width, 256);
+	BOOST_CHECK_EQUAL(stone.m_Height, 128);
+	BOOST_CHECK_EQUAL(stone.m_MipLevels, 9);
+	BOOST_CHECK_EQUAL(table.getTexture(1).m_Format, formatBC3);
+	BOOST_CHECK_EQUAL(table.getTexture(2).m_MipLevels, 1);
+
+	// Unsupported textures are reported and left out
+	TextureTableConverter converter;
+	const std::string unknown = makeDDS(16, 16, 0, "ABCD");
+	BOOST_CHECK(!converter.addTexture("Unknown.dds", unknown.data(), unknown.size()));
+	BOOST_CHECK(converter.getTextures().empty());
+	BOOST_REQUIRE_EQUAL(converter.getUnsupportedTextures().size(), 1);
+	BOOST_CHECK_EQUAL(converter.getUnsupportedTextures()[0], "Unknown.dds");
+
+	std::ifstream input(m_TablePath, std::istream::in | std::istream::binary);
+	const std::string contents((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+	TextureTable copy;
+	BOOST_REQUIRE(copy.load(contents.data(), contents.size()));
+	BOOST_CHECK_EQUAL(copy.getHash(), table.getHash());
+	BOOST_CHECK(!copy.load(contents.data(), contents.size() - 1));
+	BOOST_CHECK_EQUAL(copy.getNumTextures(), 0);
+	BOOST_CHECK(!copy.load("BTTX", 4));
+	BOOST_CHECK(!copy.loadFile("TestMaterialBundleMissing.btt"));
+}
+
+BOOST_FIXTURE_TEST_CASE(TestMaterialBundleRoundTrip, BundleFixture)
+{
+	TextureTable table;
+	writeTable(table);
+
+	MaterialBundleConverter converter(table);
+	converter.addMaterial("stone", "Stone_COLOR.dds", "NONE", "NONE");
+	converter.addMaterial("moss", "Moss_COLOR.dds", "Default_NRM.dds", "");
+	BOOST_REQUIRE_EQUAL(converter.getMissingTextures().size(), 1);
+	BOOST_CHECK_EQUAL(converter.getMissingTextures()[0], "Moss_COLOR.dds");
+	BOOST_REQUIRE(converter.writeFile(m_BundlePath));
+
+	MaterialBundle bundle;
+	BOOST_REQUIRE(bundle.loadFile(m_BundlePath));
+	BOOST_CHECK_EQUAL(bundle.getTableHash(), table.getHash());
+	const std::vector<MaterialBundle::Material>& materials = bundle.getMaterials();
+	BOOST_REQUIRE_EQUAL(materials.size(), 2);
+	BOOST_CHECK_EQUAL(materials[0].m_MaterialID, "stone");
+	BOOST_CHECK_EQUAL(materials[0].m_Diffuse, 0);
+	BOOST_CHECK_EQUAL(materials[0].m_Normal, 1);
+	BOOST_CHECK_EQUAL(materials[0].m_Specular, 2);
+	BOOST_CHECK_EQUAL(materials[1].m_MaterialID, "moss");
+	BOOST_CHECK_EQUAL(materials[1].m_Diffuse, MaterialBundleFormat::invalidTexture);
+	BOOST_CHECK_EQUAL(materials[1].m_Normal, 1);
+	BOOST_CHECK_EQUAL(materials[1].m_Specular, 2);
+
+	BOOST_CHECK(!bundle.load("BMTB", 4));
+	BOOST_CHECK(bundle.getMaterials().empty());
+	BOOST_CHECK(!bundle.loadFile(m_TablePath));
+
+	BOOST_CHECK_EQUAL(boost::filesystem::path(MaterialBundleConverter::getBundlePath("models/Stone.btx")),
+		boost::filesystem::path("models/Stone.bmb"));
+}
+
+BOOST_AUTO_TEST_CASE(TestTextureDirectory)
+{
+	const boost::filesystem::path directory("TestMaterialBundleTextures");
+	boost::filesystem::remove_all(directory);
+	boost::filesystem::create_directories(directory);
+	{
+		std::ofstream dds((directory / "b.dds").string(), std::ostream::out | std::ostream::binary);
+		dds << makeDDS(8, 8, 4, "DXT1");
+		std::ofstream png((directory / "a.png").string(), std::ostream::out | std::ostream::binary);
+		png << pngData;
+		std::ofstream text((directory / "notes.txt").string());
+		text << "not a texture";
+	}
+
+	TextureTableConverter converter;
+	BOOST_CHECK(converter.addDirectory(directory.string()));
+	boost::filesystem::remove_all(directory);
+	BOOST_CHECK(!converter.addDirectory(directory.string()));
+
+	// Sorted by name, so the IDs do not depend on the file system
+	const std::vector<TextureTable::Texture>& textures = converter.getTextures();
+	BOOST_REQUIRE_EQUAL(textures.size(), 2);
+	BOOST_CHECK_EQUAL(textures[0].m_Name, "a.png");
+	BOOST_CHECK_EQUAL(textures[0].m_Container, MaterialBundleFormat::WIC_CONTAINER);
+	BOOST_CHECK_EQUAL(textures[1].m_Name, "b.dds");
+	BOOST_CHECK_EQUAL(textures[1].m_MipLevels, 4);
+	BOOST_CHECK(converter.getUnsupportedTextures().empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
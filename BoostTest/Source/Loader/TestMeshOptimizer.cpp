@@ -0,0 +1,337 @@
+#include <boost/test/unit_test.hpp>
+#include "../../../BinaryConverter/Source/MeshOptimizer.h"
+#include "../../../BinaryConverter/Source/ModelConverter.h"
+#include "../../../Graphics/Source/ModelBinaryLoader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+BOOST_AUTO_TEST_SUITE(TestMeshOptimizer)
+
+static std::vector<unsigned int> createGrid(unsigned int p_Size)
+{
+	std::vector<unsigned int> indices;
+	for (unsigned int y = 0; y < p_Size; ++y)
+	{
+		for (unsigned int x = 0; x < p_Size; ++x)
+		{
+			const unsigned int corner = y * (p_Size + 1) + x;
+			const unsigned int quad[6] =
+			{
+				corner, corner + p_Size + 1, corner + 1,
+				corner + 1, corner + p_Size + 1, corner + p_Size + 2,
+			};
+			indices.insert(indices.end(), quad, quad + 6);
+		}
+	}
+	return indices;
+}
+
+static std::vector<unsigned int> shuffleTriangles(const std::vector<unsigned int>& p_Indices)
+{
+	std::vector<unsigned int> order(p_Indices.size() / 3);
+	for (unsigned int i = 0; i < order.size(); ++i)
+	{
+		order[i] = i;
+	}
+	std::shuffle(order.begin(), order.end(), std::mt19937(1234));
+
+	std::vector<unsigned int> shuffled;
+	for (unsigned int triangle : order)
+	{
+		shuffled.insert(shuffled.end(), p_Indices.begin() + triangle * 3, p_Indices.begin() + triangle * 3 + 3);
+	}
+	return shuffled;
+}
+
+template <typename Vertex>
+static std::vector<std::string> getSortedTriangles(const std::vector<Vertex>& p_Vertices, const std::vector<unsigned int>& p_Indices)
+{
+	std::vector<std::string> triangles;
+	for (unsigned int i = 0; i < p_Indices.size(); i += 3)
+	{
+		std::string triangle;
+		for (unsigned int j = 0; j < 3; ++j)
+		{
+			const char* vertex = reinterpret_cast<const char*>(&p_Vertices[p_Indices[i + j]]);
+			triangle.append(vertex, sizeof(Vertex));
+		}
+		triangles.push_back(triangle);
+	}
+	std::sort(triangles.begin(), triangles.end());
+	return triangles;
+}
+
+BOOST_AUTO_TEST_CASE(TestWeld)
+{
+	static const float corners[] = { 0.f, 1.f, 2.f, 2.f, 1.f, 3.f, -0.f };
+	std::vector<float> cornerList(corners, corners + 7);
+	std::vector<float> vertices;
+
+	std::vector<unsigned int> indices = MeshOptimizer::weld(cornerList, vertices);
+
+	static const unsigned int expectedIndices[] = { 0, 1, 2, 2, 1, 3, 4 };
+	BOOST_CHECK_EQUAL_COLLECTIONS(indices.begin(), indices.end(), expectedIndices, expectedIndices + 7);
+	BOOST_REQUIRE_EQUAL(vertices.size(), 5);
+	BOOST_CHECK_EQUAL(vertices[3], 3.f);
+}
+
+BOOST_AUTO_TEST_CASE(TestTriangleOrder)
+{
+	static const unsigned int gridSize = 64;
+	const std::vector<unsigned int> grid = createGrid(gridSize);
+	std::vector<unsigned int> indices = shuffleTriangles(grid);
+	const float shuffledACMR = MeshOptimizer::computeACMR(indices, MeshOptimizer::cacheSize);
+
+	MeshOptimizer::optimizeTriangleOrder(indices, (gridSize + 1) * (gridSize + 1));
+	const float optimizedACMR = MeshOptimizer::computeACMR(indices, MeshOptimizer::cacheSize);
+
+	BOOST_TEST_MESSAGE("ACMR of a shuffled " << gridSize << "x" << gridSize << " grid: " << shuffledACMR
+		<< ", optimized: " << optimizedACMR);
+	BOOST_CHECK_GT(shuffledACMR, 2.5f);
+	BOOST_CHECK_LT(optimizedACMR, 0.8f);
+
+	// The same triangles with the same winding must remain
+	std::vector<unsigned int> positions((gridSize + 1) * (gridSize + 1));
+	for (unsigned int i = 0; i < positions.size(); ++i)
+	{
+		positions[i] = i;
+	}
+	BOOST_CHECK(getSortedTriangles(positions, indices) == getSortedTriangles(positions, grid));
+
+	std::vector<unsigned int> partial(4, 0);
+	MeshOptimizer::optimizeTriangleOrder(partial, 1);
+	BOOST_CHECK_EQUAL(partial.size(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(TestVertexOrder)
+{
+	static const unsigned int triangles[] = { 3, 1, 4, 4, 1, 0 };
+	std::vector<unsigned int> indices(triangles, triangles + 6);
+	static const char vertexData[] = { 'a', 'b', 'c', 'd', 'e' };
+	std::vector<char> vertices(vertexData, vertexData + 5);
+
+	MeshOptimizer::optimizeVertexOrder(indices, vertices);
+
+	static const unsigned int expectedIndices[] = { 0, 1, 2, 2, 1, 3 };
+	static const char expectedVertices[] = { 'd', 'b', 'e', 'a' };
+	BOOST_CHECK_EQUAL_COLLECTIONS(indices.begin(), indices.end(), expectedIndices, expectedIndices + 6);
+	BOOST_CHECK_EQUAL_COLLECTIONS(vertices.begin(), vertices.end(), expectedVertices, expectedVertices + 4);
+}
+
+/**
+ * Height field with two materials, split between the left and right half.
+ */
+class GridModel
+{
+public:
+	std::vector<DirectX::XMFLOAT3> m_Positions;
+	std::vector<DirectX::XMFLOAT3> m_Normals;
+	std::vector<DirectX::XMFLOAT3> m_Tangents;
+	std::vector<DirectX::XMFLOAT2> m_UVs;
+	std::vector<ModelLoader::Material> m_Materials;
+	std::vector<std::vector<ModelLoader::IndexDesc>> m_Indices;
+
+	explicit GridModel(unsigned int p_Size)
+		:	m_Normals(1, DirectX::XMFLOAT3(0.f, 1.f, 0.f)),
+			m_Tangents(1, DirectX::XMFLOAT3(1.f, 0.f, 0.f)),
+			m_Materials(2),
+			m_Indices(2)
+	{
+		for (unsigned int y = 0; y <= p_Size; ++y)
+		{
+			for (unsigned int x = 0; x <= p_Size; ++x)
+			{
+				m_Positions.push_back(DirectX::XMFLOAT3((float)x, (float)((x * 7 + y * 3) % 5), (float)y));
+				m_UVs.push_back(DirectX::XMFLOAT2((float)x / p_Size, (float)y / p_Size));
+			}
+		}
+
+		m_Materials[0].m_MaterialID = "Left";
+		m_Materials[1].m_MaterialID = "Right";
+
+		const std::vector<unsigned int> grid = createGrid(p_Size);
+		for (unsigned int i = 0; i < grid.size(); ++i)
+		{
+			const unsigned int quadX = (i / 6) % p_Size;
+			ModelLoader::IndexDesc desc;
+			desc.m_MaterialID = quadX < p_Size / 2 ? "Left" : "Right";
+			desc.m_Vertex = grid[i];
+			desc.m_Normal = 0;
+			desc.m_Tangent = 0;
+			desc.m_TextureCoord = grid[i];
+			m_Indices[quadX < p_Size / 2 ? 0 : 1].push_back(desc);
+		}
+	}
+
+	bool write(ModelConverter& p_Converter, const std::string& p_Filename) const
+	{
+		p_Converter.setMeshName("grid");
+		p_Converter.setVertices(&m_Positions);
+		p_Converter.setNormals(&m_Normals);
+		p_Converter.setTangents(&m_Tangents);
+		p_Converter.setTextureCoords(&m_UVs);
+		p_Converter.setIndices(&m_Indices);
+		p_Converter.setMaterial(&m_Materials);
+		p_Converter.setTransparent(false);
+		p_Converter.setCollidable(true);
+		return p_Converter.writeFile(p_Filename);
+	}
+};
+
+BOOST_AUTO_TEST_CASE(TestIndexedRoundTrip)
+{
+	static const unsigned int gridSize = 32;
+	GridModel model(gridSize);
+
+	ModelConverter expandedConverter;
+	expandedConverter.setIndexedOutput(false);
+	BOOST_REQUIRE(model.write(expandedConverter, "..\\Source\\Loader\\models\\testExpanded.btx"));
+
+	ModelConverter indexedConverter;
+	BOOST_REQUIRE(model.write(indexedConverter, "..\\Source\\Loader\\models\\testIndexed.btx"));
+	const ModelConverter::MeshStatistics& statistics = indexedConverter.getStatistics();
+	BOOST_CHECK_EQUAL(statistics.m_Corners, gridSize * gridSize * 6);
+	// The vertices on the border between the materials are stored once per material
+	BOOST_CHECK_EQUAL(statistics.m_Vertices, (gridSize + 1) * (gridSize + 2));
+	BOOST_CHECK_EQUAL(statistics.m_IndexSize, 2);
+	BOOST_CHECK_LT(statistics.m_ACMRAfter, statistics.m_ACMRBefore);
+
+	ModelBinaryLoader expanded;
+	expanded.loadBinaryFile("..\\Source\\Loader\\models\\testExpanded.btx");
+	ModelBinaryLoader indexed;
+	indexed.loadBinaryFile("..\\Source\\Loader\\models\\testIndexed.btx");
+
+	BOOST_CHECK_EQUAL(expanded.getIndexSize(), 0);
+	BOOST_CHECK(expanded.getIndices().empty());
+	BOOST_CHECK_EQUAL(indexed.getIndexSize(), 2);
+	BOOST_CHECK_EQUAL(indexed.getStaticVertexBuffer().size(), statistics.m_Vertices);
+	BOOST_CHECK_EQUAL(indexed.getCollideAble(), true);
+	BOOST_CHECK_EQUAL(indexed.getAnimated(), false);
+
+	const std::vector<MaterialBuffer>& expandedRanges = expanded.getMaterialBuffer();
+	const std::vector<MaterialBuffer>& indexedRanges = indexed.getMaterialBuffer();
+	BOOST_REQUIRE_EQUAL(indexedRanges.size(), 2);
+	BOOST_REQUIRE_EQUAL(expandedRanges.size(), 2);
+
+	const std::vector<unsigned int> indices = indexed.getIndices();
+	for (unsigned int i = 0; i < indexedRanges.size(); ++i)
+	{
+		BOOST_CHECK_EQUAL(indexedRanges[i].material, expandedRanges[i].material);
+		BOOST_CHECK_EQUAL(indexedRanges[i].length, expandedRanges[i].length);
+
+		std::vector<unsigned int> expandedIndices;
+		for (int j = expandedRanges[i].start; j < expandedRanges[i].start + expandedRanges[i].length; ++j)
+		{
+			expandedIndices.push_back(j);
+		}
+		std::vector<unsigned int> rangeIndices(indices.begin() + indexedRanges[i].start,
+			indices.begin() + indexedRanges[i].start + indexedRanges[i].length);
+
+		BOOST_CHECK(getSortedTriangles(indexed.getStaticVertexBuffer(), rangeIndices)
+			== getSortedTriangles(expanded.getStaticVertexBuffer(), expandedIndices));
+	}
+
+	BOOST_CHECK_EQUAL(indexed.getBoundingVolume()[0].x, expanded.getBoundingVolume()[0].x);
+	BOOST_CHECK_EQUAL(indexed.getBoundingVolume()[7].y, expanded.getBoundingVolume()[7].y);
+}
+
+BOOST_AUTO_TEST_CASE(TestCompactRoundTrip)
+{
+	static const unsigned int gridSize = 32;
+	GridModel model(gridSize);
+
+	ModelConverter floatConverter;
+	BOOST_REQUIRE(model.write(floatConverter, "..\\Source\\Loader\\models\\testIndexed.btx"));
+	ModelConverter compactConverter;
+	compactConverter.setCompactVertices(true);
+	BOOST_REQUIRE(model.write(compactConverter, "..\\Source\\Loader\\models\\testCompact.btx"));
+
+	const ModelConverter::MeshStatistics& floatStatistics = floatConverter.getStatistics();
+	const ModelConverter::MeshStatistics& statistics = compactConverter.getStatistics();
+	BOOST_CHECK(!floatStatistics.m_Compact);
+	BOOST_REQUIRE(statistics.m_Compact);
+	BOOST_CHECK_EQUAL(statistics.m_Vertices, floatStatistics.m_Vertices);
+	BOOST_CHECK_LE(statistics.m_VertexSize * 2, floatStatistics.m_VertexSize);
+	BOOST_CHECK_LT(statistics.m_FileSize, floatStatistics.m_FileSize);
+	BOOST_CHECK_LE(statistics.m_QuantizationError.m_Position, gridSize / 65535.f * 2.f);
+	BOOST_CHECK_LT(statistics.m_QuantizationError.m_Normal, 0.01f);
+	BOOST_CHECK_LT(statistics.m_QuantizationError.m_Binormal, 0.01f);
+	BOOST_CHECK_LT(statistics.m_QuantizationError.m_UV, 0.001f);
+
+	ModelBinaryLoader floatLoader;
+	floatLoader.loadBinaryFile("..\\Source\\Loader\\models\\testIndexed.btx");
+	ModelBinaryLoader compactLoader;
+	compactLoader.loadBinaryFile("..\\Source\\Loader\\models\\testCompact.btx");
+
+	BOOST_CHECK(compactLoader.getIndexBuffer() == floatLoader.getIndexBuffer());
+	BOOST_CHECK(compactLoader.getVertexFormat() == VertexQuantizer::compactFormat);
+	BOOST_CHECK(compactLoader.getStaticVertexBuffer().empty());
+	BOOST_CHECK_EQUAL(compactLoader.getBoundingVolume()[0].x, floatLoader.getBoundingVolume()[0].x);
+	BOOST_CHECK_EQUAL(compactLoader.getBoundingVolume()[7].y, floatLoader.getBoundingVolume()[7].y);
+
+	// The loader keeps the quantized vertices for the GPU, decode them like the shaders do
+	const std::vector<StaticVertex>& floatVertices = floatLoader.getStaticVertexBuffer();
+	const std::vector<char>& compactData = compactLoader.getCompactVertexBuffer();
+	BOOST_REQUIRE_EQUAL(compactData.size(), floatVertices.size() * sizeof(VertexQuantizer::CompactVertex));
+	const VertexQuantizer::CompactVertex* compactVertices =
+		reinterpret_cast<const VertexQuantizer::CompactVertex*>(compactData.data());
+	const std::vector<DirectX::XMFLOAT3> positions = compactLoader.getPositions();
+	BOOST_REQUIRE_EQUAL(positions.size(), floatVertices.size());
+	for (unsigned int i = 0; i < floatVertices.size(); ++i)
+	{
+		StaticVertex vertex;
+		VertexQuantizer::decode(compactVertices[i], compactLoader.getCompactBounds(), vertex.m_Position, vertex.m_Normal,
+			vertex.m_UV, vertex.m_Tangent, vertex.m_Binormal);
+		BOOST_CHECK_SMALL(vertex.m_Position.x - floatVertices[i].m_Position.x, 0.001f);
+		BOOST_CHECK_SMALL(vertex.m_Position.y - floatVertices[i].m_Position.y, 0.001f);
+		BOOST_CHECK_SMALL(vertex.m_Position.z - floatVertices[i].m_Position.z, 0.001f);
+		BOOST_CHECK_SMALL(vertex.m_UV.x - floatVertices[i].m_UV.x, 0.001f);
+		BOOST_CHECK_SMALL(vertex.m_Normal.y - floatVertices[i].m_Normal.y, 0.0001f);
+		BOOST_CHECK_SMALL(vertex.m_Binormal.z - floatVertices[i].m_Binormal.z, 0.0001f);
+		BOOST_CHECK_EQUAL(positions[i].x, vertex.m_Position.x);
+		BOOST_CHECK_EQUAL(positions[i].z, vertex.m_Position.z);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(TestIndexedBenchmark)
+{
+	typedef std::chrono::high_resolution_clock Clock;
+	static const unsigned int numLoads = 20;
+
+	GridModel model(128);
+	ModelConverter expandedConverter;
+	expandedConverter.setIndexedOutput(false);
+	BOOST_REQUIRE(model.write(expandedConverter, "..\\Source\\Loader\\models\\testExpanded.btx"));
+	ModelConverter indexedConverter;
+	BOOST_REQUIRE(model.write(indexedConverter, "..\\Source\\Loader\\models\\testIndexed.btx"));
+	const ModelConverter::MeshStatistics& statistics = indexedConverter.getStatistics();
+
+	ModelBinaryLoader loader;
+	Clock::time_point expandedStart = Clock::now();
+	for (unsigned int i = 0; i < numLoads; ++i)
+	{
+		loader.loadBinaryFile("..\\Source\\Loader\\models\\testExpanded.btx");
+	}
+	Clock::time_point expandedEnd = Clock::now();
+
+	Clock::time_point indexedStart = Clock::now();
+	for (unsigned int i = 0; i < numLoads; ++i)
+	{
+		loader.loadBinaryFile("..\\Source\\Loader\\models\\testIndexed.btx");
+	}
+	Clock::time_point indexedEnd = Clock::now();
+
+	std::ifstream expandedFile("..\\Source\\Loader\\models\\testExpanded.btx", std::istream::binary | std::istream::ate);
+	const std::streamoff expandedSize = expandedFile.tellg();
+	BOOST_CHECK_LT(statistics.m_FileSize, expandedSize);
+
+	const long long expandedMicro = std::chrono::duration_cast<std::chrono::microseconds>(expandedEnd - expandedStart).count();
+	const long long indexedMicro = std::chrono::duration_cast<std::chrono::microseconds>(indexedEnd - indexedStart).count();
+	BOOST_TEST_MESSAGE("Loading a " << statistics.m_Corners / 3 << " triangle model " << numLoads << " times: expanded "
+		<< expandedMicro << " us (" << expandedSize << " bytes), indexed " << indexedMicro << " us ("
+		<< statistics.m_FileSize << " bytes), ACMR " << statistics.m_ACMRBefore << " -> " << statistics.m_ACMRAfter);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
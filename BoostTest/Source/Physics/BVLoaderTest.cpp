@@ -1,5 +1,6 @@
 #include <boost\test\unit_test.hpp>
 #include "..\..\Physics\Source\BVLoader.h"
+#include "..\..\BinaryConverter\Source\BoundingVolumeConverter.h"
 #include "..\..\Physics\include\BoundingVolume.h"
 
 class DummyBoundingVolume : public BoundingVolume
@@ -54,11 +55,11 @@ BOOST_AUTO_TEST_CASE(testLoad)
 						"face: 3\n"
 						"0 | 1 | 2 |";
 
-	std::istringstream stream(file);
+	TextTokenizer tokenizer(file.data(), file.size());
 	
 	BVLoader bv;
 	BVLoader::Header header;
-	bv.readHeader(&stream);
+	bv.readHeader(tokenizer);
 	header = bv.getLevelHeader();
 
 	BOOST_CHECK_EQUAL(header.m_modelName, "CB_Test");
@@ -66,7 +67,7 @@ BOOST_AUTO_TEST_CASE(testLoad)
 	BOOST_CHECK_EQUAL(header.m_numVertex, 3);
 	BOOST_CHECK_EQUAL(header.m_numFaces, 1);
 
-	bv.readBoundingVolume(&stream);
+	bv.readBoundingVolume(tokenizer);
 	std::vector<BVLoader::BoundingVolume> vec = bv.getBoundingVolumes();
 	BOOST_CHECK_EQUAL(vec[0].m_Postition.x, -1.f); // BVloader .x *-1.f :'(
 	BOOST_CHECK_EQUAL(vec[0].m_Postition.y, 1.f);
@@ -93,4 +94,94 @@ BOOST_AUTO_TEST_CASE(testLoad)
 	BOOST_CHECK_EQUAL(header.m_numFaces, 0);
 }
 
+BOOST_AUTO_TEST_CASE(testLoadBinary)
+{
+	std::string file =  "*Header\n" 
+						"#Materials 0\n" 
+						"#MESH CB_Test\n"
+						"#Vertices 3\n"
+						"#Triangles 1\n"
+						"\n"
+						"*Vertices\n"
+						"v 100 100 100\n"
+						"v 200 200 100\n"
+						"v 200 100 100\n"
+						"\n"
+						"*FACES\n"
+						"-BoundingVolume\n"
+						"face: 3\n"
+						"0 | 1 | 2 |";
+
+	std::istringstream text(file);
+	BoundingVolumeConverter converter;
+	BOOST_REQUIRE(converter.readStream(text));
+	BOOST_CHECK_CLOSE_FRACTION(converter.getRadius(), 3.f, 0.0001f);
+
+	std::stringstream binary(std::ios::in | std::ios::out | std::ios::binary);
+	BOOST_REQUIRE(converter.writeStream(binary));
+
+	BVLoader bv;
+	BOOST_REQUIRE(bv.readCompactBoundingVolume(binary));
+	BOOST_CHECK(bv.isPrescaled());
+	BOOST_CHECK_CLOSE_FRACTION(bv.getBoundingSphere().w, 3.f, 0.0001f);
+	BOOST_CHECK_EQUAL(bv.getLevelHeader().m_numFaces, 1);
+
+	std::vector<BVLoader::BoundingVolume> vec = bv.getBoundingVolumes();
+	BOOST_REQUIRE_EQUAL(vec.size(), 3);
+	BOOST_CHECK_CLOSE_FRACTION(vec[1].m_Postition.x, -2.f, 0.0001f);
+	BOOST_CHECK_CLOSE_FRACTION(vec[1].m_Postition.y, 2.f, 0.0001f);
+	BOOST_CHECK_CLOSE_FRACTION(vec[1].m_Postition.z, 1.f, 0.0001f);
+	BOOST_CHECK_EQUAL(vec[1].m_Postition.w, 1.f);
+
+	std::string broken = binary.str();
+	broken[0] = 'X';
+	std::istringstream brokenMagic(broken);
+	BOOST_CHECK(!bv.readCompactBoundingVolume(brokenMagic));
+
+	std::istringstream truncated(binary.str().substr(0, binary.str().size() - 4));
+	BOOST_CHECK(!bv.readCompactBoundingVolume(truncated));
+	BOOST_CHECK(bv.getBoundingVolumes().empty());
+}
+
+BOOST_AUTO_TEST_CASE(testLoadMemory)
+{
+	const std::string file =	"*Header\n"
+								"#Materials 0\n"
+								"#MESH CB_Test\n"
+								"#Vertices 3\n"
+								"#Triangles 1\n"
+								"\n"
+								"*Vertices\n"
+								"v 100 100 100\n"
+								"v 200 200 100\n"
+								"v 200 100 100\n"
+								"\n"
+								"*FACES\n"
+								"-BoundingVolume\n"
+								"face: 3\n"
+								"0 | 1 | 2 |";
+
+	BVLoader bv;
+	BOOST_REQUIRE(bv.loadMemory(file.data(), file.size()));
+	BOOST_CHECK(!bv.isPrescaled());
+	BOOST_REQUIRE_EQUAL(bv.getBoundingVolumes().size(), 3);
+	BOOST_CHECK_EQUAL(bv.getBoundingVolumes()[1].m_Postition.x, -200.f);
+
+	std::istringstream text(file);
+	BoundingVolumeConverter converter;
+	BOOST_REQUIRE(converter.readStream(text));
+	std::ostringstream binaryStream(std::ios::out | std::ios::binary);
+	BOOST_REQUIRE(converter.writeStream(binaryStream));
+	const std::string binary = binaryStream.str();
+
+	BOOST_REQUIRE(bv.loadMemory(binary.data(), binary.size()));
+	BOOST_CHECK(bv.isPrescaled());
+	BOOST_CHECK_CLOSE_FRACTION(bv.getBoundingSphere().w, 3.f, 0.0001f);
+	BOOST_REQUIRE_EQUAL(bv.getBoundingVolumes().size(), 3);
+	BOOST_CHECK_CLOSE_FRACTION(bv.getBoundingVolumes()[1].m_Postition.x, -2.f, 0.0001f);
+
+	BOOST_CHECK(!bv.loadMemory(binary.data(), binary.size() - 4));
+	BOOST_CHECK(bv.getBoundingVolumes().empty());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
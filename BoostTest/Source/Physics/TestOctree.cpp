@@ -2,8 +2,10 @@
 #include "..\..\Physics\Source\Octree.h"
 #include "..\..\Physics\include\Sphere.h"
 
+#include <cmath>
 #include <iterator>
 #include <set>
+#include <vector>
 
 using namespace DirectX;
 
@@ -109,4 +111,94 @@ BOOST_AUTO_TEST_CASE(TestOctreeFind)
 	BOOST_CHECK(potentialColliders.find(1) != potentialColliders.end());
 }
 
+BOOST_AUTO_TEST_CASE(TestOctreeAddBodies)
+{
+	// A level-like grid of static bodies, with a few large ones mixed in
+	std::vector<Sphere> spheres;
+	for (int x = 0; x < 20; ++x)
+	{
+		for (int z = 0; z < 20; ++z)
+		{
+			const float radius = (x * z) % 37 == 0 ? 40.f : 1.f + (x + z) % 3;
+			spheres.push_back(Sphere(radius, XMFLOAT4(x * 5.f - 30.f, (float)(x % 4), z * 5.f + 12.f, 1.f)));
+		}
+	}
+
+	Octree incremental;
+	Octree bulk;
+	std::vector<std::pair<Octree::BodyHandle, const Sphere*>> bodies;
+	for (size_t i = 0; i < spheres.size(); ++i)
+	{
+		incremental.addBody(i, &spheres[i]);
+		bodies.push_back(std::make_pair((Octree::BodyHandle)i, &spheres[i]));
+	}
+	bulk.addBodies(bodies);
+
+	const XMFLOAT4& min = bulk.getMinPos();
+	const XMFLOAT4& max = bulk.getMaxPos();
+	for (const auto& sphere : spheres)
+	{
+		BOOST_CHECK(sphere.getPosition().x - sphere.getRadius() >= min.x);
+		BOOST_CHECK(sphere.getPosition().z + sphere.getRadius() <= max.z);
+	}
+	BOOST_CHECK_CLOSE(max.x - min.x, max.y - min.y, 0.001f);
+
+	for (const auto& query : spheres)
+	{
+		std::set<Octree::BodyHandle> fromIncremental;
+		std::set<Octree::BodyHandle> fromBulk;
+		incremental.findPotentialIntersections(&query, std::inserter(fromIncremental, fromIncremental.end()));
+		bulk.findPotentialIntersections(&query, std::inserter(fromBulk, fromBulk.end()));
+
+		for (size_t i = 0; i < spheres.size(); ++i)
+		{
+			const XMFLOAT4 a = query.getPosition();
+			const XMFLOAT4 b = spheres[i].getPosition();
+			const float distance = std::sqrt((a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y) + (a.z - b.z) * (a.z - b.z));
+			if (distance <= query.getRadius() + spheres[i].getRadius())
+			{
+				BOOST_CHECK(fromIncremental.count(i) == 1);
+				BOOST_CHECK(fromBulk.count(i) == 1);
+			}
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(TestOctreeAddBodiesToExistingTree)
+{
+	Octree tree;
+
+	Sphere first(1.f, XMFLOAT4(0.f, 0.f, 0.f, 1.f));
+	tree.addBody(0, &first);
+
+	std::vector<Sphere> spheres;
+	for (int i = 0; i < 40; ++i)
+	{
+		spheres.push_back(Sphere(1.f, XMFLOAT4(i * 3.f, 0.f, 0.f, 1.f)));
+	}
+	std::vector<std::pair<Octree::BodyHandle, const Sphere*>> bodies;
+	for (size_t i = 0; i < spheres.size(); ++i)
+	{
+		bodies.push_back(std::make_pair((Octree::BodyHandle)(i + 1), &spheres[i]));
+	}
+	tree.addBodies(bodies);
+	tree.addBodies(std::vector<std::pair<Octree::BodyHandle, const Sphere*>>());
+
+	BOOST_CHECK(tree.getMaxPos().x >= 118.f);
+
+	std::set<Octree::BodyHandle> potentialColliders;
+	tree.findPotentialIntersections(&first, std::inserter(potentialColliders, potentialColliders.end()));
+	BOOST_CHECK(potentialColliders.find(0) != potentialColliders.end());
+
+	potentialColliders.clear();
+	tree.findPotentialIntersections(&spheres.back(), std::inserter(potentialColliders, potentialColliders.end()));
+	BOOST_CHECK(potentialColliders.find(40) != potentialColliders.end());
+	BOOST_CHECK(potentialColliders.find(0) == potentialColliders.end());
+
+	tree.removeBody(40, &spheres.back());
+	potentialColliders.clear();
+	tree.findPotentialIntersections(&spheres.back(), std::inserter(potentialColliders, potentialColliders.end()));
+	BOOST_CHECK(potentialColliders.find(40) == potentialColliders.end());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -26,6 +26,19 @@ cbuffer cbSkinned : register(b2)
 	float4x4 cBoneTransform[96];
 };
 
+#ifdef COMPACT_VERTEX
+#include "CompactVertex.hlsl"
+
+struct VSIn
+{
+	float4 pos		: POSITION;
+	float2 normal	: NORMAL;
+	float2 uvCoord	: COORD;
+	float2 tangent	: TANGENT;
+	float3 weights	: WEIGHTS;
+	uint4 boneId	: BONEID;
+};
+#else
 struct VSIn
 {
 	float4 pos		: POSITION;
@@ -36,6 +49,7 @@ struct VSIn
 	float3 weights	: WEIGHTS;
 	uint4 boneId	: BONEID;
 };
+#endif
 
 //############################
 // Shader step: Vertex Shader
@@ -43,6 +57,16 @@ struct VSIn
 PSIn VS(VSIn input)
 {
 	PSIn output;
+#ifdef COMPACT_VERTEX
+	float4 position;
+	float3 normal, tangent, binormal;
+	decodeCompactVertex(input.pos, input.normal, input.tangent, position, normal, tangent, binormal);
+#else
+	float4 position = input.pos;
+	float3 normal = input.normal;
+	float3 tangent = input.tangent;
+	float3 binormal = input.binormal;
+#endif
 
 	// Init array or else we get strange warnings about SV_POSITION.
 	float weights[4] = {0.0f, 0.0f, 0.0f, 0.0f};
@@ -61,10 +85,10 @@ PSIn VS(VSIn input)
 	{
 	    // Assume no nonuniform scaling when transforming normals, so 
 		// that we do not have to use the inverse-transpose.
-	    posL		+= weights[i] * mul(cBoneTransform[input.boneId[i] - 1], input.pos);
-		normalL		+= weights[i] * mul((float3x3)cBoneTransform[input.boneId[i] - 1], input.normal);
-		tangentL	+= weights[i] * mul((float3x3)cBoneTransform[input.boneId[i] - 1], input.tangent);
-		binormalL	+= weights[i] * mul((float3x3)cBoneTransform[input.boneId[i] - 1], input.binormal);
+	    posL		+= weights[i] * mul(cBoneTransform[input.boneId[i] - 1], position);
+		normalL		+= weights[i] * mul((float3x3)cBoneTransform[input.boneId[i] - 1], normal);
+		tangentL	+= weights[i] * mul((float3x3)cBoneTransform[input.boneId[i] - 1], tangent);
+		binormalL	+= weights[i] * mul((float3x3)cBoneTransform[input.boneId[i] - 1], binormal);
 	}
 	posL /= posL.w;
 
@@ -75,7 +99,7 @@ PSIn VS(VSIn input)
 	output.uvCoord = input.uvCoord;
 	output.tangent = normalize(mul(cWorld, float4(tangentL, 0.f))).xyz;
 	output.binormal = normalize(mul(cWorld, float4(binormalL, 0.f))).xyz;
-	output.depth = mul(cView, mul(cWorld, input.pos)).z;
+	output.depth = mul(cView, mul(cWorld, position)).z;
 
 	return output;
 }
@@ -0,0 +1,40 @@
+#pragma pack_matrix(row_major)
+
+//################################
+//		Compact Vertex Layout
+//################################
+// Decodes the quantized vertices of compact model files, see VertexQuantizer.
+// POSITION is R16G16B16A16_UNORM with the binormal sign in w, NORMAL and
+// TANGENT are octahedral R16G16_SNORM and COORD is R16G16_FLOAT.
+
+cbuffer cbVertexBounds : register(b4)
+{
+	float4 cPositionMin;
+	float4 cPositionSize;
+};
+
+float3 decodeOctahedral(float2 p_Encoded)
+{
+	float3 direction = float3(p_Encoded, 1.f - abs(p_Encoded.x) - abs(p_Encoded.y));
+	if(direction.z < 0.f)
+	{
+		float2 signs = float2(direction.x >= 0.f ? 1.f : -1.f, direction.y >= 0.f ? 1.f : -1.f);
+		direction.xy = (1.f - abs(direction.yx)) * signs;
+	}
+	return normalize(direction);
+}
+
+float4 decodeCompactPosition(float4 p_Position)
+{
+	return float4(cPositionMin.xyz + p_Position.xyz * cPositionSize.xyz, 1.f);
+}
+
+void decodeCompactVertex(float4 p_Position, float2 p_Normal, float2 p_Tangent,
+	out float4 p_DecodedPosition, out float3 p_DecodedNormal, out float3 p_DecodedTangent, out float3 p_DecodedBinormal)
+{
+	p_DecodedPosition = decodeCompactPosition(p_Position);
+	p_DecodedNormal = decodeOctahedral(p_Normal);
+	p_DecodedTangent = decodeOctahedral(p_Tangent);
+	// The sign is stored as a 16 bit integer, so -1 reads as 1 and +1 as almost 0
+	p_DecodedBinormal = cross(p_DecodedTangent, p_DecodedNormal) * (p_Position.w > 0.5f ? -1.f : 1.f);
+}
@@ -22,6 +22,17 @@ cbuffer cbColor : register(b3)
 	float3 cbColor;
 };
 
+#ifdef COMPACT_VERTEX
+#include "CompactVertex.hlsl"
+
+struct VSIn
+{
+	float4 pos		: POSITION;
+	float2 normal	: NORMAL;
+	float2 uvCoord	: COORD;
+	float2 tangent	: TANGENT;
+};
+#else
 struct VSIn
 {
 	float4 pos		: POSITION;
@@ -30,6 +41,7 @@ struct VSIn
 	float3 tangent	: TANGENT;
 	float3 binormal	: BINORMAL;
 };
+#endif
 
 struct PSIn
 {
@@ -49,14 +61,24 @@ struct PSOut
 PSIn VS( VSIn input )
 {
 	PSIn output;
+#ifdef COMPACT_VERTEX
+	float4 position;
+	float3 normal, tangent, binormal;
+	decodeCompactVertex(input.pos, input.normal, input.tangent, position, normal, tangent, binormal);
+#else
+	float4 position = input.pos;
+	float3 normal = input.normal;
+	float3 tangent = input.tangent;
+	float3 binormal = input.binormal;
+#endif
 
-	output.pos = mul( projection, mul(view, mul(world, input.pos) ) );
-	output.wpos = mul(world, input.pos);
+	output.pos = mul( projection, mul(view, mul(world, position) ) );
+	output.wpos = mul(world, position);
 
-	output.normal = normalize(mul(world, float4(input.normal, 0.f)).xyz);
+	output.normal = normalize(mul(world, float4(normal, 0.f)).xyz);
 	output.uvCoord = input.uvCoord;
-	output.tangent = normalize(mul(world, float4(input.tangent,0.f)).xyz);
-	output.binormal = normalize(mul(world, float4(input.binormal, 0.f)).xyz);
+	output.tangent = normalize(mul(world, float4(tangent,0.f)).xyz);
+	output.binormal = normalize(mul(world, float4(binormal, 0.f)).xyz);
 	
 	return output;
 }
@@ -18,6 +18,18 @@ cbuffer cbWorld : register(b1)
 	float4x4 cWorld;
 };
 
+#ifdef COMPACT_VERTEX
+#include "CompactVertex.hlsl"
+
+struct VSIn
+{
+	float4 pos		: POSITION;
+	float2 normal	: NORMAL;
+	float2 uvCoord	: COORD;
+	float2 tangent	: TANGENT;
+	float4x4 vworld	: WORLD;
+};
+#else
 struct VSIn
 {
 	float4 pos		: POSITION;
@@ -27,6 +39,7 @@ struct VSIn
 	float3 binormal	: BINORMAL;
 	float4x4 vworld	: WORLD;
 };
+#endif
 
 //############################
 // Shader step: Vertex Shader
@@ -34,15 +47,25 @@ struct VSIn
 PSIn VS( VSIn input )
 {
 	PSIn output;
+#ifdef COMPACT_VERTEX
+	float4 position;
+	float3 normal, tangent, binormal;
+	decodeCompactVertex(input.pos, input.normal, input.tangent, position, normal, tangent, binormal);
+#else
+	float4 position = input.pos;
+	float3 normal = input.normal;
+	float3 tangent = input.tangent;
+	float3 binormal = input.binormal;
+#endif
 
-	output.position = mul( cProjection, mul(cView, mul(input.vworld, input.pos)));
-	output.wposition = mul(input.vworld, input.pos);
+	output.position = mul( cProjection, mul(cView, mul(input.vworld, position)));
+	output.wposition = mul(input.vworld, position);
 
-	output.normal = normalize(mul(input.vworld, float4(input.normal, 0.f)).xyz);
+	output.normal = normalize(mul(input.vworld, float4(normal, 0.f)).xyz);
 	output.uvCoord = input.uvCoord;
-	output.tangent = normalize(mul(input.vworld, float4(input.tangent, 0.f)).xyz);
-	output.binormal = normalize(mul(input.vworld, float4(input.binormal, 0.f)).xyz);
-	output.depth = mul(cView, mul(input.vworld, input.pos)).z;
+	output.tangent = normalize(mul(input.vworld, float4(tangent, 0.f)).xyz);
+	output.binormal = normalize(mul(input.vworld, float4(binormal, 0.f)).xyz);
+	output.depth = mul(cView, mul(input.vworld, position)).z;
 			
 	return output;
 }
@@ -18,6 +18,17 @@ cbuffer cbWorld : register(b1)
 	float4x4 cWorld;
 };
 
+#ifdef COMPACT_VERTEX
+#include "CompactVertex.hlsl"
+
+struct VSIn
+{
+	float4 position	: POSITION;
+	float2 normal	: NORMAL;
+	float2 uvCoord	: COORD;
+	float2 tangent	: TANGENT;
+};
+#else
 struct VSIn
 {
 	float4 position	: POSITION;
@@ -26,6 +37,7 @@ struct VSIn
 	float3 tangent	: TANGENT;
 	float3 binormal	: BINORMAL;
 };
+#endif
 
 //############################
 // Shader step: Vertex Shader
@@ -33,15 +45,25 @@ struct VSIn
 PSIn VS(VSIn p_Input)
 {
 	PSIn output;
+#ifdef COMPACT_VERTEX
+	float4 position;
+	float3 normal, tangent, binormal;
+	decodeCompactVertex(p_Input.position, p_Input.normal, p_Input.tangent, position, normal, tangent, binormal);
+#else
+	float4 position = p_Input.position;
+	float3 normal = p_Input.normal;
+	float3 tangent = p_Input.tangent;
+	float3 binormal = p_Input.binormal;
+#endif
 
-	output.position = mul(cProjection, mul(cView, mul(cWorld, p_Input.position)));
-	output.wposition = mul(cWorld, p_Input.position);
+	output.position = mul(cProjection, mul(cView, mul(cWorld, position)));
+	output.wposition = mul(cWorld, position);
 
-	output.normal = normalize(mul(cWorld, float4(p_Input.normal, 0.f)).xyz);
+	output.normal = normalize(mul(cWorld, float4(normal, 0.f)).xyz);
 	output.uvCoord = p_Input.uvCoord;
-	output.tangent = normalize(mul(cWorld, float4(p_Input.tangent, 0.f)).xyz);
-	output.binormal = normalize(mul(cWorld, float4(p_Input.binormal, 0.f)).xyz);
-	output.depth = mul(cView, mul(cWorld, p_Input.position)).z;
+	output.tangent = normalize(mul(cWorld, float4(tangent, 0.f)).xyz);
+	output.binormal = normalize(mul(cWorld, float4(binormal, 0.f)).xyz);
+	output.depth = mul(cView, mul(cWorld, position)).z;
 
 	return output;
 }
@@ -14,6 +14,15 @@ cbuffer cbPos : register (b1)
 	float4 cColor;
 };
 
+#ifdef COMPACT_VERTEX
+#include "CompactVertex.hlsl"
+
+struct VS_Input
+{
+	float4 position	: POSITION;
+	float2 texCoord	: COORD;
+};
+#else
 struct VS_Input
 {
 	float4 position	: POSITION;
@@ -22,6 +31,7 @@ struct VS_Input
 	float3 tangent	: TANGENT;
 	float3 binormal	: BINORMAL;
 };
+#endif
 
 struct VS_Output
 {
@@ -32,7 +42,12 @@ struct VS_Output
 VS_Output VS(VS_Input input)
 {
 	VS_Output output;
-	output.position = mul(cOrthoProjection, mul(cWorld, float4(input.position.xyz, 1.0f)));
+#ifdef COMPACT_VERTEX
+	float4 position = decodeCompactPosition(input.position);
+#else
+	float4 position = float4(input.position.xyz, 1.0f);
+#endif
+	output.position = mul(cOrthoProjection, mul(cWorld, position));
 	output.position /= output.position.w;
 	output.texCoord = input.texCoord;
 	
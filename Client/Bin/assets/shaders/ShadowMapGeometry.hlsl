@@ -13,6 +13,15 @@ cbuffer cbWorld : register(b1)
 	float4x4 cWorld;
 };
 
+#ifdef COMPACT_VERTEX
+#include "CompactVertex.hlsl"
+
+struct VSIn
+{
+	float4 pos		: POSITION;
+	float4x4 vworld	: WORLD;
+};
+#else
 struct VSIn
 {
 	float4 pos		: POSITION;
@@ -22,11 +31,17 @@ struct VSIn
 	float3 binormal	: BINORMAL;
 	float4x4 vworld	: WORLD;
 };
+#endif
 
 float4 VS(VSIn input) : SV_POSITION
 {
 	float4 output;
-	output = mul(cProjection, mul(cView, mul(input.vworld, input.pos)));
+#ifdef COMPACT_VERTEX
+	float4 position = decodeCompactPosition(input.pos);
+#else
+	float4 position = input.pos;
+#endif
+	output = mul(cProjection, mul(cView, mul(input.vworld, position)));
 
 	return output;
 }
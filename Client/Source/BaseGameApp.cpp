@@ -1,5 +1,6 @@
 #include "BaseGameApp.h"
 
+#include <CommonExceptions.h>
 #include <Logger.h>
 #include "Scenes/HUDScene.h"
 #include "Scenes/GameScene.h"
@@ -7,12 +8,39 @@
 #include <TweakCommand.h>
 #include "../resource.h"
 
+#include <algorithm>
+#include <fstream>
 #include <iomanip>
 #include <memory>
 #include <sstream>
+#include <thread>
 
 using namespace DirectX;
 
+namespace
+{
+	/**
+	 * Held by the finish step of a model load, discards the preloaded model file
+	 * if the finish step is dropped without creating the model.
+	 */
+	struct PreloadedModelGuard
+	{
+		IGraphics* m_Graphics;
+		std::string m_Path;
+
+		PreloadedModelGuard(IGraphics* p_Graphics, const std::string& p_Path)
+			:	m_Graphics(p_Graphics),
+				m_Path(p_Path)
+		{
+		}
+
+		~PreloadedModelGuard()
+		{
+			m_Graphics->discardPreloadedModel(m_Path.c_str());
+		}
+	};
+}
+
 const std::string BaseGameApp::m_GameTitle = "The Apprentice of Havenborough";
 
 BaseGameApp::BaseGameApp()
@@ -94,6 +122,7 @@ void BaseGameApp::init()
 
 	using std::placeholders::_1;
 	using std::placeholders::_2;
+	using std::placeholders::_3;
 	m_Graphics->setLoadModelTextureCallBack(&ResourceManager::loadModelTexture, m_ResourceManager.get());
 	m_Graphics->setReleaseModelTextureCallBack(&ResourceManager::releaseModelTexture, m_ResourceManager.get());
 
@@ -102,12 +131,15 @@ void BaseGameApp::init()
 		std::bind(&IGraphics::releaseModel, m_Graphics, _1) );
 	m_ResourceManager->registerFunction("texture",
 		std::bind(&IGraphics::createTexture, m_Graphics, _1, _2),
+		std::bind(&IGraphics::createTextureFromMemory, m_Graphics, _1, _2, _3),
 		std::bind(&IGraphics::releaseTexture, m_Graphics, _1));
 	m_ResourceManager->registerFunction("volume",
 		std::bind(&IPhysics::createBV, m_Physics, _1, _2),
+		std::bind(&IPhysics::createBVFromMemory, m_Physics, _1, _2, _3),
 		std::bind(&IPhysics::releaseBV, m_Physics, _1));
 	m_ResourceManager->registerFunction("sound",
 		std::bind(&ISound::loadSound, m_Sound, _1, _2),
+		std::bind(&ISound::loadSoundFromMemory, m_Sound, _1, _2, _3),
 		std::bind(&ISound::releaseSound, m_Sound, _1));
 	m_ResourceManager->registerFunction("particleSystem",
 		std::bind(&IGraphics::createParticleEffectDefinition, m_Graphics, _1, _2),
@@ -118,7 +150,55 @@ void BaseGameApp::init()
 	m_ResourceManager->registerFunction("animation",
 		std::bind(&AnimationLoader::loadAnimationDataResource, m_AnimationLoader.get(), _1, _2),
 		std::bind(&AnimationLoader::releaseAnimationData, m_AnimationLoader.get(), _1));
+	// Files are read and parsed on the loader threads, only the creation of
+	// the graphics and physics resources is left for the main thread
+	IGraphics* graphics = m_Graphics;
+	IPhysics* physics = m_Physics;
+	m_ResourceManager->registerPrepareFunction("model",
+		[graphics] (const char* p_Name, const char* p_Path, ResourceDependencies& p_Dependencies) -> ResourceManager::FinishFunction
+		{
+			graphics->preloadModel(p_Path, &ResourceDependencies::addModelTexture, &p_Dependencies);
+			const std::string name(p_Name);
+			const std::string path(p_Path);
+			const std::shared_ptr<PreloadedModelGuard> guard(new PreloadedModelGuard(graphics, path));
+			return [name, path, graphics, guard] () { return graphics->createModel(name.c_str(), path.c_str()); };
+		});
+	m_ResourceManager->registerPrepareFunction("texture",
+		[graphics] (const char* p_Name, const char* p_Path, ResourceDependencies&) -> ResourceManager::FinishFunction
+		{
+			std::ifstream file(p_Path, std::ifstream::in | std::ifstream::binary);
+			if (!file)
+			{
+				throw ResourceManagerException(std::string("Texture file could not be opened: ") + p_Path, __LINE__, __FILE__);
+			}
+			std::shared_ptr<std::vector<char>> data(new std::vector<char>(
+				(std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>()));
+			const std::string name(p_Name);
+			return [=] () { return graphics->createTextureFromMemory(name.c_str(), data->data(), data->size()); };
+		});
+	m_ResourceManager->registerPrepareFunction("volume",
+		[physics] (const char* p_Name, const char* p_Path, ResourceDependencies&) -> ResourceManager::FinishFunction
+		{
+			physics->preloadBV(p_Name, p_Path);
+			const std::string name(p_Name);
+			const std::string path(p_Path);
+			return [=] () { return physics->createBV(name.c_str(), path.c_str()); };
+		});
+	m_ResourceManager->setLoaderThreads((std::max)(std::thread::hardware_concurrency(), 2u) - 1);
+	// Keep unused models and textures, such as spell effects, loaded until these
+	// budgets of file size are exceeded instead of reloading them on every use
+	m_ResourceManager->setResourceBudget("model", 64 * 1024 * 1024);
+	m_ResourceManager->setResourceBudget("texture", 256 * 1024 * 1024);
+
 	m_ResourceManager->loadDataFromFile("assets\\Resources.xml");
+	if (boost::filesystem::exists("assets\\Resources.hpak"))
+	{
+		m_ResourceManager->loadArchive("assets\\Resources.hpak");
+	}
+	if (boost::filesystem::exists("assets\\textures\\Textures.btt"))
+	{
+		m_Graphics->loadTextureTable("assets\\textures\\Textures.btt");
+	}
 
 	InputTranslator::ptr translator(new InputTranslator);
 	translator->init(&m_Window);
@@ -235,6 +315,8 @@ void BaseGameApp::run()
 		handleInput();
 
 		updateLogic();
+
+		m_ResourceManager->finishAsyncLoads();
 		
 		m_Sound->onFrame();
 
@@ -250,6 +332,8 @@ void BaseGameApp::shutdown()
 	Logger::log(Logger::Level::INFO, "Shutting down the game app");
 
 	m_ResourceManager->setReleaseImmediately(true);
+	// Stop preparing resources before the subsystems they are prepared for are deleted
+	m_ResourceManager->setLoaderThreads(0);
 
 	INetwork::deleteNetwork(m_Network);	
 	m_Network = nullptr;
@@ -385,6 +469,7 @@ void BaseGameApp::updateDebugInfo()
 		info.updateDebugInfo("Virtual RAM", vMemUsage);
 		info.updateDebugInfo("Physical RAM", pMemUsage);
 		info.updateDebugInfo("Video RAM", gMemUsage);
+		info.updateDebugInfo("Animation LOD", m_GameLogic->getAnimationLOD().getTierCountText());
 
 		char buffer[10];
 		std::sprintf(buffer, "%.1f", 1.0f / m_DeltaTime);
@@ -39,6 +39,13 @@ void GameLogic::initialize(ResourceManager *p_ResourceManager, IPhysics *p_Physi
 	m_Network = p_Network;
 	m_EventManager = p_EventManager;
 
+	m_ActorFactory->setAnimationLOD(&m_AnimationLOD);
+
+	// The main thread evaluates poses as well, leave the other cores to the workers
+	const unsigned int numCores = std::thread::hardware_concurrency();
+	m_AnimationJobs.reset(new AnimationJobSystem(numCores > 1 ? numCores - 1 : 0));
+	m_ActorFactory->setAnimationJobs(m_AnimationJobs.get());
+
 	m_EventManager->addListener(EventListenerDelegate(this, &GameLogic::removeActorByEvent), RemoveActorEventData::sk_EventType);
 		
 	m_Actors.reset(new ActorList);
@@ -51,6 +58,8 @@ void GameLogic::initialize(ResourceManager *p_ResourceManager, IPhysics *p_Physi
 	m_InGame = false;
 	m_PlayingLocal = true;
 	m_StartLocal = false;
+	m_StartLocalWhenLoaded = false;
+	m_DoneLoadingWhenLoaded = false;
 	m_PlayerTimeDifference = 0.f;
 	m_PlayerPositionInRace = 0;
 
@@ -63,13 +72,18 @@ void GameLogic::initialize(ResourceManager *p_ResourceManager, IPhysics *p_Physi
 	{
 		changeCameraMode(p_Mode);
 	}));
+	m_AnimationLOD.registerTweakSettings();
 
 	m_ActorFactory->getSpellFactory()->createSpellDefinition("TestSpell", ".."); // Maybe not here.
 }
 
 void GameLogic::shutdown(void)
 {
+	m_ActorFactory->setAnimationLOD(nullptr);
+	m_ActorFactory->setAnimationJobs(nullptr);
 	m_Level.releaseLevel();
+	// The prototypes reference loaded volumes
+	m_ActorFactory->clearInstancePrototypes();
 	m_Physics->releaseAllBoundingVolumes();
 }
 
@@ -93,6 +107,15 @@ void GameLogic::onFrame(float p_DeltaTime)
 		m_StartLocal = false;
 	}
 
+	if (m_Level.isLoading())
+	{
+		m_Level.onFrame();
+		if (!m_Level.isLoading())
+		{
+			levelLoaded();
+		}
+	}
+
 	if (!m_InGame)
 	{
 		return;
@@ -218,7 +241,9 @@ void GameLogic::onFrame(float p_DeltaTime)
 			}
 		}
 	}
+	m_AnimationLOD.assignTiers(getPlayerEyePosition());
 	m_Actors->onUpdate(p_DeltaTime);
+	m_AnimationJobs->run();
 
 	m_Player.fixLookToHead();
 	
@@ -440,27 +465,27 @@ void GameLogic::playLocalLevel()
 	m_Actors.reset(new ActorList());
 	m_ActorFactory->setActorList(m_Actors);
 
-	m_Level = Level(m_ResourceManager, m_ActorFactory, m_EventManager);
+	m_Level = Level(m_ResourceManager, m_ActorFactory, m_EventManager, m_Physics);
 #ifdef _DEBUG
-	std::ifstream input("assets/levels/Level2.btxl", std::istream::in | std::istream::binary);
-	if(!input)
-	{
-		throw InvalidArgument("File could not be found: LoadLevel", __LINE__, __FILE__);
-	}
-	m_Level.loadLevel(input, m_Actors);
+	std::shared_ptr<LevelBinaryView> levelData(new LevelBinaryView);
+	levelData->openFile("assets/levels/Level2.btxl");
+	m_Level.loadLevel(levelData, m_Actors);
 	m_Level.setStartPosition(XMFLOAT3(0.f, 10.0f, 1500.f)); //TODO: Remove this line when level gets the position from file
 	m_Level.setGoalPosition(XMFLOAT3(4850.0f, 0.0f, -2528.0f)); //TODO: Remove this line when level gets the position from file
 #else
-	std::ifstream input("assets/levels/Level4.5.btxl", std::istream::in | std::istream::binary);
-	if(!input)
-	{
-		throw InvalidArgument("File could not be found: LoadLevel", __LINE__, __FILE__);
-	}
-	m_Level.loadLevel(input, m_Actors);
+	std::shared_ptr<LevelBinaryView> levelData(new LevelBinaryView);
+	levelData->openFile("assets/levels/Level4.5.btxl");
+	m_Level.loadLevel(levelData, m_Actors);
 	m_Level.setStartPosition(XMFLOAT3(6200.0f, 250.0f, -30600.0f)); //TODO: Remove this line when level gets the position from file
 	m_Level.setGoalPosition(XMFLOAT3(4850.0f, 0.0f, -2528.0f)); //TODO: Remove this line when level gets the position from file
 #endif
 
+	// The player is added by levelLoaded when the instances to stand on exist
+	m_StartLocalWhenLoaded = true;
+}
+
+void GameLogic::startLocalLevel()
+{
 	m_PlayerDefault = addActor(m_ActorFactory->createPlayerActor(m_Level.getStartPosition(), m_Username, m_CharacterName, m_CharacterStyle));
 	
 	m_Player = Player();
@@ -477,6 +502,26 @@ void GameLogic::playLocalLevel()
 	m_EventManager->queueEvent(IEventData::Ptr(new GameStartedEventData));
 }
 
+void GameLogic::levelLoaded()
+{
+	if (m_StartLocalWhenLoaded)
+	{
+		m_StartLocalWhenLoaded = false;
+		startLocalLevel();
+	}
+
+	if (m_DoneLoadingWhenLoaded)
+	{
+		m_DoneLoadingWhenLoaded = false;
+		IConnectionController* conn = m_Network->getConnectionToServer();
+		if (conn && conn->isConnected())
+		{
+			conn->sendDoneLoading();
+		}
+		m_InGame = true;
+	}
+}
+
 void GameLogic::connectToServer(const std::string& p_URL, unsigned short p_Port,
 								const std::string& p_LevelName, const std::string& p_Username,
 								const std::string& p_CharacterName,
@@ -496,9 +541,11 @@ void GameLogic::connectToServer(const std::string& p_URL, unsigned short p_Port,
 
 void GameLogic::leaveGame()
 {
-	if (m_InGame)
+	if (m_InGame || m_Level.isLoading())
 	{
 		m_Level = Level();
+		m_StartLocalWhenLoaded = false;
+		m_DoneLoadingWhenLoaded = false;
 		m_Actors.reset();
 		m_Actors.reset(new ActorList);
 		m_ActorFactory->setActorList(m_Actors);
@@ -696,13 +743,14 @@ void GameLogic::handleNetwork()
 
 			case PackageType::LEVEL_DATA:
 				{
-					m_Level = Level(m_ResourceManager, m_ActorFactory, m_EventManager);
+					m_Level = Level(m_ResourceManager, m_ActorFactory, m_EventManager, m_Physics);
 					size_t size = conn->getLevelDataSize(package);
 					if (size > 0)
 					{
-						std::string buffer(conn->getLevelData(package),size);
-						std::istringstream stream(buffer);
-						m_Level.loadLevel(stream, m_Actors);
+						// The package is cleared after this frame, the instances are created later
+						std::shared_ptr<LevelBinaryView> levelData(new LevelBinaryView);
+						levelData->openCopy(conn->getLevelData(package), size);
+						m_Level.loadLevel(levelData, m_Actors);
 					}
 					else
 					{
@@ -711,8 +759,9 @@ void GameLogic::handleNetwork()
 #else
 						std::string levelFileName("assets/levels/Level1.2.1.btxl");
 #endif
-						std::ifstream file(levelFileName, std::istream::binary);
-						m_Level.loadLevel(file, m_Actors);
+						std::shared_ptr<LevelBinaryView> levelData(new LevelBinaryView);
+						levelData->openFile(levelFileName);
+						m_Level.loadLevel(levelData, m_Actors);
 					}
 					m_Level.setStartPosition(XMFLOAT3(0.f, 1000.0f, 1500.f)); //TODO: Remove this line when level gets the position from file
 					m_Level.setGoalPosition(XMFLOAT3(4850.0f, 0.f, -2528.0f)); //TODO: Remove this line when level gets the position from file
@@ -1040,9 +1089,16 @@ void GameLogic::handleNetwork()
 						m_PlayerDefault = actor;
 					}
 
-					conn->sendDoneLoading();
-					m_InGame = true;
 					m_PlayingLocal = false;
+					if (m_Level.isLoading())
+					{
+						m_DoneLoadingWhenLoaded = true;
+					}
+					else
+					{
+						conn->sendDoneLoading();
+						m_InGame = true;
+					}
 				}
 				break;
 
@@ -1279,6 +1335,11 @@ IPhysics *GameLogic::getPhysics() const
 	return m_Physics;
 }
 
+const AnimationLOD& GameLogic::getAnimationLOD() const
+{
+	return m_AnimationLOD;
+}
+
 std::weak_ptr<Actor> GameLogic::addActor(Actor::ptr p_Actor)
 {
 	m_Actors->addActor(p_Actor);
@@ -42,6 +42,8 @@ private:
 	GoToScene m_ChangeScene;
 
 	ActorFactory* m_ActorFactory;
+	AnimationLOD m_AnimationLOD;
+	std::unique_ptr<AnimationJobSystem> m_AnimationJobs;
 	ActorList::ptr m_Actors;
 
 	Actor::wPtr m_PlayerSparks;
@@ -56,6 +58,8 @@ private:
 	bool m_InGame;
 	bool m_PlayingLocal;
 	bool m_StartLocal;
+	bool m_StartLocalWhenLoaded;
+	bool m_DoneLoadingWhenLoaded;
 	float m_CountdownTimer;
 	bool m_RenderGo;
 
@@ -99,6 +103,7 @@ public:
 	void movePlayerView(float p_Yaw, float p_Pitch);
 
 	IPhysics *getPhysics() const;
+	const AnimationLOD& getAnimationLOD() const;
 
 	void playerJump();
 	void playLocalLevel();
@@ -202,6 +207,8 @@ public:
 private:
 	void handleNetwork();
 	void joinGame();
+	void startLocalLevel();
+	void levelLoaded();
 	
 	static void connectedCallback(Result p_Res, void* p_UserData);
 
@@ -1,14 +1,74 @@
 #include "Level.h"
-#include "InstanceBinaryLoader.h"
+#include "LevelBinaryView.h"
 #include "boost\filesystem.hpp"
 #include "EventData.h"
+#include "WorkerPool.h"
 #include <XMLHelper.h>
 
-Level::Level(ResourceManager* p_Resources, ActorFactory* p_ActorFactory, EventManager* p_EventManager)
+#include <atomic>
+#include <exception>
+#include <thread>
+
+/**
+ * The most threads reading edge files while a level loads. The resource loader
+ * threads are busy with the models and volumes at the same time.
+ */
+static const unsigned int maxDecodeThreads = 4;
+
+/**
+ * The collision data of one model, filled in by a decode job.
+ */
+struct DecodedModel
+{
+	std::vector<ActorFactory::InstanceEdgeBox> edges;
+	/**
+	 * Set if reading the edge file failed, rethrown when the instances are created.
+	 */
+	std::exception_ptr error;
+};
+
+struct Level::LoadState
+{
+	ResourceManager* resources;
+	ActorList::ptr actorOut;
+	/**
+	 * The loaded models and volumes, released with the level.
+	 */
+	std::vector<int> resourceIDs;
+	/**
+	 * The resources not loaded yet, plus one while loadLevel is requesting them.
+	 */
+	unsigned int numPending;
+	bool created;
+	/**
+	 * The level data the instances are placed from, kept mapped until they are created.
+	 */
+	std::shared_ptr<const LevelBinaryView> level;
+	std::vector<DecodedModel> decoded;
+	/**
+	 * The decode jobs not finished yet.
+	 */
+	std::atomic<unsigned int> numDecoding;
+	std::unique_ptr<WorkerPool> decoders;
+
+	~LoadState()
+	{
+		// Running jobs write to decoded, so they have to finish first
+		decoders.reset();
+
+		for (int id : resourceIDs)
+		{
+			resources->releaseResource(id);
+		}
+	}
+};
+
+Level::Level(ResourceManager* p_Resources, ActorFactory* p_ActorFactory, EventManager* p_EventManager, IPhysics* p_Physics)
 {
 	m_Resources = p_Resources;
 	m_ActorFactory = p_ActorFactory;
 	m_EventManager = p_EventManager;
+	m_Physics = p_Physics;
 
 	m_StartPosition = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
 	m_GoalPosition = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
@@ -18,6 +78,7 @@ Level::~Level()
 {
 	m_Resources = nullptr;
 	m_ActorFactory = nullptr;
+	m_Physics = nullptr;
 
 	m_StartPosition = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
 	m_GoalPosition = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
@@ -25,67 +86,163 @@ Level::~Level()
 
 void Level::releaseLevel()
 {
+	m_Load.reset();
 	m_Resources = nullptr;
 }
 
-bool Level::loadLevel(std::istream& p_LevelData, ActorList::ptr p_ActorOut)
+/**
+ * Defers adding static bodies to the collision tree while it exists, and adds
+ * them all when it goes out of scope, also if creating the bodies throws.
+ */
+class StaticBodyBatch
 {
-	InstanceBinaryLoader levelLoader;
-	boost::filesystem::path collisionFolder("assets/volumes/edge");
-	levelLoader.readStreamData(p_LevelData);	
+private:
+	IPhysics* m_Physics;
+
+public:
+	explicit StaticBodyBatch(IPhysics* p_Physics)
+		:	m_Physics(p_Physics)
+	{
+		if (m_Physics)
+		{
+			m_Physics->beginStaticBodyBatch();
+		}
+	}
 
-	std::vector<InstanceBinaryLoader::ModelData> m_LevelData = levelLoader.getModelData();
-	for(unsigned int i = 0; i < m_LevelData.size(); i++)
+	~StaticBodyBatch()
 	{
-		InstanceBinaryLoader::ModelData& model = m_LevelData.at(i);
+		if (m_Physics)
+		{
+			m_Physics->endStaticBodyBatch();
+		}
+	}
 
-		ActorFactory::InstanceModel instModel;
-		instModel.meshName = model.m_MeshName;
+private:
+	StaticBodyBatch(const StaticBodyBatch&);
+	StaticBodyBatch& operator=(const StaticBodyBatch&);
+};
 
-		std::vector<ActorFactory::InstanceBoundingVolume> volumes;
-		std::vector<ActorFactory::InstanceEdgeBox> edges;
+/**
+ * Read the climbable edges of a model, if it has any. Runs on a worker thread.
+ */
+static std::vector<ActorFactory::InstanceEdgeBox> loadEdgeBoxes(const boost::filesystem::path& p_EdgePath)
+{
+	std::vector<ActorFactory::InstanceEdgeBox> edges;
+	if(!boost::filesystem::exists(p_EdgePath))
+	{
+		return edges;
+	}
 
-		if(model.m_CollideAble)
-		{
-			ActorFactory::InstanceBoundingVolume volume;
-			volume.meshName = model.m_MeshName;
-			volumes.push_back(volume);
+	LevelBinaryView EBView;
+	EBView.openFile(p_EdgePath.string());
+	if (EBView.getModelData().empty())
+	{
+		return edges;
+	}
+
+	const LevelBinaryView::ModelData& eb = EBView.getModelData()[0];
+	edges.reserve(eb.m_Translation.size());
+	for(unsigned int k = 0; k < eb.m_Translation.size(); k++)
+	{
+		ActorFactory::InstanceEdgeBox edge;
+		edge.halfsize = eb.m_Scale[k];
+		edge.halfsize = edge.halfsize * 0.5f;
+		edge.offsetPosition = eb.m_Translation[k];
+		edge.offsetRotation = eb.m_Rotation[k];
+		edges.push_back(edge);
+	}
+
+	return edges;
+}
 
-			boost::filesystem::path EBPath = collisionFolder/("EB_" + model.m_MeshName + ".btxe");
-			if(boost::filesystem::exists(EBPath))
+bool Level::loadLevel(std::shared_ptr<const LevelBinaryView> p_LevelData, ActorList::ptr p_ActorOut)
+{
+	const LevelBinaryView& levelLoader = *p_LevelData;
+	boost::filesystem::path collisionFolder("assets/volumes/edge");
+
+	m_ActorFactory->clearInstancePrototypes();
+
+	// Replacing the previous load drops its references, and its callbacks
+	// still in flight release what they receive
+	m_Load.reset(new LoadState);
+	m_Load->resources = m_Resources;
+	m_Load->actorOut = p_ActorOut;
+	m_Load->numPending = 1;
+	m_Load->created = false;
+	m_Load->level = p_LevelData;
+	m_Load->numDecoding = 0;
+	m_Load->decoders.reset(new WorkerPool((std::min)(std::thread::hardware_concurrency(), maxDecodeThreads)));
+
+	std::weak_ptr<LoadState> weakLoad(m_Load);
+	ResourceManager* resources = m_Resources;
+	const ResourceManager::LoadedCallback resourceLoaded = [weakLoad, resources] (int p_ID)
+	{
+		std::shared_ptr<LoadState> load = weakLoad.lock();
+		if (!load)
+		{
+			if (p_ID >= 0)
 			{
-				InstanceBinaryLoader EBLoader;
-				EBLoader.loadBinaryFile(EBPath.string());
-				const InstanceBinaryLoader::ModelData& eb = EBLoader.getModelData()[0];
-				for(unsigned int k = 0; k < EBLoader.getModelData()[0].m_Translation.size(); k++)
-				{
-					ActorFactory::InstanceEdgeBox edge;
-					edge.halfsize = eb.m_Scale[k];
-					edge.halfsize = edge.halfsize * 0.5f;
-					edge.offsetPosition = eb.m_Translation[k];
-					edge.offsetRotation = eb.m_Rotation[k];
-					edges.push_back(edge);
-				}
+				resources->releaseResource(p_ID);
 			}
+			return;
 		}
 
-		for(unsigned int j = 0; j < model.m_Translation.size(); j++)
+		if (p_ID >= 0)
 		{
-			instModel.position = model.m_Translation[j];
-			instModel.rotation = model.m_Rotation[j];
-			instModel.scale = model.m_Scale[j];
+			load->resourceIDs.push_back(p_ID);
+		}
+		--load->numPending;
+	};
 
-			if (model.m_CollideAble)
+	// Stage 1: Load the models and bounding volumes on the resource loader
+	// threads and decode the edge files on the decode threads.
+	const std::vector<LevelBinaryView::ModelData>& levelData = levelLoader.getModelData();
+	m_Load->decoded.resize(levelData.size());
+	for (unsigned int i = 0; i < levelData.size(); i++)
+	{
+		const LevelBinaryView::ModelData& model = levelData[i];
+		const std::string meshName = LevelBinaryView::toString(model.m_MeshName);
+
+		++m_Load->numPending;
+		m_Resources->loadResourceAsync("model", meshName, resourceLoaded);
+
+		if (!model.m_CollideAble)
+		{
+			continue;
+		}
+
+		++m_Load->numPending;
+		m_Resources->loadResourceAsync("volume", meshName, resourceLoaded);
+
+		// The decoded slots are not resized again until the pool is joined
+		const boost::filesystem::path edgePath = collisionFolder/("EB_" + meshName + ".btxe");
+		DecodedModel* decoded = &m_Load->decoded[i];
+		std::atomic<unsigned int>* numDecoding = &m_Load->numDecoding;
+		++m_Load->numDecoding;
+		m_Load->decoders->push([=] ()
+		{
+			try
+			{
+				decoded->edges = loadEdgeBoxes(edgePath);
+			}
+			catch (...)
 			{
-				volumes[0].scale = model.m_Scale[j];
+				decoded->error = std::current_exception();
 			}
+			--*numDecoding;
+		});
+	}
 
-			p_ActorOut->addActor(m_ActorFactory->createInstanceActor(instModel, volumes, edges));
-		}
+	// Without decode threads the edge files are read here
+	if (m_Load->decoders->getNumThreads() == 0)
+	{
+		m_Load->decoders->runQueued();
 	}
-	
-	p_LevelData.seekg(0, p_LevelData.beg);
-		
+
+	--m_Load->numPending;
+
+	// Stage 2: Lights and effects do not depend on the loaded resources
+	// and are created while the loaders are busy.
 	Actor::ptr directionalActor;
 	Actor::ptr pointActor;
 	Actor::ptr spotActor;
@@ -107,17 +264,17 @@ bool Level::loadLevel(std::istream& p_LevelData, ActorList::ptr p_ActorOut)
 		p_ActorOut->addActor(spotActor);
 	}
 
-
 	Actor::ptr particleEffect;
 	for(const auto& effect : levelLoader.getEffectData())
 	{
+		const std::string effectName = LevelBinaryView::toString(effect.m_EffectName);
 		for(unsigned int i = 0; i < effect.m_Translation.size(); i++)
 		{
 			Vector3 position = Vector3(effect.m_Translation[i].x, effect.m_Translation[i].y, effect.m_Translation[i].z);
 			Vector3 rotation = Vector3(effect.m_Rotation[i].x, effect.m_Rotation[i].y, effect.m_Rotation[i].z);
-			particleEffect = m_ActorFactory->createParticles(position, effect.m_EffectName.c_str());
+			particleEffect = m_ActorFactory->createParticles(position, effectName);
 			Vector3 temp = Vector3(0,0,0);
-			if(effect.m_EffectName == "fire")
+			if(effectName == "fire")
 			{
 				m_EventManager->queueEvent(IEventData::Ptr(new Create3DSoundEventData("Fire", i, 10.0f, 50+i, true, true)));
 				m_EventManager->queueEvent(IEventData::Ptr(new Play3DSoundEventData(i, 50+i, effect.m_Translation[i], temp)));
@@ -130,6 +287,110 @@ bool Level::loadLevel(std::istream& p_LevelData, ActorList::ptr p_ActorOut)
 	return true;
 }
 
+void Level::onFrame()
+{
+	if (!isLoading() || m_Load->numPending > 0 || m_Load->numDecoding > 0)
+	{
+		return;
+	}
+
+	createInstances();
+}
+
+bool Level::isLoading() const
+{
+	return m_Load && !m_Load->created;
+}
+
+void Level::createInstances()
+{
+	// Stage 3: Create the instances. Levels converted with a spatial index are
+	// created cell by cell, so that neighbouring instances get neighbouring
+	// actors and bodies. The models and volumes are already loaded, so the
+	// actors only add references to them. The static bodies of all instances
+	// are added to the collision tree in a single pass at the end.
+	LoadState& load = *m_Load;
+	load.decoders.reset();
+	for (const auto& decoded : load.decoded)
+	{
+		if (decoded.error)
+		{
+			std::rethrow_exception(decoded.error);
+		}
+	}
+
+	struct PreparedModel
+	{
+		ActorFactory::InstanceModel instModel;
+		std::vector<ActorFactory::InstanceBoundingVolume> volumes;
+		std::vector<ActorFactory::InstanceEdgeBox> edges;
+		bool prepared;
+	};
+	const std::vector<LevelBinaryView::ModelData>& levelData = load.level->getModelData();
+	std::vector<PreparedModel> preparedModels(levelData.size());
+	for (auto& preparedModel : preparedModels)
+	{
+		preparedModel.prepared = false;
+	}
+
+	auto createInstance = [&] (unsigned int p_Model, unsigned int p_Instance) -> Actor::ptr
+	{
+		const LevelBinaryView::ModelData& model = levelData[p_Model];
+		PreparedModel& preparedModel = preparedModels[p_Model];
+		if (!preparedModel.prepared)
+		{
+			preparedModel.instModel.meshName = LevelBinaryView::toString(model.m_MeshName);
+			if (model.m_CollideAble)
+			{
+				ActorFactory::InstanceBoundingVolume volume;
+				volume.meshName = preparedModel.instModel.meshName;
+				preparedModel.volumes.push_back(volume);
+
+				preparedModel.edges.swap(load.decoded[p_Model].edges);
+			}
+			preparedModel.prepared = true;
+		}
+
+		preparedModel.instModel.position = model.m_Translation[p_Instance];
+		preparedModel.instModel.rotation = model.m_Rotation[p_Instance];
+		preparedModel.instModel.scale = model.m_Scale[p_Instance];
+
+		if (model.m_CollideAble)
+		{
+			preparedModel.volumes[0].scale = preparedModel.instModel.scale;
+		}
+
+		return m_ActorFactory->createInstanceActor(preparedModel.instModel, preparedModel.volumes, preparedModel.edges);
+	};
+
+	{
+		StaticBodyBatch bodyBatch(m_Physics);
+		if (load.level->hasSpatialIndex())
+		{
+			for (const auto& instance : load.level->getSpatialIndex().m_Instances)
+			{
+				load.actorOut->addActor(createInstance(instance.m_Model, instance.m_Instance));
+			}
+		}
+		else
+		{
+			for (unsigned int i = 0; i < levelData.size(); i++)
+			{
+				for (unsigned int j = 0; j < levelData[i].m_Translation.size(); j++)
+				{
+					load.actorOut->addActor(createInstance(i, j));
+				}
+			}
+		}
+	}
+
+	// The level data is not needed anymore, only the references are kept
+	load.created = true;
+	load.actorOut.reset();
+	load.level.reset();
+	std::vector<DecodedModel>().swap(load.decoded);
+}
+
 const Vector3 &Level::getStartPosition(void) const
 {
 	return m_StartPosition;
@@ -4,15 +4,28 @@
 #include "ActorList.h"
 #include "ResourceManager.h"
 #include "IEventManager.h"
+#include "LevelBinaryView.h"
+
+#include <IPhysics.h>
+
+#include <memory>
 
 class Level
 {
 private:
+	/**
+	 * The instances of a level waiting for their resources, and the references
+	 * that keep the resources loaded for as long as the level exists.
+	 */
+	struct LoadState;
+
 	ResourceManager* m_Resources;
 	ActorFactory* m_ActorFactory;
 	EventManager* m_EventManager;
+	IPhysics* m_Physics;
 	Vector3 m_StartPosition;
 	Vector3 m_GoalPosition;
+	std::shared_ptr<LoadState> m_Load;
 
 public:
 	/*
@@ -52,9 +65,12 @@ public:
 	 * Constructor
 	 *
 	 * @param p_Resources, Creates a reference to the main resource source. 
-	 * @param p_Physics, Creates a reference to the main physic source.
+	 * @param p_ActorFactory, the factory used to create the level actors.
+	 * @param p_EventManager, the event manager receiving level sound events.
+	 * @param p_Physics, Creates a reference to the main physic source, used to
+	 *			decode bounding volumes in parallel while the level loads.
 	 **/
-	Level(ResourceManager* p_Resources, ActorFactory* p_ActorFactory, EventManager* p_EventManager);
+	Level(ResourceManager* p_Resources, ActorFactory* p_ActorFactory, EventManager* p_EventManager, IPhysics* p_Physics);
 
 	/**
 	 * Destructor
@@ -67,10 +83,31 @@ public:
 	void releaseLevel();
 
 	/**
-	 * Loads a .txl file and send the information to Physics and Graphics, 
-	 * the collision map is also a .txl file but loads information about collision.
+	 * Starts loading a .btxl level without blocking, the edge boxes are read
+	 * from .btxe files with the same format.
+	 *
+	 * Lights and effects are created immediately. The models and bounding volumes
+	 * are loaded with ResourceManager::loadResourceAsync and the edge boxes are
+	 * decoded on a few threads owned by the load, the instances are created by
+	 * onFrame once all of them are done. The instances are placed straight from the
+	 * level data, so the view is kept until then.
 	 *
-	 * @param p_LevelFilePath the complete path to the environment .txl file.
+	 * @param p_LevelData a validated view of the level, mapped from a file or copied from a received buffer.
+	 * @param p_ActorOut the list receiving the created actors.
+	 */
+	bool loadLevel(std::shared_ptr<const LevelBinaryView> p_LevelData, ActorList::ptr p_ActorOut);
+
+	/**
+	 * Creates the instances of the level once its resources are loaded.
+	 * Should be called every frame while isLoading returns true.
 	 */
-	bool loadLevel(std::istream& p_LevelData, ActorList::ptr p_ActorOut);
+	void onFrame();
+
+	/**
+	 * @return true if the level has been started by loadLevel but its instances are not created yet
+	 */
+	bool isLoading() const;
+
+private:
+	void createInstances();
 };
\ No newline at end of file
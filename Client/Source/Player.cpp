@@ -33,6 +33,9 @@ Player::Player(void)
 	m_ElapsedTime = 0.f;
 	m_Landing = false;
 	m_StartElapsedTime = false;
+	m_HeadJoint = AnimationData::invalidHandle;
+	m_HeadBaseJoint = AnimationData::invalidHandle;
+	m_RightUpperArmJoint = AnimationData::invalidHandle;
 }
 
 Player::~Player(void)
@@ -46,11 +49,22 @@ void Player::initialize(IPhysics *p_Physics, INetwork *p_Network, std::weak_ptr<
 	m_Network = p_Network;
 	m_Actor = p_Actor;
 	setCurrentMana(0.f);
+	m_HeadJoint = AnimationData::invalidHandle;
+	m_HeadBaseJoint = AnimationData::invalidHandle;
+	m_RightUpperArmJoint = AnimationData::invalidHandle;
 
 	Actor::ptr strActor = m_Actor.lock();
 	if (strActor)
 	{
 		m_LastSafePosition = strActor->getPosition();
+
+		std::shared_ptr<AnimationInterface> comp = strActor->getComponent<AnimationInterface>(AnimationInterface::m_ComponentId).lock();
+		if (comp)
+		{
+			m_HeadJoint = comp->findJoint("Head");
+			m_HeadBaseJoint = comp->findJoint("HeadBase");
+			m_RightUpperArmJoint = comp->findJoint("R_UpperArm");
+		}
 	}
 }
 
@@ -506,7 +520,7 @@ XMFLOAT3 Player::getRightHandPosition() const
 		std::shared_ptr<AnimationInterface> comp = actor->getComponent<AnimationInterface>(AnimationInterface::m_ComponentId).lock();
 		if (comp)
 		{
-			return comp->getJointPos("R_UpperArm");
+			return comp->getJointPos(m_RightUpperArmJoint);
 		}
 	}
 
@@ -756,8 +770,8 @@ XMFLOAT3 Player::getUpVector()
 		std::shared_ptr<AnimationInterface> comp = actor->getComponent<AnimationInterface>(AnimationInterface::m_ComponentId).lock();
 		if (comp)
 		{
-			XMVECTOR headPos = Vector4ToXMVECTOR(&Vector4(comp->getJointPos("Head"), 0.0f));
-			XMVECTOR headBasePos = Vector4ToXMVECTOR(&Vector4(comp->getJointPos("HeadBase"), 0.0f));
+			XMVECTOR headPos = Vector4ToXMVECTOR(&Vector4(comp->getJointPos(m_HeadJoint), 0.0f));
+			XMVECTOR headBasePos = Vector4ToXMVECTOR(&Vector4(comp->getJointPos(m_HeadBaseJoint), 0.0f));
 
 			if(XMVector3LengthSq(headBasePos).m128_f32[1] > 0 && XMVector3LengthSq(headPos).m128_f32[1] > 0)
 			{
@@ -781,8 +795,8 @@ void Player::fixLookToHead()
 		std::shared_ptr<LookInterface> look = actor->getComponent<LookInterface>(LookInterface::m_ComponentId).lock();
 		if (comp && look)
 		{
-			XMVECTOR headPos = Vector4ToXMVECTOR(&Vector4(comp->getJointPos("Head"), 0.0f));
-			XMVECTOR headBasePos = Vector4ToXMVECTOR(&Vector4(comp->getJointPos("HeadBase"), 0.0f));
+			XMVECTOR headPos = Vector4ToXMVECTOR(&Vector4(comp->getJointPos(m_HeadJoint), 0.0f));
+			XMVECTOR headBasePos = Vector4ToXMVECTOR(&Vector4(comp->getJointPos(m_HeadBaseJoint), 0.0f));
 
 			if(XMVector3LengthSq(headBasePos).m128_f32[1] > 0 && XMVector3LengthSq(headPos).m128_f32[1] > 0)
 			{
@@ -1,5 +1,6 @@
 #pragma once
 #include "Actor.h"
+#include "AnimationData.h"
 #include "INetwork.h"
 #include "IPhysics.h"
 
@@ -11,6 +12,9 @@ private:
 	IPhysics *m_Physics;
 	INetwork *m_Network;
 	std::weak_ptr<Actor> m_Actor;
+	AnimationData::Handle m_HeadJoint;
+	AnimationData::Handle m_HeadBaseJoint;
+	AnimationData::Handle m_RightUpperArmJoint;
 
 	int m_JumpCount, m_JumpCountMax;
     float m_JumpTime, m_JumpTimeMax;
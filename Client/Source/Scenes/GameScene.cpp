@@ -49,8 +49,15 @@ bool GameScene::init(unsigned int p_SceneID, IGraphics *p_Graphics, ResourceMana
 	m_EventManager = p_EventManager;
 	
 	// Added from Skydome branch
-	m_SkyboxID = m_ResourceManager->loadResource("texture","SKYBOXDDS");
-	m_Graphics->createSkydome("SKYBOXDDS",50000.f);
+	m_SkyboxID = -1;
+	m_ResourceManager->loadResourceAsync("texture", "SKYBOXDDS", [this] (int p_ID)
+	{
+		m_SkyboxID = p_ID;
+		if (p_ID >= 0)
+		{
+			m_Graphics->createSkydome("SKYBOXDDS", 50000.f);
+		}
+	});
 
 	m_EventManager->addListener(EventListenerDelegate(this, &GameScene::addLight), LightEventData::sk_EventType);
 	m_EventManager->addListener(EventListenerDelegate(this, &GameScene::removeLight), RemoveLightEventData::sk_EventType);
@@ -100,7 +107,10 @@ bool GameScene::init(unsigned int p_SceneID, IGraphics *p_Graphics, ResourceMana
 void GameScene::destroy()
 {
 	releasePreLoadedModels();
-	m_ResourceManager->releaseResource(m_SkyboxID);
+	if (m_SkyboxID >= 0)
+	{
+		m_ResourceManager->releaseResource(m_SkyboxID);
+	}
 }
 
 void GameScene::onFrame(float p_DeltaTime, int* p_IsCurrentScene)
@@ -214,10 +224,7 @@ void GameScene::render()
 
 	m_Graphics->updateCamera(playerPos, playerForward, playerUp);
 
-	for (auto& mesh : m_Models)
-	{
-		m_Graphics->renderModel(mesh.modelId);
-	}
+	m_Graphics->renderModels();
 
 	if(m_RenderDebugBV)
 	{
@@ -524,12 +531,25 @@ void GameScene::updateModelScale(IEventData::Ptr p_Data)
 void GameScene::updateAnimation(IEventData::Ptr p_Data)
 {
 	std::shared_ptr<UpdateAnimationEventData> animationData = std::static_pointer_cast<UpdateAnimationEventData>(p_Data);
+
+	// Queued before the animation was released, its pose and animation data are gone
+	std::shared_ptr<const DirectX::XMFLOAT4X4* const> poseSource = animationData->getPoseSource();
+	if(animationData->hasPoseSource() && !poseSource)
+		return;
+
 	for(auto &model : m_Models)
 	{
 		if(model.meshId == animationData->getId())
 		{
 			const std::vector<DirectX::XMFLOAT4X4>& animation = animationData->getAnimationData();
-			m_Graphics->animationPose(model.modelId, animation.data(), animation.size());
+			if(poseSource)
+			{
+				m_Graphics->setAnimationPoseSource(model.modelId, poseSource.get(), animation.size());
+			}
+			else
+			{
+				m_Graphics->animationPose(model.modelId, animation.data(), animation.size());
+			}
 
 			if( m_DebugAnimations )
 			{
@@ -790,8 +810,15 @@ void GameScene::renderBoundingVolume(BodyHandle p_BodyHandle)
 void GameScene::preLoadModels()
 {
 	//DO NOT MAKE ANY CALLS TO GRAPHICS IN HERE!
-	m_ResourceIDs.push_back(m_ResourceManager->loadResource("particleSystem", "TestParticle"));
-	m_ResourceIDs.push_back(m_ResourceManager->loadResource("model", "Pivot1"));
+	const ResourceManager::LoadedCallback keepLoaded = [this] (int p_ID)
+	{
+		if (p_ID >= 0)
+		{
+			m_ResourceIDs.push_back(p_ID);
+		}
+	};
+	m_ResourceManager->loadResourceAsync("particleSystem", "TestParticle", keepLoaded);
+	m_ResourceManager->loadResourceAsync("model", "Pivot1", keepLoaded);
 
 }
 
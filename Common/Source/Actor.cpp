@@ -14,16 +14,24 @@ Actor::~Actor()
 
 void Actor::initialize(const tinyxml2::XMLElement* p_Data)
 {
-	m_Position = Vector3(0.f, 0.f, 0.f);
-	m_Rotation = Vector3(0.f, 0.f, 0.f);
+	Vector3 position(0.f, 0.f, 0.f);
+	Vector3 rotation(0.f, 0.f, 0.f);
 
-	p_Data->QueryAttribute("x", &m_Position.x);
-	p_Data->QueryAttribute("y", &m_Position.y);
-	p_Data->QueryAttribute("z", &m_Position.z);
+	p_Data->QueryAttribute("x", &position.x);
+	p_Data->QueryAttribute("y", &position.y);
+	p_Data->QueryAttribute("z", &position.z);
 
-	p_Data->QueryAttribute("yaw", &m_Rotation.x);
-	p_Data->QueryAttribute("pitch", &m_Rotation.y);
-	p_Data->QueryAttribute("roll", &m_Rotation.z);
+	p_Data->QueryAttribute("yaw", &rotation.x);
+	p_Data->QueryAttribute("pitch", &rotation.y);
+	p_Data->QueryAttribute("roll", &rotation.z);
+
+	initialize(position, rotation);
+}
+
+void Actor::initialize(Vector3 p_Position, Vector3 p_Rotation)
+{
+	m_Position = p_Position;
+	m_Rotation = p_Rotation;
 }
 
 void Actor::postInit()
@@ -53,6 +53,13 @@ public:
 	 * @param p_Data XML data to read attributes from
 	 */
 	void initialize(const tinyxml2::XMLElement* p_Data);
+	/**
+	 * Initialize the actor with any non-component data.
+	 *
+	 * @param p_Position the initial position of the actor in world space (cm)
+	 * @param p_Rotation the initial rotation of the actor as (yaw, pitch, roll) in radians
+	 */
+	void initialize(Vector3 p_Position, Vector3 p_Rotation);
 	/**
 	 * Finish any initialization that must be done after
 	 * the actor has been assembled.
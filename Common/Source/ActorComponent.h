@@ -13,6 +13,10 @@ class ActorComponent
 {
 protected:
 	Actor* m_Owner;
+	/**
+	 * Set for the components of cached instance prototypes, which are only copied and never added to an actor.
+	 */
+	bool m_IsPrototype;
 
 public:
 	/**
@@ -24,6 +28,25 @@ public:
 	 */
 	typedef unsigned int Id;
 
+	/**
+	 * constructor, the component has no owner until it is added to an actor.
+	 */
+	ActorComponent() : m_Owner(nullptr), m_IsPrototype(false) {}
+
+	/**
+	 * copy constructor, the copy of a prototype is a regular component without an owner.
+	 */
+	ActorComponent(const ActorComponent&) : m_Owner(nullptr), m_IsPrototype(false) {}
+
+	/**
+	 * Mark the component as an instance prototype, which releases nothing when destroyed
+	 * since it is never added to an actor. Has to be called before the component is initialized.
+	 */
+	void markPrototype()
+	{
+		m_IsPrototype = true;
+	}
+
 	/**
 	 * destructor.
 	 */
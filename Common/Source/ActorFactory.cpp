@@ -11,6 +11,8 @@
 #include "PlayerBodyComponent.h"
 #include "XMLHelper.h"
 
+#include <algorithm>
+
 ActorFactory::ActorFactory(unsigned int p_BaseActorId)
 	:	m_LastActorId(p_BaseActorId),
 		m_LastModelComponentId(0),
@@ -19,6 +21,8 @@ ActorFactory::ActorFactory(unsigned int p_BaseActorId)
 		m_LastSpellComponentId(0),
 		m_LastTextComponentId(0),
 		m_Physics(nullptr),
+		m_AnimationLOD(nullptr),
+		m_AnimationJobs(nullptr),
 		m_SpellFactory(nullptr)
 {
 	m_ComponentCreators["PlayerPhysics"] = std::bind(&ActorFactory::createPlayerComponent, this);
@@ -63,6 +67,16 @@ void ActorFactory::setAnimationLoader(AnimationLoader* p_AnimationLoader)
 	m_AnimationLoader = p_AnimationLoader;
 }
 
+void ActorFactory::setAnimationLOD(AnimationLOD* p_AnimationLOD)
+{
+	m_AnimationLOD = p_AnimationLOD;
+}
+
+void ActorFactory::setAnimationJobs(AnimationJobSystem* p_AnimationJobs)
+{
+	m_AnimationJobs = p_AnimationJobs;
+}
+
 void ActorFactory::setSpellFactory(SpellFactory* p_SpellFactory)
 {
 	m_SpellFactory = p_SpellFactory;
@@ -116,6 +130,84 @@ void addEdge(tinyxml2::XMLPrinter& p_Printer, Vector3 p_Position, Vector3 p_Half
 	p_Printer.CloseElement();
 }
 
+static OBB_Component::Description createEdgeDescription(const ActorFactory::InstanceEdgeBox& p_Edge, Vector3 p_Scale)
+{
+	using namespace DirectX;
+
+	XMFLOAT3 position = p_Edge.offsetPosition;
+	XMFLOAT3 rotation = p_Edge.offsetRotation;
+	XMFLOAT3 halfSize = p_Edge.halfsize;
+
+	if(p_Scale.x == p_Scale.y && p_Scale.x == p_Scale.z)
+	{
+		halfSize = p_Edge.halfsize * p_Scale.x;
+		position = p_Edge.offsetPosition * p_Scale.x;
+	}
+	else
+	{
+		XMMATRIX rotMat , scalMat;
+		rotMat = XMMatrixRotationRollPitchYaw(rotation.y, rotation.x, rotation.z);
+		scalMat = XMMatrixScalingFromVector(XMLoadFloat3(&p_Scale));
+
+		float offsetValue = halfSize.x;
+		int index = 0;
+		float sideValue = halfSize.y;
+		if(halfSize.x < halfSize.y)
+		{
+			offsetValue = halfSize.y;
+			sideValue = halfSize.x;
+			index = 1;
+		}
+		if(offsetValue < halfSize.z)
+		{
+			offsetValue = halfSize.z;
+			index = 2;
+		}
+
+		XMVECTOR sizeVector = XMVectorZero();
+		sizeVector.m128_f32[index] = offsetValue;
+
+		sizeVector = XMVector3Transform(sizeVector, rotMat);
+
+		XMVECTOR pos1, pos2;
+		XMVECTOR centerPos = XMLoadFloat3(&position);
+		centerPos.m128_f32[3] = 1.0f;
+		pos1 = centerPos + sizeVector;
+		pos2 = centerPos - sizeVector;
+
+		pos1 = XMVector3Transform(pos1, scalMat);
+		pos2 = XMVector3Transform(pos2, scalMat);
+
+		centerPos = (pos1 + pos2) * 0.5f;
+
+		XMStoreFloat3(&position, centerPos);
+
+		XMVECTOR dirVector = pos1 - centerPos;
+
+		float length = XMVector3Length(dirVector).m128_f32[0];
+
+		halfSize.x = length;
+		halfSize.y = sideValue;
+		halfSize.z = sideValue;
+
+		XMFLOAT3 direction; 
+		XMStoreFloat3(&direction,dirVector);
+		rotation.x = -atan2f(direction.z, direction.x);
+		rotation.y = 0;
+		rotation.z = asinf(direction.y / length);
+	}
+
+	OBB_Component::Description edge;
+	edge.immovable = true;
+	edge.mass = 0.f;
+	edge.isEdge = true;
+	edge.halfsize = halfSize;
+	edge.offsetPosition = position;
+	edge.offsetRotation = rotation;
+
+	return edge;
+}
+
 Actor::ptr ActorFactory::createCheckPointActor(Vector3 p_Position, Vector3 p_Scale, float p_StartTime)
 {
 	Vector3 AABBScale = p_Scale;
@@ -123,41 +215,34 @@ Actor::ptr ActorFactory::createCheckPointActor(Vector3 p_Position, Vector3 p_Sca
 	AABBScale.y *= 2.f;
 	AABBScale.z *= 1.66f;
 
-	tinyxml2::XMLPrinter printer;
-	printer.OpenElement("Object");
-	pushVector(printer, p_Position);
-
-	printer.OpenElement("Model");
-	printer.PushAttribute("Mesh", "Checkpoint1");
-	pushVector(printer, "Scale", Vector3(0.8f, 0.8f, 0.8f));
-	pushVector(printer, "OffsetPosition", Vector3(0,200,0));
-	printer.CloseElement();
+	Actor::ptr actor = createEmptyActor(p_Position, Vector3(0.f, 0.f, 0.f));
 
-	printer.OpenElement("ModelSinOffset");
-	printer.PushAttribute("StartTime", p_StartTime);
-	pushVector(printer, "Offset", Vector3(0, 50, 0));
-	printer.CloseElement();
+	ModelComponent::Description model;
+	model.meshName = "Checkpoint1";
+	model.scale = Vector3(0.8f, 0.8f, 0.8f);
+	model.offsetPosition = Vector3(0.f, 200.f, 0.f);
+	addComponent<ModelComponent>(actor, createModelComponent(), model);
 
-	printer.OpenElement("Movement");
-	pushVector(printer, "RotationalVelocity",Vector3(1.57f,0.f,0.f));
-	printer.CloseElement();
+	ModelSinOffsetComponent::Description sinOffset;
+	sinOffset.startTime = p_StartTime;
+	sinOffset.offset = Vector3(0.f, 50.f, 0.f);
+	addComponent<ModelSinOffsetComponent>(actor, createModelSinOffsetComponent(), sinOffset);
 
-	printer.OpenElement("AABBPhysics");
-	printer.PushAttribute("CollisionResponse", false);
-	pushVector(printer, "Halfsize", AABBScale);
-	pushVector(printer, "OffsetPosition", Vector3(0.0f, AABBScale.y, 0.0f));
-	printer.CloseElement();
+	MovementComponent::Description movement;
+	movement.rotationalVelocity = Vector3(1.57f, 0.f, 0.f);
+	addComponent<MovementComponent>(actor, createMovementComponent(), movement);
 
-	printer.OpenElement("Particle");
-	printer.PushAttribute("Effect", "checkpointSwirl");
-	printer.CloseElement();
-
-	printer.CloseElement();
+	AABB_Component::Description aabb;
+	aabb.collisionResponse = false;
+	aabb.halfsize = AABBScale;
+	aabb.offsetPosition = Vector3(0.f, AABBScale.y, 0.f);
+	addComponent<AABB_Component>(actor, createAABBComponent(), aabb);
 
-	tinyxml2::XMLDocument doc;
-	doc.Parse(printer.CStr());
+	ParticleComponent::Description particle;
+	particle.effectName = "checkpointSwirl";
+	addComponent<ParticleComponent>(actor, createParticleComponent(), particle);
 
-	Actor::ptr actor = createActor(doc.FirstChildElement("Object"));
+	actor->postInit();
 
 	return actor;
 }
@@ -227,104 +312,59 @@ Actor::ptr ActorFactory::createPlayerActor(Vector3 p_Position, std::string p_Use
 
 Actor::ptr ActorFactory::createDirectionalLight(Vector3 p_Direction, Vector3 p_Color, float p_Intensity)
 {
-	tinyxml2::XMLPrinter printer;
-	printer.OpenElement("Object");
-	printer.OpenElement("Light");
-	printer.PushAttribute("Type", "Directional");
-	pushVector(printer, "Direction", p_Direction);
-	printer.OpenElement("Intensity");
-	printer.PushAttribute("Intensity", p_Intensity);
-	printer.CloseElement();
-	pushColor(printer, "Color", p_Color);
-	printer.CloseElement();
-	printer.CloseElement();
-
-	tinyxml2::XMLDocument doc;
-	doc.Parse(printer.CStr());
-
-	Actor::ptr actor = createActor(doc.FirstChildElement("Object"));
+	Actor::ptr actor = createEmptyActor(Vector3(0.f, 0.f, 0.f), Vector3(0.f, 0.f, 0.f));
+	addComponent<LightComponent>(actor, createLightComponent(),
+		LightClass::createDirectionalLight(p_Direction, p_Color, p_Intensity));
+	actor->postInit();
 
 	return actor;
 }
 
 Actor::ptr ActorFactory::createSpotLight(Vector3 p_Position, Vector3 p_Direction, Vector2 p_MinMaxAngles, float p_Range, Vector3 p_Color)
 {
-	tinyxml2::XMLPrinter printer;
-	printer.OpenElement("Object");
-	pushVector(printer, p_Position);
-	printer.OpenElement("Light");
-	printer.PushAttribute("Type", "Spot");
-	printer.PushAttribute("Range", p_Range);
-	pushVector(printer, "Position", p_Position);
-	pushVector(printer, "Direction", p_Direction);
-	printer.OpenElement("Angles");
-	printer.PushAttribute("min", p_MinMaxAngles.x);
-	printer.PushAttribute("max", p_MinMaxAngles.y);
-	printer.CloseElement();
-	pushColor(printer, "Color", p_Color);
-	printer.CloseElement();
-	printer.CloseElement();
-
-	tinyxml2::XMLDocument doc;
-	doc.Parse(printer.CStr());
-
-	Actor::ptr actor = createActor(doc.FirstChildElement("Object"));
+	Actor::ptr actor = createEmptyActor(p_Position, Vector3(0.f, 0.f, 0.f));
+	addComponent<LightComponent>(actor, createLightComponent(),
+		LightClass::createSpotLight(p_Position, p_Direction, p_MinMaxAngles, p_Range, p_Color));
+	actor->postInit();
 
 	return actor;
 }
 
 Actor::ptr ActorFactory::createPointLight(Vector3 p_Position, float p_Range, Vector3 p_Color)
 {
-	tinyxml2::XMLPrinter printer;
-	printer.OpenElement("Object");
-	pushVector(printer, p_Position);
-	printer.OpenElement("Light");
-	printer.PushAttribute("Type", "Point");
-	printer.PushAttribute("Range", p_Range);
-	pushVector(printer, "Position", p_Position);
-	pushColor(printer, "Color", p_Color);
-	printer.CloseElement();
-	printer.CloseElement();
-
-	tinyxml2::XMLDocument doc;
-	doc.Parse(printer.CStr());
-
-	Actor::ptr actor = createActor(doc.FirstChildElement("Object"));
+	Actor::ptr actor = createEmptyActor(p_Position, Vector3(0.f, 0.f, 0.f));
+	addComponent<LightComponent>(actor, createLightComponent(),
+		LightClass::createPointLight(p_Position, p_Range, p_Color));
+	actor->postInit();
 
 	return actor;
 }
 
 Actor::ptr ActorFactory::createParticles( Vector3 p_Position, const std::string& p_Effect )
 {
-	tinyxml2::XMLPrinter printer;
-	printer.OpenElement("Object");
-	pushVector(printer, p_Position);
-	printer.OpenElement("Particle");
-	printer.PushAttribute("Effect", p_Effect.c_str());
-	printer.CloseElement();
-	printer.CloseElement();
+	Actor::ptr actor = createEmptyActor(p_Position, Vector3(0.f, 0.f, 0.f));
 
-	tinyxml2::XMLDocument doc;
-	doc.Parse(printer.CStr());
+	ParticleComponent::Description particle;
+	particle.effectName = p_Effect;
+	addComponent<ParticleComponent>(actor, createParticleComponent(), particle);
 
-	return createActor(doc.FirstChildElement("Object"));
+	actor->postInit();
+
+	return actor;
 }
 
 Actor::ptr ActorFactory::createParticles( Vector3 p_Position, const std::string& p_Effect, Vector4 p_BaseColor )
 {
-	tinyxml2::XMLPrinter printer;
-	printer.OpenElement("Object");
-	pushVector(printer, p_Position);
-	printer.OpenElement("Particle");
-	printer.PushAttribute("Effect", p_Effect.c_str());
-	pushColor(printer, "BaseColor", p_BaseColor);
-	printer.CloseElement();
-	printer.CloseElement();
+	Actor::ptr actor = createEmptyActor(p_Position, Vector3(0.f, 0.f, 0.f));
 
-	tinyxml2::XMLDocument doc;
-	doc.Parse(printer.CStr());
+	ParticleComponent::Description particle;
+	particle.effectName = p_Effect;
+	particle.baseColor = p_BaseColor;
+	addComponent<ParticleComponent>(actor, createParticleComponent(), particle);
 
-	return createActor(doc.FirstChildElement("Object"));
+	actor->postInit();
+
+	return actor;
 }
 
 Actor::ptr ActorFactory::createFlyingCamera(Vector3 p_Position)
@@ -381,70 +421,153 @@ Actor::ptr ActorFactory::createSplineCamera(Vector3 p_Position)
 	return actor;
 }
 
+static bool isSameVolume(const ActorFactory::InstanceBoundingVolume& p_Left, const ActorFactory::InstanceBoundingVolume& p_Right)
+{
+	return p_Left.meshName == p_Right.meshName
+		&& p_Left.scale == p_Right.scale;
+}
+
+static bool isSameEdge(const ActorFactory::InstanceEdgeBox& p_Left, const ActorFactory::InstanceEdgeBox& p_Right)
+{
+	return p_Left.halfsize == p_Right.halfsize
+		&& p_Left.offsetPosition == p_Right.offsetPosition
+		&& p_Left.offsetRotation == p_Right.offsetRotation;
+}
+
 Actor::ptr ActorFactory::createInstanceActor(
 		const InstanceModel& p_Model,
 		const std::vector<InstanceBoundingVolume>& p_BoundingVolumes,
 		const std::vector<InstanceEdgeBox>& p_Edges)
 {
-	tinyxml2::XMLPrinter printer;
-	printer.OpenElement("Object");
-	pushVector(printer, p_Model.position);
-	pushRotation(printer, p_Model.rotation);
-	print(printer, p_Model);
+	InstancePrototype* prototype = findInstancePrototype(p_Model, p_BoundingVolumes, p_Edges);
+	if (prototype)
+	{
+		return cloneInstanceActor(*prototype, p_Model.position, p_Model.rotation);
+	}
+
+	InstancePrototype newPrototype;
+	newPrototype.scale = p_Model.scale;
+	newPrototype.sourceVolumes = p_BoundingVolumes;
+	newPrototype.sourceEdges = p_Edges;
+
+	ModelComponent::Description model;
+	model.meshName = p_Model.meshName;
+	model.scale = p_Model.scale;
+	newPrototype.model = std::static_pointer_cast<ModelComponent>(createModelComponent());
+	newPrototype.model->markPrototype();
+	newPrototype.model->initialize(model);
+
 	for (const auto& volume : p_BoundingVolumes)
 	{
-		print(printer, volume);
+		BoundingMeshComponent::Description mesh;
+		mesh.meshName = volume.meshName;
+		mesh.scale = volume.scale;
+		std::shared_ptr<BoundingMeshComponent> component =
+			std::static_pointer_cast<BoundingMeshComponent>(createBoundingMeshComponent());
+		component->markPrototype();
+		component->initialize(mesh);
+		newPrototype.volumes.push_back(component);
 	}
 	for (const auto& edge : p_Edges)
 	{
-		print(printer, edge, p_Model.scale);
+		std::shared_ptr<OBB_Component> component = std::static_pointer_cast<OBB_Component>(createOBBComponent());
+		component->markPrototype();
+		component->initialize(createEdgeDescription(edge, p_Model.scale));
+		newPrototype.edges.push_back(component);
 	}
-	printer.CloseElement();
 
-	tinyxml2::XMLDocument doc;
-	doc.Parse(printer.CStr());
+	std::vector<InstancePrototype>& variants = m_InstancePrototypes[p_Model.meshName];
+	variants.push_back(newPrototype);
 
-	Actor::ptr actor = createActor(doc.FirstChildElement("Object"));
+	return cloneInstanceActor(variants.back(), p_Model.position, p_Model.rotation);
+}
+
+void ActorFactory::clearInstancePrototypes()
+{
+	m_InstancePrototypes.clear();
+}
+
+unsigned int ActorFactory::getNumInstancePrototypes() const
+{
+	unsigned int count = 0;
+	for (const auto& variants : m_InstancePrototypes)
+	{
+		count += variants.second.size();
+	}
+
+	return count;
+}
+
+ActorFactory::InstancePrototype* ActorFactory::findInstancePrototype(const InstanceModel& p_Model,
+	const std::vector<InstanceBoundingVolume>& p_BoundingVolumes,
+	const std::vector<InstanceEdgeBox>& p_Edges)
+{
+	auto findIt = m_InstancePrototypes.find(p_Model.meshName);
+	if (findIt == m_InstancePrototypes.end())
+	{
+		return nullptr;
+	}
+
+	for (auto& prototype : findIt->second)
+	{
+		if (prototype.scale == p_Model.scale
+			&& prototype.sourceVolumes.size() == p_BoundingVolumes.size()
+			&& prototype.sourceEdges.size() == p_Edges.size()
+			&& std::equal(p_BoundingVolumes.begin(), p_BoundingVolumes.end(), prototype.sourceVolumes.begin(), isSameVolume)
+			&& std::equal(p_Edges.begin(), p_Edges.end(), prototype.sourceEdges.begin(), isSameEdge))
+		{
+			return &prototype;
+		}
+	}
+
+	return nullptr;
+}
+
+Actor::ptr ActorFactory::cloneInstanceActor(const InstancePrototype& p_Prototype, Vector3 p_Position, Vector3 p_Rotation)
+{
+	Actor::ptr actor = createEmptyActor(p_Position, p_Rotation);
+
+	// The components are copies of the prototype, only the model needs its own id
+	ModelComponent* model = new ModelComponent(*p_Prototype.model);
+	model->setId(++m_LastModelComponentId);
+	attachComponent(actor, ActorComponent::ptr(model));
+
+	for (const auto& volume : p_Prototype.volumes)
+	{
+		attachComponent(actor, ActorComponent::ptr(new BoundingMeshComponent(*volume)));
+	}
+	for (const auto& edge : p_Prototype.edges)
+	{
+		attachComponent(actor, ActorComponent::ptr(new OBB_Component(*edge)));
+	}
+
+	actor->postInit();
 
 	return actor;
 }
 
 Actor::ptr ActorFactory::createSpell(const std::string& p_Spell, Actor::Id p_CasterId, Vector3 p_Direction, Vector3 p_StartPosition)
 {
-	tinyxml2::XMLPrinter printer;
-	printer.OpenElement("Object");
-	pushVector(printer, p_StartPosition);
+	Actor::ptr actor = createEmptyActor(p_StartPosition, Vector3(0.f, 0.f, 0.f));
 
-	printer.OpenElement("Model");
-	printer.PushAttribute("Mesh", "ExplosionSphere1");
-	pushVector(printer, "Scale", Vector3(0.02f, 0.02f, 0.02f));
-	printer.CloseElement();
+	ModelComponent::Description model;
+	model.meshName = "ExplosionSphere1";
+	model.scale = Vector3(0.02f, 0.02f, 0.02f);
+	addComponent<ModelComponent>(actor, createModelComponent(), model);
 
-	printer.OpenElement("Spell");
-	printer.PushAttribute("SpellName", p_Spell.c_str());
-	printer.PushAttribute("CasterId", p_CasterId);
-	pushVector(printer, "Direction", p_Direction);
-	printer.CloseElement();
-	printer.OpenElement("Particle");
-	printer.PushAttribute("Effect", "magic");
-	printer.CloseElement();
-	printer.OpenElement("Particle");
-	printer.PushAttribute("Effect", "magicProjectile");
-	printer.CloseElement();
-	//printer.OpenElement("Sound");
-	//printer.PushAttribute("FileName", "InAir");
-	//printer.PushAttribute("SoundID", 10);
-	//printer.PushAttribute("MultiD", 1);
-	//printer.PushAttribute("Loop", 1);
-	//printer.PushAttribute("MinDistance", 50.0f);
-	//pushVector(printer, "Velocity", Vector3(0,0,0));
-	//printer.CloseElement();
-	printer.CloseElement();
+	SpellComponent::Description spell;
+	spell.spellName = p_Spell;
+	spell.casterId = p_CasterId;
+	spell.direction = p_Direction;
+	addComponent<SpellComponent>(actor, createSpellComponent(), spell);
 
-	tinyxml2::XMLDocument doc;
-	doc.Parse(printer.CStr());
+	ParticleComponent::Description particle;
+	particle.effectName = "magic";
+	addComponent<ParticleComponent>(actor, createParticleComponent(), particle);
+	particle.effectName = "magicProjectile";
+	addComponent<ParticleComponent>(actor, createParticleComponent(), particle);
 
-	Actor::ptr actor = createActor(doc.FirstChildElement("Object"));
+	actor->postInit();
 
 	return actor;
 }
@@ -479,6 +602,14 @@ unsigned int ActorFactory::getNextActorId()
 	return ++m_LastActorId;
 }
 
+Actor::ptr ActorFactory::createEmptyActor(Vector3 p_Position, Vector3 p_Rotation)
+{
+	Actor::ptr actor(new Actor(getNextActorId(), m_EventManager, m_ActorList));
+	actor->initialize(p_Position, p_Rotation);
+
+	return actor;
+}
+
 ActorComponent::ptr ActorFactory::createPlayerComponent()
 {
 	PlayerBodyComponent* comp = new PlayerBodyComponent;
@@ -589,6 +720,8 @@ ActorComponent::ptr ActorFactory::createHumanAnimationComponent()
 	HumanAnimationComponent* comp = new HumanAnimationComponent;
 	comp->setResourceManager(m_ResourceManager);
 	comp->setAnimationLoader(m_AnimationLoader);
+	comp->setAnimationLOD(m_AnimationLOD);
+	comp->setAnimationJobs(m_AnimationJobs);
 	comp->setPhysics(m_Physics);
 
 	return ActorComponent::ptr(comp);
@@ -624,97 +757,3 @@ ActorComponent::ptr ActorFactory::createTextComponent()
 	comp->setId(++m_LastTextComponentId);
 	return ActorComponent::ptr(comp);
 }
-
-void ActorFactory::print(tinyxml2::XMLPrinter& p_Printer, const InstanceModel& p_Model)
-{
-	p_Printer.OpenElement("Model");
-	p_Printer.PushAttribute("Mesh", p_Model.meshName.c_str());
-	pushVector(p_Printer, "Scale", p_Model.scale);
-	p_Printer.CloseElement();
-}
-
-void ActorFactory::print(tinyxml2::XMLPrinter& p_Printer, const InstanceBoundingVolume& p_Volume)
-{
-	p_Printer.OpenElement("MeshPhysics");
-	p_Printer.PushAttribute("Mesh", p_Volume.meshName.c_str());
-	pushVector(p_Printer, "Scale", p_Volume.scale);
-	p_Printer.CloseElement();
-}
-
-void ActorFactory::print(tinyxml2::XMLPrinter& p_Printer, const InstanceEdgeBox& p_Edge, Vector3 p_Scale)
-{
-	p_Printer.OpenElement("OBBPhysics");
-	p_Printer.PushAttribute("Immovable", true);
-	p_Printer.PushAttribute("Mass", 0.f);
-	p_Printer.PushAttribute("IsEdge", true);
-
-	using namespace DirectX;
-
-	XMFLOAT3 position = p_Edge.offsetPosition;
-	XMFLOAT3 rotation = p_Edge.offsetRotation;
-	XMFLOAT3 halfSize = p_Edge.halfsize;
-
-	if(p_Scale.x == p_Scale.y && p_Scale.x == p_Scale.z)
-	{
-		halfSize = p_Edge.halfsize * p_Scale.x;
-		position = p_Edge.offsetPosition * p_Scale.x;
-	}
-	else
-	{
-		XMMATRIX rotMat , scalMat;
-		rotMat = XMMatrixRotationRollPitchYaw(rotation.y, rotation.x, rotation.z);
-		scalMat = XMMatrixScalingFromVector(XMLoadFloat3(&p_Scale));
-
-		float offsetValue = halfSize.x;
-		int index = 0;
-		float sideValue = halfSize.y;
-		if(halfSize.x < halfSize.y)
-		{
-			offsetValue = halfSize.y;
-			sideValue = halfSize.x;
-			index = 1;
-		}
-		if(offsetValue < halfSize.z)
-		{
-			offsetValue = halfSize.z;
-			index = 2;
-		}
-
-		XMVECTOR sizeVector = XMVectorZero();
-		sizeVector.m128_f32[index] = offsetValue;
-
-		sizeVector = XMVector3Transform(sizeVector, rotMat);
-
-		XMVECTOR pos1, pos2;
-		XMVECTOR centerPos = XMLoadFloat3(&position);
-		centerPos.m128_f32[3] = 1.0f;
-		pos1 = centerPos + sizeVector;
-		pos2 = centerPos - sizeVector;
-
-		pos1 = XMVector3Transform(pos1, scalMat);
-		pos2 = XMVector3Transform(pos2, scalMat);
-
-		centerPos = (pos1 + pos2) * 0.5f;
-
-		XMStoreFloat3(&position, centerPos);
-
-		XMVECTOR dirVector = pos1 - centerPos;
-
-		float length = XMVector3Length(dirVector).m128_f32[0];
-
-		halfSize.x = length;
-		halfSize.y = sideValue;
-		halfSize.z = sideValue;
-
-		XMFLOAT3 direction; 
-		XMStoreFloat3(&direction,dirVector);
-		rotation.x = -atan2f(direction.z, direction.x);
-		rotation.y = 0;
-		rotation.z = asinf(direction.y / length);
-	}
-
-	pushVector(p_Printer, "Halfsize", halfSize);
-	pushVector(p_Printer, "OffsetPosition", position);
-	pushRotation(p_Printer, "OffsetRotation", rotation);
-	p_Printer.CloseElement();
-}
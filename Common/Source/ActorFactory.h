@@ -2,7 +2,10 @@
 
 #include "Actor.h"
 #include "ActorList.h"
+#include "AnimationJobSystem.h"
 #include "AnimationLoader.h"
+#include "AnimationLOD.h"
+#include "Components.h"
 #include "ResourceManager.h"
 #include "SpellFactory.h"
 
@@ -32,6 +35,8 @@ private:
 	EventManager* m_EventManager;
 	ResourceManager* m_ResourceManager;
 	AnimationLoader* m_AnimationLoader;
+	AnimationLOD* m_AnimationLOD;
+	AnimationJobSystem* m_AnimationJobs;
 	SpellFactory* m_SpellFactory;
 	std::weak_ptr<ActorList> m_ActorList;
 
@@ -73,6 +78,20 @@ public:
 
 	void setAnimationLoader(AnimationLoader* p_AnimationLoader);
 
+	/**
+	 * Set the level of detail manager given to new animated actors. Optional.
+	 *
+	 * @param p_AnimationLOD the manager to use, or nullptr to always animate at full detail
+	 */
+	void setAnimationLOD(AnimationLOD* p_AnimationLOD);
+
+	/**
+	 * Set the job system that evaluates the poses of new animated actors. Optional.
+	 *
+	 * @param p_AnimationJobs the job system to use, or nullptr to evaluate each actor in its own update
+	 */
+	void setAnimationJobs(AnimationJobSystem* p_AnimationJobs);
+
 	void setSpellFactory(SpellFactory* p_SpellFactory);
 	SpellFactory* getSpellFactory();
 
@@ -123,11 +142,34 @@ public:
 		Vector3 offsetRotation;
 		Vector3 halfsize;
 	};
+	/**
+	 * Create a static level instance. The first instance of each combination of
+	 * mesh, scale, volumes and edges is fully built and kept as a prototype,
+	 * later instances are cloned from it and only differ in transform and id.
+	 *
+	 * @param p_Model the mesh and transform of the instance
+	 * @param p_BoundingVolumes collision meshes for the instance, scaled with the model
+	 * @param p_Edges climbable edge boxes in model space
+	 * @return a fully initialized actor
+	 */
 	Actor::ptr createInstanceActor(
 		const InstanceModel& p_Model,
 		const std::vector<InstanceBoundingVolume>& p_BoundingVolumes,
 		const std::vector<InstanceEdgeBox>& p_Edges);
 
+	/**
+	 * Forget all cached instance prototypes, for example when a new level is loaded.
+	 * Releases the bounding volumes referenced by the prototypes.
+	 */
+	void clearInstancePrototypes();
+
+	/**
+	 * Get the number of cached instance prototypes.
+	 *
+	 * @return the number of unique instance combinations seen since the last clear
+	 */
+	unsigned int getNumInstancePrototypes() const;
+
 protected:
 	/**
 	 * Creata a component from a XML description.
@@ -137,8 +179,29 @@ protected:
 	virtual ActorComponent::ptr createComponent(const tinyxml2::XMLElement* p_Data);
 
 private:
+	/**
+	 * Initialized components for instances sharing mesh, scale, volumes and edges.
+	 * The components are never added to an actor, clones are copy constructed from them.
+	 */
+	struct InstancePrototype
+	{
+		Vector3 scale;
+		std::vector<InstanceBoundingVolume> sourceVolumes;
+		std::vector<InstanceEdgeBox> sourceEdges;
+
+		std::shared_ptr<ModelComponent> model;
+		std::vector<std::shared_ptr<BoundingMeshComponent>> volumes;
+		std::vector<std::shared_ptr<OBB_Component>> edges;
+	};
+	std::map<std::string, std::vector<InstancePrototype>> m_InstancePrototypes;
+
 	unsigned int getNextActorId();
 
+	InstancePrototype* findInstancePrototype(const InstanceModel& p_Model,
+		const std::vector<InstanceBoundingVolume>& p_BoundingVolumes,
+		const std::vector<InstanceEdgeBox>& p_Edges);
+	Actor::ptr cloneInstanceActor(const InstancePrototype& p_Prototype, Vector3 p_Position, Vector3 p_Rotation);
+
 	ActorComponent::ptr createPlayerComponent();
 	ActorComponent::ptr createOBBComponent();
 	ActorComponent::ptr createAABBComponent();
@@ -160,7 +223,39 @@ private:
 	ActorComponent::ptr createRunControlComponent();
 	ActorComponent::ptr createTextComponent();
 
-	void print(tinyxml2::XMLPrinter& p_Printer, const InstanceModel& p_Model);
-	void print(tinyxml2::XMLPrinter& p_Printer, const InstanceBoundingVolume& p_Volume);
-	void print(tinyxml2::XMLPrinter& p_Printer, const InstanceEdgeBox& p_Edge, Vector3 p_Scale);
+	/**
+	 * Create an actor without any components, bypassing the XML path.
+	 * Finish the actor with postInit after all components have been added.
+	 *
+	 * @param p_Position the initial position of the actor
+	 * @param p_Rotation the initial rotation of the actor
+	 */
+	Actor::ptr createEmptyActor(Vector3 p_Position, Vector3 p_Rotation);
+
+	/**
+	 * Initialize a component from its typed description and attach it to an actor.
+	 *
+	 * @param p_Actor the actor to attach the component to
+	 * @param p_Component a component created by one of the component creators
+	 * @param p_Description the typed description matching the component type
+	 */
+	template <class ComponentType>
+	void addComponent(const Actor::ptr& p_Actor, const ActorComponent::ptr& p_Component,
+		const typename ComponentType::Description& p_Description)
+	{
+		std::static_pointer_cast<ComponentType>(p_Component)->initialize(p_Description);
+		attachComponent(p_Actor, p_Component);
+	}
+
+	/**
+	 * Attach an already initialized component to an actor.
+	 *
+	 * @param p_Actor the actor to attach the component to
+	 * @param p_Component the component, not owned by any other actor
+	 */
+	void attachComponent(const Actor::ptr& p_Actor, const ActorComponent::ptr& p_Component)
+	{
+		p_Actor->addComponent(p_Component);
+		p_Component->setOwner(p_Actor.get());
+	}
 };
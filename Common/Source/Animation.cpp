@@ -8,7 +8,23 @@ using namespace DirectX;
 using std::string;
 using std::vector;
 
+// Flip the X-axis to solve right-to-left-handed conversion
+static const XMFLOAT4X4 flipMatrixData(
+	-1.f, 0.f, 0.f, 0.f,
+	 0.f, 1.f, 0.f, 0.f,
+	 0.f, 0.f, 1.f, 0.f,
+	 0.f, 0.f, 0.f, 1.f);
+
 Animation::Animation()
+	:	m_LocalTransforms(nullptr),
+		m_ToRootTransforms(nullptr),
+		m_MaxJointDepth(0),
+		m_PoseComplete(false),
+		m_EvaluatedDepth(0),
+		m_PreviousDepth(0),
+		m_EvaluatedStep(0.f),
+		m_TimeSinceEvaluation(0.f),
+		m_Throttled(false)
 {
 	for (int i = 0; i < 6; i++)
 	{
@@ -23,95 +39,313 @@ Animation::Animation()
 	}
 }
 
-Animation::~Animation() {}
+Animation::~Animation()
+{
+	releasePoseScratch();
+}
 
 void Animation::updateAnimation(float p_DeltaTime)
 {
-	const std::vector<Joint>& p_Joints = m_Data->joints;
-
 	// Update time stamp in the direction of the animation speed per track.
 	updateTimeStamp(p_DeltaTime);
 
 	// Check if any fade blends are active and if they should end.
 	checkFades();
 
-	const unsigned int numBones = p_Joints.size();
+	BlendBatch& batch = getLocalBatch();
+	samplePose(batch, 0);
+	batch.blend(0, 1);
+	applyPose(batch.base, 0);
+}
 
-	m_LocalTransforms.resize(numBones);
+bool Animation::updateAnimationThrottled(float p_DeltaTime, float p_Interval)
+{
+	if (!prepareUpdate(p_DeltaTime, p_Interval))
+	{
+		return false;
+	}
 
-	// Calculate the local transformations for each joint. Has 
-	// to be done before IK is calculated and applied.
-	for(unsigned int i = 0; i < numBones; ++i)
+	BlendBatch& batch = getLocalBatch();
+	samplePose(batch, 0);
+	batch.blend(0, 1);
+	finishUpdate(batch.base, 0);
+	return true;
+}
+
+bool Animation::prepareUpdate(float p_DeltaTime, float p_Interval)
+{
+	m_Throttled = p_Interval > 0.f;
+	if (!m_Throttled)
+	{
+		// Drop the history so a later throttled update does not extrapolate from stale poses
+		m_EvaluatedPose.clear();
+		m_PreviousPose.clear();
+		m_TimeSinceEvaluation = 0.f;
+		updateTimeStamp(p_DeltaTime);
+		checkFades();
+		return true;
+	}
+
+	m_TimeSinceEvaluation += p_DeltaTime;
+	if (m_TimeSinceEvaluation >= p_Interval || m_EvaluatedPose.empty())
 	{
-		MatrixDecomposed toParentData;
-		// Track 0 is the main track. Do vanilla animation.
-		if(m_Tracks[0].clip->m_AnimationSpeed > 0)
+		m_EvaluatedStep = m_TimeSinceEvaluation;
+		m_TimeSinceEvaluation = 0.f;
+		updateTimeStamp(m_EvaluatedStep);
+		checkFades();
+		return true;
+	}
+
+	// Hold the pose until there are two to extrapolate from
+	if (m_PreviousPose.size() != m_EvaluatedPose.size() || m_EvaluatedStep <= 0.f)
+	{
+		return false;
+	}
+
+	// Extrapolating further than one step tends to overshoot visibly
+	extrapolatePose((std::min)(m_TimeSinceEvaluation / m_EvaluatedStep, 1.f));
+
+	return false;
+}
+
+void Animation::extrapolatePose(float p_Fraction)
+{
+	const std::vector<unsigned int>& jointDepths = m_Data->jointDepths;
+	const XMVECTOR factor = XMVectorReplicate(p_Fraction);
+	for (unsigned int i = 0; i < m_EvaluatedPose.size(); ++i)
+	{
+		// Joints not sampled in both poses keep their local transform
+		if ((m_EvaluatedDepth > 0 && jointDepths[i] > m_EvaluatedDepth)
+			|| (m_PreviousDepth > 0 && jointDepths[i] > m_PreviousDepth))
 		{
-			toParentData = std::move(p_Joints[i].interpolateEx(m_Tracks[0].currentFrame, m_Tracks[0].destinationFrame));
+			continue;
 		}
-		else
+
+		const MatrixDecomposed& current = m_EvaluatedPose[i];
+		const MatrixDecomposed& previous = m_PreviousPose[i];
+		MatrixDecomposed result;
+
+		// Translation and scale continue linearly
+		const XMVECTOR currentTranslation = XMLoadFloat4(&current.translation);
+		XMStoreFloat4(&result.translation, XMVectorMultiplyAdd(
+			XMVectorSubtract(currentTranslation, XMLoadFloat4(&previous.translation)), factor, currentTranslation));
+		const XMVECTOR currentScale = XMLoadFloat4(&current.scale);
+		XMStoreFloat4(&result.scale, XMVectorMultiplyAdd(
+			XMVectorSubtract(currentScale, XMLoadFloat4(&previous.scale)), factor, currentScale));
+
+		// The rotation continues along the shortest arc and stays a unit quaternion
+		const XMVECTOR currentRotation = XMLoadFloat4(&current.rotation);
+		XMVECTOR previousRotation = XMLoadFloat4(&previous.rotation);
+		if (XMVectorGetX(XMVector4Dot(currentRotation, previousRotation)) < 0.f)
 		{
-			toParentData = std::move(p_Joints[i].interpolateEx(m_Tracks[0].destinationFrame, m_Tracks[0].currentFrame));
+			previousRotation = XMVectorNegate(previousRotation);
 		}
+		XMStoreFloat4(&result.rotation, XMQuaternionNormalize(XMVectorMultiplyAdd(
+			XMVectorSubtract(currentRotation, previousRotation), factor, currentRotation)));
 
-		for(unsigned int currentTrack = 1; currentTrack < 6; currentTrack++)
+		setLocalTransform(i, result);
+	}
+
+	updateFinalTransforms();
+}
+
+void Animation::samplePose(BlendBatch& p_Batch, unsigned int p_Pose) const
+{
+	const unsigned int numBones = m_Data->joints.size();
+	if (m_Tracks[0].clip)
+	{
+		sampleTrack(0, p_Batch.base, p_Pose);
+	}
+	else
+	{
+		// Nothing has been played on the main track yet, start from the joint offsets alone
+		MatrixDecomposed identity;
+		identity.translation = XMFLOAT4(0.f, 0.f, 0.f, 0.f);
+		identity.rotation = XMFLOAT4(0.f, 0.f, 0.f, 1.f);
+		identity.scale = XMFLOAT4(1.f, 1.f, 1.f, 0.f);
+		for (unsigned int i = 0; i < numBones; ++i)
+		{
+			p_Batch.base.setJoint(p_Pose, i, identity);
+		}
+	}
+
+	const unsigned int stride = p_Batch.base.getStride();
+	const size_t first = (size_t)p_Pose * stride;
+	for (unsigned int layer = 0; layer < BlendBatch::numLayers; ++layer)
+	{
+		const unsigned int track = layer + 1;
+		float* weights = p_Batch.weights[layer].data() + first;
+		if (!m_Tracks[track].active)
 		{
-			if (m_Tracks[currentTrack].active)
+			std::fill(weights, weights + stride, 0.f);
+			p_Batch.used[layer][p_Pose] = 0;
+			continue;
+		}
+
+		sampleTrack(track, p_Batch.layers[layer], p_Pose);
+
+		// Tracks 4 and 5 only affect the joints of their clip
+		const float weight = getTrackWeight(track);
+		const std::vector<bool>& affectedJoints = m_Tracks[track].clip->m_AffectedJoints;
+		for (unsigned int i = 0; i < numBones; ++i)
+		{
+			const bool affected = track <= 3 || (i < affectedJoints.size() && affectedJoints[i]);
+			weights[i] = affected ? weight : 0.f;
+		}
+		std::fill(weights + numBones, weights + stride, 0.f);
+		p_Batch.used[layer][p_Pose] = 1;
+	}
+}
+
+void Animation::finishUpdate(const PoseBuffer& p_Pose, unsigned int p_Index)
+{
+	// The same joints applyPose samples, the others are not set in the pose
+	const unsigned int sampledDepth = m_MaxJointDepth > 0 && m_PoseComplete ? m_MaxJointDepth : 0;
+
+	applyPose(p_Pose, p_Index);
+
+	if (m_Throttled)
+	{
+		const std::vector<unsigned int>& jointDepths = m_Data->jointDepths;
+		const unsigned int numBones = m_Data->joints.size();
+
+		m_PreviousPose.swap(m_EvaluatedPose);
+		m_PreviousDepth = m_EvaluatedDepth;
+		m_EvaluatedPose.resize(numBones);
+		m_EvaluatedDepth = sampledDepth;
+		for (unsigned int i = 0; i < numBones; ++i)
+		{
+			if (sampledDepth == 0 || jointDepths[i] <= sampledDepth)
 			{
-				if (currentTrack > 3)
-				{
-					if (affected(i, m_Tracks[currentTrack].clip->m_FirstJoint))
-					{
-						toParentData = updateKeyFrameInformation(p_Joints[i], currentTrack, toParentData);
-					}
-				}
-				else
-					toParentData = updateKeyFrameInformation(p_Joints[i], currentTrack, toParentData);
+				m_EvaluatedPose[i] = p_Pose.getJoint(p_Index, i);
 			}
 		}
+	}
+}
+
+void Animation::setMaxJointDepth(unsigned int p_MaxDepth)
+{
+	m_MaxJointDepth = p_MaxDepth;
+}
+
+Animation::BlendBatch& Animation::getLocalBatch()
+{
+	if (!m_Batch)
+	{
+		m_Batch.reset(new BlendBatch);
+	}
+	m_Batch->resize(1, m_Data->joints.size());
+	return *m_Batch;
+}
+
+void Animation::applyPose(const PoseBuffer& p_Pose, unsigned int p_Index)
+{
+	const std::vector<Joint>& p_Joints = m_Data->joints;
+	const unsigned int numBones = p_Joints.size();
 
-		XMMATRIX transMat = XMMatrixTranslationFromVector(XMLoadFloat4(&toParentData.translation));
-		XMMATRIX scaleMat = XMMatrixScalingFromVector(XMLoadFloat4(&toParentData.scale));
-		XMMATRIX rotMat = XMMatrixRotationQuaternion(XMLoadFloat4(&toParentData.rotation));
-		XMMATRIX toParentMatrix = XMMatrixTranspose(scaleMat * rotMat * transMat);
+	// Joints below the depth limit keep their local transform from the last full update
+	const bool limitDepth = m_MaxJointDepth > 0 && m_PoseComplete;
+	const std::vector<unsigned int>& jointDepths = m_Data->jointDepths;
 
-		XMMATRIX toParent = XMMatrixMultiply(XMMatrixTranspose(XMLoadFloat4x4(&p_Joints[i].m_JointOffsetMatrix)),
-			toParentMatrix);
-		XMStoreFloat4x4(&m_LocalTransforms[i], toParent);
+	// Calculate the local transformations for each joint. Has 
+	// to be done before IK is calculated and applied.
+	for (unsigned int i = 0; i < numBones; ++i)
+	{
+		if (limitDepth && jointDepths[i] > m_MaxJointDepth)
+		{
+			continue;
+		}
+
+		setLocalTransform(i, p_Pose.getJoint(p_Index, i));
 	}
+	m_PoseComplete = true;
 
 	updateFinalTransforms();
 }
 
-MatrixDecomposed Animation::updateKeyFrameInformation(const Joint& p_Joint, unsigned int p_CurrentTrack,
-	const MatrixDecomposed& p_ToParentData)
+void Animation::setLocalTransform(unsigned int p_Joint, const MatrixDecomposed& p_ToParent)
+{
+	XMMATRIX transMat = XMMatrixTranslationFromVector(XMLoadFloat4(&p_ToParent.translation));
+	XMMATRIX scaleMat = XMMatrixScalingFromVector(XMLoadFloat4(&p_ToParent.scale));
+	XMMATRIX rotMat = XMMatrixRotationQuaternion(XMLoadFloat4(&p_ToParent.rotation));
+	XMMATRIX toParentMatrix = XMMatrixTranspose(scaleMat * rotMat * transMat);
+
+	XMMATRIX toParent = XMMatrixMultiply(XMMatrixTranspose(XMLoadFloat4x4(&m_Data->joints[p_Joint].m_JointOffsetMatrix)),
+		toParentMatrix);
+	XMStoreFloat4x4(&m_LocalTransforms[p_Joint], toParent);
+}
+
+void Animation::sampleTrack(unsigned int p_Track, PoseBuffer& p_Pose, unsigned int p_Index) const
+{
+	const std::vector<Joint>& p_Joints = m_Data->joints;
+	const unsigned int numBones = p_Joints.size();
+
+	const bool limitDepth = m_MaxJointDepth > 0 && m_PoseComplete;
+	const std::vector<unsigned int>& jointDepths = m_Data->jointDepths;
+
+	const AnimationTrack& track = m_Tracks[p_Track];
+	const bool forward = track.clip->m_AnimationSpeed > 0;
+	const float from = forward ? track.currentFrame : track.destinationFrame;
+	const float to = forward ? track.destinationFrame : track.currentFrame;
+
+	for (unsigned int i = 0; i < numBones; ++i)
+	{
+		if (limitDepth && jointDepths[i] > m_MaxJointDepth)
+		{
+			continue;
+		}
+
+		p_Pose.setJoint(p_Index, i, p_Joints[i].interpolateEx(from, to));
+	}
+}
+
+float Animation::getTrackWeight(unsigned int p_Track) const
 {
-	MatrixDecomposed tempData;
-	if(m_Tracks[p_CurrentTrack].clip->m_AnimationSpeed > 0)
+	const AnimationTrack& track = m_Tracks[p_Track];
+
+	float weight = track.clip->m_Weight * track.dynamicWeight;
+	if (track.fadeIn)
 	{
-		tempData = p_Joint.interpolateEx(m_Tracks[p_CurrentTrack].currentFrame, m_Tracks[p_CurrentTrack].destinationFrame);
+		weight *= track.fadedFrames / (float)track.clip->m_FadeInFrames;
 	}
-	else
+	else if (track.fadeOut && !track.clip->m_Loop)
 	{
-		tempData = p_Joint.interpolateEx(m_Tracks[p_CurrentTrack].destinationFrame, m_Tracks[p_CurrentTrack].currentFrame);
+		weight *= 1.0f - track.fadedFrames / (float)track.clip->m_FadeOutFrames;
 	}
 
-	if(m_Tracks[p_CurrentTrack].fadeIn)
+	return (std::max)(0.f, (std::min)(weight, 1.f));
+}
+
+void Animation::BlendBatch::resize(unsigned int p_NumPoses, unsigned int p_NumJoints)
+{
+	if (base.getNumPoses() >= p_NumPoses && base.getNumJoints() >= p_NumJoints)
 	{
-		return p_Joint.interpolateEx(p_ToParentData, tempData, (m_Tracks[p_CurrentTrack].fadedFrames /
-			(float)m_Tracks[p_CurrentTrack].clip->m_FadeInFrames) * m_Tracks[p_CurrentTrack].clip->m_Weight *
-			m_Tracks[p_CurrentTrack].dynamicWeight);
+		return;
 	}
-	else if(m_Tracks[p_CurrentTrack].fadeOut && !m_Tracks[p_CurrentTrack].clip->m_Loop)
+
+	const unsigned int numPoses = (std::max)(base.getNumPoses(), p_NumPoses);
+	const unsigned int numJoints = (std::max)(base.getNumJoints(), p_NumJoints);
+	base.resize(numPoses, numJoints);
+	for (unsigned int i = 0; i < numLayers; ++i)
 	{
-		return p_Joint.interpolateEx(p_ToParentData, tempData, (1.0f - ((m_Tracks[p_CurrentTrack].fadedFrames /
-			(float)m_Tracks[p_CurrentTrack].clip->m_FadeOutFrames))) * m_Tracks[p_CurrentTrack].clip->m_Weight *
-			m_Tracks[p_CurrentTrack].dynamicWeight );
+		layers[i].resize(numPoses, numJoints);
+		weights[i].assign((size_t)numPoses * base.getStride(), 0.f);
+		used[i].assign(numPoses, 0);
 	}
-	else
+}
+
+void Animation::BlendBatch::blend(unsigned int p_FirstPose, unsigned int p_NumPoses)
+{
+	for (unsigned int i = 0; i < numLayers; ++i)
 	{
-		return p_Joint.interpolateEx(p_ToParentData, tempData, m_Tracks[p_CurrentTrack].clip->m_Weight *
-			m_Tracks[p_CurrentTrack].dynamicWeight );
+		// Layers without a track in the range would blend with zero weight
+		const auto begin = used[i].begin() + p_FirstPose;
+		if (std::find(begin, begin + p_NumPoses, 1) == begin + p_NumPoses)
+		{
+			continue;
+		}
+
+		PoseBlender::blendRange(base, layers[i], weights[i].data(), PoseBlender::RotationBlend::NLERP, p_FirstPose, p_NumPoses);
 	}
 }
 
@@ -228,18 +462,6 @@ void Animation::updateTimeStamp(float p_DeltaTime)
 	}
 }
 
-bool Animation::affected(int p_ID, string p_FirstAffectedJoint)
-{
-	const std::vector<Joint>& p_Joints = m_Data->joints;
-
-	// FirstAffectedJode = FAJ
-	if (p_Joints[p_ID].m_JointName == p_FirstAffectedJoint) // The FAJ has been found.
-		return true;
-	else if(p_ID == 0) // The root joint has been reached and the FAJ has not been found.
-		return false;
-	else return affected(p_Joints.at(p_ID).m_Parent - 1, p_FirstAffectedJoint); // Neither the root nor the FAJ has been found yet, keep looking.
-}
-
 const vector<DirectX::XMFLOAT4X4>& Animation::getFinalTransform() const
 {
 	return m_FinalTransform;
@@ -247,13 +469,17 @@ const vector<DirectX::XMFLOAT4X4>& Animation::getFinalTransform() const
 
 void Animation::applyIK_ReachPoint(const std::string& p_GroupName, const DirectX::XMFLOAT3& p_Position, XMFLOAT4X4 p_WorldMatrix, float p_Weight)
 {
-	auto it = m_Data->ikGroups.find(p_GroupName);
-	if (it == m_Data->ikGroups.end())
+	applyIK_ReachPoint(m_Data->findIKGroup(p_GroupName), p_Position, p_WorldMatrix, p_Weight);
+}
+
+void Animation::applyIK_ReachPoint(AnimationData::Handle p_Group, const DirectX::XMFLOAT3& p_Position, XMFLOAT4X4 p_WorldMatrix, float p_Weight)
+{
+	if (p_Group < 0 || (size_t)p_Group >= m_Data->ikGroupTable.size())
 	{
 		return;
 	}
 
-	const IKGroup& p_Group = it->second;
+	const AnimationData::ResolvedIKGroup& group = m_Data->ikGroupTable[p_Group];
 
 	const std::vector<Joint>& p_Joints = m_Data->joints;
 
@@ -266,34 +492,17 @@ void Animation::applyIK_ReachPoint(const std::string& p_GroupName, const DirectX
 	// to the base joint than the length of the "arm" when fully extended. The base joint works
 	// like a human shoulder it has 3 DoF and will make sure that the "arm" is always pointed
 	// towards the target point.
-	const Joint* endJoint = nullptr;
-	const Joint* middleJoint = nullptr;
-	const Joint* baseJoint = nullptr;
-
-	for (unsigned int i = 0; i < p_Joints.size(); i++)
-	{
-		const Joint& joint = p_Joints[i];
-
-		if (joint.m_JointName == p_Group.m_Hand)
-		{
-			endJoint = &joint;
-		}
-		else if (joint.m_JointName == p_Group.m_Elbow)
-		{
-			middleJoint = &joint;
-		}
-		else if (joint.m_JointName == p_Group.m_Shoulder)
-		{
-			baseJoint = &joint;
-		}
-	}
-
 	// The algorithm requires all three joints
-	if (endJoint == nullptr || middleJoint == nullptr || baseJoint == nullptr)
+	if (group.m_Hand == AnimationData::invalidHandle || group.m_Elbow == AnimationData::invalidHandle
+		|| group.m_Shoulder == AnimationData::invalidHandle)
 	{
 		return;
 	}
 
+	const Joint* endJoint = &p_Joints[group.m_Hand];
+	const Joint* middleJoint = &p_Joints[group.m_Elbow];
+	const Joint* baseJoint = &p_Joints[group.m_Shoulder];
+
 	XMMATRIX world = XMLoadFloat4x4(&p_WorldMatrix);
 
 	// Calculate matrices for transforming vectors from joint spaces to world space
@@ -418,32 +627,44 @@ void Animation::applyIK_ReachPoint(const std::string& p_GroupName, const DirectX
 
 DirectX::XMFLOAT3 Animation::getJointPos(const string& p_JointName, XMFLOAT4X4 p_WorldMatrix)
 {
-	const std::vector<Joint>& p_Joints = m_Data->joints;
-	
 	if(m_FinalTransform.size() > 0)
 	{
-		for (const auto& joint : p_Joints)
+		const AnimationData::Handle joint = m_Data->findJoint(p_JointName);
+		if (joint == AnimationData::invalidHandle)
 		{
-			if (joint.m_JointName == p_JointName)
-			{
-				// The joints' positions in world space is the zero vector in joint space transformed to world space.
-				XMMATRIX jointCombinedTransform = XMMatrixMultiply(
-					XMLoadFloat4x4(&p_WorldMatrix),
-					XMMatrixMultiply(
-						XMLoadFloat4x4(&m_FinalTransform[joint.m_ID - 1]),
-						XMLoadFloat4x4(&joint.m_TotalJointOffset)));
-
-				XMFLOAT4X4 jointCombinedTransformData;
-				XMStoreFloat4x4(&jointCombinedTransformData, jointCombinedTransform);
+			throw InvalidArgument("Joint does not exist: '" + p_JointName + "'", __LINE__, __FILE__);
+		}
 
-				XMFLOAT3 jointPosition(jointCombinedTransformData._14, jointCombinedTransformData._24,
-					jointCombinedTransformData._34); 
+		return getJointPos(joint, p_WorldMatrix);
+	}
+	return XMFLOAT3(0.0f, 0.0f, 0.0f);
+}
 
-				return jointPosition;
-			}
+DirectX::XMFLOAT3 Animation::getJointPos(AnimationData::Handle p_Joint, XMFLOAT4X4 p_WorldMatrix)
+{
+	if(m_FinalTransform.size() > 0)
+	{
+		if (p_Joint < 0 || (size_t)p_Joint >= m_Data->joints.size())
+		{
+			throw InvalidArgument("Joint handle does not exist: " + std::to_string(p_Joint), __LINE__, __FILE__);
 		}
 
-		throw InvalidArgument("Joint does not exist: '" + p_JointName + "'", __LINE__, __FILE__);
+		const Joint& joint = m_Data->joints[p_Joint];
+
+		// The joints' positions in world space is the zero vector in joint space transformed to world space.
+		XMMATRIX jointCombinedTransform = XMMatrixMultiply(
+			XMLoadFloat4x4(&p_WorldMatrix),
+			XMMatrixMultiply(
+				XMLoadFloat4x4(&m_FinalTransform[joint.m_ID - 1]),
+				XMLoadFloat4x4(&joint.m_TotalJointOffset)));
+
+		XMFLOAT4X4 jointCombinedTransformData;
+		XMStoreFloat4x4(&jointCombinedTransformData, jointCombinedTransform);
+
+		XMFLOAT3 jointPosition(jointCombinedTransformData._14, jointCombinedTransformData._24,
+			jointCombinedTransformData._34); 
+
+		return jointPosition;
 	}
 	return XMFLOAT3(0.0f, 0.0f, 0.0f);
 }
@@ -454,7 +675,7 @@ void Animation::updateFinalTransforms()
 
 	const unsigned int numBones = p_Joints.size();
 
-	vector<XMFLOAT4X4> toRootTransforms(numBones);
+	XMFLOAT4X4* toRootTransforms = m_ToRootTransforms;
 
 	// Accumulate parent transformations
 	toRootTransforms[0] = m_LocalTransforms[0];
@@ -467,23 +688,17 @@ void Animation::updateFinalTransforms()
 		XMStoreFloat4x4(&toRootTransforms[i], toRoot);
 	}
 
-	// Flip the X-axis to solve right-to-left-handed conversion
-	static const XMFLOAT4X4 flipMatrixData(
-		-1.f, 0.f, 0.f, 0.f,
-		 0.f, 1.f, 0.f, 0.f,
-		 0.f, 0.f, 1.f, 0.f,
-		 0.f, 0.f, 0.f, 1.f);
-	static const XMMATRIX flipMatrix = XMLoadFloat4x4(&flipMatrixData);
+	// Loaded per call, function local statics are not initialized thread safe and poses are evaluated in parallel
+	const XMMATRIX flipMatrix = XMLoadFloat4x4(&flipMatrixData);
 	
 	m_FinalTransform.resize(numBones);
 
 	// Use offset to account for bind space coordinates of vertex positions
 	for (unsigned int i = 0; i < numBones; i++)
 	{
-		XMMATRIX offSet = XMLoadFloat4x4(&p_Joints[i].m_TotalJointOffset);
+		const XMMATRIX offSet = XMLoadFloat4x4(&m_Data->inverseBindPoses[i]);
 		const XMMATRIX toRoot = XMLoadFloat4x4(&toRootTransforms[i]);
 		
-		offSet = XMMatrixInverse(nullptr, offSet);
 		XMMATRIX result = XMMatrixMultiply(toRoot, offSet);
 		//result = offSet;
 
@@ -500,14 +715,21 @@ void Animation::updateFinalTransforms()
 
 void Animation::playClip( const std::string& p_ClipName, bool p_Override )
 {
-	auto clip = m_Data->animationClips.find(p_ClipName);
-	if (clip == m_Data->animationClips.end())
+	playClip(m_Data->findClip(p_ClipName), p_Override);
+}
+
+void Animation::playClip( AnimationData::Handle p_Clip, bool p_Override )
+{
+	if (p_Clip < 0 || (size_t)p_Clip >= m_Data->clipTable.size())
 	{
 		return;
 	}
 
-	const AnimationClip* p_Clip = &clip->second;
+	startClip(m_Data->clipTable[p_Clip], p_Override);
+}
 
+void Animation::startClip(const AnimationClip* p_Clip, bool p_Override)
+{
 	int track = p_Clip->m_DestinationTrack;
 	if(p_Override)
 	{
@@ -564,13 +786,17 @@ void Animation::playClip( const std::string& p_ClipName, bool p_Override )
 
 void Animation::queueClip( const std::string& p_Clip )
 {
-	auto clip = m_Data->animationClips.find(p_Clip);
-	if (clip == m_Data->animationClips.end())
+	queueClip(m_Data->findClip(p_Clip));
+}
+
+void Animation::queueClip( AnimationData::Handle p_Clip )
+{
+	if (p_Clip < 0 || (size_t)p_Clip >= m_Data->clipTable.size())
 	{
 		return;
 	}
 
-	m_Queue.push_back(&clip->second);
+	m_Queue.push_back(m_Data->clipTable[p_Clip]);
 }
 
 bool Animation::playQueuedClip(int p_Track)
@@ -584,7 +810,7 @@ bool Animation::playQueuedClip(int p_Track)
 		{
 			if (m_Queue[i]->m_DestinationTrack == p_Track)
 			{
-				playClip(m_Queue[i]->m_ClipName, false);
+				startClip(m_Queue[i], false);
 				return true;
 			}
 		}
@@ -603,38 +829,29 @@ void Animation::changeWeight(int p_Track, float p_Weight)
 
 void Animation::applyLookAtIK(const std::string& p_GroupName, const DirectX::XMFLOAT3& p_Position, DirectX::XMFLOAT4X4 p_WorldMatrix, float p_MaxAngle)
 {
-	auto it = m_Data->ikGroups.find(p_GroupName);
-	if (it == m_Data->ikGroups.end())
+	applyLookAtIK(m_Data->findIKGroup(p_GroupName), p_Position, p_WorldMatrix, p_MaxAngle);
+}
+
+void Animation::applyLookAtIK(AnimationData::Handle p_Group, const DirectX::XMFLOAT3& p_Position, DirectX::XMFLOAT4X4 p_WorldMatrix, float p_MaxAngle)
+{
+	if (p_Group < 0 || (size_t)p_Group >= m_Data->ikGroupTable.size())
 	{
 		return;
 	}
 
-	const IKGroup& p_Group = it->second;
-
-	const std::vector<Joint>& p_Joints = m_Data->joints;
+	const AnimationData::ResolvedIKGroup& group = m_Data->ikGroupTable[p_Group];
 
 	XMFLOAT4 targetData(p_Position.x, p_Position.y, p_Position.z, 1.f);
 	XMVECTOR target = XMLoadFloat4(&targetData);
 
-	const Joint* headJoint = nullptr;
-
-	for (unsigned int i = 0; i < p_Joints.size(); i++)
-	{
-		const Joint& joint = p_Joints[i];
-
-		if (joint.m_JointName == p_Group.m_Hand)
-		{
-			headJoint = &joint;
-			break;
-		}
-	}
-
-	// The algorithm requires all three joints
-	if (headJoint == nullptr)
+	// The algorithm requires the head joint
+	if (group.m_Hand == AnimationData::invalidHandle)
 	{
 		return;
 	}
 
+	const Joint* headJoint = &m_Data->joints[group.m_Hand];
+
 	XMMATRIX world = XMLoadFloat4x4(&p_WorldMatrix);
 
 	// Calculate matrices for transforming vectors from joint spaces to world space
@@ -725,10 +942,41 @@ XMFLOAT4X4 Animation::getViewDirection(std::string p_Joint, DirectX::XMFLOAT3 p_
 
 void Animation::setAnimationData(AnimationData::ptr p_Data)
 {
+	releasePoseScratch();
+
 	m_Data = p_Data;
+	if (m_Data && !m_Data->hasJointData())
+	{
+		m_Data->computeJointData();
+	}
+
+	m_FinalTransform.clear();
+	m_EvaluatedPose.clear();
+	m_PreviousPose.clear();
+	m_TimeSinceEvaluation = 0.f;
+	m_PoseComplete = false;
+	if (m_Data)
+	{
+		m_PosePool = m_Data->posePool;
+		m_LocalTransforms = m_PosePool->acquire();
+		m_ToRootTransforms = m_LocalTransforms + m_Data->joints.size();
+		m_FinalTransform.reserve(m_Data->joints.size());
+	}
+
 	playClip("default", true);
 }
 
+void Animation::releasePoseScratch()
+{
+	if (m_PosePool)
+	{
+		m_PosePool->release(m_LocalTransforms);
+		m_PosePool.reset();
+	}
+	m_LocalTransforms = nullptr;
+	m_ToRootTransforms = nullptr;
+}
+
 const AnimationData::ptr Animation::getAnimationData() const
 {
 	return m_Data;
@@ -2,12 +2,49 @@
 #include "Joint.h"
 #include "AnimationClip.h"
 #include "AnimationData.h"
+#include "PoseBlender.h"
 
 #include <DirectXMath.h>
+#include <memory>
 #include <vector>
 
 class Animation
 {
+public:
+	/**
+	 * The sampled tracks of one or more animations, one pose per animation, blended
+	 * together as a batch. Track 0 is sampled into the base pose and tracks 1 to 5
+	 * into the layers, which are blended on top of the base in track order.
+	 */
+	struct BlendBatch
+	{
+		static const unsigned int numLayers = 5;
+
+		PoseBuffer base;
+		PoseBuffer layers[numLayers];
+		/**
+		 * The blend weight of every joint in each layer, laid out like the pose channels.
+		 */
+		std::vector<float> weights[numLayers];
+		/**
+		 * Non-zero for the poses that have a track playing in each layer.
+		 */
+		std::vector<char> used[numLayers];
+
+		/**
+		 * Make room for a number of poses, keeping the size if it is already enough.
+		 *
+		 * @param p_NumPoses the number of animations in the batch
+		 * @param p_NumJoints the largest number of joints of any of the animations
+		 */
+		void resize(unsigned int p_NumPoses, unsigned int p_NumJoints);
+
+		/**
+		 * Blend the layers of a range of poses into their base poses.
+		 */
+		void blend(unsigned int p_FirstPose, unsigned int p_NumPoses);
+	};
+
 private:
 	struct AnimationTrack
 	{
@@ -25,14 +62,23 @@ private:
 	// Animation data
 	/**
 	 * The matrices that transforms from the animated joint's space to the parent's joint's space.
-	 * Row major.
+	 * Row major. Points into a slot of the animation data's pose scratch pool.
 	 */
-	std::vector<DirectX::XMFLOAT4X4> m_LocalTransforms;
+	DirectX::XMFLOAT4X4* m_LocalTransforms;
 	/**
 	 * The matrices that transforms from bind space to model space with animations.
 	 * Row major.
 	 */
 	std::vector<DirectX::XMFLOAT4X4> m_FinalTransform;
+	/**
+	 * Scratch space for the accumulated joint to model space transformations,
+	 * the second half of the pose scratch slot.
+	 */
+	DirectX::XMFLOAT4X4* m_ToRootTransforms;
+	/**
+	 * The pool the scratch slot was taken from, kept alive until the slot is returned.
+	 */
+	PoseScratchPool::ptr m_PosePool;
 	/**
 	 * The animation tracks contain the timestamp information and animation clip data needed for animations and blends.
 	 * Track 0 is the forward track. It contains whole body animations that are in the z-axis in Maya. It also contains
@@ -46,6 +92,35 @@ private:
 	AnimationTrack m_Tracks[6];
 	std::vector<const AnimationClip*> m_Queue;
 	AnimationData::ptr m_Data;
+	/**
+	 * Blend space for updates outside of an AnimationJobSystem, created on first use.
+	 */
+	std::unique_ptr<BlendBatch> m_Batch;
+
+	// Level of detail
+	/**
+	 * Joints deeper in the hierarchy than this keep their last sampled local transform. 0 samples all joints.
+	 */
+	unsigned int m_MaxJointDepth;
+	/**
+	 * True once every joint has been sampled at least once since the animation data was set.
+	 */
+	bool m_PoseComplete;
+	/**
+	 * The local transforms of the two most recently evaluated poses, used to
+	 * extrapolate between throttled updates, and the joint depth each pose was
+	 * sampled to, 0 for all joints.
+	 */
+	std::vector<MatrixDecomposed> m_EvaluatedPose;
+	std::vector<MatrixDecomposed> m_PreviousPose;
+	unsigned int m_EvaluatedDepth;
+	unsigned int m_PreviousDepth;
+	float m_EvaluatedStep;
+	float m_TimeSinceEvaluation;
+	/**
+	 * True if the pose being evaluated is a throttled update and should be kept for extrapolation.
+	 */
+	bool m_Throttled;
 
 public:
 	/**
@@ -64,6 +139,47 @@ public:
 	 * @param p_Joints the skeleton to be used for the animation.
 	 */
 	void updateAnimation(float p_DeltaTime);
+	/**
+	 * Update the animation, but only evaluate the pose every p_Interval seconds.
+	 * In between, the local joint transforms are extrapolated from the two latest
+	 * evaluated poses, or the last pose is held until there are two.
+	 *
+	 * @param p_DeltaTime the time since the previous frame.
+	 * @param p_Interval the time between evaluated poses, 0 to evaluate every frame.
+	 * @return true if the pose was evaluated this frame.
+	 */
+	bool updateAnimationThrottled(float p_DeltaTime, float p_Interval);
+	/**
+	 * The first stage of updateAnimationThrottled, for evaluating many animations as a
+	 * batch. Advances the time and, if no new pose is needed, extrapolates the last ones.
+	 *
+	 * @param p_DeltaTime the time since the previous frame.
+	 * @param p_Interval the time between evaluated poses, 0 to evaluate every frame.
+	 * @return true if the pose should be evaluated with samplePose and finishUpdate.
+	 */
+	bool prepareUpdate(float p_DeltaTime, float p_Interval);
+	/**
+	 * Sample the active tracks into a pose of a blend batch. Joints the animation
+	 * does not sample are left untouched.
+	 *
+	 * @param p_Batch the batch, with room for the joints of the animation.
+	 * @param p_Pose the pose in the batch reserved for this animation.
+	 */
+	void samplePose(BlendBatch& p_Batch, unsigned int p_Pose) const;
+	/**
+	 * Build the final transformations from a blended pose, the last stage of an update.
+	 *
+	 * @param p_Pose the blended poses.
+	 * @param p_Index the pose of this animation.
+	 */
+	void finishUpdate(const PoseBuffer& p_Pose, unsigned int p_Index);
+	/**
+	 * Limit the joints sampled by updateAnimation to a depth in the skeleton.
+	 * Deeper joints follow their parents with the last sampled local transform.
+	 *
+	 * @param p_MaxDepth the deepest sampled joint, the root has depth 0. Use 0 to sample all joints.
+	 */
+	void setMaxJointDepth(unsigned int p_MaxDepth);
 	/**
 	 * Get the final transformations for the models joints.
 	 *
@@ -80,6 +196,10 @@ public:
 	 * @param p_Joints the skeleton used for the model.
 	 */
 	void applyIK_ReachPoint(const std::string& p_GroupName, const DirectX::XMFLOAT3& p_Position, DirectX::XMFLOAT4X4 p_WorldMatrix, float p_Weight);
+	/**
+	 * Same as above, with the IK group resolved by AnimationData::findIKGroup.
+	 */
+	void applyIK_ReachPoint(AnimationData::Handle p_Group, const DirectX::XMFLOAT3& p_Position, DirectX::XMFLOAT4X4 p_WorldMatrix, float p_Weight);
 	
 	/**
 	 * Get the position of a joint.
@@ -88,6 +208,10 @@ public:
 	 * @param p_Joints the joints associated with the model instance.
 	 */
 	DirectX::XMFLOAT3 getJointPos(const std::string& p_JointName, DirectX::XMFLOAT4X4 p_WorldMatrix);
+	/**
+	 * Same as above, with the joint resolved by AnimationData::findJoint.
+	 */
+	DirectX::XMFLOAT3 getJointPos(AnimationData::Handle p_Joint, DirectX::XMFLOAT4X4 p_WorldMatrix);
 
 	/**
 	 * Play an animation clip.
@@ -95,6 +219,10 @@ public:
 	 * @param p_Override, false if you want standard behavior and true if you want to skip blending etc.
 	 */
 	virtual void playClip( const std::string& p_Clip, bool p_Override );
+	/**
+	 * Play an animation clip resolved by AnimationData::findClip.
+	 */
+	void playClip( AnimationData::Handle p_Clip, bool p_Override );
 
 	/**
 	 * Queue animation clip.
@@ -102,6 +230,10 @@ public:
 	 * NOTE: Queued clips cannot override the main track of a pair.
 	 */
 	virtual void queueClip( const std::string& p_Clip );
+	/**
+	 * Queue an animation clip resolved by AnimationData::findClip.
+	 */
+	void queueClip( AnimationData::Handle p_Clip );
 
 	/**
 	 * Purge queue of all elements destined to be on track p_Track.
@@ -118,6 +250,7 @@ public:
 	void changeWeight(int p_MainTrack, float p_Weight );
 
 	void applyLookAtIK(const std::string& p_GroupName, const DirectX::XMFLOAT3& p_Position, DirectX::XMFLOAT4X4 p_WorldMatrix, float p_MaxAngle);
+	void applyLookAtIK(AnimationData::Handle p_Group, const DirectX::XMFLOAT3& p_Position, DirectX::XMFLOAT4X4 p_WorldMatrix, float p_MaxAngle);
 
 	DirectX::XMFLOAT4X4 getViewDirection(std::string p_Joint, DirectX::XMFLOAT3 p_BodyRotation, DirectX::XMFLOAT3 p_Up);
 
@@ -126,10 +259,19 @@ public:
 	const AnimationData::ptr getAnimationData() const;
 
 private:
+	Animation(const Animation&);
+	Animation& operator=(const Animation&);
+
+	void releasePoseScratch();
+	void startClip(const AnimationClip* p_Clip, bool p_Override);
 	void updateFinalTransforms();
-	bool affected(int p_ID, std::string p_FirstAffectedJoint);
+	BlendBatch& getLocalBatch();
+	void applyPose(const PoseBuffer& p_Pose, unsigned int p_Index);
+	void setLocalTransform(unsigned int p_Joint, const MatrixDecomposed& p_ToParent);
+	void extrapolatePose(float p_Fraction);
+	void sampleTrack(unsigned int p_Track, PoseBuffer& p_Pose, unsigned int p_Index) const;
+	float getTrackWeight(unsigned int p_Track) const;
 	bool playQueuedClip(int p_Track);
 	void checkFades();
 	void updateTimeStamp(float p_DeltaTime);
-	MatrixDecomposed updateKeyFrameInformation(const Joint& p_Joint, unsigned int p_CurrentTrack, const MatrixDecomposed& p_ToParentData);
 };
\ No newline at end of file
@@ -1,4 +1,5 @@
 #pragma once
+#include <string>
 #include <vector>
 #include <map>
 #include <DirectXMath.h>
@@ -18,6 +19,11 @@ struct AnimationClip
 	bool		m_FadeOut;
 	int			m_FadeOutFrames;
 	float		m_Weight;
+	/**
+	 * One flag per joint in the skeleton, set for m_FirstJoint and all joints below it.
+	 * Filled by AnimationData::computeJointData, layered tracks only blend the flagged joints.
+	 */
+	std::vector<bool> m_AffectedJoints;
 
 	AnimationClip()
 	{
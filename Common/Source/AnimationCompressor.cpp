@@ -0,0 +1,502 @@
+#include "AnimationCompressor.h"
+
+#include "CommonExceptions.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace DirectX;
+
+const char AnimationCompressor::magic[4] = { 'A', 'T', 'X', 'C' };
+
+namespace
+{
+	typedef CompressedChannel::Type ChannelType;
+
+	const ChannelType channelTypes[] = { ChannelType::TRANSLATION, ChannelType::ROTATION, ChannelType::SCALE };
+
+	XMFLOAT4 getKey(const KeyFrame& p_Key, ChannelType p_Type)
+	{
+		switch (p_Type)
+		{
+		case ChannelType::TRANSLATION:
+			return XMFLOAT4(p_Key.m_Trans.x, p_Key.m_Trans.y, p_Key.m_Trans.z, 0.f);
+		case ChannelType::ROTATION:
+			return p_Key.m_Rot;
+		default:
+			return XMFLOAT4(p_Key.m_Scale.x, p_Key.m_Scale.y, p_Key.m_Scale.z, 0.f);
+		}
+	}
+
+	CompressedChannel& getChannel(CompressedKeyFrames& p_Animation, ChannelType p_Type)
+	{
+		switch (p_Type)
+		{
+		case ChannelType::TRANSLATION:
+			return p_Animation.m_Translation;
+		case ChannelType::ROTATION:
+			return p_Animation.m_Rotation;
+		default:
+			return p_Animation.m_Scale;
+		}
+	}
+
+	float getError(const AnimationCompressor::Settings& p_Settings, ChannelType p_Type)
+	{
+		switch (p_Type)
+		{
+		case ChannelType::TRANSLATION:
+			return p_Settings.m_TranslationError;
+		case ChannelType::ROTATION:
+			return p_Settings.m_RotationError;
+		default:
+			return p_Settings.m_ScaleError;
+		}
+	}
+
+	float& getMaxError(AnimationCompressor::Statistics& p_Statistics, ChannelType p_Type)
+	{
+		switch (p_Type)
+		{
+		case ChannelType::TRANSLATION:
+			return p_Statistics.m_TranslationError;
+		case ChannelType::ROTATION:
+			return p_Statistics.m_RotationError;
+		default:
+			return p_Statistics.m_ScaleError;
+		}
+	}
+
+	/**
+	 * Largest component difference, with rotations compared in the same hemisphere.
+	 */
+	float keyDistance(const XMFLOAT4& p_A, const XMFLOAT4& p_B, ChannelType p_Type)
+	{
+		XMVECTOR a = XMLoadFloat4(&p_A);
+		XMVECTOR b = XMLoadFloat4(&p_B);
+		if (p_Type == ChannelType::ROTATION && XMVectorGetX(XMVector4Dot(a, b)) < 0.f)
+		{
+			b = XMVectorNegate(b);
+		}
+
+		XMFLOAT4 diff;
+		XMStoreFloat4(&diff, XMVectorAbs(XMVectorSubtract(a, b)));
+		float result = diff.x;
+		if (diff.y > result) result = diff.y;
+		if (diff.z > result) result = diff.z;
+		if (diff.w > result) result = diff.w;
+		return result;
+	}
+
+	/**
+	 * Pick the frames to store for a channel that is not constant.
+	 *
+	 * @param p_Values the source value of every frame
+	 * @param p_Quantized the value of every frame after quantization, the keys that will be interpolated
+	 */
+	std::vector<unsigned int> selectKeys(const std::vector<XMFLOAT4>& p_Values, const std::vector<XMFLOAT4>& p_Quantized,
+		ChannelType p_Type, float p_Error, bool p_Reduce)
+	{
+		std::vector<unsigned int> keys;
+		const unsigned int numValues = p_Values.size();
+		if (!p_Reduce)
+		{
+			keys.resize(numValues);
+			for (unsigned int i = 0; i < numValues; ++i)
+			{
+				keys[i] = i;
+			}
+			return keys;
+		}
+
+		// Greedily extend each segment as long as the skipped frames, interpolated
+		// from the quantized end keys, stay within the error of the source values
+		keys.push_back(0);
+		unsigned int start = 0;
+		for (unsigned int end = 2; end < numValues; ++end)
+		{
+			bool fits = true;
+			for (unsigned int k = start + 1; k < end && fits; ++k)
+			{
+				const float fraction = (float)(k - start) / (float)(end - start);
+				const XMFLOAT4 interpolated = CompressedChannel::interpolate(p_Type, p_Quantized[start], p_Quantized[end], fraction);
+				fits = keyDistance(interpolated, p_Values[k], p_Type) <= p_Error;
+			}
+
+			if (!fits)
+			{
+				start = end - 1;
+				keys.push_back(start);
+			}
+		}
+		keys.push_back(numValues - 1);
+
+		return keys;
+	}
+
+	/**
+	 * Compress the values of a channel within the error, including the quantization error of the keys.
+	 * A channel whose quantization error alone is above the bound keeps all its keys.
+	 */
+	void compressChannel(const std::vector<XMFLOAT4>& p_Values, float p_Error, bool p_Reduce, CompressedChannel& p_Channel)
+	{
+		const ChannelType type = p_Channel.getType();
+		const unsigned int numValues = p_Values.size();
+		if (numValues == 0)
+		{
+			return;
+		}
+
+		bool constant = true;
+		for (unsigned int i = 1; i < numValues && constant; ++i)
+		{
+			constant = keyDistance(p_Values[0], p_Values[i], type) <= p_Error;
+		}
+		if (constant)
+		{
+			p_Channel.setConstant(p_Values[0]);
+			return;
+		}
+
+		// The bounds cover every frame, so that the quantized value of every
+		// frame is known before the keys are selected
+		XMFLOAT3 min(0.f, 0.f, 0.f), extent(0.f, 0.f, 0.f);
+		if (type != ChannelType::ROTATION)
+		{
+			XMVECTOR minValue = XMLoadFloat4(&p_Values[0]);
+			XMVECTOR maxValue = minValue;
+			for (unsigned int i = 1; i < numValues; ++i)
+			{
+				const XMVECTOR value = XMLoadFloat4(&p_Values[i]);
+				minValue = XMVectorMin(minValue, value);
+				maxValue = XMVectorMax(maxValue, value);
+			}
+			XMStoreFloat3(&min, minValue);
+			XMStoreFloat3(&extent, XMVectorSubtract(maxValue, minValue));
+		}
+
+		std::vector<uint16_t> packed(numValues * 3);
+		std::vector<XMFLOAT4> quantized(numValues);
+		for (unsigned int i = 0; i < numValues; ++i)
+		{
+			CompressedChannel::packKey(type, p_Values[i], min, extent, &packed[i * 3]);
+			quantized[i] = CompressedChannel::unpackKey(type, &packed[i * 3], min, extent);
+		}
+
+		const std::vector<unsigned int> keys = selectKeys(p_Values, quantized, type, p_Error, p_Reduce);
+
+		std::vector<uint16_t> frames;
+		std::vector<uint16_t> keyData(keys.size() * 3);
+		if (keys.size() < numValues)
+		{
+			frames.resize(keys.size());
+		}
+		for (unsigned int i = 0; i < keys.size(); ++i)
+		{
+			if (!frames.empty())
+			{
+				frames[i] = (uint16_t)keys[i];
+			}
+			std::copy(&packed[keys[i] * 3], &packed[keys[i] * 3] + 3, &keyData[i * 3]);
+		}
+		p_Channel.setKeys(frames, keyData, min, extent);
+	}
+
+	class ChannelWriter
+	{
+	private:
+		std::ostream& m_Output;
+		size_t m_BytesWritten;
+
+	public:
+		explicit ChannelWriter(std::ostream& p_Output)
+			: m_Output(p_Output), m_BytesWritten(0)
+		{}
+
+		void write(const void* p_Data, size_t p_Size)
+		{
+			m_Output.write(static_cast<const char*>(p_Data), p_Size);
+			m_BytesWritten += p_Size;
+		}
+
+		void writeInt(int p_Value)
+		{
+			write(&p_Value, sizeof(p_Value));
+		}
+
+		void writeString(const std::string& p_String)
+		{
+			writeInt(p_String.size());
+			write(p_String.data(), p_String.size());
+		}
+
+		size_t getBytesWritten() const
+		{
+			return m_BytesWritten;
+		}
+	};
+
+	class ChannelReader
+	{
+	private:
+		std::istream& m_Input;
+
+	public:
+		explicit ChannelReader(std::istream& p_Input)
+			: m_Input(p_Input)
+		{}
+
+		void read(void* p_Data, size_t p_Size)
+		{
+			m_Input.read(static_cast<char*>(p_Data), p_Size);
+			if (!m_Input)
+			{
+				throw CommonException("Compressed animation data is truncated", __LINE__, __FILE__);
+			}
+		}
+
+		int readInt()
+		{
+			int value;
+			read(&value, sizeof(value));
+			return value;
+		}
+
+		unsigned int readCount(unsigned int p_Max)
+		{
+			int count = readInt();
+			if (count < 0 || (unsigned int)count > p_Max)
+			{
+				throw CommonException("Invalid count in compressed animation: " + std::to_string(count), __LINE__, __FILE__);
+			}
+			return (unsigned int)count;
+		}
+
+		std::string readString()
+		{
+			int length = readInt();
+			if (length < 0 || length > 4096)
+			{
+				throw CommonException("Invalid string length in compressed animation", __LINE__, __FILE__);
+			}
+			std::string result(length, '\0');
+			if (length > 0)
+			{
+				read(&result[0], length);
+			}
+			return result;
+		}
+	};
+
+	void writeChannel(ChannelWriter& p_Writer, const CompressedChannel& p_Channel, unsigned int p_NumFrames)
+	{
+		if (p_NumFrames == 0)
+		{
+			p_Writer.writeInt(0);
+			return;
+		}
+
+		if (p_Channel.isConstant())
+		{
+			p_Writer.writeInt(1);
+			p_Writer.write(&p_Channel.getConstant(), p_Channel.getType() == ChannelType::ROTATION ? sizeof(XMFLOAT4) : sizeof(XMFLOAT3));
+			return;
+		}
+
+		const std::vector<uint16_t>& keys = p_Channel.getKeys();
+		const std::vector<uint16_t>& frames = p_Channel.getFrames();
+		p_Writer.writeInt(keys.size() / 3);
+		if (!frames.empty())
+		{
+			p_Writer.write(frames.data(), frames.size() * sizeof(uint16_t));
+		}
+		if (p_Channel.getType() != ChannelType::ROTATION)
+		{
+			p_Writer.write(&p_Channel.getMin(), sizeof(XMFLOAT3));
+			p_Writer.write(&p_Channel.getExtent(), sizeof(XMFLOAT3));
+		}
+		p_Writer.write(keys.data(), keys.size() * sizeof(uint16_t));
+	}
+
+	void readChannel(ChannelReader& p_Reader, unsigned int p_NumFrames, CompressedChannel& p_Channel)
+	{
+		const ChannelType type = p_Channel.getType();
+		const unsigned int numKeys = p_Reader.readCount(p_NumFrames);
+		if (numKeys == 0)
+		{
+			if (p_NumFrames != 0)
+			{
+				throw CommonException("Missing keys in compressed animation", __LINE__, __FILE__);
+			}
+			return;
+		}
+
+		if (numKeys == 1)
+		{
+			XMFLOAT4 value(0.f, 0.f, 0.f, 0.f);
+			p_Reader.read(&value, type == ChannelType::ROTATION ? sizeof(XMFLOAT4) : sizeof(XMFLOAT3));
+			p_Channel.setConstant(value);
+			return;
+		}
+
+		std::vector<uint16_t> frames;
+		if (numKeys < p_NumFrames)
+		{
+			frames.resize(numKeys);
+			p_Reader.read(frames.data(), frames.size() * sizeof(uint16_t));
+			if (frames.front() != 0 || frames.back() != p_NumFrames - 1)
+			{
+				throw CommonException("Compressed animation keys do not cover all frames", __LINE__, __FILE__);
+			}
+			for (unsigned int i = 1; i < numKeys; ++i)
+			{
+				if (frames[i] <= frames[i - 1])
+				{
+					throw CommonException("Compressed animation keys are not ordered", __LINE__, __FILE__);
+				}
+			}
+		}
+
+		XMFLOAT3 min(0.f, 0.f, 0.f), extent(0.f, 0.f, 0.f);
+		if (type != ChannelType::ROTATION)
+		{
+			p_Reader.read(&min, sizeof(min));
+			p_Reader.read(&extent, sizeof(extent));
+		}
+
+		std::vector<uint16_t> keys(numKeys * 3);
+		p_Reader.read(keys.data(), keys.size() * sizeof(uint16_t));
+		p_Channel.setKeys(frames, keys, min, extent);
+	}
+}
+
+AnimationCompressor::Statistics AnimationCompressor::write(std::ostream& p_Output, const std::string& p_ModelName,
+	const std::vector<Joint>& p_Joints, int p_NumFrames, const Settings& p_Settings)
+{
+	if (p_NumFrames < 0 || p_NumFrames > 0xffff)
+	{
+		throw CommonException("Unsupported number of frames for compression: " + std::to_string(p_NumFrames), __LINE__, __FILE__);
+	}
+
+	Statistics stats;
+	stats.m_RawKeyBytes = 0;
+	stats.m_ConstantChannels = 0;
+	stats.m_ReducedChannels = 0;
+	stats.m_TotalChannels = 0;
+	stats.m_TranslationError = 0.f;
+	stats.m_RotationError = 0.f;
+	stats.m_ScaleError = 0.f;
+
+	ChannelWriter writer(p_Output);
+	writer.write(magic, sizeof(magic));
+	writer.writeInt(version);
+	writer.writeString(p_ModelName);
+	writer.writeInt(p_Joints.size());
+	writer.writeInt(p_NumFrames);
+
+	size_t keyBytes = 0;
+	std::vector<XMFLOAT4> values(p_NumFrames);
+	for (const auto& joint : p_Joints)
+	{
+		if (joint.m_JointAnimation.size() != (size_t)p_NumFrames)
+		{
+			throw CommonException("Joint '" + joint.m_JointName + "' does not have a key for every frame", __LINE__, __FILE__);
+		}
+
+		writer.writeString(joint.m_JointName);
+		writer.writeInt(joint.m_ID);
+		writer.writeInt(joint.m_Parent);
+		writer.write(&joint.m_TotalJointOffset, sizeof(XMFLOAT4X4));
+
+		stats.m_RawKeyBytes += sizeof(KeyFrame) * p_NumFrames;
+
+		for (ChannelType type : channelTypes)
+		{
+			for (int f = 0; f < p_NumFrames; ++f)
+			{
+				values[f] = getKey(joint.m_JointAnimation[f], type);
+				if (type == ChannelType::ROTATION)
+				{
+					XMStoreFloat4(&values[f], XMQuaternionNormalize(XMLoadFloat4(&values[f])));
+				}
+			}
+
+			CompressedChannel channel(type);
+			compressChannel(values, getError(p_Settings, type), p_Settings.m_ReduceKeys, channel);
+
+			stats.m_TotalChannels++;
+			if (channel.isConstant())
+			{
+				stats.m_ConstantChannels++;
+			}
+			else if (!channel.getFrames().empty())
+			{
+				stats.m_ReducedChannels++;
+			}
+
+			// Measure what the runtime will actually sample, quantization included
+			float& maxError = getMaxError(stats, type);
+			for (int f = 0; f < p_NumFrames; ++f)
+			{
+				maxError = (std::max)(maxError, keyDistance(channel.sample(f), values[f], type));
+			}
+
+			const size_t before = writer.getBytesWritten();
+			writeChannel(writer, channel, p_NumFrames);
+			keyBytes += writer.getBytesWritten() - before;
+		}
+	}
+
+	stats.m_CompressedKeyBytes = keyBytes;
+	return stats;
+}
+
+bool AnimationCompressor::isCompressed(std::istream& p_Input)
+{
+	char fileMagic[sizeof(magic)];
+	const std::streampos start = p_Input.tellg();
+	p_Input.read(fileMagic, sizeof(fileMagic));
+	const bool result = p_Input && memcmp(fileMagic, magic, sizeof(magic)) == 0;
+
+	p_Input.clear();
+	p_Input.seekg(start);
+	return result;
+}
+
+std::vector<Joint> AnimationCompressor::read(std::istream& p_Input, std::string& p_ModelName, int& p_NumFrames)
+{
+	ChannelReader reader(p_Input);
+
+	char fileMagic[sizeof(magic)];
+	reader.read(fileMagic, sizeof(fileMagic));
+	if (memcmp(fileMagic, magic, sizeof(magic)) != 0)
+	{
+		throw CommonException("Not a compressed animation file", __LINE__, __FILE__);
+	}
+	const int fileVersion = reader.readInt();
+	if (fileVersion != version)
+	{
+		throw CommonException("Unsupported compressed animation version: " + std::to_string(fileVersion), __LINE__, __FILE__);
+	}
+
+	p_ModelName = reader.readString();
+	const unsigned int numJoints = reader.readCount(0xffff);
+	p_NumFrames = reader.readCount(0xffff);
+
+	std::vector<Joint> joints(numJoints);
+	for (auto& joint : joints)
+	{
+		joint.m_JointName = reader.readString();
+		joint.m_ID = reader.readInt();
+		joint.m_Parent = reader.readInt();
+		reader.read(&joint.m_TotalJointOffset, sizeof(XMFLOAT4X4));
+
+		joint.m_CompressedAnimation.m_NumFrames = p_NumFrames;
+		for (ChannelType type : channelTypes)
+		{
+			readChannel(reader, p_NumFrames, getChannel(joint.m_CompressedAnimation, type));
+		}
+	}
+
+	return joints;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Joint.h"
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * Reads and writes compressed animation files.
+ *
+ * A compressed .atx file starts with the four bytes in magic, followed by the
+ * version, the model name, the number of joints and the number of frames. Every
+ * joint then stores its name, ID, parent ID and offset matrix as in the raw
+ * format, followed by a translation, a rotation and a scale channel.
+ *
+ * Each channel starts with the number of stored keys. A single key means the
+ * channel is constant and is stored as raw floats. Fewer keys than frames means
+ * the keys were reduced and a 16-bit frame index precedes each key. Translation
+ * and scale keys are quantized to 16 bits per component within the channel's
+ * bounds, rotations use the smallest three encoding in 48 bits, see CompressedChannel.
+ *
+ * The error bounds in Settings apply to the decoded keys, so a channel whose
+ * quantization error alone exceeds its bound is stored with every key.
+ */
+class AnimationCompressor
+{
+public:
+	/**
+	 * The maximum allowed errors when compressing, per component.
+	 */
+	struct Settings
+	{
+		float m_TranslationError;
+		float m_RotationError;
+		float m_ScaleError;
+		/**
+		 * Remove keys that can be linearly interpolated from their neighbours within the errors.
+		 */
+		bool m_ReduceKeys;
+
+		Settings()
+			:	m_TranslationError(0.01f),
+				m_RotationError(0.001f),
+				m_ScaleError(0.001f),
+				m_ReduceKeys(true)
+		{}
+	};
+
+	/**
+	 * Memory use of a compressed animation, in bytes.
+	 */
+	struct Statistics
+	{
+		size_t m_RawKeyBytes;
+		size_t m_CompressedKeyBytes;
+		unsigned int m_ConstantChannels;
+		unsigned int m_ReducedChannels;
+		unsigned int m_TotalChannels;
+		/**
+		 * The largest component error of any sampled frame, quantization included.
+		 */
+		float m_TranslationError;
+		float m_RotationError;
+		float m_ScaleError;
+	};
+
+	static const char magic[4];
+	static const int version = 1;
+
+	/**
+	 * Write a compressed animation file.
+	 *
+	 * @param p_Output the stream to write to, should be binary
+	 * @param p_ModelName the name of the animated model
+	 * @param p_Joints the skeleton, all joints must have p_NumFrames key frames
+	 * @param p_NumFrames the number of frames in the animation
+	 * @param p_Settings the error bounds to stay within
+	 * @return the size of the key data before and after compression
+	 */
+	static Statistics write(std::ostream& p_Output, const std::string& p_ModelName, const std::vector<Joint>& p_Joints,
+		int p_NumFrames, const Settings& p_Settings);
+
+	/**
+	 * Check for the compressed file magic without consuming any input.
+	 *
+	 * @param p_Input the stream positioned at the start of an animation file
+	 * @return true if the file is compressed
+	 */
+	static bool isCompressed(std::istream& p_Input);
+
+	/**
+	 * Read a compressed animation file. The keys are kept compressed in
+	 * Joint::m_CompressedAnimation and decoded when sampled through Joint::getKeyFrame,
+	 * Joint::m_JointAnimation is left empty. The offset matrices are returned as stored in the file.
+	 *
+	 * @param p_Input the stream positioned at the start of the file
+	 * @param p_ModelName receives the name of the animated model
+	 * @param p_NumFrames receives the number of frames
+	 * @return the decoded joints
+	 * @throws CommonException if the data is not a valid compressed animation
+	 */
+	static std::vector<Joint> read(std::istream& p_Input, std::string& p_ModelName, int& p_NumFrames);
+};
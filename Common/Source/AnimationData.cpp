@@ -0,0 +1,88 @@
+#include "AnimationData.h"
+
+using namespace DirectX;
+
+/**
+ * Slots allocated at a time in the pose scratch pools, enough for all players.
+ */
+static const unsigned int poseSlotsPerChunk = 8;
+
+void AnimationData::computeJointData()
+{
+	const size_t numJoints = joints.size();
+
+	inverseBindPoses.resize(numJoints);
+	jointDepths.resize(numJoints);
+	m_JointHandles.clear();
+	for (size_t i = 0; i < numJoints; ++i)
+	{
+		XMMATRIX offset = XMLoadFloat4x4(&joints[i].m_TotalJointOffset);
+		XMStoreFloat4x4(&inverseBindPoses[i], XMMatrixInverse(nullptr, offset));
+
+		const int parent = joints[i].m_Parent;
+		jointDepths[i] = parent > 0 && (size_t)parent <= i ? jointDepths[parent - 1] + 1 : 0;
+
+		m_JointHandles.insert(std::make_pair(joints[i].m_JointName, (Handle)i));
+	}
+
+	clipTable.clear();
+	m_ClipHandles.clear();
+	for (auto& clip : animationClips)
+	{
+		std::vector<bool>& mask = clip.second.m_AffectedJoints;
+		mask.assign(numJoints, false);
+		for (size_t i = 0; i < numJoints; ++i)
+		{
+			if (joints[i].m_JointName == clip.second.m_FirstJoint)
+			{
+				mask[i] = true;
+			}
+			else if (joints[i].m_Parent > 0 && (size_t)joints[i].m_Parent <= i)
+			{
+				mask[i] = mask[joints[i].m_Parent - 1];
+			}
+		}
+
+		m_ClipHandles[clip.first] = (Handle)clipTable.size();
+		clipTable.push_back(&clip.second);
+	}
+
+	ikGroupTable.clear();
+	m_IKGroupHandles.clear();
+	for (const auto& group : ikGroups)
+	{
+		ResolvedIKGroup resolved;
+		resolved.m_Shoulder = findJoint(group.second.m_Shoulder);
+		resolved.m_Elbow = findJoint(group.second.m_Elbow);
+		resolved.m_Hand = findJoint(group.second.m_Hand);
+
+		m_IKGroupHandles[group.first] = (Handle)ikGroupTable.size();
+		ikGroupTable.push_back(resolved);
+	}
+
+	// Local and to root transforms for every instance
+	posePool.reset(new PoseScratchPool(numJoints * 2, poseSlotsPerChunk));
+}
+
+bool AnimationData::hasJointData() const
+{
+	return posePool && inverseBindPoses.size() == joints.size();
+}
+
+AnimationData::Handle AnimationData::findClip(const std::string& p_ClipName) const
+{
+	auto it = m_ClipHandles.find(p_ClipName);
+	return it == m_ClipHandles.end() ? invalidHandle : it->second;
+}
+
+AnimationData::Handle AnimationData::findIKGroup(const std::string& p_GroupName) const
+{
+	auto it = m_IKGroupHandles.find(p_GroupName);
+	return it == m_IKGroupHandles.end() ? invalidHandle : it->second;
+}
+
+AnimationData::Handle AnimationData::findJoint(const std::string& p_JointName) const
+{
+	auto it = m_JointHandles.find(p_JointName);
+	return it == m_JointHandles.end() ? invalidHandle : it->second;
+}
@@ -2,6 +2,7 @@
 
 #include "AnimationClip.h"
 #include "Joint.h"
+#include "PoseScratchPool.h"
 
 #include <map>
 #include <memory>
@@ -12,6 +13,12 @@ struct AnimationData
 
 	std::vector<Joint> joints;
 
+	/**
+	 * The inverse of each joint's m_TotalJointOffset, moving a vector from the
+	 * joint's local space back to bind space. Filled by computeJointData.
+	 */
+	std::vector<DirectX::XMFLOAT4X4> inverseBindPoses;
+
 	/**
 	 * The animation clips. Address them via a name. E.g. "Walk", "Run", "Laugh"...
 	 */
@@ -32,4 +39,75 @@ struct AnimationData
 	 * Some animations need IK coreections at certain frames.
 	 */
 	std::map<std::string, IKGrabShell> grabShells;
+
+	/**
+	 * Interned handle to a clip, IK group or joint, an index into the matching table.
+	 * Resolve names to handles once with the find functions and use the handles per frame.
+	 */
+	typedef int Handle;
+	static const Handle invalidHandle = -1;
+
+	/**
+	 * An IK group with its joint names resolved to joint handles.
+	 */
+	struct ResolvedIKGroup
+	{
+		Handle m_Shoulder;
+		Handle m_Elbow;
+		Handle m_Hand;
+	};
+
+	/**
+	 * The clips by handle, pointing into animationClips.
+	 */
+	std::vector<const AnimationClip*> clipTable;
+
+	/**
+	 * The IK groups by handle.
+	 */
+	std::vector<ResolvedIKGroup> ikGroupTable;
+
+	/**
+	 * The depth of each joint in the hierarchy, 0 for the root.
+	 */
+	std::vector<unsigned int> jointDepths;
+
+	/**
+	 * Scratch memory for the poses of all Animation instances using this data.
+	 */
+	PoseScratchPool::ptr posePool;
+
+	/**
+	 * Precompute the per joint data that is constant for the skeleton: the inverse
+	 * bind poses, the joint depths, the affected joint masks of every clip, the handle tables and
+	 * the pose scratch pool. Has to be called after the joints and clips have been
+	 * loaded and before the data is used by an Animation.
+	 * Joints are expected to be ordered with parents before their children.
+	 */
+	void computeJointData();
+
+	/**
+	 * @return true if computeJointData has been run for the current joints
+	 */
+	bool hasJointData() const;
+
+	/**
+	 * @return the handle of the clip, or invalidHandle if there is no such clip
+	 */
+	Handle findClip(const std::string& p_ClipName) const;
+
+	/**
+	 * @return the handle of the IK group, or invalidHandle if there is no such group
+	 */
+	Handle findIKGroup(const std::string& p_GroupName) const;
+
+	/**
+	 * @return the handle of the joint, which is also its index in joints, or invalidHandle if there is no such joint
+	 */
+	Handle findJoint(const std::string& p_JointName) const;
+
+private:
+	std::map<std::string, Handle> m_ClipHandles;
+	std::map<std::string, Handle> m_IKGroupHandles;
+	std::map<std::string, Handle> m_JointHandles;
 };
@@ -0,0 +1,302 @@
+#include "AnimationJobSystem.h"
+#include "CommonExceptions.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace DirectX;
+
+/**
+ * Matrices allocated at a time in the pose arena, enough for a few dozen characters.
+ */
+static const unsigned int poseArenaChunkSize = 4096;
+
+/**
+ * Poses blended by one task, enough to keep the tasks from being dominated by scheduling.
+ */
+static const unsigned int posesPerBlendTask = 8;
+
+AnimationJobSystem::Job::~Job()
+{
+	m_Arena->release(m_Pose);
+}
+
+const DirectX::XMFLOAT4X4* const* AnimationJobSystem::Job::getPoseSource() const
+{
+	return &m_Pose->m_Front;
+}
+
+unsigned int AnimationJobSystem::Job::getPoseSize() const
+{
+	return m_Pose->m_Size;
+}
+
+AnimationJobSystem::AnimationJobSystem(unsigned int p_NumThreads)
+	:	m_Arena(new PoseArena(poseArenaChunkSize)),
+		m_Generation(0),
+		m_BusyWorkers(0),
+		m_Quit(false),
+		m_NumTasks(0)
+{
+	m_NextTask = 0;
+
+	for (unsigned int i = 0; i < p_NumThreads; ++i)
+	{
+		m_Workers.push_back(std::thread(&AnimationJobSystem::workerLoop, this));
+	}
+}
+
+AnimationJobSystem::~AnimationJobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Lock);
+		m_Quit = true;
+	}
+	m_WorkReady.notify_all();
+
+	for (auto& worker : m_Workers)
+	{
+		worker.join();
+	}
+}
+
+AnimationJobSystem::JobPtr AnimationJobSystem::registerAnimation(Animation* p_Animation, std::function<void()> p_Finish)
+{
+	if (!p_Animation || !p_Animation->getAnimationData())
+	{
+		throw InvalidArgument("Animation must have animation data to be registered", __LINE__, __FILE__);
+	}
+
+	JobPtr job(new Job);
+	job->m_Animation = p_Animation;
+	job->m_Finish = p_Finish;
+	job->m_Arena = m_Arena;
+	job->m_Pose = m_Arena->allocate((std::max)((unsigned int)p_Animation->getAnimationData()->joints.size(), 1u));
+	job->m_DeltaTime = 0.f;
+	job->m_Interval = 0.f;
+	job->m_Queued = false;
+	job->m_Evaluate = false;
+	job->m_BatchIndex = 0;
+
+	m_Jobs.erase(std::remove_if(m_Jobs.begin(), m_Jobs.end(),
+		[] (const std::weak_ptr<Job>& p_Job) { return p_Job.expired(); }),
+		m_Jobs.end());
+	m_Jobs.push_back(job);
+
+	return job;
+}
+
+void AnimationJobSystem::submit(const JobPtr& p_Job, float p_DeltaTime, float p_Interval)
+{
+	p_Job->m_Interval = p_Interval;
+	if (p_Job->m_Queued)
+	{
+		p_Job->m_DeltaTime += p_DeltaTime;
+		return;
+	}
+
+	p_Job->m_DeltaTime = p_DeltaTime;
+	p_Job->m_Queued = true;
+	m_Submitted.push_back(p_Job);
+}
+
+void AnimationJobSystem::run()
+{
+	// Owners released since they submitted are skipped
+	m_Running.clear();
+	for (const auto& submitted : m_Submitted)
+	{
+		JobPtr job = submitted.lock();
+		if (job)
+		{
+			job->m_Queued = false;
+			m_Running.push_back(job);
+		}
+	}
+	m_Submitted.clear();
+
+	if (m_Running.empty())
+	{
+		return;
+	}
+
+	// Animations between throttled evaluations only extrapolate their last poses
+	parallelFor(m_Running.size(), [this] (unsigned int p_Job)
+	{
+		Job* job = m_Running[p_Job].get();
+		job->m_Evaluate = job->m_Animation->prepareUpdate(job->m_DeltaTime, job->m_Interval);
+	});
+
+	m_Evaluating.clear();
+	unsigned int maxJoints = 0;
+	for (const auto& job : m_Running)
+	{
+		if (job->m_Evaluate)
+		{
+			job->m_BatchIndex = m_Evaluating.size();
+			m_Evaluating.push_back(job.get());
+			maxJoints = (std::max)(maxJoints, (unsigned int)job->m_Animation->getAnimationData()->joints.size());
+		}
+	}
+
+	if (!m_Evaluating.empty())
+	{
+		// Each animation only touches its own pose in the batch, the shared animation data is read only
+		const unsigned int numPoses = m_Evaluating.size();
+		m_Batch.resize(numPoses, maxJoints);
+		parallelFor(numPoses, [this] (unsigned int p_Job)
+		{
+			const Job* job = m_Evaluating[p_Job];
+			job->m_Animation->samplePose(m_Batch, job->m_BatchIndex);
+		});
+
+		parallelFor((numPoses + posesPerBlendTask - 1) / posesPerBlendTask, [this, numPoses] (unsigned int p_Task)
+		{
+			const unsigned int first = p_Task * posesPerBlendTask;
+			m_Batch.blend(first, (std::min)(posesPerBlendTask, numPoses - first));
+		});
+
+		parallelFor(numPoses, [this] (unsigned int p_Job)
+		{
+			const Job* job = m_Evaluating[p_Job];
+			job->m_Animation->finishUpdate(m_Batch.base, job->m_BatchIndex);
+		});
+		m_Evaluating.clear();
+	}
+
+	// Owners may read the new pose and apply IK, which needs the rest of the game state
+	for (const auto& job : m_Running)
+	{
+		if (job->m_Finish)
+		{
+			job->m_Finish();
+		}
+	}
+
+	for (const auto& job : m_Running)
+	{
+		const std::vector<XMFLOAT4X4>& finalTransform = job->m_Animation->getFinalTransform();
+		PoseArena::Pose* pose = job->m_Pose;
+
+		const size_t size = (std::min)(finalTransform.size(), (size_t)pose->m_Size);
+		if (size > 0)
+		{
+			memcpy(pose->m_Back, finalTransform.data(), size * sizeof(XMFLOAT4X4));
+		}
+		PoseArena::publish(pose);
+	}
+
+	m_Running.clear();
+}
+
+unsigned int AnimationJobSystem::getNumThreads() const
+{
+	return m_Workers.size();
+}
+
+unsigned int AnimationJobSystem::getNumJobs() const
+{
+	unsigned int count = 0;
+	for (const auto& job : m_Jobs)
+	{
+		if (!job.expired())
+		{
+			++count;
+		}
+	}
+	return count;
+}
+
+void AnimationJobSystem::workerLoop()
+{
+	unsigned int lastGeneration = 0;
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_Lock);
+			m_WorkReady.wait(lock, [&] () { return m_Quit || m_Generation != lastGeneration; });
+			if (m_Quit)
+			{
+				return;
+			}
+			lastGeneration = m_Generation;
+		}
+
+		runTasks();
+
+		bool lastWorker = false;
+		{
+			std::lock_guard<std::mutex> lock(m_Lock);
+			lastWorker = --m_BusyWorkers == 0;
+		}
+		if (lastWorker)
+		{
+			m_WorkDone.notify_one();
+		}
+	}
+}
+
+void AnimationJobSystem::parallelFor(unsigned int p_NumTasks, std::function<void(unsigned int)> p_Task)
+{
+	if (p_NumTasks == 0)
+	{
+		return;
+	}
+
+	m_Task.swap(p_Task);
+	m_NumTasks = p_NumTasks;
+	m_NextTask = 0;
+
+	// A single task is not worth waking the workers for
+	if (m_Workers.empty() || p_NumTasks == 1)
+	{
+		runTasks();
+	}
+	else
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Lock);
+			m_BusyWorkers = m_Workers.size();
+			++m_Generation;
+		}
+		m_WorkReady.notify_all();
+
+		// The calling thread takes tasks as well
+		runTasks();
+
+		// The workers may still be running tasks of this stage, even if one of them failed
+		std::unique_lock<std::mutex> lock(m_Lock);
+		m_WorkDone.wait(lock, [this] () { return m_BusyWorkers == 0; });
+	}
+
+	m_Task = nullptr;
+
+	if (m_TaskError)
+	{
+		std::exception_ptr error = m_TaskError;
+		m_TaskError = nullptr;
+		std::rethrow_exception(error);
+	}
+}
+
+void AnimationJobSystem::runTasks()
+{
+	const unsigned int numTasks = m_NumTasks;
+	for (unsigned int i = m_NextTask++; i < numTasks; i = m_NextTask++)
+	{
+		try
+		{
+			m_Task(i);
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> lock(m_Lock);
+			if (!m_TaskError)
+			{
+				m_TaskError = std::current_exception();
+			}
+			// Skip the tasks nobody has taken yet
+			m_NextTask = numTasks;
+		}
+	}
+}
@@ -0,0 +1,166 @@
+#pragma once
+
+#include "Animation.h"
+#include "PoseArena.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Evaluates the poses of all animated actors in one stage, spread over a worker pool.
+ *
+ * Owners register their Animation once and submit it every frame they want it
+ * updated. run() samples the tracks of all submitted animations into one
+ * Animation::BlendBatch, blends the batch with PoseBlender and builds the final
+ * transformations, each stage spread over the workers. It then calls each owner's
+ * finish callback on the calling thread in submission order, for work such as IK
+ * that needs the new pose and the rest of the game state. Finally the poses are
+ * written to the back buffers of a PoseArena and published, where the renderer
+ * reads them without copying.
+ *
+ * With zero worker threads everything runs on the calling thread in submission
+ * order, which gives deterministic results for tests.
+ */
+class AnimationJobSystem
+{
+public:
+	/**
+	 * The registration of one animation. Owned by the registering actor, the
+	 * job system drops it when the last reference is released.
+	 */
+	class Job
+	{
+	private:
+		friend class AnimationJobSystem;
+
+		Animation* m_Animation;
+		std::function<void()> m_Finish;
+		PoseArena::ptr m_Arena;
+		PoseArena::Pose* m_Pose;
+		float m_DeltaTime;
+		float m_Interval;
+		bool m_Queued;
+		/**
+		 * True if the animation evaluates a new pose in the current run.
+		 */
+		bool m_Evaluate;
+		/**
+		 * The pose of the animation in the blend batch while it is evaluated.
+		 */
+		unsigned int m_BatchIndex;
+
+	public:
+		~Job();
+
+		/**
+		 * @return the location of the pointer to the latest published pose, for IGraphics::setAnimationPoseSource
+		 */
+		const DirectX::XMFLOAT4X4* const* getPoseSource() const;
+
+		/**
+		 * @return the number of matrices in the published pose
+		 */
+		unsigned int getPoseSize() const;
+	};
+	typedef std::shared_ptr<Job> JobPtr;
+
+private:
+	PoseArena::ptr m_Arena;
+	std::vector<std::weak_ptr<Job>> m_Jobs;
+	std::vector<std::weak_ptr<Job>> m_Submitted;
+	std::vector<JobPtr> m_Running;
+	/**
+	 * The running jobs that evaluate a new pose this frame, the others only extrapolate.
+	 */
+	std::vector<Job*> m_Evaluating;
+	Animation::BlendBatch m_Batch;
+
+	std::vector<std::thread> m_Workers;
+	std::mutex m_Lock;
+	std::condition_variable m_WorkReady;
+	std::condition_variable m_WorkDone;
+	unsigned int m_Generation;
+	unsigned int m_BusyWorkers;
+	bool m_Quit;
+	/**
+	 * The stage being run, called with the index of each task.
+	 */
+	std::function<void(unsigned int)> m_Task;
+	unsigned int m_NumTasks;
+	std::atomic<unsigned int> m_NextTask;
+	/**
+	 * The first exception thrown by a task of the stage, rethrown on the calling thread.
+	 */
+	std::exception_ptr m_TaskError;
+
+public:
+	/**
+	 * Constructor, starts the worker threads.
+	 *
+	 * @param p_NumThreads the number of worker threads in addition to the thread calling run(),
+	 *			0 to evaluate everything on the calling thread
+	 */
+	explicit AnimationJobSystem(unsigned int p_NumThreads);
+
+	/**
+	 * Destructor, stops the worker threads.
+	 */
+	~AnimationJobSystem();
+
+	/**
+	 * Register an animation to be evaluated by the job system. The animation data
+	 * has to be set before registering.
+	 *
+	 * @param p_Animation the animation, must outlive the returned job
+	 * @param p_Finish called on the thread calling run() after the pose is evaluated, may be empty
+	 * @return the registration, release it to unregister
+	 */
+	JobPtr registerAnimation(Animation* p_Animation, std::function<void()> p_Finish);
+
+	/**
+	 * Queue a registered animation to be updated by the next run(). Submitting
+	 * the same animation again before run() adds to its time step.
+	 *
+	 * @param p_Job the registration
+	 * @param p_DeltaTime the time since the previous frame
+	 * @param p_Interval the time between evaluated poses, see Animation::updateAnimationThrottled
+	 */
+	void submit(const JobPtr& p_Job, float p_DeltaTime, float p_Interval);
+
+	/**
+	 * Evaluate all submitted animations, call their finish callbacks and publish the poses.
+	 *
+	 * If an animation throws while it is evaluated, the rest of the stage is skipped and
+	 * the exception is rethrown here once all workers are idle. The next run starts over
+	 * with the animations submitted after it.
+	 */
+	void run();
+
+	/**
+	 * @return the number of worker threads, not counting the thread calling run()
+	 */
+	unsigned int getNumThreads() const;
+
+	/**
+	 * @return the number of registered animations
+	 */
+	unsigned int getNumJobs() const;
+
+private:
+	void workerLoop();
+	/**
+	 * Run a task for every index in [0, p_NumTasks) on the workers and the calling thread.
+	 * Returns when all workers are done, and rethrows the first exception thrown by a task.
+	 */
+	void parallelFor(unsigned int p_NumTasks, std::function<void(unsigned int)> p_Task);
+	void runTasks();
+
+	AnimationJobSystem(const AnimationJobSystem&);
+	AnimationJobSystem& operator=(const AnimationJobSystem&);
+};
@@ -0,0 +1,184 @@
+#include "AnimationLOD.h"
+#include "TweakSettings.h"
+
+#include <algorithm>
+#include <functional>
+
+using namespace DirectX;
+
+AnimationLOD::AnimationLOD()
+{
+	TierSettings& full = m_Tiers[(int)Tier::FULL];
+	full.m_MaxDistance = 2000.f;
+	full.m_UpdateInterval = 0.f;
+	full.m_UseIK = true;
+	full.m_MaxJointDepth = 0;
+	full.m_Budget = 8;
+
+	TierSettings& reduced = m_Tiers[(int)Tier::REDUCED];
+	reduced.m_MaxDistance = 6000.f;
+	reduced.m_UpdateInterval = 1.f / 20.f;
+	reduced.m_UseIK = false;
+	reduced.m_MaxJointDepth = 0;
+	reduced.m_Budget = 16;
+
+	TierSettings& low = m_Tiers[(int)Tier::LOW];
+	low.m_MaxDistance = 0.f;
+	low.m_UpdateInterval = 1.f / 8.f;
+	low.m_UseIK = false;
+	low.m_MaxJointDepth = 4;
+	low.m_Budget = 0;
+
+	for (unsigned int& count : m_TierCounts)
+	{
+		count = 0;
+	}
+}
+
+AnimationLOD::~AnimationLOD()
+{
+	unregisterTweakSettings();
+}
+
+AnimationLOD::InstancePtr AnimationLOD::registerInstance()
+{
+	InstancePtr instance(new Instance);
+	instance->m_Position = XMFLOAT3(0.f, 0.f, 0.f);
+	instance->m_Tier = Tier::FULL;
+	instance->m_Settings = m_Tiers[(int)Tier::FULL];
+
+	m_Instances.push_back(instance);
+	return instance;
+}
+
+void AnimationLOD::assignTiers(const DirectX::XMFLOAT3& p_ViewPoint)
+{
+	m_Instances.erase(std::remove_if(m_Instances.begin(), m_Instances.end(),
+		[] (const std::weak_ptr<Instance>& p_Instance) { return p_Instance.expired(); }),
+		m_Instances.end());
+
+	// The owners are alive for the duration of this call, raw pointers are fine
+	const XMVECTOR viewPoint = XMLoadFloat3(&p_ViewPoint);
+	m_SortedInstances.clear();
+	for (const auto& weakInstance : m_Instances)
+	{
+		InstancePtr instance = weakInstance.lock();
+		const float distanceSq = XMVectorGetX(XMVector3LengthSq(XMVectorSubtract(XMLoadFloat3(&instance->m_Position), viewPoint)));
+		m_SortedInstances.push_back(std::make_pair(distanceSq, instance.get()));
+	}
+
+	std::sort(m_SortedInstances.begin(), m_SortedInstances.end(),
+		[] (const std::pair<float, Instance*>& p_A, const std::pair<float, Instance*>& p_B) { return p_A.first < p_B.first; });
+
+	for (unsigned int& count : m_TierCounts)
+	{
+		count = 0;
+	}
+
+	// Sorted by distance, so the tier never improves further down the list
+	unsigned int tier = 0;
+	for (const auto& entry : m_SortedInstances)
+	{
+		while (tier < numTiers - 1)
+		{
+			const TierSettings& settings = m_Tiers[tier];
+			const bool inRange = entry.first <= settings.m_MaxDistance * settings.m_MaxDistance;
+			const bool hasBudget = settings.m_Budget == 0 || m_TierCounts[tier] < settings.m_Budget;
+			if (inRange && hasBudget)
+			{
+				break;
+			}
+			++tier;
+		}
+
+		entry.second->m_Tier = (Tier)tier;
+		entry.second->m_Settings = m_Tiers[tier];
+		++m_TierCounts[tier];
+	}
+}
+
+void AnimationLOD::setTierSettings(Tier p_Tier, const TierSettings& p_Settings)
+{
+	m_Tiers[(int)p_Tier] = p_Settings;
+}
+
+const AnimationLOD::TierSettings& AnimationLOD::getTierSettings(Tier p_Tier) const
+{
+	return m_Tiers[(int)p_Tier];
+}
+
+unsigned int AnimationLOD::getTierCount(Tier p_Tier) const
+{
+	return m_TierCounts[(int)p_Tier];
+}
+
+std::string AnimationLOD::getTierCountText() const
+{
+	return std::to_string(m_TierCounts[(int)Tier::FULL]) + " full, "
+		+ std::to_string(m_TierCounts[(int)Tier::REDUCED]) + " reduced, "
+		+ std::to_string(m_TierCounts[(int)Tier::LOW]) + " low";
+}
+
+void AnimationLOD::registerTweakSettings()
+{
+	unregisterTweakSettings();
+
+	TweakSettings* settings = TweakSettings::getInstance();
+
+	static const char* tierNames[numTiers] = { "full", "reduced", "low" };
+	for (unsigned int i = 0; i < numTiers; ++i)
+	{
+		const std::string prefix = std::string("animation.lod.") + tierNames[i];
+		TierSettings* tier = &m_Tiers[i];
+
+		if (i < numTiers - 1)
+		{
+			settings->setSetting(prefix + ".distance", tier->m_MaxDistance);
+			settings->setListener(prefix + ".distance", std::function<void(float)>(
+				[tier] (float p_Value)
+			{
+				tier->m_MaxDistance = p_Value;
+			}));
+			m_TweakSettings.push_back(prefix + ".distance");
+
+			settings->setSetting(prefix + ".budget", (int)tier->m_Budget);
+			settings->setListener(prefix + ".budget", std::function<void(int)>(
+				[tier] (int p_Value)
+			{
+				tier->m_Budget = (unsigned int)(std::max)(p_Value, 0);
+			}));
+			m_TweakSettings.push_back(prefix + ".budget");
+		}
+
+		settings->setSetting(prefix + ".interval", tier->m_UpdateInterval);
+		settings->setListener(prefix + ".interval", std::function<void(float)>(
+			[tier] (float p_Value)
+		{
+			tier->m_UpdateInterval = p_Value;
+		}));
+		m_TweakSettings.push_back(prefix + ".interval");
+
+		settings->setSetting(prefix + ".jointDepth", (int)tier->m_MaxJointDepth);
+		settings->setListener(prefix + ".jointDepth", std::function<void(int)>(
+			[tier] (int p_Value)
+		{
+			tier->m_MaxJointDepth = (unsigned int)(std::max)(p_Value, 0);
+		}));
+		m_TweakSettings.push_back(prefix + ".jointDepth");
+	}
+}
+
+void AnimationLOD::unregisterTweakSettings()
+{
+	if (m_TweakSettings.empty())
+	{
+		return;
+	}
+
+	TweakSettings* settings = TweakSettings::getInstance();
+	for (const std::string& setting : m_TweakSettings)
+	{
+		settings->removeListener(setting);
+	}
+	m_TweakSettings.clear();
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <DirectXMath.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Assigns animation level of detail tiers to animated instances.
+ *
+ * Instances are sorted by their distance to the view point and handed the best
+ * tier they are within range of, as long as that tier still has budget left.
+ * Instances that do not fit are pushed down to the next tier. The last tier
+ * accepts any number of instances at any distance.
+ */
+class AnimationLOD
+{
+public:
+	enum class Tier
+	{
+		FULL,
+		REDUCED,
+		LOW,
+	};
+	static const unsigned int numTiers = 3;
+
+	/**
+	 * How instances in a tier are animated.
+	 */
+	struct TierSettings
+	{
+		/**
+		 * The largest distance from the view point for the tier. Ignored for the last tier.
+		 */
+		float m_MaxDistance;
+		/**
+		 * The time in seconds between evaluated poses, 0 to evaluate every frame.
+		 */
+		float m_UpdateInterval;
+		/**
+		 * Whether reach and look at IK is applied.
+		 */
+		bool m_UseIK;
+		/**
+		 * The deepest joint to sample, 0 samples all joints.
+		 */
+		unsigned int m_MaxJointDepth;
+		/**
+		 * The maximum number of instances in the tier, 0 for no limit.
+		 */
+		unsigned int m_Budget;
+	};
+
+	/**
+	 * The LOD state of one animated instance. The owner writes the position
+	 * and reads the tier and its settings.
+	 */
+	struct Instance
+	{
+		DirectX::XMFLOAT3 m_Position;
+		Tier m_Tier;
+		TierSettings m_Settings;
+	};
+	typedef std::shared_ptr<Instance> InstancePtr;
+
+private:
+	TierSettings m_Tiers[numTiers];
+	unsigned int m_TierCounts[numTiers];
+	std::vector<std::weak_ptr<Instance>> m_Instances;
+	std::vector<std::pair<float, Instance*>> m_SortedInstances;
+	/**
+	 * The settings with listeners writing to m_Tiers.
+	 */
+	std::vector<std::string> m_TweakSettings;
+
+public:
+	/**
+	 * Constructor, sets up the default tiers.
+	 */
+	AnimationLOD();
+
+	/**
+	 * Destructor, removes the listeners added by registerTweakSettings.
+	 */
+	~AnimationLOD();
+
+	/**
+	 * Add an instance to be managed. The instance is dropped when the last
+	 * reference to it is released, so the manager can be destroyed first.
+	 * New instances start in the full tier until the next assignTiers.
+	 *
+	 * @return the instance state, owned by the caller
+	 */
+	InstancePtr registerInstance();
+
+	/**
+	 * Assign tiers to all instances. Call once per frame before the instances update.
+	 *
+	 * @param p_ViewPoint the position of the camera
+	 */
+	void assignTiers(const DirectX::XMFLOAT3& p_ViewPoint);
+
+	void setTierSettings(Tier p_Tier, const TierSettings& p_Settings);
+	const TierSettings& getTierSettings(Tier p_Tier) const;
+
+	/**
+	 * @return the number of instances assigned to the tier by the latest assignTiers
+	 */
+	unsigned int getTierCount(Tier p_Tier) const;
+
+	/**
+	 * @return the number of instances in each tier as a short text for debug output
+	 */
+	std::string getTierCountText() const;
+
+	/**
+	 * Expose the tier distances, budgets and update rates as tweak settings,
+	 * prefixed with "animation.lod.". The listeners refer to this object, so
+	 * TweakSettings has to outlive it.
+	 */
+	void registerTweakSettings();
+
+	/**
+	 * Remove the listeners added by registerTweakSettings, the settings keep their values.
+	 */
+	void unregisterTweakSettings();
+
+private:
+	AnimationLOD(const AnimationLOD&);
+	AnimationLOD& operator=(const AnimationLOD&);
+};
@@ -1,9 +1,64 @@
 #include "AnimationLoader.h"
 
-#include "AnimationClipLoader.h"
+#include "AnimationCompressor.h"
+#include "AnimationMetadata.h"
 
 #include <algorithm>
 #include <boost/filesystem.hpp>
+#include <cstring>
+
+namespace
+{
+	/**
+	 * Lets the animation readers parse a file that has already been read into memory.
+	 */
+	class MemoryBuffer : public std::streambuf
+	{
+	public:
+		MemoryBuffer(char* p_Data, size_t p_Size)
+		{
+			setg(p_Data, p_Data, p_Data + p_Size);
+		}
+
+		size_t getPosition() const
+		{
+			return gptr() - eback();
+		}
+
+	protected:
+		pos_type seekoff(off_type p_Offset, std::ios_base::seekdir p_Direction, std::ios_base::openmode p_Mode)
+		{
+			char* base = p_Direction == std::ios_base::beg ? eback() : p_Direction == std::ios_base::cur ? gptr() : egptr();
+			char* position = base + p_Offset;
+			if (!(p_Mode & std::ios_base::in) || position < eback() || position > egptr())
+			{
+				return pos_type(off_type(-1));
+			}
+			setg(eback(), position, egptr());
+			return pos_type(position - eback());
+		}
+
+		pos_type seekpos(pos_type p_Position, std::ios_base::openmode p_Mode)
+		{
+			return seekoff(off_type(p_Position), std::ios_base::beg, p_Mode);
+		}
+	};
+
+	/**
+	 * @return true if the first file exists and was written after the second, or the second is missing
+	 */
+	bool isNewer(const boost::filesystem::path& p_File, const boost::filesystem::path& p_Other)
+	{
+		boost::system::error_code error;
+		const std::time_t fileTime = boost::filesystem::last_write_time(p_File, error);
+		if (error)
+		{
+			return false;
+		}
+		const std::time_t otherTime = boost::filesystem::last_write_time(p_Other, error);
+		return error || fileTime > otherTime;
+	}
+}
 
 AnimationLoader::AnimationLoader(void)
 {
@@ -43,60 +98,101 @@ std::vector<Joint> AnimationLoader::readJointList(int p_NumberOfJoint, int p_Num
 		p_Input->read(reinterpret_cast<char*>(&temp.m_TotalJointOffset), sizeof(DirectX::XMFLOAT4X4));
 		p_Input->read(reinterpret_cast<char*>(temp.m_JointAnimation.data()), sizeof(KeyFrame) * p_NumberOfFrames);
 
-		using namespace DirectX;
-		
-		XMMATRIX offset = XMLoadFloat4x4(&temp.m_TotalJointOffset);
+		readJoints.push_back(temp);
+	}
+	computeJointOffsets(readJoints);
+	return readJoints;
+}
+
+void AnimationLoader::computeJointOffsets(std::vector<Joint>& p_Joints)
+{
+	using namespace DirectX;
+
+	for (auto& joint : p_Joints)
+	{
+		XMMATRIX offset = XMLoadFloat4x4(&joint.m_TotalJointOffset);
 		offset = XMMatrixTranspose(offset);
-		XMStoreFloat4x4(&temp.m_TotalJointOffset, offset);
+		XMStoreFloat4x4(&joint.m_TotalJointOffset, offset);
 
 		// Precompute the total offset matrix for the joints
-		if (temp.m_Parent == 0)
+		if (joint.m_Parent == 0)
 		{
-			XMStoreFloat4x4(&temp.m_JointOffsetMatrix, XMMatrixTranspose(offset));
+			XMStoreFloat4x4(&joint.m_JointOffsetMatrix, XMMatrixTranspose(offset));
 		}
 		else
 		{
-			XMMATRIX parent = XMLoadFloat4x4(&readJoints[temp.m_Parent - 1].m_TotalJointOffset);
+			XMMATRIX parent = XMLoadFloat4x4(&p_Joints[joint.m_Parent - 1].m_TotalJointOffset);
 			parent = XMMatrixInverse(nullptr, parent);
 
 			XMMATRIX sumOffset = XMMatrixMultiply(parent, offset);
-			XMStoreFloat4x4(&temp.m_JointOffsetMatrix, XMMatrixTranspose(sumOffset));
+			XMStoreFloat4x4(&joint.m_JointOffsetMatrix, XMMatrixTranspose(sumOffset));
 		}
-
-		readJoints.push_back(temp);
 	}
-	return readJoints;
 }
 
-void AnimationLoader::loadAnimationData(std::string p_FilePath)
+void AnimationLoader::loadAnimationData(std::istream& p_Input)
 {
 	clearData();
-	std::ifstream input(p_FilePath, std::istream::in | std::istream::binary);
-	m_FileHeader = readHeader(&input);
-	m_Joints = readJointList(m_FileHeader.m_NumJoints, m_FileHeader.m_NumFrames, &input);
-
-	input.close();
+	if (AnimationCompressor::isCompressed(p_Input))
+	{
+		m_Joints = AnimationCompressor::read(p_Input, m_FileHeader.m_ModelName, m_FileHeader.m_NumFrames);
+		m_FileHeader.m_NumJoints = m_Joints.size();
+		computeJointOffsets(m_Joints);
+	}
+	else
+	{
+		m_FileHeader = readHeader(&p_Input);
+		m_Joints = readJointList(m_FileHeader.m_NumJoints, m_FileHeader.m_NumFrames, &p_Input);
+	}
 }
 
 bool AnimationLoader::loadAnimationDataResource(const char* p_ResourceName, const char* p_FilePath)
 {
+	// Read the whole file at once, the metadata may follow the animation
+	std::ifstream file(p_FilePath, std::istream::in | std::istream::binary | std::istream::ate);
+	if (!file)
+	{
+		return false;
+	}
+	std::vector<char> buffer((size_t)file.tellg());
+	file.seekg(0);
+	file.read(buffer.data(), buffer.size());
+	file.close();
+
+	MemoryBuffer memory(buffer.data(), buffer.size());
+	std::istream input(&memory);
 	AnimationData::ptr data(new AnimationData);
-	loadAnimationData(p_FilePath);
+	loadAnimationData(input);
 	data->joints = getJoints();
 	clearData();
+	const size_t animationSize = memory.getPosition();
 
 	LoadedAnimationData loadedData;
 	loadedData.animationData = data;
 	loadedData.filename = p_FilePath;
 	loadedData.resourceName = p_ResourceName;
 
-	boost::filesystem::path filepath(p_FilePath);
-	boost::filesystem::path mlxPath(filepath.replace_extension("mlx"));
+	// Prefer the metadata packed by BinaryConverter, unless the text source has been edited since
+	const boost::filesystem::path filepath(p_FilePath);
+	const boost::filesystem::path textPath = boost::filesystem::path(filepath).replace_extension("mlx");
+	const boost::filesystem::path binaryPath = boost::filesystem::path(filepath).replace_extension("bmlx");
+	const bool embedded = buffer.size() - animationSize >= sizeof(AnimationMetadata::magic) &&
+		memcmp(buffer.data() + animationSize, AnimationMetadata::magic, sizeof(AnimationMetadata::magic)) == 0;
+	AnimationMetadata metadata;
+	if (embedded && !isNewer(textPath, filepath))
+	{
+		metadata = AnimationMetadata::read(buffer.data() + animationSize, buffer.size() - animationSize);
+	}
+	else if (isNewer(textPath, binaryPath) || !AnimationMetadata::loadBinary(binaryPath.string(), metadata))
+	{
+		metadata = AnimationMetadata::loadText(textPath.string());
+	}
 
-	data->animationClips = MattiasLucaseXtremeLoader::loadAnimationClip(mlxPath.string());
-	data->ikGroups = MattiasLucaseXtremeLoader::loadIKGroup(mlxPath.string());
-	data->animationPath = MattiasLucaseXtremeLoader::loadAnimationPath(mlxPath.string());
-	data->grabShells = MattiasLucaseXtremeLoader::loadIKGrabs(mlxPath.string());
+	data->animationClips.swap(metadata.m_Clips);
+	data->ikGroups.swap(metadata.m_IKGroups);
+	data->animationPath.swap(metadata.m_Paths);
+	data->grabShells.swap(metadata.m_GrabShells);
+	data->computeJointData();
 
 	m_LoadedAnimations.push_back(loadedData);
 
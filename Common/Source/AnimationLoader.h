@@ -56,15 +56,24 @@ protected:
 
 	Header readHeader(std::istream* p_Input);
 	std::vector<Joint> readJointList(int p_NumberOfJoint, int p_NumberOfFrames, std::istream* p_Input);
+
+	/**
+	 * Convert the offset matrices as stored in the file into m_TotalJointOffset
+	 * and m_JointOffsetMatrix. Parents have to come before their children.
+	 *
+	 * @param p_Joints the joints read from a raw or compressed file
+	 */
+	static void computeJointOffsets(std::vector<Joint>& p_Joints);
 private:
 	void clearData();
 
 	/**
-	 * Opens a binary file then reads the information stream and saves the information in vectors of structs.
+	 * Reads an animation, raw or compressed by AnimationCompressor, from the stream and saves the information in vectors of structs.
+	 * The stream is left right after the animation, where ModelConverter may have appended the metadata.
 	 * 
-	 * @param p_FilePath, the absolute path to the source file.
+	 * @param p_Input a binary stream positioned at the start of the animation.
 	 */
-	void loadAnimationData(std::string p_FilePath);
+	void loadAnimationData(std::istream& p_Input);
 
 	/**
 	 * Returns a vector of joints for the animation. 
@@ -0,0 +1,290 @@
+#include "AnimationMetadata.h"
+
+#include "AnimationClipLoader.h"
+#include "CommonExceptions.h"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+const char AnimationMetadata::magic[4] = { 'A', 'M', 'L', 'X' };
+
+namespace
+{
+	/**
+	 * Bounds checked reading from the loaded file.
+	 */
+	class Reader
+	{
+	private:
+		const char* m_Pos;
+		const char* m_End;
+
+	public:
+		Reader(const char* p_Data, size_t p_Size)
+			:	m_Pos(p_Data),
+				m_End(p_Data + p_Size)
+		{
+		}
+
+		void readBytes(void* p_Dest, size_t p_Size)
+		{
+			if ((size_t)(m_End - m_Pos) < p_Size)
+			{
+				throw CommonException("Animation metadata is truncated", __LINE__, __FILE__);
+			}
+			memcpy(p_Dest, m_Pos, p_Size);
+			m_Pos += p_Size;
+		}
+
+		int32_t readInt()
+		{
+			int32_t value;
+			readBytes(&value, sizeof(value));
+			return value;
+		}
+
+		float readFloat()
+		{
+			float value;
+			readBytes(&value, sizeof(value));
+			return value;
+		}
+
+		bool readBool()
+		{
+			return readInt() != 0;
+		}
+
+		unsigned int readCount()
+		{
+			const int32_t count = readInt();
+			if (count < 0 || count > m_End - m_Pos)
+			{
+				throw CommonException("Animation metadata has an invalid count", __LINE__, __FILE__);
+			}
+			return count;
+		}
+
+		std::string readString()
+		{
+			const unsigned int length = readCount();
+			std::string value(m_Pos, length);
+			m_Pos += length;
+			return value;
+		}
+
+		void readPath(std::vector<DirectX::XMFLOAT2>& p_Path)
+		{
+			p_Path.resize(readCount());
+			if (!p_Path.empty())
+			{
+				readBytes(p_Path.data(), p_Path.size() * sizeof(DirectX::XMFLOAT2));
+			}
+		}
+	};
+
+	void writeInt(std::ostream& p_Output, int32_t p_Value)
+	{
+		p_Output.write(reinterpret_cast<const char*>(&p_Value), sizeof(p_Value));
+	}
+
+	void writeFloat(std::ostream& p_Output, float p_Value)
+	{
+		p_Output.write(reinterpret_cast<const char*>(&p_Value), sizeof(p_Value));
+	}
+
+	void writeString(std::ostream& p_Output, const std::string& p_Value)
+	{
+		writeInt(p_Output, p_Value.size());
+		p_Output.write(p_Value.data(), p_Value.size());
+	}
+
+	void writePath(std::ostream& p_Output, const std::vector<DirectX::XMFLOAT2>& p_Path)
+	{
+		writeInt(p_Output, p_Path.size());
+		if (!p_Path.empty())
+		{
+			p_Output.write(reinterpret_cast<const char*>(p_Path.data()), p_Path.size() * sizeof(DirectX::XMFLOAT2));
+		}
+	}
+}
+
+AnimationMetadata AnimationMetadata::loadText(const std::string& p_Filename)
+{
+	AnimationMetadata metadata;
+	metadata.m_Clips = MattiasLucaseXtremeLoader::loadAnimationClip(p_Filename);
+	metadata.m_IKGroups = MattiasLucaseXtremeLoader::loadIKGroup(p_Filename);
+	metadata.m_Paths = MattiasLucaseXtremeLoader::loadAnimationPath(p_Filename);
+	metadata.m_GrabShells = MattiasLucaseXtremeLoader::loadIKGrabs(p_Filename);
+	return metadata;
+}
+
+bool AnimationMetadata::loadBinary(const std::string& p_Filename, AnimationMetadata& p_Metadata)
+{
+	std::ifstream input(p_Filename, std::istream::in | std::istream::binary);
+	if (!input)
+	{
+		return false;
+	}
+
+	input.seekg(0, std::istream::end);
+	std::vector<char> buffer((size_t)input.tellg());
+	input.seekg(0, std::istream::beg);
+	if (!buffer.empty())
+	{
+		input.read(buffer.data(), buffer.size());
+	}
+
+	p_Metadata = read(buffer.data(), buffer.size());
+	return true;
+}
+
+AnimationMetadata AnimationMetadata::read(const char* p_Data, size_t p_Size)
+{
+	Reader reader(p_Data, p_Size);
+
+	char fileMagic[sizeof(magic)];
+	reader.readBytes(fileMagic, sizeof(fileMagic));
+	if (memcmp(fileMagic, magic, sizeof(magic)) != 0)
+	{
+		throw CommonException("File is not binary animation metadata", __LINE__, __FILE__);
+	}
+	if (reader.readInt() != version)
+	{
+		throw CommonException("Unsupported animation metadata version", __LINE__, __FILE__);
+	}
+
+	AnimationMetadata metadata;
+
+	for (unsigned int i = reader.readCount(); i > 0; --i)
+	{
+		AnimationClip clip;
+		clip.m_ClipName = reader.readString();
+		clip.m_AnimationSpeed = reader.readFloat();
+		clip.m_Start = reader.readInt();
+		clip.m_End = reader.readInt();
+		clip.m_Loop = reader.readBool();
+		clip.m_FirstJoint = reader.readString();
+		clip.m_DestinationTrack = reader.readInt();
+		clip.m_Layered = reader.readBool();
+		clip.m_FadeIn = reader.readBool();
+		clip.m_FadeInFrames = reader.readInt();
+		clip.m_FadeOut = reader.readBool();
+		clip.m_FadeOutFrames = reader.readInt();
+		clip.m_Weight = reader.readFloat();
+		metadata.m_Clips.insert(std::make_pair(clip.m_ClipName, clip));
+	}
+
+	for (unsigned int i = reader.readCount(); i > 0; --i)
+	{
+		IKGroup group;
+		group.m_GroupName = reader.readString();
+		group.m_Shoulder = reader.readString();
+		group.m_Elbow = reader.readString();
+		group.m_Hand = reader.readString();
+		metadata.m_IKGroups.insert(std::make_pair(group.m_GroupName, group));
+	}
+
+	for (unsigned int i = reader.readCount(); i > 0; --i)
+	{
+		AnimationPath path;
+		path.m_PathName = reader.readString();
+		path.m_Speed = reader.readFloat();
+		reader.readPath(path.m_YPath);
+		reader.readPath(path.m_ZPath);
+		metadata.m_Paths.insert(std::make_pair(path.m_PathName, path));
+	}
+
+	for (unsigned int i = reader.readCount(); i > 0; --i)
+	{
+		IKGrabShell shell;
+		shell.m_Name = reader.readString();
+		shell.m_Speed = reader.readFloat();
+		shell.m_CurrentFrame = 0.f;
+		shell.m_Weight = 0.f;
+		for (unsigned int j = reader.readCount(); j > 0; --j)
+		{
+			IKGrab grab;
+			grab.m_Target = reader.readString();
+			grab.m_Position = reader.readFloat();
+			grab.m_FadeIn = reader.readBool();
+			grab.m_FadeInTime = reader.readFloat();
+			grab.m_FadeOutTime = reader.readFloat();
+			grab.m_Start = reader.readFloat();
+			grab.m_End = reader.readFloat();
+			grab.m_Active = false;
+			grab.m_Faded = 1.f;
+			shell.m_Grabs.insert(std::make_pair(grab.m_Target, grab));
+		}
+		metadata.m_GrabShells.insert(std::make_pair(shell.m_Name, shell));
+	}
+
+	return metadata;
+}
+
+void AnimationMetadata::write(std::ostream& p_Output) const
+{
+	p_Output.write(magic, sizeof(magic));
+	writeInt(p_Output, version);
+
+	writeInt(p_Output, m_Clips.size());
+	for (const auto& entry : m_Clips)
+	{
+		const AnimationClip& clip = entry.second;
+		writeString(p_Output, clip.m_ClipName);
+		writeFloat(p_Output, clip.m_AnimationSpeed);
+		writeInt(p_Output, clip.m_Start);
+		writeInt(p_Output, clip.m_End);
+		writeInt(p_Output, clip.m_Loop);
+		writeString(p_Output, clip.m_FirstJoint);
+		writeInt(p_Output, clip.m_DestinationTrack);
+		writeInt(p_Output, clip.m_Layered);
+		writeInt(p_Output, clip.m_FadeIn);
+		writeInt(p_Output, clip.m_FadeInFrames);
+		writeInt(p_Output, clip.m_FadeOut);
+		writeInt(p_Output, clip.m_FadeOutFrames);
+		writeFloat(p_Output, clip.m_Weight);
+	}
+
+	writeInt(p_Output, m_IKGroups.size());
+	for (const auto& entry : m_IKGroups)
+	{
+		const IKGroup& group = entry.second;
+		writeString(p_Output, group.m_GroupName);
+		writeString(p_Output, group.m_Shoulder);
+		writeString(p_Output, group.m_Elbow);
+		writeString(p_Output, group.m_Hand);
+	}
+
+	writeInt(p_Output, m_Paths.size());
+	for (const auto& entry : m_Paths)
+	{
+		const AnimationPath& path = entry.second;
+		writeString(p_Output, path.m_PathName);
+		writeFloat(p_Output, path.m_Speed);
+		writePath(p_Output, path.m_YPath);
+		writePath(p_Output, path.m_ZPath);
+	}
+
+	writeInt(p_Output, m_GrabShells.size());
+	for (const auto& entry : m_GrabShells)
+	{
+		const IKGrabShell& shell = entry.second;
+		writeString(p_Output, shell.m_Name);
+		writeFloat(p_Output, shell.m_Speed);
+		writeInt(p_Output, shell.m_Grabs.size());
+		for (const auto& grabEntry : shell.m_Grabs)
+		{
+			const IKGrab& grab = grabEntry.second;
+			writeString(p_Output, grab.m_Target);
+			writeFloat(p_Output, grab.m_Position);
+			writeInt(p_Output, grab.m_FadeIn);
+			writeFloat(p_Output, grab.m_FadeInTime);
+			writeFloat(p_Output, grab.m_FadeOutTime);
+			writeFloat(p_Output, grab.m_Start);
+			writeFloat(p_Output, grab.m_End);
+		}
+	}
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "AnimationClip.h"
+
+#include <map>
+#include <ostream>
+#include <string>
+
+/**
+ * The clips, IK groups, paths and grab shells of an animated model.
+ *
+ * The metadata is authored as text in a .mlx file next to the model. BinaryConverter
+ * appends it to the .atx file of the model and packs it into a .bmlx sidecar, which are
+ * read in one go instead of parsing the text once per kind of data every time a character
+ * is loaded. AnimationLoader falls back to the text when it has been written after the
+ * converted copies.
+ *
+ * A .bmlx file starts with the four bytes in magic and the version, followed by
+ * the clips, IK groups, paths and grab shells. Each section starts with the number
+ * of entries. Strings are stored as a length followed by the characters, numbers
+ * and flags as 32-bit values.
+ */
+class AnimationMetadata
+{
+public:
+	std::map<std::string, AnimationClip> m_Clips;
+	std::map<std::string, IKGroup> m_IKGroups;
+	std::map<std::string, AnimationPath> m_Paths;
+	std::map<std::string, IKGrabShell> m_GrabShells;
+
+	static const char magic[4];
+	static const int version = 1;
+
+	/**
+	 * Parse a text .mlx file. Missing files give the same defaults as MattiasLucaseXtremeLoader.
+	 *
+	 * @param p_Filename the path to the .mlx file
+	 * @return the parsed metadata
+	 */
+	static AnimationMetadata loadText(const std::string& p_Filename);
+
+	/**
+	 * Read a binary .bmlx file with a single read.
+	 *
+	 * @param p_Filename the path to the .bmlx file
+	 * @param p_Metadata receives the metadata if the file exists
+	 * @return false if the file could not be opened
+	 * @throws CommonException if the file is not valid metadata
+	 */
+	static bool loadBinary(const std::string& p_Filename, AnimationMetadata& p_Metadata);
+
+	/**
+	 * Decode binary metadata from memory.
+	 *
+	 * @param p_Data the start of the data
+	 * @param p_Size the size of the data in bytes
+	 * @return the decoded metadata
+	 * @throws CommonException if the data is not valid metadata
+	 */
+	static AnimationMetadata read(const char* p_Data, size_t p_Size);
+
+	/**
+	 * Write the metadata in the binary format.
+	 *
+	 * @param p_Output the stream to write to, should be binary
+	 */
+	void write(std::ostream& p_Output) const;
+};
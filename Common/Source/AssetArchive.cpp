@@ -0,0 +1,143 @@
+#include "AssetArchive.h"
+
+#include <cstring>
+
+using namespace AssetArchiveFormat;
+
+AssetArchive::AssetArchive()
+	:	m_Header(nullptr),
+		m_Directory(nullptr),
+		m_Strings(nullptr)
+{
+}
+
+bool AssetArchive::open(const std::string& p_FilePath)
+{
+	close();
+
+	if (!m_File.open(p_FilePath))
+	{
+		return false;
+	}
+
+	if (!validate())
+	{
+		close();
+		return false;
+	}
+
+	const char* data = m_File.getData();
+	m_Header = reinterpret_cast<const Header*>(data);
+	m_Directory = reinterpret_cast<const Entry*>(data + sizeof(Header));
+	m_Strings = data + m_Header->m_StringsOffset;
+
+	return true;
+}
+
+void AssetArchive::close()
+{
+	m_File.close();
+	m_Header = nullptr;
+	m_Directory = nullptr;
+	m_Strings = nullptr;
+}
+
+bool AssetArchive::isOpen() const
+{
+	return m_Header != nullptr;
+}
+
+unsigned int AssetArchive::getNumEntries() const
+{
+	return m_Header ? m_Header->m_NumEntries : 0;
+}
+
+const Entry* AssetArchive::find(const std::string& p_Type, const std::string& p_Name) const
+{
+	if (!m_Header)
+	{
+		return nullptr;
+	}
+
+	const uint64_t hash = hashKey(p_Type.data(), p_Type.size(), p_Name.data(), p_Name.size());
+	const uint32_t mask = m_Header->m_NumSlots - 1;
+	const size_t keyLength = p_Type.size() + 1 + p_Name.size();
+
+	// There is always at least one empty slot, which ends the probe
+	for (uint32_t slot = static_cast<uint32_t>(hash) & mask; ; slot = (slot + 1) & mask)
+	{
+		const Entry& entry = m_Directory[slot];
+		if (entry.m_KeyLength == 0)
+		{
+			return nullptr;
+		}
+
+		if (entry.m_Hash == hash && entry.m_KeyLength == keyLength)
+		{
+			const char* key = m_Strings + entry.m_KeyOffset;
+			if (memcmp(key, p_Type.data(), p_Type.size()) == 0
+				&& key[p_Type.size()] == ':'
+				&& memcmp(key + p_Type.size() + 1, p_Name.data(), p_Name.size()) == 0)
+			{
+				return &entry;
+			}
+		}
+	}
+}
+
+const char* AssetArchive::getData(const Entry& p_Entry) const
+{
+	return m_File.getData() + p_Entry.m_DataOffset;
+}
+
+std::string AssetArchive::getPath(const Entry& p_Entry) const
+{
+	return std::string(m_Strings + p_Entry.m_PathOffset, p_Entry.m_PathLength);
+}
+
+bool AssetArchive::validate() const
+{
+	const size_t size = m_File.getSize();
+	if (size < sizeof(Header))
+	{
+		return false;
+	}
+
+	const Header& header = *reinterpret_cast<const Header*>(m_File.getData());
+	if (memcmp(header.m_Magic, magic, sizeof(header.m_Magic)) != 0
+		|| header.m_Version != version
+		|| header.m_NumSlots == 0
+		|| (header.m_NumSlots & (header.m_NumSlots - 1)) != 0
+		|| header.m_NumEntries >= header.m_NumSlots
+		|| header.m_NumSlots > (size - sizeof(Header)) / sizeof(Entry)
+		|| header.m_StringsOffset > size
+		|| header.m_StringsSize > size - header.m_StringsOffset)
+	{
+		return false;
+	}
+
+	// Check every entry once, so lookups can trust the directory
+	const Entry* directory = reinterpret_cast<const Entry*>(m_File.getData() + sizeof(Header));
+	uint32_t numEntries = 0;
+	for (uint32_t i = 0; i < header.m_NumSlots; ++i)
+	{
+		const Entry& entry = directory[i];
+		if (entry.m_KeyLength == 0)
+		{
+			continue;
+		}
+
+		++numEntries;
+		if (entry.m_KeyOffset > header.m_StringsSize
+			|| entry.m_KeyLength > header.m_StringsSize - entry.m_KeyOffset
+			|| entry.m_PathOffset > header.m_StringsSize
+			|| entry.m_PathLength > header.m_StringsSize - entry.m_PathOffset
+			|| entry.m_DataOffset > size
+			|| entry.m_DataSize > size - entry.m_DataOffset)
+		{
+			return false;
+		}
+	}
+
+	return numEntries == header.m_NumEntries;
+}
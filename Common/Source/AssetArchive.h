@@ -0,0 +1,71 @@
+#pragma once
+
+#include "AssetArchiveFormat.h"
+#include "MappedFile.h"
+
+#include <string>
+
+/**
+ * Read only access to a packed asset archive, see AssetArchiveFormat.h.
+ *
+ * The archive is mapped into memory as a whole, so opening it costs a single
+ * file open, and finding a resource is a hash table lookup instead of a search
+ * through the resource list. The contents are read directly from the mapping.
+ */
+class AssetArchive
+{
+private:
+	MappedFile m_File;
+	const AssetArchiveFormat::Header* m_Header;
+	const AssetArchiveFormat::Entry* m_Directory;
+	const char* m_Strings;
+
+public:
+	/**
+	 * Constructor, creates a closed archive.
+	 */
+	AssetArchive();
+
+	/**
+	 * Map an archive, closing any previously opened archive.
+	 *
+	 * @param p_FilePath the path to the archive
+	 * @return false if the file could not be mapped or is not a valid archive
+	 */
+	bool open(const std::string& p_FilePath);
+
+	/**
+	 * Close the archive. Any entries and data pointers become invalid.
+	 */
+	void close();
+
+	bool isOpen() const;
+
+	/**
+	 * The number of resources in the archive.
+	 */
+	unsigned int getNumEntries() const;
+
+	/**
+	 * Find a resource by type and name.
+	 *
+	 * @return the entry of the resource, or nullptr if the archive does not contain it
+	 */
+	const AssetArchiveFormat::Entry* find(const std::string& p_Type, const std::string& p_Name) const;
+
+	/**
+	 * The contents of a resource, valid while the archive is open. Not null terminated.
+	 */
+	const char* getData(const AssetArchiveFormat::Entry& p_Entry) const;
+
+	/**
+	 * The path of a resource in the resource list the archive was built from.
+	 */
+	std::string getPath(const AssetArchiveFormat::Entry& p_Entry) const;
+
+private:
+	bool validate() const;
+
+	AssetArchive(const AssetArchive&);
+	AssetArchive& operator=(const AssetArchive&);
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Layout of packed asset archives (.hpak) written by BinaryConverter and read
+ * by AssetArchive.
+ *
+ * An archive holds every resource of a resource list in a single file. It
+ * starts with a Header, followed by a directory of Header::m_NumSlots entries
+ * forming an open addressing hash table. An entry is found by hashing its
+ * "type:name" key with hashKey, starting at slot (hash & (m_NumSlots - 1)) and
+ * probing linearly until the key or an empty slot is found. Empty slots have
+ * a key length of zero. After the directory follows a string table with the
+ * keys and the original relative paths of the resources, and then the file
+ * contents, each starting at a multiple of alignment from the start of the file.
+ */
+namespace AssetArchiveFormat
+{
+	/**
+	 * Identifies the file type, the first four bytes of every file.
+	 */
+	static const char magic[4] = { 'H', 'P', 'A', 'K' };
+
+	/**
+	 * Current version of the layout, increase when the layout changes.
+	 */
+	static const int version = 1;
+
+	/**
+	 * Alignment of the file contents, in bytes.
+	 */
+	static const unsigned int alignment = 16;
+
+	struct Header
+	{
+		char m_Magic[4];
+		int m_Version;
+		uint32_t m_NumEntries;
+		/**
+		 * Number of directory slots, a power of two larger than m_NumEntries.
+		 */
+		uint32_t m_NumSlots;
+		uint64_t m_StringsOffset;
+		uint64_t m_StringsSize;
+	};
+
+	struct Entry
+	{
+		uint64_t m_Hash;
+		uint64_t m_DataOffset;
+		uint64_t m_DataSize;
+		/**
+		 * The "type:name" key, relative to the string table.
+		 */
+		uint32_t m_KeyOffset;
+		uint32_t m_KeyLength;
+		/**
+		 * The path from the resource list, relative to the string table.
+		 */
+		uint32_t m_PathOffset;
+		uint32_t m_PathLength;
+	};
+
+	/**
+	 * 64-bit FNV-1a hash of "type:name", without building the key string.
+	 */
+	inline uint64_t hashKey(const char* p_Type, size_t p_TypeLength, const char* p_Name, size_t p_NameLength)
+	{
+		uint64_t hash = 14695981039346656037ull;
+		for (size_t i = 0; i < p_TypeLength; ++i)
+		{
+			hash ^= static_cast<unsigned char>(p_Type[i]);
+			hash *= 1099511628211ull;
+		}
+		hash ^= static_cast<unsigned char>(':');
+		hash *= 1099511628211ull;
+		for (size_t i = 0; i < p_NameLength; ++i)
+		{
+			hash ^= static_cast<unsigned char>(p_Name[i]);
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+}
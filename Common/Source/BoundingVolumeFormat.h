@@ -0,0 +1,42 @@
+#pragma once
+
+#include <DirectXMath.h>
+
+/**
+ * Layout of the binary bounding volume files (.bbv) written by BinaryConverter
+ * and read by BVLoader.
+ *
+ * A file starts with a Header, followed by Header::m_NumTriangles * 3
+ * triangle corners as DirectX::XMFLOAT4, three per triangle. The corners are
+ * already converted to the physics coordinate system, i.e. with the x-axis
+ * mirrored and scaled from centimeters to meters, with w set to 1.
+ */
+namespace BoundingVolumeFormat
+{
+	/**
+	 * Identifies the file type, the first four bytes of every file.
+	 */
+	static const char magic[4] = { 'B', 'B', 'V', '\0' };
+
+	/**
+	 * Current version of the layout, increase when the layout changes.
+	 */
+	static const int version = 1;
+
+	/**
+	 * Unit conversion applied to the source vertices, centimeters to meters.
+	 */
+	static const float scale = 0.01f;
+
+	struct Header
+	{
+		char m_Magic[4];
+		int m_Version;
+		int m_NumTriangles;
+		/**
+		 * Sphere around the model space origin containing all corners,
+		 * xyz is the center and w the radius, in meters.
+		 */
+		DirectX::XMFLOAT4 m_BoundingSphere;
+	};
+}
@@ -8,6 +8,7 @@
 #include "XMLHelper.h"
 #include "Utilities/Util.h"
 #include "AnimationClip.h"
+#include "AnimationData.h"
 
 
 #include <IPhysics.h>
@@ -63,6 +64,30 @@ public:
  */
 class OBB_Component : public PhysicsInterface
 {
+public:
+	/**
+	 * Typed description of an OBB component, mirroring the XML attributes.
+	 */
+	struct Description
+	{
+		Vector3 halfsize;
+		Vector3 offsetPosition;
+		Vector3 offsetRotation;
+		float mass;
+		bool immovable;
+		bool isEdge;
+
+		Description()
+			:	halfsize(1.f, 1.f, 1.f),
+				offsetPosition(0.f, 0.f, 0.f),
+				offsetRotation(0.f, 0.f, 0.f),
+				mass(0.f),
+				immovable(true),
+				isEdge(false)
+		{
+		}
+	};
+
 private:
 	BodyHandle m_Body;
 	IPhysics* m_Physics;
@@ -75,9 +100,19 @@ private:
 	
 
 public:
+	OBB_Component()
+		:	m_Body(0),
+			m_Physics(nullptr)
+	{
+	}
+
 	~OBB_Component() override
 	{
-		m_Physics->releaseBody(m_Body);
+		// Instance prototypes are never added to an actor and have no body
+		if (!m_IsPrototype)
+		{
+			m_Physics->releaseBody(m_Body);
+		}
 	}
 
 	/**
@@ -92,39 +127,38 @@ public:
 
 	void initialize(const tinyxml2::XMLElement* p_Data) override
 	{
-		m_OffsetPosition = Vector3(0.f, 0.f, 0.f);
-		m_OffsetRotation = Vector3(0.f, 0.f,0.f);
-		m_Halfsize = Vector3(1.f, 1.f, 1.f);
+		Description desc;
 		const tinyxml2::XMLElement* size = p_Data->FirstChildElement("Halfsize");
 		if (size)
 		{
-			m_Halfsize.x = size->FloatAttribute("x");
-			m_Halfsize.y = size->FloatAttribute("y");
-			m_Halfsize.z = size->FloatAttribute("z");
+			desc.halfsize.x = size->FloatAttribute("x");
+			desc.halfsize.y = size->FloatAttribute("y");
+			desc.halfsize.z = size->FloatAttribute("z");
 		}
 
-		const tinyxml2::XMLElement* relPos = p_Data->FirstChildElement("OffsetPosition");
-		if (relPos)
-		{
-			relPos->QueryAttribute("x", &m_OffsetPosition.x);
-			relPos->QueryAttribute("y", &m_OffsetPosition.y);
-			relPos->QueryAttribute("z", &m_OffsetPosition.z);
-		}
+		queryVector(p_Data->FirstChildElement("OffsetPosition"), desc.offsetPosition);
+		queryRotation(p_Data->FirstChildElement("OffsetRotation"), desc.offsetRotation);
 
-		const tinyxml2::XMLElement* relRot = p_Data->FirstChildElement("OffsetRotation");
-		if(relRot)
-		{
-			queryRotation(relRot, m_OffsetRotation);
-		}
+		p_Data->QueryBoolAttribute("Immovable", &desc.immovable);
+		p_Data->QueryFloatAttribute("Mass", &desc.mass);
+		p_Data->QueryBoolAttribute("IsEdge", &desc.isEdge);
 
-		m_Immovable = true;
-		p_Data->QueryBoolAttribute("Immovable", &m_Immovable);
-
-		m_Mass = 0.f;
-		p_Data->QueryFloatAttribute("Mass", &m_Mass);
+		initialize(desc);
+	}
 
-		m_IsEdge = false;
-		p_Data->QueryBoolAttribute("IsEdge", &m_IsEdge);
+	/**
+	 * Initialize the component directly from a typed description.
+	 *
+	 * @param p_Description the component parameters
+	 */
+	void initialize(const Description& p_Description)
+	{
+		m_Halfsize = p_Description.halfsize;
+		m_OffsetPosition = p_Description.offsetPosition;
+		m_OffsetRotation = p_Description.offsetRotation;
+		m_Mass = p_Description.mass;
+		m_Immovable = p_Description.immovable;
+		m_IsEdge = p_Description.isEdge;
 	}
 
 	void postInit() override
@@ -345,6 +379,30 @@ public:
  */
 class AABB_Component : public PhysicsInterface
 {
+public:
+	/**
+	 * Typed description of an AABB component, mirroring the XML attributes.
+	 */
+	struct Description
+	{
+		Vector3 halfsize;
+		Vector3 offsetPosition;
+		float mass;
+		bool immovable;
+		bool isEdge;
+		bool collisionResponse;
+
+		Description()
+			:	halfsize(1.f, 1.f, 1.f),
+				offsetPosition(0.f, 0.f, 0.f),
+				mass(0.f),
+				immovable(true),
+				isEdge(false),
+				collisionResponse(true)
+		{
+		}
+	};
+
 private:
 	BodyHandle m_Body;
 	IPhysics* m_Physics;
@@ -373,34 +431,38 @@ public:
 
 	void initialize(const tinyxml2::XMLElement* p_Data) override
 	{
-		m_OffsetPositition = Vector3(0.f, 0.f, 0.f);
-
-		m_Halfsize = Vector3(1.f, 1.f, 1.f);
+		Description desc;
 		const tinyxml2::XMLElement* size = p_Data->FirstChildElement("Halfsize");
 		if (size)
 		{
-			m_Halfsize.x = size->FloatAttribute("x");
-			m_Halfsize.y = size->FloatAttribute("y");
-			m_Halfsize.z = size->FloatAttribute("z");
+			desc.halfsize.x = size->FloatAttribute("x");
+			desc.halfsize.y = size->FloatAttribute("y");
+			desc.halfsize.z = size->FloatAttribute("z");
 		}
 
-		const tinyxml2::XMLElement* relPos = p_Data->FirstChildElement("OffsetPosition");
-		if (relPos)
-		{
-			relPos->QueryAttribute("x", &m_OffsetPositition.x);
-			relPos->QueryAttribute("y", &m_OffsetPositition.y);
-			relPos->QueryAttribute("z", &m_OffsetPositition.z);
-		}
+		queryVector(p_Data->FirstChildElement("OffsetPosition"), desc.offsetPosition);
 
-		m_IsEdge = false;
-		p_Data->QueryBoolAttribute("IsEdge", &m_IsEdge);
-		m_RespondToCollision = true;
-		p_Data->QueryBoolAttribute("CollisionResponse", &m_RespondToCollision);
-		m_Mass = 0.f;
-		p_Data->QueryFloatAttribute("Mass", &m_Mass);
-		m_Immovable = true;
-		p_Data->QueryBoolAttribute("Immovable", &m_Immovable);
+		p_Data->QueryBoolAttribute("IsEdge", &desc.isEdge);
+		p_Data->QueryBoolAttribute("CollisionResponse", &desc.collisionResponse);
+		p_Data->QueryFloatAttribute("Mass", &desc.mass);
+		p_Data->QueryBoolAttribute("Immovable", &desc.immovable);
+
+		initialize(desc);
+	}
 
+	/**
+	 * Initialize the component directly from a typed description.
+	 *
+	 * @param p_Description the component parameters
+	 */
+	void initialize(const Description& p_Description)
+	{
+		m_Halfsize = p_Description.halfsize;
+		m_OffsetPositition = p_Description.offsetPosition;
+		m_Mass = p_Description.mass;
+		m_Immovable = p_Description.immovable;
+		m_IsEdge = p_Description.isEdge;
+		m_RespondToCollision = p_Description.collisionResponse;
 	}
 
 	void postInit() override
@@ -460,6 +522,21 @@ public:
  */
 class BoundingMeshComponent : public PhysicsInterface
 {
+public:
+	/**
+	 * Typed description of a bounding mesh component, mirroring the XML attributes.
+	 */
+	struct Description
+	{
+		std::string meshName;
+		Vector3 scale;
+
+		Description()
+			:	scale(1.f, 1.f, 1.f)
+		{
+		}
+	};
+
 private:
 	BodyHandle m_Body;
 	int m_MeshResourceId;
@@ -469,9 +546,40 @@ private:
 	std::string m_MeshName;
 
 public:
+	BoundingMeshComponent()
+		:	m_Body(0),
+			m_Physics(nullptr)
+	{
+	}
+
+	/**
+	 * Copy an initialized component that has not been added to an actor,
+	 * the copy adds its own reference to the loaded volume.
+	 *
+	 * @param p_Prototype the component to copy
+	 */
+	BoundingMeshComponent(const BoundingMeshComponent& p_Prototype)
+		:	PhysicsInterface(p_Prototype),
+			m_Body(0),
+			m_MeshResourceId(p_Prototype.m_MeshResourceId),
+			m_Physics(p_Prototype.m_Physics),
+			m_ResourceManager(p_Prototype.m_ResourceManager),
+			m_Scale(p_Prototype.m_Scale),
+			m_MeshName(p_Prototype.m_MeshName)
+	{
+		if (!m_ResourceManager->acquireResource(m_MeshResourceId))
+		{
+			m_MeshResourceId = m_ResourceManager->loadResource("volume", m_MeshName);
+		}
+	}
+
 	~BoundingMeshComponent() override
 	{
-		m_Physics->releaseBody(m_Body);
+		// Instance prototypes are never added to an actor and have no body
+		if (!m_IsPrototype)
+		{
+			m_Physics->releaseBody(m_Body);
+		}
 		m_ResourceManager->releaseResource(m_MeshResourceId);
 	}
 	
@@ -503,17 +611,35 @@ public:
 			throw CommonException("Collision component lacks mesh", __LINE__, __FILE__);
 		}
 
-		m_MeshName = meshName;
-		m_MeshResourceId = m_ResourceManager->loadResource("volume", meshName);
+		Description desc;
+		desc.meshName = meshName;
 
-		m_Scale = Vector3(1.f, 1.f, 1.f);
 		const tinyxml2::XMLElement* scale = p_Data->FirstChildElement("Scale");
 		if (scale)
 		{
-			m_Scale.x = scale->FloatAttribute("x");
-			m_Scale.y = scale->FloatAttribute("y");
-			m_Scale.z = scale->FloatAttribute("z");
+			desc.scale.x = scale->FloatAttribute("x");
+			desc.scale.y = scale->FloatAttribute("y");
+			desc.scale.z = scale->FloatAttribute("z");
+		}
+
+		initialize(desc);
+	}
+
+	/**
+	 * Initialize the component directly from a typed description.
+	 *
+	 * @param p_Description the component parameters
+	 */
+	void initialize(const Description& p_Description)
+	{
+		if (p_Description.meshName.empty())
+		{
+			throw CommonException("Collision component lacks mesh", __LINE__, __FILE__);
 		}
+
+		m_MeshName = p_Description.meshName;
+		m_MeshResourceId = m_ResourceManager->loadResource("volume", m_MeshName);
+		m_Scale = p_Description.scale;
 	}
 
 	void postInit() override
@@ -564,6 +690,9 @@ public:
 	{
 		return m_Physics->getBodyOnSomething(m_Body);
 	}
+
+private:
+	BoundingMeshComponent& operator=(const BoundingMeshComponent&);
 };
 
 /**
@@ -613,6 +742,25 @@ public:
 	 */
 	typedef unsigned int ModelCompId;
 
+	/**
+	 * Typed description of a model component, mirroring the XML attributes.
+	 */
+	struct Description
+	{
+		std::string meshName;
+		std::string style;
+		Vector3 scale;
+		Vector3 colorTone;
+		Vector3 offsetPosition;
+
+		Description()
+			:	scale(1.f, 1.f, 1.f),
+				colorTone(1.f, 1.f, 1.f),
+				offsetPosition(0.f, 0.f, 0.f)
+		{
+		}
+	};
+
 private:
 	ModelCompId m_Id;
 	Vector3 m_BaseScale;
@@ -626,7 +774,11 @@ private:
 public:
 	~ModelComponent() override
 	{
-		m_Owner->getEventManager()->queueEvent(IEventData::Ptr(new RemoveMeshEventData(m_Id)));
+		// Instance prototypes are never added to an actor and have no mesh
+		if (!m_IsPrototype)
+		{
+			m_Owner->getEventManager()->queueEvent(IEventData::Ptr(new RemoveMeshEventData(m_Id)));
+		}
 	}
 
 	void initialize(const tinyxml2::XMLElement* p_Data) override
@@ -637,38 +789,37 @@ public:
 			throw CommonException("Component lacks mesh", __LINE__, __FILE__);
 		}
 
-		m_MeshName = std::string(mesh);
+		Description desc;
+		desc.meshName = mesh;
 
 		const char* style = p_Data->Attribute("Style");
 		if (style)
-			m_Style = style;
+			desc.style = style;
 
-		m_BaseScale = Vector3(1.f, 1.f, 1.f);
-		const tinyxml2::XMLElement* scale = p_Data->FirstChildElement("Scale");
-		if (scale)
-		{
-			scale->QueryFloatAttribute("x", &m_BaseScale.x);
-			scale->QueryFloatAttribute("y", &m_BaseScale.y);
-			scale->QueryFloatAttribute("z", &m_BaseScale.z);
-		}
+		queryVector(p_Data->FirstChildElement("Scale"), desc.scale);
+		queryVector(p_Data->FirstChildElement("ColorTone"), desc.colorTone);
+		queryVector(p_Data->FirstChildElement("OffsetPosition"), desc.offsetPosition);
 
-		m_ColorTone = Vector3(1.f, 1.f, 1.f);
-		const tinyxml2::XMLElement* tone = p_Data->FirstChildElement("ColorTone");
-		if (tone)
-		{
-			tone->QueryFloatAttribute("x", &m_ColorTone.x);
-			tone->QueryFloatAttribute("y", &m_ColorTone.y);
-			tone->QueryFloatAttribute("z", &m_ColorTone.z);
-		}
+		initialize(desc);
+	}
 
-		m_Offset = Vector3(0,0,0);
-		const tinyxml2::XMLElement* pos = p_Data->FirstChildElement("OffsetPosition");
-		if (pos)
+	/**
+	 * Initialize the component directly from a typed description.
+	 *
+	 * @param p_Description the component parameters
+	 */
+	void initialize(const Description& p_Description)
+	{
+		if (p_Description.meshName.empty())
 		{
-			pos->QueryFloatAttribute("x", &m_Offset.x);
-			pos->QueryFloatAttribute("y", &m_Offset.y);
-			pos->QueryFloatAttribute("z", &m_Offset.z);
+			throw CommonException("Component lacks mesh", __LINE__, __FILE__);
 		}
+
+		m_MeshName = p_Description.meshName;
+		m_Style = p_Description.style;
+		m_BaseScale = p_Description.scale;
+		m_ColorTone = p_Description.colorTone;
+		m_Offset = p_Description.offsetPosition;
 	}
 	void postInit() override
 	{
@@ -832,6 +983,22 @@ public:
  */
 class MovementComponent : public MovementInterface
 {
+public:
+	/**
+	 * Typed description of a movement component, mirroring the XML attributes.
+	 */
+	struct Description
+	{
+		Vector3 velocity;
+		Vector3 rotationalVelocity;
+
+		Description()
+			:	velocity(0.f, 0.f, 0.f),
+				rotationalVelocity(0.f, 0.f, 0.f)
+		{
+		}
+	};
+
 private:
 	Vector3 m_Velocity;
 	Vector3 m_RotVelocity;
@@ -839,29 +1006,36 @@ private:
 public:
 	void initialize(const tinyxml2::XMLElement* p_Data) override
 	{
+		Description desc;
+
 		const tinyxml2::XMLElement* velElem = p_Data->FirstChildElement("Velocity");
 		if (velElem)
 		{
-			m_Velocity.x = velElem->FloatAttribute("x");
-			m_Velocity.y = velElem->FloatAttribute("y");
-			m_Velocity.z = velElem->FloatAttribute("z");
-		}
-		else
-		{
-			m_Velocity = Vector3(0.f, 0.f, 0.f);
+			desc.velocity.x = velElem->FloatAttribute("x");
+			desc.velocity.y = velElem->FloatAttribute("y");
+			desc.velocity.z = velElem->FloatAttribute("z");
 		}
 
 		const tinyxml2::XMLElement* rotVelElem = p_Data->FirstChildElement("RotationalVelocity");
 		if (rotVelElem)
 		{
-			m_RotVelocity.x = rotVelElem->FloatAttribute("x");
-			m_RotVelocity.y = rotVelElem->FloatAttribute("y");
-			m_RotVelocity.z = rotVelElem->FloatAttribute("z");
-		}
-		else
-		{
-			m_RotVelocity = Vector3(0.f, 0.f, 0.f);
+			desc.rotationalVelocity.x = rotVelElem->FloatAttribute("x");
+			desc.rotationalVelocity.y = rotVelElem->FloatAttribute("y");
+			desc.rotationalVelocity.z = rotVelElem->FloatAttribute("z");
 		}
+
+		initialize(desc);
+	}
+
+	/**
+	 * Initialize the component directly from a typed description.
+	 *
+	 * @param p_Description the component parameters
+	 */
+	void initialize(const Description& p_Description)
+	{
+		m_Velocity = p_Description.velocity;
+		m_RotVelocity = p_Description.rotationalVelocity;
 	}
 
 	void onUpdate(float p_DeltaTime) override
@@ -1084,6 +1258,12 @@ public:
  */
 class LightComponent : public LightInterface
 {
+public:
+	/**
+	 * Typed description of a light component. The light id is assigned by the factory.
+	 */
+	typedef LightClass Description;
+
 private:
 	LightClass m_Light;
 
@@ -1119,7 +1299,7 @@ public:
 				col->QueryAttribute("b", &color.z);
 			}
 
-			m_Light = LightClass::createPointLight(position, range, color);
+			initialize(LightClass::createPointLight(position, range, color));
 		}
 		else if (p_Data->Attribute("Type", "Spot"))
 		{
@@ -1162,7 +1342,7 @@ public:
 				ang->QueryAttribute("max", &angles.y);
 			}
 
-			m_Light = LightClass::createSpotLight(position, direction, angles, range, color);
+			initialize(LightClass::createSpotLight(position, direction, angles, range, color));
 		}
 		else if (p_Data->Attribute("Type", "Directional"))
 		{
@@ -1189,13 +1369,26 @@ public:
 				col->QueryAttribute("b", &color.z);
 			}
 			
-			m_Light = LightClass::createDirectionalLight(direction, color, intensity);
+			initialize(LightClass::createDirectionalLight(direction, color, intensity));
 		}
 		else
 		{
 			throw CommonException("XML Light description missing valid type", __LINE__, __FILE__);
 		}
 	}
+
+	/**
+	 * Initialize the component directly from a typed description,
+	 * keeping the id already assigned to the component.
+	 *
+	 * @param p_Description the light to shine
+	 */
+	void initialize(const Description& p_Description)
+	{
+		LightClass::Id id = m_Light.id;
+		m_Light = p_Description;
+		m_Light.id = id;
+	}
 	void postInit() override
 	{
 		m_Owner->getEventManager()->queueEvent(IEventData::Ptr(new LightEventData(m_Light)));
@@ -1300,6 +1493,25 @@ public:
 
 class ParticleComponent : public ParticleInterface
 {
+public:
+	/**
+	 * Typed description of a particle component, mirroring the XML attributes.
+	 */
+	struct Description
+	{
+		std::string effectName;
+		Vector4 baseColor;
+		Vector3 offsetPosition;
+		Vector3 rotation;
+
+		Description()
+			:	baseColor(-1.f, -1.f, -1.f, -1.f),
+				offsetPosition(0.f, 0.f, 0.f),
+				rotation(0.f, 0.f, 0.f)
+		{
+		}
+	};
+
 private:
 	unsigned int m_ParticleId;
 	std::string m_EffectName;
@@ -1320,12 +1532,32 @@ public:
 		{
 			throw CommonException("Missing effect name", __LINE__, __FILE__);
 		}
-		m_BaseColor = Vector4(-1.f, -1.f, -1.f, -1.f);
-		queryColor(p_Data->FirstChildElement("BaseColor"), m_BaseColor);
-		queryVector(p_Data->FirstChildElement("OffsetPosition"), m_OffsetPosition);
-		queryRotation(p_Data->FirstChildElement("Rotation"), m_Rotation);
 
-		m_EffectName = effectName;
+		Description desc;
+		desc.effectName = effectName;
+		queryColor(p_Data->FirstChildElement("BaseColor"), desc.baseColor);
+		queryVector(p_Data->FirstChildElement("OffsetPosition"), desc.offsetPosition);
+		queryRotation(p_Data->FirstChildElement("Rotation"), desc.rotation);
+
+		initialize(desc);
+	}
+
+	/**
+	 * Initialize the component directly from a typed description.
+	 *
+	 * @param p_Description the component parameters
+	 */
+	void initialize(const Description& p_Description)
+	{
+		if (p_Description.effectName.empty())
+		{
+			throw CommonException("Missing effect name", __LINE__, __FILE__);
+		}
+
+		m_EffectName = p_Description.effectName;
+		m_BaseColor = p_Description.baseColor;
+		m_OffsetPosition = p_Description.offsetPosition;
+		m_Rotation = p_Description.rotation;
 	}
 
 	void postInit() override
@@ -1427,6 +1659,19 @@ public:
 	 */
 	virtual DirectX::XMFLOAT3 getJointPos(const std::string& p_JointName) = 0;
 
+	/**
+	 * @param p_Joint, a joint handle from findJoint.
+	 * @return the joint position in World space.
+	 */
+	virtual DirectX::XMFLOAT3 getJointPos(AnimationData::Handle p_Joint) = 0;
+
+	/**
+	 * Resolve a joint name once, for callers that ask for its position every frame.
+	 * @param p_JointName, the name of the joint.
+	 * @return the joint handle, or AnimationData::invalidHandle if there is no such joint.
+	 */
+	virtual AnimationData::Handle findJoint(const std::string& p_JointName) const = 0;
+
 	/**
 	 * Poll the animation to return a specified animation path for climbing.
 	 * @param p_AnimationId, the name of the animation path.
@@ -1648,6 +1893,22 @@ public:
 
 class ModelSinOffsetComponent : public OffsetCalculationInterface
 {
+public:
+	/**
+	 * Typed description of a sine offset component, mirroring the XML attributes.
+	 */
+	struct Description
+	{
+		float startTime;
+		Vector3 offset;
+
+		Description()
+			:	startTime(0.f),
+				offset(0.f, 0.f, 0.f)
+		{
+		}
+	};
+
 private:
 	Vector3 m_Position;
 	Vector3 m_Offset;
@@ -1662,10 +1923,22 @@ public:
 
 	void initialize(const tinyxml2::XMLElement* p_Data) override
 	{
-		m_Time = 0;
-		m_Offset = Vector3(0,0,0);
-		p_Data->QueryAttribute("StartTime", &m_Time);
-		queryVector(p_Data->FirstChildElement("Offset"), m_Offset);
+		Description desc;
+		p_Data->QueryAttribute("StartTime", &desc.startTime);
+		queryVector(p_Data->FirstChildElement("Offset"), desc.offset);
+
+		initialize(desc);
+	}
+
+	/**
+	 * Initialize the component directly from a typed description.
+	 *
+	 * @param p_Description the component parameters
+	 */
+	void initialize(const Description& p_Description)
+	{
+		m_Time = p_Description.startTime;
+		m_Offset = p_Description.offset;
 	}
 	
 	void postInit() override
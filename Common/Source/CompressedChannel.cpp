@@ -0,0 +1,257 @@
+#include "CompressedChannel.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace DirectX;
+
+namespace
+{
+	const float smallestThreeRange = 0.70710678f; // 1 / sqrt(2)
+	const float maxQuantized15 = 32767.f;
+	const float maxQuantized16 = 65535.f;
+
+	uint16_t quantize(float p_Value, float p_Min, float p_Extent)
+	{
+		if (p_Extent <= 0.f)
+		{
+			return 0;
+		}
+		float normalized = (p_Value - p_Min) / p_Extent;
+		if (normalized < 0.f) normalized = 0.f;
+		if (normalized > 1.f) normalized = 1.f;
+		return (uint16_t)(normalized * maxQuantized16 + 0.5f);
+	}
+
+	float dequantize(uint16_t p_Value, float p_Min, float p_Extent)
+	{
+		return p_Min + (float)p_Value / maxQuantized16 * p_Extent;
+	}
+}
+
+CompressedChannel::CompressedChannel(Type p_Type)
+	:	m_Type(p_Type),
+		m_Constant(0.f, 0.f, 0.f, 0.f),
+		m_Min(0.f, 0.f, 0.f),
+		m_Extent(0.f, 0.f, 0.f)
+{
+	if (p_Type == Type::ROTATION)
+	{
+		m_Constant.w = 1.f;
+	}
+	else if (p_Type == Type::SCALE)
+	{
+		m_Constant = XMFLOAT4(1.f, 1.f, 1.f, 0.f);
+	}
+}
+
+CompressedChannel::Type CompressedChannel::getType() const
+{
+	return m_Type;
+}
+
+void CompressedChannel::setConstant(const XMFLOAT4& p_Value)
+{
+	m_Constant = p_Value;
+	if (m_Type != Type::ROTATION)
+	{
+		m_Constant.w = 0.f;
+	}
+	m_Frames.clear();
+	m_Keys.clear();
+}
+
+void CompressedChannel::setKeys(std::vector<uint16_t> p_Frames, std::vector<uint16_t> p_Keys, const XMFLOAT3& p_Min,
+	const XMFLOAT3& p_Extent)
+{
+	m_Frames.swap(p_Frames);
+	m_Keys.swap(p_Keys);
+	m_Min = p_Min;
+	m_Extent = p_Extent;
+}
+
+bool CompressedChannel::isConstant() const
+{
+	return m_Keys.empty();
+}
+
+const XMFLOAT4& CompressedChannel::getConstant() const
+{
+	return m_Constant;
+}
+
+const std::vector<uint16_t>& CompressedChannel::getFrames() const
+{
+	return m_Frames;
+}
+
+const std::vector<uint16_t>& CompressedChannel::getKeys() const
+{
+	return m_Keys;
+}
+
+const XMFLOAT3& CompressedChannel::getMin() const
+{
+	return m_Min;
+}
+
+const XMFLOAT3& CompressedChannel::getExtent() const
+{
+	return m_Extent;
+}
+
+XMFLOAT4 CompressedChannel::sample(unsigned int p_Frame) const
+{
+	if (m_Keys.empty())
+	{
+		return m_Constant;
+	}
+
+	const unsigned int numKeys = m_Keys.size() / 3;
+	if (m_Frames.empty())
+	{
+		return getKey((std::min)(p_Frame, numKeys - 1));
+	}
+
+	// The first key after the frame, the frame lies between it and the key before
+	const auto next = std::upper_bound(m_Frames.begin(), m_Frames.end(), p_Frame);
+	if (next == m_Frames.end())
+	{
+		return getKey(numKeys - 1);
+	}
+	const unsigned int nextKey = next - m_Frames.begin();
+	const unsigned int previousKey = nextKey - 1;
+	const unsigned int previousFrame = m_Frames[previousKey];
+	if (previousFrame == p_Frame)
+	{
+		return getKey(previousKey);
+	}
+
+	const float fraction = (float)(p_Frame - previousFrame) / (float)(*next - previousFrame);
+	return interpolate(m_Type, getKey(previousKey), getKey(nextKey), fraction);
+}
+
+size_t CompressedChannel::getKeyBytes() const
+{
+	if (m_Keys.empty())
+	{
+		return m_Type == Type::ROTATION ? sizeof(XMFLOAT4) : sizeof(XMFLOAT3);
+	}
+
+	size_t bytes = (m_Frames.size() + m_Keys.size()) * sizeof(uint16_t);
+	if (m_Type != Type::ROTATION)
+	{
+		bytes += sizeof(m_Min) + sizeof(m_Extent);
+	}
+	return bytes;
+}
+
+void CompressedChannel::packKey(Type p_Type, const XMFLOAT4& p_Value, const XMFLOAT3& p_Min, const XMFLOAT3& p_Extent,
+	uint16_t p_Packed[3])
+{
+	if (p_Type == Type::ROTATION)
+	{
+		packQuaternion(p_Value, p_Packed);
+	}
+	else
+	{
+		p_Packed[0] = quantize(p_Value.x, p_Min.x, p_Extent.x);
+		p_Packed[1] = quantize(p_Value.y, p_Min.y, p_Extent.y);
+		p_Packed[2] = quantize(p_Value.z, p_Min.z, p_Extent.z);
+	}
+}
+
+XMFLOAT4 CompressedChannel::unpackKey(Type p_Type, const uint16_t p_Packed[3], const XMFLOAT3& p_Min, const XMFLOAT3& p_Extent)
+{
+	if (p_Type == Type::ROTATION)
+	{
+		return unpackQuaternion(p_Packed);
+	}
+
+	return XMFLOAT4(dequantize(p_Packed[0], p_Min.x, p_Extent.x), dequantize(p_Packed[1], p_Min.y, p_Extent.y),
+		dequantize(p_Packed[2], p_Min.z, p_Extent.z), 0.f);
+}
+
+XMFLOAT4 CompressedChannel::interpolate(Type p_Type, const XMFLOAT4& p_A, const XMFLOAT4& p_B, float p_Fraction)
+{
+	XMVECTOR a = XMLoadFloat4(&p_A);
+	XMVECTOR b = XMLoadFloat4(&p_B);
+
+	XMFLOAT4 result;
+	if (p_Type == Type::ROTATION)
+	{
+		if (XMVectorGetX(XMVector4Dot(a, b)) < 0.f)
+		{
+			b = XMVectorNegate(b);
+		}
+		XMStoreFloat4(&result, XMQuaternionNormalize(XMVectorLerp(a, b, p_Fraction)));
+	}
+	else
+	{
+		XMStoreFloat4(&result, XMVectorLerp(a, b, p_Fraction));
+	}
+	return result;
+}
+
+void CompressedChannel::packQuaternion(const XMFLOAT4& p_Rotation, uint16_t p_Packed[3])
+{
+	float components[4] = { p_Rotation.x, p_Rotation.y, p_Rotation.z, p_Rotation.w };
+
+	unsigned int largest = 0;
+	for (unsigned int i = 1; i < 4; ++i)
+	{
+		if (fabsf(components[i]) > fabsf(components[largest]))
+		{
+			largest = i;
+		}
+	}
+
+	// q and -q are the same rotation, make the dropped component positive so it can be restored
+	const float sign = components[largest] < 0.f ? -1.f : 1.f;
+
+	unsigned int packedIndex = 0;
+	for (unsigned int i = 0; i < 4; ++i)
+	{
+		if (i == largest)
+		{
+			continue;
+		}
+
+		float normalized = (components[i] * sign / smallestThreeRange + 1.f) * 0.5f;
+		if (normalized < 0.f) normalized = 0.f;
+		if (normalized > 1.f) normalized = 1.f;
+		p_Packed[packedIndex++] = (uint16_t)(normalized * maxQuantized15 + 0.5f);
+	}
+
+	// The index of the dropped component goes in the top bits of the first two values
+	p_Packed[0] |= (uint16_t)((largest & 1) << 15);
+	p_Packed[1] |= (uint16_t)((largest >> 1) << 15);
+}
+
+XMFLOAT4 CompressedChannel::unpackQuaternion(const uint16_t p_Packed[3])
+{
+	const unsigned int largest = (p_Packed[0] >> 15) | ((p_Packed[1] >> 15) << 1);
+
+	float components[4];
+	float sumSquares = 0.f;
+	unsigned int packedIndex = 0;
+	for (unsigned int i = 0; i < 4; ++i)
+	{
+		if (i == largest)
+		{
+			continue;
+		}
+
+		const float normalized = (float)(p_Packed[packedIndex++] & 0x7fff) / maxQuantized15;
+		components[i] = (normalized * 2.f - 1.f) * smallestThreeRange;
+		sumSquares += components[i] * components[i];
+	}
+	components[largest] = sumSquares < 1.f ? sqrtf(1.f - sumSquares) : 0.f;
+
+	return XMFLOAT4(components[0], components[1], components[2], components[3]);
+}
+
+XMFLOAT4 CompressedChannel::getKey(unsigned int p_Key) const
+{
+	return unpackKey(m_Type, &m_Keys[p_Key * 3], m_Min, m_Extent);
+}
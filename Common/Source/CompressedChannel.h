@@ -0,0 +1,114 @@
+#pragma once
+
+#include <DirectXMath.h>
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * One translation, rotation or scale channel of a joint's animation, kept in the
+ * form stored by AnimationCompressor and decoded when a frame is sampled.
+ *
+ * A channel is either a single constant value, one key per frame or fewer keys
+ * with the frame of each key. Frames between two keys are linearly interpolated.
+ * Translation and scale keys are quantized to 16 bits per component within the
+ * channel bounds, rotation keys use the smallest three encoding in 48 bits.
+ */
+class CompressedChannel
+{
+public:
+	enum class Type
+	{
+		TRANSLATION,
+		ROTATION,
+		SCALE,
+	};
+
+private:
+	Type m_Type;
+	DirectX::XMFLOAT4 m_Constant;
+	DirectX::XMFLOAT3 m_Min;
+	DirectX::XMFLOAT3 m_Extent;
+	/**
+	 * The frame of each key, empty if there is a key for every frame.
+	 */
+	std::vector<uint16_t> m_Frames;
+	/**
+	 * Three packed values per key, empty if the channel is constant.
+	 */
+	std::vector<uint16_t> m_Keys;
+
+public:
+	/**
+	 * Create a constant channel with the identity value for the type.
+	 */
+	explicit CompressedChannel(Type p_Type = Type::TRANSLATION);
+
+	Type getType() const;
+
+	/**
+	 * Make the channel constant.
+	 */
+	void setConstant(const DirectX::XMFLOAT4& p_Value);
+
+	/**
+	 * Set the quantized keys of the channel.
+	 *
+	 * @param p_Frames the frame of each key in increasing order, starting at 0 and
+	 *			ending at the last frame, or empty if there is a key for every frame
+	 * @param p_Keys three packed values per key, see packKey
+	 * @param p_Min the minimum of the bounds translation and scale keys are quantized within
+	 * @param p_Extent the size of the bounds
+	 */
+	void setKeys(std::vector<uint16_t> p_Frames, std::vector<uint16_t> p_Keys, const DirectX::XMFLOAT3& p_Min,
+		const DirectX::XMFLOAT3& p_Extent);
+
+	bool isConstant() const;
+	const DirectX::XMFLOAT4& getConstant() const;
+	const std::vector<uint16_t>& getFrames() const;
+	const std::vector<uint16_t>& getKeys() const;
+	const DirectX::XMFLOAT3& getMin() const;
+	const DirectX::XMFLOAT3& getExtent() const;
+
+	/**
+	 * Decode the value of the channel at a frame. Frames after the last key return the last key.
+	 *
+	 * @param p_Frame the frame to sample
+	 * @return the value, with w = 0 for translation and scale
+	 */
+	DirectX::XMFLOAT4 sample(unsigned int p_Frame) const;
+
+	/**
+	 * @return the memory used by the keys of the channel, in bytes
+	 */
+	size_t getKeyBytes() const;
+
+	/**
+	 * Quantize a value as a key of a channel.
+	 *
+	 * @param p_Type the channel type, which decides the encoding
+	 * @param p_Value the value, rotations should be normalized
+	 * @param p_Min the minimum of the channel bounds, unused for rotations
+	 * @param p_Extent the size of the channel bounds, unused for rotations
+	 * @param p_Packed receives the three packed values
+	 */
+	static void packKey(Type p_Type, const DirectX::XMFLOAT4& p_Value, const DirectX::XMFLOAT3& p_Min,
+		const DirectX::XMFLOAT3& p_Extent, uint16_t p_Packed[3]);
+	static DirectX::XMFLOAT4 unpackKey(Type p_Type, const uint16_t p_Packed[3], const DirectX::XMFLOAT3& p_Min,
+		const DirectX::XMFLOAT3& p_Extent);
+
+	/**
+	 * Interpolate between two values of a channel. Rotations take the shortest path and are normalized.
+	 */
+	static DirectX::XMFLOAT4 interpolate(Type p_Type, const DirectX::XMFLOAT4& p_A, const DirectX::XMFLOAT4& p_B,
+		float p_Fraction);
+
+	/**
+	 * Pack a unit quaternion with the smallest three encoding.
+	 */
+	static void packQuaternion(const DirectX::XMFLOAT4& p_Rotation, uint16_t p_Packed[3]);
+	static DirectX::XMFLOAT4 unpackQuaternion(const uint16_t p_Packed[3]);
+
+private:
+	DirectX::XMFLOAT4 getKey(unsigned int p_Key) const;
+};
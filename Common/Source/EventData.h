@@ -383,13 +383,17 @@ private:
 	const std::vector<DirectX::XMFLOAT4X4>& m_AnimationData;
 	const AnimationData::ptr m_Animation;
 	const DirectX::XMFLOAT4X4 m_World;
+	const std::weak_ptr<const DirectX::XMFLOAT4X4* const> m_PoseSource;
+	bool m_HasPoseSource;
 
 public:
 	static const Type sk_EventType = Type(0x14dd2b5d);
 
 	UpdateAnimationEventData(unsigned int p_Id, const std::vector<DirectX::XMFLOAT4X4>& p_AnimationData, AnimationData::ptr p_Animation,
-		DirectX::XMFLOAT4X4 p_World)
-		:	m_Id(p_Id), m_AnimationData(p_AnimationData), m_Animation(p_Animation), m_World(p_World)
+		DirectX::XMFLOAT4X4 p_World,
+		std::weak_ptr<const DirectX::XMFLOAT4X4* const> p_PoseSource = std::weak_ptr<const DirectX::XMFLOAT4X4* const>())
+		:	m_Id(p_Id), m_AnimationData(p_AnimationData), m_Animation(p_Animation), m_World(p_World), m_PoseSource(p_PoseSource),
+			m_HasPoseSource(!p_PoseSource.expired())
 	{
 	}
 
@@ -400,7 +404,9 @@ public:
 
 	virtual Ptr copy(void) const override
 	{
-		return Ptr(new UpdateAnimationEventData(m_Id, m_AnimationData, m_Animation, m_World));
+		UpdateAnimationEventData* data = new UpdateAnimationEventData(m_Id, m_AnimationData, m_Animation, m_World, m_PoseSource);
+		data->m_HasPoseSource = m_HasPoseSource;
+		return Ptr(data);
 	}
 
 	virtual void serialize(std::ostream &p_Out) const override
@@ -431,6 +437,27 @@ public:
 	{
 		return m_World;
 	}
+
+	/**
+	 * @return true if the pose was evaluated by the AnimationJobSystem, even if it has been released since
+	 */
+	bool hasPoseSource() const
+	{
+		return m_HasPoseSource;
+	}
+
+	/**
+	 * The published pose of an animation evaluated by the AnimationJobSystem.
+	 * Keep the returned pointer only while handing the location on, the pose
+	 * must not outlive the animation that owns it.
+	 *
+	 * @return the location of the pose pointer, or empty if there is none or the animation
+	 *			has been released, in which case the animation data is gone as well
+	 */
+	std::shared_ptr<const DirectX::XMFLOAT4X4* const> getPoseSource() const
+	{
+		return m_PoseSource.lock();
+	}
 };
 
 class GameStartedEventData : public BaseEventData
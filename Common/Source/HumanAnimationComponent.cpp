@@ -270,6 +270,25 @@ void HumanAnimationComponent::updateAnimation()
 		m_PrevForwardState = ForwardAnimationState::RUNNING_FORWARD;
 }
 
+void HumanAnimationComponent::resolveHandles()
+{
+	const AnimationData::ptr data = m_Animation.getAnimationData();
+
+	m_LeftAnkle = data->findJoint("L_Ankle");
+	m_RightAnkle = data->findJoint("R_Ankle");
+	m_HeadJoint = data->findJoint("Head");
+	m_LeftFootBase = data->findJoint("L_FootBase");
+	m_RightFootBase = data->findJoint("R_FootBase");
+
+	m_LeftLegIK = data->findIKGroup("LeftLeg");
+	m_RightLegIK = data->findIKGroup("RightLeg");
+	m_LeftFootIK = data->findIKGroup("LeftFoot");
+	m_RightFootIK = data->findIKGroup("RightFoot");
+	m_LeftArmIK = data->findIKGroup("LeftArm");
+	m_RightArmIK = data->findIKGroup("RightArm");
+	m_HeadIK = data->findIKGroup("Head");
+}
+
 void HumanAnimationComponent::updateIKJoints(float dt)
 {
 	using namespace DirectX;
@@ -286,7 +305,7 @@ void HumanAnimationComponent::updateIKJoints(float dt)
 				XMVECTOR reachPoint;
 				reachPoint = XMLoadFloat3(&m_CenterReachPos) + (XMLoadFloat3(&m_EdgeOrientation) * m_Shell.m_Grabs.at("RightArm").m_Position);
 				Vector3 vReachPointR = Vector4(reachPoint).xyz();
-				applyIK_ReachPoint("RightArm", vReachPointR, m_Shell.m_Weight);
+				applyIK_ReachPoint(m_RightArmIK, vReachPointR, m_Shell.m_Weight);
 			}
 		}
 
@@ -298,13 +317,13 @@ void HumanAnimationComponent::updateIKJoints(float dt)
 			{
 				reachPoint = XMLoadFloat3(&m_CenterReachPos) + (XMLoadFloat3(&m_EdgeOrientation) * m_Shell.m_Grabs.at("RightArm").m_Position);
 				vReachPoint = Vector4(reachPoint).xyz();
-				applyIK_ReachPoint("RightArm", vReachPoint, m_Shell.m_Weight);
+				applyIK_ReachPoint(m_RightArmIK, vReachPoint, m_Shell.m_Weight);
 			}
 			if(m_Shell.m_Grabs.at("LeftArm").m_Active)
 			{
 				reachPoint = XMLoadFloat3(&m_CenterReachPos) + (XMLoadFloat3(&m_EdgeOrientation) * m_Shell.m_Grabs.at("LeftArm").m_Position);
 				vReachPoint = Vector4(reachPoint).xyz();
-				applyIK_ReachPoint("LeftArm", vReachPoint, m_Shell.m_Weight);
+				applyIK_ReachPoint(m_LeftArmIK, vReachPoint, m_Shell.m_Weight);
 			}
 		}
 		
@@ -316,14 +335,14 @@ void HumanAnimationComponent::updateIKJoints(float dt)
 			{
 				reachPoint = XMLoadFloat3(&m_CenterReachPos) + (XMLoadFloat3(&m_EdgeOrientation) * m_Shell.m_Grabs.at("RightArm").m_Position);
 				vReachPoint = Vector4(reachPoint).xyz();
-				applyIK_ReachPoint("RightArm", vReachPoint, m_Shell.m_Weight);
+				applyIK_ReachPoint(m_RightArmIK, vReachPoint, m_Shell.m_Weight);
 			}
 
 			if(m_Shell.m_Grabs.at("LeftArm").m_Active)
 			{
 				reachPoint = XMLoadFloat3(&m_CenterReachPos) + (XMLoadFloat3(&m_EdgeOrientation) * m_Shell.m_Grabs.at("LeftArm").m_Position);
 				vReachPoint = Vector4(reachPoint).xyz();
-				applyIK_ReachPoint("LeftArm", vReachPoint, m_Shell.m_Weight);
+				applyIK_ReachPoint(m_LeftArmIK, vReachPoint, m_Shell.m_Weight);
 			}
 		}
 	}
@@ -338,10 +357,10 @@ void HumanAnimationComponent::updateIKJoints(float dt)
 			if(hit.IDInBody == 2 && hit.colType != Type::SPHEREVSSPHERE && hit.collider == m_Owner->getBodyHandles()[0])
 			{
 				hit.colPos.y += 5.0f;
-				applyIK_ReachPoint("LeftLeg", Vector4ToXMFLOAT3(&hit.colPos), 1.0f);
+				applyIK_ReachPoint(m_LeftLegIK, Vector4ToXMFLOAT3(&hit.colPos), 1.0f);
 
-				DirectX::XMFLOAT3 anklePos = getJointPos("L_Ankle");
-				DirectX::XMFLOAT3 toePos = getJointPos("L_FootBase");
+				DirectX::XMFLOAT3 anklePos = getJointPos(m_LeftAnkle);
+				DirectX::XMFLOAT3 toePos = getJointPos(m_LeftFootBase);
 				DirectX::XMVECTOR vAnkle = DirectX::XMLoadFloat3(&anklePos);
 				DirectX::XMVECTOR vToe = DirectX::XMLoadFloat3(&toePos);
 
@@ -363,15 +382,15 @@ void HumanAnimationComponent::updateIKJoints(float dt)
 					hit.colPos = vToe;
 				}
 
-				applyIK_ReachPoint("LeftFoot", Vector4ToXMFLOAT3(&hit.colPos), 1.0f);
+				applyIK_ReachPoint(m_LeftFootIK, Vector4ToXMFLOAT3(&hit.colPos), 1.0f);
 			}
 			if(hit.IDInBody == 3 && hit.colType != Type::SPHEREVSSPHERE && hit.collider == m_Owner->getBodyHandles()[0])
 			{
 				hit.colPos.y += 5.0f;
-				applyIK_ReachPoint("RightLeg", Vector4ToXMFLOAT3(&hit.colPos), 1.0f);
+				applyIK_ReachPoint(m_RightLegIK, Vector4ToXMFLOAT3(&hit.colPos), 1.0f);
 
-				DirectX::XMFLOAT3 anklePos = getJointPos("R_Ankle");
-				DirectX::XMFLOAT3 toePos = getJointPos("R_FootBase");
+				DirectX::XMFLOAT3 anklePos = getJointPos(m_RightAnkle);
+				DirectX::XMFLOAT3 toePos = getJointPos(m_RightFootBase);
 				DirectX::XMVECTOR vAnkle = DirectX::XMLoadFloat3(&anklePos);
 				DirectX::XMVECTOR vToe = DirectX::XMLoadFloat3(&toePos);
 
@@ -395,7 +414,7 @@ void HumanAnimationComponent::updateIKJoints(float dt)
 					hit.colPos = vToe;
 				}
 				
-				applyIK_ReachPoint("RightFoot", Vector4ToXMFLOAT3(&hit.colPos), 1.0f);
+				applyIK_ReachPoint(m_RightFootIK, Vector4ToXMFLOAT3(&hit.colPos), 1.0f);
 			}
 		}
 	}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Animation.h"
+#include "AnimationJobSystem.h"
+#include "AnimationLOD.h"
 #include "AnimationLoader.h"
 #include "ActorComponent.h"
 #include "Components.h"
@@ -75,9 +77,45 @@ private:
 	IKGrabShell		m_Shell;
 	DirectX::XMFLOAT3 m_LookAtPoint;
 	DirectX::XMFLOAT3 m_Up;
+
+	/**
+	 * Joints and IK groups used every update, resolved once when the animation data is set.
+	 */
+	AnimationData::Handle m_LeftAnkle, m_RightAnkle, m_HeadJoint, m_LeftFootBase, m_RightFootBase;
+	AnimationData::Handle m_LeftLegIK, m_RightLegIK, m_LeftFootIK, m_RightFootIK, m_LeftArmIK, m_RightArmIK, m_HeadIK;
+
+	AnimationLOD* m_AnimationLOD;
+	AnimationLOD::InstancePtr m_LODInstance;
+	AnimationJobSystem* m_AnimationJobs;
+	AnimationJobSystem::JobPtr m_AnimationJob;
+	unsigned int m_PoseModelId;
+	bool m_PoseShared;
+	float m_FrameDeltaTime;
+	bool m_UseIK;
 public:
+	HumanAnimationComponent()
+		:	m_AnimationLOD(nullptr),
+			m_AnimationJobs(nullptr),
+			m_PoseModelId(0),
+			m_PoseShared(false),
+			m_FrameDeltaTime(0.f),
+			m_UseIK(true)
+	{
+	}
+
 	~HumanAnimationComponent()
 	{
+		// The model reads the pose in place, give it a copy before the pose is released
+		if (m_PoseShared)
+		{
+			DirectX::XMFLOAT4X4 identity;
+			DirectX::XMStoreFloat4x4(&identity, DirectX::XMMatrixIdentity());
+			m_EventManager->triggerTriggerEvent(IEventData::Ptr(new UpdateAnimationEventData(m_PoseModelId,
+				m_Animation.getFinalTransform(), m_Animation.getAnimationData(), identity)));
+		}
+
+		// Unregister before the animation it refers to is destroyed
+		m_AnimationJob.reset();
 		m_ResourceManager->releaseResource(m_AnimationResource);
 		m_EventManager->queueEvent(IEventData::Ptr(new Release3DSoundEventData(m_Owner->getId(), m_RunningSound)));
 		m_EventManager->queueEvent(IEventData::Ptr(new Release3DSoundEventData(m_Owner->getId(), m_LandingSound)));
@@ -109,6 +147,17 @@ public:
 		m_AnimationName = resourceName;
 		m_AnimationResource = m_ResourceManager->loadResource("animation", m_AnimationName);
 		m_Animation.setAnimationData(m_AnimationLoader->getAnimationData(m_AnimationName.c_str()));
+		resolveHandles();
+
+		if (m_AnimationLOD)
+		{
+			m_LODInstance = m_AnimationLOD->registerInstance();
+		}
+
+		if (m_AnimationJobs)
+		{
+			m_AnimationJob = m_AnimationJobs->registerAnimation(&m_Animation, [this] () { finishUpdate(); });
+		}
 	}
 
 	void setPhysics(IPhysics *p_Physics) override
@@ -137,28 +186,28 @@ public:
 	void onUpdate(float p_DeltaTime) override
 	{
 		updateAnimation();
-		m_Animation.updateAnimation(p_DeltaTime);
-
-		Vector3 left = getJointPos("L_Ankle");
-		left.y = left.y + 5.f;
-		m_Physics->setBodyVolumePosition(m_Owner->getBodyHandles()[0], 2, left);
-			
-		Vector3 right = getJointPos("R_Ankle");
-		right.y = right.y + 5.f;
-		m_Physics->setBodyVolumePosition(m_Owner->getBodyHandles()[0], 3, right);
 
-		Vector3 eye = getJointPos("Head");
-		m_Physics->setBodyVolumePosition(m_Owner->getBodyHandles()[0], 4, eye);
+		float updateInterval = 0.f;
+		m_UseIK = true;
+		if (m_LODInstance)
+		{
+			m_LODInstance->m_Position = m_Owner->getPosition();
+			updateInterval = m_LODInstance->m_Settings.m_UpdateInterval;
+			m_UseIK = m_LODInstance->m_Settings.m_UseIK;
+			m_Animation.setMaxJointDepth(m_LODInstance->m_Settings.m_MaxJointDepth);
+		}
+		m_FrameDeltaTime = p_DeltaTime;
 
-		updateIKJoints(p_DeltaTime);
-		
-		std::shared_ptr<ModelComponent> comp = m_Model.lock();
-		if (comp)
+		// The job system evaluates the pose with the other actors and calls finishUpdate afterwards
+		if (m_AnimationJob)
 		{
-			m_Owner->getEventManager()->queueEvent(IEventData::Ptr(new UpdateAnimationEventData(comp->getId(), m_Animation.getFinalTransform(), m_Animation.getAnimationData(), m_Owner->getWorldMatrix())));
+			m_AnimationJobs->submit(m_AnimationJob, p_DeltaTime, updateInterval);
+		}
+		else
+		{
+			m_Animation.updateAnimationThrottled(p_DeltaTime, updateInterval);
+			finishUpdate();
 		}
-		if(!m_ForceMove)
-			applyLookAtIK("Head", m_LookAtPoint, 1.0f);
 
 		if(m_Landing)
 		{
@@ -192,8 +241,45 @@ public:
 		m_AnimationLoader = p_AnimationLoader;
 	}
 
+	void setAnimationLOD(AnimationLOD* p_AnimationLOD)
+	{
+		m_AnimationLOD = p_AnimationLOD;
+	}
+
 	void updateAnimation();
 
+	/**
+	 * Move the joint volumes and apply IK to the newly evaluated pose.
+	 */
+	void finishUpdate()
+	{
+		Vector3 left = getJointPos(m_LeftAnkle);
+		left.y = left.y + 5.f;
+		m_Physics->setBodyVolumePosition(m_Owner->getBodyHandles()[0], 2, left);
+			
+		Vector3 right = getJointPos(m_RightAnkle);
+		right.y = right.y + 5.f;
+		m_Physics->setBodyVolumePosition(m_Owner->getBodyHandles()[0], 3, right);
+
+		Vector3 eye = getJointPos(m_HeadJoint);
+		m_Physics->setBodyVolumePosition(m_Owner->getBodyHandles()[0], 4, eye);
+
+		if (m_UseIK)
+		{
+			updateIKJoints(m_FrameDeltaTime);
+		}
+		
+		queuePoseUpdate();
+
+		if(!m_ForceMove && m_UseIK)
+			applyLookAtIK(m_HeadIK, m_LookAtPoint, 1.0f);
+	}
+
+	void setAnimationJobs(AnimationJobSystem* p_AnimationJobs)
+	{
+		m_AnimationJobs = p_AnimationJobs;
+	}
+
 	void playAnimation(std::string p_AnimationName, bool p_Override) override
 	{
 		m_Animation.playClip(p_AnimationName, p_Override);
@@ -211,12 +297,17 @@ public:
 
 	void applyIK_ReachPoint(const std::string& p_GroupName, Vector3 p_Target, float p_Weight) override
 	{
-		m_Animation.applyIK_ReachPoint(p_GroupName, p_Target, m_Owner->getWorldMatrix(), p_Weight);
-		
-		std::shared_ptr<ModelComponent> comp = m_Model.lock();
-		if (comp)
+		applyIK_ReachPoint(m_Animation.getAnimationData()->findIKGroup(p_GroupName), p_Target, p_Weight);
+	}
+
+	void applyIK_ReachPoint(AnimationData::Handle p_Group, Vector3 p_Target, float p_Weight)
+	{
+		m_Animation.applyIK_ReachPoint(p_Group, p_Target, m_Owner->getWorldMatrix(), p_Weight);
+
+		// Poses from the job system are published once, after all IK is applied
+		if (!m_AnimationJob)
 		{
-			m_Owner->getEventManager()->queueEvent(IEventData::Ptr(new UpdateAnimationEventData(comp->getId(), m_Animation.getFinalTransform(), m_Animation.getAnimationData(), m_Owner->getWorldMatrix())));
+			queuePoseUpdate();
 		}
 	}
 
@@ -225,6 +316,16 @@ public:
 		return m_Animation.getJointPos(p_JointName, m_Owner->getWorldMatrix());
 	}
 
+	DirectX::XMFLOAT3 getJointPos(AnimationData::Handle p_Joint) override
+	{
+		return m_Animation.getJointPos(p_Joint, m_Owner->getWorldMatrix());
+	}
+
+	AnimationData::Handle findJoint(const std::string& p_JointName) const override
+	{
+		return m_Animation.getAnimationData()->findJoint(p_JointName);
+	}
+
 	const AnimationPath getAnimationData(std::string p_AnimationId) const override
 	{
 		return m_Animation.getAnimationData().get()->animationPath[p_AnimationId];
@@ -252,15 +353,21 @@ public:
 	}
 
 	void updateIKJoints(float dt);
+	void resolveHandles();
 
 	void applyLookAtIK(const std::string& p_GroupName, const DirectX::XMFLOAT3& p_Target, float p_MaxAngle) override
 	{
-		m_Animation.applyLookAtIK(p_GroupName, p_Target, m_Owner->getWorldMatrix(), p_MaxAngle);
-		
-		std::shared_ptr<ModelComponent> comp = m_Model.lock();
-		if (comp)
+		applyLookAtIK(m_Animation.getAnimationData()->findIKGroup(p_GroupName), p_Target, p_MaxAngle);
+	}
+
+	void applyLookAtIK(AnimationData::Handle p_Group, const DirectX::XMFLOAT3& p_Target, float p_MaxAngle)
+	{
+		m_Animation.applyLookAtIK(p_Group, p_Target, m_Owner->getWorldMatrix(), p_MaxAngle);
+
+		// Poses from the job system are published once, after all IK is applied
+		if (!m_AnimationJob)
 		{
-			m_Owner->getEventManager()->queueEvent(IEventData::Ptr(new UpdateAnimationEventData(comp->getId(), m_Animation.getFinalTransform(), m_Animation.getAnimationData(), m_Owner->getWorldMatrix())));
+			queuePoseUpdate();
 		}
 	}
 
@@ -278,4 +385,22 @@ public:
 	{
 		return m_Animation.getViewDirection(p_Joint, m_Owner->getRotation(), m_Up);
 	}
+
+private:
+	void queuePoseUpdate()
+	{
+		std::shared_ptr<ModelComponent> comp = m_Model.lock();
+		if (comp)
+		{
+			// Shares the lifetime of the job, so events still queued when the job is released are ignored
+			std::weak_ptr<const DirectX::XMFLOAT4X4* const> poseSource;
+			if (m_AnimationJob)
+			{
+				poseSource = std::shared_ptr<const DirectX::XMFLOAT4X4* const>(m_AnimationJob, m_AnimationJob->getPoseSource());
+				m_PoseModelId = comp->getId();
+				m_PoseShared = true;
+			}
+			m_Owner->getEventManager()->queueEvent(IEventData::Ptr(new UpdateAnimationEventData(comp->getId(), m_Animation.getFinalTransform(), m_Animation.getAnimationData(), m_Owner->getWorldMatrix(), poseSource)));
+		}
+	}
 };
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "Joint.h"
 
+#include <stdexcept>
+
 //DirectX::XMFLOAT4X4 Joint::interpolate(float p_FrameTime, float m_DestinationFrameTime) const
 //{
 //	using namespace DirectX;
@@ -34,12 +36,43 @@
 //	return result;
 //}
 
+unsigned int Joint::getNumFrames() const
+{
+	if (!m_JointAnimation.empty())
+	{
+		return m_JointAnimation.size();
+	}
+	return m_CompressedAnimation.m_NumFrames;
+}
+
+KeyFrame Joint::getKeyFrame(unsigned int p_Frame) const
+{
+	if (!m_JointAnimation.empty())
+	{
+		return m_JointAnimation.at(p_Frame);
+	}
+
+	if (p_Frame >= m_CompressedAnimation.m_NumFrames)
+	{
+		throw std::out_of_range("Joint::getKeyFrame frame out of range");
+	}
+
+	const DirectX::XMFLOAT4 translation = m_CompressedAnimation.m_Translation.sample(p_Frame);
+	const DirectX::XMFLOAT4 scale = m_CompressedAnimation.m_Scale.sample(p_Frame);
+
+	KeyFrame key;
+	key.m_Trans = DirectX::XMFLOAT3(translation.x, translation.y, translation.z);
+	key.m_Rot = m_CompressedAnimation.m_Rotation.sample(p_Frame);
+	key.m_Scale = DirectX::XMFLOAT3(scale.x, scale.y, scale.z);
+	return key;
+}
+
 MatrixDecomposed Joint::interpolateEx(float p_FrameTime, float m_DestinationFrameTime) const
 {
 	using namespace DirectX;
 
-	KeyFrame first = m_JointAnimation.at(unsigned int(p_FrameTime));
-	KeyFrame second = m_JointAnimation.at(unsigned int(m_DestinationFrameTime));
+	KeyFrame first = getKeyFrame(unsigned int(p_FrameTime));
+	KeyFrame second = getKeyFrame(unsigned int(m_DestinationFrameTime));
 
 	float dummy;
 	float interpolateFraction2 = modff(p_FrameTime, &dummy);
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "CompressedChannel.h"
+
 #include <DirectXMath.h>
 #include <string>
 #include <vector>
@@ -11,6 +13,24 @@ struct KeyFrame
 	DirectX::XMFLOAT3 m_Scale;
 };
 
+/**
+ * The animation of a joint kept in the compressed form read from a compressed .atx file.
+ */
+struct CompressedKeyFrames
+{
+	unsigned int m_NumFrames;
+	CompressedChannel m_Translation;
+	CompressedChannel m_Rotation;
+	CompressedChannel m_Scale;
+
+	CompressedKeyFrames()
+		:	m_NumFrames(0),
+			m_Translation(CompressedChannel::Type::TRANSLATION),
+			m_Rotation(CompressedChannel::Type::ROTATION),
+			m_Scale(CompressedChannel::Type::SCALE)
+	{}
+};
+
 struct MatrixDecomposed
 {
 	DirectX::XMFLOAT4 rotation;
@@ -52,7 +72,22 @@ public:
 	 * A list of all of the animations' keyframes, that is interpolated in between frames.
 	 */
 	std::vector<KeyFrame> m_JointAnimation;
+	/**
+	 * The keyframes of a compressed animation, sampled when m_JointAnimation is empty.
+	 */
+	CompressedKeyFrames m_CompressedAnimation;
 public:
+	/**
+	 * @return the number of frames in the joint's animation, raw or compressed
+	 */
+	unsigned int getNumFrames() const;
+	/**
+	 * Get the key of a frame, decoding it if the animation is compressed.
+	 *
+	 * @param p_Frame the frame, must be less than getNumFrames()
+	 * @return the translation, rotation and scale of the joint at the frame
+	 */
+	KeyFrame getKeyFrame(unsigned int p_Frame) const;
 	/**
 	 * Calculate the animation transformation at a certain frame.
 	 *
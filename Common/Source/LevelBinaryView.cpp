@@ -0,0 +1,424 @@
+#include "LevelBinaryView.h"
+
+#include "CommonExceptions.h"
+
+#include <cstring>
+
+/**
+ * Bounds checked cursor over the level data.
+ */
+class LevelDataCursor
+{
+private:
+	const char* m_Begin;
+	const char* m_Current;
+	const char* m_End;
+
+public:
+	LevelDataCursor(const char* p_Data, size_t p_Size)
+		: m_Begin(p_Data), m_Current(p_Data), m_End(p_Data + p_Size)
+	{}
+
+	int readInt()
+	{
+		int value;
+		memcpy(&value, take(sizeof(int)), sizeof(int));
+		return value;
+	}
+
+	unsigned int readCount()
+	{
+		int count = readInt();
+		if (count < 0)
+		{
+			throw CommonException("Negative element count in level data at offset " + std::to_string(offset()), __LINE__, __FILE__);
+		}
+		return (unsigned int)count;
+	}
+
+	bool readBool()
+	{
+		return readInt() == 1;
+	}
+
+	DirectX::XMFLOAT3 readFloat3()
+	{
+		DirectX::XMFLOAT3 value;
+		memcpy(&value, take(sizeof(DirectX::XMFLOAT3)), sizeof(DirectX::XMFLOAT3));
+		return value;
+	}
+
+	ArrayView<char> readString()
+	{
+		unsigned int length = readCount();
+		return ArrayView<char>(take(length), length);
+	}
+
+	template <typename T>
+	ArrayView<T> readArray(unsigned int p_Count)
+	{
+		if (p_Count > (size_t)(m_End - m_Current) / sizeof(T))
+		{
+			throw CommonException("Level data truncated at offset " + std::to_string(offset()), __LINE__, __FILE__);
+		}
+		// Arrays follow names of any length, ArrayView copies the elements out instead of aligning them
+		return ArrayView<T>(take(sizeof(T) * p_Count), p_Count);
+	}
+
+	template <typename T>
+	ArrayView<T> readSizedArray()
+	{
+		return readArray<T>(readCount());
+	}
+
+	template <typename T>
+	T readValue()
+	{
+		T value;
+		memcpy(&value, take(sizeof(T)), sizeof(T));
+		return value;
+	}
+
+	bool startsWith(const char* p_Bytes, size_t p_Size) const
+	{
+		return p_Size <= (size_t)(m_End - m_Current) && memcmp(m_Current, p_Bytes, p_Size) == 0;
+	}
+
+private:
+	const char* take(size_t p_Bytes)
+	{
+		if (p_Bytes > (size_t)(m_End - m_Current))
+		{
+			throw CommonException("Level data truncated at offset " + std::to_string(offset()), __LINE__, __FILE__);
+		}
+
+		const char* result = m_Current;
+		m_Current += p_Bytes;
+		return result;
+	}
+
+	size_t offset() const
+	{
+		return m_Current - m_Begin;
+	}
+};
+
+LevelBinaryView::LevelBinaryView()
+	:	m_Data(nullptr),
+		m_Size(0)
+{
+	close();
+}
+
+void LevelBinaryView::openFile(const std::string& p_FilePath)
+{
+	close();
+
+	if (!m_File.open(p_FilePath))
+	{
+		throw CommonException("Could not map level file: " + p_FilePath, __LINE__, __FILE__);
+	}
+
+	m_Data = m_File.getData();
+	m_Size = m_File.getSize();
+
+	parseOrClose();
+}
+
+void LevelBinaryView::openBuffer(const char* p_Data, size_t p_Size)
+{
+	close();
+
+	m_Data = p_Data;
+	m_Size = p_Size;
+
+	parseOrClose();
+}
+
+void LevelBinaryView::openCopy(const char* p_Data, size_t p_Size)
+{
+	close();
+
+	m_Buffer.assign(p_Data, p_Data + p_Size);
+	m_Data = m_Buffer.data();
+	m_Size = m_Buffer.size();
+
+	parseOrClose();
+}
+
+void LevelBinaryView::close()
+{
+	m_File.close();
+	std::vector<char>().swap(m_Buffer);
+
+	m_Data = nullptr;
+	m_Size = 0;
+
+	m_Header.m_NumberOfModels = 0;
+	m_Header.m_NumberOfLights = 0;
+	m_Header.m_NumberOfCheckPoints = 0;
+	m_Header.m_NumberOfEffects = 0;
+	m_Models.clear();
+	m_Effects.clear();
+	m_DirectionalLights = ArrayView<InstanceBinaryLoader::DirectionalLight>();
+	m_PointLights = ArrayView<InstanceBinaryLoader::PointLight>();
+	m_SpotLights = ArrayView<InstanceBinaryLoader::SpotLight>();
+	m_CheckPoints.clear();
+	m_CheckPointStart = DirectX::XMFLOAT3(0.f, 0.f, 0.f);
+	m_CheckPointEnd = DirectX::XMFLOAT3(0.f, 0.f, 0.f);
+	m_HasSpatialIndex = false;
+	m_SpatialIndex = SpatialIndex();
+}
+
+const char* LevelBinaryView::getData() const
+{
+	return m_Data;
+}
+
+size_t LevelBinaryView::getSize() const
+{
+	return m_Size;
+}
+
+const InstanceBinaryLoader::Header& LevelBinaryView::getHeader() const
+{
+	return m_Header;
+}
+
+const std::vector<LevelBinaryView::ModelData>& LevelBinaryView::getModelData() const
+{
+	return m_Models;
+}
+
+ArrayView<InstanceBinaryLoader::DirectionalLight> LevelBinaryView::getDirectionalLightData() const
+{
+	return m_DirectionalLights;
+}
+
+ArrayView<InstanceBinaryLoader::PointLight> LevelBinaryView::getPointLightData() const
+{
+	return m_PointLights;
+}
+
+ArrayView<InstanceBinaryLoader::SpotLight> LevelBinaryView::getSpotLightData() const
+{
+	return m_SpotLights;
+}
+
+DirectX::XMFLOAT3 LevelBinaryView::getCheckPointStart() const
+{
+	return m_CheckPointStart;
+}
+
+DirectX::XMFLOAT3 LevelBinaryView::getCheckPointEnd() const
+{
+	return m_CheckPointEnd;
+}
+
+const std::vector<ArrayView<InstanceBinaryLoader::CheckPointStruct>>& LevelBinaryView::getCheckPointData() const
+{
+	return m_CheckPoints;
+}
+
+const std::vector<LevelBinaryView::EffectData>& LevelBinaryView::getEffectData() const
+{
+	return m_Effects;
+}
+
+bool LevelBinaryView::hasSpatialIndex() const
+{
+	return m_HasSpatialIndex;
+}
+
+const LevelBinaryView::SpatialIndex& LevelBinaryView::getSpatialIndex() const
+{
+	return m_SpatialIndex;
+}
+
+std::string LevelBinaryView::toString(ArrayView<char> p_Name)
+{
+	return std::string(static_cast<const char*>(p_Name.data()), p_Name.size());
+}
+
+void LevelBinaryView::parseOrClose()
+{
+	try
+	{
+		parse();
+	}
+	catch (...)
+	{
+		close();
+		throw;
+	}
+}
+
+void LevelBinaryView::parse()
+{
+	LevelDataCursor cursor(m_Data, m_Size);
+
+	m_Header.m_NumberOfModels = cursor.readInt();
+	m_Header.m_NumberOfLights = cursor.readInt();
+	m_Header.m_NumberOfCheckPoints = cursor.readInt();
+	m_Header.m_NumberOfEffects = cursor.readInt();
+
+	if (m_Header.m_NumberOfModels != 0)
+	{
+		unsigned int numberOfDifferentModels = cursor.readCount();
+		m_Models.reserve(numberOfDifferentModels);
+		for (unsigned int i = 0; i < numberOfDifferentModels; i++)
+		{
+			ModelData model;
+			model.m_MeshName = cursor.readString();
+			model.m_Animated = cursor.readBool();
+			model.m_Transparent = cursor.readBool();
+			model.m_CollideAble = cursor.readBool();
+			model.m_Translation = cursor.readSizedArray<DirectX::XMFLOAT3>();
+			model.m_Rotation = cursor.readSizedArray<DirectX::XMFLOAT3>();
+			model.m_Scale = cursor.readSizedArray<DirectX::XMFLOAT3>();
+
+			if (model.m_Rotation.size() != model.m_Translation.size()
+				|| model.m_Scale.size() != model.m_Translation.size())
+			{
+				throw CommonException("Mismatching instance arrays for model: " + toString(model.m_MeshName), __LINE__, __FILE__);
+			}
+
+			m_Models.push_back(model);
+		}
+	}
+
+	if (m_Header.m_NumberOfLights != 0)
+	{
+		unsigned int numberOfDifferentLights = cursor.readCount();
+		for (unsigned int i = 0; i < numberOfDifferentLights; i++)
+		{
+			int type = cursor.readInt();
+			switch (type)
+			{
+			case 0:
+				m_DirectionalLights = cursor.readSizedArray<InstanceBinaryLoader::DirectionalLight>();
+				break;
+			case 1:
+				m_PointLights = cursor.readSizedArray<InstanceBinaryLoader::PointLight>();
+				break;
+			case 2:
+				m_SpotLights = cursor.readSizedArray<InstanceBinaryLoader::SpotLight>();
+				break;
+			default:
+				throw CommonException("Unknown light type in level data: " + std::to_string(type), __LINE__, __FILE__);
+			}
+		}
+	}
+
+	if (m_Header.m_NumberOfCheckPoints != 0)
+	{
+		m_CheckPointStart = cursor.readFloat3();
+		m_CheckPointEnd = cursor.readFloat3();
+		unsigned int size = cursor.readCount();
+		for (unsigned int i = 0; i < size; i++)
+		{
+			ArrayView<InstanceBinaryLoader::CheckPointStruct> checkPoints = cursor.readSizedArray<InstanceBinaryLoader::CheckPointStruct>();
+			if (!checkPoints.empty())
+			{
+				m_CheckPoints.push_back(checkPoints);
+			}
+		}
+	}
+
+	if (m_Header.m_NumberOfEffects != 0)
+	{
+		unsigned int numberOfDifferentEffects = cursor.readCount();
+		m_Effects.reserve(numberOfDifferentEffects);
+		for (unsigned int i = 0; i < numberOfDifferentEffects; i++)
+		{
+			EffectData effect;
+			effect.m_EffectName = cursor.readString();
+			effect.m_Translation = cursor.readSizedArray<DirectX::XMFLOAT3>();
+			effect.m_Rotation = cursor.readSizedArray<DirectX::XMFLOAT3>();
+
+			if (effect.m_Rotation.size() != effect.m_Translation.size())
+			{
+				throw CommonException("Mismatching instance arrays for effect: " + toString(effect.m_EffectName), __LINE__, __FILE__);
+			}
+
+			m_Effects.push_back(effect);
+		}
+	}
+
+	if (cursor.startsWith(LevelSpatialIndexFormat::magic, sizeof(LevelSpatialIndexFormat::magic)))
+	{
+		parseSpatialIndex(cursor);
+	}
+}
+
+void LevelBinaryView::parseSpatialIndex(LevelDataCursor& p_Cursor)
+{
+	using namespace LevelSpatialIndexFormat;
+
+	const Header header = p_Cursor.readValue<Header>();
+	if (header.m_Version != version)
+	{
+		// Older converters, the level is still usable without the index
+		return;
+	}
+
+	for (uint32_t cells : header.m_Cells)
+	{
+		if (cells == 0 || cells > maxCellsPerAxis)
+		{
+			throw CommonException("Invalid spatial index grid size: " + std::to_string(cells), __LINE__, __FILE__);
+		}
+	}
+
+	// The first instance of each model among all instances, so that every
+	// instance can be marked when it is referenced
+	std::vector<size_t> firstInstance(m_Models.size());
+	size_t numInstances = 0;
+	for (size_t i = 0; i < m_Models.size(); ++i)
+	{
+		firstInstance[i] = numInstances;
+		numInstances += m_Models[i].m_Translation.size();
+	}
+	if (header.m_NumInstances != numInstances)
+	{
+		throw CommonException("Spatial index does not cover all instances", __LINE__, __FILE__);
+	}
+
+	const ArrayView<uint32_t> cellStart = p_Cursor.readArray<uint32_t>(getNumCells(header) + 1);
+	const ArrayView<InstanceRef> instances = p_Cursor.readArray<InstanceRef>(header.m_NumInstances);
+
+	if (cellStart[0] != 0 || cellStart[cellStart.size() - 1] != header.m_NumInstances)
+	{
+		throw CommonException("Invalid spatial index cell ranges", __LINE__, __FILE__);
+	}
+	for (size_t i = 1; i < cellStart.size(); ++i)
+	{
+		if (cellStart[i] < cellStart[i - 1])
+		{
+			throw CommonException("Invalid spatial index cell ranges", __LINE__, __FILE__);
+		}
+	}
+
+	// There are as many references as instances, so every instance is
+	// referenced exactly once if none is referenced twice
+	std::vector<bool> referenced(numInstances, false);
+	for (const auto& ref : instances)
+	{
+		if (ref.m_Model >= m_Models.size() || ref.m_Instance >= m_Models[ref.m_Model].m_Translation.size())
+		{
+			throw CommonException("Spatial index refers to a missing instance", __LINE__, __FILE__);
+		}
+
+		const size_t instance = firstInstance[ref.m_Model] + ref.m_Instance;
+		if (referenced[instance])
+		{
+			throw CommonException("Spatial index refers to an instance more than once", __LINE__, __FILE__);
+		}
+		referenced[instance] = true;
+	}
+
+	m_SpatialIndex.m_Header = header;
+	m_SpatialIndex.m_CellStart = cellStart;
+	m_SpatialIndex.m_Instances = instances;
+	m_HasSpatialIndex = true;
+}
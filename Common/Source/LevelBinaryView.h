@@ -0,0 +1,172 @@
+#pragma once
+
+#include "InstanceBinaryLoader.h"
+#include "LevelSpatialIndexFormat.h"
+#include "MappedFile.h"
+#include "Utilities/ArrayView.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * Zero-copy reader for binary level files (.btxl) and edge box files (.btxe).
+ *
+ * Reads the same format as InstanceBinaryLoader, but instead of copying
+ * the instance arrays all accessors point directly into the level data,
+ * which is either a memory mapped file or a buffer owned by the caller.
+ * The layout is validated when the data is opened, so the views returned
+ * never reach outside of the data.
+ *
+ * Levels converted with a spatial index also give access to the index, which
+ * groups the instances of all models by grid cell.
+ */
+class LevelDataCursor;
+
+class LevelBinaryView
+{
+public:
+	/**
+	 * All instances of one model in the level.
+	 */
+	struct ModelData
+	{
+		ArrayView<char> m_MeshName;
+		bool m_Animated;
+		bool m_Transparent;
+		bool m_CollideAble;
+		ArrayView<DirectX::XMFLOAT3> m_Translation;
+		ArrayView<DirectX::XMFLOAT3> m_Rotation;
+		ArrayView<DirectX::XMFLOAT3> m_Scale;
+	};
+
+	/**
+	 * All instances of one particle effect in the level.
+	 */
+	struct EffectData
+	{
+		ArrayView<char> m_EffectName;
+		ArrayView<DirectX::XMFLOAT3> m_Translation;
+		ArrayView<DirectX::XMFLOAT3> m_Rotation;
+	};
+
+	/**
+	 * The baked grid over the instances, see LevelSpatialIndexFormat.h.
+	 */
+	struct SpatialIndex
+	{
+		LevelSpatialIndexFormat::Header m_Header;
+		/**
+		 * The first instance of every cell, followed by the total number of instances.
+		 */
+		ArrayView<uint32_t> m_CellStart;
+		/**
+		 * All instances, sorted by cell.
+		 */
+		ArrayView<LevelSpatialIndexFormat::InstanceRef> m_Instances;
+	};
+
+private:
+	MappedFile m_File;
+	std::vector<char> m_Buffer;
+
+	const char* m_Data;
+	size_t m_Size;
+
+	InstanceBinaryLoader::Header m_Header;
+	std::vector<ModelData> m_Models;
+	std::vector<EffectData> m_Effects;
+	ArrayView<InstanceBinaryLoader::DirectionalLight> m_DirectionalLights;
+	ArrayView<InstanceBinaryLoader::PointLight> m_PointLights;
+	ArrayView<InstanceBinaryLoader::SpotLight> m_SpotLights;
+	std::vector<ArrayView<InstanceBinaryLoader::CheckPointStruct>> m_CheckPoints;
+	DirectX::XMFLOAT3 m_CheckPointStart;
+	DirectX::XMFLOAT3 m_CheckPointEnd;
+	bool m_HasSpatialIndex;
+	SpatialIndex m_SpatialIndex;
+
+public:
+	/**
+	 * Constructor, creates an empty view.
+	 */
+	LevelBinaryView();
+
+	/**
+	 * Memory map a level file and validate its content.
+	 *
+	 * @param p_FilePath the path to the .btxl or .btxe file
+	 * @throws CommonException if the file can not be mapped or is malformed
+	 */
+	void openFile(const std::string& p_FilePath);
+
+	/**
+	 * Validate level data already in memory, such as a received LEVEL_DATA package.
+	 * The buffer is not copied and has to outlive the view.
+	 *
+	 * @param p_Data pointer to the first byte of the level data
+	 * @param p_Size the size of the level data in bytes
+	 * @throws CommonException if the data is malformed
+	 */
+	void openBuffer(const char* p_Data, size_t p_Size);
+
+	/**
+	 * Copy level data that does not outlive the view, such as a received LEVEL_DATA
+	 * package that is cleared after the frame, and validate the copy.
+	 *
+	 * @param p_Data pointer to the first byte of the level data
+	 * @param p_Size the size of the level data in bytes
+	 * @throws CommonException if the data is malformed
+	 */
+	void openCopy(const char* p_Data, size_t p_Size);
+
+	/**
+	 * Release the mapping and forget all views into it.
+	 */
+	void close();
+
+	/**
+	 * @return the raw level data, for example to send it to a client
+	 */
+	const char* getData() const;
+
+	/**
+	 * @return the size of the raw level data in bytes
+	 */
+	size_t getSize() const;
+
+	const InstanceBinaryLoader::Header& getHeader() const;
+	const std::vector<ModelData>& getModelData() const;
+	ArrayView<InstanceBinaryLoader::DirectionalLight> getDirectionalLightData() const;
+	ArrayView<InstanceBinaryLoader::PointLight> getPointLightData() const;
+	ArrayView<InstanceBinaryLoader::SpotLight> getSpotLightData() const;
+	DirectX::XMFLOAT3 getCheckPointStart() const;
+	DirectX::XMFLOAT3 getCheckPointEnd() const;
+	const std::vector<ArrayView<InstanceBinaryLoader::CheckPointStruct>>& getCheckPointData() const;
+	const std::vector<EffectData>& getEffectData() const;
+
+	/**
+	 * @return true if the level was converted with a spatial index of the current version
+	 */
+	bool hasSpatialIndex() const;
+
+	/**
+	 * The spatial index of the level, only valid if hasSpatialIndex returns true.
+	 * All instance references are validated against the model data.
+	 */
+	const SpatialIndex& getSpatialIndex() const;
+
+	/**
+	 * Helper for the name views, which are not null terminated.
+	 *
+	 * @param p_Name a name view from the level data
+	 * @return a copy of the name
+	 */
+	static std::string toString(ArrayView<char> p_Name);
+
+private:
+	LevelBinaryView(const LevelBinaryView&);
+	LevelBinaryView& operator=(const LevelBinaryView&);
+
+	void parseOrClose();
+	void parse();
+	void parseSpatialIndex(LevelDataCursor& p_Cursor);
+};
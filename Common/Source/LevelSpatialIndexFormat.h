@@ -0,0 +1,157 @@
+#pragma once
+
+#include <DirectXMath.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+/**
+ * Layout of the spatial index that InstanceConverter appends to level files
+ * (.btxl and .btxe), read by LevelBinaryView.
+ *
+ * The index is a uniform grid over the instance positions of the level. It
+ * starts with a Header, followed by (cells + 1) uint32_t cell starts and
+ * Header::m_NumInstances InstanceRefs sorted by cell. The instances of cell c
+ * are the InstanceRefs in [cellStart[c], cellStart[c + 1]). Cells are numbered
+ * x first, then y, then z, see getCellIndex.
+ *
+ * The index is optional, level files written before it existed end after
+ * the effects and are still valid.
+ */
+namespace LevelSpatialIndexFormat
+{
+	/**
+	 * Identifies the index, the first four bytes after the effects.
+	 */
+	static const char magic[4] = { 'B', 'S', 'I', 'X' };
+
+	/**
+	 * Current version of the layout, increase when the layout changes.
+	 */
+	static const int version = 1;
+
+	/**
+	 * The average number of instances per cell the converter aims for.
+	 */
+	static const unsigned int instancesPerCell = 8;
+
+	/**
+	 * Upper limit of cells along one axis, to keep the cell starts small for sparse levels.
+	 */
+	static const unsigned int maxCellsPerAxis = 64;
+
+	struct Header
+	{
+		char m_Magic[4];
+		int m_Version;
+		/**
+		 * Bounds of the instance positions, in the same space as the instances.
+		 */
+		DirectX::XMFLOAT3 m_BoundsMin;
+		DirectX::XMFLOAT3 m_BoundsMax;
+		/**
+		 * Number of cells along x, y and z, at least one each.
+		 */
+		uint32_t m_Cells[3];
+		uint32_t m_NumInstances;
+	};
+
+	/**
+	 * One instance, as an index into the model list and the instance arrays of that model.
+	 */
+	struct InstanceRef
+	{
+		uint32_t m_Model;
+		uint32_t m_Instance;
+	};
+
+	inline uint32_t getNumCells(const Header& p_Header)
+	{
+		return p_Header.m_Cells[0] * p_Header.m_Cells[1] * p_Header.m_Cells[2];
+	}
+
+	/**
+	 * Choose the number of cells along each axis so that the cells are roughly
+	 * cubes holding instancesPerCell instances each. Flat axes get a single cell.
+	 */
+	inline void chooseCells(const DirectX::XMFLOAT3& p_Min, const DirectX::XMFLOAT3& p_Max, uint32_t p_NumInstances, uint32_t p_Cells[3])
+	{
+		const float extents[3] = { p_Max.x - p_Min.x, p_Max.y - p_Min.y, p_Max.z - p_Min.z };
+
+		float volume = 1.f;
+		int usedAxes = 0;
+		for (int i = 0; i < 3; ++i)
+		{
+			if (extents[i] > 0.f)
+			{
+				volume *= extents[i];
+				++usedAxes;
+			}
+		}
+
+		const float targetCells = (std::max)(1.f, (float)p_NumInstances / instancesPerCell);
+		const float cellSize = usedAxes == 0 ? 0.f : std::pow(volume / targetCells, 1.f / usedAxes);
+
+		for (int i = 0; i < 3; ++i)
+		{
+			p_Cells[i] = 1;
+			if (extents[i] > 0.f && cellSize > 0.f)
+			{
+				const float cells = std::ceil(extents[i] / cellSize);
+				p_Cells[i] = (uint32_t)(std::min)((std::max)(cells, 1.f), (float)maxCellsPerAxis);
+			}
+		}
+	}
+
+	/**
+	 * The cell containing a position, positions outside of the bounds are clamped to the border cells.
+	 */
+	inline uint32_t getCellIndex(const Header& p_Header, const DirectX::XMFLOAT3& p_Position)
+	{
+		const float position[3] = { p_Position.x, p_Position.y, p_Position.z };
+		const float boundsMin[3] = { p_Header.m_BoundsMin.x, p_Header.m_BoundsMin.y, p_Header.m_BoundsMin.z };
+		const float boundsMax[3] = { p_Header.m_BoundsMax.x, p_Header.m_BoundsMax.y, p_Header.m_BoundsMax.z };
+
+		uint32_t cell[3];
+		for (int i = 0; i < 3; ++i)
+		{
+			cell[i] = 0;
+			const float extent = boundsMax[i] - boundsMin[i];
+			if (extent > 0.f && position[i] > boundsMin[i])
+			{
+				const float relative = (position[i] - boundsMin[i]) / extent * p_Header.m_Cells[i];
+				cell[i] = (std::min)((uint32_t)relative, p_Header.m_Cells[i] - 1);
+			}
+		}
+
+		return cell[0] + p_Header.m_Cells[0] * (cell[1] + p_Header.m_Cells[1] * cell[2]);
+	}
+
+	/**
+	 * The bounds of a cell.
+	 */
+	inline void getCellBounds(const Header& p_Header, uint32_t p_Cell, DirectX::XMFLOAT3& p_Min, DirectX::XMFLOAT3& p_Max)
+	{
+		const uint32_t cell[3] =
+		{
+			p_Cell % p_Header.m_Cells[0],
+			(p_Cell / p_Header.m_Cells[0]) % p_Header.m_Cells[1],
+			p_Cell / (p_Header.m_Cells[0] * p_Header.m_Cells[1])
+		};
+		const float boundsMin[3] = { p_Header.m_BoundsMin.x, p_Header.m_BoundsMin.y, p_Header.m_BoundsMin.z };
+		const float boundsMax[3] = { p_Header.m_BoundsMax.x, p_Header.m_BoundsMax.y, p_Header.m_BoundsMax.z };
+
+		float cellMin[3];
+		float cellMax[3];
+		for (int i = 0; i < 3; ++i)
+		{
+			const float size = (boundsMax[i] - boundsMin[i]) / p_Header.m_Cells[i];
+			cellMin[i] = boundsMin[i] + size * cell[i];
+			cellMax[i] = cell[i] + 1 == p_Header.m_Cells[i] ? boundsMax[i] : cellMin[i] + size;
+		}
+
+		p_Min = DirectX::XMFLOAT3(cellMin[0], cellMin[1], cellMin[2]);
+		p_Max = DirectX::XMFLOAT3(cellMax[0], cellMax[1], cellMax[2]);
+	}
+}
@@ -7,12 +7,22 @@ void LookComponent::initialize(const tinyxml2::XMLElement* p_Data)
 	m_OffsetPosition = Vector3(0.f, 0.f, 0.f);
 	m_Forward = Vector3(0.f, 0.f, 1.f);
 	m_Up = Vector3(0.f, 1.f, 0.f);
+	m_HeadBaseJoint = AnimationData::invalidHandle;
 
 	queryVector(p_Data->FirstChildElement("OffsetPosition"), m_OffsetPosition);
 	queryVector(p_Data->FirstChildElement("Forward"), m_Forward);
 	queryVector(p_Data->FirstChildElement("Up"), m_Up);
 }
 
+void LookComponent::postInit()
+{
+	std::shared_ptr<HumanAnimationComponent> comp = m_Owner->getComponent<HumanAnimationComponent>(HumanAnimationComponent::m_ComponentId).lock();
+	if (comp)
+	{
+		m_HeadBaseJoint = comp->findJoint("HeadBase");
+	}
+}
+
 void LookComponent::serialize(tinyxml2::XMLPrinter& p_Printer) const
 {
 	p_Printer.OpenElement("Look");
@@ -33,7 +43,7 @@ Vector3 LookComponent::getLookPosition() const
 		Vector3 rotOffset;
 		XMStoreFloat3(&rotOffset, XMVector3Transform(XMLoadFloat3(&m_OffsetPosition), rot));
 
-		return Vector3(comp->getJointPos("HeadBase")) + rotOffset;
+		return Vector3(comp->getJointPos(m_HeadBaseJoint)) + rotOffset;
 	}
 	else
 	{
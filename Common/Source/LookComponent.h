@@ -8,9 +8,11 @@ private:
 	Vector3 m_OffsetPosition;
 	Vector3 m_Forward;
 	Vector3 m_Up;
+	AnimationData::Handle m_HeadBaseJoint;
 
 public:
 	void initialize(const tinyxml2::XMLElement* p_Data) override;
+	void postInit() override;
 	void serialize(tinyxml2::XMLPrinter& p_Printer) const override;
 
 	Vector3 getLookPosition() const override;
@@ -0,0 +1,82 @@
+#include "MappedFile.h"
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/exceptions.hpp>
+
+using namespace boost::interprocess;
+
+MappedFile::MappedFile()
+	:	m_Data(nullptr),
+		m_Size(0)
+{
+}
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+bool MappedFile::open(const std::string& p_FilePath)
+{
+	close();
+
+	boost::system::error_code error;
+	if (!boost::filesystem::is_regular_file(p_FilePath, error))
+	{
+		return false;
+	}
+	const boost::uintmax_t size = boost::filesystem::file_size(p_FilePath, error);
+	if (error)
+	{
+		return false;
+	}
+
+	try
+	{
+		// An empty file can not be mapped, but it is still a valid file to read
+		file_mapping file(p_FilePath.c_str(), read_only);
+		if (size > 0)
+		{
+			mapped_region region(file, read_only);
+			m_Region.swap(region);
+			m_File.swap(file);
+			m_Data = static_cast<const char*>(m_Region.get_address());
+			m_Size = m_Region.get_size();
+		}
+		else
+		{
+			m_Data = "";
+		}
+	}
+	catch (interprocess_exception&)
+	{
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+void MappedFile::close()
+{
+	mapped_region().swap(m_Region);
+	file_mapping().swap(m_File);
+
+	m_Data = nullptr;
+	m_Size = 0;
+}
+
+bool MappedFile::isOpen() const
+{
+	return m_Data != nullptr;
+}
+
+const char* MappedFile::getData() const
+{
+	return m_Data;
+}
+
+size_t MappedFile::getSize() const
+{
+	return m_Size;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <cstddef>
+#include <string>
+
+/**
+ * A read only view of a whole file, mapped into memory by the operating system.
+ *
+ * Used for parsing assets without copying them into stream buffers first, and
+ * for keeping level files and asset archives mapped while they are in use.
+ */
+class MappedFile
+{
+private:
+	boost::interprocess::file_mapping m_File;
+	/**
+	 * Empty for open empty files, which can not be mapped.
+	 */
+	boost::interprocess::mapped_region m_Region;
+	const char* m_Data;
+	size_t m_Size;
+
+public:
+	/**
+	 * Constructor, creates a closed file.
+	 */
+	MappedFile();
+	/**
+	 * Destructor, unmaps the file if open.
+	 */
+	~MappedFile();
+
+	/**
+	 * Map a file into memory, closing any previously mapped file.
+	 *
+	 * @param p_FilePath the path to the file
+	 * @return false if the file could not be opened or mapped
+	 */
+	bool open(const std::string& p_FilePath);
+
+	/**
+	 * Unmap the file. Any pointers into the file become invalid.
+	 */
+	void close();
+
+	bool isOpen() const;
+
+	/**
+	 * The contents of the file. Not null terminated, but valid for an empty file.
+	 */
+	const char* getData() const;
+
+	/**
+	 * The size of the file in bytes.
+	 */
+	size_t getSize() const;
+
+private:
+	MappedFile(const MappedFile&);
+	MappedFile& operator=(const MappedFile&);
+};
@@ -0,0 +1,83 @@
+#include "MaterialBundle.h"
+#include "MappedFile.h"
+
+#include <cstring>
+
+using namespace MaterialBundleFormat;
+
+MaterialBundle::MaterialBundle()
+	:	m_TableHash(0)
+{
+}
+
+bool MaterialBundle::load(const char* p_Data, size_t p_Size)
+{
+	clear();
+
+	if (p_Size < sizeof(BundleHeader))
+	{
+		return false;
+	}
+
+	BundleHeader header;
+	memcpy(&header, p_Data, sizeof(header));
+	if (memcmp(header.m_Magic, bundleMagic, sizeof(header.m_Magic)) != 0
+		|| header.m_Version != version
+		|| header.m_NumMaterials > (p_Size - sizeof(BundleHeader)) / sizeof(MaterialEntry)
+		|| header.m_StringsSize != p_Size - sizeof(BundleHeader) - header.m_NumMaterials * sizeof(MaterialEntry))
+	{
+		return false;
+	}
+
+	const char* entries = p_Data + sizeof(BundleHeader);
+	const char* strings = entries + header.m_NumMaterials * sizeof(MaterialEntry);
+	m_Materials.resize(header.m_NumMaterials);
+	for (uint32_t i = 0; i < header.m_NumMaterials; ++i)
+	{
+		MaterialEntry entry;
+		memcpy(&entry, entries + i * sizeof(MaterialEntry), sizeof(entry));
+		if (entry.m_IDOffset > header.m_StringsSize
+			|| entry.m_IDLength > header.m_StringsSize - entry.m_IDOffset)
+		{
+			clear();
+			return false;
+		}
+
+		Material& material = m_Materials[i];
+		material.m_MaterialID.assign(strings + entry.m_IDOffset, entry.m_IDLength);
+		material.m_Diffuse = entry.m_Diffuse;
+		material.m_Normal = entry.m_Normal;
+		material.m_Specular = entry.m_Specular;
+	}
+
+	m_TableHash = header.m_TableHash;
+	return true;
+}
+
+bool MaterialBundle::loadFile(const std::string& p_FilePath)
+{
+	MappedFile file;
+	if (!file.open(p_FilePath))
+	{
+		clear();
+		return false;
+	}
+
+	return load(file.getData(), file.getSize());
+}
+
+void MaterialBundle::clear()
+{
+	m_Materials.clear();
+	m_TableHash = 0;
+}
+
+const std::vector<MaterialBundle::Material>& MaterialBundle::getMaterials() const
+{
+	return m_Materials;
+}
+
+uint64_t MaterialBundle::getTableHash() const
+{
+	return m_TableHash;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "MaterialBundleFormat.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * The materials of a model with their textures resolved to texture table IDs,
+ * read from a material bundle (.bmb), see MaterialBundleFormat.h.
+ */
+class MaterialBundle
+{
+public:
+	struct Material
+	{
+		std::string m_MaterialID;
+		/**
+		 * Texture IDs in the table the bundle was built against,
+		 * MaterialBundleFormat::invalidTexture if the texture was not in the table.
+		 */
+		unsigned int m_Diffuse;
+		unsigned int m_Normal;
+		unsigned int m_Specular;
+	};
+
+private:
+	std::vector<Material> m_Materials;
+	uint64_t m_TableHash;
+
+public:
+	/**
+	 * Constructor, creates an empty bundle.
+	 */
+	MaterialBundle();
+
+	/**
+	 * Read a material bundle, replacing the current contents.
+	 *
+	 * @param p_Data the contents of a .bmb file
+	 * @param p_Size the size of the contents in bytes
+	 * @return false if the data is not a valid material bundle, which leaves the bundle empty
+	 */
+	bool load(const char* p_Data, size_t p_Size);
+
+	/**
+	 * Read a material bundle from a file, replacing the current contents.
+	 *
+	 * @return false if the file could not be read or is not a valid material bundle
+	 */
+	bool loadFile(const std::string& p_FilePath);
+
+	void clear();
+
+	const std::vector<Material>& getMaterials() const;
+
+	/**
+	 * The hash of the texture table the bundle was built against,
+	 * compare with TextureTable::getHash before using the texture IDs.
+	 */
+	uint64_t getTableHash() const;
+};
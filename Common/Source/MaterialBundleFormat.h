@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Layout of texture tables (.btt) and material bundles (.bmb) written by
+ * BinaryConverter and read by TextureTable and MaterialBundle.
+ *
+ * A texture table describes every texture in a texture directory: its file
+ * name, the container it is stored in, and the format, size and mip count it
+ * loads as. Textures are identified by their index in the table. A table
+ * starts with a TableHeader, followed by m_NumTextures TextureEntry records
+ * and a string table with the file names.
+ *
+ * A material bundle belongs to a model (.btx) and replaces the texture names
+ * of its materials with texture IDs from a table. It starts with a
+ * BundleHeader, followed by m_NumMaterials MaterialEntry records and a string
+ * table with the material IDs. The hash of the table the bundle was built
+ * against is stored so that stale bundles can be detected.
+ *
+ * All values are little endian, as written by the converter.
+ */
+namespace MaterialBundleFormat
+{
+	/**
+	 * Identifies a texture table, the first four bytes of every table.
+	 */
+	static const char tableMagic[4] = { 'B', 'T', 'T', 'B' };
+
+	/**
+	 * Identifies a material bundle, the first four bytes of every bundle.
+	 */
+	static const char bundleMagic[4] = { 'B', 'M', 'T', 'B' };
+
+	/**
+	 * Current version of both layouts, increase when a layout changes.
+	 */
+	static const int version = 1;
+
+	/**
+	 * Texture ID of a material map without a texture in the table.
+	 */
+	static const uint32_t invalidTexture = 0xffffffff;
+
+	/**
+	 * How the texture file is stored, which decides the loader used for it.
+	 */
+	enum Container
+	{
+		DDS_CONTAINER = 0,
+		WIC_CONTAINER = 1,
+	};
+
+	struct TableHeader
+	{
+		char m_Magic[4];
+		int m_Version;
+		uint32_t m_NumTextures;
+		uint32_t m_StringsSize;
+	};
+
+	struct TextureEntry
+	{
+		/**
+		 * The file name, relative to the string table.
+		 */
+		uint32_t m_NameOffset;
+		uint32_t m_NameLength;
+		uint32_t m_Container;
+		/**
+		 * A DXGI_FORMAT value, or 0 (DXGI_FORMAT_UNKNOWN) when the format is
+		 * decided by the WIC decoder.
+		 */
+		uint32_t m_Format;
+		uint32_t m_Width;
+		uint32_t m_Height;
+		uint32_t m_MipLevels;
+		uint32_t m_ArraySize;
+	};
+
+	struct BundleHeader
+	{
+		char m_Magic[4];
+		int m_Version;
+		uint64_t m_TableHash;
+		uint32_t m_NumMaterials;
+		uint32_t m_StringsSize;
+	};
+
+	struct MaterialEntry
+	{
+		/**
+		 * The material ID, relative to the string table.
+		 */
+		uint32_t m_IDOffset;
+		uint32_t m_IDLength;
+		uint32_t m_Diffuse;
+		uint32_t m_Normal;
+		uint32_t m_Specular;
+	};
+
+	/**
+	 * 64-bit FNV-1a hash, used to identify the contents of a texture table.
+	 */
+	inline uint64_t hashData(const char* p_Data, size_t p_Size)
+	{
+		uint64_t hash = 14695981039346656037ull;
+		for (size_t i = 0; i < p_Size; ++i)
+		{
+			hash ^= static_cast<unsigned char>(p_Data[i]);
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+}
@@ -0,0 +1,105 @@
+#include "PoseArena.h"
+#include "CommonExceptions.h"
+
+#include <algorithm>
+
+using namespace DirectX;
+
+PoseArena::PoseArena(unsigned int p_ChunkSize)
+	:	m_ChunkSize(p_ChunkSize),
+		m_ChunkUsed(0),
+		m_CurrentChunk(nullptr),
+		m_Capacity(0)
+{
+}
+
+PoseArena::Pose* PoseArena::allocate(unsigned int p_Size)
+{
+	if (p_Size == 0)
+	{
+		throw InvalidArgument("Pose size must be larger than 0", __LINE__, __FILE__);
+	}
+
+	// Both buffers of a pose are allocated as one range
+	const unsigned int rangeSize = p_Size * 2;
+	XMFLOAT4X4* range = nullptr;
+
+	auto freeRange = m_FreeRanges.find(rangeSize);
+	if (freeRange != m_FreeRanges.end())
+	{
+		range = freeRange->second;
+		m_FreeRanges.erase(freeRange);
+	}
+	else if (rangeSize > m_ChunkSize)
+	{
+		// Oversized poses get a chunk of their own
+		range = allocateChunk(rangeSize);
+	}
+	else
+	{
+		if (!m_CurrentChunk || m_ChunkUsed + rangeSize > m_ChunkSize)
+		{
+			m_CurrentChunk = allocateChunk(m_ChunkSize);
+			m_ChunkUsed = 0;
+		}
+
+		range = m_CurrentChunk + m_ChunkUsed;
+		m_ChunkUsed += rangeSize;
+	}
+
+	XMFLOAT4X4 identity;
+	XMStoreFloat4x4(&identity, XMMatrixIdentity());
+	std::fill(range, range + rangeSize, identity);
+
+	std::unique_ptr<Pose> pose(new Pose);
+	pose->m_Front = range;
+	pose->m_Back = range + p_Size;
+	pose->m_Size = p_Size;
+
+	m_Poses.push_back(std::move(pose));
+	return m_Poses.back().get();
+}
+
+void PoseArena::release(Pose* p_Pose)
+{
+	if (!p_Pose)
+	{
+		return;
+	}
+
+	auto it = std::find_if(m_Poses.begin(), m_Poses.end(),
+		[p_Pose] (const std::unique_ptr<Pose>& p_Other) { return p_Other.get() == p_Pose; });
+	if (it == m_Poses.end())
+	{
+		return;
+	}
+
+	// The range starts at whichever buffer comes first
+	XMFLOAT4X4* range = (std::min)(p_Pose->m_Front, p_Pose->m_Back);
+	m_FreeRanges.insert(std::make_pair(p_Pose->m_Size * 2, range));
+
+	std::swap(*it, m_Poses.back());
+	m_Poses.pop_back();
+}
+
+void PoseArena::publish(Pose* p_Pose)
+{
+	std::swap(p_Pose->m_Front, p_Pose->m_Back);
+}
+
+unsigned int PoseArena::getNumPoses() const
+{
+	return m_Poses.size();
+}
+
+unsigned int PoseArena::getCapacity() const
+{
+	return m_Capacity;
+}
+
+DirectX::XMFLOAT4X4* PoseArena::allocateChunk(unsigned int p_Size)
+{
+	m_Chunks.push_back(std::unique_ptr<XMFLOAT4X4[]>(new XMFLOAT4X4[p_Size]));
+	m_Capacity += p_Size;
+	return m_Chunks.back().get();
+}
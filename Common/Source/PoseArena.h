@@ -0,0 +1,88 @@
+#pragma once
+
+#include <DirectXMath.h>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+/**
+ * Double buffered storage for the final poses of all animated instances.
+ *
+ * Every pose has a front buffer that readers, such as the renderer, use directly
+ * and a back buffer that the animation system writes the next pose to. Publishing
+ * a pose flips the two, so readers always see a complete pose without copying it.
+ * The buffers are carved out of large chunks so the poses of all instances stay
+ * close together in memory, and released ranges are reused by later poses of the
+ * same size.
+ */
+class PoseArena
+{
+public:
+	typedef std::shared_ptr<PoseArena> ptr;
+
+	/**
+	 * A pose in the arena. The address of m_Front is stable for the lifetime of
+	 * the pose and can be handed to readers that need to follow the flips.
+	 */
+	struct Pose
+	{
+		DirectX::XMFLOAT4X4* m_Front;
+		DirectX::XMFLOAT4X4* m_Back;
+		unsigned int m_Size;
+	};
+
+private:
+	unsigned int m_ChunkSize;
+	std::vector<std::unique_ptr<DirectX::XMFLOAT4X4[]>> m_Chunks;
+	unsigned int m_ChunkUsed;
+	DirectX::XMFLOAT4X4* m_CurrentChunk;
+	unsigned int m_Capacity;
+	std::multimap<unsigned int, DirectX::XMFLOAT4X4*> m_FreeRanges;
+	std::vector<std::unique_ptr<Pose>> m_Poses;
+
+public:
+	/**
+	 * Constructor.
+	 *
+	 * @param p_ChunkSize the number of matrices to allocate at a time
+	 */
+	explicit PoseArena(unsigned int p_ChunkSize);
+
+	/**
+	 * Allocate a pose with both buffers initialized to identity. Not thread safe.
+	 *
+	 * @param p_Size the number of matrices in the pose
+	 * @return the pose, valid until it is released or the arena destroyed
+	 */
+	Pose* allocate(unsigned int p_Size);
+
+	/**
+	 * Return a pose to the arena. Not thread safe.
+	 *
+	 * @param p_Pose a pose from allocate, or nullptr
+	 */
+	void release(Pose* p_Pose);
+
+	/**
+	 * Make the back buffer of a pose the front buffer. Readers see the new pose
+	 * the next time they read the front pointer.
+	 */
+	static void publish(Pose* p_Pose);
+
+	/**
+	 * @return the number of poses currently allocated
+	 */
+	unsigned int getNumPoses() const;
+
+	/**
+	 * @return the number of matrices allocated from the system, used or not
+	 */
+	unsigned int getCapacity() const;
+
+private:
+	DirectX::XMFLOAT4X4* allocateChunk(unsigned int p_Size);
+
+	PoseArena(const PoseArena&);
+	PoseArena& operator=(const PoseArena&);
+};
@@ -0,0 +1,230 @@
+#include "PoseBlender.h"
+
+#include "CommonExceptions.h"
+
+using namespace DirectX;
+
+PoseBuffer::PoseBuffer()
+	:	m_NumPoses(0),
+		m_NumJoints(0),
+		m_Stride(0)
+{
+}
+
+void PoseBuffer::resize(unsigned int p_NumPoses, unsigned int p_NumJoints)
+{
+	m_NumPoses = p_NumPoses;
+	m_NumJoints = p_NumJoints;
+	m_Stride = (p_NumJoints + 3) & ~3u;
+
+	const size_t size = (size_t)m_NumPoses * m_Stride;
+	for (unsigned int i = 0; i < NUM_CHANNELS; ++i)
+	{
+		const float identity = (i == ROTATION_W || i >= SCALE_X) ? 1.f : 0.f;
+		m_Channels[i].assign(size, identity);
+	}
+}
+
+unsigned int PoseBuffer::getNumPoses() const
+{
+	return m_NumPoses;
+}
+
+unsigned int PoseBuffer::getNumJoints() const
+{
+	return m_NumJoints;
+}
+
+unsigned int PoseBuffer::getStride() const
+{
+	return m_Stride;
+}
+
+float* PoseBuffer::getChannel(Channel p_Channel)
+{
+	return m_Channels[p_Channel].data();
+}
+
+const float* PoseBuffer::getChannel(Channel p_Channel) const
+{
+	return m_Channels[p_Channel].data();
+}
+
+void PoseBuffer::loadKeyFrame(unsigned int p_Pose, const std::vector<Joint>& p_Joints, unsigned int p_Frame)
+{
+	if (p_Joints.size() != m_NumJoints)
+	{
+		throw CommonException("Skeleton does not match the pose buffer", __LINE__, __FILE__);
+	}
+
+	const size_t base = (size_t)p_Pose * m_Stride;
+	for (unsigned int i = 0; i < m_NumJoints; ++i)
+	{
+		const KeyFrame key = p_Joints[i].getKeyFrame(p_Frame);
+		const size_t index = base + i;
+
+		m_Channels[TRANSLATION_X][index] = key.m_Trans.x;
+		m_Channels[TRANSLATION_Y][index] = key.m_Trans.y;
+		m_Channels[TRANSLATION_Z][index] = key.m_Trans.z;
+		m_Channels[ROTATION_X][index] = key.m_Rot.x;
+		m_Channels[ROTATION_Y][index] = key.m_Rot.y;
+		m_Channels[ROTATION_Z][index] = key.m_Rot.z;
+		m_Channels[ROTATION_W][index] = key.m_Rot.w;
+		m_Channels[SCALE_X][index] = key.m_Scale.x;
+		m_Channels[SCALE_Y][index] = key.m_Scale.y;
+		m_Channels[SCALE_Z][index] = key.m_Scale.z;
+	}
+}
+
+void PoseBuffer::setJoint(unsigned int p_Pose, unsigned int p_Joint, const MatrixDecomposed& p_Transform)
+{
+	const size_t index = (size_t)p_Pose * m_Stride + p_Joint;
+
+	m_Channels[TRANSLATION_X][index] = p_Transform.translation.x;
+	m_Channels[TRANSLATION_Y][index] = p_Transform.translation.y;
+	m_Channels[TRANSLATION_Z][index] = p_Transform.translation.z;
+	m_Channels[ROTATION_X][index] = p_Transform.rotation.x;
+	m_Channels[ROTATION_Y][index] = p_Transform.rotation.y;
+	m_Channels[ROTATION_Z][index] = p_Transform.rotation.z;
+	m_Channels[ROTATION_W][index] = p_Transform.rotation.w;
+	m_Channels[SCALE_X][index] = p_Transform.scale.x;
+	m_Channels[SCALE_Y][index] = p_Transform.scale.y;
+	m_Channels[SCALE_Z][index] = p_Transform.scale.z;
+}
+
+MatrixDecomposed PoseBuffer::getJoint(unsigned int p_Pose, unsigned int p_Joint) const
+{
+	const size_t index = (size_t)p_Pose * m_Stride + p_Joint;
+
+	MatrixDecomposed result;
+	result.translation = XMFLOAT4(m_Channels[TRANSLATION_X][index], m_Channels[TRANSLATION_Y][index],
+		m_Channels[TRANSLATION_Z][index], 0.f);
+	result.rotation = XMFLOAT4(m_Channels[ROTATION_X][index], m_Channels[ROTATION_Y][index],
+		m_Channels[ROTATION_Z][index], m_Channels[ROTATION_W][index]);
+	result.scale = XMFLOAT4(m_Channels[SCALE_X][index], m_Channels[SCALE_Y][index],
+		m_Channels[SCALE_Z][index], 0.f);
+
+	return result;
+}
+
+/**
+ * Load four consecutive channel values into one register.
+ */
+static XMVECTOR loadLanes(const float* p_Values)
+{
+	return XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(p_Values));
+}
+
+static void storeLanes(float* p_Values, FXMVECTOR p_Lanes)
+{
+	XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(p_Values), p_Lanes);
+}
+
+void PoseBlender::blend(PoseBuffer& p_Dest, const PoseBuffer& p_Source, const float* p_Weights, RotationBlend p_Mode)
+{
+	blendRange(p_Dest, p_Source, p_Weights, p_Mode, 0, p_Dest.getNumPoses());
+}
+
+void PoseBlender::blendRange(PoseBuffer& p_Dest, const PoseBuffer& p_Source, const float* p_Weights, RotationBlend p_Mode,
+	unsigned int p_FirstPose, unsigned int p_NumPoses)
+{
+	if (p_Dest.getNumPoses() != p_Source.getNumPoses() || p_Dest.getNumJoints() != p_Source.getNumJoints())
+	{
+		throw CommonException("Pose buffers to blend differ in size", __LINE__, __FILE__);
+	}
+	if (p_FirstPose + p_NumPoses > p_Dest.getNumPoses())
+	{
+		throw CommonException("Pose range outside of the buffer", __LINE__, __FILE__);
+	}
+
+	const unsigned int stride = p_Dest.getStride();
+
+	float* dst[PoseBuffer::NUM_CHANNELS];
+	const float* src[PoseBuffer::NUM_CHANNELS];
+	for (unsigned int c = 0; c < PoseBuffer::NUM_CHANNELS; ++c)
+	{
+		dst[c] = p_Dest.getChannel((PoseBuffer::Channel)c);
+		src[c] = p_Source.getChannel((PoseBuffer::Channel)c);
+	}
+
+	// Below this angle cosine slerp degenerates, fall back to nlerp.
+	static const XMVECTORF32 slerpThreshold = { 0.9995f, 0.9995f, 0.9995f, 0.9995f };
+
+	const XMVECTOR zero = XMVectorZero();
+	const XMVECTOR one = XMVectorSplatOne();
+
+	for (unsigned int pose = p_FirstPose; pose < p_FirstPose + p_NumPoses; ++pose)
+	{
+		for (size_t i = (size_t)pose * stride; i < (size_t)(pose + 1) * stride; i += 4)
+		{
+			const XMVECTOR t = loadLanes(p_Weights + i);
+			const XMVECTOR invT = XMVectorSubtract(one, t);
+
+			// Translation and scale, plain lerp
+			for (unsigned int c = PoseBuffer::TRANSLATION_X; c <= PoseBuffer::TRANSLATION_Z; ++c)
+			{
+				storeLanes(dst[c] + i, XMVectorLerpV(loadLanes(dst[c] + i), loadLanes(src[c] + i), t));
+			}
+			for (unsigned int c = PoseBuffer::SCALE_X; c <= PoseBuffer::SCALE_Z; ++c)
+			{
+				storeLanes(dst[c] + i, XMVectorLerpV(loadLanes(dst[c] + i), loadLanes(src[c] + i), t));
+			}
+
+			// Rotation, one quaternion component per register and one joint per lane
+			const XMVECTOR ax = loadLanes(dst[PoseBuffer::ROTATION_X] + i);
+			const XMVECTOR ay = loadLanes(dst[PoseBuffer::ROTATION_Y] + i);
+			const XMVECTOR az = loadLanes(dst[PoseBuffer::ROTATION_Z] + i);
+			const XMVECTOR aw = loadLanes(dst[PoseBuffer::ROTATION_W] + i);
+			XMVECTOR bx = loadLanes(src[PoseBuffer::ROTATION_X] + i);
+			XMVECTOR by = loadLanes(src[PoseBuffer::ROTATION_Y] + i);
+			XMVECTOR bz = loadLanes(src[PoseBuffer::ROTATION_Z] + i);
+			XMVECTOR bw = loadLanes(src[PoseBuffer::ROTATION_W] + i);
+
+			XMVECTOR cosAngle = XMVectorMultiply(ax, bx);
+			cosAngle = XMVectorMultiplyAdd(ay, by, cosAngle);
+			cosAngle = XMVectorMultiplyAdd(az, bz, cosAngle);
+			cosAngle = XMVectorMultiplyAdd(aw, bw, cosAngle);
+
+			// Take the shortest arc by flipping the target where the dot product is negative
+			const XMVECTOR flip = XMVectorLess(cosAngle, zero);
+			bx = XMVectorSelect(bx, XMVectorNegate(bx), flip);
+			by = XMVectorSelect(by, XMVectorNegate(by), flip);
+			bz = XMVectorSelect(bz, XMVectorNegate(bz), flip);
+			bw = XMVectorSelect(bw, XMVectorNegate(bw), flip);
+			cosAngle = XMVectorAbs(cosAngle);
+
+			XMVECTOR weightA = invT;
+			XMVECTOR weightB = t;
+			if (p_Mode == RotationBlend::SLERP)
+			{
+				const XMVECTOR angle = XMVectorACos(XMVectorMin(cosAngle, one));
+				const XMVECTOR invSin = XMVectorReciprocal(XMVectorSin(angle));
+				const XMVECTOR slerpA = XMVectorMultiply(XMVectorSin(XMVectorMultiply(invT, angle)), invSin);
+				const XMVECTOR slerpB = XMVectorMultiply(XMVectorSin(XMVectorMultiply(t, angle)), invSin);
+
+				const XMVECTOR useLinear = XMVectorGreater(cosAngle, slerpThreshold);
+				weightA = XMVectorSelect(slerpA, invT, useLinear);
+				weightB = XMVectorSelect(slerpB, t, useLinear);
+			}
+
+			XMVECTOR rx = XMVectorMultiplyAdd(bx, weightB, XMVectorMultiply(ax, weightA));
+			XMVECTOR ry = XMVectorMultiplyAdd(by, weightB, XMVectorMultiply(ay, weightA));
+			XMVECTOR rz = XMVectorMultiplyAdd(bz, weightB, XMVectorMultiply(az, weightA));
+			XMVECTOR rw = XMVectorMultiplyAdd(bw, weightB, XMVectorMultiply(aw, weightA));
+
+			XMVECTOR lengthSq = XMVectorMultiply(rx, rx);
+			lengthSq = XMVectorMultiplyAdd(ry, ry, lengthSq);
+			lengthSq = XMVectorMultiplyAdd(rz, rz, lengthSq);
+			lengthSq = XMVectorMultiplyAdd(rw, rw, lengthSq);
+
+			// Padding lanes may be all zero, leave those untouched
+			const XMVECTOR valid = XMVectorGreater(lengthSq, zero);
+			const XMVECTOR invLength = XMVectorSelect(one, XMVectorReciprocalSqrt(lengthSq), valid);
+
+			storeLanes(dst[PoseBuffer::ROTATION_X] + i, XMVectorMultiply(rx, invLength));
+			storeLanes(dst[PoseBuffer::ROTATION_Y] + i, XMVectorMultiply(ry, invLength));
+			storeLanes(dst[PoseBuffer::ROTATION_Z] + i, XMVectorMultiply(rz, invLength));
+			storeLanes(dst[PoseBuffer::ROTATION_W] + i, XMVectorMultiply(rw, invLength));
+		}
+	}
+}
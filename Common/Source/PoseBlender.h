@@ -0,0 +1,118 @@
+#pragma once
+
+#include "Joint.h"
+
+#include <DirectXMath.h>
+#include <vector>
+
+/**
+ * Joint poses of many characters stored as structure of arrays.
+ *
+ * Each channel (translation x, y, z, rotation x, y, z, w and scale x, y, z) is
+ * a separate float array. The joints of a pose are padded to a multiple of four,
+ * so every group of four consecutive values belongs to the same pose and can be
+ * processed in one SIMD register.
+ */
+class PoseBuffer
+{
+public:
+	enum Channel
+	{
+		TRANSLATION_X,
+		TRANSLATION_Y,
+		TRANSLATION_Z,
+		ROTATION_X,
+		ROTATION_Y,
+		ROTATION_Z,
+		ROTATION_W,
+		SCALE_X,
+		SCALE_Y,
+		SCALE_Z,
+
+		NUM_CHANNELS
+	};
+
+private:
+	unsigned int m_NumPoses;
+	unsigned int m_NumJoints;
+	unsigned int m_Stride;
+	std::vector<float> m_Channels[NUM_CHANNELS];
+
+public:
+	/**
+	 * Constructor, creates an empty buffer.
+	 */
+	PoseBuffer();
+
+	/**
+	 * Resize the buffer, all joints are reset to the identity transformation.
+	 *
+	 * @param p_NumPoses the number of characters in the buffer
+	 * @param p_NumJoints the number of joints of every character
+	 */
+	void resize(unsigned int p_NumPoses, unsigned int p_NumJoints);
+
+	unsigned int getNumPoses() const;
+	unsigned int getNumJoints() const;
+
+	/**
+	 * @return the number of values per pose in each channel, the joint count rounded up to a multiple of four
+	 */
+	unsigned int getStride() const;
+
+	float* getChannel(Channel p_Channel);
+	const float* getChannel(Channel p_Channel) const;
+
+	/**
+	 * Copy one key frame of every joint in a skeleton into a pose.
+	 *
+	 * @param p_Pose the pose to write
+	 * @param p_Joints the skeleton, must have getNumJoints() joints
+	 * @param p_Frame the key frame to copy
+	 */
+	void loadKeyFrame(unsigned int p_Pose, const std::vector<Joint>& p_Joints, unsigned int p_Frame);
+
+	void setJoint(unsigned int p_Pose, unsigned int p_Joint, const MatrixDecomposed& p_Transform);
+	MatrixDecomposed getJoint(unsigned int p_Pose, unsigned int p_Joint) const;
+};
+
+/**
+ * Blends whole batches of poses, four joints at a time.
+ * Splitting a batch over threads is left to the caller, see AnimationJobSystem.
+ */
+class PoseBlender
+{
+public:
+	enum class RotationBlend
+	{
+		/**
+		 * Normalized linear interpolation, cheap and accurate for small angles.
+		 */
+		NLERP,
+		/**
+		 * Spherical linear interpolation, constant angular velocity.
+		 */
+		SLERP,
+	};
+
+	/**
+	 * Blend p_Source into p_Dest, in place. Translation and scale are
+	 * interpolated linearly, rotations along the shortest arc.
+	 *
+	 * @param p_Dest the poses to blend from, receives the result
+	 * @param p_Source the poses to blend towards, same size as p_Dest
+	 * @param p_Weights one weight per joint laid out like the channels, getStride() values per pose.
+	 *			0 keeps p_Dest and 1 gives p_Source
+	 * @param p_Mode how the rotations are interpolated
+	 */
+	static void blend(PoseBuffer& p_Dest, const PoseBuffer& p_Source, const float* p_Weights, RotationBlend p_Mode);
+
+	/**
+	 * Blend a range of poses, see blend.
+	 *
+	 * @param p_FirstPose the first pose to blend
+	 * @param p_NumPoses the number of poses to blend
+	 */
+	static void blendRange(PoseBuffer& p_Dest, const PoseBuffer& p_Source, const float* p_Weights, RotationBlend p_Mode,
+		unsigned int p_FirstPose, unsigned int p_NumPoses);
+};
@@ -0,0 +1,69 @@
+#include "PoseScratchPool.h"
+
+using namespace DirectX;
+
+PoseScratchPool::PoseScratchPool(unsigned int p_SlotSize, unsigned int p_SlotsPerChunk)
+	:	m_SlotSize(p_SlotSize),
+		m_SlotsPerChunk(p_SlotsPerChunk > 0 ? p_SlotsPerChunk : 1)
+{
+}
+
+XMFLOAT4X4* PoseScratchPool::acquire()
+{
+	XMFLOAT4X4* slot = nullptr;
+	{
+		std::lock_guard<std::mutex> lock(m_Lock);
+
+		if (m_FreeSlots.empty())
+		{
+			// Zero sized slots still get a unique address
+			const size_t slotSize = m_SlotSize > 0 ? m_SlotSize : 1;
+			std::unique_ptr<XMFLOAT4X4[]> chunk(new XMFLOAT4X4[slotSize * m_SlotsPerChunk]);
+			for (unsigned int i = m_SlotsPerChunk; i > 0; --i)
+			{
+				m_FreeSlots.push_back(chunk.get() + (i - 1) * slotSize);
+			}
+			m_Chunks.push_back(std::move(chunk));
+		}
+
+		slot = m_FreeSlots.back();
+		m_FreeSlots.pop_back();
+	}
+
+	XMFLOAT4X4 identity;
+	XMStoreFloat4x4(&identity, XMMatrixIdentity());
+	for (unsigned int i = 0; i < m_SlotSize; ++i)
+	{
+		slot[i] = identity;
+	}
+
+	return slot;
+}
+
+void PoseScratchPool::release(XMFLOAT4X4* p_Slot)
+{
+	if (p_Slot == nullptr)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(m_Lock);
+	m_FreeSlots.push_back(p_Slot);
+}
+
+unsigned int PoseScratchPool::getSlotSize() const
+{
+	return m_SlotSize;
+}
+
+unsigned int PoseScratchPool::getNumSlots()
+{
+	std::lock_guard<std::mutex> lock(m_Lock);
+	return m_Chunks.size() * m_SlotsPerChunk;
+}
+
+unsigned int PoseScratchPool::getNumFreeSlots()
+{
+	std::lock_guard<std::mutex> lock(m_Lock);
+	return m_FreeSlots.size();
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <DirectXMath.h>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * Preallocated scratch memory for the per instance pose buffers of one skeleton.
+ *
+ * Every slot holds a fixed number of matrices. Slots are allocated in chunks
+ * and handed out through a free list, so characters sharing a skeleton reuse
+ * the same memory and acquiring a slot after the first chunk is allocation free.
+ * Slots never move, a pointer stays valid until it is released.
+ */
+class PoseScratchPool
+{
+public:
+	typedef std::shared_ptr<PoseScratchPool> ptr;
+
+private:
+	unsigned int m_SlotSize;
+	unsigned int m_SlotsPerChunk;
+	std::vector<std::unique_ptr<DirectX::XMFLOAT4X4[]>> m_Chunks;
+	std::vector<DirectX::XMFLOAT4X4*> m_FreeSlots;
+	std::mutex m_Lock;
+
+public:
+	/**
+	 * Constructor.
+	 *
+	 * @param p_SlotSize the number of matrices in each slot
+	 * @param p_SlotsPerChunk the number of slots to allocate at a time
+	 */
+	PoseScratchPool(unsigned int p_SlotSize, unsigned int p_SlotsPerChunk);
+
+	/**
+	 * Take a slot from the pool, allocating a new chunk if none is free.
+	 * Thread safe.
+	 *
+	 * @return the first of getSlotSize() matrices, initialized to identity
+	 */
+	DirectX::XMFLOAT4X4* acquire();
+
+	/**
+	 * Return a slot to the pool. Thread safe.
+	 *
+	 * @param p_Slot a slot previously returned by acquire, or nullptr
+	 */
+	void release(DirectX::XMFLOAT4X4* p_Slot);
+
+	unsigned int getSlotSize() const;
+
+	/**
+	 * @return the number of slots allocated, both used and free
+	 */
+	unsigned int getNumSlots();
+
+	/**
+	 * @return the number of slots currently not in use
+	 */
+	unsigned int getNumFreeSlots();
+
+private:
+	PoseScratchPool(const PoseScratchPool&);
+	PoseScratchPool& operator=(const PoseScratchPool&);
+};
@@ -1,11 +1,84 @@
 #include "ResourceManager.h"
 #include "CommonExceptions.h"
 #include "Logger.h"
+#include <algorithm>
 #include <istream>
+#include <limits>
 
 using std::string;
 using std::vector;
 
+/**
+ * An asynchronous load of a resource, shared by every load of the same file.
+ * Everything but the name, path and entry is guarded by ResourceManager::m_AsyncLock.
+ */
+struct AsyncLoadRequest
+{
+	std::string m_Type;
+	std::string m_Name;
+	std::string m_Path;
+	const AssetArchiveFormat::Entry* m_Entry;
+	bool m_Resolved;
+	ResourceManager::PrepareFunction m_Prepare;
+	ResourceManager::FinishFunction m_Finish;
+	std::string m_Error;
+	bool m_Prepared;
+	unsigned int m_NumWaitingFor;
+	std::vector<ResourceManager::LoadedCallback> m_Callbacks;
+	std::vector<std::shared_ptr<AsyncLoadRequest>> m_Dependents;
+	std::vector<int> m_DependencyIDs;
+};
+
+ResourceDependencies::ResourceDependencies(ResourceManager* p_Manager, std::shared_ptr<AsyncLoadRequest> p_Request)
+	:	m_Manager(p_Manager),
+		m_Request(p_Request)
+{
+}
+
+void ResourceDependencies::addDependency(const std::string& p_ResourceType, const std::string& p_ResourceName)
+{
+	const AssetArchiveFormat::Entry* entry;
+	const std::string filePath = m_Manager->resolveResource(p_ResourceType, p_ResourceName, entry);
+	addDependency(p_ResourceType, p_ResourceName, filePath, entry, true);
+}
+
+void ResourceDependencies::addDependency(const std::string& p_ResourceType, const std::string& p_ResourceName,
+	const std::string& p_FilePath)
+{
+	addDependency(p_ResourceType, p_ResourceName, p_FilePath, nullptr, false);
+}
+
+void ResourceDependencies::addModelTexture(const char *p_ResourceName, const char *p_FilePath, void* p_Userdata)
+{
+	static_cast<ResourceDependencies*>(p_Userdata)->addDependency("texture", p_ResourceName, p_FilePath);
+}
+
+void ResourceDependencies::addDependency(const std::string& p_ResourceType, const std::string& p_ResourceName,
+	const std::string& p_FilePath, const AssetArchiveFormat::Entry* p_Entry, bool p_Resolved)
+{
+	std::lock_guard<std::mutex> lock(m_Manager->m_AsyncLock);
+
+	bool added;
+	std::shared_ptr<AsyncLoadRequest> dependency =
+		m_Manager->addPendingLoad(p_ResourceType, p_ResourceName, p_FilePath, p_Entry, p_Resolved, added);
+	dependency->m_Dependents.push_back(m_Request);
+	m_Request->m_NumWaitingFor++;
+
+	// The owning thread knows what is loaded, so it decides if the dependency needs loading
+	if (added)
+	{
+		m_Manager->m_NewDependencies.push_back(dependency);
+	}
+}
+
+ResourceType::ResourceType()
+	:	m_FirstUnused(nullptr),
+		m_LastUnused(nullptr),
+		m_ResidentSize(0),
+		m_Budget((std::numeric_limits<size_t>::max)())
+{
+}
+
 void ResourceType::setType(string p_Type)
 {
 	m_Type = p_Type;
@@ -17,7 +90,8 @@ const string& ResourceType::getType() const
 
 
 ResourceManager::ResourceManager()
-	: m_ReleaseImmediately(false)
+	:	m_ReleaseImmediately(false),
+		m_Loaders(new WorkerPool(0))
 {
 	m_ProjectDirectory = boost::filesystem::current_path();
 	
@@ -27,69 +101,88 @@ ResourceManager::ResourceManager()
 ResourceManager::ResourceManager(const boost::filesystem::path& p_RootPath)
 	:	m_ProjectDirectory(p_RootPath),
 		m_NextID(0),
-		m_ReleaseImmediately(false)
+		m_ReleaseImmediately(false),
+		m_Loaders(new WorkerPool(0))
 {
 }
 
 ResourceManager::~ResourceManager()
 {
+	// Loads still in progress are dropped, nothing may be prepared after this point
+	m_Loaders.reset();
+
 	for (auto& type : m_ResourceList)
 	{
-		for (auto& res : type.m_LoadedResources)
-		{
-			if (res.m_Count > 0)
-			{
-				Logger::log(Logger::Level::WARNING,
-					"Resource not released before shutdown: '" + type.getType() + ':' + res.m_Name + '\'');
-			}
-
-			type.m_Release(res.m_Name.c_str());
-		}
+		releaseAllResources(type.second, "Resource not released before shutdown: '");
 	}
 }
 
 bool ResourceManager::registerFunction(string p_Type, std::function<bool(const char*, const char*)> p_CreateFunc,
 	std::function<bool(const char*)> p_ReleaseFunc)
 {
-	for(auto &rl : m_ResourceList)
+	return registerFunction(p_Type, p_CreateFunc, nullptr, p_ReleaseFunc);
+}
+
+bool ResourceManager::registerFunction(string p_Type, std::function<bool(const char*, const char*)> p_CreateFunc,
+	std::function<bool(const char*, const char*, size_t)> p_CreateFromMemoryFunc,
+	std::function<bool(const char*)> p_ReleaseFunc)
+{
+	if (m_ResourceList.count(p_Type) > 0)
 	{
-		if(rl.getType() == p_Type)
-		{
-			return false;
-		}
+		return false;
 	}
 
-	ResourceType temp;
-	temp.setType(p_Type);
-	temp.m_Create = p_CreateFunc;
-	temp.m_Release = p_ReleaseFunc;
-	m_ResourceList.push_back(temp);
+	ResourceType& type = m_ResourceList[p_Type];
+	type.setType(p_Type);
+	type.m_Create = p_CreateFunc;
+	type.m_CreateFromMemory = p_CreateFromMemoryFunc;
+	type.m_Release = p_ReleaseFunc;
 	return true;
 }
 
-void ResourceManager::unregisterResourceType(const std::string& p_Type)
+bool ResourceManager::registerPrepareFunction(const std::string& p_Type, PrepareFunction p_PrepareFunc)
 {
-	auto it = std::find_if(m_ResourceList.begin(), m_ResourceList.end(),
-		[&] (const ResourceType& p_ListType)
-		{
-			return p_ListType.getType() == p_Type;
-		});
+	ResourceType* type = findType(p_Type);
+	if (!type)
+	{
+		return false;
+	}
 
-	if (it != m_ResourceList.end())
+	type->m_Prepare = p_PrepareFunc;
+	return true;
+}
+
+bool ResourceManager::registerSizeFunction(const std::string& p_Type, std::function<size_t(const char*, const char*)> p_SizeFunc)
+{
+	ResourceType* type = findType(p_Type);
+	if (!type)
 	{
-		for (auto& res : it->m_LoadedResources)
-		{
-			if (res.m_Count > 0)
-			{
-				Logger::log(Logger::Level::WARNING,
-					"Resource not released before unregistering resource type: '" + it->getType() + ':' + res.m_Name + '\'');
-			}
+		return false;
+	}
 
-			it->m_Release(res.m_Name.c_str());
-		}
+	type->m_GetSize = p_SizeFunc;
+	return true;
+}
 
+void ResourceManager::unregisterResourceType(const std::string& p_Type)
+{
+	auto it = m_ResourceList.find(p_Type);
+	if (it != m_ResourceList.end())
+	{
+		releaseAllResources(it->second, "Resource not released before unregistering resource type: '");
 		m_ResourceList.erase(it);
 	}
+
+	// Prepared loads of the type will never be finished, drop what they prepared
+	// while the subsystem that prepared it still exists
+	std::lock_guard<std::mutex> lock(m_AsyncLock);
+	for (auto& pending : m_PendingLoads)
+	{
+		if (pending.first.first == p_Type)
+		{
+			pending.second->m_Finish = nullptr;
+		}
+	}
 }
 
 void ResourceManager::loadDataFromFile(std::string p_FilePath)
@@ -102,115 +195,249 @@ void ResourceManager::loadDataFromFile(std::string p_FilePath)
 	m_ResourceTranslator.loadResourceList(file);
 }
 
-int ResourceManager::loadResource(string p_ResourceType, string p_ResourceName)
+void ResourceManager::loadArchive(const std::string& p_FilePath)
 {
-	boost::filesystem::path filePath(m_ProjectDirectory / m_ResourceTranslator.translate(p_ResourceType, p_ResourceName));
+	if (!m_Archive.open(p_FilePath))
+	{
+		throw ResourceManagerException("Load asset archive failed: " + p_FilePath, __LINE__, __FILE__);
+	}
+}
 
-	for(auto &rl : m_ResourceList)
+std::string ResourceManager::resolveResource(const std::string& p_ResourceType, const std::string& p_ResourceName,
+	const AssetArchiveFormat::Entry*& p_Entry)
+{
+	p_Entry = m_Archive.find(p_ResourceType, p_ResourceName);
+	if (p_Entry)
 	{
-		if(rl.getType() == p_ResourceType)
-		{
+		return (m_ProjectDirectory / m_Archive.getPath(*p_Entry)).string();
+	}
 
-			for(auto &r : rl.m_LoadedResources)
-			{
-				if(filePath.string() == r.m_Path)
-				{
-					r.m_Count++;
+	return (m_ProjectDirectory / m_ResourceTranslator.translate(p_ResourceType, p_ResourceName)).string();
+}
 
-					return r.m_ID;
-				}
-			}
+std::string ResourceManager::getResourcePath(const std::string& p_ResourceType, const std::string& p_ResourceName)
+{
+	const AssetArchiveFormat::Entry* entry;
+	return resolveResource(p_ResourceType, p_ResourceName, entry);
+}
 
-			if( rl.m_Create(p_ResourceName.c_str(), filePath.string().c_str()) )
-			{
-				ResourceType::Resource newRes;
-				newRes.m_Name = p_ResourceName;
-				newRes.m_ID = m_NextID++;
-				newRes.m_Count = 1;
-				newRes.m_Path = filePath.string().c_str();
-				
-				rl.m_LoadedResources.push_back(newRes);
-				return newRes.m_ID;
-			}
-			else
-			{
-				throw ResourceManagerException("Error when loading resource: '" + p_ResourceType + ":" + p_ResourceName + "' (" + filePath.string() + ")", __LINE__, __FILE__);
-			}
+bool ResourceManager::isArchived(const std::string& p_ResourceType, const std::string& p_ResourceName) const
+{
+	return m_Archive.find(p_ResourceType, p_ResourceName) != nullptr;
+}
+
+int ResourceManager::loadResource(string p_ResourceType, string p_ResourceName)
+{
+	ResourceType* type = findType(p_ResourceType);
+	if (type)
+	{
+		ResourceType::Resource* named = findNamed(*type, p_ResourceName);
+		if (named)
+		{
+			addReferences(*named, 1);
+			return named->m_ID;
 		}
 	}
+
+	const AssetArchiveFormat::Entry* entry;
+	const std::string filePath = resolveResource(p_ResourceType, p_ResourceName, entry);
+
+	if (!type)
+	{
 #ifdef DEBUG
-	throw ResourceManagerException(std::string("Error when loading resource! create function for ") + p_ResourceType + "s not registered!", __LINE__, __FILE__);
+		throw ResourceManagerException(std::string("Error when loading resource! create function for ") + p_ResourceType + "s not registered!", __LINE__, __FILE__);
 #endif
+		return -1;
+	}
 
-	return -1;
+	ResourceType::Resource* loaded = findLoaded(*type, filePath);
+	if (loaded)
+	{
+		addReferences(*loaded, 1);
+		return loaded->m_ID;
+	}
+
+	const bool created = entry && type->m_CreateFromMemory
+		? type->m_CreateFromMemory(p_ResourceName.c_str(), m_Archive.getData(*entry), static_cast<size_t>(entry->m_DataSize))
+		: type->m_Create(p_ResourceName.c_str(), filePath.c_str());
+	if (!created)
+	{
+		throw ResourceManagerException("Error when loading resource: '" + p_ResourceType + ":" + p_ResourceName + "' (" + filePath + ")", __LINE__, __FILE__);
+	}
+
+	ResourceType::Resource& newRes = addResource(*type, p_ResourceName, filePath, entry, true);
+	newRes.m_Count = 1;
+	return newRes.m_ID;
 }
 
-void  ResourceManager::loadModelTexture(const char *p_ResourceName, const char *p_FilePath, void* p_Userdata)
+void ResourceManager::loadResourceAsync(const std::string& p_ResourceType, const std::string& p_ResourceName,
+	LoadedCallback p_Loaded)
 {
-	((ResourceManager*)p_Userdata)->loadModelTextureImpl(p_ResourceName, p_FilePath);
+	ResourceType* type = findType(p_ResourceType);
+	if (type)
+	{
+		ResourceType::Resource* named = findNamed(*type, p_ResourceName);
+		if (named)
+		{
+			addReferences(*named, 1);
+			p_Loaded(named->m_ID);
+			return;
+		}
+	}
+
+	const AssetArchiveFormat::Entry* entry;
+	const std::string filePath = resolveResource(p_ResourceType, p_ResourceName, entry);
+
+	if (!type)
+	{
+#ifdef DEBUG
+		throw ResourceManagerException(std::string("Error when loading resource! create function for ") + p_ResourceType + "s not registered!", __LINE__, __FILE__);
+#endif
+		p_Loaded(-1);
+		return;
+	}
+
+	ResourceType::Resource* loaded = findLoaded(*type, filePath);
+	if (loaded)
+	{
+		addReferences(*loaded, 1);
+		p_Loaded(loaded->m_ID);
+		return;
+	}
+
+	bool added;
+	std::shared_ptr<AsyncLoadRequest> request;
+	{
+		std::lock_guard<std::mutex> lock(m_AsyncLock);
+		request = addPendingLoad(p_ResourceType, p_ResourceName, filePath, entry, true, added);
+		request->m_Callbacks.push_back(p_Loaded);
+	}
+
+	if (added)
+	{
+		startLoad(request);
+	}
 }
 
-int ResourceManager::loadModelTextureImpl(const char *p_ResourceName, const char *p_FilePath)
+void ResourceManager::finishAsyncLoads()
 {
-	for(auto &rl : m_ResourceList)
+	// Without loader threads everything is prepared here, including the
+	// dependencies found while preparing, so keep going until nothing is left
+	const bool prepareHere = m_Loaders->getNumThreads() == 0;
+	do
 	{
-		if(rl.getType() == "texture")
+		if (prepareHere)
 		{
+			m_Loaders->runQueued();
+		}
 
-			for(auto &r : rl.m_LoadedResources)
-			{
-				if(p_FilePath == r.m_Path)
-				{
-					r.m_Count++;
+		std::vector<std::shared_ptr<AsyncLoadRequest>> newDependencies;
+		std::vector<std::shared_ptr<AsyncLoadRequest>> prepared;
+		{
+			std::lock_guard<std::mutex> lock(m_AsyncLock);
+			newDependencies.swap(m_NewDependencies);
+			prepared.swap(m_PreparedLoads);
+		}
 
-					return r.m_ID;
-				}
-			}
+		if (newDependencies.empty() && prepared.empty())
+		{
+			break;
+		}
 
-			if( rl.m_Create(p_ResourceName, p_FilePath) )
+		for (auto& dependency : newDependencies)
+		{
+			ResourceType* type = findType(dependency->m_Type);
+			if (type && findLoaded(*type, dependency->m_Path))
 			{
-				ResourceType::Resource newRes;
-				newRes.m_Name = p_ResourceName;
-				newRes.m_ID = m_NextID++;
-				newRes.m_Count = 1;
-				newRes.m_Path = p_FilePath;
-				
-				rl.m_LoadedResources.push_back(newRes);
-				return newRes.m_ID;
+				finishLoad(dependency);
 			}
 			else
 			{
-				throw ResourceManagerException(std::string("Error when loading model texture resource: ") + p_FilePath + " (" + p_ResourceName + ")", __LINE__, __FILE__);
+				startLoad(dependency);
 			}
 		}
+
+		for (auto& request : prepared)
+		{
+			bool ready;
+			{
+				std::lock_guard<std::mutex> lock(m_AsyncLock);
+				request->m_Prepared = true;
+				ready = request->m_NumWaitingFor == 0;
+			}
+
+			if (ready)
+			{
+				finishLoad(request);
+			}
+		}
+	} while (prepareHere);
+}
+
+unsigned int ResourceManager::getNumPendingLoads()
+{
+	std::lock_guard<std::mutex> lock(m_AsyncLock);
+	return m_PendingLoads.size();
+}
+
+void ResourceManager::setLoaderThreads(unsigned int p_NumThreads)
+{
+	m_Loaders.reset();
+	m_Loaders.reset(new WorkerPool(p_NumThreads));
+}
+
+bool ResourceManager::acquireResource(int p_ID)
+{
+	auto it = m_ResourceIDs.find(p_ID);
+	if (it == m_ResourceIDs.end())
+	{
+		return false;
 	}
-#ifdef DEBUG
-	throw ResourceManagerException(std::string("Error when loading model texture ") + p_FilePath + " (" + p_ResourceName + "). create function for textures not registered!", __LINE__, __FILE__);
-#endif
-	return -1;
+
+	addReferences(*it->second, 1);
+	return true;
 }
 
-bool ResourceManager::releaseResource(int p_ID)
+void  ResourceManager::loadModelTexture(const char *p_ResourceName, const char *p_FilePath, void* p_Userdata)
 {
-	for(auto &rl : m_ResourceList)
+	((ResourceManager*)p_Userdata)->loadModelTextureImpl(p_ResourceName, p_FilePath);
+}
+
+int ResourceManager::loadModelTextureImpl(const char *p_ResourceName, const char *p_FilePath)
+{
+	ResourceType* type = findType("texture");
+	if (!type)
 	{
-		for(auto it = rl.m_LoadedResources.begin(); it != rl.m_LoadedResources.end(); ++it)
-		{
-			auto& r = *it;
+#ifdef DEBUG
+		throw ResourceManagerException(std::string("Error when loading model texture ") + p_FilePath + " (" + p_ResourceName + "). create function for textures not registered!", __LINE__, __FILE__);
+#endif
+		return -1;
+	}
 
-			if(r.m_ID == p_ID)
-			{
-				r.m_Count--;
+	ResourceType::Resource* loaded = findLoaded(*type, p_FilePath);
+	if (loaded)
+	{
+		addReferences(*loaded, 1);
+		return loaded->m_ID;
+	}
 
-				if (r.m_Count <= 0 && m_ReleaseImmediately)
-				{
-					rl.m_Release(r.m_Name.c_str());
-					rl.m_LoadedResources.erase(it);
-				}
+	if (!type->m_Create(p_ResourceName, p_FilePath))
+	{
+		throw ResourceManagerException(std::string("Error when loading model texture resource: ") + p_FilePath + " (" + p_ResourceName + ")", __LINE__, __FILE__);
+	}
 
-				return true;
-			}
-		}
+	ResourceType::Resource& newRes = addResource(*type, p_ResourceName, p_FilePath, nullptr, false);
+	newRes.m_Count = 1;
+	return newRes.m_ID;
+}
+
+bool ResourceManager::releaseResource(int p_ID)
+{
+	auto it = m_ResourceIDs.find(p_ID);
+	if (it != m_ResourceIDs.end())
+	{
+		removeReference(*it->second);
+		return true;
 	}
 
 #ifdef DEBUG
@@ -221,23 +448,20 @@ bool ResourceManager::releaseResource(int p_ID)
 
 void ResourceManager::releaseUnusedResources()
 {
-	for (auto& resType : m_ResourceList)
+	// Releasing a resource can make others unused, possibly of a type already visited
+	bool released;
+	do
 	{
-		auto& resources = resType.m_LoadedResources;
-
-		const auto partitionPoint = std::partition(resources.begin(), resources.end(),
-			[] (const ResourceType::Resource& p_Res)
-			{
-				return p_Res.m_Count > 0;
-			});
-
-		for (auto it = partitionPoint; it != resources.end(); ++it)
+		released = false;
+		for (auto& type : m_ResourceList)
 		{
-			resType.m_Release(it->m_Name.c_str());
+			while (type.second.m_FirstUnused)
+			{
+				destroyResource(*type.second.m_FirstUnused);
+				released = true;
+			}
 		}
-
-		resources.erase(partitionPoint, resources.end());
-	}
+	} while (released);
 }
 
 void ResourceManager::setReleaseImmediately(bool p_Release)
@@ -250,37 +474,442 @@ void ResourceManager::setReleaseImmediately(bool p_Release)
 	m_ReleaseImmediately = p_Release;
 }
 
+bool ResourceManager::setResourceBudget(const std::string& p_Type, size_t p_Budget)
+{
+	ResourceType* type = findType(p_Type);
+	if (!type)
+	{
+		return false;
+	}
+
+	type->m_Budget = p_Budget;
+	releaseOverBudget(*type);
+	return true;
+}
+
+size_t ResourceManager::getResourceBudget(const std::string& p_Type) const
+{
+	auto it = m_ResourceList.find(p_Type);
+	return it != m_ResourceList.end() ? it->second.m_Budget : 0;
+}
+
+size_t ResourceManager::getResidentSize(const std::string& p_Type) const
+{
+	auto it = m_ResourceList.find(p_Type);
+	return it != m_ResourceList.end() ? it->second.m_ResidentSize : 0;
+}
+
+std::vector<int> ResourceManager::getEvictionOrder(const std::string& p_Type) const
+{
+	std::vector<int> order;
+	auto it = m_ResourceList.find(p_Type);
+	if (it != m_ResourceList.end())
+	{
+		for (const ResourceType::Resource* res = it->second.m_FirstUnused; res; res = res->m_NextUnused)
+		{
+			order.push_back(res->m_ID);
+		}
+	}
+
+	return order;
+}
+
 void ResourceManager::releaseModelTexture(const char *p_ResourceName, void *p_Userdata)
 {
 	((ResourceManager*)p_Userdata)->releaseModelTextureImpl(p_ResourceName);
 }
 
-const std::vector<ResourceType> ResourceManager::getResourceList()
+const std::unordered_map<std::string, ResourceType>& ResourceManager::getResourceList() const
 {
 	return m_ResourceList;
 }
 
 void ResourceManager::releaseModelTextureImpl(const char *p_ResourceName)
 {
-	for(auto &rl : m_ResourceList)
+	for (auto& type : m_ResourceList)
+	{
+		// The first loaded resource with the name is the one released
+		ResourceType::Resource* first = nullptr;
+		const auto range = type.second.m_Names.equal_range(p_ResourceName);
+		for (auto it = range.first; it != range.second; ++it)
+		{
+			if (!first || it->second->m_ID < first->m_ID)
+			{
+				first = it->second;
+			}
+		}
+
+		if (first)
+		{
+			removeReference(*first);
+		}
+	}
+}
+
+ResourceType* ResourceManager::findType(const std::string& p_Type)
+{
+	auto it = m_ResourceList.find(p_Type);
+	return it != m_ResourceList.end() ? &it->second : nullptr;
+}
+
+ResourceType::Resource* ResourceManager::findLoaded(ResourceType& p_Type, const std::string& p_FilePath)
+{
+	auto it = p_Type.m_LoadedResources.find(p_FilePath);
+	return it != p_Type.m_LoadedResources.end() ? &it->second : nullptr;
+}
+
+ResourceType::Resource* ResourceManager::findNamed(ResourceType& p_Type, const std::string& p_ResourceName)
+{
+	const auto range = p_Type.m_Names.equal_range(p_ResourceName);
+	for (auto it = range.first; it != range.second; ++it)
+	{
+		if (it->second->m_Resolved)
+		{
+			return it->second;
+		}
+	}
+
+	return nullptr;
+}
+
+ResourceType::Resource& ResourceManager::addResource(ResourceType& p_Type, const std::string& p_ResourceName,
+	const std::string& p_FilePath, const AssetArchiveFormat::Entry* p_Entry, bool p_Resolved)
+{
+	size_t size = 0;
+	if (p_Type.m_GetSize)
+	{
+		size = p_Type.m_GetSize(p_ResourceName.c_str(), p_FilePath.c_str());
+	}
+	else if (p_Entry)
+	{
+		size = static_cast<size_t>(p_Entry->m_DataSize);
+	}
+	else
+	{
+		boost::system::error_code error;
+		const uintmax_t fileSize = boost::filesystem::file_size(p_FilePath, error);
+		size = error ? 0 : static_cast<size_t>(fileSize);
+	}
+
+	ResourceType::Resource& res = p_Type.m_LoadedResources[p_FilePath];
+	res.m_ID = m_NextID++;
+	res.m_Name = p_ResourceName;
+	res.m_Path = p_FilePath;
+	res.m_Count = 0;
+	res.m_Size = size;
+	res.m_Resolved = p_Resolved;
+	res.m_Type = &p_Type;
+	res.m_PrevUnused = nullptr;
+	res.m_NextUnused = nullptr;
+
+	p_Type.m_Names.insert(std::make_pair(p_ResourceName, &res));
+	m_ResourceIDs[res.m_ID] = &res;
+
+	// The new resource is not unused yet, so it is never the one released
+	p_Type.m_ResidentSize += size;
+	releaseOverBudget(p_Type);
+
+	return res;
+}
+
+void ResourceManager::addReferences(ResourceType::Resource& p_Resource, int p_Count)
+{
+	unlinkUnused(p_Resource);
+	p_Resource.m_Count += p_Count;
+}
+
+void ResourceManager::removeReference(ResourceType::Resource& p_Resource)
+{
+	p_Resource.m_Count--;
+
+	if (p_Resource.m_Count <= 0)
+	{
+		if (m_ReleaseImmediately)
+		{
+			destroyResource(p_Resource);
+		}
+		else
+		{
+			linkUnused(p_Resource);
+			releaseOverBudget(*p_Resource.m_Type);
+		}
+	}
+}
+
+void ResourceManager::releaseOverBudget(ResourceType& p_Type)
+{
+	while (p_Type.m_ResidentSize > p_Type.m_Budget && p_Type.m_FirstUnused)
+	{
+		destroyResource(*p_Type.m_FirstUnused);
+	}
+}
+
+void ResourceManager::destroyResource(ResourceType::Resource& p_Resource)
+{
+	unlinkUnused(p_Resource);
+	m_ResourceIDs.erase(p_Resource.m_ID);
+
+	ResourceType& type = *p_Resource.m_Type;
+	type.m_ResidentSize -= p_Resource.m_Size;
+	const auto range = type.m_Names.equal_range(p_Resource.m_Name);
+	for (auto it = range.first; it != range.second; ++it)
+	{
+		if (it->second == &p_Resource)
+		{
+			type.m_Names.erase(it);
+			break;
+		}
+	}
+
+	// The release function may load or release other resources, so the tables are updated first
+	const std::string name = p_Resource.m_Name;
+	const std::string path = p_Resource.m_Path;
+	type.m_LoadedResources.erase(path);
+	type.m_Release(name.c_str());
+}
+
+void ResourceManager::releaseAllResources(ResourceType& p_Type, const std::string& p_Warning)
+{
+	std::unordered_map<std::string, ResourceType::Resource> resources;
+	resources.swap(p_Type.m_LoadedResources);
+	p_Type.m_Names.clear();
+	p_Type.m_FirstUnused = nullptr;
+	p_Type.m_LastUnused = nullptr;
+	p_Type.m_ResidentSize = 0;
+
+	// Released in the order they were loaded
+	std::vector<ResourceType::Resource*> ordered;
+	ordered.reserve(resources.size());
+	for (auto& res : resources)
+	{
+		m_ResourceIDs.erase(res.second.m_ID);
+		ordered.push_back(&res.second);
+	}
+	std::sort(ordered.begin(), ordered.end(),
+		[] (const ResourceType::Resource* p_Left, const ResourceType::Resource* p_Right)
+		{
+			return p_Left->m_ID < p_Right->m_ID;
+		});
+
+	for (auto res : ordered)
+	{
+		if (res->m_Count > 0)
+		{
+			Logger::log(Logger::Level::WARNING, p_Warning + p_Type.getType() + ':' + res->m_Name + '\'');
+		}
+
+		p_Type.m_Release(res->m_Name.c_str());
+	}
+}
+
+void ResourceManager::linkUnused(ResourceType::Resource& p_Resource)
+{
+	ResourceType& type = *p_Resource.m_Type;
+	if (p_Resource.m_PrevUnused || type.m_FirstUnused == &p_Resource)
+	{
+		return;
+	}
+
+	p_Resource.m_PrevUnused = type.m_LastUnused;
+	p_Resource.m_NextUnused = nullptr;
+	if (type.m_LastUnused)
+	{
+		type.m_LastUnused->m_NextUnused = &p_Resource;
+	}
+	else
+	{
+		type.m_FirstUnused = &p_Resource;
+	}
+	type.m_LastUnused = &p_Resource;
+}
+
+void ResourceManager::unlinkUnused(ResourceType::Resource& p_Resource)
+{
+	ResourceType& type = *p_Resource.m_Type;
+	if (!p_Resource.m_PrevUnused && type.m_FirstUnused != &p_Resource)
+	{
+		return;
+	}
+
+	if (p_Resource.m_PrevUnused)
+	{
+		p_Resource.m_PrevUnused->m_NextUnused = p_Resource.m_NextUnused;
+	}
+	else
+	{
+		type.m_FirstUnused = p_Resource.m_NextUnused;
+	}
+	if (p_Resource.m_NextUnused)
+	{
+		p_Resource.m_NextUnused->m_PrevUnused = p_Resource.m_PrevUnused;
+	}
+	else
+	{
+		type.m_LastUnused = p_Resource.m_PrevUnused;
+	}
+
+	p_Resource.m_PrevUnused = nullptr;
+	p_Resource.m_NextUnused = nullptr;
+}
+
+std::shared_ptr<AsyncLoadRequest> ResourceManager::addPendingLoad(const std::string& p_ResourceType,
+	const std::string& p_ResourceName, const std::string& p_FilePath, const AssetArchiveFormat::Entry* p_Entry, bool p_Resolved,
+	bool& p_Added)
+{
+	std::shared_ptr<AsyncLoadRequest>& request = m_PendingLoads[std::make_pair(p_ResourceType, p_FilePath)];
+	p_Added = !request;
+	if (p_Added)
+	{
+		request.reset(new AsyncLoadRequest);
+		request->m_Type = p_ResourceType;
+		request->m_Name = p_ResourceName;
+		request->m_Path = p_FilePath;
+		request->m_Entry = p_Entry;
+		request->m_Resolved = p_Resolved;
+		request->m_Prepared = false;
+		request->m_NumWaitingFor = 0;
+	}
+
+	return request;
+}
+
+void ResourceManager::startLoad(std::shared_ptr<AsyncLoadRequest> p_Request)
+{
+	// Archived resources are already in memory, they have nothing to prepare
+	ResourceType* type = findType(p_Request->m_Type);
+	if (type && !(p_Request->m_Entry && type->m_CreateFromMemory))
 	{
-		for(auto it = rl.m_LoadedResources.begin(); it != rl.m_LoadedResources.end(); ++it)
+		p_Request->m_Prepare = type->m_Prepare;
+	}
+
+	if (!p_Request->m_Prepare)
+	{
+		std::lock_guard<std::mutex> lock(m_AsyncLock);
+		m_PreparedLoads.push_back(p_Request);
+		return;
+	}
+
+	m_Loaders->push([this, p_Request] () { prepareLoad(p_Request); });
+}
+
+void ResourceManager::prepareLoad(std::shared_ptr<AsyncLoadRequest> p_Request)
+{
+	FinishFunction finish;
+	std::string error;
+	try
+	{
+		ResourceDependencies dependencies(this, p_Request);
+		finish = p_Request->m_Prepare(p_Request->m_Name.c_str(), p_Request->m_Path.c_str(), dependencies);
+		if (!finish)
 		{
-			auto& r = *it;
+			error = "Nothing to finish";
+		}
+	}
+	catch (std::exception& err)
+	{
+		error = err.what();
+	}
+
+	std::lock_guard<std::mutex> lock(m_AsyncLock);
+	p_Request->m_Finish = finish;
+	p_Request->m_Error = error;
+	m_PreparedLoads.push_back(p_Request);
+}
 
-			if(strcmp(r.m_Name.c_str(), p_ResourceName) == 0)
+void ResourceManager::finishLoad(std::shared_ptr<AsyncLoadRequest> p_Request)
+{
+	int id = -1;
+	std::string error = p_Request->m_Error;
+
+	ResourceType* type = findType(p_Request->m_Type);
+	if (!type)
+	{
+		error = "Resource type not registered";
+	}
+	else if (ResourceType::Resource* loaded = findLoaded(*type, p_Request->m_Path))
+	{
+		id = loaded->m_ID;
+	}
+	else if (error.empty())
+	{
+		bool created = false;
+		try
+		{
+			if (p_Request->m_Finish)
 			{
-				r.m_Count--;
+				created = p_Request->m_Finish();
+			}
+			else if (p_Request->m_Entry && type->m_CreateFromMemory)
+			{
+				created = type->m_CreateFromMemory(p_Request->m_Name.c_str(), m_Archive.getData(*p_Request->m_Entry),
+					static_cast<size_t>(p_Request->m_Entry->m_DataSize));
+			}
+			else
+			{
+				created = type->m_Create(p_Request->m_Name.c_str(), p_Request->m_Path.c_str());
+			}
+		}
+		catch (std::exception& err)
+		{
+			error = err.what();
+		}
 
-				if (r.m_Count <= 0 && m_ReleaseImmediately)
-				{
-					rl.m_Release(r.m_Name.c_str());
-					rl.m_LoadedResources.erase(it);
-				}
+		if (created)
+		{
+			id = addResource(*type, p_Request->m_Name, p_Request->m_Path, p_Request->m_Entry, p_Request->m_Resolved).m_ID;
+		}
+	}
 
-				break;
+	// Whatever the finish step did not use, because the load failed or the resource
+	// was already loaded, is released with it instead of with the request
+	p_Request->m_Finish = nullptr;
+
+	std::vector<LoadedCallback> callbacks;
+	std::vector<std::shared_ptr<AsyncLoadRequest>> dependents;
+	{
+		std::lock_guard<std::mutex> lock(m_AsyncLock);
+		m_PendingLoads.erase(std::make_pair(p_Request->m_Type, p_Request->m_Path));
+		callbacks.swap(p_Request->m_Callbacks);
+		dependents.swap(p_Request->m_Dependents);
+	}
+
+	// Every caller gets its own reference, and every dependent keeps one until it is finished
+	if (id >= 0)
+	{
+		addReferences(*findLoaded(*type, p_Request->m_Path), callbacks.size() + dependents.size());
+	}
+	else
+	{
+		Logger::log(Logger::Level::ERROR_L, "Error when loading resource: '" + p_Request->m_Type + ':' + p_Request->m_Name +
+			"' (" + p_Request->m_Path + ")" + (error.empty() ? "" : ": " + error));
+	}
+
+	for (auto& callback : callbacks)
+	{
+		callback(id);
+	}
+
+	for (auto& dependent : dependents)
+	{
+		bool ready;
+		{
+			std::lock_guard<std::mutex> lock(m_AsyncLock);
+			if (id >= 0)
+			{
+				dependent->m_DependencyIDs.push_back(id);
 			}
+			dependent->m_NumWaitingFor--;
+			ready = dependent->m_Prepared && dependent->m_NumWaitingFor == 0;
+		}
+
+		if (ready)
+		{
+			finishLoad(dependent);
 		}
 	}
-}
 
+	for (int dependencyID : p_Request->m_DependencyIDs)
+	{
+		releaseResource(dependencyID);
+	}
+}
@@ -1,10 +1,20 @@
 #pragma once
+#include "AssetArchive.h"
 #include "ResourceTranslator.h"
+#include "WorkerPool.h"
 
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 #include <string>
 #include <boost/filesystem.hpp>
 
+class ResourceDependencies;
+class ResourceManager;
+struct AsyncLoadRequest;
+
 class ResourceType
 {
 public:
@@ -14,15 +24,61 @@ public:
 		std::string m_Name;
 		std::string m_Path;
 		int m_Count;
+		/**
+		 * The size counted against the budget of the type.
+		 */
+		size_t m_Size;
+		/**
+		 * True if the path was resolved from the name, so that the name alone finds the resource.
+		 */
+		bool m_Resolved;
+		ResourceType* m_Type;
+		/**
+		 * Links in the type's list of unused resources, least recently used first. Null while in use.
+		 */
+		Resource* m_PrevUnused;
+		Resource* m_NextUnused;
 	};
 
-	std::vector<Resource> m_LoadedResources;
+	/**
+	 * The loaded resources keyed by path. A resource keeps its address while it is loaded.
+	 */
+	std::unordered_map<std::string, Resource> m_LoadedResources;
+	/**
+	 * The loaded resources keyed by the name they were loaded with.
+	 */
+	std::unordered_multimap<std::string, Resource*> m_Names;
+
+	Resource* m_FirstUnused;
+	Resource* m_LastUnused;
+	/**
+	 * The total size of the loaded resources, used or not.
+	 */
+	size_t m_ResidentSize;
+	/**
+	 * Unused resources are released, least recently used first, while the resident size is over the budget.
+	 */
+	size_t m_Budget;
 	
 	std::function<bool(const char*, const char*)> m_Create;
+	/**
+	 * Optional, creates a resource from its contents in an asset archive.
+	 */
+	std::function<bool(const char*, const char*, size_t)> m_CreateFromMemory;
+	/**
+	 * Optional, prepares a resource on a loader thread for loadResourceAsync.
+	 */
+	std::function<std::function<bool()>(const char*, const char*, ResourceDependencies&)> m_Prepare;
 	std::function<bool(const char*)> m_Release;
+	/**
+	 * Optional, the size of a loaded resource given its name and path. Defaults to the size of the file.
+	 */
+	std::function<size_t(const char*, const char*)> m_GetSize;
 private:
 	std::string m_Type;
 public:
+	ResourceType();
+
 	/**
 	 * Set resource type.
 	 * @param p_Type type to be set
@@ -39,16 +95,81 @@ public:
 };
 
 
+/**
+ * Given to a prepare function, used to load the resources a resource depends on.
+ *
+ * A dependency starts loading at once, in parallel with the rest of the
+ * prepare function. The finish step of the depending resource is not run
+ * until the finish steps of all its dependencies have been run, and the
+ * dependencies are kept loaded until then. Dependencies must not be cyclic.
+ */
+class ResourceDependencies
+{
+private:
+	friend class ResourceManager;
+
+	ResourceManager* m_Manager;
+	std::shared_ptr<AsyncLoadRequest> m_Request;
+
+	ResourceDependencies(ResourceManager* p_Manager, std::shared_ptr<AsyncLoadRequest> p_Request);
+	void addDependency(const std::string& p_ResourceType, const std::string& p_ResourceName,
+		const std::string& p_FilePath, const AssetArchiveFormat::Entry* p_Entry, bool p_Resolved);
+
+public:
+	/**
+	 * Load a resource found through the resource list or the archive.
+	 * @throws ResourceManagerException if the resource can not be found
+	 */
+	void addDependency(const std::string& p_ResourceType, const std::string& p_ResourceName);
+
+	/**
+	 * Load a resource from a known file, like loadModelTextureImpl does.
+	 */
+	void addDependency(const std::string& p_ResourceType, const std::string& p_ResourceName, const std::string& p_FilePath);
+
+	/**
+	 * Adds a texture dependency, like loadModelTexture, should only be used as callback.
+	 * @param p_Userdata the ResourceDependencies of the model being prepared
+	 */
+	static void addModelTexture(const char *p_ResourceName, const char *p_FilePath, void* p_Userdata);
+};
+
 class ResourceManager
 {
 public:
+	/**
+	 * The work left for the owning thread after a resource has been prepared,
+	 * returns true if the resource was created.
+	 */
+	typedef std::function<bool()> FinishFunction;
+
+	/**
+	 * Prepares a resource on a loader thread. Called with the name and the
+	 * complete path of the resource, returns the finish step or throws on failure.
+	 */
+	typedef std::function<FinishFunction(const char*, const char*, ResourceDependencies&)> PrepareFunction;
+
+	/**
+	 * Called on the owning thread when an asynchronous load is done, with the
+	 * ID of the resource or -1 if it failed.
+	 */
+	typedef std::function<void(int)> LoadedCallback;
+
 protected:
 	unsigned int m_NextID;
-	std::vector<ResourceType> m_ResourceList;
+	std::unordered_map<std::string, ResourceType> m_ResourceList;
+	std::unordered_map<int, ResourceType::Resource*> m_ResourceIDs;
 	ResourceTranslator m_ResourceTranslator;
+	AssetArchive m_Archive;
 	boost::filesystem::path m_ProjectDirectory;
 	bool m_ReleaseImmediately;
 
+	std::unique_ptr<WorkerPool> m_Loaders;
+	std::mutex m_AsyncLock;
+	std::map<std::pair<std::string, std::string>, std::shared_ptr<AsyncLoadRequest>> m_PendingLoads;
+	std::vector<std::shared_ptr<AsyncLoadRequest>> m_NewDependencies;
+	std::vector<std::shared_ptr<AsyncLoadRequest>> m_PreparedLoads;
+
 public:
 	ResourceManager();
 	ResourceManager(const boost::filesystem::path& p_RootPath);
@@ -64,7 +185,43 @@ public:
 	 */
 	bool registerFunction(std::string p_Type, std::function<bool(const char*, const char*)> p_CreateFunc,
 		std::function<bool(const char*)> p_ReleaseFunc);
+
+	/**
+	 * Registers a new resource type that can also be created from memory.
+	 *
+	 * Resources found in a loaded asset archive are created with p_CreateFromMemoryFunc,
+	 * which is given the name, the contents and the size of the resource. The contents
+	 * are only valid during the call. Other resources are created with p_CreateFunc.
+	 *
+	 * @return true if new type is added, false if the type already exists
+	 */
+	bool registerFunction(std::string p_Type, std::function<bool(const char*, const char*)> p_CreateFunc,
+		std::function<bool(const char*, const char*, size_t)> p_CreateFromMemoryFunc,
+		std::function<bool(const char*)> p_ReleaseFunc);
 	
+	/**
+	 * Makes a registered type prepare its resources on a loader thread when
+	 * loaded with loadResourceAsync.
+	 *
+	 * The prepare function does the parsing and file reading and must be safe to
+	 * call from any thread. The finish function it returns is run on the owning
+	 * thread, and should only do what must be done there, like uploading to the GPU.
+	 * Types without a prepare function are created entirely on the owning thread.
+	 *
+	 * @return true if the prepare function was set, false if the type is not registered
+	 */
+	bool registerPrepareFunction(const std::string& p_Type, PrepareFunction p_PrepareFunc);
+
+	/**
+	 * Sets how the size of the resources of a type is measured for its budget,
+	 * such as the memory used by a texture. Without a size function the size
+	 * of the file, or the archive entry, is used.
+	 *
+	 * @param p_SizeFunc called with the name and the path of a created resource
+	 * @return true if the size function was set, false if the type is not registered
+	 */
+	bool registerSizeFunction(const std::string& p_Type, std::function<size_t(const char*, const char*)> p_SizeFunc);
+
 	/**
 	 * Unregisters a registered type with associated create and release functions.
 	 *
@@ -81,6 +238,24 @@ public:
 	 */
 	void loadDataFromFile(std::string p_FilePath);
 
+	/**
+	 * Load an asset archive built from a resource list by Binary Converter.
+	 *
+	 * Resources in the archive are found by a hash lookup and read from the
+	 * mapped archive instead of being opened one file at a time. Resources that
+	 * are not in the archive are still resolved through the resource list.
+	 * The archive stays mapped for the lifetime of the resource manager.
+	 *
+	 * Only types registered with a create from memory function are read from
+	 * the archive, currently textures, volumes and sounds. Models, particle
+	 * systems and animations find their textures, material bundles and clip
+	 * files relative to their own path, so archived entries of those types are
+	 * still created from the path they were archived from.
+	 *
+	 * @param p_FilePath the path to the .hpak archive
+	 */
+	void loadArchive(const std::string& p_FilePath);
+
 	/**
 	 * Loads a resource.
 	 * @param p_ResourceType type of resource
@@ -89,6 +264,62 @@ public:
 	 */
 	int loadResource(std::string p_ResourceType, std::string p_ResourceName);
 	
+	/**
+	 * Loads a resource without blocking the calling thread.
+	 *
+	 * The resource is prepared by the loader threads and then finished by
+	 * finishAsyncLoads on the calling thread. The ID is passed to p_Loaded when
+	 * the load is done, and each call adds a reference like loadResource does.
+	 * If the resource is already loaded, p_Loaded is called before returning.
+	 *
+	 * @param p_ResourceType type of resource
+	 * @param p_ResourceName name of the resource
+	 * @param p_Loaded called on the owning thread with the ID, or -1 if the load failed
+	 */
+	void loadResourceAsync(const std::string& p_ResourceType, const std::string& p_ResourceName, LoadedCallback p_Loaded);
+
+	/**
+	 * Runs the finish steps of prepared resources and their callbacks. Should
+	 * be called regularly, e.g. once per frame, from the thread calling loadResourceAsync.
+	 */
+	void finishAsyncLoads();
+
+	/**
+	 * @return the number of asynchronous loads, including dependencies, that are not finished
+	 */
+	unsigned int getNumPendingLoads();
+
+	/**
+	 * Sets the number of threads preparing asynchronous loads. With 0 threads,
+	 * resources are prepared on the calling thread of finishAsyncLoads.
+	 * Must not be called with loads in progress.
+	 */
+	void setLoaderThreads(unsigned int p_NumThreads);
+
+	/**
+	 * Add a reference to an already loaded resource, without resolving its name again.
+	 * The resource must be released with releaseResource like any loaded resource.
+	 * @param p_ID ID of a previously loaded resource
+	 * @return true if the resource is still loaded and was referenced, otherwise false
+	 */
+	bool acquireResource(int p_ID);
+
+	/**
+	 * Resolves the file a resource is loaded from, without loading it.
+	 * @param p_ResourceType type of resource
+	 * @param p_ResourceName name of the resource
+	 * @return the complete path to the resource file
+	 */
+	std::string getResourcePath(const std::string& p_ResourceType, const std::string& p_ResourceName);
+
+	/**
+	 * Checks if a resource is in the loaded asset archive.
+	 * @param p_ResourceType type of resource
+	 * @param p_ResourceName name of the resource
+	 * @return true if the resource is read from the archive when loaded
+	 */
+	bool isArchived(const std::string& p_ResourceType, const std::string& p_ResourceName) const;
+
 	/**
 	 * Loads a texture, should only be used as callback.
 	 * @param p_ResourceName type of resource
@@ -120,11 +351,73 @@ public:
 	 */
 	void setReleaseImmediately(bool p_Release);
 
+	/**
+	 * Limits the memory used by the resources of a type.
+	 *
+	 * Resources no longer in use are kept loaded, so that they can be used again
+	 * without being reloaded, until the loaded resources of the type exceed the
+	 * budget. The least recently used are then released first. Resources in use
+	 * are never released, and releasing immediately takes precedence.
+	 * The budget is unlimited by default.
+	 *
+	 * @param p_Type the resource type
+	 * @param p_Budget the budget in the unit of the type's size function, bytes by default
+	 * @return true if the budget was set, false if the type is not registered
+	 */
+	bool setResourceBudget(const std::string& p_Type, size_t p_Budget);
+
+	/**
+	 * @return the budget of a resource type, or 0 if the type is not registered
+	 */
+	size_t getResourceBudget(const std::string& p_Type) const;
+
+	/**
+	 * @return the total size of the loaded resources of a type, used or not
+	 */
+	size_t getResidentSize(const std::string& p_Type) const;
+
+	/**
+	 * The unused resources of a type in the order they will be released.
+	 * @return the IDs of the resources, the next to be released first
+	 */
+	std::vector<int> getEvictionOrder(const std::string& p_Type) const;
+
 	static void releaseModelTexture(const char *p_ResournceName, void* p_Userdata);
 
-	const std::vector<ResourceType> getResourceList();
+	/**
+	 * @return the registered resource types keyed by type
+	 */
+	const std::unordered_map<std::string, ResourceType>& getResourceList() const;
 	
 	int loadModelTextureImpl(const char *p_ResourceName, const char *p_FilePath);
 	void releaseModelTextureImpl(const char *p_ResourceName);
+
+private:
+	/**
+	 * Find the archive entry and the complete path of a resource.
+	 * @param p_Entry set to the entry in the archive, or nullptr if the resource is not archived
+	 */
+	std::string resolveResource(const std::string& p_ResourceType, const std::string& p_ResourceName,
+		const AssetArchiveFormat::Entry*& p_Entry);
+
+	friend class ResourceDependencies;
+
+	ResourceType* findType(const std::string& p_Type);
+	ResourceType::Resource* findLoaded(ResourceType& p_Type, const std::string& p_FilePath);
+	ResourceType::Resource* findNamed(ResourceType& p_Type, const std::string& p_ResourceName);
+	ResourceType::Resource& addResource(ResourceType& p_Type, const std::string& p_ResourceName,
+		const std::string& p_FilePath, const AssetArchiveFormat::Entry* p_Entry, bool p_Resolved);
+	void releaseOverBudget(ResourceType& p_Type);
+	void addReferences(ResourceType::Resource& p_Resource, int p_Count);
+	void removeReference(ResourceType::Resource& p_Resource);
+	void destroyResource(ResourceType::Resource& p_Resource);
+	void releaseAllResources(ResourceType& p_Type, const std::string& p_Warning);
+	void linkUnused(ResourceType::Resource& p_Resource);
+	void unlinkUnused(ResourceType::Resource& p_Resource);
+	std::shared_ptr<AsyncLoadRequest> addPendingLoad(const std::string& p_ResourceType, const std::string& p_ResourceName,
+		const std::string& p_FilePath, const AssetArchiveFormat::Entry* p_Entry, bool p_Resolved, bool& p_Added);
+	void startLoad(std::shared_ptr<AsyncLoadRequest> p_Request);
+	void prepareLoad(std::shared_ptr<AsyncLoadRequest> p_Request);
+	void finishLoad(std::shared_ptr<AsyncLoadRequest> p_Request);
 };
 
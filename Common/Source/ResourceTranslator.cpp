@@ -1,6 +1,8 @@
 #include "ResourceTranslator.h"
 #include "CommonExceptions.h"
 
+#include <vector>
+
 ResourceTranslator::ResourceTranslator(){}
 
 ResourceTranslator::~ResourceTranslator(){}
@@ -30,28 +32,24 @@ void ResourceTranslator::loadResourceList(std::istream& p_FileData)
 		if(!type)
 			continue;
 
-		m_MappedResources.push_back(std::make_pair(type, std::vector<const std::pair<std::string, std::string>>()));
-		auto& map = m_MappedResources.back().second;
+		// The first resource with a name is the one used, like when the list was searched in order
+		auto& map = m_MappedResources[type];
 		for(const tinyxml2::XMLElement* resource = resourceType->FirstChildElement("Resource"); resource; resource = resource->NextSiblingElement("Resource"))
 		{
-			map.push_back(readValues(resource));
+			map.insert(readValues(resource));
 		}
 	}
 }
 
 std::string ResourceTranslator::translate(std::string p_ResourceType, std::string p_ResourceName)
 {
-	for (const auto& map : m_MappedResources)
+	const auto type = m_MappedResources.find(p_ResourceType);
+	if (type != m_MappedResources.end())
 	{
-		if (p_ResourceType == map.first)
+		const auto resource = type->second.find(p_ResourceName);
+		if (resource != type->second.end())
 		{
-			for (const auto& m : map.second)
-			{
-				if (m.first == p_ResourceName)
-				{
-					return m.second;
-				}
-			}
+			return resource->second;
 		}
 	}
 	std::string Error("Unknown resource: '" + p_ResourceType + ":" + p_ResourceName + "'");
@@ -1,13 +1,15 @@
 #pragma once
 #include <string>
-#include <vector>
+#include <unordered_map>
 #include <tinyxml2\tinyxml2.h>
 
 class ResourceTranslator
 {
 private:
-	
-	std::vector<std::pair<std::string, std::vector<const std::pair<std::string, std::string>>>> m_MappedResources;
+	/**
+	 * Resource paths keyed by type and then by name.
+	 */
+	std::unordered_map<std::string, std::unordered_map<std::string, std::string>> m_MappedResources;
 public:
 	ResourceTranslator();
 	~ResourceTranslator();
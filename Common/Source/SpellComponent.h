@@ -7,6 +7,22 @@
 
 class SpellComponent : public SpellInterface
 {
+public:
+	/**
+	 * Typed description of a spell component, mirroring the XML attributes.
+	 */
+	struct Description
+	{
+		std::string spellName;
+		Actor::Id casterId;
+		Vector3 direction;
+
+		Description()
+			:	casterId(-1),
+				direction(0.f, 0.f, 0.f)
+		{
+		}
+	};
 
 private:
 	int m_SpellId;
@@ -47,14 +63,30 @@ public:
 			throw CommonException("Missing spell name", __LINE__, __FILE__);
 		}
 
-		m_CasterId = -1;
-		p_Data->QueryAttribute("CasterId", &m_CasterId);
+		Description desc;
+		desc.spellName = spellName;
+		p_Data->QueryAttribute("CasterId", &desc.casterId);
+		queryVector(p_Data->FirstChildElement("Direction"), desc.direction);
 
-		m_SpellName = spellName;
-		m_SpellId = m_ResourceManager->loadResource("spell", m_SpellName);
+		initialize(desc);
+	}
 
-		m_StartDirection = Vector3(0.f, 0.f, 0.f);
-		queryVector(p_Data->FirstChildElement("Direction"), m_StartDirection);
+	/**
+	 * Function called to initialize variables directly from a typed description
+	 * 
+	 * @param p_Description the spell parameters
+	 */
+	void initialize(const Description& p_Description)
+	{
+		if (p_Description.spellName.empty())
+		{
+			throw CommonException("Missing spell name", __LINE__, __FILE__);
+		}
+
+		m_CasterId = p_Description.casterId;
+		m_SpellName = p_Description.spellName;
+		m_SpellId = m_ResourceManager->loadResource("spell", m_SpellName);
+		m_StartDirection = p_Description.direction;
 
 		m_RandomEngine.seed((unsigned long)std::chrono::system_clock::now().time_since_epoch().count());
 	}
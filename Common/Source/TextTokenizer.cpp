@@ -0,0 +1,576 @@
+#include "TextTokenizer.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace
+{
+	/**
+	 * Powers of ten that are exact in a double.
+	 */
+	const double exactPowersOfTen[] =
+	{
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+	};
+	const int maxExactPower = 22;
+	const int maxMantissaDigits = 19;
+	const uint64_t maxExactMantissa = uint64_t(1) << 53;
+
+	bool isDigit(char p_Character)
+	{
+		return p_Character >= '0' && p_Character <= '9';
+	}
+
+	bool isSpace(char p_Character)
+	{
+		return p_Character == ' ' || p_Character == '\t' || p_Character == '\r'
+			|| p_Character == '\v' || p_Character == '\f';
+	}
+
+	/**
+	 * An unsigned integer of any size, only as much as comparing a decimal
+	 * number exactly with a double needs.
+	 */
+	class BigInteger
+	{
+	private:
+		/**
+		 * Least significant word first, without leading zero words.
+		 */
+		std::vector<uint32_t> m_Words;
+
+	public:
+		explicit BigInteger(uint64_t p_Value)
+		{
+			for (; p_Value != 0; p_Value >>= 32)
+			{
+				m_Words.push_back(static_cast<uint32_t>(p_Value));
+			}
+		}
+
+		void multiplyAdd(uint32_t p_Factor, uint32_t p_Term)
+		{
+			uint64_t carry = p_Term;
+			for (auto& word : m_Words)
+			{
+				carry += static_cast<uint64_t>(word) * p_Factor;
+				word = static_cast<uint32_t>(carry);
+				carry >>= 32;
+			}
+			if (carry != 0)
+			{
+				m_Words.push_back(static_cast<uint32_t>(carry));
+			}
+		}
+
+		void multiplyPow5(unsigned int p_Exponent)
+		{
+			// 5^13 is the largest power of five that fits a word
+			for (; p_Exponent >= 13; p_Exponent -= 13)
+			{
+				multiplyAdd(1220703125, 0);
+			}
+			for (; p_Exponent > 0; --p_Exponent)
+			{
+				multiplyAdd(5, 0);
+			}
+		}
+
+		void shiftLeft(unsigned int p_Bits)
+		{
+			if (m_Words.empty())
+			{
+				return;
+			}
+
+			m_Words.insert(m_Words.begin(), p_Bits / 32, 0);
+			const unsigned int bits = p_Bits % 32;
+			if (bits != 0)
+			{
+				uint32_t carry = 0;
+				for (auto& word : m_Words)
+				{
+					const uint32_t shifted = (word << bits) | carry;
+					carry = word >> (32 - bits);
+					word = shifted;
+				}
+				if (carry != 0)
+				{
+					m_Words.push_back(carry);
+				}
+			}
+		}
+
+		int compare(const BigInteger& p_Other) const
+		{
+			if (m_Words.size() != p_Other.m_Words.size())
+			{
+				return m_Words.size() < p_Other.m_Words.size() ? -1 : 1;
+			}
+			for (size_t i = m_Words.size(); i-- > 0; )
+			{
+				if (m_Words[i] != p_Other.m_Words[i])
+				{
+					return m_Words[i] < p_Other.m_Words[i] ? -1 : 1;
+				}
+			}
+			return 0;
+		}
+	};
+
+	/**
+	 * Compare the magnitude of a number accepted by parseFloat exactly with a positive double.
+	 *
+	 * @return less than, equal to or greater than zero if the number is smaller, equal or larger
+	 */
+	int compareDecimal(const char* p_Begin, const char* p_End, double p_Value)
+	{
+		const char* position = p_Begin;
+		if (*position == '-' || *position == '+')
+		{
+			++position;
+		}
+
+		BigInteger digits(0);
+		int exponent = 0;
+		bool fraction = false;
+		for (; position != p_End && *position != 'e' && *position != 'E'; ++position)
+		{
+			if (*position == '.')
+			{
+				fraction = true;
+				continue;
+			}
+			digits.multiplyAdd(10, *position - '0');
+			if (fraction)
+			{
+				--exponent;
+			}
+		}
+		if (position != p_End)
+		{
+			++position;
+			const bool negativeExponent = *position == '-';
+			if (*position == '-' || *position == '+')
+			{
+				++position;
+			}
+			int explicitExponent = 0;
+			for (; position != p_End; ++position)
+			{
+				if (explicitExponent < 100000)
+				{
+					explicitExponent = explicitExponent * 10 + (*position - '0');
+				}
+			}
+			exponent += negativeExponent ? -explicitExponent : explicitExponent;
+		}
+
+		// digits * 10^exponent against mantissa * 2^binaryExponent, all in integers
+		int binaryExponent;
+		const double fractionPart = frexp(p_Value, &binaryExponent);
+		BigInteger mantissa(static_cast<uint64_t>(ldexp(fractionPart, 53)));
+		binaryExponent -= 53;
+
+		int twos = exponent - binaryExponent;
+		if (exponent >= 0)
+		{
+			digits.multiplyPow5(exponent);
+		}
+		else
+		{
+			mantissa.multiplyPow5(-exponent);
+		}
+		if (twos >= 0)
+		{
+			digits.shiftLeft(twos);
+		}
+		else
+		{
+			mantissa.shiftLeft(-twos);
+		}
+
+		return digits.compare(mantissa);
+	}
+
+	/**
+	 * Narrow a double read from a number to the float nearest the number itself.
+	 *
+	 * A double that lands exactly halfway between two floats can be the rounded
+	 * value of a number slightly above or below, which narrowing would round to
+	 * even regardless. Those are settled against the digits of the number.
+	 */
+	float narrowToFloat(const char* p_Begin, const char* p_End, double p_Value)
+	{
+		const double magnitude = fabs(p_Value);
+		const float nearest = static_cast<float>(magnitude);
+		if (static_cast<double>(nearest) == magnitude)
+		{
+			return static_cast<float>(p_Value);
+		}
+
+		uint32_t belowBits;
+		memcpy(&belowBits, &nearest, sizeof(belowBits));
+		if (static_cast<double>(nearest) > magnitude)
+		{
+			--belowBits;
+		}
+		const uint32_t aboveBits = belowBits + 1;
+		float below, above;
+		memcpy(&below, &belowBits, sizeof(below));
+		memcpy(&above, &aboveBits, sizeof(above));
+
+		// The sum of two neighbouring floats and its half are exact in a double
+		const double halfway = (static_cast<double>(below) + static_cast<double>(above)) * 0.5;
+		if (magnitude != halfway || above == std::numeric_limits<float>::infinity())
+		{
+			return static_cast<float>(p_Value);
+		}
+
+		const int order = compareDecimal(p_Begin, p_End, halfway);
+		const float result = order < 0 || (order == 0 && (belowBits & 1) == 0) ? below : above;
+		return p_Value < 0.0 ? -result : result;
+	}
+
+	float parseFloatSlow(const char* p_Begin, const char* p_End)
+	{
+		char buffer[64];
+		const size_t length = p_End - p_Begin;
+		if (length < sizeof(buffer))
+		{
+			memcpy(buffer, p_Begin, length);
+			buffer[length] = '\0';
+			return narrowToFloat(p_Begin, p_End, strtod(buffer, nullptr));
+		}
+
+		const std::string text(p_Begin, p_End);
+		return narrowToFloat(p_Begin, p_End, strtod(text.c_str(), nullptr));
+	}
+}
+
+bool TextTokenizer::Token::empty() const
+{
+	return m_Length == 0;
+}
+
+std::string TextTokenizer::Token::str() const
+{
+	return std::string(m_Begin, m_Length);
+}
+
+bool TextTokenizer::Token::operator==(const char* p_Text) const
+{
+	return strlen(p_Text) == m_Length && memcmp(m_Begin, p_Text, m_Length) == 0;
+}
+
+bool TextTokenizer::Token::operator!=(const char* p_Text) const
+{
+	return !(*this == p_Text);
+}
+
+TextTokenizer::TextTokenizer(const char* p_Text, size_t p_Size)
+	:	m_Next(p_Text),
+		m_End(p_Text + p_Size),
+		m_LineBegin(p_Text),
+		m_Position(p_Text),
+		m_LineEnd(p_Text),
+		m_Fail(false)
+{
+}
+
+bool TextTokenizer::nextLine()
+{
+	m_Fail = false;
+	if (m_Next == m_End)
+	{
+		m_LineBegin = m_Position = m_LineEnd = m_End;
+		return false;
+	}
+
+	m_LineBegin = m_Position = m_Next;
+	const char* newline = static_cast<const char*>(memchr(m_Next, '\n', m_End - m_Next));
+	if (newline)
+	{
+		m_LineEnd = newline;
+		m_Next = newline + 1;
+	}
+	else
+	{
+		m_LineEnd = m_End;
+		m_Next = m_End;
+	}
+
+	if (m_LineEnd != m_LineBegin && m_LineEnd[-1] == '\r')
+	{
+		--m_LineEnd;
+	}
+
+	return true;
+}
+
+bool TextTokenizer::isLineEmpty() const
+{
+	return m_LineBegin == m_LineEnd;
+}
+
+bool TextTokenizer::fail() const
+{
+	return m_Fail;
+}
+
+bool TextTokenizer::atEnd() const
+{
+	return m_Next == m_End;
+}
+
+TextTokenizer::Token TextTokenizer::readToken()
+{
+	Token token;
+	token.m_Begin = m_Position;
+	token.m_Length = 0;
+	if (m_Fail)
+	{
+		return token;
+	}
+
+	skipWhitespace();
+	token.m_Begin = m_Position;
+	while (m_Position != m_LineEnd && !isSpace(*m_Position))
+	{
+		++m_Position;
+	}
+	token.m_Length = m_Position - token.m_Begin;
+	m_Fail = token.empty();
+
+	return token;
+}
+
+bool TextTokenizer::readString(std::string& p_Value)
+{
+	const Token token = readToken();
+	if (token.empty())
+	{
+		return false;
+	}
+
+	p_Value.assign(token.m_Begin, token.m_Length);
+	return true;
+}
+
+bool TextTokenizer::readFloat(float& p_Value)
+{
+	if (m_Fail)
+	{
+		return false;
+	}
+
+	skipWhitespace();
+	const char* next = parseFloat(m_Position, m_LineEnd, p_Value);
+	m_Fail = next == m_Position;
+	m_Position = next;
+
+	return !m_Fail;
+}
+
+bool TextTokenizer::readInt(int& p_Value)
+{
+	if (m_Fail)
+	{
+		return false;
+	}
+
+	skipWhitespace();
+	const char* next = parseInt(m_Position, m_LineEnd, p_Value);
+	m_Fail = next == m_Position;
+	m_Position = next;
+
+	return !m_Fail;
+}
+
+bool TextTokenizer::readBool(bool& p_Value)
+{
+	int value = 0;
+	if (!readInt(value))
+	{
+		return false;
+	}
+	if (value != 0 && value != 1)
+	{
+		m_Fail = true;
+		return false;
+	}
+
+	p_Value = value == 1;
+	return true;
+}
+
+const char* TextTokenizer::parseFloat(const char* p_Begin, const char* p_End, float& p_Value)
+{
+	const char* position = p_Begin;
+	bool negative = false;
+	if (position != p_End && (*position == '-' || *position == '+'))
+	{
+		negative = *position == '-';
+		++position;
+	}
+
+	uint64_t mantissa = 0;
+	int numDigits = 0;
+	int exponent = 0;
+	bool anyDigits = false;
+	bool truncated = false;
+
+	for (; position != p_End && isDigit(*position); ++position)
+	{
+		anyDigits = true;
+		if (mantissa == 0 && *position == '0')
+		{
+			continue;
+		}
+		if (numDigits < maxMantissaDigits)
+		{
+			mantissa = mantissa * 10 + (*position - '0');
+			++numDigits;
+		}
+		else
+		{
+			++exponent;
+			truncated = true;
+		}
+	}
+
+	if (position != p_End && *position == '.')
+	{
+		for (++position; position != p_End && isDigit(*position); ++position)
+		{
+			anyDigits = true;
+			if (mantissa == 0 && *position == '0')
+			{
+				--exponent;
+			}
+			else if (numDigits < maxMantissaDigits)
+			{
+				mantissa = mantissa * 10 + (*position - '0');
+				++numDigits;
+				--exponent;
+			}
+			else
+			{
+				truncated = true;
+			}
+		}
+	}
+
+	if (!anyDigits)
+	{
+		return p_Begin;
+	}
+
+	// An exponent is only part of the number if it has digits
+	if (position != p_End && (*position == 'e' || *position == 'E'))
+	{
+		const char* exponentPosition = position + 1;
+		bool negativeExponent = false;
+		if (exponentPosition != p_End && (*exponentPosition == '-' || *exponentPosition == '+'))
+		{
+			negativeExponent = *exponentPosition == '-';
+			++exponentPosition;
+		}
+		if (exponentPosition != p_End && isDigit(*exponentPosition))
+		{
+			int explicitExponent = 0;
+			for (; exponentPosition != p_End && isDigit(*exponentPosition); ++exponentPosition)
+			{
+				if (explicitExponent < 100000)
+				{
+					explicitExponent = explicitExponent * 10 + (*exponentPosition - '0');
+				}
+			}
+			exponent += negativeExponent ? -explicitExponent : explicitExponent;
+			position = exponentPosition;
+		}
+	}
+
+	if (mantissa == 0)
+	{
+		p_Value = negative ? -0.f : 0.f;
+		return position;
+	}
+
+	if (!truncated && mantissa <= maxExactMantissa && exponent >= -maxExactPower && exponent <= maxExactPower)
+	{
+		// Both operands are exact, so the division or multiplication is correctly rounded
+		double value = static_cast<double>(mantissa);
+		if (exponent < 0)
+		{
+			value /= exactPowersOfTen[-exponent];
+		}
+		else
+		{
+			value *= exactPowersOfTen[exponent];
+		}
+
+		// Narrowing is only ambiguous if the double landed exactly halfway between two floats
+		uint64_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+		const uint64_t droppedBits = bits & ((uint64_t(1) << 29) - 1);
+		if (droppedBits != (uint64_t(1) << 28))
+		{
+			const float result = static_cast<float>(value);
+			p_Value = negative ? -result : result;
+			return position;
+		}
+	}
+
+	p_Value = parseFloatSlow(p_Begin, position);
+	return position;
+}
+
+const char* TextTokenizer::parseInt(const char* p_Begin, const char* p_End, int& p_Value)
+{
+	const char* position = p_Begin;
+	bool negative = false;
+	if (position != p_End && (*position == '-' || *position == '+'))
+	{
+		negative = *position == '-';
+		++position;
+	}
+
+	const char* digits = position;
+	int64_t value = 0;
+	for (; position != p_End && isDigit(*position); ++position)
+	{
+		value = value * 10 + (*position - '0');
+		if (value > int64_t((std::numeric_limits<int>::max)()) + 1)
+		{
+			return p_Begin;
+		}
+	}
+
+	if (position == digits)
+	{
+		return p_Begin;
+	}
+
+	value = negative ? -value : value;
+	if (value > (std::numeric_limits<int>::max)())
+	{
+		return p_Begin;
+	}
+
+	p_Value = static_cast<int>(value);
+	return position;
+}
+
+void TextTokenizer::skipWhitespace()
+{
+	while (m_Position != m_LineEnd && isSpace(*m_Position))
+	{
+		++m_Position;
+	}
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/**
+ * Splits text into lines and whitespace separated tokens without allocating.
+ *
+ * Replaces reading a line with std::getline and parsing it with a
+ * std::stringstream. The read functions behave like the stream extraction
+ * operators on the current line: once a read fails, every following read on
+ * the same line fails as well, and a failed read leaves its output unchanged.
+ * Moving to the next line clears the failure.
+ *
+ * The tokenizer only points into the text, which must outlive it.
+ */
+class TextTokenizer
+{
+public:
+	/**
+	 * A part of the text. Not null terminated.
+	 */
+	struct Token
+	{
+		const char* m_Begin;
+		size_t m_Length;
+
+		bool empty() const;
+		std::string str() const;
+		bool operator==(const char* p_Text) const;
+		bool operator!=(const char* p_Text) const;
+	};
+
+private:
+	const char* m_Next;
+	const char* m_End;
+	const char* m_LineBegin;
+	const char* m_Position;
+	const char* m_LineEnd;
+	bool m_Fail;
+
+public:
+	/**
+	 * @param p_Text the text to tokenize, does not need to be null terminated
+	 * @param p_Size the number of characters in the text
+	 */
+	TextTokenizer(const char* p_Text, size_t p_Size);
+
+	/**
+	 * Move to the next line, like std::getline. A trailing carriage return is
+	 * not part of the line.
+	 *
+	 * @return false if there are no more lines, in which case the current line is empty
+	 */
+	bool nextLine();
+
+	/**
+	 * @return true if the current line has no characters at all. Whitespace counts as characters.
+	 */
+	bool isLineEmpty() const;
+
+	/**
+	 * @return true if a read on the current line has failed
+	 */
+	bool fail() const;
+
+	/**
+	 * @return true if all text has been consumed by nextLine
+	 */
+	bool atEnd() const;
+
+	/**
+	 * Read the next whitespace separated token on the current line.
+	 *
+	 * @return the token, empty if the line has no more tokens
+	 */
+	Token readToken();
+
+	/**
+	 * Read a token into a string, like operator>> for std::string.
+	 */
+	bool readString(std::string& p_Value);
+
+	/**
+	 * Read a float, like operator>> for float. Any characters following the
+	 * number are left for the next read.
+	 */
+	bool readFloat(float& p_Value);
+
+	/**
+	 * Read a decimal integer, like operator>> for int.
+	 */
+	bool readInt(int& p_Value);
+
+	/**
+	 * Read a bool written as 0 or 1, like operator>> for bool.
+	 */
+	bool readBool(bool& p_Value);
+
+	/**
+	 * Parse a float at the start of a range, in the style of std::from_chars.
+	 *
+	 * Numbers with at most 19 significant digits, a mantissa that fits a double
+	 * and a small exponent, which covers everything the exporters write, are
+	 * converted with a single correctly rounded double operation. Anything else falls back
+	 * to strtod on a copy of the number. Doubles that land exactly halfway between two
+	 * floats are rounded from the digits, so the result is always the float nearest the number.
+	 *
+	 * @param p_Begin the first character of the number
+	 * @param p_End one past the last character that may be parsed
+	 * @param p_Value the parsed value, unchanged if there is no number
+	 * @return one past the last parsed character, p_Begin if there is no number
+	 */
+	static const char* parseFloat(const char* p_Begin, const char* p_End, float& p_Value);
+
+	/**
+	 * Parse a decimal integer at the start of a range, in the style of std::from_chars.
+	 *
+	 * @return one past the last parsed character, p_Begin if there is no number or it does not fit an int
+	 */
+	static const char* parseInt(const char* p_Begin, const char* p_End, int& p_Value);
+
+private:
+	void skipWhitespace();
+};
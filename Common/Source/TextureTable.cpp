@@ -0,0 +1,102 @@
+#include "TextureTable.h"
+#include "MappedFile.h"
+
+#include <cstring>
+
+using namespace MaterialBundleFormat;
+
+TextureTable::TextureTable()
+	:	m_Hash(0)
+{
+}
+
+bool TextureTable::load(const char* p_Data, size_t p_Size)
+{
+	clear();
+
+	if (p_Size < sizeof(TableHeader))
+	{
+		return false;
+	}
+
+	TableHeader header;
+	memcpy(&header, p_Data, sizeof(header));
+	if (memcmp(header.m_Magic, tableMagic, sizeof(header.m_Magic)) != 0
+		|| header.m_Version != version
+		|| header.m_NumTextures > (p_Size - sizeof(TableHeader)) / sizeof(TextureEntry)
+		|| header.m_StringsSize != p_Size - sizeof(TableHeader) - header.m_NumTextures * sizeof(TextureEntry))
+	{
+		return false;
+	}
+
+	const char* entries = p_Data + sizeof(TableHeader);
+	const char* strings = entries + header.m_NumTextures * sizeof(TextureEntry);
+	m_Textures.resize(header.m_NumTextures);
+	for (uint32_t i = 0; i < header.m_NumTextures; ++i)
+	{
+		TextureEntry entry;
+		memcpy(&entry, entries + i * sizeof(TextureEntry), sizeof(entry));
+		if (entry.m_NameOffset > header.m_StringsSize
+			|| entry.m_NameLength > header.m_StringsSize - entry.m_NameOffset
+			|| (entry.m_Container != DDS_CONTAINER && entry.m_Container != WIC_CONTAINER))
+		{
+			clear();
+			return false;
+		}
+
+		Texture& texture = m_Textures[i];
+		texture.m_Name.assign(strings + entry.m_NameOffset, entry.m_NameLength);
+		texture.m_Container = static_cast<Container>(entry.m_Container);
+		texture.m_Format = entry.m_Format;
+		texture.m_Width = entry.m_Width;
+		texture.m_Height = entry.m_Height;
+		texture.m_MipLevels = entry.m_MipLevels;
+		texture.m_ArraySize = entry.m_ArraySize;
+
+		// Keep the first of any duplicate names, like the resource list does
+		m_IDs.insert(std::make_pair(texture.m_Name, i));
+	}
+
+	m_Hash = hashData(p_Data, p_Size);
+	return true;
+}
+
+bool TextureTable::loadFile(const std::string& p_FilePath)
+{
+	MappedFile file;
+	if (!file.open(p_FilePath))
+	{
+		clear();
+		return false;
+	}
+
+	return load(file.getData(), file.getSize());
+}
+
+void TextureTable::clear()
+{
+	m_Textures.clear();
+	m_IDs.clear();
+	m_Hash = 0;
+}
+
+unsigned int TextureTable::getNumTextures() const
+{
+	return m_Textures.size();
+}
+
+unsigned int TextureTable::find(const std::string& p_Name) const
+{
+	auto it = m_IDs.find(p_Name);
+	return it != m_IDs.end() ? it->second : invalidTexture;
+}
+
+const TextureTable::Texture& TextureTable::getTexture(unsigned int p_ID) const
+{
+	return m_Textures[p_ID];
+}
+
+uint64_t TextureTable::getHash() const
+{
+	return m_Hash;
+}
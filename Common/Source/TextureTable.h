@@ -0,0 +1,87 @@
+#pragma once
+
+#include "MaterialBundleFormat.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * The textures of a texture directory, read from a texture table (.btt),
+ * see MaterialBundleFormat.h.
+ *
+ * Textures are identified by their index in the table, and found by file name.
+ * The table records how every texture is stored and what it loads as, so that
+ * loading does not have to look at the file extension or header first.
+ */
+class TextureTable
+{
+public:
+	struct Texture
+	{
+		std::string m_Name;
+		MaterialBundleFormat::Container m_Container;
+		unsigned int m_Format;
+		unsigned int m_Width;
+		unsigned int m_Height;
+		unsigned int m_MipLevels;
+		unsigned int m_ArraySize;
+
+		Texture()
+			:	m_Container(MaterialBundleFormat::DDS_CONTAINER),
+				m_Format(0),
+				m_Width(0),
+				m_Height(0),
+				m_MipLevels(1),
+				m_ArraySize(1)
+		{}
+	};
+
+private:
+	std::vector<Texture> m_Textures;
+	std::unordered_map<std::string, unsigned int> m_IDs;
+	uint64_t m_Hash;
+
+public:
+	/**
+	 * Constructor, creates an empty table.
+	 */
+	TextureTable();
+
+	/**
+	 * Read a texture table, replacing the current contents.
+	 *
+	 * @param p_Data the contents of a .btt file
+	 * @param p_Size the size of the contents in bytes
+	 * @return false if the data is not a valid texture table, which leaves the table empty
+	 */
+	bool load(const char* p_Data, size_t p_Size);
+
+	/**
+	 * Read a texture table from a file, replacing the current contents.
+	 *
+	 * @return false if the file could not be read or is not a valid texture table
+	 */
+	bool loadFile(const std::string& p_FilePath);
+
+	void clear();
+
+	unsigned int getNumTextures() const;
+
+	/**
+	 * Find a texture by file name.
+	 *
+	 * @return the ID of the texture, or MaterialBundleFormat::invalidTexture if it is not in the table
+	 */
+	unsigned int find(const std::string& p_Name) const;
+
+	/**
+	 * @param p_ID an ID less than getNumTextures
+	 */
+	const Texture& getTexture(unsigned int p_ID) const;
+
+	/**
+	 * The hash of the loaded table, stored in material bundles built against it.
+	 */
+	uint64_t getHash() const;
+};
@@ -218,6 +218,15 @@ void TweakSettings::setListener(const std::string& p_Setting, std::function<void
 		};
 }
 
+void TweakSettings::removeListener(const std::string& p_Setting)
+{
+	auto setting = m_Settings.find(p_Setting);
+	if (setting != m_Settings.end())
+	{
+		setting->second.listener = CastingListener();
+	}
+}
+
 std::streamoff TweakSettings::getStreamsize(std::istream& p_Stream)
 {
 	p_Stream.seekg(0, std::istream::end);
@@ -194,6 +194,13 @@ public:
 	 */
 	void setListener(const std::string& p_Setting, std::function<void(bool)> p_Listener);
 
+	/**
+	 * Stop calling the listener of a setting. The setting keeps its value.
+	 *
+	 * @param p_Setting the setting to remove the listener from
+	 */
+	void removeListener(const std::string& p_Setting);
+
 private:
 	static std::streamoff getStreamsize(std::istream& p_Stream);
 };
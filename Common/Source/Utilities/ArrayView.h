@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+
+/**
+ * A read-only view of a contiguous range of elements owned by someone else,
+ * for example a memory mapped file or a network buffer.
+ *
+ * The view never copies or frees the elements, the owner has to outlive it.
+ * The elements are not required to be aligned for T, as in level files where
+ * the arrays follow names of any length, so they are copied out one at a time
+ * instead of being accessed through a T pointer.
+ */
+template <typename T>
+class ArrayView
+{
+public:
+	/**
+	 * Reads the elements by value, in order.
+	 */
+	class const_iterator
+	{
+	private:
+		const char* m_Position;
+
+	public:
+		typedef std::input_iterator_tag iterator_category;
+		typedef T value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const T* pointer;
+		typedef T reference;
+
+		const_iterator()
+			: m_Position(nullptr)
+		{}
+
+		explicit const_iterator(const char* p_Position)
+			: m_Position(p_Position)
+		{}
+
+		T operator*() const
+		{
+			return load(m_Position);
+		}
+
+		const_iterator& operator++()
+		{
+			m_Position += sizeof(T);
+			return *this;
+		}
+
+		const_iterator operator++(int)
+		{
+			const_iterator previous(*this);
+			m_Position += sizeof(T);
+			return previous;
+		}
+
+		bool operator==(const const_iterator& p_Other) const
+		{
+			return m_Position == p_Other.m_Position;
+		}
+
+		bool operator!=(const const_iterator& p_Other) const
+		{
+			return m_Position != p_Other.m_Position;
+		}
+	};
+
+private:
+	const char* m_Data;
+	size_t m_Size;
+
+public:
+	ArrayView()
+		: m_Data(nullptr), m_Size(0)
+	{}
+
+	/**
+	 * @param p_Data the first byte of the first element, any alignment
+	 * @param p_Size the number of elements
+	 */
+	ArrayView(const void* p_Data, size_t p_Size)
+		: m_Data(static_cast<const char*>(p_Data)), m_Size(p_Size)
+	{}
+
+	/**
+	 * @return the first byte of the elements, which may not be aligned for T
+	 */
+	const void* data() const
+	{
+		return m_Data;
+	}
+
+	size_t size() const
+	{
+		return m_Size;
+	}
+
+	bool empty() const
+	{
+		return m_Size == 0;
+	}
+
+	const_iterator begin() const
+	{
+		return const_iterator(m_Data);
+	}
+
+	const_iterator end() const
+	{
+		return const_iterator(m_Data + m_Size * sizeof(T));
+	}
+
+	T operator[](size_t p_Index) const
+	{
+		return load(m_Data + p_Index * sizeof(T));
+	}
+
+private:
+	static T load(const char* p_Position)
+	{
+		T value;
+		memcpy(&value, p_Position, sizeof(T));
+		return value;
+	}
+};
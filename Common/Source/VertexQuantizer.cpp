@@ -0,0 +1,288 @@
+#include "VertexQuantizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+	const float degreesPerRadian = 57.2957795f;
+
+	float signNotZero(float p_Value)
+	{
+		return p_Value < 0.f ? -1.f : 1.f;
+	}
+
+	int16_t toSnorm16(float p_Value)
+	{
+		const float clamped = (std::max)(-1.f, (std::min)(1.f, p_Value));
+		return (int16_t)std::floor(clamped * 32767.f + 0.5f);
+	}
+
+	float fromSnorm16(int16_t p_Value)
+	{
+		return (std::max)(-1.f, p_Value / 32767.f);
+	}
+
+	uint16_t toUnorm16(float p_Value, float p_Min, float p_Size)
+	{
+		if (p_Size <= 0.f)
+		{
+			return 0;
+		}
+		const float normalized = (std::max)(0.f, (std::min)(1.f, (p_Value - p_Min) / p_Size));
+		return (uint16_t)std::floor(normalized * 65535.f + 0.5f);
+	}
+
+	float fromUnorm16(uint16_t p_Value, float p_Min, float p_Size)
+	{
+		return p_Min + p_Value / 65535.f * p_Size;
+	}
+
+	DirectX::XMFLOAT3 cross(const DirectX::XMFLOAT3& p_A, const DirectX::XMFLOAT3& p_B)
+	{
+		return DirectX::XMFLOAT3(
+			p_A.y * p_B.z - p_A.z * p_B.y,
+			p_A.z * p_B.x - p_A.x * p_B.z,
+			p_A.x * p_B.y - p_A.y * p_B.x);
+	}
+
+	float dot(const DirectX::XMFLOAT3& p_A, const DirectX::XMFLOAT3& p_B)
+	{
+		return p_A.x * p_B.x + p_A.y * p_B.y + p_A.z * p_B.z;
+	}
+
+	/**
+	 * The angle between two directions in degrees, 0 if either has no direction.
+	 */
+	float angleBetween(const DirectX::XMFLOAT3& p_A, const DirectX::XMFLOAT3& p_B)
+	{
+		if (dot(p_A, p_A) < 1e-12f || dot(p_B, p_B) < 1e-12f)
+		{
+			return 0.f;
+		}
+		// atan2 keeps its precision for small angles, where acos of the cosine does not
+		const DirectX::XMFLOAT3 normal = cross(p_A, p_B);
+		return std::atan2(std::sqrt(dot(normal, normal)), dot(p_A, p_B)) * degreesPerRadian;
+	}
+}
+
+VertexQuantizer::Bounds VertexQuantizer::computeBounds(const DirectX::XMFLOAT4* p_Positions, size_t p_Count, size_t p_Stride)
+{
+	Bounds bounds;
+	bounds.m_Min = DirectX::XMFLOAT3(0.f, 0.f, 0.f);
+	bounds.m_Size = DirectX::XMFLOAT3(0.f, 0.f, 0.f);
+	if (p_Count == 0)
+	{
+		return bounds;
+	}
+
+	DirectX::XMFLOAT3 minPos(p_Positions->x, p_Positions->y, p_Positions->z);
+	DirectX::XMFLOAT3 maxPos = minPos;
+	const char* vertex = reinterpret_cast<const char*>(p_Positions);
+	for (size_t i = 0; i < p_Count; ++i, vertex += p_Stride)
+	{
+		const DirectX::XMFLOAT4& position = *reinterpret_cast<const DirectX::XMFLOAT4*>(vertex);
+		minPos.x = (std::min)(minPos.x, position.x);
+		minPos.y = (std::min)(minPos.y, position.y);
+		minPos.z = (std::min)(minPos.z, position.z);
+		maxPos.x = (std::max)(maxPos.x, position.x);
+		maxPos.y = (std::max)(maxPos.y, position.y);
+		maxPos.z = (std::max)(maxPos.z, position.z);
+	}
+
+	bounds.m_Min = minPos;
+	bounds.m_Size = DirectX::XMFLOAT3(maxPos.x - minPos.x, maxPos.y - minPos.y, maxPos.z - minPos.z);
+	return bounds;
+}
+
+void VertexQuantizer::encode(const DirectX::XMFLOAT4& p_Position, const DirectX::XMFLOAT3& p_Normal, const DirectX::XMFLOAT2& p_UV,
+	const DirectX::XMFLOAT3& p_Tangent, const DirectX::XMFLOAT3& p_Binormal, const Bounds& p_Bounds, CompactVertex& p_Vertex)
+{
+	p_Vertex.m_Position[0] = toUnorm16(p_Position.x, p_Bounds.m_Min.x, p_Bounds.m_Size.x);
+	p_Vertex.m_Position[1] = toUnorm16(p_Position.y, p_Bounds.m_Min.y, p_Bounds.m_Size.y);
+	p_Vertex.m_Position[2] = toUnorm16(p_Position.z, p_Bounds.m_Min.z, p_Bounds.m_Size.z);
+	p_Vertex.m_BinormalSign = dot(cross(p_Tangent, p_Normal), p_Binormal) < 0.f ? -1 : 1;
+	encodeOctahedral(p_Normal, p_Vertex.m_Normal);
+	encodeOctahedral(p_Tangent, p_Vertex.m_Tangent);
+	p_Vertex.m_UV[0] = floatToHalf(p_UV.x);
+	p_Vertex.m_UV[1] = floatToHalf(p_UV.y);
+}
+
+void VertexQuantizer::decode(const CompactVertex& p_Vertex, const Bounds& p_Bounds, DirectX::XMFLOAT4& p_Position, DirectX::XMFLOAT3& p_Normal,
+	DirectX::XMFLOAT2& p_UV, DirectX::XMFLOAT3& p_Tangent, DirectX::XMFLOAT3& p_Binormal)
+{
+	p_Position.x = fromUnorm16(p_Vertex.m_Position[0], p_Bounds.m_Min.x, p_Bounds.m_Size.x);
+	p_Position.y = fromUnorm16(p_Vertex.m_Position[1], p_Bounds.m_Min.y, p_Bounds.m_Size.y);
+	p_Position.z = fromUnorm16(p_Vertex.m_Position[2], p_Bounds.m_Min.z, p_Bounds.m_Size.z);
+	p_Position.w = 1.f;
+	p_Normal = decodeOctahedral(p_Vertex.m_Normal);
+	p_Tangent = decodeOctahedral(p_Vertex.m_Tangent);
+	p_Binormal = cross(p_Tangent, p_Normal);
+	if (p_Vertex.m_BinormalSign < 0)
+	{
+		p_Binormal = DirectX::XMFLOAT3(-p_Binormal.x, -p_Binormal.y, -p_Binormal.z);
+	}
+	p_UV.x = halfToFloat(p_Vertex.m_UV[0]);
+	p_UV.y = halfToFloat(p_Vertex.m_UV[1]);
+}
+
+bool VertexQuantizer::canEncodeSkin(const DirectX::XMINT4& p_Joints)
+{
+	return p_Joints.x >= 0 && p_Joints.x <= maxJoint
+		&& p_Joints.y >= 0 && p_Joints.y <= maxJoint
+		&& p_Joints.z >= 0 && p_Joints.z <= maxJoint
+		&& p_Joints.w >= 0 && p_Joints.w <= maxJoint;
+}
+
+void VertexQuantizer::encodeSkin(const DirectX::XMFLOAT3& p_Weights, const DirectX::XMINT4& p_Joints, CompactSkin& p_Skin)
+{
+	const float weights[3] = { p_Weights.x, p_Weights.y, p_Weights.z };
+	for (unsigned int i = 0; i < 3; ++i)
+	{
+		const float clamped = (std::max)(0.f, (std::min)(1.f, weights[i]));
+		p_Skin.m_Weights[i] = (uint8_t)std::floor(clamped * 255.f + 0.5f);
+	}
+	p_Skin.m_Weights[3] = 0;
+	p_Skin.m_Joints[0] = (uint8_t)p_Joints.x;
+	p_Skin.m_Joints[1] = (uint8_t)p_Joints.y;
+	p_Skin.m_Joints[2] = (uint8_t)p_Joints.z;
+	p_Skin.m_Joints[3] = (uint8_t)p_Joints.w;
+}
+
+void VertexQuantizer::decodeSkin(const CompactSkin& p_Skin, DirectX::XMFLOAT3& p_Weights, DirectX::XMINT4& p_Joints)
+{
+	p_Weights = DirectX::XMFLOAT3(p_Skin.m_Weights[0] / 255.f, p_Skin.m_Weights[1] / 255.f, p_Skin.m_Weights[2] / 255.f);
+	p_Joints = DirectX::XMINT4(p_Skin.m_Joints[0], p_Skin.m_Joints[1], p_Skin.m_Joints[2], p_Skin.m_Joints[3]);
+}
+
+void VertexQuantizer::measureError(const DirectX::XMFLOAT4& p_Position, const DirectX::XMFLOAT3& p_Normal, const DirectX::XMFLOAT2& p_UV,
+	const DirectX::XMFLOAT3& p_Tangent, const DirectX::XMFLOAT3& p_Binormal, const CompactVertex& p_Vertex,
+	const Bounds& p_Bounds, Error& p_Error)
+{
+	DirectX::XMFLOAT4 position;
+	DirectX::XMFLOAT3 normal, tangent, binormal;
+	DirectX::XMFLOAT2 uv;
+	decode(p_Vertex, p_Bounds, position, normal, uv, tangent, binormal);
+
+	const DirectX::XMFLOAT3 offset(position.x - p_Position.x, position.y - p_Position.y, position.z - p_Position.z);
+	p_Error.m_Position = (std::max)(p_Error.m_Position, std::sqrt(dot(offset, offset)));
+	p_Error.m_Normal = (std::max)(p_Error.m_Normal, angleBetween(normal, p_Normal));
+	p_Error.m_Tangent = (std::max)(p_Error.m_Tangent, angleBetween(tangent, p_Tangent));
+	p_Error.m_Binormal = (std::max)(p_Error.m_Binormal, angleBetween(binormal, p_Binormal));
+	p_Error.m_UV = (std::max)(p_Error.m_UV, (std::max)(std::abs(uv.x - p_UV.x), std::abs(uv.y - p_UV.y)));
+}
+
+void VertexQuantizer::measureSkinError(const DirectX::XMFLOAT3& p_Weights, const DirectX::XMINT4& p_Joints, const CompactSkin& p_Skin,
+	Error& p_Error)
+{
+	DirectX::XMFLOAT3 weights;
+	DirectX::XMINT4 joints;
+	decodeSkin(p_Skin, weights, joints);
+
+	const float weightError = (std::max)(std::abs(weights.x - p_Weights.x),
+		(std::max)(std::abs(weights.y - p_Weights.y), std::abs(weights.z - p_Weights.z)));
+	p_Error.m_Weight = (std::max)(p_Error.m_Weight, weightError);
+	if (joints.x != p_Joints.x || joints.y != p_Joints.y || joints.z != p_Joints.z || joints.w != p_Joints.w)
+	{
+		++p_Error.m_JointMismatches;
+	}
+}
+
+void VertexQuantizer::encodeOctahedral(const DirectX::XMFLOAT3& p_Direction, int16_t p_Encoded[2])
+{
+	const float length = std::abs(p_Direction.x) + std::abs(p_Direction.y) + std::abs(p_Direction.z);
+	if (length == 0.f)
+	{
+		p_Encoded[0] = p_Encoded[1] = 0;
+		return;
+	}
+
+	// Project on the octahedron and fold the lower half over the upper
+	float x = p_Direction.x / length;
+	float y = p_Direction.y / length;
+	if (p_Direction.z < 0.f)
+	{
+		const float foldedX = (1.f - std::abs(y)) * signNotZero(x);
+		const float foldedY = (1.f - std::abs(x)) * signNotZero(y);
+		x = foldedX;
+		y = foldedY;
+	}
+
+	p_Encoded[0] = toSnorm16(x);
+	p_Encoded[1] = toSnorm16(y);
+}
+
+DirectX::XMFLOAT3 VertexQuantizer::decodeOctahedral(const int16_t p_Encoded[2])
+{
+	float x = fromSnorm16(p_Encoded[0]);
+	float y = fromSnorm16(p_Encoded[1]);
+	const float z = 1.f - std::abs(x) - std::abs(y);
+	if (z < 0.f)
+	{
+		const float unfoldedX = (1.f - std::abs(y)) * signNotZero(x);
+		const float unfoldedY = (1.f - std::abs(x)) * signNotZero(y);
+		x = unfoldedX;
+		y = unfoldedY;
+	}
+
+	const float length = std::sqrt(x * x + y * y + z * z);
+	return DirectX::XMFLOAT3(x / length, y / length, z / length);
+}
+
+uint16_t VertexQuantizer::floatToHalf(float p_Value)
+{
+	uint32_t bits;
+	memcpy(&bits, &p_Value, sizeof(bits));
+	const uint16_t sign = (uint16_t)((bits >> 16) & 0x8000);
+	const uint32_t absBits = bits & 0x7fffffff;
+
+	if (absBits >= 0x7f800000)
+	{
+		// Infinity stays infinity, NaN stays NaN
+		return sign | 0x7c00 | (absBits > 0x7f800000 ? 0x200 : 0);
+	}
+	if (absBits >= 0x477ff000)
+	{
+		// Rounds to more than the largest half, 65504
+		return sign | 0x7c00;
+	}
+	if (absBits < 0x38800000)
+	{
+		// Below the smallest normal half, 2^-14, store as a denormal in units of 2^-24
+		float absValue;
+		memcpy(&absValue, &absBits, sizeof(absValue));
+		return sign | (uint16_t)std::floor(absValue * 16777216.f + 0.5f);
+	}
+
+	// Round the mantissa to nearest even and rebias the exponent from 127 to 15
+	const uint32_t rounded = absBits + 0xfff + ((absBits >> 13) & 1);
+	return sign | (uint16_t)((rounded - 0x38000000) >> 13);
+}
+
+float VertexQuantizer::halfToFloat(uint16_t p_Value)
+{
+	const uint32_t sign = (uint32_t)(p_Value & 0x8000) << 16;
+	const uint32_t exponent = (p_Value >> 10) & 0x1f;
+	const uint32_t mantissa = p_Value & 0x3ff;
+
+	if (exponent == 0)
+	{
+		const float value = mantissa / 16777216.f;
+		return sign ? -value : value;
+	}
+
+	uint32_t bits;
+	if (exponent == 0x1f)
+	{
+		bits = sign | 0x7f800000 | (mantissa << 13);
+	}
+	else
+	{
+		bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+	}
+
+	float value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
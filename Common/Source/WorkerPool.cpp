@@ -0,0 +1,81 @@
+#include "WorkerPool.h"
+
+WorkerPool::WorkerPool(unsigned int p_NumThreads)
+	:	m_Quit(false)
+{
+	for (unsigned int i = 0; i < p_NumThreads; ++i)
+	{
+		m_Workers.push_back(std::thread(&WorkerPool::workerLoop, this));
+	}
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Lock);
+		m_Quit = true;
+		m_Jobs.clear();
+	}
+	m_JobReady.notify_all();
+
+	for (auto& worker : m_Workers)
+	{
+		worker.join();
+	}
+}
+
+void WorkerPool::push(std::function<void()> p_Job)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Lock);
+		m_Jobs.push_back(std::move(p_Job));
+	}
+	m_JobReady.notify_one();
+}
+
+void WorkerPool::runQueued()
+{
+	std::function<void()> job;
+	while (popJob(job))
+	{
+		job();
+	}
+}
+
+unsigned int WorkerPool::getNumThreads() const
+{
+	return m_Workers.size();
+}
+
+void WorkerPool::workerLoop()
+{
+	for (;;)
+	{
+		std::function<void()> job;
+		{
+			std::unique_lock<std::mutex> lock(m_Lock);
+			m_JobReady.wait(lock, [this] () { return m_Quit || !m_Jobs.empty(); });
+			if (m_Quit)
+			{
+				return;
+			}
+			job.swap(m_Jobs.front());
+			m_Jobs.pop_front();
+		}
+
+		job();
+	}
+}
+
+bool WorkerPool::popJob(std::function<void()>& p_Job)
+{
+	std::lock_guard<std::mutex> lock(m_Lock);
+	if (m_Jobs.empty())
+	{
+		return false;
+	}
+
+	p_Job.swap(m_Jobs.front());
+	m_Jobs.pop_front();
+	return true;
+}
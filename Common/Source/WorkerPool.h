@@ -0,0 +1,62 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * A fixed number of threads running queued jobs in the order they were pushed.
+ *
+ * With zero threads nothing runs until runQueued is called, which runs every
+ * queued job on the calling thread. This gives deterministic results for tests.
+ */
+class WorkerPool
+{
+private:
+	std::vector<std::thread> m_Workers;
+	std::deque<std::function<void()>> m_Jobs;
+	std::mutex m_Lock;
+	std::condition_variable m_JobReady;
+	bool m_Quit;
+
+public:
+	/**
+	 * Constructor, starts the worker threads.
+	 *
+	 * @param p_NumThreads the number of worker threads, 0 to only run jobs in runQueued
+	 */
+	explicit WorkerPool(unsigned int p_NumThreads);
+
+	/**
+	 * Destructor, waits for running jobs to finish. Jobs that have not started are dropped.
+	 */
+	~WorkerPool();
+
+	/**
+	 * Queue a job. May be called from any thread, including from a running job.
+	 *
+	 * @param p_Job the job, must not throw
+	 */
+	void push(std::function<void()> p_Job);
+
+	/**
+	 * Run queued jobs on the calling thread until the queue is empty, including
+	 * jobs queued by the jobs being run.
+	 */
+	void runQueued();
+
+	/**
+	 * @return the number of worker threads
+	 */
+	unsigned int getNumThreads() const;
+
+private:
+	void workerLoop();
+	bool popJob(std::function<void()>& p_Job);
+
+	WorkerPool(const WorkerPool&);
+	WorkerPool& operator=(const WorkerPool&);
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <DirectXMath.h>
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * Axis aligned box, used for culling.
+ */
+struct BoundingBox
+{
+	DirectX::XMFLOAT3 min;
+	DirectX::XMFLOAT3 max;
+
+	BoundingBox()
+		:	min(0.f, 0.f, 0.f),
+			max(0.f, 0.f, 0.f)
+	{
+	}
+
+	BoundingBox(const DirectX::XMFLOAT3& p_Min, const DirectX::XMFLOAT3& p_Max)
+		:	min(p_Min),
+			max(p_Max)
+	{
+	}
+
+	/**
+	 * Create the smallest box containing a set of points.
+	 *
+	 * @param p_Points the points, at least one
+	 * @param p_NumPoints the number of points
+	 */
+	static BoundingBox fromPoints(const DirectX::XMFLOAT3* p_Points, unsigned int p_NumPoints)
+	{
+		BoundingBox result(p_Points[0], p_Points[0]);
+		for (unsigned int i = 1; i < p_NumPoints; ++i)
+		{
+			result.merge(BoundingBox(p_Points[i], p_Points[i]));
+		}
+		return result;
+	}
+
+	/**
+	 * Grow the box to contain another box.
+	 */
+	void merge(const BoundingBox& p_Other)
+	{
+		min.x = (std::min)(min.x, p_Other.min.x);
+		min.y = (std::min)(min.y, p_Other.min.y);
+		min.z = (std::min)(min.z, p_Other.min.z);
+		max.x = (std::max)(max.x, p_Other.max.x);
+		max.y = (std::max)(max.y, p_Other.max.y);
+		max.z = (std::max)(max.z, p_Other.max.z);
+	}
+
+	/**
+	 * Get the box containing this box after it has been transformed.
+	 *
+	 * @param p_World a transposed world matrix, as stored for the shaders
+	 */
+	BoundingBox transform(const DirectX::XMFLOAT4X4& p_World) const
+	{
+		const float center[3] = { (min.x + max.x) * 0.5f, (min.y + max.y) * 0.5f, (min.z + max.z) * 0.5f };
+		const float extents[3] = { (max.x - min.x) * 0.5f, (max.y - min.y) * 0.5f, (max.z - min.z) * 0.5f };
+
+		float newMin[3];
+		float newMax[3];
+		for (int i = 0; i < 3; ++i)
+		{
+			float newCenter = p_World.m[i][3];
+			float newExtent = 0.f;
+			for (int j = 0; j < 3; ++j)
+			{
+				newCenter += p_World.m[i][j] * center[j];
+				newExtent += std::abs(p_World.m[i][j]) * extents[j];
+			}
+			newMin[i] = newCenter - newExtent;
+			newMax[i] = newCenter + newExtent;
+		}
+
+		return BoundingBox(DirectX::XMFLOAT3(newMin[0], newMin[1], newMin[2]),
+			DirectX::XMFLOAT3(newMax[0], newMax[1], newMax[2]));
+	}
+};
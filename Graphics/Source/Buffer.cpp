@@ -190,7 +190,8 @@ HRESULT Buffer::setBuffer(UINT32 p_StartSlot)
 	case Type::INDEX_BUFFER:
 		{
 			UINT32 offset = 0;
-			m_DeviceContext->IASetIndexBuffer(m_Buffer, DXGI_FORMAT_R32_UINT, offset);
+			DXGI_FORMAT format = m_SizeOfElement == 2 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+			m_DeviceContext->IASetIndexBuffer(m_Buffer, format, offset);
 			break;
 		}
 	case Type::CONSTANT_BUFFER_VS:
@@ -28,6 +28,15 @@ struct cObjectBufferColor
 	DirectX::XMFLOAT4 color;
 };
 
+/*
+ * The bounds the positions of a compact vertex buffer are quantized within.
+ */
+struct cVertexBounds
+{
+	DirectX::XMFLOAT4 positionMin;
+	DirectX::XMFLOAT4 positionSize;
+};
+
 struct cAnimatedObjectBuffer
 {
 	DirectX::XMFLOAT4X4 invTransposeWorld;
@@ -0,0 +1,220 @@
+#include "CullingGrid.h"
+
+#include <cmath>
+
+using namespace DirectX;
+
+CullingGrid::CullingGrid(float p_CellSize)
+	:	m_CellSize(p_CellSize)
+{
+}
+
+void CullingGrid::clear()
+{
+	m_Cells.clear();
+	m_CellIndices.clear();
+	m_Locations.clear();
+}
+
+unsigned int CullingGrid::add()
+{
+	Location location = { noCell, 0 };
+	m_Locations.push_back(location);
+	return m_Locations.size() - 1;
+}
+
+void CullingGrid::update(unsigned int p_Handle, const BoundingBox& p_Bounds)
+{
+	const uint64_t key = getKey(p_Bounds);
+	const Location location = m_Locations[p_Handle];
+
+	if (location.cell != noCell && m_Cells[location.cell].key == key)
+	{
+		Cell& cell = m_Cells[location.cell];
+		Entry& entry = cell.entries[location.entry];
+		const bool mayShrink = isOnBorder(entry.bounds, cell.bounds);
+		entry.bounds = p_Bounds;
+
+		if (mayShrink)
+		{
+			recalculateBounds(cell);
+		}
+		else
+		{
+			cell.bounds.merge(p_Bounds);
+		}
+		return;
+	}
+
+	if (location.cell != noCell)
+	{
+		removeEntry(location);
+	}
+
+	const unsigned int cellIndex = findCell(key);
+	Cell& cell = m_Cells[cellIndex];
+	if (cell.entries.empty())
+	{
+		cell.bounds = p_Bounds;
+	}
+	else
+	{
+		cell.bounds.merge(p_Bounds);
+	}
+
+	Entry entry = { p_Bounds, p_Handle };
+	m_Locations[p_Handle].cell = cellIndex;
+	m_Locations[p_Handle].entry = cell.entries.size();
+	cell.entries.push_back(entry);
+}
+
+void CullingGrid::remove(unsigned int p_Handle)
+{
+	if (m_Locations[p_Handle].cell != noCell)
+	{
+		removeEntry(m_Locations[p_Handle]);
+	}
+
+	const unsigned int last = m_Locations.size() - 1;
+	if (p_Handle != last)
+	{
+		const Location& moved = m_Locations[last];
+		if (moved.cell != noCell)
+		{
+			m_Cells[moved.cell].entries[moved.entry].handle = p_Handle;
+		}
+		m_Locations[p_Handle] = moved;
+	}
+	m_Locations.pop_back();
+}
+
+unsigned int CullingGrid::getSize() const
+{
+	return m_Locations.size();
+}
+
+unsigned int CullingGrid::getNumCells() const
+{
+	return m_Cells.size();
+}
+
+const BoundingBox& CullingGrid::getCellBounds(unsigned int p_Handle) const
+{
+	return m_Cells[m_Locations[p_Handle].cell].bounds;
+}
+
+void CullingGrid::cull(const Frustum& p_Frustum, std::vector<unsigned int>& p_Visible) const
+{
+	p_Visible.clear();
+
+	for (const auto& cell : m_Cells)
+	{
+		switch (p_Frustum.test(cell.bounds))
+		{
+		case Frustum::Result::OUTSIDE:
+			break;
+
+		case Frustum::Result::INSIDE:
+			for (const auto& entry : cell.entries)
+			{
+				p_Visible.push_back(entry.handle);
+			}
+			break;
+
+		case Frustum::Result::INTERSECTS:
+			for (const auto& entry : cell.entries)
+			{
+				if (p_Frustum.isVisible(entry.bounds))
+				{
+					p_Visible.push_back(entry.handle);
+				}
+			}
+			break;
+		}
+	}
+}
+
+uint64_t CullingGrid::getKey(const BoundingBox& p_Bounds) const
+{
+	const float center[3] =
+	{
+		(p_Bounds.min.x + p_Bounds.max.x) * 0.5f,
+		(p_Bounds.min.y + p_Bounds.max.y) * 0.5f,
+		(p_Bounds.min.z + p_Bounds.max.z) * 0.5f
+	};
+
+	// 21 bits per axis, wrapping around for positions too far away to fit
+	uint64_t key = 0;
+	for (int i = 0; i < 3; ++i)
+	{
+		const int64_t cell = (int64_t)std::floor(center[i] / m_CellSize);
+		key = (key << 21) | ((uint64_t)cell & 0x1fffff);
+	}
+	return key;
+}
+
+unsigned int CullingGrid::findCell(uint64_t p_Key)
+{
+	auto findIt = m_CellIndices.find(p_Key);
+	if (findIt != m_CellIndices.end())
+		return findIt->second;
+
+	const unsigned int index = m_Cells.size();
+	m_Cells.push_back(Cell());
+	m_Cells.back().key = p_Key;
+	m_CellIndices[p_Key] = index;
+	return index;
+}
+
+void CullingGrid::removeEntry(Location p_Location)
+{
+	Cell& cell = m_Cells[p_Location.cell];
+	std::vector<Entry>& entries = cell.entries;
+	const bool mayShrink = isOnBorder(entries[p_Location.entry].bounds, cell.bounds);
+
+	if (p_Location.entry != entries.size() - 1)
+	{
+		entries[p_Location.entry] = entries.back();
+		m_Locations[entries[p_Location.entry].handle].entry = p_Location.entry;
+	}
+	entries.pop_back();
+
+	if (!entries.empty())
+	{
+		if (mayShrink)
+		{
+			recalculateBounds(cell);
+		}
+		return;
+	}
+
+	// Drop the empty cell, moving the last cell into its place
+	m_CellIndices.erase(cell.key);
+	const unsigned int last = m_Cells.size() - 1;
+	if (p_Location.cell != last)
+	{
+		m_Cells[p_Location.cell] = std::move(m_Cells[last]);
+		Cell& moved = m_Cells[p_Location.cell];
+		m_CellIndices[moved.key] = p_Location.cell;
+		for (const auto& entry : moved.entries)
+		{
+			m_Locations[entry.handle].cell = p_Location.cell;
+		}
+	}
+	m_Cells.pop_back();
+}
+
+void CullingGrid::recalculateBounds(Cell& p_Cell)
+{
+	p_Cell.bounds = p_Cell.entries[0].bounds;
+	for (unsigned int i = 1; i < p_Cell.entries.size(); ++i)
+	{
+		p_Cell.bounds.merge(p_Cell.entries[i].bounds);
+	}
+}
+
+bool CullingGrid::isOnBorder(const BoundingBox& p_Box, const BoundingBox& p_Bounds)
+{
+	return p_Box.min.x <= p_Bounds.min.x || p_Box.min.y <= p_Bounds.min.y || p_Box.min.z <= p_Bounds.min.z
+		|| p_Box.max.x >= p_Bounds.max.x || p_Box.max.y >= p_Bounds.max.y || p_Box.max.z >= p_Bounds.max.z;
+}
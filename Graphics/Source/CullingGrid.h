@@ -0,0 +1,117 @@
+#pragma once
+
+#include "BoundingBox.h"
+#include "Frustum.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Loose uniform grid of boxes, used to cull many instances against a frustum
+ * without testing every box.
+ *
+ * A box is placed in the cell containing its center, and each cell keeps the
+ * union of the boxes placed in it, so large boxes make their cell larger
+ * instead of being placed in several cells. Cells entirely outside a frustum
+ * skip all of their boxes and cells entirely inside accept all of them.
+ * The union is recalculated when a box that may have defined it leaves or
+ * shrinks, and cells are dropped when their last box leaves, so moving boxes
+ * do not leave large or empty cells behind.
+ *
+ * Boxes are identified by handles numbered from 0 without gaps, matching the
+ * index of the owner's dense arrays. Removing a handle gives the last handle its
+ * number, the same way as a swap with the last element.
+ */
+class CullingGrid
+{
+private:
+	struct Entry
+	{
+		BoundingBox bounds;
+		unsigned int handle;
+	};
+
+	struct Cell
+	{
+		uint64_t key;
+		BoundingBox bounds;
+		std::vector<Entry> entries;
+	};
+
+	struct Location
+	{
+		unsigned int cell;
+		unsigned int entry;
+	};
+
+	static const unsigned int noCell = 0xffffffff;
+
+	float m_CellSize;
+	std::vector<Cell> m_Cells;
+	std::unordered_map<uint64_t, unsigned int> m_CellIndices;
+	std::vector<Location> m_Locations;
+
+public:
+	/**
+	 * Constructor.
+	 *
+	 * @param p_CellSize the side of a cell, a few times the size of a typical instance
+	 */
+	explicit CullingGrid(float p_CellSize);
+
+	/**
+	 * Remove all boxes.
+	 */
+	void clear();
+
+	/**
+	 * Add a handle without a box. It is not returned by cull until it has been given a box.
+	 *
+	 * @return the new handle, the number of handles before the call
+	 */
+	unsigned int add();
+
+	/**
+	 * Set the box of a handle, moving it to another cell if needed.
+	 */
+	void update(unsigned int p_Handle, const BoundingBox& p_Bounds);
+
+	/**
+	 * Remove a handle. The last handle takes its number.
+	 */
+	void remove(unsigned int p_Handle);
+
+	/**
+	 * @return the number of handles
+	 */
+	unsigned int getSize() const;
+
+	/**
+	 * @return the number of cells containing at least one box
+	 */
+	unsigned int getNumCells() const;
+
+	/**
+	 * Get the union of the boxes sharing a cell with a handle's box.
+	 *
+	 * @param p_Handle a handle that has been given a box
+	 * @return the bounds of the handle's cell
+	 */
+	const BoundingBox& getCellBounds(unsigned int p_Handle) const;
+
+	/**
+	 * Find the handles whose boxes may be visible in a frustum.
+	 *
+	 * @param p_Frustum the view to cull against
+	 * @param p_Visible cleared and filled with the visible handles, in no particular order
+	 */
+	void cull(const Frustum& p_Frustum, std::vector<unsigned int>& p_Visible) const;
+
+private:
+	uint64_t getKey(const BoundingBox& p_Bounds) const;
+	unsigned int findCell(uint64_t p_Key);
+	void removeEntry(Location p_Location);
+	void recalculateBounds(Cell& p_Cell);
+	static bool isOnBorder(const BoundingBox& p_Box, const BoundingBox& p_Bounds);
+};
@@ -3,13 +3,12 @@
 #include "ModelBinaryLoader.h"
 #include "Utilities/MemoryUtil.h"
 #include "GraphicsExceptions.h"
+#include "ShadowMapView.h"
 #include "VRAMInfo.h"
 #include "WrapperFactory.h"
 
 #include <TweakSettings.h>
 
-#include <algorithm>	// std::sort
-#include <iterator>     // std::back_inserter
 //#include "GraphicsLogger.h"
 
 using std::vector;
@@ -60,7 +59,9 @@ DeferredRenderer::DeferredRenderer()
 	m_Buffer["AnimatedConstant"] = nullptr;
 	m_Buffer["WorldInstance"] = nullptr;
 	m_Shader["IGeometry"] = nullptr;
+	m_Shader["IGeometryCompact"] = nullptr;
 	m_Shader["ShadowMapGeometry"] = nullptr;
+	m_Shader["ShadowMapGeometryCompact"] = nullptr;
 
 	m_Buffer["LightConstant"] = nullptr;
 	m_Buffer["LightViewProj"] = nullptr;
@@ -281,11 +282,8 @@ void DeferredRenderer::renderDeferred()
 		updateConstantBuffer(*m_ViewMatrix, *m_ProjectionMatrix);
 		unsigned int one = 1;
 
-		std::vector<std::vector<Renderable>> instancedModels;
-		std::vector<Renderable> animatedOrSingle;
-
-		SortRenderables(animatedOrSingle, instancedModels);
-		renderGeometry(m_DepthStencilView, nrRT, rtv, instancedModels, animatedOrSingle, m_Shader["IGeometry"]);
+		SortRenderables();
+		renderGeometry(m_DepthStencilView, nrRT, rtv, m_Shader["IGeometry"], m_Shader["IGeometryCompact"], CAMERA_VIEW);
 		if(m_SSAO)
 		{
 			D3D11_VIEWPORT vp, oldVP;
@@ -301,7 +299,7 @@ void DeferredRenderer::renderDeferred()
 
 			m_DeviceContext->RSSetViewports(1, &oldVP);
 		}
-		renderLighting(instancedModels, animatedOrSingle);
+		renderLighting();
 
 		m_Objects.clear();
 	}
@@ -310,8 +308,7 @@ void DeferredRenderer::renderDeferred()
 
 
 void DeferredRenderer::renderGeometry(ID3D11DepthStencilView* p_DepthStencilView, unsigned int nrRT, ID3D11RenderTargetView* rtv[],
-									  const std::vector<std::vector<Renderable>> &p_InstancedModels, 
-									  const std::vector<Renderable> &p_AnimatedOrSingle, Shader* p_Shader)
+									  Shader* p_Shader, Shader* p_CompactShader, View p_View)
 {
 	// Set the render targets.
 	m_DeviceContext->OMSetRenderTargets(nrRT, rtv, p_DepthStencilView);
@@ -325,15 +322,29 @@ void DeferredRenderer::renderGeometry(ID3D11DepthStencilView* p_DepthStencilView
 	m_Buffer["ObjectConstant"]->setBuffer(1);
 	m_Buffer["AnimatedConstant"]->setBuffer(2);
 
-	for(const auto& animation : p_AnimatedOrSingle )
-		renderObject(animation);
+	// Animated models and models with a single instance are drawn one by one
+	const std::vector<unsigned int>& order = m_Queue.getOrder();
+	unsigned int runEnd = 0;
+	for(unsigned int run = 0; run < order.size(); run = runEnd)
+	{
+		runEnd = m_Queue.getRunEnd(run);
+		if(runEnd - run == 1 || RenderQueue::getPass(m_Queue.getKeys()[run]) == ANIMATED_PASS)
+		{
+			for(unsigned int i = run; i < runEnd; i++)
+				renderObject(m_Objects[order[i]], p_View);
+		}
+	}
 
 	m_DeviceContext->PSSetShaderResources(0, 3, nullsrvs);
 	m_Buffer["AnimatedConstant"]->unsetBuffer(2);
 	m_Buffer["ObjectConstant"]->unsetBuffer(1);
 
-	for(const auto& k : p_InstancedModels)
-		RenderObjectsInstanced(k,p_Shader);
+	for(unsigned int run = 0; run < order.size(); run = runEnd)
+	{
+		runEnd = m_Queue.getRunEnd(run);
+		if(runEnd - run > 1 && RenderQueue::getPass(m_Queue.getKeys()[run]) == STATIC_PASS)
+			RenderObjectsInstanced(run, runEnd, p_Shader, p_CompactShader, p_View);
+	}
 	
 	ID3D11SamplerState* const nullSamplerState = nullptr;
 	m_DeviceContext->PSSetSamplers(0, 1, &nullSamplerState);
@@ -459,7 +470,7 @@ void DeferredRenderer::updateSSAO_VarConstantBuffer()
 		NULL, nullptr, &ssaoBuffer, NULL, NULL);
 }
 
-void DeferredRenderer::renderLighting(const std::vector<std::vector<Renderable>> &p_InstancedModels, const std::vector<Renderable> &p_AnimatedOrSingle)
+void DeferredRenderer::renderLighting(void)
 {
 	// Store previous States to be set when we exit the method.
 	ID3D11RasterizerState *previousRasterState;
@@ -478,7 +489,7 @@ void DeferredRenderer::renderLighting(const std::vector<std::vector<Renderable>>
 	UINT sampleMask = 0xffffffff;
 	if(m_ShadowMap)
 	{
-		renderShadowMap(*m_ShadowMappedLight, p_InstancedModels, p_AnimatedOrSingle);
+		renderShadowMap(*m_ShadowMappedLight);
 	}
 	//Set constant data
 	m_Buffer["DefaultConstant"]->setBuffer(0);
@@ -537,6 +548,11 @@ void DeferredRenderer::addRenderable(Renderable p_renderable)
 	m_Objects.push_back(p_renderable);
 }
 
+void DeferredRenderer::resetModelIds(void)
+{
+	m_Queue.resetIds();
+}
+
 void DeferredRenderer::createSkyDome(ID3D11ShaderResourceView* p_Texture, float p_Radius)
 {
 	if(m_SkyDome)
@@ -585,11 +601,20 @@ void DeferredRenderer::FOVIsUpdated()
 	m_FOVIsUpdated = true;
 }
 
-void DeferredRenderer::updateConstantBuffer(DirectX::XMFLOAT4X4 p_ViewMatrix, DirectX::XMFLOAT4X4 p_ProjMatrix)
+unsigned int DeferredRenderer::getViewFrustums(Frustum p_Frustums[NUM_VIEWS]) const
 {
-	m_CurrentView = p_ViewMatrix;
-	m_CurrentProjection = p_ProjMatrix;
+	p_Frustums[CAMERA_VIEW] = Frustum(*m_ViewMatrix, *m_ProjectionMatrix);
+	if(!m_ShadowMap || !m_ShadowMappedLight)
+		return 1;
+
+	const XMFLOAT3& direction = m_ShadowMappedLight->lightDirection;
+	p_Frustums[SHADOW_BIG_VIEW] = ShadowMapView::createFrustum(m_CameraPosition, direction, m_ShadowBigSize);
+	p_Frustums[SHADOW_SMALL_VIEW] = ShadowMapView::createFrustum(m_CameraPosition, direction, m_ShadowSmallSize);
+	return NUM_VIEWS;
+}
 
+void DeferredRenderer::updateConstantBuffer(DirectX::XMFLOAT4X4 p_ViewMatrix, DirectX::XMFLOAT4X4 p_ProjMatrix)
+{
 	cBuffer cb;
 	cb.view = p_ViewMatrix;
 	cb.proj = p_ProjMatrix;
@@ -901,6 +926,25 @@ void DeferredRenderer::createShaders()
 	m_Shader["ShadowMapGeometry"] = WrapperFactory::getInstance()->createShader(L"assets/shaders/ShadowMapGeometry.hlsl", nullptr,
 		"VS,PS", "5_0", ShaderType::VERTEX_SHADER| ShaderType::PIXEL_SHADER, instanceshaderDesc, 9); 
 
+	ShaderInputElementDescription compactInstanceDesc[] = 
+	{
+		{"POSITION",0, Format::R16G16B16A16_UNORM, 0, 0,D3D11_INPUT_PER_VERTEX_DATA, 0},
+		{"NORMAL",	0, Format::R16G16_SNORM, 0, 8,		D3D11_INPUT_PER_VERTEX_DATA, 0},
+		{"TANGENT",	0, Format::R16G16_SNORM, 0, 12,		D3D11_INPUT_PER_VERTEX_DATA, 0},
+		{"COORD",	0, Format::R16G16_FLOAT, 0, 16,		D3D11_INPUT_PER_VERTEX_DATA, 0},
+		{"WORLD", 0, Format::R32G32B32A32_FLOAT, 1, 0,	D3D10_INPUT_PER_INSTANCE_DATA, 1},
+		{"WORLD", 1, Format::R32G32B32A32_FLOAT, 1, 16, D3D10_INPUT_PER_INSTANCE_DATA, 1},
+		{"WORLD", 2, Format::R32G32B32A32_FLOAT, 1, 32, D3D10_INPUT_PER_INSTANCE_DATA, 1},
+		{"WORLD", 3, Format::R32G32B32A32_FLOAT, 1, 48, D3D10_INPUT_PER_INSTANCE_DATA, 1},
+	};
+	D3D_SHADER_MACRO compactDefine[2] = {{ "COMPACT_VERTEX", "1" }, nullptr };
+
+	m_Shader["IGeometryCompact"] = WrapperFactory::getInstance()->createShader(L"assets/shaders/GeoInstanceShader.hlsl", compactDefine,
+		"VS,PS", "5_0",ShaderType::VERTEX_SHADER | ShaderType::PIXEL_SHADER, compactInstanceDesc, 8);
+
+	m_Shader["ShadowMapGeometryCompact"] = WrapperFactory::getInstance()->createShader(L"assets/shaders/ShadowMapGeometry.hlsl",
+		compactDefine, "VS,PS", "5_0", ShaderType::VERTEX_SHADER| ShaderType::PIXEL_SHADER, compactInstanceDesc, 8);
+
 	m_Shader["SSAO"] = WrapperFactory::getInstance()->createShader(L"assets/shaders/SSAO.hlsl",
 		"VS,PS", "5_0",ShaderType::VERTEX_SHADER | ShaderType::PIXEL_SHADER);
 
@@ -918,16 +962,31 @@ void DeferredRenderer::createShaders()
 	recompileFogShader();
 }
 
+static std::vector<DirectX::XMFLOAT3> getLightModelTriangles(const ModelBinaryLoader& p_Loader)
+{
+	// The light volumes are drawn without an index buffer, so indexed models are expanded
+	const std::vector<DirectX::XMFLOAT3> positions = p_Loader.getPositions();
+	std::vector<unsigned int> indices = p_Loader.getIndices();
+	if (indices.empty())
+	{
+		for(unsigned int i = 0; i < positions.size(); i++)
+			indices.push_back(i);
+	}
+
+	std::vector<DirectX::XMFLOAT3> triangles;
+	triangles.reserve(indices.size());
+	for(unsigned int index : indices)
+	{
+		triangles.push_back(positions.at(index));
+	}
+	return triangles;
+}
+
 void DeferredRenderer::loadLightModels()
 {
 	ModelBinaryLoader modelLoader;
 	modelLoader.loadBinaryFile("assets/LightModels/SpotLight.btx");
-	const std::vector<StaticVertex>& vertices = modelLoader.getStaticVertexBuffer();
-	std::vector<DirectX::XMFLOAT3> temp;
-	for(unsigned int i = 0; i < vertices.size(); i++)
-	{
-		temp.push_back(DirectX::XMFLOAT3(vertices.at(i).m_Position.x,vertices.at(i).m_Position.y,vertices.at(i).m_Position.z));
-	}
+	std::vector<DirectX::XMFLOAT3> temp = getLightModelTriangles(modelLoader);
 
 	Buffer::Description cbdesc;
 	cbdesc.initData = temp.data();
@@ -940,10 +999,7 @@ void DeferredRenderer::loadLightModels()
 	m_Buffer["SpotLightModel"] = WrapperFactory::getInstance()->createBuffer(cbdesc);
 	temp.clear();
 	modelLoader.loadBinaryFile("assets/LightModels/Sphere2.btx");
-	for(unsigned int i = 0; i < vertices.size(); i++)
-	{
-		temp.push_back(DirectX::XMFLOAT3(vertices.at(i).m_Position.x,vertices.at(i).m_Position.y,vertices.at(i).m_Position.z));
-	}
+	temp = getLightModelTriangles(modelLoader);
 
 	cbdesc.initData = temp.data();
 	cbdesc.numOfElements = temp.size();
@@ -1092,21 +1148,25 @@ void DeferredRenderer::createRandomTexture(unsigned int p_Size)
 	SAFE_RELEASE(texture);
 }
 
-void DeferredRenderer::renderObject(const Renderable &p_Object)
+void DeferredRenderer::renderObject(const Renderable &p_Object, View p_View)
 {
-	if (!isVisible(p_Object))
+	if (!(p_Object.visibleViews & (1 << p_View)))
 		return;
 
 	p_Object.model->vertexBuffer->setBuffer(0);
+	if (p_Object.model->indexBuffer)
+		p_Object.model->indexBuffer->setBuffer(0);
+	if (p_Object.model->vertexBoundsBuffer)
+		p_Object.model->vertexBoundsBuffer->setBuffer(4);
 
 	if (p_Object.model->isAnimated)
 	{
 		cAnimatedObjectBuffer temp;
 		temp.invTransposeWorld = p_Object.invTransposeWorld;
 
-		const std::vector<DirectX::XMFLOAT4X4>* tempBones = p_Object.finalTransforms;
-		for (unsigned int a = 0; a < tempBones->size(); a++)
-			temp.boneTransform[a] = (*tempBones)[a];
+		const DirectX::XMFLOAT4X4* tempBones = p_Object.finalTransforms;
+		for (unsigned int a = 0; a < p_Object.numFinalTransforms; a++)
+			temp.boneTransform[a] = tempBones[a];
 
 		m_DeviceContext->UpdateSubresource(m_Buffer["AnimatedConstant"]->getBufferPointer(), NULL,NULL, &temp,NULL,NULL);
 	}
@@ -1128,76 +1188,56 @@ void DeferredRenderer::renderObject(const Renderable &p_Object)
 		};
 		m_DeviceContext->PSSetShaderResources(0, 3, srvs);
 
-
-		m_DeviceContext->Draw(material.numOfVertices, material.vertexStart);
+		if (p_Object.model->indexBuffer)
+			m_DeviceContext->DrawIndexed(material.numOfVertices, material.vertexStart, material.baseVertex);
+		else
+			m_DeviceContext->Draw(material.numOfVertices, material.vertexStart);
 	}
 
 	p_Object.model->shader->setBlendState(0, data);
 	p_Object.model->shader->unSetShader();
 	p_Object.model->vertexBuffer->unsetBuffer(0);
+	if (p_Object.model->indexBuffer)
+		p_Object.model->indexBuffer->unsetBuffer(0);
+	if (p_Object.model->vertexBoundsBuffer)
+		p_Object.model->vertexBoundsBuffer->unsetBuffer(4);
 }
 
-void DeferredRenderer::SortRenderables( std::vector<Renderable> &animatedOrSingle, std::vector<std::vector<Renderable>> &instancedModels )
+void DeferredRenderer::SortRenderables(void)
 {
-	std::sort(m_Objects.begin(),m_Objects.end(), [] (Renderable &a, Renderable &b)
-	{ 
-		return a.model > b.model;
-	});
+	m_Queue.clear();
 
-	for(unsigned int i = 0; i < m_Objects.size(); i++)
+	const XMVECTOR eye = XMLoadFloat3(&m_CameraPosition);
+	for(const auto& object : m_Objects)
 	{
-		if(m_Objects.at(i).model->isAnimated)
-			animatedOrSingle.push_back(std::move(m_Objects.at(i)));
-		else
-		{
-			std::vector<Renderable> l;
-			int current = i;
-			int nr = 0;
-			for(unsigned int j = i + 1; j < m_Objects.size();j++)
-				if(m_Objects.at(current).model == m_Objects.at(j).model)
-					nr++;
-				else
-					break;
-
-			i += nr;
-
-			if(nr >= 1)
-			{
-				l.reserve(nr);
-				std::move(m_Objects.begin() + current, m_Objects.begin() + i + 1, std::back_inserter(l));
-				instancedModels.push_back(l);
-			}
-			else
-				animatedOrSingle.push_back(std::move(m_Objects.at(current)));
-		}
-	}
-
-	std::sort(animatedOrSingle.begin(), animatedOrSingle.end(), [&](Renderable &a, Renderable &b)
-		{
-			DirectX::XMFLOAT3 aa = DirectX::XMFLOAT3(a.world._14,a.world._24,a.world._34);
-			DirectX::XMFLOAT3 bb = DirectX::XMFLOAT3(b.world._14,b.world._24,b.world._34);
+		const XMVECTOR position = XMVectorSet(object.world._14, object.world._24, object.world._34, 1.f);
+		const float depth = XMVectorGetX(XMVector3Length(XMVectorSubtract(position, eye))) / m_FarZ;
 
-			DirectX::XMVECTOR aV = DirectX::XMLoadFloat3(&aa);
-			DirectX::XMVECTOR bV = DirectX::XMLoadFloat3(&bb);
-			DirectX::XMVECTOR eV = DirectX::XMLoadFloat3(&m_CameraPosition);
-
-			using DirectX::operator -;
-			DirectX::XMVECTOR aVeVLength = DirectX::XMVector3Length(aV - eV);
-			DirectX::XMVECTOR bVeVLength = DirectX::XMVector3Length(bV - eV);
+		// Nearest first within each group, so that the depth test rejects more
+		m_Queue.add(m_Queue.createKey(object.model->isAnimated ? ANIMATED_PASS : STATIC_PASS,
+			object.model->shader, object.materialSet, object.model, depth));
+	}
 
-			return aVeVLength.m128_f32[0] > bVeVLength.m128_f32[0];
-	});
+	m_Queue.sort();
 }
 
-void DeferredRenderer::RenderObjectsInstanced(const std::vector<Renderable> &p_Objects, Shader* p_Shader)
+void DeferredRenderer::RenderObjectsInstanced(unsigned int p_RunStart, unsigned int p_RunEnd, Shader* p_Shader, Shader* p_CompactShader,
+	View p_View)
 {
-	if(p_Objects.size() >  m_Buffer["WorldInstance"]->getNumOfElements())
+	const std::vector<unsigned int>& order = m_Queue.getOrder();
+	const Renderable& first = m_Objects[order[p_RunStart]];
+	const unsigned int numObjects = p_RunEnd - p_RunStart;
+	const std::unique_ptr<Buffer>& boundsBuffer = first.model->vertexBoundsBuffer;
+	if (boundsBuffer)
+		p_Shader = p_CompactShader;
+
+	if(numObjects >  m_Buffer["WorldInstance"]->getNumOfElements())
 	{
 		VRAMInfo::getInstance()->updateUsage(sizeof(DirectX::XMFLOAT4X4) * m_Buffer["WorldInstance"]->getNumOfElements() * -1);
 		SAFE_DELETE(m_Buffer["WorldInstance"]);
 		Buffer::Description instanceWorldDesc;
 		instanceWorldDesc.initData = nullptr;
-		instanceWorldDesc.numOfElements = p_Objects.size() + 5;
+		instanceWorldDesc.numOfElements = numObjects + 5;
 		instanceWorldDesc.sizeOfElement = sizeof(DirectX::XMFLOAT4X4);
 		instanceWorldDesc.type = Buffer::Type::VERTEX_BUFFER;
 		instanceWorldDesc.usage = Buffer::Usage::CPU_WRITE_DISCARD;
@@ -1206,8 +1246,8 @@ void DeferredRenderer::RenderObjectsInstanced(const std::vector<Renderable> &p_O
 	}
 
 	UINT Offsets[2] = {0,0};
-	ID3D11Buffer * buffers[] = {p_Objects.front().model->vertexBuffer->getBufferPointer(), m_Buffer["WorldInstance"]->getBufferPointer()};
-	UINT Stride[2] = {60, sizeof(DirectX::XMFLOAT4X4)};
+	ID3D11Buffer * buffers[] = {first.model->vertexBuffer->getBufferPointer(), m_Buffer["WorldInstance"]->getBufferPointer()};
+	UINT Stride[2] = {first.model->vertexBuffer->getSizeOfElement(), sizeof(DirectX::XMFLOAT4X4)};
 
 	ID3D11ShaderResourceView *nullsrvs[] = {0,0,0};
 
@@ -1216,6 +1256,11 @@ void DeferredRenderer::RenderObjectsInstanced(const std::vector<Renderable> &p_O
 	float data[] = { 1.0f, 1.0f, 1.f, 1.0f};
 	p_Shader->setBlendState(m_BlendState2, data);
 	m_DeviceContext->IASetVertexBuffers(0,2,buffers,Stride, Offsets);
+	const std::unique_ptr<Buffer>& indexBuffer = first.model->indexBuffer;
+	if (indexBuffer)
+		indexBuffer->setBuffer(0);
+	if (boundsBuffer)
+		boundsBuffer->setBuffer(4);
 
 	D3D11_MAPPED_SUBRESOURCE ms;
 
@@ -1223,51 +1268,58 @@ void DeferredRenderer::RenderObjectsInstanced(const std::vector<Renderable> &p_O
 
 	XMFLOAT4X4 *ptr = (XMFLOAT4X4 *)ms.pData;
 	size_t numVisible = 0;
-	for(unsigned int j = 0; j < p_Objects.size(); j++)
+	for(unsigned int j = p_RunStart; j < p_RunEnd; j++)
 	{
-		if (!isVisible(p_Objects[j]))
+		const Renderable& object = m_Objects[order[j]];
+		if (!(object.visibleViews & (1 << p_View)))
 			continue;
 
-		ptr[numVisible] = p_Objects[j].world;
+		ptr[numVisible] = object.world;
 		++numVisible;
 	}
 
 	m_DeviceContext->Unmap(m_Buffer["WorldInstance"]->getBufferPointer(), NULL);
 
-	const auto& materialSet = p_Objects.front().model->materialSets[p_Objects.front().materialSet].second;
+	const auto& materialSet = first.model->materialSets[first.materialSet].second;
 	for(const auto& material : materialSet)
 	{
 		ID3D11ShaderResourceView *srvs[] =  {
-			p_Objects.front().model->diffuseTexture[material.textureIndex].second, 
-			p_Objects.front().model->normalTexture[material.textureIndex].second, 
-			p_Objects.front().model->specularTexture[material.textureIndex].second 
+			first.model->diffuseTexture[material.textureIndex].second, 
+			first.model->normalTexture[material.textureIndex].second, 
+			first.model->specularTexture[material.textureIndex].second 
 		};
 		m_DeviceContext->PSSetShaderResources(0, 3, srvs);
 		
-		m_DeviceContext->DrawInstanced(material.numOfVertices, numVisible, material.vertexStart,0);
+		if (indexBuffer)
+			m_DeviceContext->DrawIndexedInstanced(material.numOfVertices, numVisible, material.vertexStart, material.baseVertex, 0);
+		else
+			m_DeviceContext->DrawInstanced(material.numOfVertices, numVisible, material.vertexStart,0);
 		
 		m_DeviceContext->PSSetShaderResources(0, 3, nullsrvs);
 	}
 
 	ID3D11Buffer* nullBuffers[] = { nullptr, nullptr };
 	m_DeviceContext->IASetVertexBuffers(0, 2, nullBuffers, Stride, Offsets);
+	if (indexBuffer)
+		indexBuffer->unsetBuffer(0);
+	if (boundsBuffer)
+		boundsBuffer->unsetBuffer(4);
 	p_Shader->setBlendState(0, data);
 	p_Shader->unSetShader();
 }
 
 void DeferredRenderer::updateLightView(DirectX::XMFLOAT3 p_Dir)
 {
-	XMVECTOR pos = XMVectorSet(m_CameraPosition.x, m_CameraPosition.y, m_CameraPosition.z, 1.f);
-	XMStoreFloat4x4(&m_LightView, XMMatrixTranspose(XMMatrixLookToLH(pos, XMVectorSet(p_Dir.x, p_Dir.y, p_Dir.z ,0.0f) , XMVectorSet(0, 1, 0, 0))));
+	m_LightView = ShadowMapView::createView(m_CameraPosition, p_Dir);
 }
 
 void DeferredRenderer::updateLightProjection(float p_viewHW)
 {
 	m_ViewHW = p_viewHW; // size of viewHeight and viewWidth
-	XMStoreFloat4x4(&m_LightProjection, XMMatrixTranspose(XMMatrixOrthographicLH(m_ViewHW, m_ViewHW, -20000.f, 20000)));
+	m_LightProjection = ShadowMapView::createProjection(m_ViewHW);
 }
 
-void DeferredRenderer::renderShadowMap(Light p_Directional, const std::vector<std::vector<Renderable>> &p_InstancedModels, const std::vector<Renderable> &p_AnimatedOrSingle)
+void DeferredRenderer::renderShadowMap(Light p_Directional)
 {
 	ID3D11DepthStencilState* previousDepthState;
 	m_DeviceContext->OMGetDepthStencilState(&previousDepthState,0);
@@ -1303,7 +1355,8 @@ void DeferredRenderer::renderShadowMap(Light p_Directional, const std::vector<st
 		//update and render Shadow map
 		updateConstantBuffer(m_LightView, m_LightProjection);
 
-		renderGeometry(m_DepthMapDSV, nrRT, &noRTV, p_InstancedModels, p_AnimatedOrSingle, m_Shader["ShadowMapGeometry"]);
+		renderGeometry(m_DepthMapDSV, nrRT, &noRTV, m_Shader["ShadowMapGeometry"], m_Shader["ShadowMapGeometryCompact"],
+			j == 0 ? SHADOW_BIG_VIEW : SHADOW_SMALL_VIEW);
 
 		m_DeviceContext->RSSetViewports(1, &prevViewport);
 
@@ -1471,49 +1524,3 @@ void DeferredRenderer::recompileFogShader(void)
 	SAFE_DELETE(m_Shader["DistanceFog"]);
 	m_Shader["DistanceFog"] = tempFogShader;
 }
-
-bool DeferredRenderer::isVisible(const Renderable& p_Object) const
-{
-	XMMATRIX world = XMLoadFloat4x4(&p_Object.world);
-	XMMATRIX view = XMLoadFloat4x4(&m_CurrentView);
-	XMMATRIX proj = XMLoadFloat4x4(&m_CurrentProjection);
-	XMMATRIX projWorldView = XMMatrixTranspose(proj * view * world);
-
-	std::array<XMVECTOR, 8> corners;
-	size_t i = 0;
-	for (const auto& corner : p_Object.model->boundingVolume)
-	{
-		corners[i] = XMVector4Transform(XMVectorSetW(XMLoadFloat3(&corner), 1.f), projWorldView);
-		corners[i] /= corners[i].m128_f32[3];
-
-		++i;
-	}
-
-	static const std::tuple<int, float, float> planes[] =
-	{
-		std::make_tuple(0, 4.f, 1.f),
-		std::make_tuple(0, 4.f, -1.f),
-		std::make_tuple(1, 4.f, 1.f),
-		std::make_tuple(1, 4.f, -1.f),
-		std::make_tuple(2, 4.f, 1.f),
-		std::make_tuple(2, 0.f, -1.f)
-	};
-
-	for (const auto& plane : planes)
-	{
-		bool outside = true;
-		for (const auto& corner : corners)
-		{
-			if (corner.m128_f32[std::get<0>(plane)] * std::get<2>(plane) <= std::get<1>(plane))
-			{
-				outside = false;
-				break;
-			}
-		}
-
-		if (outside)
-			return false;
-	}
-
-	return true;
-}
@@ -4,6 +4,8 @@
 #include "Renderable.h"
 #include "SkyDome.h"
 #include "ConstantBuffers.h"
+#include "Frustum.h"
+#include "RenderQueue.h"
 //#include "GPUTimer.h"
 
 #include <d3d11.h>
@@ -13,7 +15,29 @@
 
 class DeferredRenderer
 {
+public:
+	/**
+	 * The views the geometry is rendered from each frame, used as bit
+	 * numbers in Renderable::visibleViews.
+	 */
+	enum View
+	{
+		CAMERA_VIEW,
+		SHADOW_BIG_VIEW,
+		SHADOW_SMALL_VIEW,
+		NUM_VIEWS
+	};
+
 private:
+	/**
+	 * Passes stored in the render queue keys.
+	 */
+	enum GeometryPass
+	{
+		ANIMATED_PASS,
+		STATIC_PASS,
+	};
+
 	float *m_FOV;
 	float m_FarZ;
 	float m_ScreenWidth;
@@ -24,6 +48,7 @@ private:
 	ID3D11DepthStencilView	*m_DepthStencilView;
 
 	std::vector<Renderable>	m_Objects;
+	RenderQueue				m_Queue;
 	std::vector<Light>		*m_SpotLights;
 	std::vector<Light>		*m_PointLights;
 	std::vector<Light>		*m_DirectionalLights;
@@ -63,9 +88,6 @@ private:
 	UINT m_Width;
 	UINT m_Height;
 
-	DirectX::XMFLOAT4X4	m_CurrentView;
-	DirectX::XMFLOAT4X4	m_CurrentProjection;
-
 	float				m_ViewHW;
 	DirectX::XMFLOAT4X4	m_LightView;
 	DirectX::XMFLOAT4X4	m_LightProjection;
@@ -129,6 +151,12 @@ public:
 	 */
 	void addRenderable(Renderable p_Renderable);
 
+	/*
+	 * Forget the models seen when sorting the renderables, call when a model is released
+	 * so that a later model at the same address is not drawn as the released one.
+	 */
+	void resetModelIds(void);
+
 	/*
 	 * Add models to the list of objects to be rendered with deferred rendering.
 	 * @ p_Texture, the texture for the skydome
@@ -159,9 +187,20 @@ public:
 	 */
 	void FOVIsUpdated();
 
+	/**
+	 * Get the frustums of the views that will be rendered this frame, to cull
+	 * renderables before they are added. Call after the camera and the frame's
+	 * lights have been set. The shadow views of a light that has not been set
+	 * contain everything.
+	 *
+	 * @param p_Frustums filled with the frustums, indexed by View
+	 * @return the number of views in use, CAMERA_VIEW only if shadows are disabled
+	 */
+	unsigned int getViewFrustums(Frustum p_Frustums[NUM_VIEWS]) const;
+
 private:
 	void renderGeometry(ID3D11DepthStencilView* p_DepthStencilView, unsigned int nrRT, ID3D11RenderTargetView* rtv[],
-		const std::vector<std::vector<Renderable>> &p_InstancedModels, const std::vector<Renderable> &p_AnimatedOrSingle, Shader* p_Shader);
+		Shader* p_Shader, Shader* p_CompactShader, View p_View);
 	void renderSSAO(void);
 	void blurSSAO(void);
 	void SSAO_PingPong(ID3D11ShaderResourceView*, ID3D11RenderTargetView*, bool p_HorizontalBlur);
@@ -172,7 +211,7 @@ private:
 	void clearRenderTargets(unsigned int nrRT);
 
 
-	void renderLighting(const std::vector<std::vector<Renderable>> &p_InstancedModels, const std::vector<Renderable> &p_AnimatedOrSingle);
+	void renderLighting(void);
 	void renderSkyDomeImpl();
 
 
@@ -197,15 +236,14 @@ private:
 	void createRandomTexture(unsigned int p_Size);
 
 
-	void renderObject(const Renderable &p_Object);
-	void SortRenderables( std::vector<Renderable> &animatedOrSingle, std::vector<std::vector<Renderable>> &instancedModels );
-	void RenderObjectsInstanced(const std::vector<Renderable> &p_Objects, Shader* p_Shader);
+	void renderObject(const Renderable &p_Object, View p_View);
+	void SortRenderables(void);
+	void RenderObjectsInstanced(unsigned int p_RunStart, unsigned int p_RunEnd, Shader* p_Shader, Shader* p_CompactShader,
+		View p_View);
 
 	void updateLightView(DirectX::XMFLOAT3 p_Dir);
 	void updateLightProjection(float p_viewHW);
-	void renderShadowMap(Light p_Directional, const std::vector<std::vector<Renderable>> &p_InstancedModels, const std::vector<Renderable> &p_AnimatedOrSingle);
+	void renderShadowMap(Light p_Directional);
 	void registerTweakSettings();
 	void recompileFogShader(void);
-
-	bool isVisible(const Renderable& p_Object) const;
 };
\ No newline at end of file
@@ -272,15 +272,19 @@ void ForwardRendering::renderObject(Renderable& p_Object)
 	m_ConstantBuffer->setBuffer(1);
 	m_DeviceContext->PSSetSamplers(0,1,&m_Sampler);
 	p_Object.model->vertexBuffer->setBuffer(0);
+	if (p_Object.model->indexBuffer)
+		p_Object.model->indexBuffer->setBuffer(0);
+	if (p_Object.model->vertexBoundsBuffer)
+		p_Object.model->vertexBoundsBuffer->setBuffer(4);
 
 	if (p_Object.model->isAnimated)
 	{
 		cAnimatedObjectBuffer temp;
 		temp.invTransposeWorld = p_Object.invTransposeWorld;
 
-		const std::vector<DirectX::XMFLOAT4X4>* tempBones = p_Object.finalTransforms;
-		for (unsigned int a = 0; a < tempBones->size(); a++)
-			temp.boneTransform[a] = (*tempBones)[a];
+		const DirectX::XMFLOAT4X4* tempBones = p_Object.finalTransforms;
+		for (unsigned int a = 0; a < p_Object.numFinalTransforms; a++)
+			temp.boneTransform[a] = tempBones[a];
 
 		m_DeviceContext->UpdateSubresource(m_AnimatedObjectConstantBuffer->getBufferPointer(), NULL,NULL, &temp,NULL,NULL);
 		m_AnimatedObjectConstantBuffer->setBuffer(3);
@@ -313,7 +317,10 @@ void ForwardRendering::renderObject(Renderable& p_Object)
 		};
 		m_DeviceContext->PSSetShaderResources(0, 3, srvs);
 
-		m_DeviceContext->Draw(material.numOfVertices, material.vertexStart);
+		if (p_Object.model->indexBuffer)
+			m_DeviceContext->DrawIndexed(material.numOfVertices, material.vertexStart, material.baseVertex);
+		else
+			m_DeviceContext->Draw(material.numOfVertices, material.vertexStart);
 
 		// The textures will be needed to be grabbed from the model later.
 		static ID3D11ShaderResourceView * const nullsrvs[] = {NULL,NULL,NULL};
@@ -326,6 +333,10 @@ void ForwardRendering::renderObject(Renderable& p_Object)
 	m_ObjectConstantBuffer->unsetBuffer(2);
 	m_AnimatedObjectConstantBuffer->unsetBuffer(3);
 	p_Object.model->vertexBuffer->unsetBuffer(0);
+	if (p_Object.model->indexBuffer)
+		p_Object.model->indexBuffer->unsetBuffer(0);
+	if (p_Object.model->vertexBoundsBuffer)
+		p_Object.model->vertexBoundsBuffer->unsetBuffer(4);
 	m_ColorShadingConstantBuffer->unsetBuffer(3);
 	ID3D11SamplerState* noState = nullptr;
 	m_DeviceContext->PSSetSamplers(0, 1, &noState);
@@ -0,0 +1,104 @@
+#include "Frustum.h"
+
+using namespace DirectX;
+
+Frustum::Frustum()
+{
+	for (int i = 0; i < 2; ++i)
+	{
+		m_PlaneX[i] = XMFLOAT4(0.f, 0.f, 0.f, 0.f);
+		m_PlaneY[i] = XMFLOAT4(0.f, 0.f, 0.f, 0.f);
+		m_PlaneZ[i] = XMFLOAT4(0.f, 0.f, 0.f, 0.f);
+		m_PlaneW[i] = XMFLOAT4(1.f, 1.f, 1.f, 1.f);
+	}
+}
+
+Frustum::Frustum(const XMFLOAT4X4& p_View, const XMFLOAT4X4& p_Projection)
+{
+	// The stored matrices are transposed, so the rows of the product are
+	// the rows of the clip space transform for column vectors.
+	XMFLOAT4X4 clip;
+	XMStoreFloat4x4(&clip, XMLoadFloat4x4(&p_Projection) * XMLoadFloat4x4(&p_View));
+
+	XMFLOAT4 planes[6];
+	for (int i = 0; i < 3; ++i)
+	{
+		// Left, bottom and near use w + x, w + y and z (Direct3D depth starts at 0)
+		const float sign = i == 2 ? 0.f : 1.f;
+		planes[i * 2] = XMFLOAT4(
+			clip.m[3][0] * sign + clip.m[i][0],
+			clip.m[3][1] * sign + clip.m[i][1],
+			clip.m[3][2] * sign + clip.m[i][2],
+			clip.m[3][3] * sign + clip.m[i][3]);
+		planes[i * 2 + 1] = XMFLOAT4(
+			clip.m[3][0] - clip.m[i][0],
+			clip.m[3][1] - clip.m[i][1],
+			clip.m[3][2] - clip.m[i][2],
+			clip.m[3][3] - clip.m[i][3]);
+	}
+
+	for (int i = 0; i < 2; ++i)
+	{
+		const XMFLOAT4* group[4];
+		for (int j = 0; j < 4; ++j)
+		{
+			group[j] = &planes[(std::min)(i * 4 + j, 5)];
+		}
+
+		m_PlaneX[i] = XMFLOAT4(group[0]->x, group[1]->x, group[2]->x, group[3]->x);
+		m_PlaneY[i] = XMFLOAT4(group[0]->y, group[1]->y, group[2]->y, group[3]->y);
+		m_PlaneZ[i] = XMFLOAT4(group[0]->z, group[1]->z, group[2]->z, group[3]->z);
+		m_PlaneW[i] = XMFLOAT4(group[0]->w, group[1]->w, group[2]->w, group[3]->w);
+	}
+}
+
+Frustum::Result Frustum::test(const BoundingBox& p_Box) const
+{
+	const XMVECTOR half = XMVectorReplicate(0.5f);
+	const XMVECTOR boxMin = XMLoadFloat3(&p_Box.min);
+	const XMVECTOR boxMax = XMLoadFloat3(&p_Box.max);
+	const XMVECTOR center = XMVectorMultiply(XMVectorAdd(boxMin, boxMax), half);
+	const XMVECTOR extents = XMVectorMultiply(XMVectorSubtract(boxMax, boxMin), half);
+
+	const XMVECTOR centerX = XMVectorSplatX(center);
+	const XMVECTOR centerY = XMVectorSplatY(center);
+	const XMVECTOR centerZ = XMVectorSplatZ(center);
+	const XMVECTOR extentX = XMVectorSplatX(extents);
+	const XMVECTOR extentY = XMVectorSplatY(extents);
+	const XMVECTOR extentZ = XMVectorSplatZ(extents);
+	const XMVECTOR zero = XMVectorZero();
+
+	bool inside = true;
+	for (int i = 0; i < 2; ++i)
+	{
+		const XMVECTOR planeX = XMLoadFloat4(&m_PlaneX[i]);
+		const XMVECTOR planeY = XMLoadFloat4(&m_PlaneY[i]);
+		const XMVECTOR planeZ = XMLoadFloat4(&m_PlaneZ[i]);
+
+		// Signed distance from the box center to each plane, scaled by the normal length
+		XMVECTOR distance = XMLoadFloat4(&m_PlaneW[i]);
+		distance = XMVectorMultiplyAdd(planeX, centerX, distance);
+		distance = XMVectorMultiplyAdd(planeY, centerY, distance);
+		distance = XMVectorMultiplyAdd(planeZ, centerZ, distance);
+
+		// Projected radius of the box onto each normal
+		XMVECTOR radius = XMVectorMultiply(XMVectorAbs(planeX), extentX);
+		radius = XMVectorMultiplyAdd(XMVectorAbs(planeY), extentY, radius);
+		radius = XMVectorMultiplyAdd(XMVectorAbs(planeZ), extentZ, radius);
+
+		if (!XMComparisonAllTrue(XMVector4GreaterOrEqualR(XMVectorAdd(distance, radius), zero)))
+			return Result::OUTSIDE;
+
+		if (!XMComparisonAllTrue(XMVector4GreaterOrEqualR(XMVectorSubtract(distance, radius), zero)))
+		{
+			inside = false;
+		}
+	}
+
+	return inside ? Result::INSIDE : Result::INTERSECTS;
+}
+
+bool Frustum::isVisible(const BoundingBox& p_Box) const
+{
+	return test(p_Box) != Result::OUTSIDE;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "BoundingBox.h"
+
+#include <DirectXMath.h>
+
+/**
+ * The volume seen by a camera or a shadow casting light, as six planes.
+ */
+class Frustum
+{
+public:
+	enum class Result
+	{
+		OUTSIDE,
+		INTERSECTS,
+		INSIDE,
+	};
+
+private:
+	/**
+	 * The plane equations stored one component per vector, four planes at a time,
+	 * so that a box is tested against four planes with a few vector operations.
+	 * The normals point into the frustum. The second group repeats the last plane.
+	 */
+	DirectX::XMFLOAT4 m_PlaneX[2];
+	DirectX::XMFLOAT4 m_PlaneY[2];
+	DirectX::XMFLOAT4 m_PlaneZ[2];
+	DirectX::XMFLOAT4 m_PlaneW[2];
+
+public:
+	/**
+	 * Create a frustum containing everything.
+	 */
+	Frustum();
+
+	/**
+	 * Create the frustum of a view.
+	 *
+	 * @param p_View a transposed view matrix, as stored for the shaders
+	 * @param p_Projection a transposed projection matrix, as stored for the shaders
+	 */
+	Frustum(const DirectX::XMFLOAT4X4& p_View, const DirectX::XMFLOAT4X4& p_Projection);
+
+	/**
+	 * Test a world space box against the frustum.
+	 *
+	 * Boxes close to a corner of the frustum may be reported as intersecting
+	 * even though they are outside, but never the other way around.
+	 */
+	Result test(const BoundingBox& p_Box) const;
+
+	/**
+	 * @return true if any part of the box may be visible
+	 */
+	bool isVisible(const BoundingBox& p_Box) const;
+};
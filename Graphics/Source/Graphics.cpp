@@ -18,6 +18,11 @@ using std::make_pair;
 typedef vector<pair<IGraphics::Object2D_Id, Renderable2D>>::iterator Renderable2DIterator;
 typedef vector<pair<IGraphics::InstanceId, ModelInstance>>::iterator ModelInstanceIterator;
 
+static BoundingBox getModelBounds(const ModelDefinition& p_Model)
+{
+	return BoundingBox::fromPoints(p_Model.boundingVolume.data(), p_Model.boundingVolume.size());
+}
+
 Graphics::Graphics(void)
 {
 	m_Device = nullptr;
@@ -45,8 +50,8 @@ Graphics::Graphics(void)
 	m_ConstantBuffer = nullptr;
 	m_BVBuffer = nullptr;
 	m_VSyncEnabled = false; //DEBUG
-	m_NextInstanceId = 1;
 	m_Next2D_ObjectId = 1;
+	m_RenderAllModels = false;
 	m_NextParticleInstanceId = 1;
 	m_SelectedRenderTarget = IGraphics::RenderTarget::FINAL;
 }
@@ -362,10 +367,21 @@ void IGraphics::deleteGraphics(IGraphics *p_Graphics)
 
 bool Graphics::createModel(const char *p_ModelId, const char *p_Filename)
 {
-	m_ModelList.insert(pair<string, ModelDefinition>(p_ModelId, std::move(m_ModelFactory->getInstance()->createModel(p_Filename))));
+	auto result = m_ModelList.insert(pair<string, ModelDefinition>(p_ModelId, std::move(m_ModelFactory->getInstance()->createModel(p_Filename))));
+	m_ModelScene.attachModel(p_ModelId, &result.first->second, getModelBounds(result.first->second));
 	return true;
 }
 
+void Graphics::preloadModel(const char *p_Filename, loadModelTextureCallBack p_TextureFound, void *p_Userdata)
+{
+	m_ModelFactory->getInstance()->preloadModel(p_Filename, p_TextureFound, p_Userdata);
+}
+
+void Graphics::discardPreloadedModel(const char *p_Filename)
+{
+	m_ModelFactory->getInstance()->discardPreloadedModel(p_Filename);
+}
+
 bool Graphics::releaseModel(const char* p_ResourceName)
 {
 	std::string resourceName(p_ResourceName);
@@ -384,7 +400,10 @@ bool Graphics::releaseModel(const char* p_ResourceName)
 				m_ReleaseModelTexture(tex.first.c_str(), m_ReleaseModelTextureUserdata);
 		}
 
+		m_ModelScene.detachModel(&model);
 		m_ModelList.erase(resourceName);
+		if(m_DeferredRender)
+			m_DeferredRender->resetModelIds();
 		return true;
 	}
 
@@ -463,7 +482,36 @@ void Graphics::deleteShader(const char *p_ShaderId)
 
 bool Graphics::createTexture(const char *p_TextureId, const char *p_Filename)
 {
-	ID3D11ShaderResourceView *resourceView = m_TextureLoader.createTextureFromFile(p_Filename);
+	const unsigned int tableId = m_TextureTable.find(boost::filesystem::path(p_Filename).filename().string());
+	ID3D11ShaderResourceView *resourceView = tableId != MaterialBundleFormat::invalidTexture ?
+		m_TextureLoader.createTextureFromFile(p_Filename, m_TextureTable.getTexture(tableId)) :
+		m_TextureLoader.createTextureFromFile(p_Filename);
+	if(!resourceView)
+	{
+		return false;
+	}
+
+	int size = calculateTextureSize(resourceView);
+	VRAMInfo::getInstance()->updateUsage(size);
+
+	m_TextureList.insert(make_pair(p_TextureId, resourceView));
+
+	return true;
+}
+
+bool Graphics::loadTextureTable(const char *p_Filename)
+{
+	const bool loaded = m_TextureTable.loadFile(p_Filename);
+	if(!loaded)
+		GraphicsLogger::log(GraphicsLogger::Level::WARNING, "Could not load texture table: " + std::string(p_Filename));
+
+	m_ModelFactory->setTextureTable(loaded ? &m_TextureTable : nullptr);
+	return loaded;
+}
+
+bool Graphics::createTextureFromMemory(const char *p_TextureId, const char *p_Data, size_t p_Size)
+{
+	ID3D11ShaderResourceView *resourceView = m_TextureLoader.createTextureFromMemory(p_Data, p_Size);
 	if(!resourceView)
 	{
 		return false;
@@ -700,31 +748,101 @@ void Graphics::render2D_Object(Object2D_Id p_Id)
 
 void Graphics::renderModel(InstanceId p_ModelId)
 {
-	if(m_ModelInstances.count(p_ModelId) > 0)
+	if(!m_ModelScene.getInstance(p_ModelId))
+		throw GraphicsException("Failed to render model instance, vector out of bounds.", __LINE__, __FILE__);
+
+	if(!m_ModelScene.getModel(p_ModelId))
+		throw GraphicsException("Failed to render model instance, the model has been released: " +
+			m_ModelScene.getInstance(p_ModelId)->getModelName(), __LINE__, __FILE__);
+
+	m_SingleModels.push_back(p_ModelId);
+}
+
+void Graphics::renderModels(void)
+{
+	m_RenderAllModels = true;
+}
+
+void Graphics::submitModels(void)
+{
+	m_ModelScene.updateTransforms();
+
+	// Cull each view once, before anything is queued. The shadow views depend
+	// on the frame's directional lights, which are set after the models.
+	Frustum frustums[DeferredRenderer::NUM_VIEWS];
+	const unsigned int numViews = m_DeferredRender->getViewFrustums(frustums);
+
+	if(m_RenderAllModels)
 	{
-		const auto& model = m_ModelInstances[p_ModelId];
-		ModelDefinition *modelDef = getModelFromList(model.getModelName());
-		if(!modelDef->isTransparent)
+		m_ModelScene.cullViews(frustums, numViews, m_VisibleViews);
+
+		const std::vector<ModelDefinition*>& models = m_ModelScene.getModels();
+		const std::vector<ModelInstance>& instances = m_ModelScene.getInstances();
+		const std::vector<ModelScene::Transform>& transforms = m_ModelScene.getTransforms();
+		for(unsigned int i = 0; i < m_ModelScene.getSize(); i++)
 		{
-			m_DeferredRender->addRenderable(Renderable(
-				Renderable::Type::DEFERRED_OBJECT, modelDef,
-				model.getWorldMatrix(),
-				&model.getFinalTransform(),
-				nullptr,
-				model.getSelectedMaterialSet()));
+			// Instances of released models are kept until erased, but not rendered
+			if(models[i] && m_VisibleViews[i])
+			{
+				addModelRenderable(models[i], instances[i], transforms[i], m_VisibleViews[i]);
+			}
 		}
-		else
+	}
+	else
+	{
+		for(InstanceId id : m_SingleModels)
 		{
-			m_ForwardRenderer->addRenderable(Renderable(
-				Renderable::Type::FORWARD_OBJECT, modelDef,
-				model.getWorldMatrix(),
-				&model.getFinalTransform(),
-				&model.getColorTone(),
-				model.getSelectedMaterialSet()));
+			// The instance or its model may have been released since renderModel
+			const ModelScene::Transform* transform = m_ModelScene.getTransform(id);
+			ModelDefinition* modelDef = m_ModelScene.getModel(id);
+			if(!transform || !modelDef)
+				continue;
+
+			const BoundingBox* bounds = m_ModelScene.getBounds(id);
+			unsigned int visibleViews = 0;
+			for(unsigned int view = 0; view < numViews; view++)
+			{
+				if(frustums[view].isVisible(*bounds))
+					visibleViews |= 1 << view;
+			}
+
+			if(visibleViews)
+				addModelRenderable(modelDef, *m_ModelScene.getInstance(id), *transform, visibleViews);
 		}
 	}
-	else
-		throw GraphicsException("Failed to render model instance, vector out of bounds.", __LINE__, __FILE__);
+
+	m_RenderAllModels = false;
+	m_SingleModels.clear();
+}
+
+void Graphics::addModelRenderable(ModelDefinition *p_Model, const ModelInstance &p_Instance, const ModelScene::Transform &p_Transform,
+	unsigned int p_VisibleViews)
+{
+	if(!p_Model->isTransparent)
+	{
+		m_DeferredRender->addRenderable(Renderable(
+			Renderable::Type::DEFERRED_OBJECT, p_Model,
+			p_Transform.world,
+			p_Transform.invTransposeWorld,
+			p_Instance.getFinalTransform(),
+			p_Instance.getNumFinalTransforms(),
+			nullptr,
+			p_Instance.getSelectedMaterialSet(),
+			p_VisibleViews));
+	}
+	else if(p_VisibleViews & (1 << DeferredRenderer::CAMERA_VIEW))
+	{
+		// Transparent models are not drawn into the shadow maps
+		m_ForwardRenderer->addRenderable(Renderable(
+			Renderable::Type::FORWARD_OBJECT, p_Model,
+			p_Transform.world,
+			p_Transform.invTransposeWorld,
+			p_Instance.getFinalTransform(),
+			p_Instance.getNumFinalTransforms(),
+			&p_Instance.getColorTone(),
+			p_Instance.getSelectedMaterialSet(),
+			p_VisibleViews));
+	}
 }
 
 void Graphics::renderSkydome(void)
@@ -810,6 +928,8 @@ void Graphics::drawFrame(void)
 	m_TextFactory.update();
 
 
+	submitModels();
+
 	Begin(m_ClearColor);
 	m_DeferredRender->renderDeferred();
 	m_DeviceContext->OMSetRenderTargets(1, &m_RenderTargetView, NULL); 
@@ -857,8 +977,16 @@ void Graphics::setModelDefinitionTransparency(const char *p_ModelId, bool p_Stat
 
 void Graphics::animationPose(int p_Instance, const DirectX::XMFLOAT4X4* p_Pose, unsigned int p_Size)
 {
-	if(m_ModelInstances.count(p_Instance) > 0)
-		m_ModelInstances.at(p_Instance).animationPose(p_Pose, p_Size);
+	ModelInstance* instance = m_ModelScene.getInstance(p_Instance);
+	if(instance)
+		instance->animationPose(p_Pose, p_Size);
+}
+
+void Graphics::setAnimationPoseSource(int p_Instance, const DirectX::XMFLOAT4X4* const* p_Pose, unsigned int p_Size)
+{
+	ModelInstance* instance = m_ModelScene.getInstance(p_Instance);
+	if(instance)
+		instance->setPoseSource(p_Pose, p_Size);
 }
 
 int Graphics::getVRAMUsage(void)
@@ -876,16 +1004,7 @@ IGraphics::InstanceId Graphics::createModelInstance(const char *p_ModelId)
 		return -1;
 	}
 
-	ModelInstance instance;
-	instance.setModelName(p_ModelId);
-	instance.setPosition(XMFLOAT3(0.f, 0.f, 0.f));
-	instance.setRotation(XMFLOAT3(0.f, 0.f, 0.f));
-	instance.setScale(XMFLOAT3(1.f, 1.f, 1.f));
-	int id = m_NextInstanceId++;
-
-	m_ModelInstances.insert(make_pair(id, instance));
-
-	return id;
+	return m_ModelScene.addInstance(p_ModelId, modelDef, getModelBounds(*modelDef));
 }
 
 void Graphics::createSkydome(const char* p_TextureResource, float p_Radius)
@@ -895,49 +1014,43 @@ void Graphics::createSkydome(const char* p_TextureResource, float p_Radius)
 
 void Graphics::eraseModelInstance(InstanceId p_Instance)
 {
-	if(m_ModelInstances.count(p_Instance) > 0)
-		m_ModelInstances.erase(p_Instance);
-	else
+	if(!m_ModelScene.removeInstance(p_Instance))
 		throw GraphicsException("Failed to erase model instance, vector out of bounds.", __LINE__, __FILE__);
 }
 
 void Graphics::setModelPosition(InstanceId p_Instance, Vector3 p_Position)
 {
-	if(m_ModelInstances.count(p_Instance) > 0)
-		m_ModelInstances.at(p_Instance).setPosition(p_Position);
-	else
+	if(!m_ModelScene.setPosition(p_Instance, p_Position))
 		throw GraphicsException("Failed to set model instance position, vector out of bounds.", __LINE__, __FILE__);
 }
 
 void Graphics::setModelRotation(InstanceId p_Instance, Vector3 p_YawPitchRoll)
 {
-	if(m_ModelInstances.count(p_Instance) > 0)
-		m_ModelInstances.at(p_Instance).setRotation(DirectX::XMFLOAT3(p_YawPitchRoll.y, p_YawPitchRoll.x, p_YawPitchRoll.z));
-	else
+	if(!m_ModelScene.setRotation(p_Instance, DirectX::XMFLOAT3(p_YawPitchRoll.y, p_YawPitchRoll.x, p_YawPitchRoll.z)))
 		throw GraphicsException("Failed to set model instance position, vector out of bounds.", __LINE__, __FILE__);
 }
 
 void Graphics::setModelScale(InstanceId p_Instance, Vector3 p_Scale)
 {
-	if(m_ModelInstances.count(p_Instance) > 0)
-		m_ModelInstances.at(p_Instance).setScale(DirectX::XMFLOAT3(p_Scale));
-	else
+	if(!m_ModelScene.setScale(p_Instance, DirectX::XMFLOAT3(p_Scale)))
 		throw GraphicsException("Failed to set model instance scale, vector out of bounds.", __LINE__, __FILE__);
 }
 
 void Graphics::setModelColorTone(InstanceId p_Instance, Vector3 p_ColorTone)
 {
-	if(m_ModelInstances.count(p_Instance) > 0)
-		m_ModelInstances.at(p_Instance).setColorTone(DirectX::XMFLOAT3(p_ColorTone));
+	ModelInstance* instance = m_ModelScene.getInstance(p_Instance);
+	if(instance)
+		instance->setColorTone(DirectX::XMFLOAT3(p_ColorTone));
 	else
 		throw GraphicsException("Failed to set model instance color tone, vector out of bounds.", __LINE__, __FILE__);
 }
 
 void Graphics::setModelStyle(InstanceId p_Instance, const char* p_Style)
 {
-	if(m_ModelInstances.count(p_Instance) > 0)
+	ModelInstance* instance = m_ModelScene.getInstance(p_Instance);
+	if(instance)
 	{
-		auto& modelInst = m_ModelInstances.at(p_Instance);
+		auto& modelInst = *instance;
 		const ModelDefinition* model = getModelFromList(modelInst.getModelName());
 
 		for (unsigned int i = 0; i < model->materialSets.size(); i++)
@@ -1184,6 +1297,24 @@ void Graphics::createDefaultShaders(void)
 	createShader("DefaultAnimatedShader", L"assets/shaders/AnimatedGeometryPass.hlsl",	"VS,PS","5_0",
 		ShaderType::VERTEX_SHADER | ShaderType::PIXEL_SHADER);
 
+	// Models from compact files keep their quantized vertices, the shaders decode them
+	ShaderInputElementDescription compactDesc[] =
+	{
+		{"POSITION",0, Format::R16G16B16A16_UNORM, 0, 0,	D3D11_INPUT_PER_VERTEX_DATA, 0},
+		{"NORMAL",	0, Format::R16G16_SNORM, 0, 8,			D3D11_INPUT_PER_VERTEX_DATA, 0},
+		{"TANGENT",	0, Format::R16G16_SNORM, 0, 12,			D3D11_INPUT_PER_VERTEX_DATA, 0},
+		{"COORD",	0, Format::R16G16_FLOAT, 0, 16,			D3D11_INPUT_PER_VERTEX_DATA, 0},
+		{"WEIGHTS",	0, Format::R8G8B8A8_UNORM, 0, 20,		D3D11_INPUT_PER_VERTEX_DATA, 0},
+		{"BONEID",	0, Format::R8G8B8A8_UINT, 0, 24,		D3D11_INPUT_PER_VERTEX_DATA, 0},
+	};
+	D3D_SHADER_MACRO compactDefine[2] = {{ "COMPACT_VERTEX", "1" }, nullptr };
+	m_ShaderList.insert(make_pair("CompactDeferredShader", m_WrapperFactory->createShader(L"assets/shaders/GeometryPass.hlsl",
+		compactDefine, "VS,PS", "5_0", ShaderType::VERTEX_SHADER | ShaderType::PIXEL_SHADER, compactDesc, 4)));
+	m_ShaderList.insert(make_pair("CompactForwardShader", m_WrapperFactory->createShader(L"assets/shaders/ForwardShader.hlsl",
+		compactDefine, "VS,PS", "5_0", ShaderType::VERTEX_SHADER | ShaderType::PIXEL_SHADER, compactDesc, 4)));
+	m_ShaderList.insert(make_pair("CompactAnimatedShader", m_WrapperFactory->createShader(L"assets/shaders/AnimatedGeometryPass.hlsl",
+		compactDefine, "VS,PS", "5_0", ShaderType::VERTEX_SHADER | ShaderType::PIXEL_SHADER, compactDesc, 6)));
+
 	// Debug shaders 
 	createShader("DebugDeferredShader", L"assets/shaders/DebugShader.hlsl","VS,PS","5_0",
 		ShaderType::VERTEX_SHADER | ShaderType::PIXEL_SHADER);
@@ -1443,7 +1574,7 @@ Shader *Graphics::getShaderFromList(string p_Identifier)
 		__LINE__, __FILE__);
 }
 
-ModelDefinition *Graphics::getModelFromList(string p_Identifier)
+ModelDefinition *Graphics::getModelFromList(const string& p_Identifier)
 {
 	auto findIt = m_ModelList.find(p_Identifier);
 	if (findIt != m_ModelList.end())
@@ -17,6 +17,7 @@
 #include "WrapperFactory.h"
 #include "ModelFactory.h"
 #include "ModelInstance.h"
+#include "ModelScene.h"
 #include "ModelDefinition.h"
 #include "ParticleFactory.h"
 #include "ParticleInstance.h"
@@ -58,15 +59,24 @@ private:
 	DirectX::XMFLOAT3 m_Eye;
 
 	TextureLoader m_TextureLoader;	
+	TextureTable m_TextureTable;
 	WrapperFactory *m_WrapperFactory;
 	ModelFactory *m_ModelFactory;
 
 	std::map<std::string, Shader*> m_ShaderList;
 	std::map<std::string, ModelDefinition> m_ModelList;
 	std::map<std::string, ID3D11ShaderResourceView*> m_TextureList;
-	std::map<InstanceId, ModelInstance> m_ModelInstances;
+	ModelScene m_ModelScene;
+	/**
+	 * Models requested this frame, culled and queued in drawFrame once the lights are known.
+	 */
+	bool m_RenderAllModels;
+	std::vector<InstanceId> m_SingleModels;
+	/**
+	 * Scratch space for culling, kept between frames to avoid allocations.
+	 */
+	std::vector<unsigned int> m_VisibleViews;
 	std::map<Object2D_Id, Renderable2D> m_2D_Objects;
-	InstanceId m_NextInstanceId;
 	Object2D_Id m_Next2D_ObjectId;
 
 	//Particles
@@ -114,6 +124,8 @@ public:
 	bool reInitialize(HWND p_Hwnd, int p_ScreenWidht, int p_ScreenHeight, bool p_Fullscreen) override;
 	
 	bool createModel(const char *p_ModelId, const char *p_Filename) override;
+	void preloadModel(const char *p_Filename, loadModelTextureCallBack p_TextureFound, void *p_Userdata) override;
+	void discardPreloadedModel(const char *p_Filename) override;
 	bool releaseModel(const char *p_ModelID) override;
 	
 	void createShader(const char *p_shaderId, LPCWSTR p_Filename,
@@ -126,6 +138,8 @@ public:
 	void deleteShader(const char *p_ShaderId) override;
 
 	bool createTexture(const char *p_TextureId, const char *p_filename) override;
+	bool createTextureFromMemory(const char *p_TextureId, const char *p_Data, size_t p_Size) override;
+	bool loadTextureTable(const char *p_Filename) override;
 	bool releaseTexture(const char *p_TextureId) override;	
 
 	//Particles
@@ -164,6 +178,7 @@ public:
 	void setClearColor(Vector4 p_Color) override;
 
 	void renderModel(InstanceId p_ModelId) override;
+	void renderModels(void) override;
 	virtual void renderSkydome(void) override;
 	void renderText(Text_Id p_Id) override;
 	void render2D_Object(Object2D_Id p_Id) override;
@@ -172,6 +187,7 @@ public:
 	void setModelDefinitionTransparency(const char *p_ModelId, bool p_State) override;
 
 	void animationPose(int p_Instance, const DirectX::XMFLOAT4X4* p_Pose, unsigned int p_Size) override;
+	void setAnimationPoseSource(int p_Instance, const DirectX::XMFLOAT4X4* const* p_Pose, unsigned int p_Size) override;
 
 	int getVRAMUsage(void) override;
 	
@@ -235,7 +251,10 @@ private:
 	void initializeMatrices(int p_ScreenWidth, int p_ScreenHeight, float p_NearZ, float p_FarZ);
 	
 	Shader *getShaderFromList(std::string p_Identifier);
-	ModelDefinition *getModelFromList(std::string p_Identifier);
+	ModelDefinition *getModelFromList(const std::string& p_Identifier);
+	void submitModels(void);
+	void addModelRenderable(ModelDefinition *p_Model, const ModelInstance &p_Instance, const ModelScene::Transform &p_Transform,
+		unsigned int p_VisibleViews);
 	ParticleEffectDefinition::ptr getParticleFromList(std::string p_ParticleSystemId);
 	ID3D11ShaderResourceView *getTextureFromList(std::string p_Identifier);
 	
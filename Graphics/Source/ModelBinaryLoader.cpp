@@ -4,9 +4,14 @@
 
 #include <DirectXMath.h>
 
+#include <cstdint>
+#include <cstring>
+
+const char ModelBinaryLoader::indexedMagic[4] = { 'B', 'T', 'X', 'I' };
+
 ModelBinaryLoader::ModelBinaryLoader()
 {
-
+	clearData();
 }
 
 ModelBinaryLoader::~ModelBinaryLoader()
@@ -24,6 +29,10 @@ void ModelBinaryLoader::clear()
 	m_VertexBuffer.shrink_to_fit();
 	m_MaterialBuffer.clear();
 	m_MaterialBuffer.shrink_to_fit();
+	m_IndexBuffer.clear();
+	m_IndexBuffer.shrink_to_fit();
+	m_CompactVertexBuffer.clear();
+	m_CompactVertexBuffer.shrink_to_fit();
 }
 
 ModelBinaryLoader::Header ModelBinaryLoader::readHeader(std::istream* p_Input)
@@ -32,6 +41,9 @@ ModelBinaryLoader::Header ModelBinaryLoader::readHeader(std::istream* p_Input)
 	tempHeader.m_Animated = true;
 	tempHeader.m_Transparent = true;
 	tempHeader.m_CollideAble = true;
+	tempHeader.m_IndexSize = 0;
+	tempHeader.m_NumIndex = 0;
+	tempHeader.m_VertexFormat = VertexQuantizer::floatFormat;
 	int tempBool;
 	byteToString(p_Input, tempHeader.m_ModelName);
 	byteToInt(p_Input, tempHeader.m_NumMaterial);
@@ -70,20 +82,36 @@ std::vector<Material> ModelBinaryLoader::readMaterial(int p_NumberOfMaterial, st
 	return tempVector;
 }
 
-std::vector<MaterialBuffer> ModelBinaryLoader::readMaterialBuffer(int p_NumberOfMaterialBuffers, std::istream* p_Input)
+std::vector<MaterialBuffer> ModelBinaryLoader::readMaterialBuffer(int p_NumberOfMaterialBuffers, std::istream* p_Input, bool p_Indexed)
 {
 	MaterialBuffer temp;
+	temp.baseVertex = 0;
 	std::vector<MaterialBuffer> tempBuffer;
 	for(int i = 0; i < p_NumberOfMaterialBuffers; i++)
 	{
 		byteToString(p_Input, temp.material);
 		byteToInt(p_Input, temp.start);
 		byteToInt(p_Input, temp.length);
+		if(p_Indexed)
+		{
+			byteToInt(p_Input, temp.baseVertex);
+		}
 		tempBuffer.push_back(temp);
 	}
 	return tempBuffer;
 }
 
+std::vector<char> ModelBinaryLoader::readIndexBuffer(int p_NumberOfIndex, int p_IndexSize, std::istream* p_Input)
+{
+	if(p_IndexSize != 2 && p_IndexSize != 4)
+	{
+		throw GraphicsException("Invalid index size in model file", __LINE__, __FILE__);
+	}
+	std::vector<char> indexBuffer(p_NumberOfIndex * p_IndexSize);
+	p_Input->read(indexBuffer.data(), indexBuffer.size());
+	return indexBuffer;
+}
+
 std::vector<StaticVertex> ModelBinaryLoader::readVertexBuffer(int p_NumberOfVertex, std::istream* p_Input)
 {
 	std::vector<StaticVertex> vertexBuffer(p_NumberOfVertex);
@@ -98,6 +126,13 @@ std::vector<AnimatedVertex> ModelBinaryLoader::readVertexBufferAnimation(int p_N
 	return vertexBuffer;
 }
 
+std::vector<char> ModelBinaryLoader::readCompactVertexBuffer(int p_NumberOfVertex, int p_VertexSize, std::istream* p_Input)
+{
+	std::vector<char> vertexBuffer(p_NumberOfVertex * p_VertexSize);
+	p_Input->read(vertexBuffer.data(), vertexBuffer.size());
+	return vertexBuffer;
+}
+
 void ModelBinaryLoader::byteToString(std::istream* p_Input, std::string& p_Return)
 {
 	int strLength = 0;
@@ -112,7 +147,7 @@ void ModelBinaryLoader::byteToInt(std::istream* p_Input, int& p_Return)
 	p_Input->read((char*)&p_Return, sizeof(int));
 }
 
-void ModelBinaryLoader::loadBinaryFile(std::string p_FilePath)
+void ModelBinaryLoader::loadBinaryFile(std::string p_FilePath, std::function<void(const ModelBinaryLoader&)> p_MaterialsRead)
 {
 	clearData();
 	std::ifstream input(p_FilePath, std::istream::in | std::istream::binary);
@@ -120,9 +155,57 @@ void ModelBinaryLoader::loadBinaryFile(std::string p_FilePath)
 	{
 		throw GraphicsException("File could not be opened: " + p_FilePath, __LINE__, __FILE__);
 	}
+
+	char magic[sizeof(indexedMagic)];
+	input.read(magic, sizeof(magic));
+	const bool indexed = input && memcmp(magic, indexedMagic, sizeof(indexedMagic)) == 0;
+	int version = 0;
+	if(indexed)
+	{
+		byteToInt(&input, version);
+		if(version < 1 || version > indexedVersion)
+		{
+			throw GraphicsException("Unsupported model file version: " + p_FilePath, __LINE__, __FILE__);
+		}
+	}
+	else
+	{
+		input.clear();
+		input.seekg(0, std::istream::beg);
+	}
+
 	m_FileHeader = readHeader(&input);
+	if(indexed)
+	{
+		byteToInt(&input, m_FileHeader.m_IndexSize);
+		byteToInt(&input, m_FileHeader.m_NumIndex);
+	}
+	if(version >= 2)
+	{
+		byteToInt(&input, m_FileHeader.m_VertexFormat);
+		if(m_FileHeader.m_VertexFormat == VertexQuantizer::compactFormat)
+		{
+			input.read(reinterpret_cast<char*>(&m_CompactBounds), sizeof(m_CompactBounds));
+		}
+		else if(m_FileHeader.m_VertexFormat != VertexQuantizer::floatFormat)
+		{
+			throw GraphicsException("Unsupported vertex format in model file: " + p_FilePath, __LINE__, __FILE__);
+		}
+	}
+	const bool compact = m_FileHeader.m_VertexFormat == VertexQuantizer::compactFormat;
 	m_Material = readMaterial(m_FileHeader.m_NumMaterial,&input);
-	if(m_FileHeader.m_Animated)
+	if(p_MaterialsRead)
+	{
+		p_MaterialsRead(*this);
+	}
+	if(compact)
+	{
+		const int vertexSize = m_FileHeader.m_Animated ? sizeof(VertexQuantizer::CompactSkinnedVertex)
+			: sizeof(VertexQuantizer::CompactVertex);
+		m_CompactVertexBuffer = readCompactVertexBuffer(m_FileHeader.m_NumVertex, vertexSize, &input);
+		calculateBoundingVolume(m_CompactBounds);
+	}
+	else if(m_FileHeader.m_Animated)
 	{
 		m_AnimationVertexBuffer = readVertexBufferAnimation(m_FileHeader.m_NumVertex, &input);
 		calculateBoundingVolume(m_AnimationVertexBuffer);
@@ -132,7 +215,11 @@ void ModelBinaryLoader::loadBinaryFile(std::string p_FilePath)
 		m_VertexBuffer = readVertexBuffer(m_FileHeader.m_NumVertex, &input);
 		calculateBoundingVolume(m_VertexBuffer);
 	}
-	m_MaterialBuffer = readMaterialBuffer(m_FileHeader.m_NumMaterialBuffer, &input);
+	if(indexed)
+	{
+		m_IndexBuffer = readIndexBuffer(m_FileHeader.m_NumIndex, m_FileHeader.m_IndexSize, &input);
+	}
+	m_MaterialBuffer = readMaterialBuffer(m_FileHeader.m_NumMaterialBuffer, &input, indexed);
 	
 }
 
@@ -151,11 +238,96 @@ const std::vector<StaticVertex>& ModelBinaryLoader::getStaticVertexBuffer() cons
 	return m_VertexBuffer;
 }
 
+const std::vector<char>& ModelBinaryLoader::getCompactVertexBuffer() const
+{
+	return m_CompactVertexBuffer;
+}
+
+const VertexQuantizer::Bounds& ModelBinaryLoader::getCompactBounds() const
+{
+	return m_CompactBounds;
+}
+
+int ModelBinaryLoader::getVertexFormat() const
+{
+	return m_FileHeader.m_VertexFormat;
+}
+
+std::vector<DirectX::XMFLOAT3> ModelBinaryLoader::getPositions() const
+{
+	std::vector<DirectX::XMFLOAT3> positions;
+	positions.reserve(m_FileHeader.m_NumVertex);
+	if(m_FileHeader.m_VertexFormat == VertexQuantizer::compactFormat)
+	{
+		const size_t vertexSize = m_FileHeader.m_Animated ? sizeof(VertexQuantizer::CompactSkinnedVertex)
+			: sizeof(VertexQuantizer::CompactVertex);
+		for(size_t offset = 0; offset + vertexSize <= m_CompactVertexBuffer.size(); offset += vertexSize)
+		{
+			// The skin follows the vertex, so both layouts start with a CompactVertex
+			VertexQuantizer::CompactVertex compact;
+			memcpy(&compact, m_CompactVertexBuffer.data() + offset, sizeof(compact));
+			DirectX::XMFLOAT4 position;
+			DirectX::XMFLOAT3 normal, tangent, binormal;
+			DirectX::XMFLOAT2 uv;
+			VertexQuantizer::decode(compact, m_CompactBounds, position, normal, uv, tangent, binormal);
+			positions.push_back(DirectX::XMFLOAT3(position.x, position.y, position.z));
+		}
+	}
+	else
+	{
+		for(const AnimatedVertex& vertex : m_AnimationVertexBuffer)
+		{
+			positions.push_back(DirectX::XMFLOAT3(vertex.m_Position.x, vertex.m_Position.y, vertex.m_Position.z));
+		}
+		for(const StaticVertex& vertex : m_VertexBuffer)
+		{
+			positions.push_back(DirectX::XMFLOAT3(vertex.m_Position.x, vertex.m_Position.y, vertex.m_Position.z));
+		}
+	}
+	return positions;
+}
+
 const std::vector<MaterialBuffer>& ModelBinaryLoader::getMaterialBuffer() const
 {
 	return m_MaterialBuffer;
 }
 
+const std::vector<char>& ModelBinaryLoader::getIndexBuffer() const
+{
+	return m_IndexBuffer;
+}
+
+int ModelBinaryLoader::getIndexSize() const
+{
+	return m_FileHeader.m_IndexSize;
+}
+
+std::vector<unsigned int> ModelBinaryLoader::getIndices() const
+{
+	std::vector<unsigned int> indices(m_FileHeader.m_NumIndex);
+	if(m_IndexBuffer.empty())
+	{
+		return indices;
+	}
+	for(const MaterialBuffer& range : m_MaterialBuffer)
+	{
+		for(int i = range.start; i < range.start + range.length; i++)
+		{
+			unsigned int index;
+			if(m_FileHeader.m_IndexSize == 2)
+			{
+				index = reinterpret_cast<const uint16_t*>(m_IndexBuffer.data())[i];
+			}
+			else
+			{
+				index = reinterpret_cast<const uint32_t*>(m_IndexBuffer.data())[i];
+			}
+			indices[i] = index + range.baseVertex;
+		}
+	}
+	return indices;
+}
+
 bool ModelBinaryLoader::getAnimated() const
 {
 	return m_FileHeader.m_Animated;
@@ -185,10 +357,17 @@ void ModelBinaryLoader::clearData()
 	m_FileHeader.m_Animated = false;
 	m_FileHeader.m_CollideAble = false;
 	m_FileHeader.m_Transparent = false;
+	m_FileHeader.m_IndexSize = 0;
+	m_FileHeader.m_NumIndex = 0;
+	m_FileHeader.m_VertexFormat = VertexQuantizer::floatFormat;
+	m_CompactBounds.m_Min = DirectX::XMFLOAT3(0.f, 0.f, 0.f);
+	m_CompactBounds.m_Size = DirectX::XMFLOAT3(0.f, 0.f, 0.f);
 	m_Material.clear();
 	m_AnimationVertexBuffer.clear();
 	m_VertexBuffer.clear();
 	m_MaterialBuffer.clear();
+	m_IndexBuffer.clear();
+	m_CompactVertexBuffer.clear();
 }
 
 template <typename VertList>
@@ -232,3 +411,13 @@ void ModelBinaryLoader::calculateBoundingVolume(const std::vector<StaticVertex>&
 {
 	calcBoundingVolume(p_Vertices, m_BoundingVolume);
 }
+
+void ModelBinaryLoader::calculateBoundingVolume(const VertexQuantizer::Bounds& p_Bounds)
+{
+	// The quantization bounds are the exact bounds of the source positions
+	std::array<StaticVertex, 2> corners;
+	corners[0].m_Position = DirectX::XMFLOAT4(p_Bounds.m_Min.x, p_Bounds.m_Min.y, p_Bounds.m_Min.z, 1.f);
+	corners[1].m_Position = DirectX::XMFLOAT4(p_Bounds.m_Min.x + p_Bounds.m_Size.x, p_Bounds.m_Min.y + p_Bounds.m_Size.y,
+		p_Bounds.m_Min.z + p_Bounds.m_Size.z, 1.f);
+	calcBoundingVolume(corners, m_BoundingVolume);
+}
@@ -2,8 +2,11 @@
 
 #include "ShaderStructs.h"
 
+#include <VertexQuantizer.h>
+
 #include <array>
 #include <fstream>
+#include <functional>
 #include <vector>
 #include <string>
 
@@ -19,14 +22,26 @@ public:
 		bool m_Animated;
 		bool m_Transparent;
 		bool m_CollideAble;
+		int m_IndexSize;
+		int m_NumIndex;
+		int m_VertexFormat;
 	};
 
+	/**
+	 * The first four bytes of an indexed model file, must match ModelConverter::indexedMagic.
+	 */
+	static const char indexedMagic[4];
+	static const int indexedVersion = 2;
+
 private:
 	Header m_FileHeader;
 	std::vector<Material> m_Material;
 	std::vector<AnimatedVertex> m_AnimationVertexBuffer;
 	std::vector<StaticVertex> m_VertexBuffer;
+	std::vector<char> m_CompactVertexBuffer;
+	VertexQuantizer::Bounds m_CompactBounds;
 	std::vector<MaterialBuffer> m_MaterialBuffer;
+	std::vector<char> m_IndexBuffer;
 	std::array<DirectX::XMFLOAT3, 8> m_BoundingVolume;
 
 public:	
@@ -49,9 +64,10 @@ public:
 	 * Opens a binary file then reads the information stream and saves the information in vectors of structs.
 	 * 
 	 * @param p_FilePath, the absolute path to the source file.
-	 *
+	 * @param p_MaterialsRead optional, called when the header and the materials
+	 *			have been read, before the vertices are read.
 	 */
-	void loadBinaryFile(std::string p_FilePath);
+	void loadBinaryFile(std::string p_FilePath, std::function<void(const ModelBinaryLoader&)> p_MaterialsRead = nullptr);
 	
 	/**
 	 * Returns information about the materials used in the model.
@@ -75,6 +91,35 @@ public:
 	 */
 	const std::vector<StaticVertex>& getStaticVertexBuffer() const;
 
+	/**
+	 * Returns the vertices of a compact model as stored in the file, one
+	 * VertexQuantizer::CompactVertex or CompactSkinnedVertex per vertex.
+	 * The float vertex buffers are empty for compact models.
+	 *
+	 * @returns the vertex data, empty if the model uses the float vertex layout.
+	 */
+	const std::vector<char>& getCompactVertexBuffer() const;
+
+	/**
+	 * Returns the bounds the positions of a compact model are quantized within.
+	 */
+	const VertexQuantizer::Bounds& getCompactBounds() const;
+
+	/**
+	 * Returns the vertex format id of the model file.
+	 *
+	 * @returns VertexQuantizer::floatFormat or VertexQuantizer::compactFormat.
+	 */
+	int getVertexFormat() const;
+
+	/**
+	 * Returns the position of every vertex regardless of the vertex format,
+	 * for code that uses the geometry on the CPU.
+	 *
+	 * @returns one position per vertex.
+	 */
+	std::vector<DirectX::XMFLOAT3> getPositions() const;
+
 	/**
 	 * Returns information about what material is used on a part of the model.
 	 *
@@ -82,6 +127,29 @@ public:
 	 */
 	const std::vector<MaterialBuffer>& getMaterialBuffer() const;
 
+	/**
+	 * Returns the raw index buffer of an indexed model, getIndexSize() bytes per index.
+	 * The material buffer ranges then refer to indices instead of vertices.
+	 *
+	 * @returns the index data, empty if the model is an expanded triangle list.
+	 */
+	const std::vector<char>& getIndexBuffer() const;
+
+	/**
+	 * Returns the size of each index in the index buffer.
+	 *
+	 * @returns 2 or 4 for indexed models, 0 if the model has no index buffer.
+	 */
+	int getIndexSize() const;
+
+	/**
+	 * Returns the indices widened to 32 bits, with the base vertex of each material range added,
+	 * for code that uses the triangles on the CPU. Expanded models return an empty vector.
+	 *
+	 * @returns one index into the vertex buffer per triangle corner.
+	 */
+	std::vector<unsigned int> getIndices() const;
+
 	/**
 	 * Returns a true or fasle about if the model is animated.
 	 *
@@ -111,13 +179,19 @@ protected:
 	
 	ModelBinaryLoader::Header readHeader(std::istream* p_Input);
 	std::vector<Material> readMaterial(int p_NumberOfMaterial, std::istream* p_Input);
-	std::vector<MaterialBuffer> readMaterialBuffer(int p_NumberOfMaterialBuffers, std::istream* p_Input);
+	std::vector<MaterialBuffer> readMaterialBuffer(int p_NumberOfMaterialBuffers, std::istream* p_Input, bool p_Indexed = false);
+	std::vector<char> readIndexBuffer(int p_NumberOfIndex, int p_IndexSize, std::istream* p_Input);
 	std::vector<StaticVertex> readVertexBuffer(int p_NumberOfVertex, std::istream* p_Input);
 	std::vector<AnimatedVertex> readVertexBufferAnimation(int p_NumberOfVertex, std::istream* p_Input);	
+	/**
+	 * Read quantized vertices as they are, the shaders decode them.
+	 */
+	std::vector<char> readCompactVertexBuffer(int p_NumberOfVertex, int p_VertexSize, std::istream* p_Input);
 
 private:
 	void clearData();
 
 	void calculateBoundingVolume(const std::vector<AnimatedVertex>& p_Vertices);
 	void calculateBoundingVolume(const std::vector<StaticVertex>& p_Vertices);
+	void calculateBoundingVolume(const VertexQuantizer::Bounds& p_Bounds);
 };
\ No newline at end of file
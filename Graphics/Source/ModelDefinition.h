@@ -19,21 +19,37 @@ public:
 	 * The GPU buffer containing the vertex data.
 	 */
 	std::unique_ptr<Buffer> vertexBuffer;
+	/**
+	 * The GPU buffer containing the indices, or nullptr if the vertex buffer is an expanded triangle list.
+	 */
+	std::unique_ptr<Buffer> indexBuffer;
+	/**
+	 * Constant buffer with the bounds the vertex positions are quantized within,
+	 * or nullptr if the vertex buffer holds the float vertex layout.
+	 */
+	std::unique_ptr<Buffer> vertexBoundsBuffer;
 	
+	/**
+	 * A part of the model drawn with one texture. With an index buffer the start and count
+	 * refer to indices, which are offset by baseVertex.
+	 */
 	struct Material
 	{
 		int vertexStart;
 		int numOfVertices;
 		int textureIndex;
+		int baseVertex;
 
 		Material()
+			:	baseVertex(0)
 		{
 		}
 
 		Material(int p_VertexStart, int p_NumOfVertice, int p_TexureIndex) :
 			vertexStart(p_VertexStart),
 			numOfVertices(p_NumOfVertice),
-			textureIndex(p_TexureIndex)
+			textureIndex(p_TexureIndex),
+			baseVertex(0)
 		{
 		}
 	};
@@ -90,6 +106,8 @@ public:
 	 */
 	ModelDefinition(ModelDefinition&& p_Other)
 		:	vertexBuffer(std::move(p_Other.vertexBuffer)),
+			indexBuffer(std::move(p_Other.indexBuffer)),
+			vertexBoundsBuffer(std::move(p_Other.vertexBoundsBuffer)),
 			materialSets(p_Other.materialSets),
 			shader(p_Other.shader),
 			diffuseTexture(p_Other.diffuseTexture),
@@ -107,6 +125,8 @@ public:
 	ModelDefinition& operator=(ModelDefinition&& p_Other)
 	{
 		std::swap(vertexBuffer, p_Other.vertexBuffer);
+		std::swap(indexBuffer, p_Other.indexBuffer);
+		std::swap(vertexBoundsBuffer, p_Other.vertexBoundsBuffer);
 		std::swap(materialSets, p_Other.materialSets);
 		std::swap(shader, p_Other.shader);
 		std::swap(diffuseTexture, p_Other.diffuseTexture);
@@ -1,8 +1,10 @@
 #include "ModelFactory.h"
+#include "ConstantBuffers.h"
 #include "GraphicsExceptions.h"
 #include "ModelBinaryLoader.h"
 #include "Utilities/MemoryUtil.h"
 #include "..\..\Common\Source\AnimationLoader.h"
+#include <MaterialBundle.h>
 #include <boost/filesystem.hpp>
 
 using std::string;
@@ -11,6 +13,18 @@ using std::map;
 using std::pair;
 using namespace DirectX;
 
+namespace
+{
+	const unsigned int numStyles = 4;
+	const char* styles[numStyles] =
+	{
+		"Green",
+		"Red",
+		"Blue",
+		"Black",
+	};
+}
+
 ModelFactory *ModelFactory::m_Instance = nullptr;
 
 ModelFactory *ModelFactory::getInstance(void)
@@ -37,8 +51,25 @@ void ModelFactory::shutdown(void)
 
 ModelDefinition ModelFactory::createModel(const char *p_Filename)
 {
-	ModelBinaryLoader modelLoader;
-	modelLoader.loadBinaryFile(p_Filename);
+	std::unique_ptr<PreloadedModel> preloaded;
+	{
+		std::lock_guard<std::mutex> lock(m_PreloadLock);
+		auto it = m_PreloadedModels.find(p_Filename);
+		if(it != m_PreloadedModels.end())
+		{
+			preloaded = std::move(it->second);
+			m_PreloadedModels.erase(it);
+		}
+	}
+	if(!preloaded)
+	{
+		preloaded.reset(new PreloadedModel);
+		preloaded->m_Loader.reset(new ModelBinaryLoader);
+		preloaded->m_Loader->loadBinaryFile(p_Filename);
+		preloaded->m_StyleTextures = getStyleTextures(p_Filename, preloaded->m_Loader->getAnimated(),
+			preloaded->m_Loader->getMaterial());
+	}
+	ModelBinaryLoader &modelLoader = *preloaded->m_Loader;
 
 	ModelDefinition model;
 	Buffer::Description bufferDescription;
@@ -48,7 +79,38 @@ ModelDefinition ModelFactory::createModel(const char *p_Filename)
 	model.isAnimated = modelLoader.getAnimated();
 	model.isTransparent = modelLoader.getTransparent();
 
-	if(!model.isAnimated)
+	std::unique_ptr<Buffer> vertexBoundsBuffer;
+	if(modelLoader.getVertexFormat() == VertexQuantizer::compactFormat)
+	{
+		// The vertices stay quantized on the GPU and the shaders decode them with the bounds
+		const vector<char> &vertexData = modelLoader.getCompactVertexBuffer();
+		bufferDescription.initData = vertexData.data();
+		bufferDescription.sizeOfElement = model.isAnimated ? sizeof(VertexQuantizer::CompactSkinnedVertex)
+			: sizeof(VertexQuantizer::CompactVertex);
+		bufferDescription.numOfElements = vertexData.size() / bufferDescription.sizeOfElement;
+		bufferDescription.type = Buffer::Type::VERTEX_BUFFER;
+		bufferDescription.usage = Buffer::Usage::USAGE_IMMUTABLE;
+
+		const VertexQuantizer::Bounds &bounds = modelLoader.getCompactBounds();
+		cVertexBounds boundsData;
+		boundsData.positionMin = XMFLOAT4(bounds.m_Min.x, bounds.m_Min.y, bounds.m_Min.z, 0.f);
+		boundsData.positionSize = XMFLOAT4(bounds.m_Size.x, bounds.m_Size.y, bounds.m_Size.z, 0.f);
+		Buffer::Description boundsDescription;
+		boundsDescription.initData = &boundsData;
+		boundsDescription.numOfElements = 1;
+		boundsDescription.sizeOfElement = sizeof(cVertexBounds);
+		boundsDescription.type = Buffer::Type::CONSTANT_BUFFER_VS;
+		boundsDescription.usage = Buffer::Usage::USAGE_IMMUTABLE;
+		vertexBoundsBuffer.reset(WrapperFactory::getInstance()->createBuffer(boundsDescription));
+
+		if(model.isAnimated)
+			model.shader = m_ShaderList->at("CompactAnimatedShader");
+		else if(model.isTransparent)
+			model.shader = m_ShaderList->at("CompactForwardShader");
+		else
+			model.shader = m_ShaderList->at("CompactDeferredShader");
+	}
+	else if(!model.isAnimated)
 	{
 		const vector<StaticVertex> &vertexData = modelLoader.getStaticVertexBuffer();
 		bufferDescription = createBufferDescription(vertexData, Buffer::Usage::USAGE_IMMUTABLE); //Change to default when needed to change data.
@@ -65,20 +127,25 @@ ModelDefinition ModelFactory::createModel(const char *p_Filename)
 	}
 	std::unique_ptr<Buffer> vertexBuffer(WrapperFactory::getInstance()->createBuffer(bufferDescription));
 
+	std::unique_ptr<Buffer> indexBuffer;
+	const vector<char> &indexData = modelLoader.getIndexBuffer();
+	if(!indexData.empty())
+	{
+		Buffer::Description indexDescription;
+		indexDescription.initData = indexData.data();
+		indexDescription.sizeOfElement = modelLoader.getIndexSize();
+		indexDescription.numOfElements = indexData.size() / indexDescription.sizeOfElement;
+		indexDescription.type = Buffer::Type::INDEX_BUFFER;
+		indexDescription.usage = Buffer::Usage::USAGE_IMMUTABLE;
+		indexBuffer.reset(WrapperFactory::getInstance()->createBuffer(indexDescription));
+	}
+
 	boost::filesystem::path modelPath(p_Filename);
 	boost::filesystem::path parentDir(modelPath.parent_path());
 
 	if (model.isAnimated)
 	{
-		static const char* styles[4] =
-		{
-			"Green",
-			"Red",
-			"Blue",
-			"Black",
-		};
-
-		for (unsigned int styleId = 0; styleId < 4; ++styleId)
+		for (unsigned int styleId = 0; styleId < numStyles; ++styleId)
 		{
 			unsigned int startIndex = model.diffuseTexture.size();
 
@@ -88,10 +155,11 @@ ModelDefinition ModelFactory::createModel(const char *p_Filename)
 				tempInterval.at(i).vertexStart = materialBufferData.at(i).start;
 				tempInterval.at(i).numOfVertices = materialBufferData.at(i).length;
 				tempInterval.at(i).textureIndex = startIndex + i;
+				tempInterval.at(i).baseVertex = materialBufferData.at(i).baseVertex;
 			}
 			model.materialSets.push_back(std::make_pair(styles[styleId], tempInterval));
 
-			loadTextures(model, p_Filename, materialData.size(), materialData, styles[styleId]);
+			loadTextures(model, preloaded->m_StyleTextures.at(styleId));
 		}
 	}
 	else
@@ -102,13 +170,16 @@ ModelDefinition ModelFactory::createModel(const char *p_Filename)
 			tempInterval.at(i).vertexStart = materialBufferData.at(i).start;
 			tempInterval.at(i).numOfVertices = materialBufferData.at(i).length;
 			tempInterval.at(i).textureIndex = i;
+			tempInterval.at(i).baseVertex = materialBufferData.at(i).baseVertex;
 		}
 		model.materialSets.push_back(std::make_pair("default", tempInterval));
 
-		loadTextures(model, p_Filename, materialData.size(), materialData, nullptr);
+		loadTextures(model, preloaded->m_StyleTextures.at(0));
 	}
 
 	model.vertexBuffer.swap(vertexBuffer);
+	model.indexBuffer.swap(indexBuffer);
+	model.vertexBoundsBuffer.swap(vertexBoundsBuffer);
 	model.boundingVolume = modelLoader.getBoundingVolume();
 
 	modelLoader.clear();
@@ -116,6 +187,38 @@ ModelDefinition ModelFactory::createModel(const char *p_Filename)
 	return model;
 }
 
+void ModelFactory::preloadModel(const char *p_Filename, loadModelTextureCallBack p_TextureFound, void *p_Userdata)
+{
+	std::unique_ptr<PreloadedModel> preloaded(new PreloadedModel);
+	preloaded->m_Loader.reset(new ModelBinaryLoader);
+	preloaded->m_Loader->loadBinaryFile(p_Filename, [&] (const ModelBinaryLoader &p_Loader)
+	{
+		// Kept for createModel, so the material bundle is only read here
+		preloaded->m_StyleTextures = getStyleTextures(p_Filename, p_Loader.getAnimated(), p_Loader.getMaterial());
+		if(!p_TextureFound)
+			return;
+
+		for(const vector<MaterialTextures> &modelTextures : preloaded->m_StyleTextures)
+		{
+			for(const MaterialTextures &textures : modelTextures)
+			{
+				p_TextureFound(textures.m_DiffuseName.c_str(), textures.m_DiffusePath.c_str(), p_Userdata);
+				p_TextureFound(textures.m_NormalName.c_str(), textures.m_NormalPath.c_str(), p_Userdata);
+				p_TextureFound(textures.m_SpecularName.c_str(), textures.m_SpecularPath.c_str(), p_Userdata);
+			}
+		}
+	});
+
+	std::lock_guard<std::mutex> lock(m_PreloadLock);
+	m_PreloadedModels[p_Filename] = std::move(preloaded);
+}
+
+void ModelFactory::discardPreloadedModel(const char *p_Filename)
+{
+	std::lock_guard<std::mutex> lock(m_PreloadLock);
+	m_PreloadedModels.erase(p_Filename);
+}
+
 ModelDefinition *ModelFactory::create2D_Model(Vector2 p_HalfSize, const char *p_TextureId)
 {
 	ModelDefinition *model = new ModelDefinition();
@@ -163,7 +266,13 @@ void ModelFactory::setLoadModelTextureCallBack(loadModelTextureCallBack p_LoadMo
 	m_LoadModelTextureUserdata = p_Userdata;
 }
 
+void ModelFactory::setTextureTable(const TextureTable *p_Table)
+{
+	m_TextureTable = p_Table;
+}
+
 ModelFactory::ModelFactory(void)
+	:	m_TextureTable(nullptr)
 {
 }
 
@@ -220,83 +329,163 @@ void ModelFactory::create2D_VertexBuffer(ModelDefinition *p_Model, Vector2 p_Hal
 	p_Model->vertexBuffer.swap(vertexBuffer);
 }
 
-void ModelFactory::loadTextures(ModelDefinition &p_Model, const char *p_Filename, unsigned int p_NumOfMaterials,
-	const vector<Material> &p_Materials, const char *p_Style)
+void ModelFactory::loadTextures(ModelDefinition &p_Model, const vector<MaterialTextures> &p_ModelTextures)
 {
-	using std::pair;
+	for(const MaterialTextures &textures : p_ModelTextures)
+	{
+
+		m_LoadModelTexture(textures.m_DiffuseName.c_str(), textures.m_DiffusePath.c_str(), m_LoadModelTextureUserdata);
+		m_LoadModelTexture(textures.m_NormalName.c_str(), textures.m_NormalPath.c_str(), m_LoadModelTextureUserdata);
+		m_LoadModelTexture(textures.m_SpecularName.c_str(), textures.m_SpecularPath.c_str(), m_LoadModelTextureUserdata);
+
+		p_Model.diffuseTexture.push_back(std::make_pair(textures.m_DiffuseName, getTextureFromList(textures.m_DiffuseName)));
+		p_Model.normalTexture.push_back(std::make_pair(textures.m_NormalName, getTextureFromList(textures.m_NormalName)));
+		p_Model.specularTexture.push_back(std::make_pair(textures.m_SpecularName, getTextureFromList(textures.m_SpecularName)));
+	}
+}
+
+vector<vector<ModelFactory::MaterialTextures>> ModelFactory::getStyleTextures(const char *p_Filename, bool p_Animated,
+	const vector<Material> &p_Materials) const
+{
+	// Animated models have textures for each style, static models one set
+	vector<vector<MaterialTextures>> styleTextures;
+	if(p_Animated)
+	{
+		for(unsigned int styleId = 0; styleId < numStyles; ++styleId)
+			styleTextures.push_back(getModelTextures(p_Filename, true, p_Materials, styles[styleId]));
+	}
+	else
+		styleTextures.push_back(getModelTextures(p_Filename, false, p_Materials, nullptr));
+
+	return styleTextures;
+}
+
+vector<ModelFactory::MaterialTextures> ModelFactory::getModelTextures(const char *p_Filename, bool p_Animated,
+	const vector<Material> &p_Materials, const char *p_Style) const
+{
+	vector<MaterialTextures> textures;
+	// Animated models pick their diffuse textures by style, which bundles do not describe
+	if(!p_Animated && getBundleTextures(p_Filename, p_Materials.size(), textures))
+		return textures;
+
+	for(unsigned int i = 0; i < p_Materials.size(); i++)
+		textures.push_back(getMaterialTextures(p_Filename, p_Animated, i, p_Materials[i], p_Style));
+
+	return textures;
+}
+
+bool ModelFactory::getBundleTextures(const char *p_Filename, unsigned int p_NumOfMaterials,
+	vector<MaterialTextures> &p_Textures) const
+{
+	if(!m_TextureTable || m_TextureTable->getNumTextures() == 0)
+		return false;
 
+	boost::filesystem::path modelPath(p_Filename);
+	MaterialBundle bundle;
+	if(!bundle.loadFile(boost::filesystem::path(modelPath).replace_extension(".bmb").string()))
+		return false;
+
+	// A bundle built against another table or model has IDs that mean nothing here
+	const vector<MaterialBundle::Material> &materials = bundle.getMaterials();
+	if(bundle.getTableHash() != m_TextureTable->getHash() || materials.size() != p_NumOfMaterials)
+		return false;
+
+	boost::filesystem::path parentDir(modelPath.parent_path().parent_path() / "textures");
+	p_Textures.clear();
+	for(const MaterialBundle::Material &material : materials)
+	{
+		if(material.m_Diffuse == MaterialBundleFormat::invalidTexture
+			|| material.m_Normal == MaterialBundleFormat::invalidTexture
+			|| material.m_Specular == MaterialBundleFormat::invalidTexture)
+		{
+			p_Textures.clear();
+			return false;
+		}
+
+		MaterialTextures textures;
+		textures.m_DiffusePath = (parentDir / m_TextureTable->getTexture(material.m_Diffuse).m_Name).string();
+		textures.m_DiffuseName = textures.m_DiffusePath;
+		textures.m_NormalName = m_TextureTable->getTexture(material.m_Normal).m_Name;
+		textures.m_NormalPath = (parentDir / textures.m_NormalName).string();
+		textures.m_SpecularName = m_TextureTable->getTexture(material.m_Specular).m_Name;
+		textures.m_SpecularPath = (parentDir / textures.m_SpecularName).string();
+		p_Textures.push_back(textures);
+	}
+
+	return true;
+}
+
+ModelFactory::MaterialTextures ModelFactory::getMaterialTextures(const char *p_Filename, bool p_Animated,
+	unsigned int p_MaterialIndex, const Material &p_Material, const char *p_Style)
+{
 	boost::filesystem::path modelPath(p_Filename);
 	boost::filesystem::path parentDir(modelPath.parent_path().parent_path() / "textures");
 
 	string styleOfDoom;
 	if(p_Style)
 		styleOfDoom = p_Style;
-	for(unsigned int i = 0; i < p_NumOfMaterials; i++)
+
+	const Material &material = p_Material;
+	boost::filesystem::path diff;
+	if(p_Animated)
 	{
-		const Material &material = p_Materials.at(i);
-		boost::filesystem::path diff;
-		if(p_Model.isAnimated)
+		string pathToHell = modelPath.parent_path().string() + "/Dzala.btx";
+		if(string(p_Filename) == pathToHell)
 		{
-			string pathToHell = modelPath.parent_path().string() + "/Dzala.btx";
-			if(string(p_Filename) == pathToHell)
+			switch(p_MaterialIndex)
 			{
-				switch(i)
+			case 0:
 				{
-				case 0:
-					{
-						if(styleOfDoom == "Green")
-							diff = parentDir / "Dzala_BodyGreen_COLOR.dds";
-						else if(styleOfDoom == "Red")
-							diff = parentDir / "Dzala_BodyRed_COLOR.dds";
-						else if(styleOfDoom == "Blue")
-							diff = parentDir / "Dzala_BodyBlue_COLOR.dds";
-						else if(styleOfDoom == "Black")
-							diff = parentDir / "Dzala_BodyBlack_COLOR.dds";
-						break;
-					}
-				case 1:
-					{
-						if(styleOfDoom == "Green")
-							diff = parentDir / "Dzala_AccessoriesGreen_COLOR.dds";
-						else if(styleOfDoom == "Red")
-							diff = parentDir / "Dzala_AccessoriesRed_COLOR.dds";
-						else if(styleOfDoom == "Blue")
-							diff = parentDir / "Dzala_AccessoriesBlue_COLOR.dds";
-						else if(styleOfDoom == "Black")
-							diff = parentDir / "Dzala_AccessoriesBlack_COLOR.dds";
-						break;
-					}
+					if(styleOfDoom == "Green")
+						diff = parentDir / "Dzala_BodyGreen_COLOR.dds";
+					else if(styleOfDoom == "Red")
+						diff = parentDir / "Dzala_BodyRed_COLOR.dds";
+					else if(styleOfDoom == "Blue")
+						diff = parentDir / "Dzala_BodyBlue_COLOR.dds";
+					else if(styleOfDoom == "Black")
+						diff = parentDir / "Dzala_BodyBlack_COLOR.dds";
+					break;
+				}
+			case 1:
+				{
+					if(styleOfDoom == "Green")
+						diff = parentDir / "Dzala_AccessoriesGreen_COLOR.dds";
+					else if(styleOfDoom == "Red")
+						diff = parentDir / "Dzala_AccessoriesRed_COLOR.dds";
+					else if(styleOfDoom == "Blue")
+						diff = parentDir / "Dzala_AccessoriesBlue_COLOR.dds";
+					else if(styleOfDoom == "Black")
+						diff = parentDir / "Dzala_AccessoriesBlack_COLOR.dds";
+					break;
 				}
-				
-			}
-			if(p_Filename == modelPath.parent_path().string() + "/Zane.btx")
-			{
-				string filename = "Zane_" + styleOfDoom + "_COLOR.dds";
-				diff = parentDir / filename;
 			}
+			
 		}
-		else
+		if(p_Filename == modelPath.parent_path().string() + "/Zane.btx")
 		{
-			diff = (material.m_DiffuseMap == "NONE" || material.m_DiffuseMap == "Default_COLOR.dds") ?
-				parentDir / "Default_COLOR.dds" : parentDir / material.m_DiffuseMap;
+			string filename = "Zane_" + styleOfDoom + "_COLOR.dds";
+			diff = parentDir / filename;
 		}
-		boost::filesystem::path norm = (material.m_NormalMap == "NONE" || material.m_NormalMap == "Default_NRM.dds") ?
-			parentDir/ "Default_NRM.dds" : parentDir / material.m_NormalMap;
-		boost::filesystem::path spec = (material.m_SpecularMap == "NONE" || material.m_SpecularMap == "Default_SPEC.dds") ?
-			parentDir / "Default_SPEC.dds" : parentDir / material.m_SpecularMap;
-
-		std::string strDiff = diff.string();
-		std::string strNorm = norm.string();
-		std::string strSpec = spec.string();
-
-		m_LoadModelTexture(diff.string().c_str(), strDiff.c_str(), m_LoadModelTextureUserdata);
-		m_LoadModelTexture(material.m_NormalMap.c_str(), strNorm.c_str(), m_LoadModelTextureUserdata);
-		m_LoadModelTexture(material.m_SpecularMap.c_str(), strSpec.c_str(), m_LoadModelTextureUserdata);
-
-		p_Model.diffuseTexture.push_back(std::make_pair(strDiff, getTextureFromList(strDiff)));
-		p_Model.normalTexture.push_back(std::make_pair(material.m_NormalMap, getTextureFromList(material.m_NormalMap)));
-		p_Model.specularTexture.push_back(std::make_pair(material.m_SpecularMap, getTextureFromList(material.m_SpecularMap)));
 	}
+	else
+	{
+		diff = (material.m_DiffuseMap == "NONE" || material.m_DiffuseMap == "Default_COLOR.dds") ?
+			parentDir / "Default_COLOR.dds" : parentDir / material.m_DiffuseMap;
+	}
+	boost::filesystem::path norm = (material.m_NormalMap == "NONE" || material.m_NormalMap == "Default_NRM.dds") ?
+		parentDir/ "Default_NRM.dds" : parentDir / material.m_NormalMap;
+	boost::filesystem::path spec = (material.m_SpecularMap == "NONE" || material.m_SpecularMap == "Default_SPEC.dds") ?
+		parentDir / "Default_SPEC.dds" : parentDir / material.m_SpecularMap;
+
+	MaterialTextures textures;
+	textures.m_DiffuseName = diff.string();
+	textures.m_DiffusePath = diff.string();
+	textures.m_NormalName = material.m_NormalMap;
+	textures.m_NormalPath = norm.string();
+	textures.m_SpecularName = material.m_SpecularMap;
+	textures.m_SpecularPath = spec.string();
+
+	return textures;
 }
 
 ID3D11ShaderResourceView *ModelFactory::getTextureFromList(string p_Identifier)
@@ -4,11 +4,17 @@
 #include "ShaderStructs.h"
 #include "Utilities/XMFloatUtil.h"
 
+#include <TextureTable.h>
+
 #include <d3d11.h>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <vector>
 #include <string>
 
+class ModelBinaryLoader;
+
 class ModelFactory
 {
 public:
@@ -21,13 +27,40 @@ public:
 	typedef void (*loadModelTextureCallBack)(const char *p_ResourceName, const char *p_FilePath, void *p_Userdata);
 
 private:
+	/**
+	* The texture files used by one material of a model.
+	*/
+	struct MaterialTextures
+	{
+		std::string m_DiffuseName;
+		std::string m_DiffusePath;
+		std::string m_NormalName;
+		std::string m_NormalPath;
+		std::string m_SpecularName;
+		std::string m_SpecularPath;
+	};
+
+	/**
+	* A model file read by preloadModel, with the textures of each style so
+	* that createModel does not read the material bundle again.
+	*/
+	struct PreloadedModel
+	{
+		std::unique_ptr<ModelBinaryLoader> m_Loader;
+		std::vector<std::vector<MaterialTextures>> m_StyleTextures;
+	};
+
 	static ModelFactory *m_Instance;
 	std::map<std::string, ID3D11ShaderResourceView*> *m_TextureList;
 	std::map<std::string, Shader*> *m_ShaderList;
+	const TextureTable *m_TextureTable;
 
 	loadModelTextureCallBack m_LoadModelTexture;
 	void *m_LoadModelTextureUserdata;
 
+	std::mutex m_PreloadLock;
+	std::map<std::string, std::unique_ptr<PreloadedModel>> m_PreloadedModels;
+
 public:
 	/**
 	* Gets an instance of the model factory.
@@ -55,6 +88,23 @@ public:
 	*/
 	virtual ModelDefinition createModel(const char *p_Filename);
 
+	/**
+	* Reads a model file in advance, so that the next createModel with the same file
+	* only needs to create the buffers. Does not use the graphics device and may be
+	* called from any thread.
+	* @param p_Filename the model file to read
+	* @param p_TextureFound called for each texture the model will load, as soon as the
+	*	materials have been read and before the vertices are read, may be null
+	* @param p_Userdata user defined data passed to p_TextureFound
+	*/
+	void preloadModel(const char *p_Filename, loadModelTextureCallBack p_TextureFound, void *p_Userdata);
+
+	/**
+	* Forgets a preloaded model that will not be created. May be called from any thread.
+	* @param p_Filename the model file passed to preloadModel
+	*/
+	void discardPreloadedModel(const char *p_Filename);
+
 	/**
 	* Creates a quad model with with a texture attached to it.
 	* @param p_HalfSize the size from the center point to the xy-edges
@@ -77,6 +127,14 @@ public:
 	*/
 	void setLoadModelTextureCallBack(loadModelTextureCallBack p_LoadModelTexture, void *p_Userdata);
 
+	/**
+	* Set the texture table that material bundles (.bmb) next to the models refer to.
+	* Static models with a bundle built against the table take their textures from
+	* the bundle instead of the texture names in the model file.
+	* @param p_Table the texture table, must outlive the factory, or nullptr to ignore bundles
+	*/
+	void setTextureTable(const TextureTable *p_Table);
+
 protected:
 	ModelFactory(void);
 	~ModelFactory(void);
@@ -86,8 +144,15 @@ private:
 	Buffer::Description createBufferDescription(const std::vector<T> &p_VertexData, Buffer::Usage p_Usage);
 	void create2D_VertexBuffer(ModelDefinition *p_Model, Vector2 p_HalfSize);
 
-	void loadTextures(ModelDefinition &model, const char *p_Filename, unsigned int p_NumOfMaterials,
-		const std::vector<Material> &p_Materials, const char *p_Style);
+	void loadTextures(ModelDefinition &p_Model, const std::vector<MaterialTextures> &p_ModelTextures);
+	std::vector<std::vector<MaterialTextures>> getStyleTextures(const char *p_Filename, bool p_Animated,
+		const std::vector<Material> &p_Materials) const;
+	std::vector<MaterialTextures> getModelTextures(const char *p_Filename, bool p_Animated,
+		const std::vector<Material> &p_Materials, const char *p_Style) const;
+	bool getBundleTextures(const char *p_Filename, unsigned int p_NumOfMaterials,
+		std::vector<MaterialTextures> &p_Textures) const;
+	static MaterialTextures getMaterialTextures(const char *p_Filename, bool p_Animated, unsigned int p_MaterialIndex,
+		const Material &p_Material, const char *p_Style);
 	void load2D_Texture(ModelDefinition &model, const char *p_TextureId);
 	ID3D11ShaderResourceView *getTextureFromList(std::string p_Identifier);
 };
\ No newline at end of file
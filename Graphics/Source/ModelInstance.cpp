@@ -9,7 +9,9 @@ using std::vector;
 ModelInstance::ModelInstance()
 	: m_IsCalculated(false), 
 	m_ColorTone(DirectX::XMFLOAT3(1.f, 1.f, 1.f)),
-	m_SelectedMaterialSet(0)
+	m_SelectedMaterialSet(0),
+	m_PoseSource(nullptr),
+	m_PoseSourceSize(0)
 {
 }
 
@@ -73,16 +75,36 @@ void ModelInstance::calculateWorldMatrix() const
 	m_IsCalculated = true;
 }
 
-const vector<DirectX::XMFLOAT4X4>& ModelInstance::getFinalTransform() const
+const DirectX::XMFLOAT4X4* ModelInstance::getFinalTransform() const
 {
-	return m_FinalTransform;
+	if (m_PoseSource)
+	{
+		return *m_PoseSource;
+	}
+	return m_FinalTransform.data();
+}
+
+unsigned int ModelInstance::getNumFinalTransforms() const
+{
+	if (m_PoseSource)
+	{
+		return m_PoseSourceSize;
+	}
+	return m_FinalTransform.size();
 }
 
 void ModelInstance::animationPose(const DirectX::XMFLOAT4X4* p_Pose, unsigned int p_Size)
 {
+	m_PoseSource = nullptr;
 	m_FinalTransform.assign(p_Pose, p_Pose + p_Size);
 }
 
+void ModelInstance::setPoseSource(const DirectX::XMFLOAT4X4* const* p_Pose, unsigned int p_Size)
+{
+	m_PoseSource = p_Pose;
+	m_PoseSourceSize = p_Pose ? p_Size : 0;
+}
+
 int ModelInstance::getSelectedMaterialSet() const
 {
 	return m_SelectedMaterialSet;
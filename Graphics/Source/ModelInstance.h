@@ -27,6 +27,11 @@
 	 * Row major.
 	 */
 	std::vector<DirectX::XMFLOAT4X4> m_FinalTransform;
+	/**
+	 * Externally owned pose read at render time instead of m_FinalTransform, or nullptr.
+	 */
+	const DirectX::XMFLOAT4X4* const* m_PoseSource;
+	unsigned int m_PoseSourceSize;
 
  public:
 	/**
@@ -91,9 +96,13 @@
 	/**
 	 * Get the final transformations for the models joints.
 	 *
-	 * @return the final joint transformations. Row major.
+	 * @return the final joint transformations, from the pose source if one is set. Row major.
+	 */
+	const DirectX::XMFLOAT4X4* getFinalTransform() const;
+	/**
+	 * @return the number of matrices returned by getFinalTransform
 	 */
-	const std::vector<DirectX::XMFLOAT4X4>& getFinalTransform() const;
+	unsigned int getNumFinalTransforms() const;
 
 	/**
 	 * Set the pose of the model. Requires the model to be animated.
@@ -103,6 +112,15 @@
 	 */
 	void animationPose(const DirectX::XMFLOAT4X4* p_Pose, unsigned int p_Size);
 
+	/**
+	 * Read the pose from memory owned by the animation system instead of keeping a copy.
+	 * The pointer behind p_Pose is read every time the pose is used.
+	 *
+	 * @param p_Pose the location of the pointer to the current pose, nullptr to stop reading from it
+	 * @param p_Size the number of matrices in the pose
+	 */
+	void setPoseSource(const DirectX::XMFLOAT4X4* const* p_Pose, unsigned int p_Size);
+
 	/**
 	 * Gets the currently selected material set.
 	 *
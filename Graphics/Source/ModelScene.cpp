@@ -0,0 +1,287 @@
+#include "ModelScene.h"
+
+using namespace DirectX;
+
+ModelScene::ModelScene(InstanceId p_FirstId, float p_CellSize)
+	:	m_NextId(p_FirstId),
+		m_Grid(p_CellSize)
+{
+}
+
+void ModelScene::clear()
+{
+	m_Ids.clear();
+	m_Models.clear();
+	m_Instances.clear();
+	m_Transforms.clear();
+	m_LocalBounds.clear();
+	m_Bounds.clear();
+	m_IsDirty.clear();
+	m_DirtyIndices.clear();
+	m_Indices.clear();
+	m_Grid.clear();
+}
+
+ModelScene::InstanceId ModelScene::addInstance(const std::string& p_ModelName, ModelDefinition* p_Model,
+	const BoundingBox& p_LocalBounds)
+{
+	ModelInstance instance;
+	instance.setModelName(p_ModelName);
+	instance.setPosition(XMFLOAT3(0.f, 0.f, 0.f));
+	instance.setRotation(XMFLOAT3(0.f, 0.f, 0.f));
+	instance.setScale(XMFLOAT3(1.f, 1.f, 1.f));
+
+	const InstanceId id = m_NextId++;
+	const unsigned int index = m_Ids.size();
+
+	m_Ids.push_back(id);
+	m_Models.push_back(p_Model);
+	m_Instances.push_back(instance);
+	m_Transforms.push_back(Transform());
+	m_LocalBounds.push_back(p_LocalBounds);
+	m_Bounds.push_back(BoundingBox());
+	m_IsDirty.push_back(false);
+	m_Indices[id] = index;
+	m_Grid.add();
+
+	markDirty(index);
+
+	return id;
+}
+
+bool ModelScene::removeInstance(InstanceId p_Id)
+{
+	auto findIt = m_Indices.find(p_Id);
+	if (findIt == m_Indices.end())
+		return false;
+
+	const unsigned int index = findIt->second;
+	const unsigned int last = m_Ids.size() - 1;
+	m_Indices.erase(findIt);
+	m_Grid.remove(index);
+
+	if (index != last)
+	{
+		m_Ids[index] = m_Ids[last];
+		m_Models[index] = m_Models[last];
+		std::swap(m_Instances[index], m_Instances[last]);
+		m_Transforms[index] = m_Transforms[last];
+		m_LocalBounds[index] = m_LocalBounds[last];
+		m_Bounds[index] = m_Bounds[last];
+		m_Indices[m_Ids[index]] = index;
+
+		// Any queued update of the removed instance is dropped with its flag
+		m_IsDirty[index] = false;
+		if (m_IsDirty[last])
+		{
+			markDirty(index);
+		}
+	}
+
+	m_Ids.pop_back();
+	m_Models.pop_back();
+	m_Instances.pop_back();
+	m_Transforms.pop_back();
+	m_LocalBounds.pop_back();
+	m_Bounds.pop_back();
+	m_IsDirty.pop_back();
+
+	return true;
+}
+
+ModelInstance* ModelScene::getInstance(InstanceId p_Id)
+{
+	unsigned int* index = findIndex(p_Id);
+	if (!index)
+		return nullptr;
+
+	return &m_Instances[*index];
+}
+
+ModelDefinition* ModelScene::getModel(InstanceId p_Id) const
+{
+	auto findIt = m_Indices.find(p_Id);
+	if (findIt == m_Indices.end())
+		return nullptr;
+
+	return m_Models[findIt->second];
+}
+
+const ModelScene::Transform* ModelScene::getTransform(InstanceId p_Id)
+{
+	unsigned int* index = findIndex(p_Id);
+	if (!index)
+		return nullptr;
+
+	if (m_IsDirty[*index])
+	{
+		updateTransform(*index);
+	}
+	return &m_Transforms[*index];
+}
+
+const BoundingBox* ModelScene::getBounds(InstanceId p_Id)
+{
+	if (!getTransform(p_Id))
+		return nullptr;
+
+	return &m_Bounds[m_Indices.find(p_Id)->second];
+}
+
+bool ModelScene::setPosition(InstanceId p_Id, const XMFLOAT3& p_Position)
+{
+	unsigned int* index = findIndex(p_Id);
+	if (!index)
+		return false;
+
+	m_Instances[*index].setPosition(p_Position);
+	markDirty(*index);
+	return true;
+}
+
+bool ModelScene::setRotation(InstanceId p_Id, const XMFLOAT3& p_Rotation)
+{
+	unsigned int* index = findIndex(p_Id);
+	if (!index)
+		return false;
+
+	m_Instances[*index].setRotation(p_Rotation);
+	markDirty(*index);
+	return true;
+}
+
+bool ModelScene::setScale(InstanceId p_Id, const XMFLOAT3& p_Scale)
+{
+	unsigned int* index = findIndex(p_Id);
+	if (!index)
+		return false;
+
+	m_Instances[*index].setScale(p_Scale);
+	markDirty(*index);
+	return true;
+}
+
+void ModelScene::detachModel(const ModelDefinition* p_Model)
+{
+	for (auto& model : m_Models)
+	{
+		if (model == p_Model)
+		{
+			model = nullptr;
+		}
+	}
+}
+
+void ModelScene::attachModel(const std::string& p_ModelName, ModelDefinition* p_Model, const BoundingBox& p_LocalBounds)
+{
+	for (unsigned int i = 0; i < m_Models.size(); ++i)
+	{
+		if (!m_Models[i] && m_Instances[i].getModelName() == p_ModelName)
+		{
+			m_Models[i] = p_Model;
+			m_LocalBounds[i] = p_LocalBounds;
+			markDirty(i);
+		}
+	}
+}
+
+unsigned int ModelScene::updateTransforms()
+{
+	unsigned int numUpdated = 0;
+	for (unsigned int index : m_DirtyIndices)
+	{
+		// Removed or already updated through getTransform
+		if (index >= m_IsDirty.size() || !m_IsDirty[index])
+			continue;
+
+		updateTransform(index);
+		++numUpdated;
+	}
+	m_DirtyIndices.clear();
+
+	return numUpdated;
+}
+
+void ModelScene::cull(const Frustum& p_Frustum, std::vector<unsigned int>& p_Visible) const
+{
+	m_Grid.cull(p_Frustum, p_Visible);
+}
+
+void ModelScene::cullViews(const Frustum* p_Frustums, unsigned int p_NumViews, std::vector<unsigned int>& p_VisibleViews)
+{
+	p_VisibleViews.assign(m_Ids.size(), 0);
+	for (unsigned int view = 0; view < p_NumViews; ++view)
+	{
+		m_Grid.cull(p_Frustums[view], m_VisibleIndices);
+		for (unsigned int index : m_VisibleIndices)
+		{
+			p_VisibleViews[index] |= 1 << view;
+		}
+	}
+}
+
+unsigned int ModelScene::getSize() const
+{
+	return m_Ids.size();
+}
+
+const std::vector<ModelScene::InstanceId>& ModelScene::getIds() const
+{
+	return m_Ids;
+}
+
+const std::vector<ModelDefinition*>& ModelScene::getModels() const
+{
+	return m_Models;
+}
+
+const std::vector<ModelInstance>& ModelScene::getInstances() const
+{
+	return m_Instances;
+}
+
+const std::vector<ModelScene::Transform>& ModelScene::getTransforms() const
+{
+	return m_Transforms;
+}
+
+const std::vector<BoundingBox>& ModelScene::getBounds() const
+{
+	return m_Bounds;
+}
+
+unsigned int* ModelScene::findIndex(InstanceId p_Id)
+{
+	auto findIt = m_Indices.find(p_Id);
+	if (findIt == m_Indices.end())
+		return nullptr;
+
+	return &findIt->second;
+}
+
+void ModelScene::markDirty(unsigned int p_Index)
+{
+	if (!m_IsDirty[p_Index])
+	{
+		m_IsDirty[p_Index] = true;
+		m_DirtyIndices.push_back(p_Index);
+	}
+}
+
+void ModelScene::updateTransform(unsigned int p_Index)
+{
+	Transform& transform = m_Transforms[p_Index];
+	transform.world = m_Instances[p_Index].getWorldMatrix();
+
+	XMStoreFloat4x4(&transform.invTransposeWorld,
+		XMMatrixTranspose(XMMatrixInverse(nullptr, XMLoadFloat4x4(&transform.world))));
+	transform.invTransposeWorld._41 = 0.f;
+	transform.invTransposeWorld._42 = 0.f;
+	transform.invTransposeWorld._43 = 0.f;
+	transform.invTransposeWorld._44 = 1.f;
+
+	m_Bounds[p_Index] = m_LocalBounds[p_Index].transform(transform.world);
+	m_Grid.update(p_Index, m_Bounds[p_Index]);
+
+	m_IsDirty[p_Index] = false;
+}
@@ -0,0 +1,197 @@
+#pragma once
+
+#include "BoundingBox.h"
+#include "CullingGrid.h"
+#include "ModelInstance.h"
+
+#include <DirectXMath.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct ModelDefinition;
+
+/**
+ * Retained set of model instances, kept in dense arrays for rendering.
+ *
+ * Instances are registered once and rendered every frame until removed.
+ * Index i of getIds, getModels, getInstances and getTransforms describes
+ * the same instance. Removing an instance moves the last instance into its
+ * place, so the arrays never contain holes. Transforms are only recalculated
+ * for instances that have been changed since the last updateTransforms.
+ *
+ * The scene only refers to model definitions and does not touch the device,
+ * so it can be used without Direct3D.
+ */
+class ModelScene
+{
+public:
+	typedef int InstanceId;
+
+	/**
+	 * The world matrix of an instance, with the inverse transpose used for normals.
+	 * Both are stored transposed, ready for the shaders.
+	 */
+	struct Transform
+	{
+		DirectX::XMFLOAT4X4 world;
+		DirectX::XMFLOAT4X4 invTransposeWorld;
+	};
+
+private:
+	std::vector<InstanceId> m_Ids;
+	std::vector<ModelDefinition*> m_Models;
+	std::vector<ModelInstance> m_Instances;
+	std::vector<Transform> m_Transforms;
+	std::vector<BoundingBox> m_LocalBounds;
+	std::vector<BoundingBox> m_Bounds;
+	std::vector<bool> m_IsDirty;
+	std::vector<unsigned int> m_DirtyIndices;
+
+	std::unordered_map<InstanceId, unsigned int> m_Indices;
+	InstanceId m_NextId;
+
+	CullingGrid m_Grid;
+	std::vector<unsigned int> m_VisibleIndices;
+
+public:
+	/**
+	 * Constructor.
+	 *
+	 * @param p_FirstId the identifier of the first added instance, later instances count up from it
+	 * @param p_CellSize the side of a culling grid cell, in world units
+	 */
+	explicit ModelScene(InstanceId p_FirstId = 1, float p_CellSize = 2000.f);
+
+	/**
+	 * Remove all instances. Identifiers keep counting from where they were.
+	 */
+	void clear();
+
+	/**
+	 * Register an instance at the origin, without rotation and with unit scale.
+	 *
+	 * @param p_ModelName the identifier of the model definition
+	 * @param p_Model the model definition, or nullptr to skip the instance until attachModel
+	 * @param p_LocalBounds the bounds of the model, in model space
+	 * @return the identifier of the new instance, identifiers are never reused
+	 */
+	InstanceId addInstance(const std::string& p_ModelName, ModelDefinition* p_Model, const BoundingBox& p_LocalBounds);
+
+	/**
+	 * Remove an instance.
+	 *
+	 * @return false if the instance does not exist
+	 */
+	bool removeInstance(InstanceId p_Id);
+
+	/**
+	 * Get an instance to change properties other than the transform, such as the color tone.
+	 *
+	 * @return the instance, or nullptr if it does not exist. Only valid until the next add or remove.
+	 */
+	ModelInstance* getInstance(InstanceId p_Id);
+
+	/**
+	 * Get the model definition an instance is rendered with.
+	 *
+	 * @return the model definition, nullptr if the instance does not exist or its model has been detached
+	 */
+	ModelDefinition* getModel(InstanceId p_Id) const;
+
+	/**
+	 * Get the transform of an instance, updating it first if it has changed.
+	 *
+	 * @return the transform, or nullptr if the instance does not exist
+	 */
+	const Transform* getTransform(InstanceId p_Id);
+
+	/**
+	 * Get the world space bounds of an instance, updating them first if the instance has changed.
+	 *
+	 * @return the bounds, or nullptr if the instance does not exist
+	 */
+	const BoundingBox* getBounds(InstanceId p_Id);
+
+	/**
+	 * Set the position of an instance.
+	 *
+	 * @return false if the instance does not exist
+	 */
+	bool setPosition(InstanceId p_Id, const DirectX::XMFLOAT3& p_Position);
+
+	/**
+	 * Set the rotation of an instance.
+	 *
+	 * @param p_Rotation the rotation as (roll, pitch, yaw), see ModelInstance::setRotation
+	 * @return false if the instance does not exist
+	 */
+	bool setRotation(InstanceId p_Id, const DirectX::XMFLOAT3& p_Rotation);
+
+	/**
+	 * Set the scale of an instance.
+	 *
+	 * @return false if the instance does not exist
+	 */
+	bool setScale(InstanceId p_Id, const DirectX::XMFLOAT3& p_Scale);
+
+	/**
+	 * Stop rendering the instances of a model definition that is about to be released.
+	 */
+	void detachModel(const ModelDefinition* p_Model);
+
+	/**
+	 * Render detached instances with a model definition again, for example after a reload.
+	 *
+	 * @param p_ModelName the identifier of the model definition
+	 * @param p_LocalBounds the bounds of the model, in model space
+	 */
+	void attachModel(const std::string& p_ModelName, ModelDefinition* p_Model, const BoundingBox& p_LocalBounds);
+
+	/**
+	 * Recalculate the transforms of all changed instances.
+	 *
+	 * @return the number of recalculated transforms
+	 */
+	unsigned int updateTransforms();
+
+	/**
+	 * Find the instances that may be visible in a view. Call updateTransforms first.
+	 *
+	 * @param p_Frustum the view to cull against
+	 * @param p_Visible cleared and filled with indices into the dense arrays, in no particular order
+	 */
+	void cull(const Frustum& p_Frustum, std::vector<unsigned int>& p_Visible) const;
+
+	/**
+	 * Cull all instances against several views. Call updateTransforms first.
+	 *
+	 * @param p_Frustums the views, at most 32
+	 * @param p_NumViews the number of views
+	 * @param p_VisibleViews resized to the number of instances, bit v is set for
+	 *			each instance that may be visible in view v
+	 */
+	void cullViews(const Frustum* p_Frustums, unsigned int p_NumViews, std::vector<unsigned int>& p_VisibleViews);
+
+	/**
+	 * @return the number of instances
+	 */
+	unsigned int getSize() const;
+
+	const std::vector<InstanceId>& getIds() const;
+	const std::vector<ModelDefinition*>& getModels() const;
+	const std::vector<ModelInstance>& getInstances() const;
+	/**
+	 * Not recalculated, call updateTransforms first.
+	 */
+	const std::vector<Transform>& getTransforms() const;
+	/**
+	 * The world space bounds of the instances. Not recalculated, call updateTransforms first.
+	 */
+	const std::vector<BoundingBox>& getBounds() const;
+
+private:
+	unsigned int* findIndex(InstanceId p_Id);
+	void markDirty(unsigned int p_Index);
+	void updateTransform(unsigned int p_Index);
+};
@@ -0,0 +1,150 @@
+#include "RenderQueue.h"
+
+#include "GraphicsExceptions.h"
+
+#include <algorithm>
+#include <cstring>
+
+void RenderQueue::clear()
+{
+	m_Keys.clear();
+	m_Order.clear();
+}
+
+unsigned int RenderQueue::add(uint64_t p_Key)
+{
+	const unsigned int index = m_Keys.size();
+	m_Keys.push_back(p_Key);
+	m_Order.push_back(index);
+	return index;
+}
+
+uint64_t RenderQueue::createKey(unsigned int p_Pass, const void* p_Shader, unsigned int p_MaterialSet,
+	const void* p_Model, float p_Depth)
+{
+	static const uint64_t maxDepth = (uint64_t(1) << depthBits) - 1;
+
+	if (p_Pass >= (1u << passBits))
+	{
+		throw GraphicsException("Render pass " + std::to_string(p_Pass) + " does not fit in the render queue key",
+			__LINE__, __FILE__);
+	}
+	if (p_MaterialSet >= (1u << materialSetBits))
+	{
+		throw GraphicsException("Material set " + std::to_string(p_MaterialSet) + " does not fit in the render queue key",
+			__LINE__, __FILE__);
+	}
+
+	const float depth = (std::min)((std::max)(p_Depth, 0.f), 1.f);
+
+	uint64_t key = p_Pass;
+	key = (key << shaderBits) | getId(m_ShaderIds, p_Shader, shaderBits);
+	key = (key << materialSetBits) | p_MaterialSet;
+	key = (key << modelBits) | getId(m_ModelIds, p_Model, modelBits);
+	key = (key << depthBits) | (uint64_t)(depth * maxDepth);
+
+	return key;
+}
+
+void RenderQueue::resetIds()
+{
+	m_ShaderIds.clear();
+	m_ModelIds.clear();
+}
+
+void RenderQueue::sort()
+{
+	const unsigned int size = m_Keys.size();
+	m_SwapKeys.resize(size);
+	m_SwapOrder.resize(size);
+
+	// Least significant byte first, counting all bytes in one go
+	static const unsigned int numPasses = sizeof(uint64_t);
+	unsigned int counts[numPasses][256];
+	std::memset(counts, 0, sizeof(counts));
+	for (unsigned int i = 0; i < size; ++i)
+	{
+		const uint64_t key = m_Keys[i];
+		for (unsigned int pass = 0; pass < numPasses; ++pass)
+		{
+			++counts[pass][(key >> (pass * 8)) & 0xff];
+		}
+	}
+
+	for (unsigned int pass = 0; pass < numPasses; ++pass)
+	{
+		const unsigned int shift = pass * 8;
+		unsigned int* count = counts[pass];
+
+		// All keys have the same byte, the order would not change
+		if (size == 0 || count[(m_Keys[0] >> shift) & 0xff] == size)
+			continue;
+
+		unsigned int offset = 0;
+		for (unsigned int i = 0; i < 256; ++i)
+		{
+			const unsigned int bucketSize = count[i];
+			count[i] = offset;
+			offset += bucketSize;
+		}
+
+		for (unsigned int i = 0; i < size; ++i)
+		{
+			const unsigned int position = count[(m_Keys[i] >> shift) & 0xff]++;
+			m_SwapKeys[position] = m_Keys[i];
+			m_SwapOrder[position] = m_Order[i];
+		}
+
+		m_Keys.swap(m_SwapKeys);
+		m_Order.swap(m_SwapOrder);
+	}
+}
+
+unsigned int RenderQueue::getSize() const
+{
+	return m_Keys.size();
+}
+
+const std::vector<unsigned int>& RenderQueue::getOrder() const
+{
+	return m_Order;
+}
+
+const std::vector<uint64_t>& RenderQueue::getKeys() const
+{
+	return m_Keys;
+}
+
+unsigned int RenderQueue::getRunEnd(unsigned int p_Start) const
+{
+	const uint64_t state = m_Keys[p_Start] & stateMask;
+
+	unsigned int end = p_Start + 1;
+	while (end < m_Keys.size() && (m_Keys[end] & stateMask) == state)
+	{
+		++end;
+	}
+	return end;
+}
+
+unsigned int RenderQueue::getPass(uint64_t p_Key)
+{
+	return (unsigned int)(p_Key >> (64 - passBits));
+}
+
+uint32_t RenderQueue::getId(std::unordered_map<const void*, uint32_t>& p_Ids, const void* p_Object, unsigned int p_Bits)
+{
+	auto findIt = p_Ids.find(p_Object);
+	if (findIt != p_Ids.end())
+		return findIt->second;
+
+	if (p_Ids.size() >= (1u << p_Bits))
+	{
+		throw GraphicsException("Too many distinct objects for a " + std::to_string(p_Bits) + " bit render queue key field",
+			__LINE__, __FILE__);
+	}
+
+	const uint32_t id = p_Ids.size();
+	p_Ids[p_Object] = id;
+	return id;
+}
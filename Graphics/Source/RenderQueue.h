@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Orders the objects rendered in a frame by 64 bit keys describing the
+ * pipeline state they need, so that objects sharing state end up next to
+ * each other and can be drawn together.
+ *
+ * A key holds, from the most significant bits:
+ *  - pass (2 bits), the kind of drawing, such as animated or static geometry
+ *  - shader (12 bits)
+ *  - material set (6 bits)
+ *  - model (20 bits)
+ *  - depth (24 bits), the quantized distance from the camera, nearest first
+ *
+ * Shaders and models are given small identifiers the first time they are
+ * seen, and values that do not fit their field are rejected with an exception
+ * rather than truncated into another object's state. The identifiers must be
+ * reset when models or shaders are destroyed, so that a new object at a reused
+ * address is not mistaken for the old one and the fields do not run out. Objects are identified by the order they were added in, and sorted with
+ * a radix sort into arrays that are kept between frames, so a frame with no more
+ * objects than an earlier one does not allocate.
+ */
+class RenderQueue
+{
+public:
+	static const unsigned int passBits = 2;
+	static const unsigned int shaderBits = 12;
+	static const unsigned int materialSetBits = 6;
+	static const unsigned int modelBits = 20;
+	static const unsigned int depthBits = 24;
+
+	/**
+	 * The key bits that must be equal for objects to be drawn together, everything but the depth.
+	 */
+	static const uint64_t stateMask = ~((uint64_t(1) << depthBits) - 1);
+
+private:
+	std::vector<uint64_t> m_Keys;
+	std::vector<unsigned int> m_Order;
+	std::vector<uint64_t> m_SwapKeys;
+	std::vector<unsigned int> m_SwapOrder;
+
+	std::unordered_map<const void*, uint32_t> m_ShaderIds;
+	std::unordered_map<const void*, uint32_t> m_ModelIds;
+
+public:
+	/**
+	 * Remove all objects, keeping the memory for the next frame.
+	 */
+	void clear();
+
+	/**
+	 * Add an object.
+	 *
+	 * @param p_Key the key of the object, see createKey
+	 * @return the index of the object, the number of objects added before it
+	 */
+	unsigned int add(uint64_t p_Key);
+
+	/**
+	 * Create the key of an object.
+	 *
+	 * @param p_Pass the pass the object is drawn in, lower passes first
+	 * @param p_Shader the shader the object is drawn with, only used to tell shaders apart
+	 * @param p_MaterialSet the material set the object is drawn with
+	 * @param p_Model the model the object is drawn with, only used to tell models apart
+	 * @param p_Depth the distance from the camera divided by the far distance, clamped to [0, 1]
+	 * @throws GraphicsException if the pass or material set is too large, or there are too many shaders or models
+	 */
+	uint64_t createKey(unsigned int p_Pass, const void* p_Shader, unsigned int p_MaterialSet,
+		const void* p_Model, float p_Depth);
+
+	/**
+	 * Forget the identifiers given to shaders and models. Keys created before
+	 * the reset must not be compared to keys created after it.
+	 */
+	void resetIds();
+
+	/**
+	 * Sort the objects by their keys. Objects with equal keys keep the order they were added in.
+	 */
+	void sort();
+
+	/**
+	 * @return the number of objects
+	 */
+	unsigned int getSize() const;
+
+	/**
+	 * The object indices in sorted order, after sort.
+	 */
+	const std::vector<unsigned int>& getOrder() const;
+
+	/**
+	 * The keys in sorted order, after sort.
+	 */
+	const std::vector<uint64_t>& getKeys() const;
+
+	/**
+	 * Find the end of a run of objects with the same state, which can be drawn together.
+	 *
+	 * @param p_Start the position in the sorted order where the run starts
+	 * @return the position after the last object of the run
+	 */
+	unsigned int getRunEnd(unsigned int p_Start) const;
+
+	/**
+	 * Get the pass stored in a key.
+	 */
+	static unsigned int getPass(uint64_t p_Key);
+
+private:
+	static uint32_t getId(std::unordered_map<const void*, uint32_t>& p_Ids, const void* p_Object, unsigned int p_Bits);
+};
@@ -15,13 +15,20 @@ struct Renderable
 	ModelDefinition *model;
 	DirectX::XMFLOAT4X4 world;
 	DirectX::XMFLOAT4X4 invTransposeWorld;
-	const std::vector<DirectX::XMFLOAT4X4> *finalTransforms;
+	const DirectX::XMFLOAT4X4 *finalTransforms;
+	unsigned int numFinalTransforms;
 	const DirectX::XMFLOAT3 *colorTone;
 	ParticleInstance::ptr particles;
 	int materialSet;
+	/**
+	 * One bit for each view the renderable may be visible in, see DeferredRenderer::View.
+	 * All bits are set for renderables that have not been culled.
+	 */
+	unsigned int visibleViews;
 
 	Renderable(Type p_Type, ModelDefinition *p_Model, const DirectX::XMFLOAT4X4& p_World,
-		const std::vector<DirectX::XMFLOAT4X4>* p_FinalTransforms = nullptr, 
+		const DirectX::XMFLOAT4X4* p_FinalTransforms = nullptr, 
+		unsigned int p_NumFinalTransforms = 0,
 		const DirectX::XMFLOAT3 *p_ColorTone = nullptr,
 		int p_MaterialSet = 0)
 	{
@@ -32,6 +39,7 @@ struct Renderable
 		world = p_World;
 		colorTone = p_ColorTone;
 		materialSet = p_MaterialSet;
+		visibleViews = ~0u;
 
 		XMStoreFloat4x4(&invTransposeWorld, XMMatrixTranspose(XMMatrixInverse(nullptr, XMLoadFloat4x4(&world)))); 
 		invTransposeWorld._41 = 0.f;
@@ -40,6 +48,30 @@ struct Renderable
 		invTransposeWorld._44 = 1.f;
 
 		finalTransforms = p_FinalTransforms;
+		numFinalTransforms = p_NumFinalTransforms;
+	}
+
+	/**
+	 * Create a renderable from an already calculated inverse transpose world matrix
+	 * and the views it has been culled against.
+	 */
+	Renderable(Type p_Type, ModelDefinition *p_Model, const DirectX::XMFLOAT4X4& p_World,
+		const DirectX::XMFLOAT4X4& p_InvTransposeWorld,
+		const DirectX::XMFLOAT4X4* p_FinalTransforms, 
+		unsigned int p_NumFinalTransforms,
+		const DirectX::XMFLOAT3 *p_ColorTone,
+		int p_MaterialSet,
+		unsigned int p_VisibleViews)
+		:	type(p_Type),
+			model(p_Model),
+			world(p_World),
+			invTransposeWorld(p_InvTransposeWorld),
+			finalTransforms(p_FinalTransforms),
+			numFinalTransforms(p_NumFinalTransforms),
+			colorTone(p_ColorTone),
+			materialSet(p_MaterialSet),
+			visibleViews(p_VisibleViews)
+	{
 	}
 
 	Renderable(ParticleInstance::ptr p_Particles)
@@ -49,8 +81,10 @@ struct Renderable
 			world(p_Particles->getWorldMatrix()),
 			invTransposeWorld(),
 			finalTransforms(nullptr),
+			numFinalTransforms(0),
 			colorTone(nullptr),
-			materialSet(0)
+			materialSet(0),
+			visibleViews(~0u)
 	{
 	}
 
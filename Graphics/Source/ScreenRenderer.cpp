@@ -24,6 +24,7 @@ ScreenRenderer::ScreenRenderer(void)
 	m_ConstantBuffer = nullptr;
 	m_ObjectConstantBuffer = nullptr;
 	m_HUD_Shader = nullptr;
+	m_HUD_CompactShader = nullptr;
 	m_TransparencyAdditiveBlend = nullptr;
 }
 
@@ -43,6 +44,7 @@ ScreenRenderer::~ScreenRenderer(void)
 	SAFE_DELETE(m_ConstantBuffer);
 	SAFE_DELETE(m_ObjectConstantBuffer);
 	SAFE_DELETE(m_HUD_Shader);
+	SAFE_DELETE(m_HUD_CompactShader);
 	SAFE_RELEASE(m_TransparencyAdditiveBlend);
 }
 
@@ -68,6 +70,16 @@ void ScreenRenderer::initialize(ID3D11Device *p_Device, ID3D11DeviceContext *p_D
 	m_HUD_Shader = WrapperFactory::getInstance()->createShader(L"assets/shaders/HUD_Shader.hlsl", "VS,PS", "5_0",
 		ShaderType::VERTEX_SHADER | ShaderType::PIXEL_SHADER);
 
+	// Models loaded from compact files only need the position and texture coordinate
+	ShaderInputElementDescription compactDesc[] =
+	{
+		{"POSITION",0, Format::R16G16B16A16_UNORM, 0, 0,	D3D11_INPUT_PER_VERTEX_DATA, 0},
+		{"COORD",	0, Format::R16G16_FLOAT, 0, 16,			D3D11_INPUT_PER_VERTEX_DATA, 0},
+	};
+	D3D_SHADER_MACRO compactDefine[2] = {{ "COMPACT_VERTEX", "1" }, nullptr };
+	m_HUD_CompactShader = WrapperFactory::getInstance()->createShader(L"assets/shaders/HUD_Shader.hlsl", compactDefine,
+		"VS,PS", "5_0", ShaderType::VERTEX_SHADER | ShaderType::PIXEL_SHADER, compactDesc, 2);
+
 	p_Device->CreateBlendState(&blendDesc, &m_TransparencyAdditiveBlend);
 	p_Device->CreateSamplerState(&samplerDesc, &m_Sampler);
 	p_Device->CreateRasterizerState(&rasterDesc, &m_RasterState);
@@ -245,24 +257,36 @@ void ScreenRenderer::renderObject(Renderable2D &p_Object)
 	m_DeviceContext->PSSetSamplers(0, 1, &m_Sampler);
 	
 	p_Object.model->vertexBuffer->setBuffer(0);
+	if (p_Object.model->indexBuffer)
+		p_Object.model->indexBuffer->setBuffer(0);
+	if (p_Object.model->vertexBoundsBuffer)
+		p_Object.model->vertexBoundsBuffer->setBuffer(4);
+	Shader *shader = p_Object.model->vertexBoundsBuffer ? m_HUD_CompactShader : m_HUD_Shader;
 
 	m_DeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
 	// Set shader.
-	m_HUD_Shader->setShader();
+	shader->setShader();
 	float data[] = { 1.0f, 1.0f, 1.f, 1.0f};
-	m_HUD_Shader->setBlendState(m_TransparencyAdditiveBlend, data);
+	shader->setBlendState(m_TransparencyAdditiveBlend, data);
 	m_DeviceContext->PSSetShaderResources(0, 1, &(p_Object.model->diffuseTexture[0].second));
 
 	const auto& material = p_Object.model->materialSets.at(0).second.at(0);
-	m_DeviceContext->Draw(material.numOfVertices, material.vertexStart);
+	if (p_Object.model->indexBuffer)
+		m_DeviceContext->DrawIndexed(material.numOfVertices, material.vertexStart, material.baseVertex);
+	else
+		m_DeviceContext->Draw(material.numOfVertices, material.vertexStart);
 
 	ID3D11ShaderResourceView *nullSrv = 0;
 	m_DeviceContext->PSSetShaderResources(0, 1, &nullSrv);
 	data[0] = data[1] = data[2] = data[3] = 0.0f; 
-	m_HUD_Shader->setBlendState(0, data);
-	m_HUD_Shader->unSetShader();
+	shader->setBlendState(0, data);
+	shader->unSetShader();
 	p_Object.model->vertexBuffer->unsetBuffer(0);
+	if (p_Object.model->indexBuffer)
+		p_Object.model->indexBuffer->unsetBuffer(0);
+	if (p_Object.model->vertexBoundsBuffer)
+		p_Object.model->vertexBoundsBuffer->unsetBuffer(4);
 	ID3D11SamplerState* const nullSamplerState = nullptr;
 	m_DeviceContext->PSSetSamplers(0,1,&nullSamplerState);
 }
\ No newline at end of file
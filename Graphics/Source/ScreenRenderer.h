@@ -21,6 +21,7 @@ private:
 	Buffer *m_ObjectConstantBuffer;
 
 	Shader *m_HUD_Shader;
+	Shader *m_HUD_CompactShader;
 
 	ID3D11BlendState *m_TransparencyAdditiveBlend;
 
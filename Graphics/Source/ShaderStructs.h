@@ -27,6 +27,10 @@ struct MaterialBuffer
 	std::string material;
 	int start;
 	int length;
+	/**
+	 * Added to the indices of an indexed model, 0 for expanded models.
+	 */
+	int baseVertex;
 };
 
 struct IndexDesc
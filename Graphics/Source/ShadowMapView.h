@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Frustum.h"
+
+#include <DirectXMath.h>
+
+/**
+ * The view and projection used to render the shadow map of a directional
+ * light, shared by the renderer and the culling so that they always agree.
+ * The matrices are transposed, as stored for the shaders.
+ */
+namespace ShadowMapView
+{
+	/**
+	 * Half the depth of the shadow volume, along the light direction.
+	 */
+	static const float depthRange = 20000.f;
+
+	/**
+	 * A light that has not been set has no direction and no shadow view.
+	 */
+	inline bool hasDirection(const DirectX::XMFLOAT3& p_Direction)
+	{
+		return p_Direction.x != 0.f || p_Direction.y != 0.f || p_Direction.z != 0.f;
+	}
+
+	/**
+	 * @param p_Center the center of the shadow map, usually the camera position
+	 * @param p_Direction the light direction, must not be zero
+	 */
+	inline DirectX::XMFLOAT4X4 createView(const DirectX::XMFLOAT3& p_Center, const DirectX::XMFLOAT3& p_Direction)
+	{
+		using namespace DirectX;
+
+		XMFLOAT4X4 view;
+		XMVECTOR pos = XMVectorSet(p_Center.x, p_Center.y, p_Center.z, 1.f);
+		XMStoreFloat4x4(&view, XMMatrixTranspose(XMMatrixLookToLH(pos,
+			XMVectorSet(p_Direction.x, p_Direction.y, p_Direction.z, 0.f), XMVectorSet(0.f, 1.f, 0.f, 0.f))));
+		return view;
+	}
+
+	/**
+	 * @param p_Size the width and height covered by the shadow map
+	 */
+	inline DirectX::XMFLOAT4X4 createProjection(float p_Size)
+	{
+		using namespace DirectX;
+
+		XMFLOAT4X4 projection;
+		XMStoreFloat4x4(&projection, XMMatrixTranspose(XMMatrixOrthographicLH(p_Size, p_Size, -depthRange, depthRange)));
+		return projection;
+	}
+
+	/**
+	 * Get the volume rendered into a shadow map. Without a light direction
+	 * nothing can be culled, so the frustum contains everything.
+	 */
+	inline Frustum createFrustum(const DirectX::XMFLOAT3& p_Center, const DirectX::XMFLOAT3& p_Direction, float p_Size)
+	{
+		if (!hasDirection(p_Direction))
+			return Frustum();
+
+		return Frustum(createView(p_Center, p_Direction), createProjection(p_Size));
+	}
+}
@@ -1,5 +1,6 @@
 #include "TextureLoader.h"
 #include "GraphicsExceptions.h"
+#include "Utilities/MemoryUtil.h"
 
 TextureLoader::TextureLoader(ID3D11Device* p_Device, ID3D11DeviceContext* p_DeviceContext)
 {
@@ -92,6 +93,109 @@ ID3D11ShaderResourceView* TextureLoader::createTextureFromFile(const char* p_Fil
 	return textureSRV;
 }
 
+ID3D11ShaderResourceView* TextureLoader::createTextureFromFile(const char* p_Filename, const TextureTable::Texture& p_Texture)
+{
+	ID3D11Resource*				textureResource = nullptr;
+	ID3D11ShaderResourceView*	textureSRV = nullptr;
+
+	std::vector<wchar_t> filename(strlen(p_Filename)+1);
+	mbstowcs(filename.data(), p_Filename, strlen(p_Filename)+1);
+
+	HRESULT hr = S_OK;
+	if(p_Texture.m_Container == MaterialBundleFormat::DDS_CONTAINER)
+	{
+		DirectX::DDS_ALPHA_MODE mode;
+
+		hr = CreateDDSTextureFromFile(m_Device, filename.data(), &textureResource, &textureSRV, 0, &mode);
+		if(FAILED(hr))
+		{
+			throw TextureLoaderException("DDS Texture load failed: " + std::string(p_Filename), __LINE__, __FILE__);
+		}
+	}
+	else
+	{
+		hr = CreateWICTextureFromFile(m_Device, m_DeviceContext, filename.data(), &textureResource, &textureSRV, 0);
+		if(FAILED(hr))
+		{
+			throw TextureLoaderException("WIC Texture load failed: " + std::string(p_Filename), __LINE__, __FILE__);
+		}
+	}
+
+	const bool matches = matchesTableTexture(textureResource, p_Texture);
+	if(textureResource != nullptr)
+		textureResource->Release();
+	if(!matches)
+	{
+		SAFE_RELEASE(textureSRV);
+		throw TextureLoaderException("Texture does not match the texture table, rebuild the table: " + std::string(p_Filename),
+			__LINE__, __FILE__);
+	}
+
+	return textureSRV;
+}
+
+bool TextureLoader::matchesTableTexture(ID3D11Resource* p_Resource, const TextureTable::Texture& p_Texture)
+{
+	// WIC decides the format when decoding and images have no mips, so the table
+	// only records the layout of dds textures
+	if(p_Texture.m_Container != MaterialBundleFormat::DDS_CONTAINER)
+		return true;
+
+	if(!p_Resource)
+		return false;
+
+	D3D11_RESOURCE_DIMENSION dimension;
+	p_Resource->GetType(&dimension);
+	if(dimension != D3D11_RESOURCE_DIMENSION_TEXTURE2D)
+		return false;
+
+	ID3D11Texture2D* texture = nullptr;
+	if(FAILED(p_Resource->QueryInterface(__uuidof(ID3D11Texture2D), (void**)&texture)))
+		return false;
+	D3D11_TEXTURE2D_DESC desc;
+	texture->GetDesc(&desc);
+	texture->Release();
+
+	return desc.Format == (DXGI_FORMAT)p_Texture.m_Format
+		&& desc.Width == p_Texture.m_Width
+		&& desc.Height == p_Texture.m_Height
+		&& desc.MipLevels == p_Texture.m_MipLevels
+		&& desc.ArraySize == p_Texture.m_ArraySize;
+}
+
+ID3D11ShaderResourceView* TextureLoader::createTextureFromMemory(const char* p_Data, size_t p_Size)
+{
+	static const char ddsMagic[4] = { 'D', 'D', 'S', ' ' };
+
+	ID3D11Resource*				textureResource = nullptr;
+	ID3D11ShaderResourceView*	textureSRV = nullptr;
+	const uint8_t* data = reinterpret_cast<const uint8_t*>(p_Data);
+
+	HRESULT hr = S_OK;
+	if(p_Size >= sizeof(ddsMagic) && memcmp(p_Data, ddsMagic, sizeof(ddsMagic)) == 0)
+	{
+		DirectX::DDS_ALPHA_MODE mode;
+
+		hr = CreateDDSTextureFromMemory(m_Device, data, p_Size, &textureResource, &textureSRV, 0, &mode);
+		if(FAILED(hr))
+		{
+			throw TextureLoaderException("DDS Texture load from memory failed", __LINE__, __FILE__);
+		}
+	}
+	else
+	{
+		hr = CreateWICTextureFromMemory(m_Device, m_DeviceContext, data, p_Size, &textureResource, &textureSRV, 0);
+		if(FAILED(hr))
+		{
+			throw TextureLoaderException("WIC Texture load from memory failed", __LINE__, __FILE__);
+		}
+	}
+	if(textureResource != nullptr)
+		textureResource->Release();
+
+	return textureSRV;
+}
+
 char* TextureLoader::checkCompability(char* p_FileType)
 {
 	unsigned int size = m_CompabilityList.size();
@@ -128,4 +232,16 @@ HRESULT TextureLoader::CreateDDSTextureFromFile(ID3D11Device* p_Device, const wc
 	ID3D11Resource** p_Texture, ID3D11ShaderResourceView** p_TextureView, size_t p_MaxSize, DirectX::DDS_ALPHA_MODE* p_AlphaMode)
 {
 	return DirectX::CreateDDSTextureFromFile(p_Device, p_FileName, p_Texture, p_TextureView, p_MaxSize, p_AlphaMode);
+}
+
+HRESULT TextureLoader::CreateWICTextureFromMemory(ID3D11Device* p_Device, ID3D11DeviceContext* p_Context,
+	const uint8_t* p_Data, size_t p_Size, ID3D11Resource** p_Texture, ID3D11ShaderResourceView** p_TextureView, size_t p_MaxSize)
+{
+	return DirectX::CreateWICTextureFromMemory(p_Device, p_Context, p_Data, p_Size, p_Texture, p_TextureView, p_MaxSize);
+}
+
+HRESULT TextureLoader::CreateDDSTextureFromMemory(ID3D11Device* p_Device, const uint8_t* p_Data, size_t p_Size,
+	ID3D11Resource** p_Texture, ID3D11ShaderResourceView** p_TextureView, size_t p_MaxSize, DirectX::DDS_ALPHA_MODE* p_AlphaMode)
+{
+	return DirectX::CreateDDSTextureFromMemory(p_Device, p_Data, p_Size, p_Texture, p_TextureView, p_MaxSize, p_AlphaMode);
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 #include "WICTextureLoader.h"
 #include "DDSTextureLoader.h"
 
+#include <TextureTable.h>
+
 #include <d3d11.h>
 #include <vector>
 
@@ -37,12 +39,39 @@ public:
 	 * @return Success = A pointer to the loaded texture, Fail = nullptr.
 	 */
 	ID3D11ShaderResourceView* createTextureFromFile(const char* p_Filename);
+	/**
+	 * Used to load textures described by a texture table. The loader is picked
+	 * from the container recorded in the table instead of the file extension.
+	 * @param p_Filename, path of the file to be loaded.
+	 * @param p_Texture, the table entry of the texture.
+	 * @return Success = A pointer to the loaded texture, Fail = nullptr.
+	 */
+	ID3D11ShaderResourceView* createTextureFromFile(const char* p_Filename, const TextureTable::Texture& p_Texture);
+	/**
+	 * Used to load textures already in memory, such as entries of an asset archive.
+	 * Data starting with the DDS magic number is loaded as dds, anything else with WIC.
+	 * @param p_Data, the contents of the texture file.
+	 * @param p_Size, the size of the contents in bytes.
+	 * @return Success = A pointer to the loaded texture, Fail = nullptr.
+	 */
+	ID3D11ShaderResourceView* createTextureFromMemory(const char* p_Data, size_t p_Size);
 protected:
 	virtual HRESULT CreateWICTextureFromFile(ID3D11Device* p_Device, ID3D11DeviceContext* p_Context,
 		const wchar_t* p_Filename, ID3D11Resource** p_Texture, ID3D11ShaderResourceView** p_TextureView, size_t p_MaxSize);
 	
 	virtual HRESULT CreateDDSTextureFromFile(ID3D11Device* p_Device, const wchar_t* p_Filename, ID3D11Resource** p_Texture,
 		ID3D11ShaderResourceView** p_TextureView, size_t p_MaxSize, DirectX::DDS_ALPHA_MODE* p_AlphaMode);
+
+	virtual HRESULT CreateWICTextureFromMemory(ID3D11Device* p_Device, ID3D11DeviceContext* p_Context,
+		const uint8_t* p_Data, size_t p_Size, ID3D11Resource** p_Texture, ID3D11ShaderResourceView** p_TextureView, size_t p_MaxSize);
+
+	virtual HRESULT CreateDDSTextureFromMemory(ID3D11Device* p_Device, const uint8_t* p_Data, size_t p_Size, ID3D11Resource** p_Texture,
+		ID3D11ShaderResourceView** p_TextureView, size_t p_MaxSize, DirectX::DDS_ALPHA_MODE* p_AlphaMode);
 private:
 	char* checkCompability(char* p_FileType);
+	/**
+	 * Check that a loaded texture has the format, size, mip levels and array size
+	 * recorded in the texture table, which the material bundles were built against.
+	 */
+	static bool matchesTableTexture(ID3D11Resource* p_Resource, const TextureTable::Texture& p_Texture);
 };
\ No newline at end of file
@@ -115,6 +115,29 @@ public:
 	 */
 	virtual bool createModel(const char *p_ModelId, const char *p_Filename) = 0;
 
+	/**
+	 * Reads a model file without creating any graphics resources, so that the
+	 * next createModel with the same file only has to create the buffers.
+	 * May be called from any thread, unlike createModel.
+	 *
+	 * @param p_Filename the filename of the model
+	 * @param p_TextureFound called with each texture the model will load as soon as it is known,
+	 *			before the rest of the file has been read, may be null
+	 * @param p_Userdata user defined data passed to p_TextureFound
+	 * @throws GraphicsException if the file could not be read
+	 */
+	virtual void preloadModel(const char *p_Filename, loadModelTextureCallBack p_TextureFound, void *p_Userdata) = 0;
+
+	/**
+	 * Drops a model read by preloadModel that will not be created, such as when
+	 * the load was abandoned or the model was already loaded. Does nothing if the
+	 * file has not been preloaded or the preloaded model was already created.
+	 * May be called from any thread.
+	 *
+	 * @param p_Filename the filename passed to preloadModel
+	 */
+	virtual void discardPreloadedModel(const char *p_Filename) = 0;
+
 	/**
 	* Release a previously created model.
 	*
@@ -183,6 +206,28 @@ public:
 	 */
 	virtual bool createTexture(const char *p_TextureId, const char *p_Filename) = 0;
 
+	/**
+	 * Creates a new texture from the contents of a texture file, such as an entry of an asset archive.
+	 * WARNING: Should only be called by the resource manager.
+	 *
+	 * @param p_TextureId the ID of the texture
+	 * @param p_Data the contents of a dds or WIC supported image file, only used during the call
+	 * @param p_Size the size of the contents in bytes
+	 * @return true if the texture was successfully loaded, otherwise false
+	 */
+	virtual bool createTextureFromMemory(const char *p_TextureId, const char *p_Data, size_t p_Size) = 0;
+
+	/**
+	 * Load a texture table (.btt) built by BinaryConverter -texturetable. Textures in the
+	 * table are loaded without checking their file type, and static models with a material
+	 * bundle (.bmb) built against the table get their textures from the bundle.
+	 * Should be called before any models are loaded.
+	 *
+	 * @param p_Filename the filename of the texture table
+	 * @return true if the table was loaded, otherwise false and no table is used
+	 */
+	virtual bool loadTextureTable(const char *p_Filename) = 0;
+
 	/**
 	 * Release a previously created texture.
 	 *
@@ -380,6 +425,12 @@ public:
 	 * @param p_ModelId the ID of the model to be rendered
 	 */
 	virtual void renderModel(InstanceId p_ModelId) = 0;
+	/**
+	 * Renders every existing model instance. Use instead of calling renderModel
+	 * for each instance, only the transforms that have changed are recalculated.
+	 * The instances are culled when the frame is drawn, after the frame's lights have been set.
+	 */
+	virtual void renderModels(void) = 0;
 	/**
 	 * Renders the created Skydome.
 	 */
@@ -419,6 +470,18 @@ public:
 	 */
 	virtual void animationPose(int p_Instance, const DirectX::XMFLOAT4X4* p_Pose, unsigned int p_Size) = 0;
 
+	/**
+	 * Let the model read its pose directly from memory owned by the animation system,
+	 * instead of copying it with animationPose every frame. Calling animationPose
+	 * switches the model back to its own copy.
+	 *
+	 * @param p_Instance the model instance to update the pose of
+	 * @param p_Pose the location of a pointer to the current pose, read every time the model
+	 *			is rendered. Must stay valid until the source is replaced or the instance is removed.
+	 * @param p_Size the number of matrices in the pose
+	 */
+	virtual void setAnimationPoseSource(int p_Instance, const DirectX::XMFLOAT4X4* const* p_Pose, unsigned int p_Size) = 0;
+
 	/**
 	 * Gets the amount of VRAM usage of the program.
 	 *
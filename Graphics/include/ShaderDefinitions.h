@@ -23,11 +23,15 @@ enum class Format
 	R32G32B32A32_UINT = 3,
 	R32G32B32_FLOAT = 6,
 	R32G32B32_UINT = 7,
+	R16G16B16A16_UNORM = 11,
 	R32G32_FLOAT = 16,
 	R32G32_UINT = 17,
 	R32_FLOAT = 41,
 	R32_UINT = 42,
 	R8G8B8A8_UNORM = 28,
+	R8G8B8A8_UINT = 30,
+	R16G16_FLOAT = 34,
+	R16G16_SNORM = 37,
 };
 
 struct ShaderInputElementDescription
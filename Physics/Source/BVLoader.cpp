@@ -1,8 +1,13 @@
 #include "BVLoader.h"
-#include <sstream>
+
+#include <MappedFile.h>
+
+#include <algorithm>
+#include <cstring>
 
 BVLoader::BVLoader(void)
 {
+	clearData();
 }
 
 
@@ -22,16 +27,68 @@ bool BVLoader::loadBinaryFile(std::string p_FilePath)
 	clearData();
 
 	//Pick out file extension
+	if(p_FilePath.length() < 3)
+	{
+		return false;
+	}
 	std::string type = p_FilePath.substr( p_FilePath.length() - 3, 3);
 
+	if(type == "bbv")
+	{
+		std::ifstream input(p_FilePath, std::istream::in | std::istream::binary);
+		if(!input)
+		{
+			return false;
+		}
+		return readCompactBoundingVolume(input);
+	}
 
-	//std::ifstream input(p_FilePath, std::istream::in | std::istream::binary);
-	std::ifstream input(p_FilePath, std::istream::in);
-	if(!input || type != "txc")
+	MappedFile input;
+	if(type != "txc" || !input.open(p_FilePath))
 	{
 		return false;
 	}
-	readHeader(&input);
+	TextTokenizer tokenizer(input.getData(), input.getSize());
+	return readTextBoundingVolume(tokenizer);
+}
+
+bool BVLoader::loadMemory(const char* p_Data, size_t p_Size)
+{
+	clearData();
+
+	if(p_Size >= sizeof(BoundingVolumeFormat::magic)
+		&& memcmp(p_Data, BoundingVolumeFormat::magic, sizeof(BoundingVolumeFormat::magic)) == 0)
+	{
+		BoundingVolumeFormat::Header header;
+		if(p_Size < sizeof(header))
+		{
+			return false;
+		}
+		memcpy(&header, p_Data, sizeof(header));
+		if(header.m_Version != BoundingVolumeFormat::version
+			|| header.m_NumTriangles < 0
+			|| (p_Size - sizeof(header)) / (sizeof(BoundingVolume) * 3) < static_cast<size_t>(header.m_NumTriangles))
+		{
+			return false;
+		}
+
+		m_BoundingVolume.resize(header.m_NumTriangles * 3);
+		memcpy(m_BoundingVolume.data(), p_Data + sizeof(header), m_BoundingVolume.size() * sizeof(BoundingVolume));
+		m_FileHeader.m_numVertex = header.m_NumTriangles * 3;
+		m_FileHeader.m_numFaces = header.m_NumTriangles;
+		m_Prescaled = true;
+		m_BoundingSphere = header.m_BoundingSphere;
+
+		return true;
+	}
+
+	TextTokenizer tokenizer(p_Data, p_Size);
+	return readTextBoundingVolume(tokenizer);
+}
+
+bool BVLoader::readTextBoundingVolume(TextTokenizer& p_Input)
+{
+	readHeader(p_Input);
 
 	if(m_FileHeader.m_numMaterial != 0)
 	{
@@ -39,7 +96,7 @@ bool BVLoader::loadBinaryFile(std::string p_FilePath)
 	}
 	if(m_FileHeader.m_numVertex > 0)
 	{
-		readBoundingVolume(&input);
+		readBoundingVolume(p_Input);
 	}
 	else
 	{
@@ -49,51 +106,45 @@ bool BVLoader::loadBinaryFile(std::string p_FilePath)
 	return true;
 }
 
-void BVLoader::readHeader(std::istream* p_Input)
+void BVLoader::readHeader(TextTokenizer& p_Input)
 {
 	Header tempHeader;
-	std::string line;
-	/*byteToString(p_Input, tempHeader.m_modelName);
-	byteToInt(p_Input, tempHeader.m_numMaterial);
-	byteToInt(p_Input, tempHeader.m_numVertex);
-	byteToInt(p_Input, tempHeader.m_numMaterialBuffer);
-	byteToInt(p_Input, tempHeader.m_numJoints);
-	byteToInt(p_Input, tempHeader.m_numFrames);*/
-	std::getline(*p_Input, line);
-	std::string temp;
-	std::getline(*p_Input, line);
-	std::stringstream ss(line);
-	ss >> temp >> tempHeader.m_numMaterial;
-	std::getline(*p_Input, line);
-	ss = std::stringstream(line);
-	ss >> temp >> tempHeader.m_modelName;
-	std::getline(*p_Input, line);
-	ss = std::stringstream(line);
-	ss >> temp >> tempHeader.m_numVertex;
-	std::getline(*p_Input, line);
-	ss = std::stringstream(line);
-	ss >> temp >> tempHeader.m_numFaces;
+	tempHeader.m_numMaterial = tempHeader.m_numVertex = tempHeader.m_numFaces = 0;
+	p_Input.nextLine();
+	p_Input.nextLine();
+	p_Input.readToken();
+	p_Input.readInt(tempHeader.m_numMaterial);
+	p_Input.nextLine();
+	p_Input.readToken();
+	p_Input.readString(tempHeader.m_modelName);
+	p_Input.nextLine();
+	p_Input.readToken();
+	p_Input.readInt(tempHeader.m_numVertex);
+	p_Input.nextLine();
+	p_Input.readToken();
+	p_Input.readInt(tempHeader.m_numFaces);
 
 	m_FileHeader = tempHeader;
 }
 
 
-void BVLoader::readBoundingVolume(std::istream* p_Input)
+void BVLoader::readBoundingVolume(TextTokenizer& p_Input)
 {
-	std::vector<BoundingVolume> boundingVolume;//(p_NumberOfVertex);
+	std::vector<BoundingVolume> boundingVolume;
 	std::vector<DirectX::XMFLOAT4> tempVertices;
 	std::vector<DirectX::XMFLOAT3> tempFaces;
-	//p_Input->read(reinterpret_cast<char*>(boundingVolume.data()), sizeof(boundingVolume) * p_NumberOfVertex);
-	std::string line, temp;
-	std::stringstream ss;
-	std::getline(*p_Input, line);
-	std::getline(*p_Input, line);
+	tempVertices.reserve((std::max)(m_FileHeader.m_numVertex, 0));
+	tempFaces.reserve((std::max)(m_FileHeader.m_numFaces, 0));
+	p_Input.nextLine();
+	p_Input.nextLine();
 	for(int i = 0; i < m_FileHeader.m_numVertex;i++)
 	{
 		DirectX::XMFLOAT4 tv;
-		std::getline(*p_Input, line);
-		ss = std::stringstream(line);
-		ss >> temp >> tv.x >> tv.y >> tv.z;
+		p_Input.nextLine();
+		p_Input.readToken();
+		p_Input.readFloat(tv.x);
+		p_Input.readFloat(tv.y);
+		p_Input.readFloat(tv.z);
 		tv.w = 1.0f;
 
 		tv.x *= -1;
@@ -101,22 +152,26 @@ void BVLoader::readBoundingVolume(std::istream* p_Input)
 		tempVertices.push_back(tv);
 	}
 
-	std::getline(*p_Input, line);
-	std::getline(*p_Input, line);
-	std::getline(*p_Input, line);
-	std::getline(*p_Input, line);
+	p_Input.nextLine();
+	p_Input.nextLine();
+	p_Input.nextLine();
+	p_Input.nextLine();
 	
 
 	for(int i = 0; i < m_FileHeader.m_numFaces; i++)
 	{
-		std::getline(*p_Input, line);
-		ss = std::stringstream(line);
+		p_Input.nextLine();
 		DirectX::XMFLOAT3 tempFace;
-		ss >> tempFace.x >> temp >> tempFace.y >> temp >> tempFace.z;
+		p_Input.readFloat(tempFace.x);
+		p_Input.readToken();
+		p_Input.readFloat(tempFace.y);
+		p_Input.readToken();
+		p_Input.readFloat(tempFace.z);
 
 		tempFaces.push_back(tempFace);
 	}
 
+	boundingVolume.reserve(tempFaces.size() * 3);
 	for(int i = 0; i < m_FileHeader.m_numFaces; i++)
 	{
 		BoundingVolume tempBV;
@@ -129,8 +184,7 @@ void BVLoader::readBoundingVolume(std::istream* p_Input)
 		boundingVolume.push_back(tempBV);
 	}
 
-	boundingVolume.shrink_to_fit();
-	m_BoundingVolume = boundingVolume;
+	m_BoundingVolume.swap(boundingVolume);
 }
 
 //void BVLoader::byteToString(std::istream* p_Input, std::string& p_Return)
@@ -147,6 +201,36 @@ void BVLoader::readBoundingVolume(std::istream* p_Input)
 //	p_Input->read((char*)&p_Return, sizeof(int));
 //}
 
+bool BVLoader::readCompactBoundingVolume(std::istream& p_Input)
+{
+	clearData();
+
+	BoundingVolumeFormat::Header header;
+	p_Input.read(reinterpret_cast<char*>(&header), sizeof(header));
+	if(!p_Input
+		|| memcmp(header.m_Magic, BoundingVolumeFormat::magic, sizeof(header.m_Magic)) != 0
+		|| header.m_Version != BoundingVolumeFormat::version
+		|| header.m_NumTriangles < 0)
+	{
+		return false;
+	}
+
+	m_BoundingVolume.resize(header.m_NumTriangles * 3);
+	p_Input.read(reinterpret_cast<char*>(m_BoundingVolume.data()), m_BoundingVolume.size() * sizeof(BoundingVolume));
+	if(!p_Input)
+	{
+		clearData();
+		return false;
+	}
+
+	m_FileHeader.m_numVertex = header.m_NumTriangles * 3;
+	m_FileHeader.m_numFaces = header.m_NumTriangles;
+	m_Prescaled = true;
+	m_BoundingSphere = header.m_BoundingSphere;
+
+	return true;
+}
+
 BVLoader::Header BVLoader::getLevelHeader()
 {
 	return m_FileHeader;
@@ -157,6 +241,16 @@ const std::vector<BVLoader::BoundingVolume>& BVLoader::getBoundingVolumes()
 	return m_BoundingVolume;
 }
 
+bool BVLoader::isPrescaled() const
+{
+	return m_Prescaled;
+}
+
+const DirectX::XMFLOAT4& BVLoader::getBoundingSphere() const
+{
+	return m_BoundingSphere;
+}
+
 void BVLoader::clearData()
 {
 	m_FileHeader.m_modelName = "";
@@ -164,4 +258,6 @@ void BVLoader::clearData()
 	m_FileHeader.m_numMaterial = 0;
 	m_FileHeader.m_numVertex = 0;
 	m_BoundingVolume.clear();
+	m_Prescaled = false;
+	m_BoundingSphere = DirectX::XMFLOAT4(0.f, 0.f, 0.f, 0.f);
 }
\ No newline at end of file
@@ -1,4 +1,7 @@
 #pragma once
+#include <BoundingVolumeFormat.h>
+#include <TextTokenizer.h>
+
 #include <fstream>
 #include <DirectXMath.h>
 #include <vector>
@@ -23,16 +26,39 @@ public:
 private:	
 	std::vector<BoundingVolume> m_BoundingVolume;
 	Header m_FileHeader;
+	bool m_Prescaled;
+	DirectX::XMFLOAT4 m_BoundingSphere;
 public:
 	BVLoader(void);
 	~BVLoader(void);
 
 	/**
-	 * Opens a binary file then reads the information stream and saves the information in vectors of structs.
+	 * Opens a bounding volume file then reads the information stream and saves the information in vectors of structs.
+	 * Both the binary .bbv format and the older .txc text format are supported.
 	 * 
 	 * @param p_FilePath, the absolut path to the source file.
 	 */
 	bool loadBinaryFile(std::string p_FilePath);
+
+	/**
+	 * Reads a complete .bbv bounding volume from a stream. The triangle corners
+	 * are read with a single bulk read.
+	 *
+	 * @param p_Input the stream to read from, opened in binary mode
+	 * @return true if the header is valid and all corners could be read
+	 */
+	bool readCompactBoundingVolume(std::istream& p_Input);
+
+	/**
+	 * Reads a bounding volume file that is already in memory, such as an entry of
+	 * an asset archive. Files starting with the .bbv magic are read as .bbv, anything
+	 * else as .txc text.
+	 *
+	 * @param p_Data the contents of the file
+	 * @param p_Size the size of the contents in bytes
+	 * @return true if the volume could be read
+	 */
+	bool loadMemory(const char* p_Data, size_t p_Size);
 	
 	/**
 	 * Use this function to de-allocate the memory in loader vectors.
@@ -52,12 +78,39 @@ public:
 	 * @returns a vector of the struct BoundingVolume.
 	 */
 	const std::vector<BVLoader::BoundingVolume>& getBoundingVolumes();
+
+	/**
+	 * Returns if the loaded corners are already in meters. The .txc format is in centimeters.
+	 *
+	 * @return true if the corners were loaded from a .bbv file
+	 */
+	bool isPrescaled() const;
+
+	/**
+	 * Returns the bounding sphere stored in a .bbv file, xyz is the center and w the radius.
+	 * Only valid if isPrescaled returns true.
+	 *
+	 * @return the precomputed bounding sphere in meters
+	 */
+	const DirectX::XMFLOAT4& getBoundingSphere() const;
 	//void byteToInt(std::istream* p_Input, int& p_Return);
 	//void byteToString(std::istream* p_Input, std::string& p_Return);
 
-	void readHeader(std::istream* p_Input);
-	void readBoundingVolume(std::istream* p_Input);
+	/**
+	 * Reads the header of a .txc file.
+	 *
+	 * @param p_Input the tokenizer, positioned before the first line.
+	 */
+	void readHeader(TextTokenizer& p_Input);
+
+	/**
+	 * Reads the vertices and faces of a .txc file, following the header.
+	 *
+	 * @param p_Input the tokenizer, positioned after the header.
+	 */
+	void readBoundingVolume(TextTokenizer& p_Input);
 
 private:
+	bool readTextBoundingVolume(TextTokenizer& p_Input);
 	void clearData();
 };
\ No newline at end of file
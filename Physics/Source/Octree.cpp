@@ -3,6 +3,9 @@
 #include "Collision.h"
 #include "Sphere.h"
 
+#include <algorithm>
+#include <cfloat>
+
 using namespace DirectX;
 
 Octree::Node::Node(const DirectX::XMFLOAT4& p_MinPos, const DirectX::XMFLOAT4& p_MaxPos) :
@@ -72,6 +75,58 @@ void Octree::Node::addBody(const Volume& p_Body)
 	}
 }
 
+void Octree::Node::addBodies(std::vector<Volume>& p_Bodies)
+{
+	size_t numSmall = 0;
+	for (const auto& body : p_Bodies)
+	{
+		if (isLarge(body))
+		{
+			m_LargeBodies.push_back(body);
+		}
+		else
+		{
+			p_Bodies[numSmall++] = body;
+		}
+	}
+	p_Bodies.resize(numSmall);
+
+	if (p_Bodies.empty())
+		return;
+
+	if (m_IsLeaf)
+	{
+		if (m_NumBodies + p_Bodies.size() <= bodiesPerLeaf)
+		{
+			for (const auto& body : p_Bodies)
+			{
+				m_Bodies[m_NumBodies] = body;
+				++m_NumBodies;
+			}
+			return;
+		}
+
+		p_Bodies.insert(p_Bodies.end(), m_Bodies.begin(), m_Bodies.begin() + m_NumBodies);
+		m_NumBodies = 0;
+		createChildren();
+	}
+
+	std::vector<Volume> childBodies;
+	childBodies.reserve(p_Bodies.size());
+	for (auto& childNode : m_Children)
+	{
+		childBodies.clear();
+		for (const auto& body : p_Bodies)
+		{
+			if (Collision::AABBvsSphereIntersect(childNode->m_MinPos, childNode->m_MaxPos, *body.sphere))
+			{
+				childBodies.push_back(body);
+			}
+		}
+		childNode->addBodies(childBodies);
+	}
+}
+
 void Octree::Node::addBodyIfIntersect(const Volume& p_Body)
 {
 	if (Collision::AABBvsSphereIntersect(m_MinPos, m_MaxPos, *p_Body.sphere))
@@ -208,6 +263,51 @@ void Octree::addBody(BodyHandle p_Body, const Sphere* p_Sphere)
 	m_RootNode->addBody(Volume(p_Body, p_Sphere));
 }
 
+void Octree::addBodies(const std::vector<std::pair<BodyHandle, const Sphere*>>& p_Bodies)
+{
+	if (p_Bodies.empty())
+		return;
+
+	if (!m_RootNode)
+	{
+		XMFLOAT4 boundsMin(FLT_MAX, FLT_MAX, FLT_MAX, 1.f);
+		XMFLOAT4 boundsMax(-FLT_MAX, -FLT_MAX, -FLT_MAX, 1.f);
+		for (const auto& body : p_Bodies)
+		{
+			const XMFLOAT4 center = body.second->getPosition();
+			const float radius = body.second->getRadius();
+			boundsMin.x = (std::min)(boundsMin.x, center.x - radius);
+			boundsMin.y = (std::min)(boundsMin.y, center.y - radius);
+			boundsMin.z = (std::min)(boundsMin.z, center.z - radius);
+			boundsMax.x = (std::max)(boundsMax.x, center.x + radius);
+			boundsMax.y = (std::max)(boundsMax.y, center.y + radius);
+			boundsMax.z = (std::max)(boundsMax.z, center.z + radius);
+		}
+
+		// Keep the root a cube, like the roots grown by addBody
+		const float halfSize = (std::max)((std::max)(boundsMax.x - boundsMin.x, boundsMax.y - boundsMin.y), boundsMax.z - boundsMin.z) * 0.5f;
+		const XMFLOAT3 center(
+			(boundsMin.x + boundsMax.x) * 0.5f,
+			(boundsMin.y + boundsMax.y) * 0.5f,
+			(boundsMin.z + boundsMax.z) * 0.5f);
+		m_RootNode.reset(new Node(XMFLOAT4(center.x - halfSize, center.y - halfSize, center.z - halfSize, 1.f),
+			XMFLOAT4(center.x + halfSize, center.y + halfSize, center.z + halfSize, 1.f)));
+	}
+
+	std::vector<Volume> volumes;
+	volumes.reserve(p_Bodies.size());
+	for (const auto& body : p_Bodies)
+	{
+		while (!Collision::SphereInsideAABB(getMinPos(), getMaxPos(), *body.second))
+		{
+			increaseSize(body.second->getPosition());
+		}
+		volumes.push_back(Volume(body.first, body.second));
+	}
+
+	m_RootNode->addBodies(volumes);
+}
+
 void Octree::removeBody(BodyHandle p_Body, const Sphere* p_Sphere)
 {
 	if (!m_RootNode)
@@ -59,6 +59,7 @@ private:
 		size_t getBodyCount() const;
 
 		void addBody(const Volume& p_Body);
+		void addBodies(std::vector<Volume>& p_Bodies);
 		void addBodyIfIntersect(const Volume& p_Body);
 		void removeBody(BodyHandle p_Body, const Sphere* p_Sphere);
 
@@ -104,6 +105,15 @@ public:
 	void reset();
 
 	void addBody(BodyHandle p_Body, const Sphere* p_Sphere);
+
+	/**
+	 * Add many bodies at once, for example all static bodies of a level.
+	 * The tree is grown to fit all bodies up front and every node is split
+	 * at most once, instead of growing and splitting once per added body.
+	 *
+	 * @param p_Bodies the handles and surrounding spheres of the bodies to add
+	 */
+	void addBodies(const std::vector<std::pair<BodyHandle, const Sphere*>>& p_Bodies);
 	void removeBody(BodyHandle p_Body, const Sphere* p_Sphere);
 
 	const DirectX::XMFLOAT4& getMinPos() const;
@@ -6,7 +6,8 @@
 using namespace DirectX;
 
 Physics::Physics(void)
-	: m_GlobalGravity(30.f)
+	: m_GlobalGravity(30.f),
+	  m_BatchingStaticBodies(false)
 {}
 
 Physics::~Physics()
@@ -291,35 +292,37 @@ void Physics::addOBBToBody(BodyHandle p_BodyHandle, Vector3 p_CenterPos, Vector3
 
 BodyHandle Physics::createBVInstance(const char* p_VolumeID)
 {
-	std::vector<BVLoader::BoundingVolume> tempBV;
-	for(auto& bv : m_TemplateBVList)
+	const BVTemplate* tempBV = nullptr;
+	for(const auto& bv : m_TemplateBVList)
 	{
 		if(strcmp(bv.first.c_str(), p_VolumeID) == 0)
 		{
-			tempBV = bv.second;
+			tempBV = &bv.second;
 			break;
 		}
 	}
 
-	if(tempBV.empty())
+	if(!tempBV || tempBV->m_Corners.empty())
 	{	
 		PhysicsLogger::log(PhysicsLogger::Level::ERROR_L, "Bounding Volume from template is empty");
 		return (BodyHandle)0;
 	}
 
+	const std::vector<BVLoader::BoundingVolume>& corners = tempBV->m_Corners;
 	std::vector<Triangle> triangles;
+	triangles.reserve(corners.size() / 3);
 	Triangle triangle;
 
-	for(unsigned i = 0; i < tempBV.size() / 3; i++)
+	for(unsigned i = 0; i < corners.size() / 3; i++)
 	{
-		triangle.corners[0] = tempBV[i * 3].m_Postition;
-		triangle.corners[1] = tempBV[i * 3 + 1].m_Postition;
-		triangle.corners[2] = tempBV[i * 3 + 2].m_Postition;
+		triangle.corners[0] = corners[i * 3].m_Postition;
+		triangle.corners[1] = corners[i * 3 + 1].m_Postition;
+		triangle.corners[2] = corners[i * 3 + 2].m_Postition;
 
 		triangles.push_back(triangle);
 	}
 
-	Hull *hull = new Hull(triangles);
+	Hull *hull = new Hull(triangles, tempBV->m_Radius);
 
 	return createBody(1.f, hull, true, false);
 
@@ -334,7 +337,7 @@ void Physics::releaseBody(BodyHandle p_Body)
 	Body& removedBody = findIt->second;
 	if (removedBody.getIsImmovable())
 	{
-		m_Octree.removeBody(p_Body, removedBody.getSurroundingSphere());
+		removeFromOctree(removedBody);
 	}
 	else
 	{
@@ -346,35 +349,134 @@ void Physics::releaseBody(BodyHandle p_Body)
 
 bool Physics::createBV(const char* p_VolumeID, const char* p_FilePath)
 {
-	if(!m_BVLoader.loadBinaryFile(p_FilePath))
+	BVTemplate tempBV;
+
+	std::unique_lock<std::mutex> lock(m_BVLock);
+	auto preloaded = m_PreloadedBVs.find(p_FilePath);
+	if (preloaded != m_PreloadedBVs.end())
+	{
+		tempBV.m_Corners.swap(preloaded->second.m_Corners);
+		tempBV.m_Radius = preloaded->second.m_Radius;
+		m_PreloadedBVs.erase(preloaded);
+	}
+	else
+	{
+		lock.unlock();
+		if (!loadBVTemplate(p_FilePath, tempBV))
+		{
+			return false;
+		}
+		lock.lock();
+	}
+
+	m_TemplateBVList.push_back(std::pair<std::string, BVTemplate>(p_VolumeID, BVTemplate()));
+	m_TemplateBVList.back().second.m_Corners.swap(tempBV.m_Corners);
+	m_TemplateBVList.back().second.m_Radius = tempBV.m_Radius;
+	//PhysicsLogger::log(PhysicsLogger::Level::INFO, "CreateBV success");
+	return true;
+}
+
+bool Physics::createBVFromMemory(const char* p_VolumeID, const char* p_Data, size_t p_Size)
+{
+	BVLoader loader;
+	if(!loader.loadMemory(p_Data, p_Size))
+	{
+		PhysicsLogger::log(PhysicsLogger::Level::ERROR_L, "Loading Bounding Volume from memory error");
+		return false;
+	}
+
+	BVTemplate tempBV;
+	if(!readBVTemplate(loader, tempBV))
+	{
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(m_BVLock);
+	m_TemplateBVList.push_back(std::pair<std::string, BVTemplate>(p_VolumeID, BVTemplate()));
+	m_TemplateBVList.back().second.m_Corners.swap(tempBV.m_Corners);
+	m_TemplateBVList.back().second.m_Radius = tempBV.m_Radius;
+	return true;
+}
+
+bool Physics::preloadBV(const char* p_VolumeID, const char* p_FilePath)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_BVLock);
+		for (const auto& bv : m_TemplateBVList)
+		{
+			if (bv.first == p_VolumeID)
+			{
+				return true;
+			}
+		}
+		if (m_PreloadedBVs.count(p_FilePath) > 0)
+		{
+			return true;
+		}
+	}
+
+	BVTemplate tempBV;
+	if (!loadBVTemplate(p_FilePath, tempBV))
+	{
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(m_BVLock);
+	BVTemplate& preloaded = m_PreloadedBVs[p_FilePath];
+	preloaded.m_Corners.swap(tempBV.m_Corners);
+	preloaded.m_Radius = tempBV.m_Radius;
+	return true;
+}
+
+bool Physics::loadBVTemplate(const char* p_FilePath, BVTemplate& p_Out)
+{
+	BVLoader loader;
+	if(!loader.loadBinaryFile(p_FilePath))
 	{
 		PhysicsLogger::log(PhysicsLogger::Level::ERROR_L, "Loading Bounding Volume file error");
 		return false;
 	}
-	std::vector<BVLoader::BoundingVolume> tempBV;
-	tempBV = m_BVLoader.getBoundingVolumes();
 
-	if(tempBV.empty())
+	return readBVTemplate(loader, p_Out);
+}
+
+bool Physics::readBVTemplate(BVLoader& p_Loader, BVTemplate& p_Out)
+{
+	p_Out.m_Corners = p_Loader.getBoundingVolumes();
+
+	if(p_Out.m_Corners.empty())
 	{
 		PhysicsLogger::log(PhysicsLogger::Level::ERROR_L, "Bounding Volume from BVLoader is empty");
 		return false;
 	}
 
-	for(unsigned i = 0; i < tempBV.size(); i++)
+	if(p_Loader.isPrescaled())
 	{
-		tempBV[i].m_Postition.x *= 0.01f;
-		tempBV[i].m_Postition.y *= 0.01f;
-		tempBV[i].m_Postition.z *= 0.01f; 
+		p_Out.m_Radius = p_Loader.getBoundingSphere().w;
+		return true;
 	}
 
-	m_TemplateBVList.push_back(std::pair<std::string, std::vector<BVLoader::BoundingVolume>>(p_VolumeID, tempBV));
-	m_BVLoader.clear();
-	//PhysicsLogger::log(PhysicsLogger::Level::INFO, "CreateBV success");
+	float farthestDistance = 0.f;
+	for(auto& corner : p_Out.m_Corners)
+	{
+		corner.m_Postition.x *= BoundingVolumeFormat::scale;
+		corner.m_Postition.y *= BoundingVolumeFormat::scale;
+		corner.m_Postition.z *= BoundingVolumeFormat::scale;
+
+		float distance = XMVectorGetX(XMVector3LengthSq(XMLoadFloat4(&corner.m_Postition)));
+		if(distance > farthestDistance)
+		{
+			farthestDistance = distance;
+		}
+	}
+	p_Out.m_Radius = sqrtf(farthestDistance);
+
 	return true;
 }
 
 bool Physics::releaseBV(const char* p_VolumeID)
 {
+	std::lock_guard<std::mutex> lock(m_BVLock);
 	for(auto bv = m_TemplateBVList.begin(); bv != m_TemplateBVList.end(); bv++)
 	{
 		const char* temp = bv->first.c_str();
@@ -395,10 +497,58 @@ void Physics::releaseAllBoundingVolumes(void)
 	Body::resetBodyHandleCounter();
 	m_sphereBoundingVolume.clear();
 
+	std::lock_guard<std::mutex> lock(m_BVLock);
+	m_PreloadedBVs.clear();
+
 	m_Octree.reset();
+	m_StaticBatch.clear();
 	m_MovableBodies.clear();
 }
 
+void Physics::beginStaticBodyBatch()
+{
+	m_BatchingStaticBodies = true;
+}
+
+void Physics::endStaticBodyBatch()
+{
+	m_BatchingStaticBodies = false;
+
+	std::vector<std::pair<Octree::BodyHandle, const Sphere*>> bodies;
+	bodies.reserve(m_StaticBatch.size());
+	for (BodyHandle handle : m_StaticBatch)
+	{
+		Body* body = findBody(handle);
+		if (body)
+		{
+			bodies.push_back(std::make_pair(handle, body->getSurroundingSphere()));
+		}
+	}
+	m_StaticBatch.clear();
+
+	m_Octree.addBodies(bodies);
+}
+
+void Physics::addToOctree(Body& p_Body)
+{
+	if (m_BatchingStaticBodies)
+	{
+		m_StaticBatch.insert(p_Body.getHandle());
+		return;
+	}
+
+	m_Octree.addBody(p_Body.getHandle(), p_Body.getSurroundingSphere());
+}
+
+void Physics::removeFromOctree(Body& p_Body)
+{
+	// Bodies waiting in the batch are not in the tree yet
+	if (m_StaticBatch.erase(p_Body.getHandle()) != 0)
+		return;
+
+	m_Octree.removeBody(p_Body.getHandle(), p_Body.getSurroundingSphere());
+}
+
 void Physics::setBodyScale(BodyHandle p_BodyHandle, Vector3 p_Scale)
 {
 	Body* body = findBody(p_BodyHandle);
@@ -407,7 +557,7 @@ void Physics::setBodyScale(BodyHandle p_BodyHandle, Vector3 p_Scale)
 	
 	if (body->getIsImmovable())
 	{
-		m_Octree.removeBody(body->getHandle(), body->getSurroundingSphere());
+		removeFromOctree(*body);
 	}
 
 	XMVECTOR scale = Vector3ToXMVECTOR(&p_Scale, 0.f);
@@ -416,7 +566,7 @@ void Physics::setBodyScale(BodyHandle p_BodyHandle, Vector3 p_Scale)
 
 	if (body->getIsImmovable())
 	{
-		m_Octree.addBody(body->getHandle(), body->getSurroundingSphere());
+		addToOctree(*body);
 	}
 }
 
@@ -428,7 +578,7 @@ BodyHandle Physics::createBody(float p_Mass, BoundingVolume* p_BoundingVolume, b
 
 	if (p_IsImmovable)
 	{
-		m_Octree.addBody(insertedBody.getHandle(), insertedBody.getSurroundingSphere());
+		addToOctree(insertedBody);
 	}
 	else
 	{
@@ -585,7 +735,7 @@ void Physics::setBodyPosition( BodyHandle p_Body, Vector3 p_Position)
 
 	if (body->getIsImmovable())
 	{
-		m_Octree.removeBody(body->getHandle(), body->getSurroundingSphere());
+		removeFromOctree(*body);
 	}
 
 	Vector3 convPosition = p_Position * 0.01f;	// m
@@ -595,7 +745,7 @@ void Physics::setBodyPosition( BodyHandle p_Body, Vector3 p_Position)
 
 	if (body->getIsImmovable())
 	{
-		m_Octree.addBody(body->getHandle(), body->getSurroundingSphere());
+		addToOctree(*body);
 	}
 }
 
@@ -607,7 +757,7 @@ void Physics::setBodyVolumePosition( BodyHandle p_Body, unsigned p_Volume, Vecto
 	
 	if (body->getIsImmovable())
 	{
-		m_Octree.removeBody(body->getHandle(), body->getSurroundingSphere());
+		removeFromOctree(*body);
 	}
 
 	Vector3 convPosition = p_Position * 0.01f;	// m
@@ -615,7 +765,7 @@ void Physics::setBodyVolumePosition( BodyHandle p_Body, unsigned p_Volume, Vecto
 
 	if (body->getIsImmovable())
 	{
-		m_Octree.addBody(body->getHandle(), body->getSurroundingSphere());
+		addToOctree(*body);
 	}
 }
 
@@ -753,14 +903,14 @@ void Physics::setRotation(BodyHandle p_Body, XMMATRIX& p_Rotation)
 	
 	if (body->getIsImmovable())
 	{
-		m_Octree.removeBody(body->getHandle(), body->getSurroundingSphere());
+		removeFromOctree(*body);
 	}
 
 	body->setRotation(p_Rotation);
 
 	if (body->getIsImmovable())
 	{
-		m_Octree.addBody(body->getHandle(), body->getSurroundingSphere());
+		addToOctree(*body);
 	}
 }
 
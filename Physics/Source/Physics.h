@@ -5,25 +5,40 @@
 #include "Octree.h"
 
 #include <map>
+#include <mutex>
 #include <set>
 
 class Physics : public IPhysics
 {
 public:
 private:
+	/**
+	 * A loaded bounding volume, in meters, with the radius of its surrounding sphere.
+	 */
+	struct BVTemplate
+	{
+		std::vector<BVLoader::BoundingVolume> m_Corners;
+		float m_Radius;
+	};
+
+
 	float m_GlobalGravity;
 	float m_Timestep;
 	float m_LeftOverTime;
 	std::vector<HitData> m_HitDatas;
 	BVLoader m_BVLoader;
 	bool m_LoadBVSphereTemplateOnce;
-	std::vector<std::pair<std::string, std::vector<BVLoader::BoundingVolume>>> m_TemplateBVList;
+	std::vector<std::pair<std::string, BVTemplate>> m_TemplateBVList;
+	std::map<std::string, BVTemplate> m_PreloadedBVs;
+	std::mutex m_BVLock;
 	std::vector<BVLoader::BoundingVolume> m_sphereBoundingVolume;
 	bool m_IsServer;
 	std::vector<DirectX::XMFLOAT3> m_BoxTriangleIndex;
 
 	std::map<BodyHandle, Body> m_Bodies;
 	Octree m_Octree;
+	bool m_BatchingStaticBodies;
+	std::set<BodyHandle> m_StaticBatch;
 	std::set<BodyHandle> m_PotentialIntersections;
 	std::set<BodyHandle> m_MovableBodies;
 
@@ -46,11 +61,16 @@ public:
 
 	BodyHandle createBVInstance(const char* p_VolumeID) override;
 	bool createBV(const char* m_ModelID, const char* m_FilePath) override;
+	bool createBVFromMemory(const char* p_VolumeID, const char* p_Data, size_t p_Size) override;
+	bool preloadBV(const char* p_VolumeID, const char* p_FilePath) override;
 
 	bool releaseBV(const char* p_ModelID) override; 
 	void releaseBody(BodyHandle p_Body) override;
 	void releaseAllBoundingVolumes(void) override;
 
+	void beginStaticBodyBatch() override;
+	void endStaticBodyBatch() override;
+
 	void setGlobalGravity(float p_Gravity) override;
 	void setBodyGravity(BodyHandle p_Body, float p_Gravity) override;
 	bool getBodyInAir(BodyHandle p_Body) override;
@@ -97,8 +117,14 @@ private:
 
 	BoundingVolume* getVolume(BodyHandle p_Body);
 
+	void addToOctree(Body& p_Body);
+	void removeFromOctree(Body& p_Body);
+
 	void fillTriangleIndexList();
 
+	static bool loadBVTemplate(const char* p_FilePath, BVTemplate& p_Out);
+	static bool readBVTemplate(BVLoader& p_Loader, BVTemplate& p_Out);
+
 	void setRotation(BodyHandle p_Body, DirectX::XMMATRIX& p_Rotation);
 
 	void singleCollisionCheck(Body& p_Collider, Body& p_Victim, bool& p_IsOnGround);
@@ -31,6 +31,25 @@ public:
 		m_IDInBody = 0;
 	}
 
+	/**
+	 * Constructor for hulls with a known surrounding sphere, for example from a template.
+	 * The hull is always created with origo as center position, call updatePosition to move the hull to its desired place.
+	 * @param p_Triangles, a list of triangles that make up the hull
+	 * @param p_Radius, radius of a sphere around origo containing all triangle corners
+	 */
+	Hull(std::vector<Triangle> p_Triangles, float p_Radius) :
+		BoundingVolume(&m_Sphere)
+	{
+		m_BodyHandle = 0;
+		m_Position = DirectX::XMFLOAT4(0.f, 0.f, 0.f, 1.f);
+		m_Triangles.swap(p_Triangles);
+		m_Type = Type::HULL;
+		m_Scale = DirectX::XMFLOAT4(1.f, 1.f, 1.f, 0.f);
+		m_Sphere = Sphere( p_Radius, m_Position );
+		m_CollisionResponse = true;
+		m_IDInBody = 0;
+	}
+
 	/**
 	 * Destructor
 	 */
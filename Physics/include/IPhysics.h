@@ -70,6 +70,29 @@ public:
 	 */
 	virtual bool createBV(const char* p_VolumeID, const char* p_FilePath) = 0;
 
+	/**
+	 * Create a bounding volume from the contents of a volume file, such as an
+	 * entry of an asset archive.
+	 *
+	 * @param p_VolumeID are the identifier to the volume working with
+	 * @param p_Data the contents of a .bbv or .txc file, only used during the call
+	 * @param p_Size the size of the contents in bytes
+	 * @return true if the volume was successfully created, otherwise false
+	 */
+	virtual bool createBVFromMemory(const char* p_VolumeID, const char* p_Data, size_t p_Size) = 0;
+
+	/**
+	 * Decode a bounding volume file ahead of time so that a later call to createBV
+	 * with the same file does not have to read it. Unlike the rest of the interface,
+	 * this function may be called from any thread while the owner thread waits.
+	 *
+	 * @param p_VolumeID the identifier the volume will be created as, nothing is
+	 *			decoded if a volume with the identifier already exists
+	 * @param p_FilePath to the filename of the volume
+	 * @return true if the volume is available for createBV, otherwise false
+	 */
+	virtual bool preloadBV(const char* p_VolumeID, const char* p_FilePath) = 0;
+
 	/**
 	 * Add a boundingVolume Sphere to an existing body.
 	 *
@@ -108,6 +131,20 @@ public:
      */
 	virtual void releaseAllBoundingVolumes(void) = 0;
 
+	/**
+	 * Start collecting created immovable bodies instead of inserting them into
+	 * the collision tree one at a time. Use around loading a level, when many
+	 * static bodies are created at once.
+	 */
+	virtual void beginStaticBodyBatch() = 0;
+
+	/**
+	 * Insert all immovable bodies collected since beginStaticBodyBatch into the
+	 * collision tree in a single pass. Collisions against the collected bodies
+	 * are not detected until this has been called.
+	 */
+	virtual void endStaticBodyBatch() = 0;
+
 	/**
 	 * Used to get the position of the target body.
 	 *
@@ -2,6 +2,8 @@
 
 #include "SoundLogger.h"
 
+#include <cstring>
+
 int Sound::m_NextHandle = 1;
 
 int Sound::getNextHandle()
@@ -166,6 +168,28 @@ bool Sound::loadSound(const char *p_SoundId, const char *p_Filename)
 	return true;
 }
 
+bool Sound::loadSoundFromMemory(const char *p_SoundId, const char *p_Data, size_t p_Size)
+{
+	for (const auto& sound : m_SoundList)
+	{
+		if (sound.first == p_SoundId)
+		{
+			return true;
+		}
+	}
+
+	// FMOD copies the data, so the archive does not need to stay mapped for the sound
+	FMOD_CREATESOUNDEXINFO info;
+	memset(&info, 0, sizeof(info));
+	info.cbsize = sizeof(info);
+	info.length = static_cast<unsigned int>(p_Size);
+
+	FMOD::Sound *s;
+	errorCheck(m_System->createSound(p_Data, FMOD_OPENMEMORY | FMOD_LOOP_NORMAL | FMOD_3D, &info, &s));
+	m_SoundList.push_back(std::make_pair(std::string(p_SoundId), s));
+	return true;
+}
+
 int Sound::createSoundInstance(const char *p_SoundId)
 {
 	for (auto sound : m_SoundList)
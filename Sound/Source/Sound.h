@@ -77,6 +77,8 @@ public:
 
 	bool loadSound(const char *p_SoundId, const char *p_Filename) override;
 
+	bool loadSoundFromMemory(const char *p_SoundId, const char *p_Data, size_t p_Size) override;
+
 	void set3DMinDistance(int p_SoundId, float p_MinDistance) override;
 
 	void setSoundModes(int p_SoundId, bool p_3D, bool p_Loop) override;
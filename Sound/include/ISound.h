@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <Utilities\Util.h>
 
@@ -64,6 +65,16 @@ public:
 	 */
 	virtual bool loadSound(const char *p_SoundId, const char *p_Filename) = 0;
 
+	/**
+	 * Load a sound from the contents of a sound file, such as an entry of an asset
+	 * archive, and set the loop state to be on.
+	 * @param p_SoundId resource name connected to the sound to load.
+	 * @param p_Data the contents of the sound file, copied during the call.
+	 * @param p_Size the size of the contents in bytes.
+	 * @param true if the load is successful otherwise false
+	 */
+	virtual bool loadSoundFromMemory(const char *p_SoundId, const char *p_Data, size_t p_Size) = 0;
+
 	virtual void set3DMinDistance(int p_SoundId, float p_MinDistance) = 0;
 
 	virtual void setSoundModes(int p_SoundId, bool p_3D, bool p_Loop) = 0;